@@ -142,4 +142,49 @@ typedef struct nv_ioctl_export_to_dma_buf_fd
     NvU32       status;
 } nv_ioctl_export_to_dma_buf_fd_t;
 
+/*
+ * Per-fd ring of RM events with data, shared with user space.
+ *
+ * NV_ESC_EVENT_RING allocates the ring and returns the mmap() offset and
+ * length to map it through the same fd. The page at offset 0 of the mapping
+ * holds the header, and the entries follow it. The driver is the only
+ * producer and advances head; user space is the only consumer and advances
+ * tail. Both are free-running counters, so the slot of a counter value c is
+ * (c & (entry_count - 1)).
+ *
+ * The fd only becomes readable when the ring goes from empty to non-empty,
+ * so a consumer must store tail and then re-read head before going back to
+ * sleep. Events that find the ring full are queued for NV04_GET_EVENT_DATA
+ * as before, and are counted in overflow_count.
+ */
+#define NV_EVENT_RING_MAX_ENTRIES   65536
+#define NV_EVENT_RING_MMAP_OFFSET   0x7ffff0000000ULL
+
+typedef struct nv_event_ring_header
+{
+    volatile NvU32 head;
+    NvU32 pad0[15];
+    volatile NvU32 tail;
+    NvU32 pad1[15];
+    NvU32 entry_count;
+    volatile NvU32 overflow_count;
+} nv_event_ring_header_t;
+
+typedef struct nv_event_ring_entry
+{
+    NvHandle hObject;
+    NvU32    index;
+    NvU32    info32;
+    NvU16    info16;
+    NvU16    pad;
+} nv_event_ring_entry_t;
+
+typedef struct nv_ioctl_event_ring
+{
+    NvU32 entry_count;                      /* in: power of two */
+    NvU32 status;
+    NvU64 mmap_offset NV_ALIGN_BYTES(8);    /* out */
+    NvU64 mmap_length NV_ALIGN_BYTES(8);    /* out */
+} nv_ioctl_event_ring_t;
+
 #endif
@@ -0,0 +1,42 @@
+#ifndef _NV_KMEM_H_
+#define _NV_KMEM_H_
+
+#include <nvtypes.h>
+
+/*
+ * Per-CPU magazine cache in front of the locked kernel heap.
+ *
+ * Small allocations (up to NV_KMEM_MAX_CACHED_SIZE bytes) are rounded up to a
+ * power-of-two size class and served from a per-CPU magazine with interrupts
+ * disabled, so the common alloc/free pair never touches a shared lock. Empty
+ * and full magazines are exchanged with a per-class depot; the locked heap is
+ * only used for magazine refills, depot overflow and larger sizes.
+ *
+ * Objects handed out by the cache are regular kernel heap objects of the size
+ * class, so they can also be released with kfree() (unknown size), and ksize()
+ * keeps working on them.
+ */
+
+#define NV_KMEM_MIN_ORDER           5       /* 32 bytes */
+#define NV_KMEM_MAX_ORDER           12      /* 4 KiB */
+#define NV_KMEM_CLASS_COUNT         (NV_KMEM_MAX_ORDER - NV_KMEM_MIN_ORDER + 1)
+#define NV_KMEM_MAX_CACHED_SIZE     (1ull << NV_KMEM_MAX_ORDER)
+
+#define NV_KMEM_MAGAZINE_ROUNDS     32
+#define NV_KMEM_DEPOT_MAX_FULL      16
+
+/*
+ * nvidia_stack_t objects are too large for the size classes above but are
+ * taken and released around every timer callback, ISR bottom half and
+ * UVM-to-RM call, so each CPU also keeps a small LIFO of them.
+ */
+#define NV_KMEM_STACK_POOL_DEPTH    4
+#define NV_KMEM_STACK_POOL_PREFILL  2
+
+int   nv_kmem_init(void);
+void *nv_kmem_alloc(NvU64 size);
+void  nv_kmem_free(void *ptr, NvU64 size);
+void *nv_kmem_stack_alloc(void);
+void  nv_kmem_stack_free(void *stack);
+
+#endif /* _NV_KMEM_H_ */
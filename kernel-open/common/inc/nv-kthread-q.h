@@ -77,24 +77,54 @@
 //    The nv_kthread_q_stop() routine will flush the queue, and safely stop
 //    the kthread, before returning.
 //
+// 5. Multi-worker queues
+//
+//    nv_kthread_q_init_multi() initializes a queue that is serviced by several
+//    kernel contexts instead of one. Each worker owns a local deque: items are
+//    pushed onto the deque of the worker selected by the submitting CPU, and a
+//    worker that finds its own deque empty steals from the tail of the others.
+//    Items submitted with nv_kthread_q_schedule_q_item_serialized() bypass the
+//    deques; they are run one at a time, in submission order, by whichever
+//    worker picks them up.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef struct nv_kthread_q nv_kthread_q_t;
 typedef struct nv_kthread_q_item nv_kthread_q_item_t;
+typedef struct nv_kthread_q_worker nv_kthread_q_worker_t;
 
 typedef void (*nv_q_func_t)(void *args);
 
 struct nv_kthread_q
 {
+    // In multi-worker mode, this list only holds serialized items.
     struct list q_list_head;
     spinlock_t q_lock;
 
     // This is a counting semaphore. It gets incremented and decremented
-    // exactly once for each item that is added to the queue.
+    // exactly once for each item that is added to the queue. In multi-worker
+    // mode, the serialized list only ever contributes one count at a time.
     struct semaphore q_sem;
     atomic_t main_loop_should_exit;
 
     context ctx;
+
+    // Multi-worker mode only; workers is NULL for single-worker queues.
+    nv_kthread_q_worker_t *workers;
+    NvU32 worker_count;
+    int serial_running;
+    atomic_t active_items;
+    atomic_t live_workers;
+};
+
+struct nv_kthread_q_worker
+{
+    struct list q_list_head;
+    spinlock_t q_lock;
+    nv_kthread_q_t *q;
+    NvU32 id;
+    int cpu;
+    context ctx;
 };
 
 struct nv_kthread_q_item
@@ -102,6 +132,9 @@ struct nv_kthread_q_item
     struct list q_list_node;
     nv_q_func_t function_to_run;
     void *function_args;
+
+    // Set while the item is pending in a multi-worker queue.
+    NvU32 q_pending;
 };
 
 
@@ -154,6 +187,32 @@ static inline int nv_kthread_q_init(nv_kthread_q_t *q, const char *qname)
     return nv_kthread_q_init_on_node(q, qname, NV_KTHREAD_NO_NODE);
 }
 
+//
+// Initializes a multi-worker queue serviced by worker_count kernel contexts, or
+// one per present CPU if worker_count is 0. Items scheduled with
+// nv_kthread_q_schedule_q_item() may run concurrently with each other and in
+// any order; use nv_kthread_q_schedule_q_item_serialized() for items that must
+// not.
+//
+// Same return values and stop/reuse rules as nv_kthread_q_init().
+//
+int nv_kthread_q_init_multi_on_node(nv_kthread_q_t *q,
+                                    const char *qname,
+                                    unsigned worker_count,
+                                    int preferred_node);
+
+//
+// Multi-worker queue whose workers are spread over the CPUs of preferred_node
+// (or of the whole system for NV_KTHREAD_NO_NODE); worker_count 0 then means
+// one worker per CPU of that node.
+//
+static inline int nv_kthread_q_init_multi(nv_kthread_q_t *q,
+                                          const char *qname,
+                                          unsigned worker_count)
+{
+    return nv_kthread_q_init_multi_on_node(q, qname, worker_count, NV_KTHREAD_NO_NODE);
+}
+
 //
 // The caller is responsible for stopping all queues, by calling this routine
 // before, for example, kernel module unloading. This nv_kthread_q_stop()
@@ -176,6 +235,9 @@ void nv_kthread_q_stop(nv_kthread_q_t *q);
 //
 // You may NOT call nv_kthread_q_flush() after having called nv_kthread_q_stop.
 //
+// For multi-worker queues, this waits until the queue has no pending or
+// running items at all, which also covers items scheduled by other items.
+//
 // This actually flushes the queue twice. That ensures that the queue is fully
 // flushed, for an important use case: rescheduling from within one's own
 // callback. In order to do that safely, you need to:
@@ -227,6 +289,14 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
 int nv_kthread_q_schedule_q_item(nv_kthread_q_t *q,
                                  nv_kthread_q_item_t *q_item);
 
+//
+// Same as nv_kthread_q_schedule_q_item(), except that on a multi-worker queue
+// the q_item is run after, and never concurrently with, all serialized items
+// scheduled before it. On a single-worker queue every item is serialized.
+//
+int nv_kthread_q_schedule_q_item_serialized(nv_kthread_q_t *q,
+                                            nv_kthread_q_item_t *q_item);
+
 // Built-in test. Returns -1 if any subtest failed, or 0 upon success.
 int nv_kthread_q_run_self_test(void);
 
@@ -86,20 +86,35 @@ typedef int vm_fault_t;
     #define NV_GET_USER_PAGES(start, nr_pages, flags, pages, vmas) \
         get_user_pages(current, current->mm, start, nr_pages, flags, pages, vmas)
 #else
+    NvU64 nv_vtophys_range(NvU64 address, NvU64 page_count, NvU64 *phys_array);
+
     static inline long NV_GET_USER_PAGES(unsigned long start,
                                          unsigned long nr_pages,
                                          unsigned int flags,
                                          NvU64 *pages,
                                          vmap *vmas)
     {
-        unsigned long i;
+        unsigned long i = 0;
+
+        /*
+         * Only pages that are not mapped yet are touched; populated runs are
+         * translated in one nv_vtophys_range() call. Stops at the first page
+         * that cannot be resolved.
+         */
+        while (i < nr_pages) {
+            volatile u64 *ptr;
+
+            i += nv_vtophys_range(start + i * PAGESIZE, nr_pages - i, &pages[i]);
+            if (i == nr_pages)
+                break;
 
-        for (i = 0; i < nr_pages; i++) {
-            volatile u64 *ptr = pointer_from_u64(start + i * PAGESIZE);
+            ptr = pointer_from_u64(start + i * PAGESIZE);
             (void)(*ptr);   /* fault-in page */
-            pages[i] = physical_from_virtual((void *)ptr);
+            if (nv_vtophys_range(start + i * PAGESIZE, 1, &pages[i]) != 1)
+                break;
+            i++;
         }
-        return nr_pages;
+        return i;
     }
 #endif // NV_GET_USER_PAGES_HAS_ARGS_FLAGS
 
@@ -35,11 +35,13 @@
 #endif
 
 void nvidia_isr_common_bh(void *data);
+void nvidia_isr_service(nv_nanos_state_t *nvl, NvBool service_uvm, thunk bh);
 
 #if defined(NV_LINUX_PCIE_MSI_SUPPORTED)
 void    NV_API_CALL nv_init_msi         (nv_state_t *);
 void    NV_API_CALL nv_init_msix        (nv_state_t *);
 NvS32   NV_API_CALL nv_request_msix_irq (nv_nanos_state_t *);
+void                nv_free_msix_vectors(nv_nanos_state_t *);
 
 #define NV_PCI_MSIX_FLAGS         2
 #define NV_PCI_MSIX_FLAGS_QSIZE   0x7FF
@@ -52,6 +54,8 @@ static inline void nv_free_msix_irq(nv_nanos_state_t *nvl)
     {
         pci_teardown_msix(nvl->pci_dev, i);
     }
+
+    nv_free_msix_vectors(nvl);
 }
 
 static inline int nv_get_max_irq(struct pci_dev *pci_dev)
@@ -43,6 +43,7 @@ typedef u64 dev_t;
 #include "nv-mm.h"
 #include "os-interface.h"
 #include "nv-memdbg.h"
+#include "nv-kmem.h"
 #include "nv-timer.h"
 
 #define NV_CURRENT_EUID()   0
@@ -74,6 +75,7 @@ typedef struct nv_dma_map_s {
     NvU64 *pages;
     NvU64 page_count;
     NvBool contiguous;
+    NvBool identity;
     NvU32 cache_type;
     sg_list import_sgt;
 
@@ -89,6 +91,12 @@ typedef struct nv_dma_map_s {
         {
             NvU64 dma_addr;
         } contig;
+
+        /* Bus addresses equal physical addresses; nothing to tear down */
+        struct
+        {
+            NvU64 extent_count;
+        } identity;
     } mapping;
 
     struct device *dev;
@@ -102,22 +110,54 @@ typedef struct nv_dma_map_s {
 #define NV_DMA_SUBMAP_MAX_PAGES           ((NvU32)(NV_U32_MAX >> PAGELOG))
 #define NV_DMA_SUBMAP_IDX_TO_PAGE_IDX(s)  (s * NV_DMA_SUBMAP_MAX_PAGES)
 
+/* Number of runs of physically adjacent pages in pages[0..page_count) */
+static inline NvU64 nv_dma_count_extents(const NvU64 *pages, NvU64 page_count)
+{
+    NvU64 extents = (page_count != 0) ? 1 : 0;
+
+    for (NvU64 i = 1; i < page_count; i++) {
+        if (pages[i] != pages[i - 1] + PAGE_SIZE)
+            extents++;
+    }
+    return extents;
+}
+
+/*
+ * Adjacent pages are merged into a single sg_buf (a submap never exceeds
+ * 4 GiB, so the length always fits), so the list is sized by extents rather
+ * than pages.
+ */
 static inline NV_STATUS NV_ALLOC_DMA_SUBMAP_SCATTERLIST(nv_dma_map_t *dm, nv_dma_submap_t *sm,
                                                         NvU32 i)
 {
     heap h = heap_locked(get_kernel_heaps());
+#if defined(NV_DOM0_KERNEL_PRESENT)
     sm->sgt.b = allocate_buffer(h, sizeof(struct sg_buf) * sm->page_count);
     if (sm->sgt.b == INVALID_ADDRESS)
         return NV_ERR_OPERATING_SYSTEM;
     sm->sgt.count = 0;
-#if defined(NV_DOM0_KERNEL_PRESENT)
     for (NvU32 i = 0; i < sm->page_count; i++)
         sg_list_tail_add(&sm->sgt, PAGESIZE);
 #else
     NvU64 page_idx = NV_DMA_SUBMAP_IDX_TO_PAGE_IDX(i);
-    for (NvU32 i = 0; i < sm->page_count; i++) {
-        sg_buf sgb = sg_list_tail_add(&sm->sgt, PAGE_SIZE);
-        sgb->buf = pointer_from_u64(dm->pages[page_idx++]);
+    NvU64 extents = nv_dma_count_extents(&dm->pages[page_idx], sm->page_count);
+    sg_buf sgb = NULL;
+
+    sm->sgt.b = allocate_buffer(h, sizeof(struct sg_buf) * extents);
+    if (sm->sgt.b == INVALID_ADDRESS)
+        return NV_ERR_OPERATING_SYSTEM;
+    sm->sgt.count = 0;
+    for (NvU32 i = 0; i < sm->page_count; i++, page_idx++) {
+        NvU64 pa = dm->pages[page_idx];
+
+        if ((sgb != NULL) &&
+            (pa == u64_from_pointer(sgb->buf) + sgb->size)) {
+            sgb->size += PAGE_SIZE;
+            sm->sgt.count += PAGE_SIZE;
+            continue;
+        }
+        sgb = sg_list_tail_add(&sm->sgt, PAGE_SIZE);
+        sgb->buf = pointer_from_u64(pa);
         sgb->size = PAGE_SIZE;
         sgb->offset = 0;
         sgb->refcount = 0;
@@ -143,32 +183,102 @@ typedef enum
 
 typedef struct spinlock spinlock_t;
 
+/*
+ * Counting semaphore with a lock-free fast path.
+ *
+ * down() first tries to take a count with a compare-and-swap, then spins for
+ * up to spin_budget pauses before parking the context on the waiters list.
+ * The budget adapts per semaphore: it grows when spinning pays off and shrinks
+ * when the spinner ends up parking anyway. up() only takes the spinlock when
+ * somebody is (about to be) parked.
+ *
+ * A woken waiter is handed off through its state word: if it has not started
+ * parking yet it simply retries, so the waker only has to wait for a complete
+ * frame in the short window where the waiter is in the middle of suspending.
+ */
+#define NV_SEMA_SPIN_MIN    16
+#define NV_SEMA_SPIN_MAX    4096
+
+#define NV_SEMA_WAITING     0
+#define NV_SEMA_PARKING     1
+#define NV_SEMA_WOKEN       2
+
 struct semaphore {
     u64 value;
     struct list waiters;
     struct spinlock lock;
+    u32 nwaiters;
+    u32 spin_budget;
 };
 
-static inline void down(struct semaphore *sema)
-{
+struct nv_sema_waiter {
+    struct list l;
     context ctx;
-    boolean wait;
+    u32 state;
+};
 
-begin:
-    spin_lock(&sema->lock);
-    if (sema->value > 0) {
-        sema->value--;
-        wait = false;
-    } else {
-        ctx = get_current_context(current_cpu());
-        list_push_back(&sema->waiters, &ctx->mutex_l);
-        wait = true;
+static inline boolean nv_sema_try_acquire(struct semaphore *sema)
+{
+    u64 v;
+
+    while ((v = *(volatile u64 *)&sema->value) > 0) {
+        if (__sync_bool_compare_and_swap(&sema->value, v, v - 1))
+            return true;
     }
-    spin_unlock(&sema->lock);
-    if (wait) {
-        context_pre_suspend(ctx);
-        context_suspend();
-        goto begin;
+    return false;
+}
+
+static inline boolean nv_sema_spin(struct semaphore *sema)
+{
+    u32 budget = *(volatile u32 *)&sema->spin_budget;
+    u32 i;
+
+    for (i = 0; i < budget; i++) {
+        kern_pause();
+        if (nv_sema_try_acquire(sema)) {
+            if (budget < NV_SEMA_SPIN_MAX)
+                sema->spin_budget = budget * 2;
+            return true;
+        }
+    }
+    if (budget > NV_SEMA_SPIN_MIN)
+        sema->spin_budget = budget / 2;
+    return false;
+}
+
+static inline void down(struct semaphore *sema)
+{
+    struct nv_sema_waiter w;
+
+    if (nv_sema_try_acquire(sema))
+        return;
+
+    if (nv_sema_spin(sema))
+        return;
+
+    w.ctx = get_current_context(current_cpu());
+    while (1) {
+        spin_lock(&sema->lock);
+
+        // Publish the waiter before re-checking the count; up() increments
+        // the count before looking at nwaiters, so one of us sees the other.
+        __sync_fetch_and_add(&sema->nwaiters, 1);
+        if (nv_sema_try_acquire(sema)) {
+            __sync_fetch_and_sub(&sema->nwaiters, 1);
+            spin_unlock(&sema->lock);
+            return;
+        }
+        w.state = NV_SEMA_WAITING;
+        list_push_back(&sema->waiters, &w.l);
+        spin_unlock(&sema->lock);
+
+        if (__sync_bool_compare_and_swap(&w.state, NV_SEMA_WAITING, NV_SEMA_PARKING)) {
+            context_pre_suspend(w.ctx);
+            context_suspend();
+        }
+
+        if (nv_sema_try_acquire(sema))
+            return;
     }
 }
 
@@ -176,39 +286,36 @@ begin:
 
 static inline int down_trylock(struct semaphore *sema)
 {
-    boolean acquired;
-
-    spin_lock(&sema->lock);
-    if (sema->value > 0) {
-        sema->value--;
-        acquired = true;
-    } else {
-        acquired = false;
-    }
-    spin_unlock(&sema->lock);
-    return acquired ? 0 : 1;
+    return nv_sema_try_acquire(sema) ? 0 : 1;
 }
 
 static inline void up(struct semaphore *sema)
 {
+    struct nv_sema_waiter *w = 0;
     list l;
-    context next;
+
+    __sync_fetch_and_add(&sema->value, 1);
+    if (*(volatile u32 *)&sema->nwaiters == 0)
+        return;
 
     spin_lock(&sema->lock);
-    sema->value++;
     l = list_get_next(&sema->waiters);
     if (l) {
         list_delete(l);
-        next = struct_from_list(l, context, mutex_l);
-    } else {
-        next = 0;
+        __sync_fetch_and_sub(&sema->nwaiters, 1);
+        w = struct_from_list(l, struct nv_sema_waiter *, l);
     }
     spin_unlock(&sema->lock);
-    if (!next)
+    if (!w)
         return;
-    while (!frame_is_full(next->frame))
+
+    // The waiter saw this and will retry without suspending.
+    if (__sync_bool_compare_and_swap(&w->state, NV_SEMA_WAITING, NV_SEMA_WOKEN))
+        return;
+
+    while (!frame_is_full(w->ctx->frame))
         kern_pause();
-    context_schedule_return(next);
+    context_schedule_return(w->ctx);
 }
 
 static inline void sema_init(struct semaphore *sema, int val)
@@ -216,8 +323,67 @@ static inline void sema_init(struct semaphore *sema, int val)
     sema->value = val;
     list_init(&sema->waiters);
     spin_lock_init(&sema->lock);
+    sema->nwaiters = 0;
+    sema->spin_budget = NV_SEMA_SPIN_MIN;
+}
+
+/*
+ * CPU/NUMA topology (nvidia/nv-numa.c). Nanos does not expose the platform
+ * topology, so the node count comes from the NumaNodeCount registry key and
+ * CPUs are split into contiguous, equally sized blocks per node.
+ */
+#define NV_MAX_CPUS         256
+#define NV_MAX_NUMNODES     8
+
+struct cpumask {
+    u64 bits[NV_MAX_CPUS / 64];
+};
+
+static inline NvBool cpumask_test_cpu(int cpu, const struct cpumask *m)
+{
+    return (cpu >= 0) && (cpu < NV_MAX_CPUS) && ((m->bits[cpu / 64] >> (cpu % 64)) & 1);
 }
 
+static inline NvBool cpumask_empty(const struct cpumask *m)
+{
+    int i;
+
+    if (m == NULL)
+        return NV_TRUE;
+    for (i = 0; i < NV_MAX_CPUS / 64; i++)
+        if (m->bits[i])
+            return NV_FALSE;
+    return NV_TRUE;
+}
+
+static inline int cpumask_first(const struct cpumask *m)
+{
+    int cpu;
+
+    for (cpu = 0; cpu < NV_MAX_CPUS; cpu++)
+        if (cpumask_test_cpu(cpu, m))
+            break;
+    return cpu;
+}
+
+static inline int cpumask_weight(const struct cpumask *m)
+{
+    int i, weight = 0;
+
+    for (i = 0; i < NV_MAX_CPUS / 64; i++)
+        weight += __builtin_popcountll(m->bits[i]);
+    return weight;
+}
+
+void nv_numa_init(void);
+int nv_num_nodes(void);
+int nv_cpu_to_node(int cpu);
+const struct cpumask *nv_cpumask_of_node(int node);
+int nv_pci_dev_to_node(struct pci_dev *d);
+heap nv_numa_node_heap(int node);
+
+void nv_p2p_init(void);
+
 #include "nv-kthread-q.h"
 #include "nv-lock.h"
 
@@ -240,6 +406,28 @@ struct nv_dma_device {
     } addressable_range;
 
     NvBool nvlink;
+
+    /*
+     * Mapping statistics of nv_dma_map_pages() and nv_dma_map_sgt(), printed
+     * by nv_dma_print_stats(). Segments are the runs of DMA-contiguous pages
+     * of each mapping.
+     */
+    struct {
+        atomic64_t maps;
+        atomic64_t unmaps;
+        atomic64_t failed_maps;
+        atomic64_t identity_maps;
+        atomic64_t contig_maps;
+        atomic64_t scatterlist_maps;
+        atomic64_t bytes_mapped;
+        atomic64_t segments;
+        atomic64_t outstanding;
+        atomic64_t peak_outstanding;
+        atomic64_t map_ns;
+        atomic64_t max_map_ns;
+        atomic64_t first_map_ns;
+        NvU64      last_map_ns;
+    } stats;
 };
 
 typedef struct nvidia_pte_s {
@@ -247,6 +435,9 @@ typedef struct nvidia_pte_s {
     unsigned long   virt_addr;
     NvU64           dma_addr;
     unsigned int    page_count;
+    unsigned int    chunk_pages;    /* pages in the physically contiguous chunk
+                                       starting here, 0 if this page is not the
+                                       first of a chunk */
 } nvidia_pte_t;
 
 #define pfn_valid(pfn)  ((pfn) < (INVALID_PHYSICAL >> PAGELOG))
@@ -287,6 +478,18 @@ declare_closure_struct(0, 0, void, nvidia_isr_kthread_bh);
 declare_closure_struct(0, 0, void, nvidia_isr_msix);
 declare_closure_struct(0, 0, void, nvidia_isr_msix_kthread_bh);
 declare_closure_struct(0, 0, void, nvidia_isr_bh_unlocked);
+declare_closure_struct(0, 0, void, nvidia_isr_msix_vector);
+declare_closure_struct(0, 0, void, nvidia_isr_msix_vector_bh);
+
+/* Per-vector MSI-X state, used when NVreg_MsixPerVector is set */
+typedef struct nv_msix_vector_s {
+    struct nv_nanos_state_s *nvl;
+    NvU32 index;
+    nvidia_stack_t *bh_sp;
+    closure_struct(nvidia_isr_msix_vector, isr);
+    closure_struct(nvidia_isr_msix_vector_bh, bh);
+} nv_msix_vector_t;
+
 typedef struct nv_nanos_state_s {
     nv_state_t nv_state;
     atomic_t usage_count;
@@ -327,6 +530,9 @@ typedef struct nv_nanos_state_s {
     /* Lock serializing bottom halves for different MSI-X vectors */
     void *msix_bh_mutex;
 
+    /* Per-vector top and bottom halves, NULL in the serialized MSI-X mode */
+    nv_msix_vector_t *msix_vectors;
+
     NvU64 numa_memblock_size;
 
     /* GPU user mapping revocation/remapping (only for non-CTL device) */
@@ -347,11 +553,20 @@ typedef struct nv_nanos_state_s {
     NvU16 current_num_irq_tracked;
 
     struct nv_dma_device dma_dev;
+
+    /* Load-time initialization, see NVreg_InitDevicesAtLoad */
+    nv_kthread_q_item_t preinit_q_item;
+    NvBool preinit_opened;
 } nv_nanos_state_t;
 
 extern NvBool nv_ats_supported;
 
 extern NvU32 NVreg_RegisterPCIDriver;
+extern NvU32 NVreg_NumaNodeCount;
+extern NvU32 NVreg_NanoTimerSlack;
+extern NvU32 NVreg_MsixPerVector;
+extern NvU32 NVreg_MmapLargePages;
+extern NvU32 NVreg_InitDevicesAtLoad;
 
 extern NvU32 num_probed_nv_devices;
 extern NvU32 num_nv_devices;
@@ -481,10 +696,8 @@ typedef struct nvidia_event
 #define ZERO_SIZE_PTR       pointer_from_u64(16)
 #define ZERO_OR_NULL_PTR(p) (u64_from_pointer(p) <= u64_from_pointer(ZERO_SIZE_PTR))
 
-#define NV_KMALLOC(ptr, size)   do {                                                        \
-    ptr = ((size) != 0) ? allocate(heap_locked(get_kernel_heaps()), size) : ZERO_SIZE_PTR;  \
-    if (ptr == INVALID_ADDRESS)                                                             \
-        ptr = 0;                                                                            \
+#define NV_KMALLOC(ptr, size)   do {                            \
+    ptr = ((size) != 0) ? nv_kmem_alloc(size) : ZERO_SIZE_PTR;  \
 } while (0)
 
 #define NV_KZALLOC(ptr, size)   do {    \
@@ -495,9 +708,9 @@ typedef struct nvidia_event
 #define NV_KMALLOC_ATOMIC   NV_KMALLOC
 #define NV_KMALLOC_NO_OOM   NV_KMALLOC
 
-#define NV_KFREE(ptr, size) do {                                            \
-    if (!ZERO_OR_NULL_PTR(ptr))                                             \
-        deallocate(heap_locked(get_kernel_heaps()), (void *) (ptr), size);  \
+#define NV_KFREE(ptr, size) do {                \
+    if (!ZERO_OR_NULL_PTR(ptr))                 \
+        nv_kmem_free((void *) (ptr), size);     \
 } while (0)
 
 #define NV_UVM_GFP_FLAGS    0
@@ -608,16 +821,22 @@ static inline NvBool nv_dma_maps_swiotlb(struct device *dev)
     return NV_FALSE;
 }
 
+/* No IOMMU is programmed, so DMA addresses are the physical addresses. */
+static inline NvBool nv_dma_is_identity_mapped(struct nv_dma_device *dma_dev)
+{
+    return NV_TRUE;
+}
+
 static inline NvBool nv_numa_node_has_memory(int node_id)
 {
-    if (node_id < 0 || node_id >= 1)
+    if (node_id < 0 || node_id >= nv_num_nodes())
         return NV_FALSE;
     return NV_TRUE;
 }
 
 #define NV_ALLOC_PAGES_NODE(ptr, nid, order)  do                \
     {                                                           \
-        heap h = (heap)heap_linear_backed(get_kernel_heaps());  \
+        heap h = nv_numa_node_heap(nid);                        \
         ptr = allocate_u64(h, PAGESIZE << (order));             \
         if (ptr == INVALID_PHYSICAL)                            \
             ptr = 0;                                            \
@@ -683,11 +902,22 @@ static inline sysreturn nv_io_remap_page_range(vmap vm, NvU64 phys_addr, NvU64 s
 #define NV_MAYBE_RESERVE_PAGE(ptr_ptr)
 #define NV_MAYBE_UNRESERVE_PAGE(page_ptr)
 
-#define on_each_cpu(func, info, wait)
+typedef void (*nv_ipi_func_t)(void *info);
+
+/* Runs func on every CPU, see nv-ipi.c */
+void nv_on_each_cpu(nv_ipi_func_t func, void *info, int wait);
+
+#define on_each_cpu(func, info, wait)   nv_on_each_cpu(func, info, wait)
 
 #if defined(NVCPU_X86_64)
 #define CACHE_FLUSH()  asm volatile("wbinvd":::"memory")
 #define WRITE_COMBINE_FLUSH() asm volatile("sfence":::"memory")
+    static inline void nv_flush_cache_cpu(void *info)
+    {
+        CACHE_FLUSH();
+        flush_tlb(true);
+    }
+#define CACHE_FLUSH_ALL()        on_each_cpu(nv_flush_cache_cpu, NULL, 1)
 #elif defined(NVCPU_AARCH64)
     static inline void nv_flush_cache_cpu(void *info)
     {
@@ -709,7 +939,7 @@ static inline int nv_kmem_cache_alloc_stack(nvidia_stack_t **stack)
 {
     nvidia_stack_t *sp = NULL;
 #if defined(NVCPU_X86_64)
-    NV_KMALLOC(sp, sizeof(*sp));
+    sp = nv_kmem_stack_alloc();
     if (sp == NULL)
         return -1;
     sp->size = sizeof(sp->stack);
@@ -724,7 +954,7 @@ static inline void nv_kmem_cache_free_stack(nvidia_stack_t *stack)
 #if defined(NVCPU_X86_64)
     if (stack != NULL)
     {
-        NV_KFREE(stack, sizeof(*stack));
+        nv_kmem_stack_free(stack);
     }
 #endif
 }
@@ -753,10 +983,13 @@ extern struct semaphore nv_linux_devices_lock;
 #define LOCK_NV_LINUX_DEVICES()     down(&nv_linux_devices_lock)
 #define UNLOCK_NV_LINUX_DEVICES()   up(&nv_linux_devices_lock)
 
+/*
+ * ioctls take a pooled alt-stack per call (see nvfd_ioctl), so that threads
+ * sharing a file descriptor don't serialize on a per-fd stack slot.
+ */
 typedef enum
 {
     NV_FOPS_STACK_INDEX_MMAP,
-    NV_FOPS_STACK_INDEX_IOCTL,
     NV_FOPS_STACK_INDEX_COUNT
 } nvidia_entry_point_index_t;
 
@@ -774,6 +1007,9 @@ typedef struct nvfd {
     void *nvptr;
     nvidia_event_t *event_data_head, *event_data_tail;
     NvBool dataless_event_pending;
+    nv_event_ring_header_t *event_ring;     /* see NV_ESC_EVENT_RING */
+    NvU32 event_ring_order;
+    NvBool event_ring_mapped;
     nv_spinlock_t fp_lock;
     blockq waitqueue;
     NvU32 *attached_gpus;
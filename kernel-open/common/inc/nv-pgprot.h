@@ -45,6 +45,12 @@ static inline pgprot_t pgprot_noncached(pgprot_t old_prot)
         return new_prot;
     }
 #endif
+/*
+ * WC is selected through PWT alone (PAT entry 1, see nv_init_pat_support()),
+ * never through the PAT bit, whose position differs between 4 KiB and large
+ * page entries; the same flags are therefore valid for 2 MiB and 1 GiB
+ * mappings.
+ */
 static inline pgprot_t pgprot_modify_writecombine(pgprot_t old_prot)
     {
         pgprot_t new_prot = old_prot;
@@ -48,6 +48,8 @@ void        nv_revoke_gpu_mappings_locked(nv_state_t *);
 NvUPtr      nv_vm_map_pages             (nvidia_pte_t **, NvU32, NvBool, NvBool);
 void        nv_vm_unmap_pages           (NvUPtr, NvU32);
 
+void        nv_dma_print_stats          (nv_dma_device_t *);
+
 NV_STATUS   nv_alloc_contig_pages       (nv_state_t *, nv_alloc_t *);
 void        nv_free_contig_pages        (nv_alloc_t *);
 NV_STATUS   nv_alloc_system_pages       (nv_state_t *, nv_alloc_t *);
@@ -1058,6 +1058,62 @@ NV_STATUS nvUvmInterfaceEnableAccessCntr(uvmGpuDeviceHandle device,
 NV_STATUS nvUvmInterfaceDisableAccessCntr(uvmGpuDeviceHandle device,
                                           UvmGpuAccessCntrInfo *pAccessCntrInfo);
 
+/*******************************************************************************
+    nvUvmInterfaceAccessBitsBufAlloc
+
+    This function allocates a vidmem access bit buffer and enables access bit
+    logging over the first fbSize bytes of vidmem. RM picks the smallest
+    granularity at which UVM_ACCESS_BITS_MAX_BITS bits cover fbSize bytes.
+
+    Arguments:
+        device[IN]            - Device handle associated with the gpu
+        fbSize[IN]            - Bytes of vidmem to track
+        pAccessBitsInfo[OUT]  - Granularity and number of the access bits
+
+    Error codes:
+      NV_ERR_NOT_SUPPORTED    - The GPU or the RM configuration has no
+                                access bit buffer
+      NV_ERR_INVALID_ARGUMENT
+*/
+NV_STATUS nvUvmInterfaceAccessBitsBufAlloc(uvmGpuDeviceHandle device,
+                                           NvU64 fbSize,
+                                           UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo);
+
+/*******************************************************************************
+    nvUvmInterfaceAccessBitsBufFree
+
+    This function disables access bit logging and frees the buffer allocated
+    by nvUvmInterfaceAccessBitsBufAlloc.
+
+    Arguments:
+        device[IN]            - Device handle associated with the gpu
+        pAccessBitsInfo[IN]   - Pointer to structure filled out by
+                                nvUvmInterfaceAccessBitsBufAlloc
+*/
+NV_STATUS nvUvmInterfaceAccessBitsBufFree(uvmGpuDeviceHandle device,
+                                          UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo);
+
+/*******************************************************************************
+    nvUvmInterfaceAccessBitsDump
+
+    This function dumps the access bits of the vidmem accessed since the
+    previous dump, or since logging was enabled.
+
+    Arguments:
+        device[IN]            - Device handle associated with the gpu
+        pAccessBitsInfo[IN]   - Pointer to structure filled out by
+                                nvUvmInterfaceAccessBitsBufAlloc
+        pAccessBits[OUT]      - Array of UVM_ACCESS_BITS_MAX_BITS / 64 words.
+                                Bit i is bit (i % 64) of word (i / 64).
+
+    Error codes:
+      NV_ERR_GENERIC
+      NV_ERR_INVALID_ARGUMENT
+*/
+NV_STATUS nvUvmInterfaceAccessBitsDump(uvmGpuDeviceHandle device,
+                                       UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo,
+                                       NvU64 *pAccessBits);
+
 //
 // Called by the UVM driver to register operations with RM. Only one set of
 // callbacks can be registered by any driver at a time. If another set of
@@ -1248,6 +1304,34 @@ NV_STATUS nvUvmInterfaceGetChannelResourcePtes(uvmGpuAddressSpaceHandle vaSpace,
                                                NvU64 size,
                                                UvmGpuExternalMappingInfo *externalMappingInfo);
 
+/*******************************************************************************
+    nvUvmInterfaceGetChannelResourcesPtes
+
+    Batched variant of nvUvmInterfaceGetChannelResourcePtes: builds the PTEs of
+    several channel resources, each from offset 0, while taking the RM locks
+    only once.
+
+    Arguments:
+        vaSpace[IN]                     -  vaSpace handle.
+        resourceCount[IN]               -  Number of entries in the arrays below.
+        resourceDescriptors[IN]         -  Channel resource descriptors returned by
+                                           nvUvmInterfaceRetainChannel.
+        sizes[IN]                       -  Length of each allocation for which PTEs
+                                           should be built, with the same meaning as
+                                           in nvUvmInterfaceGetChannelResourcePtes.
+        externalMappingInfos[IN/OUT]    -  One per resource, see
+                                           nvUvmInterfaceGetChannelResourcePtes.
+
+   Error codes:
+        Same as nvUvmInterfaceGetChannelResourcePtes. Processing stops at the
+        first resource that fails.
+*/
+NV_STATUS nvUvmInterfaceGetChannelResourcesPtes(uvmGpuAddressSpaceHandle vaSpace,
+                                                NvU32 resourceCount,
+                                                const NvP64 *resourceDescriptors,
+                                                const NvU64 *sizes,
+                                                UvmGpuExternalMappingInfo *externalMappingInfos);
+
 /*******************************************************************************
     nvUvmInterfaceReportNonReplayableFault
 
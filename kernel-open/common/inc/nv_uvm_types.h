@@ -1019,6 +1019,21 @@ typedef struct UvmGpuAccessCntrConfig_tag
     NvU32 threshold;
 } UvmGpuAccessCntrConfig;
 
+// Maximum number of access bits returned by one vidmem access bit buffer dump
+#define UVM_ACCESS_BITS_MAX_BITS 4096
+
+typedef struct UvmGpuAccessBitsBufferAlloc_tag
+{
+    // Bytes of vidmem covered by one access bit. Bit i of a dump covers
+    // [i * granularity, (i + 1) * granularity) of the FB.
+    NvU64 granularity;
+
+    // Number of access bits in a dump
+    NvU32 numBits;
+
+    NvHandle accessBitsBufferHandle;
+} UvmGpuAccessBitsBufferAlloc;
+
 //
 // When modifying this enum, make sure they are compatible with the mirrored
 // MEMORY_PROTECTION enum in phys_mem_allocator.h.
@@ -1042,6 +1057,7 @@ typedef UvmGpuInfo gpuInfo;
 typedef UvmGpuClientInfo gpuClientInfo;
 typedef UvmGpuAccessCntrInfo gpuAccessCntrInfo;
 typedef UvmGpuAccessCntrConfig gpuAccessCntrConfig;
+typedef UvmGpuAccessBitsBufferAlloc gpuAccessBitsBufferAlloc;
 typedef UvmGpuFaultInfo gpuFaultInfo;
 typedef UvmGpuMemoryInfo gpuMemoryInfo;
 typedef UvmGpuExternalMappingInfo gpuExternalMappingInfo;
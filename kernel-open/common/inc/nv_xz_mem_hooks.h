@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __NV_XZ_MEM_HOOKS_H__
+#define __NV_XZ_MEM_HOOKS_H__
+
+/*
+ * This file is included by xz_config.h when NV_XZ_CUSTOM_MEM_HOOKS is defined,
+ * allowing us to override xzminidec's standard library use.
+ */
+
+#include "os-interface.h"
+
+static inline void *nv_xz_alloc(NvU64 size)
+{
+    void *ptr;
+
+    return (os_alloc_mem(&ptr, size) == NV_OK) ? ptr : (void *)0;
+}
+
+static inline void *nv_xz_memmove(void *dst, const void *src, NvU64 size)
+{
+    NvU8 *d = dst;
+    const NvU8 *s = src;
+
+    if (d < s)
+    {
+        while (size--)
+            *d++ = *s++;
+    }
+    else
+    {
+        while (size--)
+            d[size] = s[size];
+    }
+
+    return dst;
+}
+
+#define kmalloc(size, flags) nv_xz_alloc(size)
+#define kfree(ptr)           os_free_mem(ptr)
+#define vmalloc(size)        nv_xz_alloc(size)
+#define vfree(ptr)           os_free_mem(ptr)
+
+#define memeq(a, b, size)   (os_mem_cmp((const NvU8 *)(a), (const NvU8 *)(b), size) == 0)
+#define memzero(buf, size)   os_mem_set(buf, 0, size)
+#define memcpy(a, b, size)   os_mem_copy(a, b, size)
+#define memmove(a, b, size)  nv_xz_memmove(a, b, size)
+
+#endif /* __NV_XZ_MEM_HOOKS_H__ */
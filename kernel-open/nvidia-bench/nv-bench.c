@@ -0,0 +1,768 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Microbenchmarks for the Nanos glue of the driver klib.
+ *
+ * This is run as the application of a Nanos image with gpu_nvidia loaded, so
+ * every measurement goes through the syscall layer and the fdesc closures of
+ * the driver (nvfd_ioctl, nvfd_mmap, nvfd_events and uvm_ioctl), which is
+ * what user-mode drivers see. Each case prints min/p50/p90/p99/max in us.
+ *
+ * Usage: nv-bench [iterations]
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "nvtypes.h"
+#include "nvmisc.h"
+#include "nvstatus.h"
+#include "nvos.h"
+#include "nv-ioctl.h"
+#include "nv_escape.h"
+#include "nv-unix-nvos-params-wrappers.h"
+
+#include "class/cl0000.h"
+#include "class/cl0005.h"
+#include "class/cl003e.h"
+#include "class/cl0040.h"
+#include "class/cl0080.h"
+#include "class/cl2080.h"
+#include "class/cl90f1.h"
+#include "ctrl/ctrl0000/ctrl0000base.h"
+#include "ctrl/ctrl0000/ctrl0000gpu.h"
+#include "ctrl/ctrl2080/ctrl2080event.h"
+
+#include "uvm_linux_ioctl.h"
+
+#define NV_BENCH_DEFAULT_ITERATIONS     1000
+#define NV_BENCH_HANDLE_BASE            0xbe000000
+#define NV_BENCH_EVENT_TIMEOUT_MS       1000
+
+#define NV_BENCH_SYSMEM_MAP_SIZE        (64ULL << 10)
+#define NV_BENCH_VIDMEM_MAP_SIZE        (2ULL << 20)
+
+const NvProcessorUuid NV_PROCESSOR_UUID_CPU_DEFAULT =
+{
+    {
+       // Must match nvidia-uvm/nvCpuUuid.c
+       0xa6, 0x5e, 0x0f, 0x4e, 0xd7, 0xd4, 0x7b, 0xa2,
+       0x50, 0x47, 0x41, 0x2c, 0x14, 0x2a, 0x77, 0x73
+    }
+};
+
+typedef struct
+{
+    int             ctl_fd;
+    int             dev_fd;
+    int             event_fd;
+    int             uvm_fd;
+    char            dev_path[32];
+
+    NvU32           gpu_id;
+    NvU32           device_instance;
+    NvProcessorUuid gpu_uuid;
+
+    NvHandle        client;
+    NvHandle        device;
+    NvHandle        subdevice;
+    NvHandle        next_handle;
+
+    unsigned int    iterations;
+    NvU64          *samples;
+} nv_bench_t;
+
+static NvU64 nv_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (NvU64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int nv_bench_compare_u64(const void *a, const void *b)
+{
+    NvU64 x = *(const NvU64 *)a;
+    NvU64 y = *(const NvU64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void nv_bench_report(const char *name, NvU64 *samples, unsigned int count)
+{
+    if (count == 0)
+    {
+        printf("%-32s %8s\n", name, "skipped");
+        return;
+    }
+
+    qsort(samples, count, sizeof(samples[0]), nv_bench_compare_u64);
+
+#define NV_BENCH_PCT(p) (samples[((NvU64)(count - 1) * (p)) / 100] / 1000.0)
+    printf("%-32s %8u %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, count,
+           samples[0] / 1000.0, NV_BENCH_PCT(50), NV_BENCH_PCT(90),
+           NV_BENCH_PCT(99), samples[count - 1] / 1000.0);
+#undef NV_BENCH_PCT
+}
+
+static int nv_bench_ioctl(int fd, int nr, void *arg, size_t size)
+{
+    int ret;
+
+    do
+    {
+        ret = ioctl(fd, _IOC(_IOC_READ | _IOC_WRITE, NV_IOCTL_MAGIC, nr, size), arg);
+    } while ((ret < 0) && ((errno == EINTR) || (errno == EAGAIN)));
+
+    return (ret < 0) ? -errno : 0;
+}
+
+static NV_STATUS nv_bench_uvm_ioctl(nv_bench_t *b, unsigned long cmd, void *arg,
+                                    NV_STATUS *rm_status)
+{
+    if (ioctl(b->uvm_fd, cmd, arg) < 0)
+        return NV_ERR_GENERIC;
+
+    return *rm_status;
+}
+
+static NV_STATUS nv_bench_alloc(nv_bench_t *b, NvHandle parent, NvHandle handle,
+                                NvU32 hclass, void *params, NvU32 size)
+{
+    NVOS21_PARAMETERS p;
+
+    memset(&p, 0, sizeof(p));
+    p.hRoot = b->client;
+    p.hObjectParent = parent;
+    p.hObjectNew = handle;
+    p.hClass = hclass;
+    p.pAllocParms = NV_PTR_TO_NvP64(params);
+    p.paramsSize = size;
+
+    if (nv_bench_ioctl(b->ctl_fd, NV_ESC_RM_ALLOC, &p, sizeof(p)) != 0)
+        return NV_ERR_GENERIC;
+
+    if ((p.status == NV_OK) && (hclass == NV01_ROOT))
+        b->client = p.hObjectNew;
+
+    return p.status;
+}
+
+static NV_STATUS nv_bench_free(nv_bench_t *b, NvHandle parent, NvHandle handle)
+{
+    NVOS00_PARAMETERS p;
+
+    memset(&p, 0, sizeof(p));
+    p.hRoot = b->client;
+    p.hObjectParent = parent;
+    p.hObjectOld = handle;
+
+    if (nv_bench_ioctl(b->ctl_fd, NV_ESC_RM_FREE, &p, sizeof(p)) != 0)
+        return NV_ERR_GENERIC;
+
+    return p.status;
+}
+
+static NV_STATUS nv_bench_control(nv_bench_t *b, NvHandle object, NvU32 cmd,
+                                  void *params, NvU32 size)
+{
+    NVOS54_PARAMETERS p;
+
+    memset(&p, 0, sizeof(p));
+    p.hClient = b->client;
+    p.hObject = object;
+    p.cmd = cmd;
+    p.params = NV_PTR_TO_NvP64(params);
+    p.paramsSize = size;
+
+    if (nv_bench_ioctl(b->ctl_fd, NV_ESC_RM_CONTROL, &p, sizeof(p)) != 0)
+        return NV_ERR_GENERIC;
+
+    return p.status;
+}
+
+static NvHandle nv_bench_new_handle(nv_bench_t *b)
+{
+    return b->next_handle++;
+}
+
+static void nv_bench_memory_params(NV_MEMORY_ALLOCATION_PARAMS *params,
+                                   NvU32 hclass, NvU64 size)
+{
+    memset(params, 0, sizeof(*params));
+    params->type = NVOS32_TYPE_IMAGE;
+    params->size = size;
+
+    if (hclass == NV01_MEMORY_SYSTEM)
+    {
+        params->attr = DRF_DEF(OS32, _ATTR, _LOCATION, _PCI) |
+                       DRF_DEF(OS32, _ATTR, _PHYSICALITY, _NONCONTIGUOUS) |
+                       DRF_DEF(OS32, _ATTR, _COHERENCY, _CACHED);
+    }
+    else
+    {
+        params->attr = DRF_DEF(OS32, _ATTR, _LOCATION, _VIDMEM) |
+                       DRF_DEF(OS32, _ATTR, _PHYSICALITY, _NONCONTIGUOUS);
+    }
+}
+
+static int nv_bench_setup(nv_bench_t *b)
+{
+    nv_ioctl_card_info_t cards[NV_MAX_DEVICES];
+    nv_ioctl_register_fd_t register_fd;
+    NV0000_CTRL_GPU_GET_ID_INFO_V2_PARAMS id_info;
+    NV0000_CTRL_GPU_GET_UUID_FROM_GPU_ID_PARAMS uuid;
+    NV0080_ALLOC_PARAMETERS device_params;
+    NV2080_ALLOC_PARAMETERS subdevice_params;
+    unsigned int i;
+
+    b->next_handle = NV_BENCH_HANDLE_BASE;
+
+    b->ctl_fd = open("/dev/nvidiactl", O_RDWR);
+    if (b->ctl_fd < 0)
+    {
+        perror("open /dev/nvidiactl");
+        return -1;
+    }
+
+    if (nv_bench_ioctl(b->ctl_fd, NV_ESC_CARD_INFO, cards, sizeof(cards)) != 0)
+    {
+        fprintf(stderr, "NV_ESC_CARD_INFO failed\n");
+        return -1;
+    }
+
+    for (i = 0; i < NV_MAX_DEVICES; i++)
+    {
+        if (cards[i].valid)
+            break;
+    }
+
+    if (i == NV_MAX_DEVICES)
+    {
+        fprintf(stderr, "no GPU found\n");
+        return -1;
+    }
+
+    b->gpu_id = cards[i].gpu_id;
+    snprintf(b->dev_path, sizeof(b->dev_path), "/dev/nvidia%u", cards[i].minor_number);
+
+    b->dev_fd = open(b->dev_path, O_RDWR);
+    if (b->dev_fd < 0)
+    {
+        perror(b->dev_path);
+        return -1;
+    }
+
+    register_fd.ctl_fd = b->ctl_fd;
+    if (nv_bench_ioctl(b->dev_fd, NV_ESC_REGISTER_FD, &register_fd, sizeof(register_fd)) != 0)
+    {
+        fprintf(stderr, "NV_ESC_REGISTER_FD failed\n");
+        return -1;
+    }
+
+    if (nv_bench_alloc(b, 0, 0, NV01_ROOT, NULL, 0) != NV_OK)
+    {
+        fprintf(stderr, "failed to allocate a client\n");
+        return -1;
+    }
+
+    memset(&id_info, 0, sizeof(id_info));
+    id_info.gpuId = b->gpu_id;
+    if (nv_bench_control(b, b->client, NV0000_CTRL_CMD_GPU_GET_ID_INFO_V2,
+                         &id_info, sizeof(id_info)) != NV_OK)
+    {
+        fprintf(stderr, "failed to query GPU 0x%x\n", b->gpu_id);
+        return -1;
+    }
+
+    memset(&uuid, 0, sizeof(uuid));
+    uuid.gpuId = b->gpu_id;
+    uuid.flags = NV0000_CTRL_CMD_GPU_GET_UUID_FROM_GPU_ID_FLAGS_FORMAT_BINARY;
+    if (nv_bench_control(b, b->client, NV0000_CTRL_CMD_GPU_GET_UUID_FROM_GPU_ID,
+                         &uuid, sizeof(uuid)) != NV_OK)
+    {
+        fprintf(stderr, "failed to query the UUID of GPU 0x%x\n", b->gpu_id);
+        return -1;
+    }
+    memcpy(b->gpu_uuid.uuid, uuid.gpuUuid, sizeof(b->gpu_uuid.uuid));
+
+    b->device_instance = id_info.deviceInstance;
+
+    memset(&device_params, 0, sizeof(device_params));
+    device_params.deviceId = b->device_instance;
+    b->device = nv_bench_new_handle(b);
+    if (nv_bench_alloc(b, b->client, b->device, NV01_DEVICE_0,
+                       &device_params, sizeof(device_params)) != NV_OK)
+    {
+        fprintf(stderr, "failed to allocate a device\n");
+        return -1;
+    }
+
+    memset(&subdevice_params, 0, sizeof(subdevice_params));
+    subdevice_params.subDeviceId = id_info.subDeviceInstance;
+    b->subdevice = nv_bench_new_handle(b);
+    if (nv_bench_alloc(b, b->device, b->subdevice, NV20_SUBDEVICE_0,
+                       &subdevice_params, sizeof(subdevice_params)) != NV_OK)
+    {
+        fprintf(stderr, "failed to allocate a subdevice\n");
+        return -1;
+    }
+
+    printf("GPU 0x%x (%s), %u iterations\n\n", b->gpu_id, b->dev_path, b->iterations);
+    printf("%-32s %8s %10s %10s %10s %10s %10s\n", "us", "samples",
+           "min", "p50", "p90", "p99", "max");
+
+    return 0;
+}
+
+static void nv_bench_teardown(nv_bench_t *b)
+{
+    if (b->uvm_fd >= 0)
+        close(b->uvm_fd);
+
+    if (b->client != 0)
+        nv_bench_free(b, b->client, b->client);
+
+    if (b->event_fd >= 0)
+        close(b->event_fd);
+    if (b->dev_fd >= 0)
+        close(b->dev_fd);
+    if (b->ctl_fd >= 0)
+        close(b->ctl_fd);
+}
+
+static void nv_bench_null_control(nv_bench_t *b)
+{
+    unsigned int i;
+
+    for (i = 0; i < b->iterations; i++)
+    {
+        NvU64 start = nv_bench_now_ns();
+
+        if (nv_bench_control(b, b->client, NV0000_CTRL_CMD_NULL, NULL, 0) != NV_OK)
+            break;
+
+        b->samples[i] = nv_bench_now_ns() - start;
+    }
+
+    nv_bench_report("ioctl null control", b->samples, i);
+}
+
+//
+// Times the allocation and the free of an object separately. The samples of
+// the frees are kept in the second half of the sample buffer. RM writes back
+// into the allocation parameters, so they are copied for every allocation.
+//
+static void nv_bench_alloc_free(nv_bench_t *b, const char *name, NvHandle parent,
+                                NvU32 hclass, const void *params, NvU32 size)
+{
+    unsigned int count = b->iterations / 2;
+    NvU64 *free_samples = b->samples + count;
+    NvU8 scratch[sizeof(NV_MEMORY_ALLOCATION_PARAMS)];
+    char label[64];
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        NvHandle handle = nv_bench_new_handle(b);
+        NvU64 start;
+
+        memcpy(scratch, params, size);
+
+        start = nv_bench_now_ns();
+        if (nv_bench_alloc(b, parent, handle, hclass, scratch, size) != NV_OK)
+            break;
+
+        b->samples[i] = nv_bench_now_ns() - start;
+
+        start = nv_bench_now_ns();
+        if (nv_bench_free(b, parent, handle) != NV_OK)
+            break;
+
+        free_samples[i] = nv_bench_now_ns() - start;
+    }
+
+    snprintf(label, sizeof(label), "alloc %s", name);
+    nv_bench_report(label, b->samples, i);
+    snprintf(label, sizeof(label), "free %s", name);
+    nv_bench_report(label, free_samples, i);
+}
+
+static void nv_bench_alloc_free_classes(nv_bench_t *b)
+{
+    NV0080_ALLOC_PARAMETERS device_params;
+    NV_MEMORY_ALLOCATION_PARAMS memory_params;
+
+    memset(&device_params, 0, sizeof(device_params));
+    device_params.deviceId = b->device_instance;
+    nv_bench_alloc_free(b, "NV01_DEVICE_0", b->client, NV01_DEVICE_0,
+                        &device_params, sizeof(device_params));
+
+    nv_bench_memory_params(&memory_params, NV01_MEMORY_SYSTEM, NV_BENCH_SYSMEM_MAP_SIZE);
+    nv_bench_alloc_free(b, "NV01_MEMORY_SYSTEM 64K", b->device, NV01_MEMORY_SYSTEM,
+                        &memory_params, sizeof(memory_params));
+
+    nv_bench_memory_params(&memory_params, NV01_MEMORY_LOCAL_USER, NV_BENCH_VIDMEM_MAP_SIZE);
+    nv_bench_alloc_free(b, "NV01_MEMORY_LOCAL_USER 2M", b->device, NV01_MEMORY_LOCAL_USER,
+                        &memory_params, sizeof(memory_params));
+}
+
+//
+// Mirrors what user-mode drivers do for a CPU mapping: the mapping is set
+// up through NV_ESC_RM_MAP_MEMORY on the control fd, and then established by
+// mmap() on a fresh fd, since the mmap context of an fd can only be used
+// once. Only the mmap() call, which is nvfd_mmap, is timed.
+//
+static void nv_bench_mmap(nv_bench_t *b, const char *name, NvU32 hclass, NvU64 size)
+{
+    NV_MEMORY_ALLOCATION_PARAMS memory_params;
+    NvHandle memory = nv_bench_new_handle(b);
+    const char *path = (hclass == NV01_MEMORY_SYSTEM) ? "/dev/nvidiactl" : b->dev_path;
+    unsigned int i;
+
+    nv_bench_memory_params(&memory_params, hclass, size);
+    if (nv_bench_alloc(b, b->device, memory, hclass, &memory_params,
+                       sizeof(memory_params)) != NV_OK)
+    {
+        nv_bench_report(name, b->samples, 0);
+        return;
+    }
+
+    for (i = 0; i < b->iterations; i++)
+    {
+        nv_ioctl_nvos33_parameters_with_fd map;
+        NVOS34_PARAMETERS unmap;
+        NvU64 start;
+        void *ptr;
+        int fd;
+
+        fd = open(path, O_RDWR);
+        if (fd < 0)
+            break;
+
+        memset(&map, 0, sizeof(map));
+        map.params.hClient = b->client;
+        map.params.hDevice = b->device;
+        map.params.hMemory = memory;
+        map.params.length = size;
+        map.fd = fd;
+
+        if ((nv_bench_ioctl(b->ctl_fd, NV_ESC_RM_MAP_MEMORY, &map, sizeof(map)) != 0) ||
+            (map.params.status != NV_OK))
+        {
+            close(fd);
+            break;
+        }
+
+        start = nv_bench_now_ns();
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                   (off_t)(NvUPtr)NvP64_VALUE(map.params.pLinearAddress));
+        b->samples[i] = nv_bench_now_ns() - start;
+
+        if (ptr != MAP_FAILED)
+            munmap(ptr, size);
+
+        memset(&unmap, 0, sizeof(unmap));
+        unmap.hClient = b->client;
+        unmap.hDevice = b->device;
+        unmap.hMemory = memory;
+        unmap.pLinearAddress = map.params.pLinearAddress;
+        nv_bench_ioctl(b->ctl_fd, NV_ESC_RM_UNMAP_MEMORY, &unmap, sizeof(unmap));
+
+        close(fd);
+
+        if (ptr == MAP_FAILED)
+            break;
+    }
+
+    nv_bench_report(name, b->samples, i);
+
+    nv_bench_free(b, b->device, memory);
+}
+
+//
+// Event delivery latency: the time from issuing a software event trigger
+// until poll() on the fd the OS event is bound to returns. The trigger
+// notifies synchronously, so this covers the RM notification path, the wake
+// up of the poller and nvfd_events.
+//
+static void nv_bench_events(nv_bench_t *b)
+{
+    nv_ioctl_alloc_os_event_t os_event;
+    NV0005_ALLOC_PARAMETERS event_params;
+    NV2080_CTRL_EVENT_SET_NOTIFICATION_PARAMS notification;
+    NvHandle event = nv_bench_new_handle(b);
+    unsigned int i;
+
+    b->event_fd = open("/dev/nvidiactl", O_RDWR);
+    if (b->event_fd < 0)
+        goto done;
+
+    memset(&os_event, 0, sizeof(os_event));
+    os_event.hClient = b->client;
+    os_event.hDevice = b->device;
+    os_event.fd = b->event_fd;
+    if ((nv_bench_ioctl(b->event_fd, NV_ESC_ALLOC_OS_EVENT, &os_event, sizeof(os_event)) != 0) ||
+        (os_event.Status != NV_OK))
+    {
+        goto done;
+    }
+
+    memset(&event_params, 0, sizeof(event_params));
+    event_params.hParentClient = b->client;
+    event_params.hSrcResource = b->subdevice;
+    event_params.hClass = NV01_EVENT_OS_EVENT;
+    event_params.notifyIndex = NV2080_NOTIFIERS_SW;
+    event_params.data = NV_PTR_TO_NvP64((NvUPtr)b->event_fd);
+    if (nv_bench_alloc(b, b->subdevice, event, NV01_EVENT_OS_EVENT,
+                       &event_params, sizeof(event_params)) != NV_OK)
+    {
+        goto done;
+    }
+
+    memset(&notification, 0, sizeof(notification));
+    notification.event = NV2080_NOTIFIERS_SW;
+    notification.action = NV2080_CTRL_EVENT_SET_NOTIFICATION_ACTION_REPEAT;
+    if (nv_bench_control(b, b->subdevice, NV2080_CTRL_CMD_EVENT_SET_NOTIFICATION,
+                         &notification, sizeof(notification)) != NV_OK)
+    {
+        goto done;
+    }
+
+    for (i = 0; i < b->iterations; i++)
+    {
+        struct pollfd pfd = { .fd = b->event_fd, .events = POLLIN | POLLPRI };
+        NVOS41_PARAMETERS event_data;
+        NvUnixEvent unix_event;
+        NvU64 start;
+
+        start = nv_bench_now_ns();
+        if (nv_bench_control(b, b->subdevice, NV2080_CTRL_CMD_EVENT_SET_TRIGGER,
+                             NULL, 0) != NV_OK)
+        {
+            break;
+        }
+
+        if (poll(&pfd, 1, NV_BENCH_EVENT_TIMEOUT_MS) != 1)
+        {
+            fprintf(stderr, "event not delivered within %u ms\n", NV_BENCH_EVENT_TIMEOUT_MS);
+            break;
+        }
+        b->samples[i] = nv_bench_now_ns() - start;
+
+        do
+        {
+            memset(&event_data, 0, sizeof(event_data));
+            event_data.pEvent = NV_PTR_TO_NvP64(&unix_event);
+            if (nv_bench_ioctl(b->event_fd, NV_ESC_RM_GET_EVENT_DATA,
+                               &event_data, sizeof(event_data)) != 0)
+            {
+                break;
+            }
+        } while ((event_data.status == NV_OK) && event_data.MoreEvents);
+    }
+
+    nv_bench_report("event delivery", b->samples, i);
+    return;
+
+done:
+    nv_bench_report("event delivery", b->samples, 0);
+}
+
+static int nv_bench_uvm_setup(nv_bench_t *b)
+{
+    UVM_INITIALIZE_PARAMS init;
+    UVM_REGISTER_GPU_PARAMS register_gpu;
+    UVM_REGISTER_GPU_VASPACE_PARAMS register_va_space;
+    NV_VASPACE_ALLOCATION_PARAMETERS va_space_params;
+    NvHandle va_space = nv_bench_new_handle(b);
+
+    b->uvm_fd = open("/dev/nvidia-uvm", O_RDWR);
+    if (b->uvm_fd < 0)
+        return -1;
+
+    memset(&init, 0, sizeof(init));
+    if (nv_bench_uvm_ioctl(b, UVM_INITIALIZE, &init, &init.rmStatus) != NV_OK)
+        return -1;
+
+    memset(&register_gpu, 0, sizeof(register_gpu));
+    register_gpu.gpu_uuid = b->gpu_uuid;
+    register_gpu.rmCtrlFd = b->ctl_fd;
+    register_gpu.hClient = b->client;
+    if (nv_bench_uvm_ioctl(b, UVM_REGISTER_GPU, &register_gpu, &register_gpu.rmStatus) != NV_OK)
+        return -1;
+
+    memset(&va_space_params, 0, sizeof(va_space_params));
+    va_space_params.index = NV_VASPACE_ALLOCATION_INDEX_GPU_NEW;
+    va_space_params.flags = NV_VASPACE_ALLOCATION_FLAGS_ENABLE_PAGE_FAULTING;
+    if (nv_bench_alloc(b, b->device, va_space, FERMI_VASPACE_A,
+                       &va_space_params, sizeof(va_space_params)) != NV_OK)
+    {
+        return -1;
+    }
+
+    memset(&register_va_space, 0, sizeof(register_va_space));
+    register_va_space.gpuUuid = b->gpu_uuid;
+    register_va_space.rmCtrlFd = b->ctl_fd;
+    register_va_space.hClient = b->client;
+    register_va_space.hVaSpace = va_space;
+    if (nv_bench_uvm_ioctl(b, UVM_REGISTER_GPU_VASPACE, &register_va_space,
+                           &register_va_space.rmStatus) != NV_OK)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static NV_STATUS nv_bench_migrate(nv_bench_t *b, NvU64 base, NvU64 length,
+                                  const NvProcessorUuid *dest)
+{
+    UVM_MIGRATE_PARAMS params;
+
+    memset(&params, 0, sizeof(params));
+    params.base = base;
+    params.length = length;
+    params.destinationUuid = *dest;
+    params.cpuNumaNode = (NvU32)-1;
+
+    return nv_bench_uvm_ioctl(b, UVM_MIGRATE, &params, &params.rmStatus);
+}
+
+//
+// Migrates a managed range to the GPU and back, timing each direction. The
+// range is aligned to its size so that 2M and 1G migrations use whole big
+// pages.
+//
+static void nv_bench_migrate_size(nv_bench_t *b, const char *name, NvU64 size,
+                                  unsigned int count)
+{
+    NvU64 *to_cpu_samples = b->samples + count;
+    NvU64 reserve_size = size * 2;
+    NvU64 base;
+    char label[64];
+    void *reserve;
+    unsigned int i = 0;
+
+    reserve = mmap(NULL, reserve_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserve == MAP_FAILED)
+        goto report;
+
+    base = NV_ALIGN_UP((NvU64)(NvUPtr)reserve, size);
+    if (mmap((void *)(NvUPtr)base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+             b->uvm_fd, (off_t)base) == MAP_FAILED)
+    {
+        goto unmap;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        NvU64 start = nv_bench_now_ns();
+
+        if (nv_bench_migrate(b, base, size, &b->gpu_uuid) != NV_OK)
+            break;
+
+        b->samples[i] = nv_bench_now_ns() - start;
+
+        start = nv_bench_now_ns();
+        if (nv_bench_migrate(b, base, size, &NV_PROCESSOR_UUID_CPU_DEFAULT) != NV_OK)
+            break;
+
+        to_cpu_samples[i] = nv_bench_now_ns() - start;
+    }
+
+unmap:
+    munmap(reserve, reserve_size);
+
+report:
+    snprintf(label, sizeof(label), "UVM_MIGRATE %s to GPU", name);
+    nv_bench_report(label, b->samples, i);
+    snprintf(label, sizeof(label), "UVM_MIGRATE %s to CPU", name);
+    nv_bench_report(label, to_cpu_samples, i);
+}
+
+static void nv_bench_uvm_migrate(nv_bench_t *b)
+{
+    unsigned int count = b->iterations / 2;
+
+    if (nv_bench_uvm_setup(b) != 0)
+    {
+        fprintf(stderr, "UVM setup failed, skipping migrations\n");
+        return;
+    }
+
+    nv_bench_migrate_size(b, "4K", 4ULL << 10, count);
+    nv_bench_migrate_size(b, "2M", 2ULL << 20, NV_MAX(count / 10, 1));
+    nv_bench_migrate_size(b, "1G", 1ULL << 30, NV_MAX(count / 100, 1));
+}
+
+int main(int argc, char **argv)
+{
+    nv_bench_t bench;
+    int ret = 1;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.ctl_fd = -1;
+    bench.dev_fd = -1;
+    bench.event_fd = -1;
+    bench.uvm_fd = -1;
+    bench.iterations = NV_BENCH_DEFAULT_ITERATIONS;
+
+    if (argc > 1)
+        bench.iterations = strtoul(argv[1], NULL, 0);
+
+    if (bench.iterations < 2)
+    {
+        fprintf(stderr, "usage: %s [iterations >= 2]\n", argv[0]);
+        return 1;
+    }
+
+    bench.samples = calloc(bench.iterations, sizeof(bench.samples[0]));
+    if (bench.samples == NULL)
+        return 1;
+
+    if (nv_bench_setup(&bench) == 0)
+    {
+        nv_bench_null_control(&bench);
+        nv_bench_alloc_free_classes(&bench);
+        nv_bench_mmap(&bench, "mmap sysmem 64K", NV01_MEMORY_SYSTEM, NV_BENCH_SYSMEM_MAP_SIZE);
+        nv_bench_mmap(&bench, "mmap vidmem 2M", NV01_MEMORY_LOCAL_USER, NV_BENCH_VIDMEM_MAP_SIZE);
+        nv_bench_events(&bench);
+        nv_bench_uvm_migrate(&bench);
+        ret = 0;
+    }
+
+    nv_bench_teardown(&bench);
+    free(bench.samples);
+
+    return ret;
+}
@@ -173,6 +173,96 @@ err:
     return status;
 }
 
+// CPU fault handler of managed VA ranges, installed on the vma by uvm_mmap.
+// Returns false if the fault can't be serviced and the access must fail.
+closure_func_basic(vmap_fault, boolean, uvm_vm_fault,
+                   u64 fault_addr, boolean is_write)
+{
+    uvm_vma_wrapper_t *vma_wrapper = struct_from_field(closure_self(), uvm_vma_wrapper_t *, fault);
+    vmap vma = vma_wrapper->vma;
+    uvm_va_space_t *va_space = uvm_fd_va_space(vma->fd);
+    uvm_service_block_context_t *service_context;
+    uvm_global_processor_mask_t gpus_to_check_for_ecc;
+    uvm_va_block_t *va_block;
+    NV_STATUS status = uvm_global_get_status();
+    bool tools_enabled;
+
+    if (status != NV_OK)
+        return false;
+
+    if (!va_space)
+        return false;
+
+    service_context = uvm_kvmalloc_zero(sizeof(*service_context));
+    if (!service_context)
+        return false;
+
+    uvm_va_block_context_init(&service_context->block_context, NULL);
+    service_context->cpu_fault.wakeup_time_stamp = 0;
+
+    uvm_va_space_down_read(va_space);
+
+    do {
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            NvU64 now = NV_GETTIME();
+
+            // Thrashing throttle: back off with the VA space lock dropped
+            if (now < service_context->cpu_fault.wakeup_time_stamp) {
+                uvm_tools_record_throttling_start(va_space, fault_addr, UVM_ID_CPU);
+                uvm_va_space_up_read(va_space);
+                udelay((service_context->cpu_fault.wakeup_time_stamp - now) / 1000);
+                uvm_va_space_down_read(va_space);
+                uvm_tools_record_throttling_end(va_space, fault_addr, UVM_ID_CPU);
+            }
+        }
+
+        status = uvm_va_block_find_create_managed(va_space, fault_addr, &va_block);
+        if (status != NV_OK)
+            break;
+
+        // The range may have been unmapped and replaced while the lock was
+        // dropped.
+        if (uvm_va_range_vma(va_block->va_range) != vma) {
+            status = NV_ERR_INVALID_ADDRESS;
+            break;
+        }
+
+        // Loop until thrashing goes away
+        status = uvm_va_block_cpu_fault(va_block, fault_addr, is_write, service_context);
+    } while (status == NV_WARN_MORE_PROCESSING_REQUIRED);
+
+    if (status != NV_OK && status != NV_ERR_BUSY_RETRY) {
+        UvmEventFatalReason reason = uvm_tools_status_to_fatal_fault_reason(status);
+
+        if (reason != UvmEventFatalReasonInvalid)
+            uvm_tools_record_cpu_fatal_fault(va_space, fault_addr, is_write, reason);
+    }
+
+    tools_enabled = va_space->tools.enabled;
+
+    if (status == NV_OK) {
+        uvm_va_space_global_gpus_in_mask(va_space,
+                                         &gpus_to_check_for_ecc,
+                                         &service_context->cpu_fault.gpus_to_check_for_ecc);
+        uvm_global_mask_retain(&gpus_to_check_for_ecc);
+    }
+
+    uvm_va_space_up_read(va_space);
+
+    if (status == NV_OK) {
+        status = uvm_global_mask_check_ecc_error(&gpus_to_check_for_ecc);
+        uvm_global_mask_release(&gpus_to_check_for_ecc);
+    }
+
+    if (tools_enabled)
+        uvm_tools_flush_events();
+
+    uvm_kvfree(service_context);
+
+    // A busy retry leaves the page unmapped, so the access just faults again
+    return status == NV_OK || status == NV_ERR_BUSY_RETRY;
+}
+
 closure_func_basic(fdesc_mmap, sysreturn, uvm_mmap,
                    vmap vma, u64 offset)
 {
@@ -242,6 +332,10 @@ closure_func_basic(fdesc_mmap, sysreturn, uvm_mmap,
         }
     }
 
+    // Managed ranges are populated and mapped by the CPU fault handler
+    if (status == NV_OK && vma_wrapper_allocated)
+        vma->fault = init_closure_func(&vma_wrapper->fault, vmap_fault, uvm_vm_fault);
+
     if (status != NV_OK) {
         UVM_DBG_PRINT_RL("Failed to create or map VA range for vma [0x%lx, 0x%lx): %s\n",
                          vma->node.r.start, vma->node.r.end, nvstatusToString(status));
@@ -369,10 +463,55 @@ closure_func_basic(fdesc_ioctl, sysreturn, uvm_ioctl,
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_CLEAN_UP_ZOMBIE_RESOURCES,      uvm_api_clean_up_zombie_resources);
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_POPULATE_PAGEABLE,              uvm_api_populate_pageable);
         UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_VALIDATE_VA_RANGE,              uvm_api_validate_va_range);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_SET_PERF_TUNABLE,               uvm_api_set_perf_tunable);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_GET_PERF_TUNABLE,               uvm_api_get_perf_tunable);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_MIGRATE_BATCH,                  uvm_api_migrate_batch);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_GET_ACCESS_COUNTER_HEAT,        uvm_api_get_access_counter_heat);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_TOOLS_GET_MIGRATION_COUNTERS,   uvm_api_tools_get_migration_counters);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_GET_FAULT_BATCH_RECORDS,        uvm_api_get_fault_batch_records);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_GET_VIDMEM_COLDNESS,            uvm_api_get_vidmem_coldness);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_MIGRATE_RANGE_GROUP_BULK,       uvm_api_migrate_range_group_bulk);
+        UVM_ROUTE_CMD_ALLOC_INIT_CHECK(UVM_TOOLS_GET_PUSH_LATENCY,         uvm_api_tools_get_push_latency);
+        UVM_ROUTE_CMD_STACK_INIT_CHECK(UVM_GET_FAULT_BUFFER_STATS,         uvm_api_get_fault_buffer_stats);
     }
     return ioctl_generic(filp, cmd, ap);
 }
 
+// Tear down the VA spaces of closed files in the background, on the deferred
+// release queue. Closing waits only for the VA space's channels to be stopped,
+// while unmapping and freeing its memory, which can take seconds for large VA
+// spaces, happens after close has returned. The VA space's GPU memory stays
+// evictable meanwhile, and eviction drops its data instead of copying it out,
+// so PMM allocations under memory pressure reclaim it on demand. 0 tears down
+// VA spaces before close returns.
+static int uvm_va_space_deferred_destroy __read_mostly = 1;
+module_param(uvm_va_space_deferred_destroy, int, S_IRUGO);
+
+static void uvm_va_space_destroy_deferred(void *args)
+{
+    UVM_ENTRY_VOID(uvm_va_space_destroy((uvm_va_space_t *)args));
+}
+
+static void uvm_va_space_release(uvm_va_space_t *va_space)
+{
+    int scheduled;
+
+    if (!uvm_va_space_deferred_destroy) {
+        uvm_va_space_destroy(va_space);
+        return;
+    }
+
+    // Stop the channels right away so the GPUs stop accessing the VA space's
+    // memory by the time close returns. Destroy skips the stop once it's done.
+    uvm_va_space_down_read_rm(va_space);
+    uvm_va_space_stop_all_user_channels(va_space);
+    uvm_va_space_up_read_rm(va_space);
+
+    nv_kthread_q_item_init(&va_space->deferred_release_q_item, uvm_va_space_destroy_deferred, va_space);
+    scheduled = nv_kthread_q_schedule_q_item(&g_uvm_global.deferred_release_q, &va_space->deferred_release_q_item);
+    UVM_ASSERT(scheduled);
+}
+
 closure_func_basic(fdesc_close, sysreturn, uvm_close,
                    context ctx, io_completion completion)
 {
@@ -387,7 +526,7 @@ closure_func_basic(fdesc_close, sysreturn, uvm_close,
         goto out;
     UVM_ASSERT(fd_type == UVM_FD_VA_SPACE);
     va_space = (uvm_va_space_t *)ptr;
-    uvm_va_space_destroy(va_space);
+    uvm_va_space_release(va_space);
 out:
     file_release(&filp->sfw.f);
     return io_complete(completion, 0);
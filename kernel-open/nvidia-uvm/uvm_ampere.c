@@ -59,6 +59,7 @@ void uvm_hal_ampere_arch_init_properties(uvm_parent_gpu_t *parent_gpu)
     parent_gpu->ce_phys_vidmem_write_supported = true;
 
     parent_gpu->peer_copy_mode = g_uvm_global.peer_copy_mode;
+    parent_gpu->peer_copy_auto = g_uvm_global.peer_copy_auto;
 
     // Not all units on Ampere support 49-bit addressing, including those which
     // access channel buffers.
@@ -214,7 +214,17 @@ NV_STATUS uvm_api_tools_write_process_memory(UVM_TOOLS_WRITE_PROCESS_MEMORY_PARA
 NV_STATUS uvm_api_map_dynamic_parallelism_region(UVM_MAP_DYNAMIC_PARALLELISM_REGION_PARAMS *params, fdesc filp);
 NV_STATUS uvm_api_unmap_external(UVM_UNMAP_EXTERNAL_PARAMS *params, fdesc filp);
 NV_STATUS uvm_api_migrate_range_group(UVM_MIGRATE_RANGE_GROUP_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_migrate_batch(UVM_MIGRATE_BATCH_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_get_access_counter_heat(UVM_GET_ACCESS_COUNTER_HEAT_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_tools_get_migration_counters(UVM_TOOLS_GET_MIGRATION_COUNTERS_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_tools_get_push_latency(UVM_TOOLS_GET_PUSH_LATENCY_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_get_fault_batch_records(UVM_GET_FAULT_BATCH_RECORDS_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_get_fault_buffer_stats(UVM_GET_FAULT_BUFFER_STATS_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_get_vidmem_coldness(UVM_GET_VIDMEM_COLDNESS_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_migrate_range_group_bulk(UVM_MIGRATE_RANGE_GROUP_BULK_PARAMS *params, fdesc filp);
 NV_STATUS uvm_api_alloc_semaphore_pool(UVM_ALLOC_SEMAPHORE_POOL_PARAMS *params, fdesc filp);
 NV_STATUS uvm_api_populate_pageable(const UVM_POPULATE_PAGEABLE_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_set_perf_tunable(UVM_SET_PERF_TUNABLE_PARAMS *params, fdesc filp);
+NV_STATUS uvm_api_get_perf_tunable(UVM_GET_PERF_TUNABLE_PARAMS *params, fdesc filp);
 
 #endif // __UVM_API_H__
@@ -31,6 +31,21 @@
 #include <linux/hmm.h>
 #endif
 
+// Service all the read faults, and all the write faults, of a
+// UVM_VA_BLOCK_SIZE region with a single population of the span between the
+// first and last faulting pages, instead of one per contiguous run of
+// faulting pages. Pages in the gaps are populated as if they were prefetched.
+static unsigned uvm_ats_fault_coalesce = 1;
+module_param(uvm_ats_fault_coalesce, uint, S_IRUGO);
+
+// On the first touch of a UVM_VA_BLOCK_SIZE region that is fully covered by
+// the VMA, populate the whole region on the faulting GPU. This lets the region
+// be backed by a single huge page and saves the faults on the rest of it. This
+// only applies when prefetching is enabled, a VMA memory policy with preferred
+// nodes always populates the whole region.
+static unsigned uvm_ats_fault_populate_block = 1;
+module_param(uvm_ats_fault_populate_block, uint, S_IRUGO);
+
 static NV_STATUS service_ats_faults(uvm_gpu_va_space_t *gpu_va_space,
                                     vmap vma,
                                     NvU64 start,
@@ -409,8 +424,11 @@ static NV_STATUS ats_fault_prefetch(uvm_gpu_va_space_t *gpu_va_space,
         return status;
 
     // Prefetch the entire region if none of the pages are resident on any node
-    // and if preferred_location is the faulting GPU.
-    if (ats_context->prefetch_state.has_preferred_location &&
+    // and if preferred_location is the faulting GPU, or if the region is a
+    // whole VA block and uvm_ats_fault_populate_block is set.
+    if ((ats_context->prefetch_state.has_preferred_location ||
+         (uvm_ats_fault_populate_block &&
+          uvm_va_block_region_num_pages(max_prefetch_region) == PAGES_PER_UVM_VA_BLOCK)) &&
         ats_context->prefetch_state.first_touch &&
         uvm_id_equal(ats_context->residency_id, gpu_va_space->gpu->parent->id)) {
 
@@ -428,6 +446,22 @@ static NV_STATUS ats_fault_prefetch(uvm_gpu_va_space_t *gpu_va_space,
     return status;
 }
 
+// Return the mask of pages to populate to service the faults in fault_mask.
+// With uvm_ats_fault_coalesce, this is a single region spanning all of them,
+// which is serviced with a single call into the OS.
+static const uvm_page_mask_t *ats_service_mask(uvm_ats_fault_context_t *ats_context,
+                                               const uvm_page_mask_t *fault_mask)
+{
+    uvm_page_mask_t *coalesced_mask = &ats_context->coalesced_mask;
+
+    if (!uvm_ats_fault_coalesce || uvm_page_mask_empty(fault_mask))
+        return fault_mask;
+
+    uvm_page_mask_init_from_region(coalesced_mask, uvm_va_block_region_from_mask(NULL, fault_mask), NULL);
+
+    return coalesced_mask;
+}
+
 NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
                                  vmap vma,
                                  NvU64 base,
@@ -441,6 +475,7 @@ NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
     uvm_page_mask_t *faults_serviced_mask = &ats_context->faults_serviced_mask;
     uvm_page_mask_t *reads_serviced_mask = &ats_context->reads_serviced_mask;
     uvm_fault_client_type_t client_type = ats_context->client_type;
+    const uvm_page_mask_t *service_mask;
 
     UVM_ASSERT(vma);
     UVM_ASSERT(IS_ALIGNED(base, UVM_VA_BLOCK_SIZE));
@@ -476,7 +511,9 @@ NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
 
     ats_fault_prefetch(gpu_va_space, vma, base, ats_context);
 
-    for_each_va_block_subregion_in_mask(subregion, write_fault_mask, region) {
+    service_mask = ats_service_mask(ats_context, write_fault_mask);
+
+    for_each_va_block_subregion_in_mask(subregion, service_mask, region) {
         NvU64 start = base + (subregion.first * PAGE_SIZE);
         size_t length = uvm_va_block_region_num_pages(subregion) * PAGE_SIZE;
         uvm_fault_access_type_t access_type = (vma->flags & VMAP_FLAG_WRITABLE) ?
@@ -512,7 +549,9 @@ NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
     // Remove write faults from read_fault_mask
     uvm_page_mask_andnot(read_fault_mask, read_fault_mask, write_fault_mask);
 
-    for_each_va_block_subregion_in_mask(subregion, read_fault_mask, region) {
+    service_mask = ats_service_mask(ats_context, read_fault_mask);
+
+    for_each_va_block_subregion_in_mask(subregion, service_mask, region) {
         NvU64 start = base + (subregion.first * PAGE_SIZE);
         size_t length = uvm_va_block_region_num_pages(subregion) * PAGE_SIZE;
         uvm_fault_access_type_t access_type = UVM_FAULT_ACCESS_TYPE_READ;
@@ -523,10 +562,12 @@ NV_STATUS uvm_ats_service_faults(uvm_gpu_va_space_t *gpu_va_space,
         status = service_ats_faults(gpu_va_space, vma, start, length, access_type, ats_context);
         if (status != NV_OK)
             return status;
-
-        uvm_page_mask_region_fill(faults_serviced_mask, subregion);
     }
 
+    // Only report the read faults as serviced. A coalesced region may span
+    // write faults of a read-only VMA, which must still be cancelled.
+    uvm_page_mask_or(faults_serviced_mask, faults_serviced_mask, read_fault_mask);
+
     return status;
 }
 
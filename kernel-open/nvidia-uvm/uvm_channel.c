@@ -57,6 +57,46 @@ module_param(uvm_channel_gpfifo_loc, charp, S_IRUGO);
 module_param(uvm_channel_gpput_loc, charp, S_IRUGO);
 module_param(uvm_channel_pushbuffer_loc, charp, S_IRUGO);
 
+// Spread CPU_TO_GPU and GPU_TO_CPU pushes across the CE pools that can serve
+// them, instead of always using the preferred CE of the type.
+static unsigned uvm_channel_ce_load_balance = 1;
+module_param(uvm_channel_ce_load_balance, uint, S_IRUGO);
+
+// Outstanding bytes on the default pool of a type above which other pools are
+// considered.
+static unsigned uvm_channel_ce_load_balance_threshold_kb = 1024;
+module_param(uvm_channel_ce_load_balance_threshold_kb, uint, S_IRUGO);
+
+// End long CE pushes, and all pushes on channels with parked waiters, with a
+// nonstall interrupt, and let waiters park on it instead of polling the
+// tracking semaphore.
+static unsigned uvm_channel_interrupt_completion = 1;
+module_param(uvm_channel_interrupt_completion, uint, S_IRUGO);
+
+// Minimum bytes copied by a push for it to end with a nonstall interrupt even
+// if nobody is waiting on the channel yet.
+static unsigned uvm_channel_interrupt_completion_min_kb = 256;
+module_param(uvm_channel_interrupt_completion_min_kb, uint, S_IRUGO);
+
+// How long a wait is polled before the waiter parks.
+static unsigned uvm_channel_interrupt_completion_spin_us = 50;
+module_param(uvm_channel_interrupt_completion_spin_us, uint, S_IRUGO);
+
+// Channels created in each CE pool. 0 sizes the pools from the number of CPUs
+// and of replayable fault service workers of the GPU.
+static unsigned uvm_channel_ce_pool_channels = 0;
+module_param(uvm_channel_ce_pool_channels, uint, S_IRUGO);
+
+// Number of channels CE pools can grow to. Channels are added one at a time
+// when reservations in the pool wait longer than
+// uvm_channel_ce_pool_grow_wait_us for a channel to become available.
+static unsigned uvm_channel_ce_pool_max_channels = 8;
+module_param(uvm_channel_ce_pool_max_channels, uint, S_IRUGO);
+
+// 0 disables the growth of CE pools.
+static unsigned uvm_channel_ce_pool_grow_wait_us = 100;
+module_param(uvm_channel_ce_pool_grow_wait_us, uint, S_IRUGO);
+
 static NV_STATUS manager_create_procfs_dirs(uvm_channel_manager_t *manager);
 static NV_STATUS manager_create_procfs(uvm_channel_manager_t *manager);
 static NV_STATUS channel_create_procfs(uvm_channel_t *channel);
@@ -120,6 +160,31 @@ static void channel_pool_unlock(uvm_channel_pool_t *pool)
         uvm_spin_unlock(&pool->spinlock);
 }
 
+static NvU32 push_latency_bucket(NvU64 latency_ns)
+{
+    if (latency_ns == 0)
+        return 0;
+
+    return min((NvU32)ilog2(latency_ns), (NvU32)(UVM_PUSH_LATENCY_BUCKETS - 1));
+}
+
+static void channel_record_push_latency(uvm_channel_t *channel, uvm_gpfifo_entry_t *entry, NvU64 completed_time_ns)
+{
+    uvm_push_latency_stats_t *stats = &channel->pool->manager->push_latency[entry->channel_type];
+    NvU64 exec_ns = 0;
+
+    // The end time is taken after the tracking semaphore release is pushed,
+    // so a fast completion may be observed with an earlier timestamp.
+    if (completed_time_ns > entry->end_time_ns)
+        exec_ns = completed_time_ns - entry->end_time_ns;
+
+    atomic64_inc(&stats->pushes);
+    atomic64_add(entry->queue_ns, &stats->queue_ns);
+    atomic64_add(exec_ns, &stats->exec_ns);
+    atomic64_inc(&stats->queue_histogram[push_latency_bucket(entry->queue_ns)]);
+    atomic64_inc(&stats->exec_histogram[push_latency_bucket(exec_ns)]);
+}
+
 // Update channel progress, completing up to max_to_complete entries
 static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
                                                   NvU32 max_to_complete,
@@ -129,6 +194,7 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
     NvU32 cpu_put;
     NvU32 completed_count = 0;
     NvU32 pending_gpfifos;
+    NvU64 completed_time_ns = 0;
 
     NvU64 completed_value = uvm_channel_update_completed_value(channel);
 
@@ -154,6 +220,21 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
         if (entry->type == UVM_GPFIFO_ENTRY_TYPE_NORMAL) {
             uvm_pushbuffer_mark_completed(channel, entry);
             list_add_tail(&entry->push_info->available_list_node, &channel->available_push_infos);
+
+            UVM_ASSERT(channel->outstanding_copy_bytes >= entry->copy_bytes);
+            channel->outstanding_copy_bytes -= entry->copy_bytes;
+            UVM_WRITE_ONCE(channel->pool->outstanding_copy_bytes,
+                           channel->pool->outstanding_copy_bytes - entry->copy_bytes);
+            channel->pool->completed_pushes++;
+            channel->pool->completed_copy_bytes += entry->copy_bytes;
+
+            // Entries force-completed on teardown never executed
+            if (mode == UVM_CHANNEL_UPDATE_MODE_COMPLETED && entry->channel_type < UVM_CHANNEL_TYPE_CE_COUNT) {
+                if (completed_time_ns == 0)
+                    completed_time_ns = NV_GETTIME();
+
+                channel_record_push_latency(channel, entry, completed_time_ns);
+            }
         }
 
         gpu_get = (gpu_get + 1) % channel->num_gpfifo_entries;
@@ -172,6 +253,45 @@ static NvU32 uvm_channel_update_progress_with_max(uvm_channel_t *channel,
     return pending_gpfifos;
 }
 
+typedef struct
+{
+    uvm_channel_t *channel;
+    NvU64 value;
+} channel_completion_wait_t;
+
+static bool channel_completion_wait_is_done(void *arg)
+{
+    channel_completion_wait_t *wait = arg;
+
+    if (uvm_gpu_tracking_semaphore_is_value_completed(&wait->channel->tracking_sem, wait->value))
+        return true;
+
+    // Errors are only discovered by polling, so don't go to sleep on them.
+    return uvm_channel_get_status(wait->channel) != NV_OK || uvm_global_get_status() != NV_OK;
+}
+
+bool uvm_channel_wait_for_completion_interrupt(uvm_channel_t *channel, NvU64 value, NvU64 waited_ns)
+{
+    channel_completion_wait_t wait = { .channel = channel, .value = value };
+
+    if (!uvm_channel_interrupt_completion || !NV_MAY_SLEEP())
+        return false;
+
+    if (waited_ns < (NvU64)uvm_channel_interrupt_completion_spin_us * 1000)
+        return false;
+
+    // Without a nonstall interrupt at or after the value, the only wakeup
+    // would be the watchdog, so keep polling.
+    if (UVM_READ_ONCE(channel->completion_interrupt_value) < value)
+        return false;
+
+    atomic_inc(&channel->num_completion_waiters);
+    uvm_gpu_isr_wait_for_interrupt(uvm_channel_get_gpu(channel)->parent, channel_completion_wait_is_done, &wait);
+    (void)atomic_dec_return(&channel->num_completion_waiters);
+
+    return true;
+}
+
 NvU32 uvm_channel_update_progress(uvm_channel_t *channel)
 {
     // By default, don't complete too many entries at a time to spread the cost
@@ -208,6 +328,20 @@ NvU32 uvm_channel_manager_update_progress(uvm_channel_manager_t *channel_manager
     return pending_gpfifos;
 }
 
+void uvm_channel_pool_get_usage(uvm_channel_pool_t *pool,
+                                NvU64 *completed_pushes,
+                                NvU64 *completed_copy_bytes,
+                                NvU64 *outstanding_copy_bytes)
+{
+    channel_pool_lock(pool);
+
+    *completed_pushes = pool->completed_pushes;
+    *completed_copy_bytes = pool->completed_copy_bytes;
+    *outstanding_copy_bytes = pool->outstanding_copy_bytes;
+
+    channel_pool_unlock(pool);
+}
+
 static NvU32 channel_get_available_gpfifo_entries(uvm_channel_t *channel)
 {
     NvU32 available = channel->num_gpfifo_entries;
@@ -391,6 +525,25 @@ done:
     return NV_OK;
 }
 
+// Request a channel to be added to the pool once a reservation has waited for
+// more than uvm_channel_ce_pool_grow_wait_us for one to become available.
+static void channel_pool_request_grow(uvm_channel_pool_t *pool, uvm_spin_loop_t *spin)
+{
+    uvm_channel_manager_t *manager = pool->manager;
+    NvU64 wait_ns = (NvU64)uvm_channel_ce_pool_grow_wait_us * 1000;
+
+    if (UVM_READ_ONCE(pool->num_channels) >= pool->max_channels)
+        return;
+
+    if (NV_GETTIME() - spin->start_time_ns < wait_ns)
+        return;
+
+    if (nv_atomic_cmpxchg(&pool->grow_requested, 0, 1) != 0)
+        return;
+
+    nv_kthread_q_schedule_q_item(&g_uvm_global.global_q, &manager->grow_q_item);
+}
+
 // Reserve a channel in the specified pool
 static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t **channel_out)
 {
@@ -402,14 +555,31 @@ static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t
     if (uvm_conf_computing_mode_enabled(pool->manager->gpu))
         return channel_reserve_and_lock_in_pool(pool, channel_out);
 
+    // Prefer the channel with the fewest outstanding bytes, which is usually
+    // an idle one.
+    channel_pool_lock(pool);
+    *channel_out = NULL;
     uvm_for_each_channel_in_pool(channel, pool) {
-        // TODO: Bug 1764953: Prefer idle/less busy channels
-        if (try_claim_channel(channel, 1)) {
+        if (channel_get_available_gpfifo_entries(channel) == 0)
+            continue;
+
+        if (!*channel_out || channel->outstanding_copy_bytes < (*channel_out)->outstanding_copy_bytes)
             *channel_out = channel;
-            return NV_OK;
-        }
+
+        if (channel->outstanding_copy_bytes == 0)
+            break;
+    }
+
+    if (*channel_out) {
+        bool claimed = try_claim_channel_locked(*channel_out, 1);
+
+        UVM_ASSERT(claimed);
+        channel_pool_unlock(pool);
+        return NV_OK;
     }
 
+    channel_pool_unlock(pool);
+
     uvm_spin_loop_init(&spin);
     while (1) {
         uvm_for_each_channel_in_pool(channel, pool) {
@@ -429,6 +599,8 @@ static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t
 
             UVM_SPIN_LOOP(&spin);
         }
+
+        channel_pool_request_grow(pool, &spin);
     }
 
     UVM_ASSERT_MSG(0, "Cannot get here?!\n");
@@ -436,13 +608,61 @@ static NV_STATUS channel_reserve_in_pool(uvm_channel_pool_t *pool, uvm_channel_t
     return NV_ERR_GENERIC;
 }
 
-NV_STATUS uvm_channel_reserve_type(uvm_channel_manager_t *manager, uvm_channel_type_t type, uvm_channel_t **channel_out)
+// Pick the pool to use for a push of the given type. The default pool is used
+// until it has more than the threshold of copy bytes outstanding, or while a
+// bulk operation is in progress, at which point the least loaded of the
+// balanced pools is picked. Pushes of the same type can then land on
+// different CEs, so ordering between them relies on the trackers that the
+// callers already acquire, as it does for different channels of the same
+// pool.
+static uvm_channel_pool_t *channel_manager_pick_pool(uvm_channel_manager_t *manager, uvm_channel_type_t type)
 {
     uvm_channel_pool_t *pool = manager->pool_to_use.default_for_type[type];
+    NvU64 threshold = (NvU64)uvm_channel_ce_load_balance_threshold_kb * 1024;
+    NvU64 min_bytes;
+    unsigned i;
+
+    if (type >= UVM_CHANNEL_TYPE_CE_COUNT || manager->pool_to_use.num_balanced_for_type[type] < 2)
+        return pool;
+
+    min_bytes = UVM_READ_ONCE(pool->outstanding_copy_bytes);
+    if (min_bytes <= threshold && atomic_read(&manager->num_bulk_users) == 0)
+        return pool;
+
+    for (i = 1; i < manager->pool_to_use.num_balanced_for_type[type]; i++) {
+        uvm_channel_pool_t *candidate = manager->pool_to_use.balanced_for_type[type][i];
+        NvU64 bytes = UVM_READ_ONCE(candidate->outstanding_copy_bytes);
+
+        if (bytes < min_bytes) {
+            pool = candidate;
+            min_bytes = bytes;
+        }
+    }
+
+    return pool;
+}
+
+void uvm_channel_manager_bulk_begin(uvm_channel_manager_t *manager)
+{
+    atomic_inc(&manager->num_bulk_users);
+}
+
+void uvm_channel_manager_bulk_end(uvm_channel_manager_t *manager)
+{
+    UVM_ASSERT(atomic_read(&manager->num_bulk_users) > 0);
+
+    (void)atomic_dec_return(&manager->num_bulk_users);
+}
+
+NV_STATUS uvm_channel_reserve_type(uvm_channel_manager_t *manager, uvm_channel_type_t type, uvm_channel_t **channel_out)
+{
+    uvm_channel_pool_t *pool;
 
-    UVM_ASSERT(pool != NULL);
     UVM_ASSERT(type < UVM_CHANNEL_TYPE_COUNT);
 
+    pool = channel_manager_pick_pool(manager, type);
+    UVM_ASSERT(pool != NULL);
+
     return channel_reserve_in_pool(pool, channel_out);
 }
 
@@ -658,8 +878,10 @@ static void do_semaphore_release(uvm_push_t *push, NvU64 semaphore_va, NvU32 new
         gpu->parent->sec2_hal->semaphore_release(push, semaphore_va, new_payload);
 }
 
-static void uvm_channel_tracking_semaphore_release(uvm_push_t *push, NvU64 semaphore_va, NvU32 new_payload)
+static void uvm_channel_tracking_semaphore_release(uvm_push_t *push, NvU64 semaphore_va, NvU64 new_payload)
 {
+    uvm_gpu_t *gpu = uvm_push_get_gpu(push);
+
     // We used to skip the membar or use membar GPU for the semaphore release
     // for a few pushes, but that doesn't provide sufficient ordering guarantees
     // in some cases (e.g. ga100 with an LCE with PCEs from both HSHUBs) for the
@@ -668,7 +890,10 @@ static void uvm_channel_tracking_semaphore_release(uvm_push_t *push, NvU64 semap
     (void)uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_GPU);
     (void)uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
 
-    do_semaphore_release(push, semaphore_va, new_payload);
+    if (push->channel->tracking_sem.semaphore.payload_64bit)
+        gpu->parent->ce_hal->semaphore_release_64(push, semaphore_va, new_payload);
+    else
+        do_semaphore_release(push, semaphore_va, (NvU32)new_payload);
 
     // When the Confidential Computing feature is enabled, additional work
     // needs to be scheduled to get an encrypted shadow copy in unprotected
@@ -1085,6 +1310,22 @@ static void encrypt_push(uvm_push_t *push)
                                  auth_tag_gpu_va);
 }
 
+static bool channel_push_needs_completion_interrupt(uvm_channel_t *channel, uvm_push_t *push)
+{
+    if (!uvm_channel_interrupt_completion)
+        return false;
+
+    // SEC2 channels have no host methods, and the indirect submission paths
+    // of Confidential Computing have their own fixed push layouts.
+    if (!uvm_channel_is_ce(channel) || uvm_channel_is_proxy(channel) || uvm_conf_computing_mode_enabled(push->gpu))
+        return false;
+
+    if (atomic_read(&channel->num_completion_waiters) > 0)
+        return true;
+
+    return push->copy_bytes >= (NvU64)uvm_channel_interrupt_completion_min_kb * 1024;
+}
+
 void uvm_channel_end_push(uvm_push_t *push)
 {
     uvm_channel_t *channel = push->channel;
@@ -1093,7 +1334,6 @@ void uvm_channel_end_push(uvm_push_t *push)
     uvm_gpfifo_entry_t *entry;
     NvU64 semaphore_va;
     NvU64 new_tracking_value;
-    NvU32 new_payload;
     NvU32 push_size;
     NvU32 cpu_put;
     NvU32 new_cpu_put;
@@ -1105,10 +1345,18 @@ void uvm_channel_end_push(uvm_push_t *push)
     encrypt_push(push);
 
     new_tracking_value = ++channel->tracking_sem.queued_value;
-    new_payload = (NvU32)new_tracking_value;
 
     semaphore_va = uvm_channel_tracking_semaphore_get_gpu_va(channel);
-    uvm_channel_tracking_semaphore_release(push, semaphore_va, new_payload);
+    uvm_channel_tracking_semaphore_release(push, semaphore_va, new_tracking_value);
+
+    if (channel_push_needs_completion_interrupt(channel, push)) {
+        // Host does not wait for the CE semaphore release before processing
+        // the interrupt method, so idle the channel first. Otherwise a woken
+        // waiter could find the value not yet released and park again.
+        gpu->parent->host_hal->wait_for_idle(push);
+        gpu->parent->host_hal->interrupt(push);
+        UVM_WRITE_ONCE(channel->completion_interrupt_value, new_tracking_value);
+    }
 
     if (uvm_channel_is_wlc(channel) && uvm_channel_manager_is_wlc_ready(channel_manager)) {
         uvm_channel_t *paired_lcic = wlc_get_paired_lcic(channel);
@@ -1148,6 +1396,15 @@ void uvm_channel_end_push(uvm_push_t *push)
         entry->pushbuffer_size = UVM_ALIGN_UP(push_size, UVM_CONF_COMPUTING_BUF_ALIGNMENT);
     entry->push_info = &channel->push_infos[push->push_info_index];
     entry->type = UVM_GPFIFO_ENTRY_TYPE_NORMAL;
+    entry->copy_bytes = push->copy_bytes;
+    entry->channel_type = push->channel_type;
+    if (push->channel_type < UVM_CHANNEL_TYPE_CE_COUNT) {
+        entry->queue_ns = push->queue_ns;
+        entry->end_time_ns = NV_GETTIME();
+    }
+
+    channel->outstanding_copy_bytes += push->copy_bytes;
+    UVM_WRITE_ONCE(channel->pool->outstanding_copy_bytes, channel->pool->outstanding_copy_bytes + push->copy_bytes);
 
     UVM_ASSERT(channel->current_gpfifo_count > 0);
     --channel->current_gpfifo_count;
@@ -1808,7 +2065,7 @@ static void channel_destroy(uvm_channel_pool_t *pool, uvm_channel_t *channel)
 {
     uvm_gpu_t *gpu = uvm_channel_get_gpu(channel);
 
-    UVM_ASSERT(pool->num_channels > 0);
+    UVM_ASSERT(uvm_channel_index_in_pool(channel) < pool->max_channels);
 
     if (channel->tracking_sem.queued_value > 0) {
         // The channel should have been idled before being destroyed, unless an
@@ -1843,8 +2100,6 @@ static void channel_destroy(uvm_channel_pool_t *pool, uvm_channel_t *channel)
 
     UVM_ASSERT(list_empty(&channel->tools.channel_list_node));
     UVM_ASSERT(channel->tools.pending_event_count == 0);
-
-    pool->num_channels--;
 }
 
 static unsigned channel_pool_type_num_gpfifo_entries(uvm_channel_manager_t *manager, uvm_channel_pool_type_t pool_type)
@@ -1985,7 +2240,6 @@ static NV_STATUS channel_create(uvm_channel_pool_t *pool, uvm_channel_t *channel
     UVM_ASSERT(channel != NULL);
 
     channel->pool = pool;
-    pool->num_channels++;
     INIT_LIST_HEAD(&channel->available_push_infos);
     channel->tools.pending_event_count = 0;
     INIT_LIST_HEAD(&channel->tools.channel_list_node);
@@ -1993,7 +2247,15 @@ static NV_STATUS channel_create(uvm_channel_pool_t *pool, uvm_channel_t *channel
     if (uvm_conf_computing_mode_enabled(gpu) && uvm_channel_is_ce(channel))
         semaphore_pool = gpu->secure_semaphore_pool;
 
-    status = uvm_gpu_tracking_semaphore_alloc(semaphore_pool, &channel->tracking_sem);
+    // 64-bit tracking semaphores make completion checks a single lock-free
+    // read. Secure semaphores are decrypted from a 32-bit payload and SEC2
+    // only releases 32-bit semaphores.
+    if (gpu->parent->ce_semaphore_release_64_supported &&
+        uvm_channel_is_ce(channel) &&
+        !uvm_conf_computing_mode_enabled(gpu))
+        status = uvm_gpu_tracking_semaphore_alloc_64(semaphore_pool, &channel->tracking_sem);
+    else
+        status = uvm_gpu_tracking_semaphore_alloc(semaphore_pool, &channel->tracking_sem);
     if (status != NV_OK) {
         UVM_ERR_PRINT("uvm_gpu_tracking_semaphore_alloc() failed: %s, GPU %s\n",
                       nvstatusToString(status),
@@ -2125,10 +2387,35 @@ static bool channel_manager_uses_proxy_pool(uvm_channel_manager_t *manager)
     return uvm_gpu_is_virt_mode_sriov_heavy(manager->gpu);
 }
 
+// Number of channels CE pools can grow to
+static unsigned ce_pool_max_channels(uvm_channel_manager_t *manager)
+{
+    // Channels added at runtime are not supported in Confidential Computing,
+    // as the push semaphore of the pool is sized when the pool is created.
+    if (uvm_conf_computing_mode_enabled(manager->gpu) || uvm_channel_ce_pool_grow_wait_us == 0)
+        return 0;
+
+    return min(uvm_channel_ce_pool_max_channels, (unsigned)UVM_CHANNEL_MAX_NUM_CHANNELS_PER_POOL);
+}
+
+// Number of channels initially created in each CE pool. By default, one
+// channel per replayable fault service worker plus one for everything else,
+// and at least one per 16 CPUs for the pushes issued from CPU threads.
+static unsigned ce_pool_num_channels(uvm_channel_manager_t *manager)
+{
+    unsigned num_channels = uvm_channel_ce_pool_channels;
+
+    if (num_channels == 0) {
+        num_channels = manager->gpu->parent->fault_buffer_info.replayable.parallel.worker_count + 1;
+        num_channels = max(num_channels, (unsigned)present_processors / 16);
+        num_channels = max(num_channels, 2u);
+    }
+
+    return min(num_channels, (unsigned)UVM_CHANNEL_MAX_NUM_CHANNELS_PER_POOL);
+}
+
 // Number of channels to create in a pool of the given type.
-//
-// TODO: Bug 1764958: Tweak this function after benchmarking real workloads.
-static unsigned channel_pool_type_num_channels(uvm_channel_pool_type_t pool_type)
+static unsigned channel_pool_type_num_channels(uvm_channel_manager_t *manager, uvm_channel_pool_type_t pool_type)
 {
     // TODO: Bug 3387454: The vGPU plugin implementation supports a single
     // proxy channel per GPU
@@ -2144,16 +2431,16 @@ static unsigned channel_pool_type_num_channels(uvm_channel_pool_type_t pool_type
     if (pool_type == UVM_CHANNEL_POOL_TYPE_WLC || pool_type == UVM_CHANNEL_POOL_TYPE_LCIC)
         return UVM_PUSH_MAX_CONCURRENT_PUSHES;
 
-    return 2;
+    return ce_pool_num_channels(manager);
 }
 
 // Number of TSGs to create in a pool of a given type.
-static unsigned channel_pool_type_num_tsgs(uvm_channel_pool_type_t pool_type)
+static unsigned channel_pool_type_num_tsgs(uvm_channel_manager_t *manager, uvm_channel_pool_type_t pool_type)
 {
     // For WLC and LCIC channels, we create one TSG per WLC/LCIC channel pair.
     // The TSG is stored in the WLC pool.
     if (pool_type == UVM_CHANNEL_POOL_TYPE_WLC)
-        return channel_pool_type_num_channels(pool_type);
+        return channel_pool_type_num_channels(manager, pool_type);
     else if (pool_type == UVM_CHANNEL_POOL_TYPE_LCIC)
         return 0;
 
@@ -2207,8 +2494,10 @@ static void channel_pool_destroy(uvm_channel_pool_t *pool)
 {
     UVM_ASSERT(pool->manager->num_channel_pools > 0);
 
-    while (pool->num_channels > 0)
+    while (pool->num_channels > 0) {
         channel_destroy(pool, pool->channels + pool->num_channels - 1);
+        pool->num_channels--;
+    }
     uvm_kvfree(pool->channels);
     pool->channels = NULL;
 
@@ -2240,7 +2529,7 @@ static NV_STATUS channel_pool_add(uvm_channel_manager_t *channel_manager,
     pool->engine_index = engine_index;
     pool->pool_type = pool_type;
 
-    num_tsgs = channel_pool_type_num_tsgs(pool_type);
+    num_tsgs = channel_pool_type_num_tsgs(channel_manager, pool_type);
     if (num_tsgs != 0) {
         pool->tsg_handles = uvm_kvmalloc_zero(sizeof(*pool->tsg_handles) * num_tsgs);
         if (!pool->tsg_handles) {
@@ -2259,9 +2548,13 @@ static NV_STATUS channel_pool_add(uvm_channel_manager_t *channel_manager,
 
     channel_pool_lock_init(pool);
 
-    num_channels = channel_pool_type_num_channels(pool_type);
+    num_channels = channel_pool_type_num_channels(channel_manager, pool_type);
     UVM_ASSERT(num_channels <= UVM_CHANNEL_MAX_NUM_CHANNELS_PER_POOL);
 
+    pool->max_channels = num_channels;
+    if (pool_type == UVM_CHANNEL_POOL_TYPE_CE)
+        pool->max_channels = max(num_channels, ce_pool_max_channels(channel_manager));
+
     if (uvm_conf_computing_mode_enabled(channel_manager->gpu)) {
         // Use different order lock for SEC2 and WLC channels.
         // This allows reserving a SEC2 or WLC channel for indirect work
@@ -2273,7 +2566,7 @@ static NV_STATUS channel_pool_add(uvm_channel_manager_t *channel_manager,
         uvm_sema_init(&pool->push_sem, num_channels, order);
     }
 
-    pool->channels = uvm_kvmalloc_zero(sizeof(*pool->channels) * num_channels);
+    pool->channels = uvm_kvmalloc_zero(sizeof(*pool->channels) * pool->max_channels);
     if (!pool->channels) {
         status = NV_ERR_NO_MEMORY;
         goto error;
@@ -2286,6 +2579,8 @@ static NV_STATUS channel_pool_add(uvm_channel_manager_t *channel_manager,
         if (status != NV_OK)
             goto error;
 
+        pool->num_channels++;
+
         status = channel_init(channel);
         if (status != NV_OK)
             goto error;
@@ -2299,6 +2594,70 @@ static NV_STATUS channel_pool_add(uvm_channel_manager_t *channel_manager,
     return status;
 }
 
+// Add a channel to the pool. The channel is published by incrementing
+// num_channels only once it is fully initialized.
+static NV_STATUS channel_pool_grow(uvm_channel_pool_t *pool)
+{
+    NV_STATUS status;
+    uvm_channel_t *channel = pool->channels + pool->num_channels;
+
+    UVM_ASSERT(pool->num_channels < pool->max_channels);
+
+    status = channel_create(pool, channel);
+    if (status != NV_OK)
+        return status;
+
+    status = channel_init(channel);
+    if (status != NV_OK) {
+        channel_destroy(pool, channel);
+        memset(channel, 0, sizeof(*channel));
+        return status;
+    }
+
+    channel_pool_lock(pool);
+
+    // Order the initialization of the channel before its publication to the
+    // reservations that iterate over the pool without the pool lock
+    mb();
+    UVM_WRITE_ONCE(pool->num_channels, pool->num_channels + 1);
+
+    channel_pool_unlock(pool);
+
+    return NV_OK;
+}
+
+static void channel_manager_grow_pools(void *args)
+{
+    uvm_channel_manager_t *manager = (uvm_channel_manager_t *)args;
+    uvm_channel_pool_t *pool;
+
+    if (UVM_READ_ONCE(manager->grow_disabled))
+        return;
+
+    uvm_for_each_pool_of_type(pool, manager, UVM_CHANNEL_POOL_TYPE_CE) {
+        NV_STATUS status;
+
+        if (atomic_read(&pool->grow_requested) == 0)
+            continue;
+
+        if (pool->num_channels < pool->max_channels) {
+            status = channel_pool_grow(pool);
+            if (status != NV_OK) {
+                UVM_ERR_PRINT("Adding a channel failed: %s, GPU %s, CE %u\n",
+                              nvstatusToString(status),
+                              uvm_gpu_name(manager->gpu),
+                              pool->engine_index);
+
+                // Stop growing the pool, it keeps working with the channels
+                // it already has
+                pool->max_channels = pool->num_channels;
+            }
+        }
+
+        atomic_set(&pool->grow_requested, 0);
+    }
+}
+
 static bool ce_usable_for_channel_type(uvm_channel_type_t type, const UvmGpuCopyEngineCaps *cap)
 {
     if (!cap->supported || cap->grce)
@@ -2466,6 +2825,46 @@ static NV_STATUS pick_ce_for_channel_type(uvm_channel_manager_t *manager,
     return NV_OK;
 }
 
+// Collect the CEs that transfers of the given type can be spread across: the
+// preferred CE, plus any other usable CE with the same sysmem bandwidth that
+// doesn't share PCEs with the ones already picked. NvLink P2P CEs are left to
+// GPU_TO_GPU transfers unless the preferred CE is one of them.
+static void pick_balanced_ces_for_channel_type(uvm_channel_manager_t *manager,
+                                               const UvmGpuCopyEngineCaps *ce_caps,
+                                               uvm_channel_type_t type,
+                                               const unsigned *preferred_ce)
+{
+    const UvmGpuCopyEngineCaps *best_cap = ce_caps + preferred_ce[type];
+    NvU32 pce_mask = best_cap->cePceMask;
+    NvU32 i;
+
+    UVM_ASSERT(type == UVM_CHANNEL_TYPE_CPU_TO_GPU || type == UVM_CHANNEL_TYPE_GPU_TO_CPU);
+
+    manager->balanced_ce_mask[type] = NVBIT(preferred_ce[type]);
+
+    for (i = 0; i < UVM_COPY_ENGINE_COUNT_MAX; ++i) {
+        const UvmGpuCopyEngineCaps *cap = ce_caps + i;
+
+        if (i == preferred_ce[type] || !ce_usable_for_channel_type(type, cap))
+            continue;
+
+        if (type == UVM_CHANNEL_TYPE_CPU_TO_GPU && cap->sysmemRead != best_cap->sysmemRead)
+            continue;
+
+        if (type == UVM_CHANNEL_TYPE_GPU_TO_CPU && cap->sysmemWrite != best_cap->sysmemWrite)
+            continue;
+
+        if (cap->nvlinkP2p && !best_cap->nvlinkP2p)
+            continue;
+
+        if (cap->cePceMask & pce_mask)
+            continue;
+
+        pce_mask |= cap->cePceMask;
+        manager->balanced_ce_mask[type] |= NVBIT(i);
+    }
+}
+
 static NV_STATUS channel_manager_pick_copy_engines(uvm_channel_manager_t *manager, unsigned *preferred_ce)
 {
     NV_STATUS status;
@@ -2495,6 +2894,13 @@ static NV_STATUS channel_manager_pick_copy_engines(uvm_channel_manager_t *manage
             goto out;
     }
 
+    // Confidential Computing pairs the CPU_TO_GPU pool with the WLC/LCIC
+    // channels, so keep every type on its preferred CE.
+    if (uvm_channel_ce_load_balance && !uvm_conf_computing_mode_enabled(manager->gpu)) {
+        pick_balanced_ces_for_channel_type(manager, ces_caps->copyEngineCaps, UVM_CHANNEL_TYPE_CPU_TO_GPU, preferred_ce);
+        pick_balanced_ces_for_channel_type(manager, ces_caps->copyEngineCaps, UVM_CHANNEL_TYPE_GPU_TO_CPU, preferred_ce);
+    }
+
 out:
     uvm_kvfree(ces_caps);
 
@@ -2751,6 +3157,22 @@ static NV_STATUS channel_manager_create_ce_pools(uvm_channel_manager_t *manager,
         }
     }
 
+    for (type = 0; type < UVM_CHANNEL_TYPE_CE_COUNT; type++) {
+        unsigned *num_pools = &manager->pool_to_use.num_balanced_for_type[type];
+
+        if (!manager->balanced_ce_mask[type])
+            continue;
+
+        // The default pool goes first, so that it is kept when the load is
+        // even.
+        manager->pool_to_use.balanced_for_type[type][(*num_pools)++] = manager->pool_to_use.default_for_type[type];
+
+        for (ce = 0; ce < UVM_COPY_ENGINE_COUNT_MAX; ce++) {
+            if (ce != preferred_ce[type] && (manager->balanced_ce_mask[type] & NVBIT(ce)))
+                manager->pool_to_use.balanced_for_type[type][(*num_pools)++] = channel_manager_ce_pool(manager, ce);
+        }
+    }
+
     return NV_OK;
 }
 
@@ -3193,6 +3615,7 @@ NV_STATUS uvm_channel_manager_create(uvm_gpu_t *gpu, uvm_channel_manager_t **cha
         return NV_ERR_NO_MEMORY;
 
     channel_manager->gpu = gpu;
+    nv_kthread_q_item_init(&channel_manager->grow_q_item, channel_manager_grow_pools, channel_manager);
     init_channel_manager_conf(channel_manager);
     status = uvm_pushbuffer_create(channel_manager, &channel_manager->pushbuffer);
     if (status != NV_OK)
@@ -3275,6 +3698,11 @@ void uvm_channel_manager_destroy(uvm_channel_manager_t *channel_manager)
     if (channel_manager == NULL)
         return;
 
+    // Wait for any pending pool growth, and prevent pools from growing while
+    // they are destroyed
+    UVM_WRITE_ONCE(channel_manager->grow_disabled, true);
+    nv_kthread_q_flush(&g_uvm_global.global_q);
+
     if (uvm_channel_manager_is_wlc_ready(channel_manager))
         channel_manager_stop_wlc(channel_manager);
 
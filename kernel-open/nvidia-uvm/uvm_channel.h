@@ -187,8 +187,38 @@ struct uvm_gpfifo_entry_struct
 
     // Push info for the pending push that used this GPFIFO entry
     uvm_push_info_t *push_info;
+
+    // Bytes copied by the push, accounted in the outstanding bytes of the
+    // channel and its pool until the entry completes.
+    NvU64 copy_bytes;
+
+    // Channel type the push was begun for, see uvm_push_t::channel_type.
+    uvm_channel_type_t channel_type;
+
+    // Time the push waited for a channel and pushbuffer space, and time it
+    // ended, in ns. Only set for pushes accounted in the push latency stats.
+    NvU64 queue_ns;
+    NvU64 end_time_ns;
 };
 
+// Number of buckets in the push latency histograms. Bucket i counts the
+// latencies in [2^i, 2^(i+1)) ns, the first bucket also counts the 0 ns ones
+// and the last one everything above.
+#define UVM_PUSH_LATENCY_BUCKETS 32
+
+// Latency of the pushes of a channel type completed on a GPU. Queueing is the
+// time spent waiting for a channel and pushbuffer space when the push begins,
+// execution is the time from the end of the push until its tracking semaphore
+// release is observed by the CPU.
+typedef struct
+{
+    atomic64_t pushes;
+    atomic64_t queue_ns;
+    atomic64_t exec_ns;
+    atomic64_t queue_histogram[UVM_PUSH_LATENCY_BUCKETS];
+    atomic64_t exec_histogram[UVM_PUSH_LATENCY_BUCKETS];
+} uvm_push_latency_stats_t;
+
 // A channel pool is a set of channels that use the same engine. For example,
 // all channels in a CE pool share the same (logical) Copy Engine.
 typedef struct
@@ -212,9 +242,19 @@ typedef struct
     // Channels in this pool
     uvm_channel_t *channels;
 
-    // Number of elements in the channel array
+    // Number of channels in the pool. CE pools can grow while they are in use,
+    // in which case a newly added channel is fully initialized before
+    // num_channels is incremented. Code iterating over the channels without
+    // the pool lock only ever sees initialized channels.
     NvU32 num_channels;
 
+    // Number of elements in the channel array, which is the number of
+    // channels the pool can grow to
+    NvU32 max_channels;
+
+    // Set while a channel addition is pending for the pool
+    atomic_t grow_requested;
+
     // Index of the engine associated with the pool (index is an offset from the
     // first engine of the same engine type.)
     unsigned engine_index;
@@ -243,6 +283,16 @@ typedef struct
     // acquired before submitting work to a channel when the Confidential
     // Computing feature is enabled.
     uvm_semaphore_t push_sem;
+
+    // Bytes copied by pushes submitted to the channels in this pool that have
+    // not completed yet. Protected by the pool lock, but read without it when
+    // picking the least loaded pool.
+    NvU64 outstanding_copy_bytes;
+
+    // Totals of the pushes completed on the channels in this pool, and of the
+    // bytes they copied. Protected by the pool lock.
+    NvU64 completed_pushes;
+    NvU64 completed_copy_bytes;
 } uvm_channel_pool_t;
 
 struct uvm_channel_struct
@@ -275,6 +325,21 @@ struct uvm_channel_struct
     // there is a free GPFIFO entry for it.
     NvU32 current_gpfifo_count;
 
+    // Bytes copied by the pending pushes on the channel. Protected by the pool
+    // lock.
+    NvU64 outstanding_copy_bytes;
+
+    // Tracking value of the latest push that ends with a nonstall interrupt,
+    // see uvm_channel_wait_for_completion_interrupt(). Written under the pool
+    // lock, read locklessly.
+    NvU64 completion_interrupt_value;
+
+    // Number of contexts parked in uvm_channel_wait_for_completion_interrupt()
+    // on the channel. While non-zero, every push on the channel ends with a
+    // nonstall interrupt, so that waiters queued behind it are woken as soon
+    // as the channel makes progress.
+    atomic_t num_completion_waiters;
+
     // Array of uvm_push_info_t for all pending pushes on the channel
     uvm_push_info_t *push_infos;
 
@@ -436,14 +501,40 @@ struct uvm_channel_manager_struct
         // If there is no optimal pool (the entry is NULL), use default pool
         // default_for_type[UVM_CHANNEL_GPU_TO_GPU] instead.
         uvm_channel_pool_t *gpu_to_gpu[UVM_ID_MAX_GPUS];
+
+        // Pools that CPU_TO_GPU and GPU_TO_CPU transfers are spread across
+        // once the default pool has enough outstanding bytes queued. The
+        // default pool is always the first entry. Pools are backed by CEs
+        // with the same sysmem bandwidth class that don't share PCEs.
+        uvm_channel_pool_t *balanced_for_type[UVM_CHANNEL_TYPE_CE_COUNT][UVM_COPY_ENGINE_COUNT_MAX];
+        unsigned num_balanced_for_type[UVM_CHANNEL_TYPE_CE_COUNT];
     } pool_to_use;
 
+    // Mask of the CEs used to populate pool_to_use.balanced_for_type.
+    NvU32 balanced_ce_mask[UVM_CHANNEL_TYPE_CE_COUNT];
+
+    // Number of bulk operations in progress, see
+    // uvm_channel_manager_bulk_begin().
+    atomic_t num_bulk_users;
+
+    // Latency of the pushes begun for each CE channel type. Pushes begun on a
+    // given channel are not accounted.
+    uvm_push_latency_stats_t push_latency[UVM_CHANNEL_TYPE_CE_COUNT];
+
     struct
     {
         struct proc_dir_entry *channels_dir;
         struct proc_dir_entry *pending_pushes;
     } procfs;
 
+    // Adds channels to the pools with grow_requested set. Pools are grown from
+    // the global queue as channel creation calls into RM and pushes, while
+    // reservations that wait for a channel can happen with any locks held.
+    nv_kthread_q_item_t grow_q_item;
+
+    // Set when the manager starts being destroyed, to stop growing pools
+    bool grow_disabled;
+
     struct
     {
         NvU32 num_gpfifo_entries;
@@ -556,6 +647,14 @@ NV_STATUS uvm_channel_manager_check_errors(uvm_channel_manager_t *channel_manage
 // The channel has to be in error state prior to calling this function.
 uvm_gpfifo_entry_t *uvm_channel_get_fatal_entry(uvm_channel_t *channel);
 
+// Park the calling context until the tracking semaphore of the channel reaches
+// value, a GPU interrupt arrives, or a short watchdog expires. Waits that have
+// lasted less than the configured spin time, and values that no pending
+// nonstall interrupt covers, are left to the caller to poll. Returns true if
+// the context was parked, in which case the caller should recheck completion
+// without further spinning.
+bool uvm_channel_wait_for_completion_interrupt(uvm_channel_t *channel, NvU64 value, NvU64 waited_ns);
+
 // Update progress of a specific channel
 // Returns the number of still pending GPFIFO entries for that channel.
 // Notably some of the pending GPFIFO entries might be already completed, but
@@ -570,11 +669,26 @@ NvU32 uvm_channel_update_progress(uvm_channel_t *channel);
 // cost of the updates across calls.
 NvU32 uvm_channel_manager_update_progress(uvm_channel_manager_t *channel_manager);
 
+// Read the push and copy byte counters of the pool, see uvm_channel_pool_t.
+// They only account for completions already observed by
+// uvm_channel_update_progress().
+void uvm_channel_pool_get_usage(uvm_channel_pool_t *pool,
+                                NvU64 *completed_pushes,
+                                NvU64 *completed_copy_bytes,
+                                NvU64 *outstanding_copy_bytes);
+
 // Wait for all channels to idle
 // It waits for anything that is running, but doesn't prevent new work from
 // beginning.
 NV_STATUS uvm_channel_manager_wait(uvm_channel_manager_t *manager);
 
+// While at least one bulk operation is in progress, CPU_TO_GPU and GPU_TO_CPU
+// pushes go to the least loaded of the balanced pools right away instead of
+// waiting for the default pool to cross the load balancing threshold. Used
+// by transfers that queue enough copies to keep all the CEs busy.
+void uvm_channel_manager_bulk_begin(uvm_channel_manager_t *manager);
+void uvm_channel_manager_bulk_end(uvm_channel_manager_t *manager);
+
 // Check if WLC/LCIC mechanism is ready/setup
 // Should only return false during initialization
 static bool uvm_channel_manager_is_wlc_ready(uvm_channel_manager_t *manager)
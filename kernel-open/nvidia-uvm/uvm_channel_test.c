@@ -1146,3 +1146,45 @@ NV_STATUS uvm_test_channel_stress(UVM_TEST_CHANNEL_STRESS_PARAMS *params, struct
             return NV_ERR_INVALID_PARAMETER;
     }
 }
+
+NV_STATUS uvm_test_ce_usage(UVM_TEST_CE_USAGE_PARAMS *params, struct file *filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_channel_pool_t *pool;
+    uvm_gpu_t *gpu;
+    NV_STATUS status = NV_OK;
+
+    uvm_va_space_down_read(va_space);
+
+    gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->gpu_uuid);
+    if (!gpu) {
+        status = NV_ERR_INVALID_DEVICE;
+        goto done;
+    }
+
+    params->ce_mask = 0;
+    memset(params->completed_pushes, 0, sizeof(params->completed_pushes));
+    memset(params->completed_copy_bytes, 0, sizeof(params->completed_copy_bytes));
+    memset(params->outstanding_copy_bytes, 0, sizeof(params->outstanding_copy_bytes));
+
+    // Pick up completions that nobody has observed yet
+    uvm_channel_manager_update_progress(gpu->channel_manager);
+
+    uvm_for_each_pool_of_type(pool, gpu->channel_manager, UVM_CHANNEL_POOL_TYPE_CE) {
+        NvU64 pushes, copy_bytes, outstanding_bytes;
+
+        UVM_ASSERT(pool->engine_index < UVM_COPY_ENGINE_COUNT_MAX);
+
+        uvm_channel_pool_get_usage(pool, &pushes, &copy_bytes, &outstanding_bytes);
+
+        params->ce_mask |= 1u << pool->engine_index;
+        params->completed_pushes[pool->engine_index] += pushes;
+        params->completed_copy_bytes[pool->engine_index] += copy_bytes;
+        params->outstanding_copy_bytes[pool->engine_index] += outstanding_bytes;
+    }
+
+done:
+    uvm_va_space_up_read(va_space);
+
+    return status;
+}
@@ -25,6 +25,11 @@
 #define UVM_SPIN_LOOP_SCHEDULE_TIMEOUT_NS   (10*1000ULL)
 #define UVM_SPIN_LOOP_PRINT_TIMEOUT_SEC     30ULL
 
+// Upper bound of a single monitored wait in uvm_spin_loop_wait_on(), in TSC
+// cycles. Short enough that missed wakeups (e.g. a payload in uncached memory)
+// only cost what a few pauses would.
+#define UVM_SPIN_LOOP_MONITOR_WAIT_CYCLES   10000ULL
+
 // Default to debug prints being enabled for debug and develop builds and
 // disabled for release builds.
 static int uvm_debug_prints = UVM_IS_DEBUG() || UVM_IS_DEVELOP();
@@ -258,7 +263,105 @@ void on_uvm_assert(void)
 #endif
 }
 
+#if defined(NVCPU_X86_64)
+
+#define UVM_CPUID_7_ECX_WAITPKG     NVBIT(5)
+
+static bool monitor_wait_supported(void)
+{
+    // 0: not probed yet, 1: supported, -1: unsupported. Racing probes all
+    // store the same result.
+    static int supported;
+    int cached = UVM_READ_ONCE(supported);
+    u32 v[4];
+
+    if (cached != 0)
+        return cached > 0;
+
+    cpuid(7, 0, v);
+    cached = (v[2] & UVM_CPUID_7_ECX_WAITPKG) ? 1 : -1;
+    UVM_WRITE_ONCE(supported, cached);
+
+    return cached > 0;
+}
+
+static bool monitor_wait(const volatile NvU32 *addr, NvU32 value)
+{
+    NvU32 lo, hi;
+    NvU64 deadline;
+
+    if (!monitor_wait_supported())
+        return false;
+
+    asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+    deadline = (((NvU64)hi << 32) | lo) + UVM_SPIN_LOOP_MONITOR_WAIT_CYCLES;
+
+    // umonitor %rax
+    asm volatile(".byte 0xf3, 0x0f, 0xae, 0xf0" : : "a" (addr) : "memory");
+
+    // Re-check after arming the monitor, a write in between would be missed.
+    if (*addr != value)
+        return true;
+
+    // umwait %ecx, with ecx = 1 requesting the faster waking C0.1 state.
+    asm volatile(".byte 0xf2, 0x0f, 0xae, 0xf1"
+                 :
+                 : "c" (1), "a" ((NvU32)deadline), "d" ((NvU32)(deadline >> 32))
+                 : "cc", "memory");
+
+    return true;
+}
+
+#elif defined(NVCPU_AARCH64)
+
+static bool monitor_wait_supported(void)
+{
+    NvU64 cntkctl;
+
+    // WFE is only bounded if the generic timer event stream is enabled.
+    asm volatile("mrs %0, cntkctl_el1" : "=r" (cntkctl));
+
+    return (cntkctl & NVBIT64(2)) != 0;
+}
+
+static bool monitor_wait(const volatile NvU32 *addr, NvU32 value)
+{
+    NvU32 tmp;
+
+    if (!monitor_wait_supported())
+        return false;
+
+    // The exclusive load arms the monitor; a write to the line clears it and
+    // generates the event that ends the second WFE.
+    asm volatile("sevl\n"
+                 "wfe\n"
+                 "ldxr %w[tmp], %[v]\n"
+                 "eor %w[tmp], %w[tmp], %w[val]\n"
+                 "cbnz %w[tmp], 1f\n"
+                 "wfe\n"
+                 "1:"
+                 : [tmp] "=&r" (tmp)
+                 : [v] "Q" (*addr), [val] "r" (value)
+                 : "memory");
+
+    return true;
+}
+
+#else
+
+static bool monitor_wait(const volatile NvU32 *addr, NvU32 value)
+{
+    return false;
+}
+
+#endif
+
 NV_STATUS uvm_spin_loop(uvm_spin_loop_t *spin)
+{
+    return uvm_spin_loop_wait_on(spin, NULL, 0);
+}
+
+NV_STATUS uvm_spin_loop_wait_on(uvm_spin_loop_t *spin, const volatile NvU32 *addr, NvU32 value)
 {
     NvU64 curr = NV_GETTIME();
 
@@ -281,7 +384,8 @@ NV_STATUS uvm_spin_loop(uvm_spin_loop_t *spin)
         curr = NV_GETTIME();
     }
 
-    kern_pause();
+    if (addr == NULL || !monitor_wait(addr, value))
+        kern_pause();
 
     // TODO: Bug 1710855: Also check fatal_signal_pending() here if the caller can handle it.
 
@@ -293,6 +397,18 @@ NV_STATUS uvm_spin_loop(uvm_spin_loop_t *spin)
     return NV_OK;
 }
 
+NV_STATUS uvm_spin_loop_check_timeout(uvm_spin_loop_t *spin)
+{
+    NvU64 curr = NV_GETTIME();
+
+    if (curr - spin->print_time_ns >= 1000*1000*1000*UVM_SPIN_LOOP_PRINT_TIMEOUT_SEC) {
+        spin->print_time_ns = curr;
+        return NV_ERR_TIMEOUT_RETRY;
+    }
+
+    return NV_OK;
+}
+
 // This formats a GPU UUID, in a UVM-friendly way. That is, nearly the same as
 // what nvidia-smi reports.  It will always prefix the UUID with UVM-GPU so
 // that we know that we have a real, binary formatted UUID that will work in
@@ -303,14 +303,26 @@ static inline void uvm_spin_loop_init(uvm_spin_loop_t *spin)
 // waiting too long, and NV_OK otherwise.
 NV_STATUS uvm_spin_loop(uvm_spin_loop_t *spin);
 
+// Same as uvm_spin_loop(), but for loops waiting on *addr to change from
+// value. Instead of a pause, the CPU waits for a write to the cache line of
+// addr in a low power state (UMONITOR/UMWAIT on x86, WFE on arm64), bounded to
+// a few microseconds. Falls back to a pause if the CPU doesn't support it or
+// addr is NULL. addr has to be in cacheable memory for the write to end the
+// wait early.
+NV_STATUS uvm_spin_loop_wait_on(uvm_spin_loop_t *spin, const volatile NvU32 *addr, NvU32 value);
+
+// The print timeout check of uvm_spin_loop(), for loops that block between
+// iterations instead of spinning.
+NV_STATUS uvm_spin_loop_check_timeout(uvm_spin_loop_t *spin);
+
 static NvU64 uvm_spin_loop_elapsed(const uvm_spin_loop_t *spin)
 {
     NvU64 curr = NV_GETTIME();
     return curr - spin->start_time_ns;
 }
 
-#define UVM_SPIN_LOOP(__spin) ({                                                        \
-    NV_STATUS __status = uvm_spin_loop(__spin);                                         \
+#define UVM_SPIN_LOOP_WAIT_ON(__spin, __addr, __value) ({                               \
+    NV_STATUS __status = uvm_spin_loop_wait_on(__spin, __addr, __value);                \
     if (__status == NV_ERR_TIMEOUT_RETRY) {                                             \
         UVM_DBG_PRINT("Warning: stuck waiting for %llus\n",                             \
                       uvm_spin_loop_elapsed(__spin) / (1000*1000*1000));                \
@@ -321,6 +333,8 @@ static NvU64 uvm_spin_loop_elapsed(const uvm_spin_loop_t *spin)
     __status;                                                                           \
 })
 
+#define UVM_SPIN_LOOP(__spin) UVM_SPIN_LOOP_WAIT_ON(__spin, NULL, 0)
+
 // Execute the loop code while cond is true. Invokes uvm_spin_loop_iter at the
 // end of each iteration.
 #define UVM_SPIN_WHILE(cond, spin)                                                \
@@ -388,6 +388,20 @@ void uvm_conf_computing_log_gpu_encryption(uvm_channel_t *channel, UvmCslIv *iv)
     UVM_ASSERT(status == NV_OK);
 }
 
+void uvm_conf_computing_log_gpu_encryptions(uvm_channel_t *channel, UvmCslIv *ivs, NvU32 count)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    uvm_mutex_lock(&channel->csl.ctx_lock);
+    for (i = 0; i < count && status == NV_OK; i++)
+        status = nvUvmInterfaceCslIncrementIv(&channel->csl.ctx, UVM_CSL_OPERATION_DECRYPT, 1, &ivs[i]);
+    uvm_mutex_unlock(&channel->csl.ctx_lock);
+
+    // See uvm_conf_computing_log_gpu_encryption
+    UVM_ASSERT(status == NV_OK);
+}
+
 void uvm_conf_computing_acquire_encryption_iv(uvm_channel_t *channel, UvmCslIv *iv)
 {
     NV_STATUS status;
@@ -427,6 +441,32 @@ void uvm_conf_computing_cpu_encrypt(uvm_channel_t *channel,
     UVM_ASSERT(status == NV_OK);
 }
 
+void uvm_conf_computing_cpu_encrypt_pages(uvm_channel_t *channel,
+                                          void *dst_cipher,
+                                          const void *src_plain,
+                                          NvU32 page_count,
+                                          void *auth_tag_buffer)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    UVM_ASSERT(page_count);
+
+    uvm_mutex_lock(&channel->csl.ctx_lock);
+    for (i = 0; i < page_count && status == NV_OK; i++) {
+        status = nvUvmInterfaceCslEncrypt(&channel->csl.ctx,
+                                          PAGE_SIZE,
+                                          (NvU8 const *) src_plain + i * PAGE_SIZE,
+                                          NULL,
+                                          (NvU8 *) dst_cipher + i * PAGE_SIZE,
+                                          (NvU8 *) auth_tag_buffer + i * UVM_CONF_COMPUTING_AUTH_TAG_SIZE);
+    }
+    uvm_mutex_unlock(&channel->csl.ctx_lock);
+
+    // See uvm_conf_computing_cpu_encrypt
+    UVM_ASSERT(status == NV_OK);
+}
+
 NV_STATUS uvm_conf_computing_cpu_decrypt(uvm_channel_t *channel,
                                          void *dst_plain,
                                          const void *src_cipher,
@@ -450,6 +490,32 @@ NV_STATUS uvm_conf_computing_cpu_decrypt(uvm_channel_t *channel,
     return status;
 }
 
+NV_STATUS uvm_conf_computing_cpu_decrypt_pages(uvm_channel_t *channel,
+                                               void *dst_plain,
+                                               const void *src_cipher,
+                                               const UvmCslIv *src_ivs,
+                                               NvU32 page_count,
+                                               const void *auth_tag_buffer)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    uvm_mutex_lock(&channel->csl.ctx_lock);
+    for (i = 0; i < page_count && status == NV_OK; i++) {
+        status = nvUvmInterfaceCslDecrypt(&channel->csl.ctx,
+                                          PAGE_SIZE,
+                                          (const NvU8 *) src_cipher + i * PAGE_SIZE,
+                                          &src_ivs[i],
+                                          (NvU8 *) dst_plain + i * PAGE_SIZE,
+                                          NULL,
+                                          0,
+                                          (const NvU8 *) auth_tag_buffer + i * UVM_CONF_COMPUTING_AUTH_TAG_SIZE);
+    }
+    uvm_mutex_unlock(&channel->csl.ctx_lock);
+
+    return status;
+}
+
 NV_STATUS uvm_conf_computing_fault_decrypt(uvm_parent_gpu_t *parent_gpu,
                                            void *dst_plain,
                                            const void *src_cipher,
@@ -149,6 +149,11 @@ void uvm_conf_computing_gpu_deinit(uvm_gpu_t *gpu);
 // Logs encryption information from the GPU and returns the IV.
 void uvm_conf_computing_log_gpu_encryption(uvm_channel_t *channel, UvmCslIv *iv);
 
+// Same as uvm_conf_computing_log_gpu_encryption() for count consecutive GPU
+// encryptions, returning their IVs in ivs[0..count-1]. The CSL context lock is
+// only taken once.
+void uvm_conf_computing_log_gpu_encryptions(uvm_channel_t *channel, UvmCslIv *ivs, NvU32 count);
+
 // Acquires next CPU encryption IV and returns it.
 void uvm_conf_computing_acquire_encryption_iv(uvm_channel_t *channel, UvmCslIv *iv);
 
@@ -164,6 +169,17 @@ void uvm_conf_computing_cpu_encrypt(uvm_channel_t *channel,
                                     size_t size,
                                     void *auth_tag_buffer);
 
+// Encrypt page_count virtually contiguous pages of src_plain into dst_cipher,
+// one message per page using the next IVs in order, as page_count calls to
+// uvm_conf_computing_cpu_encrypt() with a NULL IV would. The authentication tag
+// of page i is written at auth_tag_buffer + i * UVM_CONF_COMPUTING_AUTH_TAG_SIZE.
+// The CSL context lock is only taken once.
+void uvm_conf_computing_cpu_encrypt_pages(uvm_channel_t *channel,
+                                          void *dst_cipher,
+                                          const void *src_plain,
+                                          NvU32 page_count,
+                                          void *auth_tag_buffer);
+
 // CPU side decryption helper. Decrypts data from src_cipher and writes the
 // plain text in dst_plain. src_cipher and dst_plain can't overlap. IV obtained
 // from uvm_conf_computing_log_gpu_encryption() needs to be be passed to src_iv.
@@ -174,6 +190,17 @@ NV_STATUS uvm_conf_computing_cpu_decrypt(uvm_channel_t *channel,
                                          size_t size,
                                          const void *auth_tag_buffer);
 
+// Decrypt page_count virtually contiguous pages encrypted by the GPU one page
+// at a time, page i with src_ivs[i] and the authentication tag at
+// auth_tag_buffer + i * UVM_CONF_COMPUTING_AUTH_TAG_SIZE. Stops at the first
+// failure. The CSL context lock is only taken once.
+NV_STATUS uvm_conf_computing_cpu_decrypt_pages(uvm_channel_t *channel,
+                                               void *dst_plain,
+                                               const void *src_cipher,
+                                               const UvmCslIv *src_ivs,
+                                               NvU32 page_count,
+                                               const void *auth_tag_buffer);
+
 // CPU decryption of a single replayable fault, encrypted by GSP-RM.
 //
 // Replayable fault decryption depends not only on the encrypted fault contents,
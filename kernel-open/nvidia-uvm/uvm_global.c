@@ -31,6 +31,7 @@
 #include "uvm_thread_context.h"
 #include "uvm_va_range.h"
 #include "uvm_kvmalloc.h"
+#include "uvm_tracker.h"
 #include "uvm_mmu.h"
 #include "uvm_perf_heuristics.h"
 #include "uvm_pmm_sysmem.h"
@@ -92,6 +93,12 @@ NV_STATUS uvm_global_init(void)
         goto error;
     }
 
+    status = uvm_tracker_global_init();
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("uvm_tracker_global_init() failed: %s\n", nvstatusToString(status));
+        goto error;
+    }
+
     status = errno_to_nv_status(nv_kthread_q_init(&g_uvm_global.global_q, "UVM global queue"));
     if (status != NV_OK) {
         UVM_DBG_PRINT("nv_kthread_q_init() failed: %s\n", nvstatusToString(status));
@@ -226,6 +233,7 @@ void uvm_global_exit(void)
     uvm_assert_mutex_unlocked(&g_uvm_global.va_spaces.lock);
     UVM_ASSERT(list_empty(&g_uvm_global.va_spaces.list));
 
+    uvm_tracker_global_exit();
     uvm_thread_context_global_exit();
     uvm_kvmalloc_exit();
 }
@@ -63,6 +63,10 @@ struct uvm_global_struct
     // Ampere+ GPUs add support for physical addresses in p2p copies.
     uvm_gpu_peer_copy_mode_t peer_copy_mode;
 
+    // Whether the addressing mode of peer copies is calibrated per peer pair
+    // when peer access is enabled. See uvm_peer_copy.
+    bool peer_copy_auto;
+
     // Stores an NV_STATUS, once it becomes != NV_OK, the driver should refuse to
     // do most anything other than try and clean up as much as possible.
     // An example of a fatal error is an unrecoverable ECC error on one of the
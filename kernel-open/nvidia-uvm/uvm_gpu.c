@@ -28,6 +28,7 @@
 #include "uvm_gpu.h"
 #include "uvm_gpu_semaphore.h"
 #include "uvm_hal.h"
+#include "uvm_mem.h"
 #include "uvm_procfs.h"
 #include "uvm_pmm_gpu.h"
 #include "uvm_pmm_sysmem.h"
@@ -47,15 +48,22 @@
 
 #define UVM_PROC_GPUS_PEER_DIR_NAME "peers"
 
-// The uvm_peer_copy module parameter enables to choose from "phys" or "virt".
-// It determines the addressing mode for P2P copies.
+// The uvm_peer_copy module parameter enables to choose from "phys", "virt" or
+// "auto". It determines the addressing mode for P2P copies. With "auto", both
+// modes are timed with a short CE benchmark when peer access is enabled, and
+// the faster one is used for each direction and copy size class.
 #define UVM_PARAM_PEER_COPY_VIRTUAL "virt"
 #define UVM_PARAM_PEER_COPY_PHYSICAL "phys"
-static char *uvm_peer_copy = UVM_PARAM_PEER_COPY_PHYSICAL;
+#define UVM_PARAM_PEER_COPY_AUTO "auto"
+static char *uvm_peer_copy = UVM_PARAM_PEER_COPY_AUTO;
 module_param(uvm_peer_copy, charp, S_IRUGO);
 MODULE_PARM_DESC(uvm_peer_copy, "Choose the addressing mode for peer copying, options: "
-                                UVM_PARAM_PEER_COPY_PHYSICAL " [default] or " UVM_PARAM_PEER_COPY_VIRTUAL ". "
-                                "Valid for Ampere+ GPUs.");
+                                UVM_PARAM_PEER_COPY_AUTO " [default], " UVM_PARAM_PEER_COPY_PHYSICAL " or "
+                                UVM_PARAM_PEER_COPY_VIRTUAL ". Valid for Ampere+ GPUs.");
+
+// Number of copies timed per addressing mode and size class when calibrating
+// the peer copy mode
+#define UVM_PEER_COPY_CALIBRATION_COPIES 16
 
 static void remove_gpu(uvm_gpu_t *gpu);
 static void disable_peer_access(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1);
@@ -523,6 +531,7 @@ static NV_STATUS alloc_parent_gpu(const NvProcessorUuid *gpu_uuid,
     uvm_sema_init(&parent_gpu->isr.non_replayable_faults.service_lock, 1, UVM_LOCK_ORDER_ISR);
     uvm_sema_init(&parent_gpu->isr.access_counters.service_lock, 1, UVM_LOCK_ORDER_ISR);
     uvm_spin_lock_irqsave_init(&parent_gpu->isr.interrupts_lock, UVM_LOCK_ORDER_LEAF);
+    uvm_gpu_init_isr_completion_waiters(parent_gpu);
     uvm_spin_lock_init(&parent_gpu->instance_ptr_table_lock, UVM_LOCK_ORDER_LEAF);
     uvm_rb_tree_init(&parent_gpu->instance_ptr_table);
     uvm_rb_tree_init(&parent_gpu->tsg_table);
@@ -555,6 +564,7 @@ static uvm_gpu_t *alloc_gpu(uvm_parent_gpu_t *parent_gpu, uvm_global_gpu_id_t gl
     // Initialize enough of the gpu struct for remove_gpu to be called
     gpu->magic = UVM_GPU_MAGIC_VALUE;
     uvm_spin_lock_init(&gpu->peer_info.peer_gpus_lock, UVM_LOCK_ORDER_LEAF);
+    uvm_rm_mem_pool_init(gpu);
 
     sub_processor_index = uvm_global_id_sub_processor_index(global_gpu_id);
     parent_gpu->gpus[sub_processor_index] = gpu;
@@ -672,7 +682,7 @@ static NV_STATUS init_parent_gpu(uvm_parent_gpu_t *parent_gpu,
     uvm_conf_computing_check_parent_gpu(parent_gpu);
 
     parent_gpu->pci_dev = gpu_platform_info->pci_dev;
-    parent_gpu->closest_cpu_numa_node = NUMA_NO_NODE;
+    parent_gpu->closest_cpu_numa_node = nv_pci_dev_to_node(parent_gpu->pci_dev);
     parent_gpu->dma_addressable_start = gpu_platform_info->dma_addressable_start;
     parent_gpu->dma_addressable_limit = gpu_platform_info->dma_addressable_limit;
 
@@ -832,6 +842,22 @@ static NV_STATUS init_gpu(uvm_gpu_t *gpu, const UvmGpuInfo *gpu_info)
         return status;
     }
 
+    status = uvm_mmu_create_pte_staging(gpu);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Creating the PTE staging buffer failed: %s, GPU %s\n",
+                      nvstatusToString(status),
+                      uvm_gpu_name(gpu));
+        return status;
+    }
+
+    status = uvm_mmu_create_page_table_pool(gpu);
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Creating the page table pool failed: %s, GPU %s\n",
+                      nvstatusToString(status),
+                      uvm_gpu_name(gpu));
+        return status;
+    }
+
     status = uvm_conf_computing_gpu_init(gpu);
     if (status != NV_OK) {
         UVM_ERR_PRINT("Failed to initialize Confidential Compute: %s for GPU %s\n",
@@ -1083,6 +1109,10 @@ static void deinit_gpu(uvm_gpu_t *gpu)
 
     deinit_procfs_files(gpu);
 
+    uvm_mmu_destroy_page_table_pool(gpu);
+
+    uvm_mmu_destroy_pte_staging(gpu);
+
     // TODO Bug 3429163: [UVM] Move uvm_mmu_destroy_flat_mapping() to the
     // correct spot
     uvm_mmu_destroy_flat_mappings(gpu);
@@ -1105,6 +1135,8 @@ static void deinit_gpu(uvm_gpu_t *gpu)
 
     uvm_pmm_gpu_deinit(&gpu->pmm);
 
+    uvm_rm_mem_pool_deinit(gpu);
+
     if (gpu->rm_address_space != 0)
         uvm_rm_locked_call_void(nvUvmInterfaceAddressSpaceDestroy(gpu->rm_address_space));
 
@@ -1356,9 +1388,17 @@ static void update_stats_migration_cb(uvm_perf_event_t event_id, uvm_perf_event_
 // Override the UVM driver and GPU settings from the module loader
 static void uvm_param_conf(void)
 {
-    // uvm_peer_copy: Valid entries are "phys" and "virt" for Ampere+ GPUs.
-    // No effect in pre-Ampere GPUs
-    if (strcmp(uvm_peer_copy, UVM_PARAM_PEER_COPY_VIRTUAL) == 0) {
+    // uvm_peer_copy: Valid entries are "phys", "virt" and "auto" for Ampere+
+    // GPUs. No effect in pre-Ampere GPUs
+    g_uvm_global.peer_copy_auto = false;
+
+    if (strcmp(uvm_peer_copy, UVM_PARAM_PEER_COPY_AUTO) == 0) {
+        // Physical copies need no setup, so start from virtual mode in order
+        // to get the identity mappings created and have both modes available.
+        g_uvm_global.peer_copy_mode = UVM_GPU_PEER_COPY_MODE_VIRTUAL;
+        g_uvm_global.peer_copy_auto = true;
+    }
+    else if (strcmp(uvm_peer_copy, UVM_PARAM_PEER_COPY_VIRTUAL) == 0) {
         g_uvm_global.peer_copy_mode = UVM_GPU_PEER_COPY_MODE_VIRTUAL;
     }
     else {
@@ -1785,6 +1825,168 @@ static NV_STATUS init_procfs_peer_cap_files(uvm_gpu_t *local, uvm_gpu_t *remote,
     return NV_OK;
 }
 
+static size_t peer_caps_index(uvm_gpu_t *local_gpu, uvm_gpu_t *remote_gpu)
+{
+    return uvm_id_value(local_gpu->id) < uvm_id_value(remote_gpu->id) ? 0 : 1;
+}
+
+static uvm_gpu_peer_copy_size_class_t peer_copy_size_class(NvU64 size)
+{
+    if (size >= UVM_GPU_PEER_COPY_LARGE_SIZE)
+        return UVM_GPU_PEER_COPY_SIZE_CLASS_LARGE;
+
+    return UVM_GPU_PEER_COPY_SIZE_CLASS_SMALL;
+}
+
+uvm_gpu_peer_copy_mode_t uvm_gpu_peer_copy_mode(uvm_gpu_t *accessing_gpu, uvm_gpu_t *owning_gpu, NvU64 size)
+{
+    uvm_gpu_peer_t *peer_caps = uvm_gpu_peer_caps(accessing_gpu, owning_gpu);
+
+    if (!peer_caps->copy_modes_calibrated)
+        return accessing_gpu->parent->peer_copy_mode;
+
+    return peer_caps->copy_modes[peer_caps_index(accessing_gpu, owning_gpu)][peer_copy_size_class(size)];
+}
+
+// Time UVM_PEER_COPY_CALIBRATION_COPIES copies of the given size from local
+// vidmem to the peer, in a single push
+static NV_STATUS peer_copy_calibration_time(uvm_gpu_t *gpu,
+                                            uvm_gpu_t *peer,
+                                            uvm_gpu_address_t dst,
+                                            uvm_gpu_address_t src,
+                                            size_t size,
+                                            NvU64 *time_ns)
+{
+    NV_STATUS status;
+    uvm_push_t push;
+    NvU64 start;
+    unsigned i;
+
+    status = uvm_push_begin_gpu_to_gpu(gpu->channel_manager,
+                                       peer,
+                                       &push,
+                                       "Peer copy calibration %s -> %s, %zu bytes",
+                                       uvm_gpu_name(gpu),
+                                       uvm_gpu_name(peer),
+                                       size);
+    if (status != NV_OK)
+        return status;
+
+    start = NV_GETTIME();
+
+    for (i = 0; i < UVM_PEER_COPY_CALIBRATION_COPIES; i++)
+        gpu->parent->ce_hal->memcopy(&push, dst, src, size);
+
+    status = uvm_push_end_and_wait(&push);
+
+    *time_ns = NV_GETTIME() - start;
+
+    return status;
+}
+
+// Pick the faster addressing mode for each size class of copies pushed by gpu
+// to its direct peer. The identity mappings from gpu to the peer must exist.
+static NV_STATUS calibrate_peer_copy_mode(uvm_gpu_t *gpu, uvm_gpu_t *peer, uvm_gpu_peer_t *peer_caps)
+{
+    static const size_t sizes[UVM_GPU_PEER_COPY_SIZE_CLASS_COUNT] = { UVM_PAGE_SIZE_4K, UVM_PAGE_SIZE_2M };
+    uvm_mem_alloc_params_t params = { 0 };
+    uvm_mem_t *src_mem = NULL;
+    uvm_mem_t *dst_mem = NULL;
+    uvm_gpu_chunk_t *dst_chunk;
+    uvm_gpu_address_t src;
+    uvm_gpu_address_t dst_phys;
+    uvm_gpu_address_t dst_virt;
+    size_t peer_index = peer_caps_index(gpu, peer);
+    uvm_gpu_peer_copy_size_class_t size_class;
+    NV_STATUS status;
+
+    BUILD_BUG_ON(UVM_PAGE_SIZE_4K >= UVM_GPU_PEER_COPY_LARGE_SIZE);
+    BUILD_BUG_ON(UVM_PAGE_SIZE_2M < UVM_GPU_PEER_COPY_LARGE_SIZE);
+
+    // A single 2M chunk on each side keeps both buffers physically contiguous
+    params.size = UVM_PAGE_SIZE_2M;
+    params.page_size = UVM_PAGE_SIZE_2M;
+
+    params.backing_gpu = gpu;
+    status = uvm_mem_alloc(&params, &src_mem);
+    if (status != NV_OK)
+        goto done;
+
+    params.backing_gpu = peer;
+    status = uvm_mem_alloc(&params, &dst_mem);
+    if (status != NV_OK)
+        goto done;
+
+    src = uvm_mem_gpu_address_copy(src_mem, gpu, 0, params.size);
+
+    dst_chunk = dst_mem->vidmem.chunks[0];
+    dst_phys = uvm_gpu_address_from_phys(uvm_pmm_gpu_peer_phys_address(&peer->pmm, dst_chunk, gpu));
+    dst_virt = uvm_gpu_address_virtual(uvm_gpu_get_peer_mapping(gpu, peer->id)->base + dst_chunk->address);
+
+    for (size_class = 0; size_class < UVM_GPU_PEER_COPY_SIZE_CLASS_COUNT; size_class++) {
+        NvU64 phys_ns, virt_ns;
+
+        // The first round warms up the channel and the TLBs, only the second
+        // one is used
+        status = peer_copy_calibration_time(gpu, peer, dst_phys, src, sizes[size_class], &phys_ns);
+        if (status == NV_OK)
+            status = peer_copy_calibration_time(gpu, peer, dst_virt, src, sizes[size_class], &virt_ns);
+        if (status == NV_OK)
+            status = peer_copy_calibration_time(gpu, peer, dst_phys, src, sizes[size_class], &phys_ns);
+        if (status == NV_OK)
+            status = peer_copy_calibration_time(gpu, peer, dst_virt, src, sizes[size_class], &virt_ns);
+        if (status != NV_OK)
+            goto done;
+
+        peer_caps->copy_modes[peer_index][size_class] = phys_ns <= virt_ns ? UVM_GPU_PEER_COPY_MODE_PHYSICAL :
+                                                                             UVM_GPU_PEER_COPY_MODE_VIRTUAL;
+
+        UVM_DBG_PRINT("%s -> %s %zu byte copies: physical %llu ns, virtual %llu ns\n",
+                      uvm_gpu_name(gpu),
+                      uvm_gpu_name(peer),
+                      sizes[size_class],
+                      phys_ns,
+                      virt_ns);
+    }
+
+done:
+    uvm_mem_free(dst_mem);
+    uvm_mem_free(src_mem);
+
+    return status;
+}
+
+static void calibrate_peer_copy_modes(uvm_gpu_t *gpu0, uvm_gpu_t *gpu1, uvm_gpu_peer_t *peer_caps)
+{
+    NV_STATUS status;
+
+    UVM_ASSERT(!peer_caps->is_indirect_peer);
+
+    if (!gpu0->parent->peer_copy_auto || !gpu1->parent->peer_copy_auto)
+        return;
+
+    if (gpu0->mem_info.size == 0 || gpu1->mem_info.size == 0)
+        return;
+
+    UVM_ASSERT(gpu0->parent->peer_copy_mode == UVM_GPU_PEER_COPY_MODE_VIRTUAL);
+    UVM_ASSERT(gpu1->parent->peer_copy_mode == UVM_GPU_PEER_COPY_MODE_VIRTUAL);
+
+    status = calibrate_peer_copy_mode(gpu0, gpu1, peer_caps);
+    if (status == NV_OK)
+        status = calibrate_peer_copy_mode(gpu1, gpu0, peer_caps);
+
+    // Failing to calibrate is not fatal, virtual copies keep working
+    if (status != NV_OK) {
+        UVM_DBG_PRINT("Peer copy calibration between %s and %s failed: %s\n",
+                      uvm_gpu_name(gpu0),
+                      uvm_gpu_name(gpu1),
+                      nvstatusToString(status));
+        return;
+    }
+
+    peer_caps->copy_modes_calibrated = true;
+}
+
 static NV_STATUS init_peer_access(uvm_gpu_t *gpu0,
                                   uvm_gpu_t *gpu1,
                                   const UvmGpuP2PCapsParams *p2p_caps_params,
@@ -1841,6 +2043,8 @@ static NV_STATUS init_peer_access(uvm_gpu_t *gpu0,
 
         set_optimal_p2p_write_ces(p2p_caps_params, peer_caps, gpu0, gpu1);
 
+        calibrate_peer_copy_modes(gpu0, gpu1, peer_caps);
+
         UVM_ASSERT(uvm_gpu_get(gpu0->global_id) == gpu0);
         UVM_ASSERT(uvm_gpu_get(gpu1->global_id) == gpu1);
 
@@ -2162,10 +2366,7 @@ static uvm_aperture_t uvm_gpu_peer_caps_aperture(uvm_gpu_peer_t *peer_caps, uvm_
     if (peer_caps->is_indirect_peer)
         return UVM_APERTURE_SYS;
 
-    if (uvm_id_value(local_gpu->id) < uvm_id_value(remote_gpu->id))
-        peer_index = 0;
-    else
-        peer_index = 1;
+    peer_index = peer_caps_index(local_gpu, remote_gpu);
 
     return UVM_APERTURE_PEER(peer_caps->peer_ids[peer_index]);
 }
@@ -44,9 +44,11 @@
 #include "uvm_va_block_types.h"
 #include "uvm_perf_module.h"
 #include "uvm_rb_tree.h"
+#include "uvm_radix_sort.h"
 #include "uvm_perf_prefetch.h"
 #include "nv-kthread-q.h"
 #include "uvm_conf_computing.h"
+#include "uvm_rm_mem.h"
 
 // Buffer length to store uvm gpu id, RM device name and gpu uuid.
 #define UVM_GPU_NICE_NAME_BUFFER_LENGTH (sizeof("ID 999: : ") + \
@@ -196,6 +198,10 @@ typedef struct
     // SAM VMA. This is used as input to the prefetcher.
     uvm_page_mask_t faulted_mask;
 
+    // Pages populated by a single call into the OS when coalescing the
+    // servicing of read or write faults. See uvm_ats_fault_coalesce.
+    uvm_page_mask_t coalesced_mask;
+
     // Client type of the service requestor.
     uvm_fault_client_type_t client_type;
 
@@ -251,6 +257,12 @@ struct uvm_fault_service_batch_context_struct
     // max_batch_size
     uvm_fault_buffer_entry_t **ordered_fault_cache;
 
+    // Sort keys of the entries in ordered_fault_cache and scratch space for
+    // uvm_radix_sort(). The number of elements in each array is exactly
+    // max_batch_size
+    uvm_radix_sort_entry_t *sort_entries;
+    uvm_radix_sort_entry_t *sort_scratch;
+
     // Per uTLB fault information. Used for replay policies and fault
     // cancellation on Pascal
     uvm_fault_utlb_info_t *utlbs;
@@ -266,6 +278,8 @@ struct uvm_fault_service_batch_context_struct
 
     bool has_throttled_faults;
 
+    NvU32 num_throttled_faults;
+
     NvU32 num_invalid_prefetch_faults;
 
     NvU32 num_duplicate_faults;
@@ -297,6 +311,28 @@ struct uvm_ats_fault_invalidate_struct
     uvm_tlb_batch_t write_faults_tlb_batch;
 };
 
+// State of one worker servicing a part of a replayable fault batch in
+// parallel, see service_fault_batch_parallel().
+typedef struct
+{
+    // Copy of the batch context of the whole batch. It shares the fault
+    // arrays and uTLB info of the batch, but has its own counters, ATS context
+    // and tracker, and num_coalesced_faults is the end of this worker's part.
+    uvm_fault_service_batch_context_t batch_context;
+
+    // Structure used to coalesce fault servicing in a VA block
+    uvm_service_block_context_t block_service_context;
+
+    uvm_gpu_t *gpu;
+
+    // First fault of this worker's part in ordered_fault_cache
+    NvU32 first_fault_index;
+
+    NV_STATUS status;
+
+    nv_kthread_q_item_t q_item;
+} uvm_fault_service_worker_t;
+
 typedef struct
 {
     // Fault buffer information and structures provided by RM
@@ -332,6 +368,31 @@ typedef struct
         // that comes before the replay method.
         NvU32 replay_update_put_ratio;
 
+        // State of the adaptive batch controller. See
+        // update_adaptive_batch_control().
+        struct
+        {
+            bool enabled;
+
+            // Number of entries fetched per batch, between
+            // UVM_PERF_FAULT_BATCH_COUNT_ADAPTIVE_MIN and max_batch_size
+            NvU32 batch_size;
+
+            // Replay policy selected from the module parameter. The
+            // controller only switches between BATCH and BATCH_FLUSH when
+            // this is one of them.
+            uvm_perf_fault_replay_policy_t configured_policy;
+
+            // Consecutive batches that left entries in the buffer, that
+            // used little of batch_size, and that had few duplicates
+            NvU32 backlogged_batches;
+            NvU32 sparse_batches;
+            NvU32 clean_batches;
+
+            // Moving average of the time to service a batch, in ns
+            NvU64 avg_service_time_ns;
+        } adaptive;
+
         // Fault statistics. These fields are per-GPU and most of them are only
         // updated during fault servicing, and can be safely incremented.
         // Migrations may be triggered by different GPUs and need to be
@@ -355,8 +416,39 @@ typedef struct
             NvU64 num_replays;
 
             NvU64 num_replays_ack_all;
+
+            // Log2 latency histograms of the fault servicing stages. VA blocks
+            // may be serviced by several workers at once, hence the atomics.
+            atomic64_t stage_latency[UVM_FAULT_STAGE_COUNT][UVM_FAULT_STAGE_HISTOGRAM_BUCKETS];
         } stats;
 
+        // Flight recorder of the last batches. Record i is stored at
+        // i % UVM_FAULT_BATCH_RECORDS, and num_batch_records is only advanced
+        // by the bottom half once the record is written, so readers can
+        // discard the records that were overwritten while they copied them.
+        uvm_fault_batch_record_t batch_records[UVM_FAULT_BATCH_RECORDS];
+        NvU64 num_batch_records;
+
+        // Fault buffer occupancy, sampled every time PUT is read while
+        // fetching. The buffer overflows when a fetch finds it full, as the
+        // GPU drops the faults that arrive then, and is drained once a later
+        // fetch finds it empty. Only updated by the bottom half.
+        struct
+        {
+            // Highest number of pending entries observed
+            NvU32 max_pending_entries;
+
+            NvU64 num_overflows;
+
+            // Time at which the current overflow was observed, 0 if the
+            // buffer has been drained since the last one
+            NvU64 start_ns;
+
+            // Time from an overflow until the buffer was drained
+            NvU64 total_drain_ns;
+            NvU64 max_drain_ns;
+        } overflow;
+
         // Number of uTLBs in the chip
         NvU32 utlb_count;
 
@@ -368,6 +460,25 @@ typedef struct
 
         // Information required to invalidate stale ATS PTEs from the GPU TLBs
         uvm_ats_fault_invalidate_t ats_invalidate;
+
+        // TLB invalidates of the mappings created by the VA blocks serviced
+        // in the current GPU VA space of a batch. They are pushed once before
+        // the VA space lock is dropped, and thus before the batch is replayed.
+        uvm_tlb_batch_t map_tlb_batch;
+
+        // Workers used to service the VA blocks of a batch in parallel. Only
+        // allocated if more than one worker is configured.
+        struct
+        {
+            NvU32 worker_count;
+
+            uvm_fault_service_worker_t *workers;
+
+            nv_kthread_q_t q;
+
+            // Upped by each worker when its part of the batch is done
+            struct semaphore done;
+        } parallel;
     } replayable;
 
     struct uvm_non_replayable_fault_buffer_info_struct
@@ -387,6 +498,18 @@ typedef struct
         // elements in this array is exactly max_batch_size
         uvm_fault_buffer_entry_t *fault_cache;
 
+        // Array of pointers to elements in fault_cache, sorted by channel and
+        // fault address so that faults of the same channel and VA block are
+        // serviced together. The number of elements in this array is exactly
+        // max_faults
+        uvm_fault_buffer_entry_t **ordered_fault_cache;
+
+        // Sort keys of the entries in ordered_fault_cache and scratch space
+        // for uvm_radix_sort(). The number of elements in each array is
+        // exactly max_faults
+        uvm_radix_sort_entry_t *sort_entries;
+        uvm_radix_sort_entry_t *sort_scratch;
+
         // Fault statistics. See replayable fault stats for more details.
         struct
         {
@@ -468,6 +591,12 @@ struct uvm_access_counter_service_batch_context_struct
         bool                              is_single_aperture;
     } phys;
 
+    // Sort keys and scratch space for uvm_radix_sort(), shared by the virt and
+    // phys notification sorts. The number of elements in each array is
+    // max_notifications
+    uvm_radix_sort_entry_t *sort_entries;
+    uvm_radix_sort_entry_t *sort_scratch;
+
     // Helper page mask to compute the accessed pages within a VA block
     uvm_page_mask_t accessed_pages;
 
@@ -606,6 +735,18 @@ typedef enum
     UVM_GPU_PEER_COPY_MODE_COUNT
 } uvm_gpu_peer_copy_mode_t;
 
+// Size classes of peer copies for which the addressing mode is selected
+// separately when it's calibrated per peer pair. Copies of at least
+// UVM_GPU_PEER_COPY_LARGE_SIZE are large.
+typedef enum
+{
+    UVM_GPU_PEER_COPY_SIZE_CLASS_SMALL,
+    UVM_GPU_PEER_COPY_SIZE_CLASS_LARGE,
+    UVM_GPU_PEER_COPY_SIZE_CLASS_COUNT
+} uvm_gpu_peer_copy_size_class_t;
+
+#define UVM_GPU_PEER_COPY_LARGE_SIZE UVM_PAGE_SIZE_64K
+
 struct uvm_gpu_struct
 {
     uvm_parent_gpu_t *parent;
@@ -713,8 +854,43 @@ struct uvm_gpu_struct
 
     uvm_gpu_semaphore_pool_t *secure_semaphore_pool;
 
+    // Slabs backing small uvm_rm_mem_t allocations owned by this GPU
+    uvm_rm_mem_pool_t rm_mem_pool;
+
     uvm_channel_manager_t *channel_manager;
 
+    // Sysmem buffer used by uvm_page_table_range_vec_write_ptes() to write
+    // long runs of PTEs with a single CE copy instead of inline pushbuffer
+    // data. It is used by one caller at a time, as arbitrated by in_use, and
+    // callers that find it busy fall back to inline writes. NULL if not
+    // available.
+    struct
+    {
+        uvm_rm_mem_t *buffer;
+
+        atomic64_t in_use;
+    } pte_staging;
+
+    // Preallocated memory for the page directories and tables of this GPU's
+    // page trees, see uvm_mmu_page_table_pool_refill(). Allocations are taken
+    // from it before falling back to PMM or sysmem, and freed ones are put
+    // back while it isn't full.
+    struct
+    {
+        // Protects entries and count
+        uvm_spinlock_t lock;
+
+        // Location of the allocations in the pool
+        uvm_aperture_t location;
+
+        uvm_mmu_page_table_alloc_t *entries;
+
+        NvU32 count;
+
+        // 0 if the GPU has no pool
+        NvU32 capacity;
+    } page_table_pool;
+
     uvm_pmm_gpu_t pmm;
 
     // Flat linear mapping covering vidmem. This is a kernel mapping that is
@@ -935,6 +1111,12 @@ struct uvm_parent_gpu_struct
 
     uvm_gpu_peer_copy_mode_t peer_copy_mode;
 
+    // Whether the GPU supports both physical and virtual peer copies, and the
+    // mode is calibrated per peer pair instead of always using peer_copy_mode.
+    // peer_copy_mode is UVM_GPU_PEER_COPY_MODE_VIRTUAL in that case, so the
+    // identity mappings get created.
+    bool peer_copy_auto;
+
     // Virtualization mode of the GPU.
     UVM_VIRT_MODE virt_mode;
 
@@ -979,6 +1161,12 @@ struct uvm_parent_gpu_struct
 
     bool plc_supported;
 
+    // If true, the CE can release 64-bit semaphores, see
+    // uvm_hal_semaphore_release_64_t. Channel tracking semaphores then use
+    // 64-bit payloads and their completion checks don't need the wrap
+    // detection of 32-bit payloads.
+    bool ce_semaphore_release_64_supported;
+
     // Parameters used by the TLB batching API
     struct
     {
@@ -1234,6 +1422,12 @@ struct uvm_gpu_peer_struct
     // deletion.
     NvHandle p2p_handle;
 
+    // Addressing mode of peer copies pushed by each of the GPUs, indexed like
+    // peer_ids and by uvm_gpu_peer_copy_size_class_t. Only valid if
+    // copy_modes_calibrated is set, see uvm_gpu_peer_copy_mode().
+    uvm_gpu_peer_copy_mode_t copy_modes[2][UVM_GPU_PEER_COPY_SIZE_CLASS_COUNT];
+    bool copy_modes_calibrated;
+
     struct
     {
         struct proc_dir_entry *peer_file[2];
@@ -1246,6 +1440,11 @@ struct uvm_gpu_peer_struct
     } procfs;
 };
 
+// Returns the addressing mode to be used by accessing_gpu for copies of the
+// given size to or from the memory of its direct peer owning_gpu. The peer
+// caps must be valid, see uvm_gpu_peer_struct.
+uvm_gpu_peer_copy_mode_t uvm_gpu_peer_copy_mode(uvm_gpu_t *accessing_gpu, uvm_gpu_t *owning_gpu, NvU64 size);
+
 // Initialize global gpu state
 NV_STATUS uvm_gpu_init(void);
 
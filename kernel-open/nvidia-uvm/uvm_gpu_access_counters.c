@@ -21,6 +21,7 @@
 *******************************************************************************/
 
 #include "nv_uvm_interface.h"
+#include "uvm_api.h"
 #include "uvm_gpu_access_counters.h"
 #include "uvm_global.h"
 #include "uvm_gpu.h"
@@ -61,6 +62,27 @@
 static UVM_ACCESS_COUNTER_GRANULARITY g_uvm_access_counter_granularity;
 static unsigned g_uvm_access_counter_threshold;
 
+// Per-VA space heat table of UVM_GET_ACCESS_COUNTER_HEAT. Notifications are
+// aggregated per VA block sized region and per notifying GPU, and the heat of a
+// region halves every uvm_perf_access_counter_heat_half_life_ms.
+#define UVM_ACCESS_COUNTER_HEAT_REGION_SIZE UVM_VA_BLOCK_SIZE
+#define UVM_ACCESS_COUNTER_HEAT_ENTRIES_SHIFT 9
+#define UVM_ACCESS_COUNTER_HEAT_ENTRIES (1 << UVM_ACCESS_COUNTER_HEAT_ENTRIES_SHIFT)
+
+// Number of slots probed when looking up a region. If none of them matches or
+// is free, the coldest one is recycled.
+#define UVM_ACCESS_COUNTER_HEAT_PROBES 8
+
+typedef struct
+{
+    NvU64 base;
+
+    // Time of the last decay, in ns. 0 for unused slots.
+    NvU64 timestamp;
+
+    NvU32 heat[UVM_ID_MAX_GPUS];
+} access_counter_heat_entry_t;
+
 // Per-VA space access counters information
 typedef struct
 {
@@ -73,6 +95,14 @@ typedef struct
         atomic_t enable_momc_migrations;
     } params;
 
+    struct
+    {
+        // Protects the table. It is allocated on the first notification.
+        uvm_spinlock_t lock;
+
+        access_counter_heat_entry_t *entries;
+    } heat;
+
     uvm_va_space_t *va_space;
 } va_space_access_counters_info_t;
 
@@ -108,6 +138,14 @@ MODULE_PARM_DESC(uvm_perf_access_counter_threshold,
                  "Number of remote accesses on a region required to trigger a notification."
                  "Valid values: [1, 65535]");
 
+// Aggregate the notifications into the per-VA space heat table queried with
+// UVM_GET_ACCESS_COUNTER_HEAT. This also enables the access counters of GPUs
+// that support them when no migration policy needs them.
+static unsigned uvm_perf_access_counter_heat = 0;
+static unsigned uvm_perf_access_counter_heat_half_life_ms = 1000;
+module_param(uvm_perf_access_counter_heat, uint, S_IRUGO);
+module_param(uvm_perf_access_counter_heat_half_life_ms, uint, S_IRUGO);
+
 static void access_counter_buffer_flush_locked(uvm_gpu_t *gpu, uvm_gpu_buffer_flush_mode_t flush_mode);
 
 static uvm_perf_module_event_callback_desc_t g_callbacks_access_counters[] = {};
@@ -182,6 +220,7 @@ static va_space_access_counters_info_t *va_space_access_counters_info_create(uvm
                    is_migration_enabled(UVM_ACCESS_COUNTER_TYPE_MIMC));
         atomic_set(&va_space_access_counters->params.enable_momc_migrations,
                    is_migration_enabled(UVM_ACCESS_COUNTER_TYPE_MOMC));
+        uvm_spin_lock_init(&va_space_access_counters->heat.lock, UVM_LOCK_ORDER_LEAF);
         va_space_access_counters->va_space = va_space;
     }
 
@@ -198,6 +237,7 @@ static void va_space_access_counters_info_destroy(uvm_va_space_t *va_space)
 
     if (va_space_access_counters) {
         uvm_perf_module_type_unset_data(va_space->perf_modules_data, UVM_PERF_MODULE_TYPE_ACCESS_COUNTERS);
+        uvm_kvfree(va_space_access_counters->heat.entries);
         uvm_kvfree(va_space_access_counters);
     }
 }
@@ -470,6 +510,20 @@ NV_STATUS uvm_gpu_init_access_counters(uvm_parent_gpu_t *parent_gpu)
         goto fail;
     }
 
+    batch_context->sort_entries = uvm_kvmalloc(access_counters->max_notifications *
+                                               sizeof(*batch_context->sort_entries));
+    if (!batch_context->sort_entries) {
+        status = NV_ERR_NO_MEMORY;
+        goto fail;
+    }
+
+    batch_context->sort_scratch = uvm_kvmalloc(access_counters->max_notifications *
+                                               sizeof(*batch_context->sort_scratch));
+    if (!batch_context->sort_scratch) {
+        status = NV_ERR_NO_MEMORY;
+        goto fail;
+    }
+
     batch_context->phys.translations = uvm_kvmalloc_zero((UVM_MAX_TRANSLATION_SIZE / PAGE_SIZE) *
                                                          sizeof(*batch_context->phys.translations));
     if (!batch_context->phys.translations) {
@@ -506,10 +560,14 @@ void uvm_gpu_deinit_access_counters(uvm_parent_gpu_t *parent_gpu)
     uvm_kvfree(batch_context->virt.notifications);
     uvm_kvfree(batch_context->phys.notifications);
     uvm_kvfree(batch_context->phys.translations);
+    uvm_kvfree(batch_context->sort_entries);
+    uvm_kvfree(batch_context->sort_scratch);
     batch_context->notification_cache = NULL;
     batch_context->virt.notifications = NULL;
     batch_context->phys.notifications = NULL;
     batch_context->phys.translations = NULL;
+    batch_context->sort_entries = NULL;
+    batch_context->sort_scratch = NULL;
 }
 
 bool uvm_gpu_access_counters_required(const uvm_parent_gpu_t *parent_gpu)
@@ -520,6 +578,9 @@ bool uvm_gpu_access_counters_required(const uvm_parent_gpu_t *parent_gpu)
     if (parent_gpu->rm_info.isSimulated)
         return true;
 
+    if (uvm_perf_access_counter_heat)
+        return true;
+
     return is_migration_enabled(UVM_ACCESS_COUNTER_TYPE_MIMC) || is_migration_enabled(UVM_ACCESS_COUNTER_TYPE_MOMC);
 }
 
@@ -754,30 +815,53 @@ static inline int cmp_access_counter_instance_ptr(const uvm_access_counter_buffe
     return UVM_CMP_DEFAULT(a->virtual_info.ve_id, b->virtual_info.ve_id);
 }
 
-// Sort comparator for pointers to GVA access counter notification buffer
-// entries that sorts by instance pointer
-static bool cmp_sort_virt_notifications_by_instance_ptr(void *_a, void *_b)
+// Sort GVA access counter notifications by instance pointer. The radix sort
+// key orders entries the same way as cmp_access_counter_instance_ptr():
+// instance blocks are 4K aligned, which leaves room for the subcontext id in
+// the low bits.
+static void sort_virt_notifications_by_instance_ptr(uvm_access_counter_service_batch_context_t *batch_context)
 {
-    const uvm_access_counter_buffer_entry_t *a = *(const uvm_access_counter_buffer_entry_t **)_a;
-    const uvm_access_counter_buffer_entry_t *b = *(const uvm_access_counter_buffer_entry_t **)_b;
+    NvU32 i;
+
+    for (i = 0; i < batch_context->virt.num_notifications; ++i) {
+        uvm_access_counter_buffer_entry_t *entry = batch_context->virt.notifications[i];
+        uvm_radix_sort_entry_t *sort_entry = &batch_context->sort_entries[i];
 
-    UVM_ASSERT(a->address.is_virtual);
-    UVM_ASSERT(b->address.is_virtual);
+        UVM_ASSERT(entry->address.is_virtual);
+        UVM_ASSERT(IS_ALIGNED(entry->virtual_info.instance_ptr.address, UVM_PAGE_SIZE_4K));
+        UVM_ASSERT(entry->virtual_info.ve_id < UVM_PAGE_SIZE_4K);
 
-    return (cmp_access_counter_instance_ptr(a, b) > 0);
+        sort_entry->hi = entry->virtual_info.instance_ptr.aperture;
+        sort_entry->lo = entry->virtual_info.instance_ptr.address | entry->virtual_info.ve_id;
+        sort_entry->elem = entry;
+    }
+
+    uvm_radix_sort_ptrs((void **)batch_context->virt.notifications,
+                        batch_context->sort_entries,
+                        batch_context->sort_scratch,
+                        batch_context->virt.num_notifications);
 }
 
-// Sort comparator for pointers to GPA access counter notification buffer
-// entries that sorts by physical address' aperture
-static bool cmp_sort_phys_notifications_by_processor_id(void *_a, void *_b)
+// Sort GPA access counter notifications by resident processor
+static void sort_phys_notifications_by_processor_id(uvm_access_counter_service_batch_context_t *batch_context)
 {
-    const uvm_access_counter_buffer_entry_t *a = *(const uvm_access_counter_buffer_entry_t **)_a;
-    const uvm_access_counter_buffer_entry_t *b = *(const uvm_access_counter_buffer_entry_t **)_b;
+    NvU32 i;
+
+    for (i = 0; i < batch_context->phys.num_notifications; ++i) {
+        uvm_access_counter_buffer_entry_t *entry = batch_context->phys.notifications[i];
+        uvm_radix_sort_entry_t *sort_entry = &batch_context->sort_entries[i];
 
-    UVM_ASSERT(!a->address.is_virtual);
-    UVM_ASSERT(!b->address.is_virtual);
+        UVM_ASSERT(!entry->address.is_virtual);
 
-    return (uvm_id_cmp(a->physical_info.resident_id, b->physical_info.resident_id) > 0);
+        sort_entry->hi = 0;
+        sort_entry->lo = uvm_id_value(entry->physical_info.resident_id);
+        sort_entry->elem = entry;
+    }
+
+    uvm_radix_sort_ptrs((void **)batch_context->phys.notifications,
+                        batch_context->sort_entries,
+                        batch_context->sort_scratch,
+                        batch_context->phys.num_notifications);
 }
 
 typedef enum
@@ -930,9 +1014,7 @@ static void preprocess_virt_notifications(uvm_gpu_t *gpu,
 {
     if (!batch_context->virt.is_single_instance_ptr) {
         // Sort by instance_ptr
-        assert(sort((void **)batch_context->virt.notifications,
-             batch_context->virt.num_notifications,
-             cmp_sort_virt_notifications_by_instance_ptr));
+        sort_virt_notifications_by_instance_ptr(batch_context);
     }
 
     translate_virt_notifications_instance_ptrs(gpu, batch_context);
@@ -945,9 +1027,7 @@ static void preprocess_phys_notifications(uvm_access_counter_service_batch_conte
 {
     if (!batch_context->phys.is_single_aperture) {
         // Sort by instance_ptr
-        assert(sort((void **)batch_context->phys.notifications,
-             batch_context->phys.num_notifications,
-             cmp_sort_phys_notifications_by_processor_id));
+        sort_phys_notifications_by_processor_id(batch_context);
     }
 }
 
@@ -1154,6 +1234,113 @@ static void reverse_mappings_to_va_block_page_mask(uvm_va_block_t *va_block,
     }
 }
 
+static NvU32 heat_table_slot(NvU64 base, NvU32 probe)
+{
+    NvU64 hash = (base / UVM_ACCESS_COUNTER_HEAT_REGION_SIZE) * 0x9e3779b97f4a7c15ULL;
+
+    return ((NvU32)(hash >> (64 - UVM_ACCESS_COUNTER_HEAT_ENTRIES_SHIFT)) + probe) &
+           (UVM_ACCESS_COUNTER_HEAT_ENTRIES - 1);
+}
+
+// Apply the decay accumulated since the last update of the entry. Returns the
+// total heat left.
+static NvU64 heat_entry_decay(access_counter_heat_entry_t *entry, NvU64 now)
+{
+    NvU64 half_life_ns = (NvU64)uvm_perf_access_counter_heat_half_life_ms * 1000 * 1000;
+    NvU64 total = 0;
+    NvU64 shift = 0;
+    NvU32 i;
+
+    if (entry->timestamp == 0)
+        return 0;
+
+    if (half_life_ns != 0 && now > entry->timestamp) {
+        shift = (now - entry->timestamp) / half_life_ns;
+        entry->timestamp += shift * half_life_ns;
+    }
+
+    for (i = 0; i < UVM_ID_MAX_GPUS; ++i) {
+        if (shift >= 32)
+            entry->heat[i] = 0;
+        else
+            entry->heat[i] >>= shift;
+
+        total += entry->heat[i];
+    }
+
+    return total;
+}
+
+// Add the count of a notification of the given GPU to the heat of the region
+// containing address. Returns false if heat tracking is disabled or the table
+// could not be allocated.
+static bool heat_table_record(va_space_access_counters_info_t *va_space_access_counters,
+                              NvU64 address,
+                              uvm_gpu_id_t gpu_id,
+                              NvU32 count)
+{
+    access_counter_heat_entry_t *entries;
+    access_counter_heat_entry_t *entry = NULL;
+    NvU64 base = UVM_ALIGN_DOWN(address, UVM_ACCESS_COUNTER_HEAT_REGION_SIZE);
+    NvU64 coldest_heat = ~0ULL;
+    NvU64 now;
+    NvU32 gpu_index = uvm_id_gpu_index(gpu_id);
+    NvU32 probe;
+
+    if (!uvm_perf_access_counter_heat)
+        return false;
+
+    entries = UVM_READ_ONCE(va_space_access_counters->heat.entries);
+    if (!entries) {
+        entries = uvm_kvmalloc_zero(sizeof(*entries) * UVM_ACCESS_COUNTER_HEAT_ENTRIES);
+        if (!entries)
+            return false;
+
+        uvm_spin_lock(&va_space_access_counters->heat.lock);
+        if (va_space_access_counters->heat.entries) {
+            uvm_kvfree(entries);
+            entries = va_space_access_counters->heat.entries;
+        }
+        else {
+            va_space_access_counters->heat.entries = entries;
+        }
+        uvm_spin_unlock(&va_space_access_counters->heat.lock);
+    }
+
+    now = NV_GETTIME();
+
+    uvm_spin_lock(&va_space_access_counters->heat.lock);
+
+    for (probe = 0; probe < UVM_ACCESS_COUNTER_HEAT_PROBES; ++probe) {
+        access_counter_heat_entry_t *candidate = &entries[heat_table_slot(base, probe)];
+        NvU64 heat;
+
+        if (candidate->timestamp != 0 && candidate->base == base) {
+            heat_entry_decay(candidate, now);
+            entry = candidate;
+            break;
+        }
+
+        heat = heat_entry_decay(candidate, now);
+        if (heat < coldest_heat) {
+            coldest_heat = heat;
+            entry = candidate;
+        }
+    }
+
+    if (entry->timestamp == 0 || entry->base != base) {
+        memset(entry, 0, sizeof(*entry));
+        entry->base = base;
+        entry->timestamp = now;
+    }
+
+    entry->heat[gpu_index] = min(entry->heat[gpu_index], ~(NvU32)0 - count) + count;
+
+    uvm_spin_unlock(&va_space_access_counters->heat.lock);
+
+    return true;
+}
+
 static NV_STATUS service_phys_single_va_block(uvm_gpu_t *gpu,
                                               uvm_access_counter_service_batch_context_t *batch_context,
                                               const uvm_access_counter_buffer_entry_t *current_entry,
@@ -1189,12 +1376,21 @@ static NV_STATUS service_phys_single_va_block(uvm_gpu_t *gpu,
             goto done;
 
         va_space_access_counters = va_space_access_counters_info_get(va_space);
+
+        // Keep the counter running if the notification only feeds the heat
+        // table
+        if (heat_table_record(va_space_access_counters, va_block->start, gpu->id, current_entry->counter_value))
+            *out_flags |= UVM_ACCESS_COUNTER_ACTION_CLEAR;
+
         if (UVM_ID_IS_CPU(processor) && !atomic_read(&va_space_access_counters->params.enable_momc_migrations))
             goto done;
 
         if (!UVM_ID_IS_CPU(processor) && !atomic_read(&va_space_access_counters->params.enable_mimc_migrations))
             goto done;
 
+        // Otherwise the counter is only cleared if servicing succeeds
+        *out_flags &= ~UVM_ACCESS_COUNTER_ACTION_CLEAR;
+
         service_context->operation = UVM_SERVICE_OPERATION_ACCESS_COUNTERS;
         service_context->num_retries = 0;
 
@@ -1400,6 +1596,9 @@ static NV_STATUS service_phys_notification(uvm_gpu_t *gpu,
         // them.
         if (address >= resident_gpu->mem_info.max_allocatable_address)
             return NV_OK;
+
+        // Accesses to vidmem keep the backing root chunks away from eviction
+        uvm_pmm_gpu_mark_root_chunk_accessed(&resident_gpu->pmm, address);
     }
 
     for (translation_index = 0; translation_index < config->translations_per_counter; ++translation_index) {
@@ -1724,6 +1923,121 @@ bool uvm_va_space_has_access_counter_migrations(uvm_va_space_t *va_space)
     return atomic_read(&va_space_access_counters->params.enable_mimc_migrations);
 }
 
+// Insert a copy of the entry into regions, which is sorted by base and holds
+// at most max_regions entries
+static void heat_regions_insert(access_counter_heat_entry_t *regions,
+                                NvU32 *num_regions,
+                                NvU32 max_regions,
+                                const access_counter_heat_entry_t *entry)
+{
+    NvU32 i = *num_regions;
+
+    if (i == max_regions) {
+        if (regions[i - 1].base < entry->base)
+            return;
+        --i;
+    }
+    else {
+        ++(*num_regions);
+    }
+
+    for (; i > 0 && regions[i - 1].base > entry->base; --i)
+        regions[i] = regions[i - 1];
+
+    regions[i] = *entry;
+}
+
+NV_STATUS uvm_api_get_access_counter_heat(UVM_GET_ACCESS_COUNTER_HEAT_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    va_space_access_counters_info_t *va_space_access_counters;
+    access_counter_heat_entry_t *regions;
+    NvU64 end = params->base + params->length;
+    NvU64 now;
+    NvU32 num_regions = 0;
+    NvU32 i;
+
+    // One more region than the output can hold tells where to resume
+    const NvU32 max_regions = UVM_ACCESS_COUNTER_HEAT_MAX_ENTRIES + 1;
+
+    params->numEntries = 0;
+    params->nextBase = end;
+
+    if (!uvm_perf_access_counter_heat)
+        return NV_ERR_NOT_SUPPORTED;
+
+    if (params->length == 0 || end < params->base)
+        return NV_ERR_INVALID_ADDRESS;
+
+    regions = uvm_kvmalloc(sizeof(*regions) * max_regions);
+    if (!regions)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_va_space_down_read(va_space);
+
+    va_space_access_counters = va_space_access_counters_info_get(va_space);
+    now = NV_GETTIME();
+
+    uvm_spin_lock(&va_space_access_counters->heat.lock);
+
+    if (va_space_access_counters->heat.entries) {
+        for (i = 0; i < UVM_ACCESS_COUNTER_HEAT_ENTRIES; ++i) {
+            access_counter_heat_entry_t *entry = &va_space_access_counters->heat.entries[i];
+
+            if (entry->timestamp == 0 ||
+                entry->base >= end ||
+                entry->base + UVM_ACCESS_COUNTER_HEAT_REGION_SIZE <= params->base)
+                continue;
+
+            if (heat_entry_decay(entry, now) == 0)
+                continue;
+
+            heat_regions_insert(regions, &num_regions, max_regions, entry);
+        }
+    }
+
+    uvm_spin_unlock(&va_space_access_counters->heat.lock);
+
+    for (i = 0; i < num_regions; ++i) {
+        uvm_gpu_id_t gpu_id;
+        NvU32 num_gpus = 0;
+
+        if (i == UVM_ACCESS_COUNTER_HEAT_MAX_ENTRIES) {
+            params->nextBase = regions[i].base;
+            break;
+        }
+
+        for_each_gpu_id_in_mask(gpu_id, &va_space->registered_gpus) {
+            if (regions[i].heat[uvm_id_gpu_index(gpu_id)] != 0)
+                ++num_gpus;
+        }
+
+        if (params->numEntries + num_gpus > UVM_ACCESS_COUNTER_HEAT_MAX_ENTRIES) {
+            params->nextBase = regions[i].base;
+            break;
+        }
+
+        for_each_gpu_id_in_mask(gpu_id, &va_space->registered_gpus) {
+            UVM_ACCESS_COUNTER_HEAT_ENTRY *out = &params->entries[params->numEntries];
+            NvU32 heat = regions[i].heat[uvm_id_gpu_index(gpu_id)];
+
+            if (heat == 0)
+                continue;
+
+            out->regionBase = regions[i].base;
+            out->processorUuid = uvm_va_space_get_gpu(va_space, gpu_id)->parent->uuid;
+            out->heat = heat;
+            ++params->numEntries;
+        }
+    }
+
+    uvm_va_space_up_read(va_space);
+
+    uvm_kvfree(regions);
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_perf_access_counters_init(void)
 {
     uvm_perf_module_init("perf_access_counters",
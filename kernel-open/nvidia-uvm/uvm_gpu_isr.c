@@ -183,6 +183,112 @@ static unsigned schedule_access_counters_handler(uvm_parent_gpu_t *parent_gpu)
     return 1;
 }
 
+// Upper bound on how long a completion waiter stays parked without an
+// interrupt.
+#define UVM_ISR_COMPLETION_WATCHDOG_US 1000
+
+// A waiter moves from WAITING to PARKING right before suspending. Only
+// completion_waiters_wake_all_locked() moves it to WOKEN, so a waiter that
+// has not started parking yet simply skips the suspend.
+#define COMPLETION_WAITER_WAITING 0
+#define COMPLETION_WAITER_PARKING 1
+#define COMPLETION_WAITER_WOKEN   2
+
+typedef struct
+{
+    struct list list_node;
+    context ctx;
+    NvU32 state;
+} completion_waiter_t;
+
+static void completion_waiters_wake_all_locked(uvm_isr_info_t *isr)
+{
+    struct list *l;
+
+    uvm_assert_spinlock_locked(&isr->completion_waiters.lock);
+
+    while ((l = list_get_next(&isr->completion_waiters.list)) != NULL) {
+        completion_waiter_t *waiter = struct_from_list(l, completion_waiter_t *, list_node);
+        context ctx = waiter->ctx;
+
+        list_delete(l);
+        list_init(l);
+
+        if (__sync_bool_compare_and_swap(&waiter->state, COMPLETION_WAITER_WAITING, COMPLETION_WAITER_WOKEN))
+            continue;
+
+        // The waiter may still be in the middle of suspending and cannot
+        // resume before it is scheduled, so its stack stays valid until then.
+        UVM_WRITE_ONCE(waiter->state, COMPLETION_WAITER_WOKEN);
+        while (!frame_is_full(ctx->frame))
+            kern_pause();
+        context_schedule_return(ctx);
+    }
+}
+
+define_closure_function(0, 2, void, completion_waiters_watchdog,
+                        u64, expiry, u64, overruns)
+{
+    uvm_isr_info_t *isr;
+
+    if (overruns == timer_disabled)
+        return;
+
+    isr = container_of(closure_self(), uvm_isr_info_t, completion_waiters.watchdog_handler);
+
+    uvm_spin_lock_irqsave(&isr->completion_waiters.lock);
+    isr->completion_waiters.watchdog_armed = false;
+    completion_waiters_wake_all_locked(isr);
+    uvm_spin_unlock_irqrestore(&isr->completion_waiters.lock);
+}
+
+void uvm_gpu_init_isr_completion_waiters(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_spin_lock_irqsave_init(&parent_gpu->isr.completion_waiters.lock, UVM_LOCK_ORDER_LEAF);
+    list_init(&parent_gpu->isr.completion_waiters.list);
+    init_timer(&parent_gpu->isr.completion_waiters.watchdog);
+    init_closure(&parent_gpu->isr.completion_waiters.watchdog_handler, completion_waiters_watchdog);
+    parent_gpu->isr.completion_waiters.watchdog_armed = false;
+}
+
+void uvm_gpu_isr_wait_for_interrupt(uvm_parent_gpu_t *parent_gpu, bool (*is_done)(void *), void *arg)
+{
+    uvm_isr_info_t *isr = &parent_gpu->isr;
+    completion_waiter_t waiter;
+
+    UVM_ASSERT(NV_MAY_SLEEP());
+
+    waiter.ctx = get_current_context(current_cpu());
+    waiter.state = COMPLETION_WAITER_WAITING;
+
+    uvm_spin_lock_irqsave(&isr->completion_waiters.lock);
+    list_push_back(&isr->completion_waiters.list, &waiter.list_node);
+    if (!isr->completion_waiters.watchdog_armed) {
+        isr->completion_waiters.watchdog_armed = true;
+        register_timer(kernel_timers,
+                       &isr->completion_waiters.watchdog,
+                       CLOCK_ID_MONOTONIC,
+                       microseconds(UVM_ISR_COMPLETION_WATCHDOG_US),
+                       false,
+                       0,
+                       (timer_handler)&isr->completion_waiters.watchdog_handler);
+    }
+    uvm_spin_unlock_irqrestore(&isr->completion_waiters.lock);
+
+    // Queued before checking, so an interrupt signalling the completion either
+    // happened before the check or will find the waiter.
+    if (!is_done(arg) &&
+        __sync_bool_compare_and_swap(&waiter.state, COMPLETION_WAITER_WAITING, COMPLETION_WAITER_PARKING)) {
+        context_pre_suspend(waiter.ctx);
+        context_suspend();
+    }
+
+    uvm_spin_lock_irqsave(&isr->completion_waiters.lock);
+    if (!list_empty(&waiter.list_node))
+        list_delete(&waiter.list_node);
+    uvm_spin_unlock_irqrestore(&isr->completion_waiters.lock);
+}
+
 // This is called from RM's top-half ISR (see: the nvidia_isr() function), and UVM is given a
 // chance to handle the interrupt, before most of the RM processing. UVM communicates what it
 // did, back to RM, via the return code:
@@ -250,6 +356,13 @@ static NV_STATUS uvm_isr_top_half(const NvProcessorUuid *gpu_uuid)
 
     uvm_spin_unlock_irqrestore(&parent_gpu->isr.interrupts_lock);
 
+    // Any interrupt may be the nonstall interrupt ending a push somebody is
+    // waiting for. Waking doesn't claim the interrupt, so the status is left
+    // alone for RM to service it.
+    uvm_spin_lock_irqsave(&parent_gpu->isr.completion_waiters.lock);
+    completion_waiters_wake_all_locked(&parent_gpu->isr);
+    uvm_spin_unlock_irqrestore(&parent_gpu->isr.completion_waiters.lock);
+
     uvm_parent_gpu_kref_put(parent_gpu);
 
     return status;
@@ -260,20 +373,26 @@ NV_STATUS uvm_isr_top_half_entry(const NvProcessorUuid *gpu_uuid)
     UVM_ENTRY_RET(uvm_isr_top_half(gpu_uuid));
 }
 
-static NV_STATUS init_queue_on_node(nv_kthread_q_t *queue, const char *name, int node)
+// The replayable, non-replayable and access counter bottom halves each
+// serialize on their own ISR lock, so they can be serviced by separate workers.
+#define UVM_ISR_BOTTOM_HALF_WORKERS 3
+
+static NV_STATUS init_queue_on_node(nv_kthread_q_t *queue, const char *name, int node, unsigned worker_count)
 {
 #if UVM_THREAD_AFFINITY_SUPPORTED()
+    // Queue contexts are placed on the node's CPUs at creation time, there is
+    // no separate affinity call to make.
     if (node != -1 && !cpumask_empty(uvm_cpumask_of_node(node))) {
-        NV_STATUS status;
-
-        status = errno_to_nv_status(nv_kthread_q_init_on_node(queue, name, node));
-        if (status != NV_OK)
-            return status;
+        if (worker_count > 1)
+            return errno_to_nv_status(nv_kthread_q_init_multi_on_node(queue, name, worker_count, node));
 
-        return errno_to_nv_status(set_cpus_allowed_ptr(queue->q_kthread, uvm_cpumask_of_node(node)));
+        return errno_to_nv_status(nv_kthread_q_init_on_node(queue, name, node));
     }
 #endif
 
+    if (worker_count > 1)
+        return errno_to_nv_status(nv_kthread_q_init_multi(queue, name, worker_count));
+
     return errno_to_nv_status(nv_kthread_q_init(queue, name));
 }
 
@@ -303,7 +422,10 @@ NV_STATUS uvm_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
         parent_gpu->isr.replayable_faults.handling = true;
 
         snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u BH", uvm_id_value(parent_gpu->id));
-        status = init_queue_on_node(&parent_gpu->isr.bottom_half_q, kthread_name, parent_gpu->closest_cpu_numa_node);
+        status = init_queue_on_node(&parent_gpu->isr.bottom_half_q,
+                                    kthread_name,
+                                    parent_gpu->closest_cpu_numa_node,
+                                    UVM_ISR_BOTTOM_HALF_WORKERS);
         if (status != NV_OK) {
             UVM_ERR_PRINT("Failed in nv_kthread_q_init for bottom_half_q: %s, GPU %s\n",
                           nvstatusToString(status),
@@ -327,7 +449,8 @@ NV_STATUS uvm_gpu_init_isr(uvm_parent_gpu_t *parent_gpu)
             snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u KC", uvm_id_value(parent_gpu->id));
             status = init_queue_on_node(&parent_gpu->isr.kill_channel_q,
                                         kthread_name,
-                                        parent_gpu->closest_cpu_numa_node);
+                                        parent_gpu->closest_cpu_numa_node,
+                                        1);
             if (status != NV_OK) {
                 UVM_ERR_PRINT("Failed in nv_kthread_q_init for kill_channel_q: %s, GPU %s\n",
                               nvstatusToString(status),
@@ -430,6 +553,16 @@ void uvm_gpu_deinit_isr(uvm_parent_gpu_t *parent_gpu)
         uvm_gpu_deinit_access_counters(parent_gpu);
     }
 
+    // Waiters retain the GPU, so the queue is empty by now and only a stale
+    // watchdog can be left.
+    uvm_spin_lock_irqsave(&parent_gpu->isr.completion_waiters.lock);
+    UVM_ASSERT(list_empty(&parent_gpu->isr.completion_waiters.list));
+    if (parent_gpu->isr.completion_waiters.watchdog_armed) {
+        remove_timer(kernel_timers, &parent_gpu->isr.completion_waiters.watchdog, 0);
+        parent_gpu->isr.completion_waiters.watchdog_armed = false;
+    }
+    uvm_spin_unlock_irqrestore(&parent_gpu->isr.completion_waiters.lock);
+
     uvm_kvfree(parent_gpu->isr.replayable_faults.stats.cpu_exec_count);
     uvm_kvfree(parent_gpu->isr.non_replayable_faults.stats.cpu_exec_count);
     uvm_kvfree(parent_gpu->isr.access_counters.stats.cpu_exec_count);
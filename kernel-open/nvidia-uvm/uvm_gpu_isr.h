@@ -29,6 +29,9 @@
 #include "uvm_lock.h"
 #include "uvm_forward_decl.h"
 
+declare_closure_struct(0, 2, void, completion_waiters_watchdog,
+                       u64, expiry, u64, overruns);
+
 // ISR handling state for a specific interrupt type
 typedef struct
 {
@@ -118,11 +121,41 @@ typedef struct
 
     // Number of top-half ISRs called for this GPU over its lifetime
     NvU64 interrupt_count;
+
+    // Contexts parked in uvm_gpu_isr_wait_for_interrupt(). Nonstall interrupts
+    // do not identify the channel that raised them, so the waiters of all the
+    // channels of the GPU share one queue and every top half wakes them all.
+    struct
+    {
+        // Taken in both interrupt and process context.
+        uvm_spinlock_irqsave_t lock;
+
+        struct list list;
+
+        // Wakes the queue if no interrupt arrived in time, so that a lost or
+        // misordered interrupt only costs latency. Armed while the queue is
+        // not empty and protected by lock.
+        struct timer watchdog;
+        closure_struct(completion_waiters_watchdog, watchdog_handler);
+        bool watchdog_armed;
+    } completion_waiters;
 } uvm_isr_info_t;
 
 // Entry point for interrupt handling. This is called from RM's top half
 NV_STATUS uvm_isr_top_half_entry(const NvProcessorUuid *gpu_uuid);
 
+// Initialize the completion wait queue. This is called when the parent GPU is
+// allocated, before interrupts can be delivered to UVM.
+void uvm_gpu_init_isr_completion_waiters(uvm_parent_gpu_t *parent_gpu);
+
+// Park the calling context until the next interrupt on the parent GPU. is_done
+// is evaluated after the context has been queued, so a completion signalled by
+// an interrupt that arrived before the call is never missed. The wait is
+// bounded by a watchdog, so callers must recheck their condition on return.
+//
+// Must be called from a context that can sleep.
+void uvm_gpu_isr_wait_for_interrupt(uvm_parent_gpu_t *parent_gpu, bool (*is_done)(void *), void *arg);
+
 // Initialize ISR handling state
 NV_STATUS uvm_gpu_init_isr(uvm_parent_gpu_t *parent_gpu);
 
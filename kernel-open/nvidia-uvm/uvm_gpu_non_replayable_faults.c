@@ -113,6 +113,12 @@
 // for that block is identical to that of a replayable fault, see
 // uvm_va_block_service_locked. Another similarity between the two types of
 // faults is that they use the same entry format, uvm_fault_buffer_entry_t.
+//
+// Like replayable faults, the entries read out of the shadow buffer are sorted
+// before servicing, by channel and then by address. All the faults of a
+// channel are serviced under a single acquisition of the VA space lock, the
+// faults falling in the same VA block under a single acquisition of the block
+// lock, and the faulted bit of the channel is cleared once at the end.
 
 
 // There is no error handling in this function. The caller is in charge of
@@ -123,8 +129,11 @@ NV_STATUS uvm_gpu_fault_buffer_init_non_replayable_faults(uvm_parent_gpu_t *pare
 
     UVM_ASSERT(parent_gpu->non_replayable_faults_supported);
 
-    non_replayable_faults->shadow_buffer_copy = NULL;
-    non_replayable_faults->fault_cache        = NULL;
+    non_replayable_faults->shadow_buffer_copy  = NULL;
+    non_replayable_faults->fault_cache         = NULL;
+    non_replayable_faults->ordered_fault_cache = NULL;
+    non_replayable_faults->sort_entries        = NULL;
+    non_replayable_faults->sort_scratch        = NULL;
 
     non_replayable_faults->max_faults = parent_gpu->fault_buffer_info.rm_info.nonReplayable.bufferSize /
                                         parent_gpu->fault_buffer_hal->entry_size(parent_gpu);
@@ -139,6 +148,21 @@ NV_STATUS uvm_gpu_fault_buffer_init_non_replayable_faults(uvm_parent_gpu_t *pare
     if (!non_replayable_faults->fault_cache)
         return NV_ERR_NO_MEMORY;
 
+    non_replayable_faults->ordered_fault_cache = kzalloc(non_replayable_faults->max_faults *
+                                                         sizeof(*non_replayable_faults->ordered_fault_cache), 0);
+    if (!non_replayable_faults->ordered_fault_cache)
+        return NV_ERR_NO_MEMORY;
+
+    non_replayable_faults->sort_entries = uvm_kvmalloc(non_replayable_faults->max_faults *
+                                                       sizeof(*non_replayable_faults->sort_entries));
+    if (!non_replayable_faults->sort_entries)
+        return NV_ERR_NO_MEMORY;
+
+    non_replayable_faults->sort_scratch = uvm_kvmalloc(non_replayable_faults->max_faults *
+                                                       sizeof(*non_replayable_faults->sort_scratch));
+    if (!non_replayable_faults->sort_scratch)
+        return NV_ERR_NO_MEMORY;
+
     uvm_tracker_init(&non_replayable_faults->clear_faulted_tracker);
     uvm_tracker_init(&non_replayable_faults->fault_service_tracker);
 
@@ -160,8 +184,15 @@ void uvm_gpu_fault_buffer_deinit_non_replayable_faults(uvm_parent_gpu_t *parent_
     NV_KFREE(non_replayable_faults->shadow_buffer_copy, parent_gpu->fault_buffer_info.rm_info.nonReplayable.bufferSize);
     NV_KFREE(non_replayable_faults->fault_cache,
              non_replayable_faults->max_faults * sizeof(*non_replayable_faults->fault_cache));
-    non_replayable_faults->shadow_buffer_copy = NULL;
-    non_replayable_faults->fault_cache        = NULL;
+    NV_KFREE(non_replayable_faults->ordered_fault_cache,
+             non_replayable_faults->max_faults * sizeof(*non_replayable_faults->ordered_fault_cache));
+    uvm_kvfree(non_replayable_faults->sort_entries);
+    uvm_kvfree(non_replayable_faults->sort_scratch);
+    non_replayable_faults->shadow_buffer_copy  = NULL;
+    non_replayable_faults->fault_cache         = NULL;
+    non_replayable_faults->ordered_fault_cache = NULL;
+    non_replayable_faults->sort_entries        = NULL;
+    non_replayable_faults->sort_scratch        = NULL;
 }
 
 bool uvm_gpu_non_replayable_faults_pending(uvm_parent_gpu_t *parent_gpu)
@@ -357,15 +388,15 @@ static NV_STATUS service_managed_fault_in_block_locked(uvm_gpu_t *gpu,
     policy = uvm_va_policy_get(va_block, fault_entry->fault_address);
 
     if (service_context->num_retries == 0) {
-        // notify event to tools/performance heuristics. For now we use a
-        // unique batch id per fault, since we clear the faulted channel for
-        // each fault.
+        // notify event to tools/performance heuristics. All the faults of a
+        // channel share a batch id, since the faulted bit of the channel is
+        // cleared once for all of them.
         uvm_perf_event_notify_gpu_fault(&va_space->perf_events,
                                         va_block,
                                         gpu->id,
                                         policy->preferred_location,
                                         fault_entry,
-                                        ++non_replayable_faults->batch_id,
+                                        non_replayable_faults->batch_id,
                                         false);
     }
 
@@ -430,16 +461,23 @@ static NV_STATUS service_managed_fault_in_block_locked(uvm_gpu_t *gpu,
     return status;
 }
 
-static NV_STATUS service_managed_fault_in_block(uvm_gpu_t *gpu,
-                                                uvm_va_block_t *va_block,
-                                                uvm_fault_buffer_entry_t *fault_entry)
+// Service the given faults, which must all fall within va_block and be sorted
+// by address and with the most intrusive access type first, under a single
+// acquisition of the block lock.
+static NV_STATUS service_managed_faults_in_block(uvm_gpu_t *gpu,
+                                                 uvm_va_block_t *va_block,
+                                                 uvm_fault_buffer_entry_t **faults,
+                                                 NvU32 num_faults)
 {
-    NV_STATUS status, tracker_status;
+    NV_STATUS status = NV_OK;
+    NV_STATUS tracker_status;
     uvm_va_block_retry_t va_block_retry;
     uvm_service_block_context_t *service_context = &gpu->parent->fault_buffer_info.non_replayable.block_service_context;
+    NvU32 i;
+
+    UVM_ASSERT(num_faults == 1 || !uvm_va_block_is_hmm(va_block));
 
     service_context->operation = UVM_SERVICE_OPERATION_NON_REPLAYABLE_FAULTS;
-    service_context->num_retries = 0;
 
     if (uvm_va_block_is_hmm(va_block)) {
         uvm_hmm_service_context_init(service_context);
@@ -448,12 +486,27 @@ static NV_STATUS service_managed_fault_in_block(uvm_gpu_t *gpu,
 
     uvm_mutex_lock(&va_block->lock);
 
-    status = UVM_VA_BLOCK_RETRY_LOCKED(va_block, &va_block_retry,
-                                       service_managed_fault_in_block_locked(gpu,
-                                                                             va_block,
-                                                                             &va_block_retry,
-                                                                             fault_entry,
-                                                                             service_context));
+    for (i = 0; i < num_faults && status == NV_OK; ++i) {
+        uvm_fault_buffer_entry_t *fault_entry = faults[i];
+
+        // A fault on the same address as the previous one is covered by its
+        // servicing, unless the previous one turned out to be fatal
+        if (i > 0 &&
+            faults[i - 1]->fault_address == fault_entry->fault_address &&
+            !faults[i - 1]->is_fatal) {
+            fault_entry->filtered = true;
+            continue;
+        }
+
+        service_context->num_retries = 0;
+
+        status = UVM_VA_BLOCK_RETRY_LOCKED(va_block, &va_block_retry,
+                                           service_managed_fault_in_block_locked(gpu,
+                                                                                 va_block,
+                                                                                 &va_block_retry,
+                                                                                 fault_entry,
+                                                                                 service_context));
+    }
 
     tracker_status = uvm_tracker_add_tracker_safe(&gpu->parent->fault_buffer_info.non_replayable.fault_service_tracker,
                                                   &va_block->tracker);
@@ -553,7 +606,7 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
                                     gpu->id,
                                     UVM_ID_INVALID,
                                     fault_entry,
-                                    ++non_replayable_faults->batch_id,
+                                    non_replayable_faults->batch_id,
                                     false);
 
     if (status != NV_ERR_INVALID_ADDRESS)
@@ -620,26 +673,33 @@ static NV_STATUS service_non_managed_fault(uvm_gpu_va_space_t *gpu_va_space,
     return status;
 }
 
-static NV_STATUS service_fault(uvm_gpu_t *gpu, uvm_fault_buffer_entry_t *fault_entry)
+// Service faults of a single channel and engine type, sorted by address and
+// with the most intrusive access type first. See service_fault_batch().
+static NV_STATUS service_channel_faults(uvm_gpu_t *gpu, uvm_fault_buffer_entry_t **faults, NvU32 num_faults)
 {
     NV_STATUS status;
     uvm_user_channel_t *user_channel;
     uvm_va_block_t *va_block;
     uvm_va_space_t *va_space = NULL;
     uvm_gpu_va_space_t *gpu_va_space;
+    uvm_fault_buffer_entry_t *kill_fault_entry = NULL;
     uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &gpu->parent->fault_buffer_info.non_replayable;
     uvm_va_block_context_t *va_block_context =
         &gpu->parent->fault_buffer_info.non_replayable.block_service_context.block_context;
+    NvU32 i, j;
 
-    status = uvm_gpu_fault_entry_to_va_space(gpu, fault_entry, &va_space);
+    UVM_ASSERT(num_faults > 0);
+
+    // All the faults share the instance pointer, so a single lookup is enough
+    status = uvm_gpu_fault_entry_to_va_space(gpu, faults[0], &va_space);
     if (status != NV_OK) {
         // The VA space lookup will fail if we're running concurrently with
         // removal of the channel from the VA space (channel unregister, GPU VA
         // space unregister, VA space destroy, etc). The other thread will stop
         // the channel and remove the channel from the table, so the faulting
         // condition will be gone. In the case of replayable faults we need to
-        // flush the buffer, but here we can just ignore the entry and proceed
-        // on.
+        // flush the buffer, but here we can just ignore the entries and
+        // proceed on.
         //
         // Note that we can't have any subcontext issues here, since non-
         // replayable faults only use the address space of their channel.
@@ -660,44 +720,72 @@ static NV_STATUS service_fault(uvm_gpu_t *gpu, uvm_fault_buffer_entry_t *fault_e
         goto exit_no_channel;
     }
 
-    fault_entry->va_space = va_space;
-
-    user_channel = uvm_gpu_va_space_get_user_channel(gpu_va_space, fault_entry->instance_ptr);
+    user_channel = uvm_gpu_va_space_get_user_channel(gpu_va_space, faults[0]->instance_ptr);
     if (!user_channel) {
         // The channel might have gone away. See the comment above.
         status = NV_OK;
         goto exit_no_channel;
     }
 
-    fault_entry->fault_source.channel_id = user_channel->hw_channel_id;
+    for (i = 0; i < num_faults; ++i) {
+        faults[i]->va_space = va_space;
+        faults[i]->fault_source.channel_id = user_channel->hw_channel_id;
+    }
+
+    ++non_replayable_faults->batch_id;
 
-    if (!fault_entry->is_fatal) {
-        status = uvm_va_block_find_create(fault_entry->va_space,
+    for (i = 0; i < num_faults && status == NV_OK; i = j) {
+        uvm_fault_buffer_entry_t *fault_entry = faults[i];
+
+        j = i + 1;
+
+        if (fault_entry->is_fatal)
+            continue;
+
+        status = uvm_va_block_find_create(va_space,
                                           fault_entry->fault_address,
                                           &va_block_context->hmm.vma,
                                           &va_block);
-        if (status == NV_OK)
-            status = service_managed_fault_in_block(gpu_va_space->gpu, va_block, fault_entry);
-        else
+        if (status != NV_OK) {
             status = service_non_managed_fault(gpu_va_space, NULL, fault_entry, status);
+            continue;
+        }
 
-        // We are done, we clear the faulted bit on the channel, so it can be
-        // re-scheduled again
-        if (status == NV_OK && !fault_entry->is_fatal) {
-            status = clear_faulted_on_gpu(gpu,
-                                          user_channel,
-                                          fault_entry,
-                                          non_replayable_faults->batch_id,
-                                          &non_replayable_faults->fault_service_tracker);
-            uvm_tracker_clear(&non_replayable_faults->fault_service_tracker);
+        // Service the following faults in the same block along with this
+        // one. HMM blocks are serviced using the VMA looked up for the first
+        // fault, which may not cover the others, so they are not grouped.
+        if (!uvm_va_block_is_hmm(va_block)) {
+            while (j < num_faults && !faults[j]->is_fatal && faults[j]->fault_address <= va_block->end)
+                ++j;
         }
+
+        status = service_managed_faults_in_block(gpu_va_space->gpu, va_block, faults + i, j - i);
     }
 
-    if (fault_entry->is_fatal)
-        uvm_tools_record_gpu_fatal_fault(gpu->parent->id, fault_entry->va_space, fault_entry, fault_entry->fatal_reason);
+    for (i = 0; i < num_faults; ++i) {
+        if (!faults[i]->is_fatal)
+            continue;
+
+        uvm_tools_record_gpu_fatal_fault(gpu->parent->id, va_space, faults[i], faults[i]->fatal_reason);
 
-    if (status != NV_OK || fault_entry->is_fatal)
-        schedule_kill_channel(gpu, fault_entry, user_channel);
+        if (!kill_fault_entry)
+            kill_fault_entry = faults[i];
+    }
+
+    // We are done, we clear the faulted bit on the channel, so it can be
+    // re-scheduled again
+    if (status == NV_OK && !kill_fault_entry) {
+        status = clear_faulted_on_gpu(gpu,
+                                      user_channel,
+                                      faults[num_faults - 1],
+                                      non_replayable_faults->batch_id,
+                                      &non_replayable_faults->fault_service_tracker);
+        uvm_tracker_clear(&non_replayable_faults->fault_service_tracker);
+    }
+
+    // Forward the first fatal fault to RM, or any fault if servicing failed
+    if (status != NV_OK || kill_fault_entry)
+        schedule_kill_channel(gpu, kill_fault_entry ? kill_fault_entry : faults[0], user_channel);
 
 exit_no_channel:
     uvm_va_space_up_read(va_space);
@@ -708,6 +796,76 @@ exit_no_channel:
     return status;
 }
 
+static bool is_same_channel(const uvm_fault_buffer_entry_t *a, const uvm_fault_buffer_entry_t *b)
+{
+    return uvm_gpu_phys_addr_cmp(a->instance_ptr, b->instance_ptr) == 0 &&
+           a->fault_source.mmu_engine_type == b->fault_source.mmu_engine_type;
+}
+
+// Sort the ordered fault cache by channel, engine type, fault address and
+// access type. The engine type is part of the channel key because it selects
+// the faulted bit to clear. Instance blocks and fault addresses are 4K
+// aligned, which leaves room for the aperture and the engine type in the low
+// bits of the former, and for the access type in the latter. The access type
+// is inverted to sort more intrusive accesses first.
+static void sort_fault_batch(uvm_non_replayable_fault_buffer_info_t *non_replayable_faults, NvU32 cached_faults)
+{
+    NvU32 i;
+
+    BUILD_BUG_ON(UVM_MMU_ENGINE_TYPE_COUNT > 4);
+    BUILD_BUG_ON((UVM_APERTURE_MAX << 2) >= UVM_PAGE_SIZE_4K);
+
+    for (i = 0; i < cached_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = non_replayable_faults->ordered_fault_cache[i];
+        uvm_radix_sort_entry_t *sort_entry = &non_replayable_faults->sort_entries[i];
+
+        UVM_ASSERT(IS_ALIGNED(entry->instance_ptr.address, UVM_PAGE_SIZE_4K));
+        UVM_ASSERT(IS_ALIGNED(entry->fault_address, UVM_PAGE_SIZE_4K));
+        UVM_ASSERT(entry->fault_access_type < UVM_FAULT_ACCESS_TYPE_COUNT);
+
+        sort_entry->hi = entry->instance_ptr.address |
+                         ((NvU64)entry->instance_ptr.aperture << 2) |
+                         entry->fault_source.mmu_engine_type;
+        sort_entry->lo = entry->fault_address | (UVM_FAULT_ACCESS_TYPE_COUNT - 1 - entry->fault_access_type);
+        sort_entry->elem = entry;
+    }
+
+    uvm_radix_sort_ptrs((void **)non_replayable_faults->ordered_fault_cache,
+                        non_replayable_faults->sort_entries,
+                        non_replayable_faults->sort_scratch,
+                        cached_faults);
+}
+
+// Bursts of non-replayable faults, for example from copy engines, often hit
+// the same channel and VA blocks. Sort the fetched faults so those end up next
+// to each other and service each channel's faults as a batch.
+static NV_STATUS service_fault_batch(uvm_gpu_t *gpu, NvU32 cached_faults)
+{
+    uvm_non_replayable_fault_buffer_info_t *non_replayable_faults = &gpu->parent->fault_buffer_info.non_replayable;
+    uvm_fault_buffer_entry_t **ordered_fault_cache = non_replayable_faults->ordered_fault_cache;
+    NvU32 i, j;
+
+    // We sort the pointers, not the entries in fault_cache, since
+    // schedule_kill_channel() relies on their buffer index
+    for (i = 0; i < cached_faults; ++i)
+        ordered_fault_cache[i] = &non_replayable_faults->fault_cache[i];
+
+    sort_fault_batch(non_replayable_faults, cached_faults);
+
+    for (i = 0; i < cached_faults; i = j) {
+        NV_STATUS status;
+
+        for (j = i + 1; j < cached_faults && is_same_channel(ordered_fault_cache[i], ordered_fault_cache[j]); ++j)
+            ;
+
+        status = service_channel_faults(gpu, ordered_fault_cache + i, j - i);
+        if (status != NV_OK)
+            return status;
+    }
+
+    return NV_OK;
+}
+
 void uvm_gpu_service_non_replayable_fault_buffer(uvm_gpu_t *gpu)
 {
     NvU32 cached_faults;
@@ -718,19 +876,16 @@ void uvm_gpu_service_non_replayable_fault_buffer(uvm_gpu_t *gpu)
     // returned to the RM.
     do {
         NV_STATUS status;
-        NvU32 i;
 
         status = fetch_non_replayable_fault_buffer_entries(gpu->parent, &cached_faults);
         if (status != NV_OK)
             return;
 
-        // Differently to replayable faults, we do not batch up and preprocess
-        // non-replayable faults since getting multiple faults on the same
-        // memory region is not very likely
-        for (i = 0; i < cached_faults; ++i) {
-            status = service_fault(gpu, &gpu->parent->fault_buffer_info.non_replayable.fault_cache[i]);
-            if (status != NV_OK)
-                return;
-        }
+        if (cached_faults == 0)
+            break;
+
+        status = service_fault_batch(gpu, cached_faults);
+        if (status != NV_OK)
+            return;
     } while (cached_faults > 0);
 }
@@ -22,6 +22,7 @@
 *******************************************************************************/
 
 #include "nv_uvm_interface.h"
+#include "uvm_api.h"
 #include "uvm_common.h"
 #include "uvm_nanos.h"
 #include "uvm_global.h"
@@ -96,6 +97,90 @@ module_param(uvm_perf_fault_max_throttle_per_service, uint, S_IRUGO);
 static unsigned uvm_perf_fault_coalesce = 1;
 module_param(uvm_perf_fault_coalesce, uint, S_IRUGO);
 
+#define UVM_PERF_FAULT_BATCH_COUNT_ADAPTIVE_MIN 32
+
+// Adapt the number of entries fetched per batch, and the choice between the
+// BATCH and BATCH_FLUSH replay policies, to the observed fault buffer
+// occupancy, duplicate ratio and batch service time. uvm_perf_fault_batch_count
+// is then the largest batch size. 0 keeps the static configuration.
+static unsigned uvm_perf_fault_batch_adaptive = 1;
+module_param(uvm_perf_fault_batch_adaptive, uint, S_IRUGO);
+
+// Batches that take longer than this to service while not being backlogged
+// are shrunk to lower the latency of sparse faults
+#define UVM_PERF_FAULT_ADAPTIVE_SERVICE_TIME_NS (500 * 1000)
+
+// Number of consecutive batches needed to grow, shrink or switch policy
+#define UVM_PERF_FAULT_ADAPTIVE_GROW_BATCHES   2
+#define UVM_PERF_FAULT_ADAPTIVE_SHRINK_BATCHES 4
+#define UVM_PERF_FAULT_ADAPTIVE_CLEAN_BATCHES  8
+
+#define UVM_PERF_FAULT_SERVICE_WORKERS_DEFAULT 1
+#define UVM_PERF_FAULT_SERVICE_WORKERS_MAX 16
+
+// Number of workers that service the VA blocks of a batch in parallel. With
+// more than one worker, the sorted batch is split at VA block boundaries and
+// the parts are serviced concurrently under the VA space locks in read mode,
+// while the replay or cancel decision is still taken once for the batch.
+static unsigned uvm_perf_fault_service_workers = UVM_PERF_FAULT_SERVICE_WORKERS_DEFAULT;
+module_param(uvm_perf_fault_service_workers, uint, S_IRUGO);
+
+// Batches with fewer faults than this per worker are serviced serially
+#define UVM_PERF_FAULT_SERVICE_PARALLEL_MIN_FAULTS 16
+
+// Merge the TLB invalidates of the mappings created while servicing a batch
+// across VA blocks, and push them once per VA space before the batch is
+// replayed. 0 pushes them with the PTE writes of each VA block.
+static unsigned uvm_perf_fault_defer_tlb_invalidates = 1;
+module_param(uvm_perf_fault_defer_tlb_invalidates, uint, S_IRUGO);
+
+// Sample the latency of each fault servicing stage into per-GPU log2
+// histograms, which are printed when the GPU is removed. 0 disables sampling.
+static unsigned uvm_perf_fault_stage_histograms = 0;
+module_param(uvm_perf_fault_stage_histograms, uint, S_IRUGO);
+
+static NvU64 fault_stage_begin(void)
+{
+    return uvm_perf_fault_stage_histograms ? NV_GETTIME() : 0;
+}
+
+static void fault_stage_end(uvm_parent_gpu_t *parent_gpu, uvm_fault_stage_t stage, NvU64 start)
+{
+    NvU64 elapsed;
+    NvU32 bucket = 0;
+
+    if (!uvm_perf_fault_stage_histograms)
+        return;
+
+    elapsed = NV_GETTIME() - start;
+    if (elapsed > 0)
+        bucket = min((NvU32)ilog2(elapsed), (NvU32)UVM_FAULT_STAGE_HISTOGRAM_BUCKETS - 1);
+
+    atomic64_inc(&parent_gpu->fault_buffer_info.replayable.stats.stage_latency[stage][bucket]);
+}
+
+static void fault_stage_histograms_print(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    int stage;
+    NvU32 bucket;
+
+    if (!uvm_perf_fault_stage_histograms)
+        return;
+
+    UVM_INFO_PRINT("Replayable fault stage latencies on GPU %s (samples per [2^i, 2^(i+1)) ns bucket):\n",
+                   parent_gpu->name);
+
+    for (stage = 0; stage < UVM_FAULT_STAGE_COUNT; ++stage) {
+        for (bucket = 0; bucket < UVM_FAULT_STAGE_HISTOGRAM_BUCKETS; ++bucket) {
+            NvU64 count = atomic64_read(&replayable_faults->stats.stage_latency[stage][bucket]);
+
+            if (count != 0)
+                UVM_INFO_PRINT("  %s[%u]: %llu\n", uvm_fault_stage_string(stage), bucket, count);
+        }
+    }
+}
+
 // This function is used for both the initial fault buffer initialization and
 // the power management resume path.
 static void fault_buffer_reinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
@@ -118,6 +203,66 @@ static void fault_buffer_reinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
 
 // There is no error handling in this function. The caller is in charge of
 // calling fault_buffer_deinit_replayable_faults on failure.
+static void fault_service_worker_entry(void *args);
+
+static NV_STATUS fault_buffer_init_parallel_service(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU32 worker_count = min(uvm_perf_fault_service_workers, (unsigned)UVM_PERF_FAULT_SERVICE_WORKERS_MAX);
+    char kthread_name[16 + 1];
+    NvU32 i;
+    int ret;
+
+    if (worker_count != uvm_perf_fault_service_workers) {
+        pr_info("Invalid uvm_perf_fault_service_workers value on GPU %s: %u. Valid range [0:%u] Using %u instead\n",
+                parent_gpu->name,
+                uvm_perf_fault_service_workers,
+                UVM_PERF_FAULT_SERVICE_WORKERS_MAX,
+                worker_count);
+    }
+
+    if (worker_count <= 1)
+        return NV_OK;
+
+    replayable_faults->parallel.workers =
+        uvm_kvmalloc_zero(worker_count * sizeof(*replayable_faults->parallel.workers));
+    if (!replayable_faults->parallel.workers)
+        return NV_ERR_NO_MEMORY;
+
+    for (i = 0; i < worker_count; i++)
+        nv_kthread_q_item_init(&replayable_faults->parallel.workers[i].q_item,
+                               fault_service_worker_entry,
+                               &replayable_faults->parallel.workers[i]);
+
+    sema_init(&replayable_faults->parallel.done, 0);
+
+    // The bottom half services one part itself
+    snprintf(kthread_name, sizeof(kthread_name), "UVM GPU%u FS", uvm_id_value(parent_gpu->id));
+    ret = nv_kthread_q_init_multi(&replayable_faults->parallel.q, kthread_name, worker_count - 1);
+    if (ret != 0) {
+        uvm_kvfree(replayable_faults->parallel.workers);
+        replayable_faults->parallel.workers = NULL;
+        return errno_to_nv_status(ret);
+    }
+
+    replayable_faults->parallel.worker_count = worker_count;
+
+    return NV_OK;
+}
+
+static void fault_buffer_deinit_parallel_service(uvm_parent_gpu_t *parent_gpu)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+
+    if (replayable_faults->parallel.worker_count == 0)
+        return;
+
+    nv_kthread_q_stop(&replayable_faults->parallel.q);
+    uvm_kvfree(replayable_faults->parallel.workers);
+    replayable_faults->parallel.workers = NULL;
+    replayable_faults->parallel.worker_count = 0;
+}
+
 static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gpu)
 {
     NV_STATUS status = NV_OK;
@@ -157,6 +302,14 @@ static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gp
     if (!batch_context->ordered_fault_cache)
         return NV_ERR_NO_MEMORY;
 
+    batch_context->sort_entries = uvm_kvmalloc(replayable_faults->max_faults * sizeof(*batch_context->sort_entries));
+    if (!batch_context->sort_entries)
+        return NV_ERR_NO_MEMORY;
+
+    batch_context->sort_scratch = uvm_kvmalloc(replayable_faults->max_faults * sizeof(*batch_context->sort_scratch));
+    if (!batch_context->sort_scratch)
+        return NV_ERR_NO_MEMORY;
+
     // This value must be initialized by HAL
     UVM_ASSERT(replayable_faults->utlb_count > 0);
 
@@ -193,11 +346,21 @@ static NV_STATUS fault_buffer_init_replayable_faults(uvm_parent_gpu_t *parent_gp
                 replayable_faults->replay_update_put_ratio);
     }
 
+    replayable_faults->adaptive.enabled = uvm_perf_fault_batch_adaptive != 0 &&
+                                          parent_gpu->fault_buffer_info.max_batch_size >
+                                          UVM_PERF_FAULT_BATCH_COUNT_ADAPTIVE_MIN;
+    replayable_faults->adaptive.batch_size = parent_gpu->fault_buffer_info.max_batch_size;
+    replayable_faults->adaptive.configured_policy = replayable_faults->replay_policy;
+
     // Re-enable fault prefetching just in case it was disabled in a previous run
     parent_gpu->fault_buffer_info.prefetch_faults_enabled = parent_gpu->prefetch_fault_supported;
 
     fault_buffer_reinit_replayable_faults(parent_gpu);
 
+    status = fault_buffer_init_parallel_service(parent_gpu);
+    if (status != NV_OK)
+        return status;
+
     return NV_OK;
 }
 
@@ -206,6 +369,10 @@ static void fault_buffer_deinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
     uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
     uvm_fault_service_batch_context_t *batch_context = &replayable_faults->batch_service_context;
 
+    fault_buffer_deinit_parallel_service(parent_gpu);
+
+    fault_stage_histograms_print(parent_gpu);
+
     if (batch_context->fault_cache) {
         UVM_ASSERT(uvm_tracker_is_empty(&replayable_faults->replay_tracker));
         uvm_tracker_deinit(&replayable_faults->replay_tracker);
@@ -220,9 +387,13 @@ static void fault_buffer_deinit_replayable_faults(uvm_parent_gpu_t *parent_gpu)
     NV_KFREE(batch_context->fault_cache, replayable_faults->max_faults * sizeof(*batch_context->fault_cache));
     NV_KFREE(batch_context->ordered_fault_cache,
              replayable_faults->max_faults * sizeof(*batch_context->ordered_fault_cache));
+    uvm_kvfree(batch_context->sort_entries);
+    uvm_kvfree(batch_context->sort_scratch);
     uvm_kvfree(batch_context->utlbs);
     batch_context->fault_cache         = NULL;
     batch_context->ordered_fault_cache = NULL;
+    batch_context->sort_entries        = NULL;
+    batch_context->sort_scratch        = NULL;
     batch_context->utlbs               = NULL;
 }
 
@@ -775,6 +946,41 @@ static bool fetch_fault_buffer_try_merge_entry(uvm_fault_buffer_entry_t *current
     return false;
 }
 
+// Number of entries left in the fault buffer after the last fetch, according
+// to the cached GET and PUT pointers
+static NvU32 fault_buffer_pending_entries(uvm_replayable_fault_buffer_info_t *replayable_faults)
+{
+    if (replayable_faults->cached_put >= replayable_faults->cached_get)
+        return replayable_faults->cached_put - replayable_faults->cached_get;
+
+    return replayable_faults->max_faults - replayable_faults->cached_get + replayable_faults->cached_put;
+}
+
+// Account the fault buffer occupancy after PUT has been read. The GPU stops
+// writing entries once PUT is right behind GET, so a full buffer is counted as
+// an overflow.
+static void fault_buffer_update_overflow_stats(uvm_replayable_fault_buffer_info_t *replayable_faults)
+{
+    NvU32 pending_entries = fault_buffer_pending_entries(replayable_faults);
+
+    if (pending_entries > replayable_faults->overflow.max_pending_entries)
+        replayable_faults->overflow.max_pending_entries = pending_entries;
+
+    if (pending_entries == replayable_faults->max_faults - 1) {
+        if (replayable_faults->overflow.start_ns == 0) {
+            ++replayable_faults->overflow.num_overflows;
+            replayable_faults->overflow.start_ns = NV_GETTIME();
+        }
+    }
+    else if (pending_entries == 0 && replayable_faults->overflow.start_ns != 0) {
+        NvU64 drain_ns = NV_GETTIME() - replayable_faults->overflow.start_ns;
+
+        replayable_faults->overflow.total_drain_ns += drain_ns;
+        replayable_faults->overflow.max_drain_ns = max(replayable_faults->overflow.max_drain_ns, drain_ns);
+        replayable_faults->overflow.start_ns = 0;
+    }
+}
+
 // Fetch entries from the fault buffer, decode them and store them in the batch
 // context. We implement the fetch modes described above.
 //
@@ -821,8 +1027,10 @@ static NV_STATUS fetch_fault_buffer_entries(uvm_gpu_t *gpu,
     get = replayable_faults->cached_get;
 
     // Read put pointer from GPU and cache it
-    if (get == replayable_faults->cached_put)
+    if (get == replayable_faults->cached_put) {
         replayable_faults->cached_put = gpu->parent->fault_buffer_hal->read_put(gpu->parent);
+        fault_buffer_update_overflow_stats(replayable_faults);
+    }
 
     put = replayable_faults->cached_put;
 
@@ -844,7 +1052,7 @@ static NV_STATUS fetch_fault_buffer_entries(uvm_gpu_t *gpu,
 
     // Parse until get != put and have enough space to cache.
     while ((get != put) &&
-           (fetch_mode == FAULT_FETCH_MODE_ALL || fault_index < gpu->parent->fault_buffer_info.max_batch_size)) {
+           (fetch_mode == FAULT_FETCH_MODE_ALL || fault_index < replayable_faults->adaptive.batch_size)) {
         bool is_same_instance_ptr = true;
         uvm_fault_buffer_entry_t *current_entry = &fault_cache[fault_index];
         uvm_fault_utlb_info_t *current_tlb;
@@ -936,34 +1144,54 @@ done:
     return status;
 }
 
-// Sort comparator for pointers to fault buffer entries that sorts by
-// instance pointer
-static bool cmp_sort_fault_entry_by_instance_ptr(void *_a, void *_b)
+// Sort the ordered fault cache by instance pointer. The radix sort key orders
+// entries the same way as cmp_fault_instance_ptr(): instance blocks are 4K
+// aligned, which leaves room for the subcontext id in the low bits.
+static void sort_fault_batch_by_instance_ptr(uvm_fault_service_batch_context_t *batch_context)
 {
-    const uvm_fault_buffer_entry_t **a = (const uvm_fault_buffer_entry_t **)_a;
-    const uvm_fault_buffer_entry_t **b = (const uvm_fault_buffer_entry_t **)_b;
+    NvU32 i;
+
+    for (i = 0; i < batch_context->num_coalesced_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = batch_context->ordered_fault_cache[i];
+        uvm_radix_sort_entry_t *sort_entry = &batch_context->sort_entries[i];
+
+        UVM_ASSERT(IS_ALIGNED(entry->instance_ptr.address, UVM_PAGE_SIZE_4K));
+
+        sort_entry->hi = entry->instance_ptr.aperture;
+        sort_entry->lo = entry->instance_ptr.address | entry->fault_source.ve_id;
+        sort_entry->elem = entry;
+    }
 
-    return (cmp_fault_instance_ptr(*a, *b) > 0);
+    uvm_radix_sort_ptrs((void **)batch_context->ordered_fault_cache,
+                        batch_context->sort_entries,
+                        batch_context->sort_scratch,
+                        batch_context->num_coalesced_faults);
 }
 
-// Sort comparator for pointers to fault buffer entries that sorts by va_space,
-// fault address and fault access type
-static bool cmp_sort_fault_entry_by_va_space_address_access_type(void *_a, void *_b)
+// Sort the ordered fault cache by va_space, fault address and fault access
+// type. fault_address is 4K aligned, so the access type is packed in the low
+// bits of the key, inverted to sort more intrusive accesses first like
+// cmp_access_type().
+static void sort_fault_batch_by_va_space_address_access_type(uvm_fault_service_batch_context_t *batch_context)
 {
-    const uvm_fault_buffer_entry_t **a = (const uvm_fault_buffer_entry_t **)_a;
-    const uvm_fault_buffer_entry_t **b = (const uvm_fault_buffer_entry_t **)_b;
+    NvU32 i;
 
-    int result;
+    for (i = 0; i < batch_context->num_coalesced_faults; ++i) {
+        uvm_fault_buffer_entry_t *entry = batch_context->ordered_fault_cache[i];
+        uvm_radix_sort_entry_t *sort_entry = &batch_context->sort_entries[i];
 
-    result = cmp_va_space((*a)->va_space, (*b)->va_space);
-    if (result != 0)
-        return (result > 0);
+        UVM_ASSERT(IS_ALIGNED(entry->fault_address, UVM_PAGE_SIZE_4K));
+        UVM_ASSERT(entry->fault_access_type < UVM_FAULT_ACCESS_TYPE_COUNT);
 
-    result = cmp_addr((*a)->fault_address, (*b)->fault_address);
-    if (result != 0)
-        return (result > 0);
+        sort_entry->hi = (NvU64)entry->va_space;
+        sort_entry->lo = entry->fault_address | (UVM_FAULT_ACCESS_TYPE_COUNT - 1 - entry->fault_access_type);
+        sort_entry->elem = entry;
+    }
 
-    return (cmp_access_type((*a)->fault_access_type, (*b)->fault_access_type) > 0);
+    uvm_radix_sort_ptrs((void **)batch_context->ordered_fault_cache,
+                        batch_context->sort_entries,
+                        batch_context->sort_scratch,
+                        batch_context->num_coalesced_faults);
 }
 
 // Translate all instance pointers to VA spaces. Since the buffer is ordered by
@@ -1071,6 +1299,8 @@ static NV_STATUS preprocess_fault_batch(uvm_gpu_t *gpu, uvm_fault_service_batch_
     NV_STATUS status;
     NvU32 i, j;
     uvm_fault_buffer_entry_t **ordered_fault_cache = batch_context->ordered_fault_cache;
+    NvU64 stage_start;
+    NvU64 sort_time;
 
     UVM_ASSERT(batch_context->num_coalesced_faults > 0);
     UVM_ASSERT(batch_context->num_cached_faults >= batch_context->num_coalesced_faults);
@@ -1087,24 +1317,23 @@ static NV_STATUS preprocess_fault_batch(uvm_gpu_t *gpu, uvm_fault_service_batch_
     UVM_ASSERT(j == batch_context->num_coalesced_faults);
 
     // 1) if the fault batch contains more than one, sort by instance_ptr
-    if (!batch_context->is_single_instance_ptr) {
-        if (!sort((void **)ordered_fault_cache,
-             batch_context->num_coalesced_faults,
-             cmp_sort_fault_entry_by_instance_ptr))
-            return NV_ERR_NO_MEMORY;
-    }
+    stage_start = fault_stage_begin();
+    if (!batch_context->is_single_instance_ptr)
+        sort_fault_batch_by_instance_ptr(batch_context);
+    sort_time = fault_stage_begin() - stage_start;
 
     // 2) translate all instance_ptrs to VA spaces
+    stage_start = fault_stage_begin();
     status = translate_instance_ptrs(gpu, batch_context);
+    fault_stage_end(gpu->parent, UVM_FAULT_STAGE_TRANSLATE, stage_start);
     if (status != NV_OK)
         return status;
 
     // 3) sort by va_space, fault address (GPU already reports 4K-aligned
-    // address) and access type
-    if (!sort((void **)ordered_fault_cache,
-         batch_context->num_coalesced_faults,
-         cmp_sort_fault_entry_by_va_space_address_access_type))
-        return NV_ERR_NO_MEMORY;
+    // address) and access type. Both sorts are accounted as a single sample.
+    stage_start = fault_stage_begin() - sort_time;
+    sort_fault_batch_by_va_space_address_access_type(batch_context);
+    fault_stage_end(gpu->parent, UVM_FAULT_STAGE_SORT, stage_start);
 
     return NV_OK;
 }
@@ -1164,6 +1393,7 @@ static void mark_fault_throttled(uvm_fault_service_batch_context_t *batch_contex
 {
     fault_entry->is_throttled = true;
     batch_context->has_throttled_faults = true;
+    batch_context->num_throttled_faults++;
 }
 
 static void mark_fault_fatal(uvm_fault_service_batch_context_t *batch_context,
@@ -1302,6 +1532,7 @@ static uvm_fault_access_type_t check_fault_access_permissions(uvm_gpu_t *gpu,
 static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
                                                   uvm_va_block_t *va_block,
                                                   uvm_va_block_retry_t *va_block_retry,
+                                                  uvm_service_block_context_t *block_context,
                                                   uvm_fault_service_batch_context_t *batch_context,
                                                   NvU32 first_fault_index,
                                                   NvU32 *block_faults)
@@ -1312,12 +1543,11 @@ static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
     uvm_page_index_t last_page_index;
     NvU32 page_fault_count = 0;
     uvm_range_group_range_iter_t iter;
-    uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
     uvm_fault_buffer_entry_t **ordered_fault_cache = batch_context->ordered_fault_cache;
-    uvm_service_block_context_t *block_context = &replayable_faults->block_service_context;
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     const uvm_va_policy_t *policy;
     NvU64 end;
+    NvU64 block_start = fault_stage_begin();
 
     // Check that all uvm_fault_access_type_t values can fit into an NvU8
     BUILD_BUG_ON(UVM_FAULT_ACCESS_TYPE_COUNT > (int)(NvU8)-1);
@@ -1501,8 +1731,11 @@ static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
     // Apply the changes computed in the fault service block context, if there
     // are pages to be serviced
     if (page_fault_count > 0) {
+        NvU64 apply_start = fault_stage_begin();
+
         block_context->region = uvm_va_block_region(first_page_index, last_page_index + 1);
         status = uvm_va_block_service_locked(gpu->id, va_block, va_block_retry, block_context);
+        fault_stage_end(gpu->parent, UVM_FAULT_STAGE_BLOCK_APPLY, apply_start);
     }
 
     *block_faults = i - first_fault_index;
@@ -1512,6 +1745,8 @@ static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
     if (status == NV_OK && batch_context->has_fatal_faults)
         status = uvm_va_block_set_cancel(va_block, &block_context->block_context, gpu);
 
+    fault_stage_end(gpu->parent, UVM_FAULT_STAGE_BLOCK_SERVICE, block_start);
+
     return status;
 }
 
@@ -1524,6 +1759,7 @@ static NV_STATUS service_fault_batch_block_locked(uvm_gpu_t *gpu,
 // implementation details and error codes.
 static NV_STATUS service_fault_batch_block(uvm_gpu_t *gpu,
                                            uvm_va_block_t *va_block,
+                                           uvm_service_block_context_t *fault_block_context,
                                            uvm_fault_service_batch_context_t *batch_context,
                                            NvU32 first_fault_index,
                                            NvU32 *block_faults)
@@ -1531,7 +1767,6 @@ static NV_STATUS service_fault_batch_block(uvm_gpu_t *gpu,
     NV_STATUS status;
     uvm_va_block_retry_t va_block_retry;
     NV_STATUS tracker_status;
-    uvm_service_block_context_t *fault_block_context = &gpu->parent->fault_buffer_info.replayable.block_service_context;
 
     fault_block_context->operation = UVM_SERVICE_OPERATION_REPLAYABLE_FAULTS;
     fault_block_context->num_retries = 0;
@@ -1545,6 +1780,7 @@ static NV_STATUS service_fault_batch_block(uvm_gpu_t *gpu,
                                        service_fault_batch_block_locked(gpu,
                                                                         va_block,
                                                                         &va_block_retry,
+                                                                        fault_block_context,
                                                                         batch_context,
                                                                         first_fault_index,
                                                                         block_faults));
@@ -1847,6 +2083,7 @@ static NV_STATUS service_fault_batch_ats(uvm_gpu_va_space_t *gpu_va_space,
 
 static NV_STATUS service_fault_batch_dispatch(uvm_va_space_t *va_space,
                                               uvm_gpu_va_space_t *gpu_va_space,
+                                              uvm_service_block_context_t *service_context,
                                               uvm_fault_service_batch_context_t *batch_context,
                                               NvU32 fault_index,
                                               NvU32 *block_faults,
@@ -1857,8 +2094,7 @@ static NV_STATUS service_fault_batch_dispatch(uvm_va_space_t *va_space,
     uvm_va_range_t *va_range_next = NULL;
     uvm_va_block_t *va_block;
     uvm_gpu_t *gpu = gpu_va_space->gpu;
-    uvm_va_block_context_t *va_block_context =
-        &gpu->parent->fault_buffer_info.replayable.block_service_context.block_context;
+    uvm_va_block_context_t *va_block_context = &service_context->block_context;
     uvm_fault_buffer_entry_t *current_entry = batch_context->ordered_fault_cache[fault_index];
     struct mm_struct *mm = va_block_context->mm;
     NvU64 fault_address = current_entry->fault_address;
@@ -1881,7 +2117,12 @@ static NV_STATUS service_fault_batch_dispatch(uvm_va_space_t *va_space,
         status = NV_ERR_INVALID_ADDRESS;
 
     if (status == NV_OK) {
-        status = service_fault_batch_block(gpu, va_block, batch_context, fault_index, block_faults);
+        status = service_fault_batch_block(gpu, va_block, service_context, batch_context, fault_index, block_faults);
+
+        // Issue the migrations predicted by the stream prefetcher now that
+        // the block lock has been dropped
+        if (status == NV_OK && va_range && uvm_perf_prefetch_enabled(va_space))
+            uvm_perf_prefetch_streams_issue(va_space, va_block_context);
     }
     else if ((status == NV_ERR_INVALID_ADDRESS) && uvm_ats_can_service_faults(gpu_va_space)) {
         NvU64 outer = ~0ULL;
@@ -1935,6 +2176,54 @@ static NV_STATUS service_fault_batch_dispatch(uvm_va_space_t *va_space,
     return status;
 }
 
+// Start merging the mapping TLB invalidates of the VA blocks serviced with
+// service_context in gpu_va_space
+static void deferred_tlb_invalidates_begin(uvm_gpu_t *gpu,
+                                           uvm_gpu_va_space_t *gpu_va_space,
+                                           uvm_service_block_context_t *service_context)
+{
+    uvm_tlb_batch_t *tlb_batch = &gpu->parent->fault_buffer_info.replayable.map_tlb_batch;
+
+    UVM_ASSERT(!service_context->block_context.mapping.deferred_tlb_batch);
+
+    uvm_tlb_batch_begin(&gpu_va_space->page_tables, tlb_batch);
+    service_context->block_context.mapping.deferred_tlb_batch = tlb_batch;
+}
+
+// Push the mapping TLB invalidates merged since
+// deferred_tlb_invalidates_begin(), if any. The push acquires tracker, which
+// holds the PTE writes of the serviced VA blocks, and is added to it so that
+// the replay waits for it.
+static NV_STATUS deferred_tlb_invalidates_end(uvm_gpu_t *gpu,
+                                              uvm_service_block_context_t *service_context,
+                                              uvm_tracker_t *tracker)
+{
+    NV_STATUS status;
+    uvm_push_t push;
+    uvm_tlb_batch_t *tlb_batch = service_context->block_context.mapping.deferred_tlb_batch;
+
+    if (!tlb_batch)
+        return NV_OK;
+
+    service_context->block_context.mapping.deferred_tlb_batch = NULL;
+
+    if (tlb_batch->count == 0)
+        return NV_OK;
+
+    status = uvm_push_begin_acquire(gpu->channel_manager,
+                                    UVM_CHANNEL_TYPE_MEMOPS,
+                                    tracker,
+                                    &push,
+                                    "Invalidate deferred mappings");
+    if (status != NV_OK)
+        return status;
+
+    uvm_tlb_batch_end(tlb_batch, &push, UVM_MEMBAR_NONE);
+    uvm_push_end(&push);
+
+    return uvm_tracker_add_push_safe(tracker, &push);
+}
+
 // Scan the ordered view of faults and group them by different va_blocks
 // (managed faults) and service faults for each va_block, in batch.
 // Service non-managed faults one at a time as they are encountered during the
@@ -1956,6 +2245,7 @@ static NV_STATUS service_fault_batch(uvm_gpu_t *gpu,
                                      gpu->parent->fault_buffer_info.replayable.replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BLOCK;
     uvm_service_block_context_t *service_context =
         &gpu->parent->fault_buffer_info.replayable.block_service_context;
+    const bool defer_tlb_invalidates = uvm_perf_fault_defer_tlb_invalidates && !replay_per_va_block;
 
     UVM_ASSERT(gpu->parent->replayable_faults_supported);
 
@@ -1973,6 +2263,10 @@ static NV_STATUS service_fault_batch(uvm_gpu_t *gpu,
             // Fault on a different va_space, drop the lock of the old one...
             if (va_space != NULL) {
                 // TLB entries are invalidated per GPU VA space
+                status = deferred_tlb_invalidates_end(gpu, service_context, &batch_context->tracker);
+                if (status != NV_OK)
+                    goto fail;
+
                 status = uvm_ats_invalidate_tlbs(gpu_va_space, ats_invalidate, &batch_context->tracker);
                 if (status != NV_OK)
                     goto fail;
@@ -1998,6 +2292,9 @@ static NV_STATUS service_fault_batch(uvm_gpu_t *gpu,
                 break;
             }
 
+            if (gpu_va_space && defer_tlb_invalidates)
+                deferred_tlb_invalidates_begin(gpu, gpu_va_space, service_context);
+
             // The case where there is no valid GPU VA space for the GPU in this
             // VA space is handled next
         }
@@ -2024,12 +2321,17 @@ static NV_STATUS service_fault_batch(uvm_gpu_t *gpu,
 
         status = service_fault_batch_dispatch(va_space,
                                               gpu_va_space,
+                                              service_context,
                                               batch_context,
                                               i,
                                               &block_faults,
                                               replay_per_va_block);
         // TODO: Bug 3900733: clean up locking in service_fault_batch().
         if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            status = deferred_tlb_invalidates_end(gpu, service_context, &batch_context->tracker);
+            if (status != NV_OK)
+                goto fail;
+
             uvm_va_space_up_read(va_space);
             va_space = NULL;
             status = NV_OK;
@@ -2057,14 +2359,245 @@ static NV_STATUS service_fault_batch(uvm_gpu_t *gpu,
     // Only clobber status if invalidate_status != NV_OK, since status may also
     // contain NV_WARN_MORE_PROCESSING_REQUIRED.
     if (va_space != NULL) {
-        NV_STATUS invalidate_status = uvm_ats_invalidate_tlbs(gpu_va_space, ats_invalidate, &batch_context->tracker);
+        NV_STATUS invalidate_status = deferred_tlb_invalidates_end(gpu, service_context, &batch_context->tracker);
+        if (invalidate_status != NV_OK)
+            status = invalidate_status;
+
+        invalidate_status = uvm_ats_invalidate_tlbs(gpu_va_space, ats_invalidate, &batch_context->tracker);
         if (invalidate_status != NV_OK)
             status = invalidate_status;
     }
 
 fail:
     if (va_space != NULL) {
+        // Still push the invalidates merged so far, the mappings they cover
+        // have been created
+        (void)deferred_tlb_invalidates_end(gpu, service_context, &batch_context->tracker);
+
+        uvm_va_space_up_read(va_space);
+    }
+
+    return status;
+}
+
+// Service the faults of one part of a batch, starting at first_fault_index and
+// ending at batch_context->num_coalesced_faults. This is the loop of
+// service_fault_batch() without the cases that service_fault_batch_parallel()
+// leaves to the serial path: fault buffer flushes, ATS and per-VA block
+// replays.
+static NV_STATUS service_fault_batch_part(uvm_gpu_t *gpu,
+                                          uvm_service_block_context_t *service_context,
+                                          uvm_fault_service_batch_context_t *batch_context,
+                                          NvU32 first_fault_index)
+{
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+    uvm_va_space_t *va_space = NULL;
+    uvm_gpu_va_space_t *gpu_va_space = NULL;
+
+    uvm_hmm_service_context_init(service_context);
+
+    for (i = first_fault_index; i < batch_context->num_coalesced_faults;) {
+        NvU32 block_faults;
+        uvm_fault_buffer_entry_t *current_entry = batch_context->ordered_fault_cache[i];
+
+        if (current_entry->va_space != va_space) {
+            if (va_space != NULL)
+                uvm_va_space_up_read(va_space);
+
+            va_space = current_entry->va_space;
+            uvm_va_space_down_read(va_space);
+
+            gpu_va_space = uvm_gpu_va_space_get_by_parent_gpu(va_space, gpu->parent);
+        }
+
+        if (current_entry->is_fatal) {
+            ++i;
+            batch_context->has_fatal_faults = true;
+
+            // uTLB info is shared by all parts; concurrent stores of true
+            // are benign.
+            batch_context->utlbs[current_entry->fault_source.utlb_id].has_fatal_faults = true;
+            continue;
+        }
+
+        if (!uvm_processor_mask_test(&va_space->registered_gpu_va_spaces, gpu->parent->id)) {
+            ++i;
+            continue;
+        }
+
+        status = service_fault_batch_dispatch(va_space,
+                                              gpu_va_space,
+                                              service_context,
+                                              batch_context,
+                                              i,
+                                              &block_faults,
+                                              false);
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            uvm_va_space_up_read(va_space);
+            va_space = NULL;
+            status = NV_OK;
+            continue;
+        }
+
+        if (status != NV_OK)
+            break;
+
+        i += block_faults;
+    }
+
+    if (va_space != NULL)
         uvm_va_space_up_read(va_space);
+
+    return status;
+}
+
+static void fault_service_worker(uvm_fault_service_worker_t *worker)
+{
+    worker->status = service_fault_batch_part(worker->gpu,
+                                              &worker->block_service_context,
+                                              &worker->batch_context,
+                                              worker->first_fault_index);
+
+    up(&worker->gpu->parent->fault_buffer_info.replayable.parallel.done);
+}
+
+static void fault_service_worker_entry(void *args)
+{
+    UVM_ENTRY_VOID(fault_service_worker((uvm_fault_service_worker_t *)args));
+}
+
+static bool same_va_block_region(const uvm_fault_buffer_entry_t *a, const uvm_fault_buffer_entry_t *b)
+{
+    return a->va_space == b->va_space &&
+           UVM_ALIGN_DOWN(a->fault_address, UVM_VA_BLOCK_SIZE) == UVM_ALIGN_DOWN(b->fault_address, UVM_VA_BLOCK_SIZE);
+}
+
+// Split the ordered batch into at most max_parts parts of similar size. Parts
+// only end where the VA space or the UVM_VA_BLOCK_SIZE region changes, so no
+// VA block is serviced by more than one part. Returns the number of parts and
+// fills starts with the first fault index of each.
+static NvU32 partition_fault_batch(uvm_fault_service_batch_context_t *batch_context,
+                                   NvU32 max_parts,
+                                   NvU32 *starts)
+{
+    uvm_fault_buffer_entry_t **ordered_fault_cache = batch_context->ordered_fault_cache;
+    NvU32 num_faults = batch_context->num_coalesced_faults;
+    NvU32 target = max(num_faults / max_parts, (NvU32)UVM_PERF_FAULT_SERVICE_PARALLEL_MIN_FAULTS);
+    NvU32 num_parts = 1;
+    NvU32 i;
+
+    starts[0] = 0;
+
+    for (i = target; i < num_faults && num_parts < max_parts; i++) {
+        if (i - starts[num_parts - 1] < target)
+            continue;
+
+        if (same_va_block_region(ordered_fault_cache[i], ordered_fault_cache[i - 1]))
+            continue;
+
+        starts[num_parts++] = i;
+    }
+
+    return num_parts;
+}
+
+// Whether the batch can be serviced by service_fault_batch_parallel(). VA
+// spaces with a pending fault buffer flush and ATS faults need the serial
+// path, and so does the per-VA block replay policy.
+static bool can_service_fault_batch_parallel(uvm_gpu_t *gpu, uvm_fault_service_batch_context_t *batch_context)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
+    uvm_va_space_t *va_space = NULL;
+    NvU32 i;
+
+    if (replayable_faults->parallel.worker_count <= 1)
+        return false;
+
+    if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BLOCK)
+        return false;
+
+    if (g_uvm_global.ats.enabled)
+        return false;
+
+    if (batch_context->num_coalesced_faults < 2 * UVM_PERF_FAULT_SERVICE_PARALLEL_MIN_FAULTS)
+        return false;
+
+    for (i = 0; i < batch_context->num_coalesced_faults; i++) {
+        uvm_fault_buffer_entry_t *current_entry = batch_context->ordered_fault_cache[i];
+
+        if (current_entry->va_space == va_space)
+            continue;
+
+        va_space = current_entry->va_space;
+        if (uvm_processor_mask_test(&va_space->needs_fault_buffer_flush, gpu->id))
+            return false;
+    }
+
+    return true;
+}
+
+// Service the batch with the parallel workers. The bottom half services the
+// first part itself, and merges the results of all parts into batch_context
+// once they are done so that the caller takes a single replay or cancel
+// decision for the whole batch.
+static NV_STATUS service_fault_batch_parallel(uvm_gpu_t *gpu, uvm_fault_service_batch_context_t *batch_context)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &gpu->parent->fault_buffer_info.replayable;
+    uvm_fault_service_worker_t *workers = replayable_faults->parallel.workers;
+    NvU32 starts[UVM_PERF_FAULT_SERVICE_WORKERS_MAX];
+    NV_STATUS status = NV_OK;
+    NvU32 num_parts;
+    NvU32 i;
+
+    num_parts = partition_fault_batch(batch_context, replayable_faults->parallel.worker_count, starts);
+    if (num_parts == 1)
+        return service_fault_batch(gpu, FAULT_SERVICE_MODE_REGULAR, batch_context);
+
+    for (i = 0; i < num_parts; i++) {
+        uvm_fault_service_worker_t *worker = &workers[i];
+
+        worker->batch_context = *batch_context;
+        worker->batch_context.num_coalesced_faults = (i + 1 < num_parts) ?
+                                                     starts[i + 1] :
+                                                     batch_context->num_coalesced_faults;
+        worker->batch_context.has_fatal_faults = false;
+        worker->batch_context.has_throttled_faults = false;
+        worker->batch_context.num_throttled_faults = 0;
+        worker->batch_context.num_invalid_prefetch_faults = 0;
+        worker->batch_context.num_duplicate_faults = 0;
+        uvm_tracker_init(&worker->batch_context.tracker);
+
+        worker->gpu = gpu;
+        worker->first_fault_index = starts[i];
+        worker->status = NV_OK;
+    }
+
+    for (i = 1; i < num_parts; i++)
+        nv_kthread_q_schedule_q_item(&replayable_faults->parallel.q, &workers[i].q_item);
+
+    fault_service_worker(&workers[0]);
+
+    for (i = 0; i < num_parts; i++)
+        down(&replayable_faults->parallel.done);
+
+    for (i = 0; i < num_parts; i++) {
+        uvm_fault_service_batch_context_t *part = &workers[i].batch_context;
+        NV_STATUS tracker_status;
+
+        batch_context->has_fatal_faults |= part->has_fatal_faults;
+        batch_context->has_throttled_faults |= part->has_throttled_faults;
+        batch_context->num_throttled_faults += part->num_throttled_faults;
+        batch_context->num_invalid_prefetch_faults += part->num_invalid_prefetch_faults;
+        batch_context->num_duplicate_faults += part->num_duplicate_faults;
+
+        tracker_status = uvm_tracker_add_tracker_safe(&batch_context->tracker, &part->tracker);
+        uvm_tracker_deinit(&part->tracker);
+
+        if (status == NV_OK)
+            status = workers[i].status;
+        if (status == NV_OK)
+            status = tracker_status;
     }
 
     return status;
@@ -2523,6 +3056,7 @@ static NV_STATUS cancel_faults_precise_tlb(uvm_gpu_t *gpu, uvm_fault_service_bat
         batch_context->num_replays                 = 0;
         batch_context->has_fatal_faults            = false;
         batch_context->has_throttled_faults        = false;
+        batch_context->num_throttled_faults        = 0;
 
         // 5) Fetch all faults from buffer
         status = fetch_fault_buffer_entries(gpu, batch_context, FAULT_FETCH_MODE_ALL);
@@ -2620,7 +3154,8 @@ static void enable_disable_prefetch_faults(uvm_parent_gpu_t *parent_gpu, uvm_fau
     // fault reporting. If the logic changes, the tests will have to be changed.
     if (parent_gpu->fault_buffer_info.prefetch_faults_enabled &&
         uvm_perf_reenable_prefetch_faults_lapse_msec > 0 &&
-        ((batch_context->num_invalid_prefetch_faults * 3 > parent_gpu->fault_buffer_info.max_batch_size * 2) ||
+        ((batch_context->num_invalid_prefetch_faults * 3 >
+          parent_gpu->fault_buffer_info.replayable.adaptive.batch_size * 2) ||
          (uvm_enable_builtin_tests &&
           parent_gpu->rm_info.isSimulated &&
           batch_context->num_invalid_prefetch_faults > 5))) {
@@ -2635,6 +3170,198 @@ static void enable_disable_prefetch_faults(uvm_parent_gpu_t *parent_gpu, uvm_fau
     }
 }
 
+// Adaptive batch controller, run after every batch serviced without errors.
+//
+// Batches that fill batch_size and still leave entries in the buffer mean
+// faults arrive faster than they are serviced, so the batch size is doubled to
+// amortize replays over more faults. Batches that use a quarter of batch_size
+// or less, or that take long to service without a backlog, halve it, so that
+// sparse faults are replayed sooner.
+//
+// The fault buffer flush of BATCH_FLUSH is only worth its cost when many
+// duplicates show up in the buffer, so after a run of batches with few
+// duplicates the controller falls back to BATCH, and it returns to
+// BATCH_FLUSH as soon as the duplicate ratio exceeds replay_update_put_ratio.
+static void update_adaptive_batch_control(uvm_parent_gpu_t *parent_gpu,
+                                          uvm_fault_service_batch_context_t *batch_context,
+                                          NvU32 pending_entries,
+                                          NvU64 service_time_ns)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU32 batch_size = replayable_faults->adaptive.batch_size;
+    bool backlogged;
+
+    if (!replayable_faults->adaptive.enabled)
+        return;
+
+    replayable_faults->adaptive.avg_service_time_ns = (replayable_faults->adaptive.avg_service_time_ns * 7 +
+                                                       service_time_ns) / 8;
+
+    backlogged = batch_context->num_cached_faults >= batch_size && pending_entries > 0;
+
+    if (backlogged) {
+        replayable_faults->adaptive.sparse_batches = 0;
+        if (++replayable_faults->adaptive.backlogged_batches >= UVM_PERF_FAULT_ADAPTIVE_GROW_BATCHES) {
+            replayable_faults->adaptive.backlogged_batches = 0;
+            batch_size = min(batch_size * 2, parent_gpu->fault_buffer_info.max_batch_size);
+        }
+    }
+    else if (batch_context->num_cached_faults * 4 <= batch_size ||
+             replayable_faults->adaptive.avg_service_time_ns > UVM_PERF_FAULT_ADAPTIVE_SERVICE_TIME_NS) {
+        replayable_faults->adaptive.backlogged_batches = 0;
+        if (++replayable_faults->adaptive.sparse_batches >= UVM_PERF_FAULT_ADAPTIVE_SHRINK_BATCHES) {
+            replayable_faults->adaptive.sparse_batches = 0;
+            batch_size = max(batch_size / 2, (NvU32)UVM_PERF_FAULT_BATCH_COUNT_ADAPTIVE_MIN);
+        }
+    }
+    else {
+        replayable_faults->adaptive.backlogged_batches = 0;
+        replayable_faults->adaptive.sparse_batches = 0;
+    }
+
+    replayable_faults->adaptive.batch_size = batch_size;
+
+    if (replayable_faults->adaptive.configured_policy != UVM_PERF_FAULT_REPLAY_POLICY_BATCH &&
+        replayable_faults->adaptive.configured_policy != UVM_PERF_FAULT_REPLAY_POLICY_BATCH_FLUSH)
+        return;
+
+    if (batch_context->num_duplicate_faults * 100 >
+        batch_context->num_cached_faults * replayable_faults->replay_update_put_ratio) {
+        replayable_faults->adaptive.clean_batches = 0;
+        replayable_faults->replay_policy = UVM_PERF_FAULT_REPLAY_POLICY_BATCH_FLUSH;
+    }
+    else if (++replayable_faults->adaptive.clean_batches >= UVM_PERF_FAULT_ADAPTIVE_CLEAN_BATCHES) {
+        replayable_faults->adaptive.clean_batches = 0;
+        replayable_faults->replay_policy = UVM_PERF_FAULT_REPLAY_POLICY_BATCH;
+    }
+}
+
+static void record_fault_batch(uvm_parent_gpu_t *parent_gpu,
+                               uvm_fault_service_batch_context_t *batch_context,
+                               NvU8 outcome,
+                               NvU64 service_start,
+                               bool flush_update_put,
+                               NV_STATUS status)
+{
+    uvm_replayable_fault_buffer_info_t *replayable_faults = &parent_gpu->fault_buffer_info.replayable;
+    NvU64 index = replayable_faults->num_batch_records;
+    uvm_fault_batch_record_t *record = &replayable_faults->batch_records[index & (UVM_FAULT_BATCH_RECORDS - 1)];
+
+    // Order the overwrite of the oldest record after the publication of the
+    // previous one
+    wmb();
+
+    record->timestamp_ns = NV_GETTIME();
+    record->service_ns = record->timestamp_ns - service_start;
+    record->batch_id = batch_context->batch_id;
+    record->num_cached_faults = batch_context->num_cached_faults;
+    record->num_coalesced_faults = batch_context->num_coalesced_faults;
+    record->num_duplicate_faults = batch_context->num_duplicate_faults;
+    record->num_throttled_faults = batch_context->num_throttled_faults;
+    record->num_invalid_prefetch_faults = batch_context->num_invalid_prefetch_faults;
+    record->num_replays = batch_context->num_replays;
+    record->status = status;
+    record->replay_policy = replayable_faults->replay_policy;
+    record->outcome = outcome;
+    record->flush_update_put = flush_update_put;
+
+    wmb();
+    UVM_WRITE_ONCE(replayable_faults->num_batch_records, index + 1);
+}
+
+NV_STATUS uvm_api_get_fault_batch_records(UVM_GET_FAULT_BATCH_RECORDS_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_replayable_fault_buffer_info_t *replayable_faults;
+    uvm_fault_batch_record_t *records;
+    uvm_gpu_t *gpu;
+    NvU64 first;
+    NvU64 end;
+    NvU64 i;
+
+    BUILD_BUG_ON(UVM_FAULT_BATCH_RECORDS != UVM_FAULT_BATCH_RECORDS_MAX_ENTRIES);
+
+    params->numEntries = 0;
+
+    records = uvm_kvmalloc(sizeof(*records) * UVM_FAULT_BATCH_RECORDS);
+    if (!records)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_va_space_down_read(va_space);
+
+    gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->gpuUuid);
+    if (!gpu || !gpu->parent->replayable_faults_supported) {
+        uvm_va_space_up_read(va_space);
+        uvm_kvfree(records);
+        return NV_ERR_INVALID_DEVICE;
+    }
+
+    // Copy the ring without synchronizing with the bottom half, then drop
+    // the records it may have overwritten in the meantime
+    replayable_faults = &gpu->parent->fault_buffer_info.replayable;
+    end = UVM_READ_ONCE(replayable_faults->num_batch_records);
+    rmb();
+    memcpy(records, replayable_faults->batch_records, sizeof(*records) * UVM_FAULT_BATCH_RECORDS);
+    rmb();
+    first = UVM_READ_ONCE(replayable_faults->num_batch_records);
+
+    uvm_va_space_up_read(va_space);
+
+    first = (first >= UVM_FAULT_BATCH_RECORDS) ? first - UVM_FAULT_BATCH_RECORDS + 1 : 0;
+
+    for (i = first; i < end; ++i) {
+        uvm_fault_batch_record_t *record = &records[i & (UVM_FAULT_BATCH_RECORDS - 1)];
+        UVM_FAULT_BATCH_RECORD *entry = &params->entries[params->numEntries++];
+
+        entry->timestampNs = record->timestamp_ns;
+        entry->serviceNs = record->service_ns;
+        entry->batchId = record->batch_id;
+        entry->numFaults = record->num_cached_faults;
+        entry->numCoalescedFaults = record->num_coalesced_faults;
+        entry->numDuplicateFaults = record->num_duplicate_faults;
+        entry->numThrottledFaults = record->num_throttled_faults;
+        entry->numInvalidPrefetchFaults = record->num_invalid_prefetch_faults;
+        entry->numReplays = record->num_replays;
+        entry->status = record->status;
+        entry->replayPolicy = record->replay_policy;
+        entry->outcome = record->outcome;
+        entry->flushUpdatePut = record->flush_update_put;
+    }
+
+    uvm_kvfree(records);
+
+    return NV_OK;
+}
+
+NV_STATUS uvm_api_get_fault_buffer_stats(UVM_GET_FAULT_BUFFER_STATS_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_replayable_fault_buffer_info_t *replayable_faults;
+    uvm_gpu_t *gpu;
+
+    uvm_va_space_down_read(va_space);
+
+    gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->gpuUuid);
+    if (!gpu || !gpu->parent->replayable_faults_supported) {
+        uvm_va_space_up_read(va_space);
+        return NV_ERR_INVALID_DEVICE;
+    }
+
+    // The counters are read without synchronizing with the bottom half, so
+    // they may be from different batches
+    replayable_faults = &gpu->parent->fault_buffer_info.replayable;
+    params->bufferEntries = replayable_faults->max_faults;
+    params->maxPendingEntries = UVM_READ_ONCE(replayable_faults->overflow.max_pending_entries);
+    params->numOverflows = UVM_READ_ONCE(replayable_faults->overflow.num_overflows);
+    params->totalDrainNs = UVM_READ_ONCE(replayable_faults->overflow.total_drain_ns);
+    params->maxDrainNs = UVM_READ_ONCE(replayable_faults->overflow.max_drain_ns);
+    params->overflowed = UVM_READ_ONCE(replayable_faults->overflow.start_ns) != 0;
+
+    uvm_va_space_up_read(va_space);
+
+    return NV_OK;
+}
+
 void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
 {
     NvU32 num_replays = 0;
@@ -2650,6 +3377,12 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
 
     // Process all faults in the buffer
     while (1) {
+        NvU32 pending_entries;
+        NvU64 service_start;
+        NvU64 batch_start;
+        NvU64 stage_start;
+        bool flush_update_put = false;
+
         if (num_throttled >= uvm_perf_fault_max_throttle_per_service ||
             num_batches >= uvm_perf_fault_max_batches_per_service) {
             break;
@@ -2660,7 +3393,9 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
         batch_context->num_replays                 = 0;
         batch_context->has_fatal_faults            = false;
         batch_context->has_throttled_faults        = false;
+        batch_context->num_throttled_faults        = 0;
 
+        batch_start = fault_stage_begin();
         status = fetch_fault_buffer_entries(gpu, batch_context, FAULT_FETCH_MODE_BATCH_READY);
         if (status != NV_OK)
             break;
@@ -2668,26 +3403,40 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
         if (batch_context->num_cached_faults == 0)
             break;
 
+        fault_stage_end(gpu->parent, UVM_FAULT_STAGE_FETCH, batch_start);
+
+        pending_entries = fault_buffer_pending_entries(replayable_faults);
+        service_start = NV_GETTIME();
+
         ++batch_context->batch_id;
 
         status = preprocess_fault_batch(gpu, batch_context);
 
         num_replays += batch_context->num_replays;
 
-        if (status == NV_WARN_MORE_PROCESSING_REQUIRED)
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_RESTARTED, service_start, false, status);
             continue;
-        else if (status != NV_OK)
+        }
+        else if (status != NV_OK) {
+            record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_FAILED, service_start, false, status);
             break;
+        }
 
-        status = service_fault_batch(gpu, FAULT_SERVICE_MODE_REGULAR, batch_context);
+        if (can_service_fault_batch_parallel(gpu, batch_context))
+            status = service_fault_batch_parallel(gpu, batch_context);
+        else
+            status = service_fault_batch(gpu, FAULT_SERVICE_MODE_REGULAR, batch_context);
 
         // We may have issued replays even if status != NV_OK if
         // UVM_PERF_FAULT_REPLAY_POLICY_BLOCK is being used or the fault buffer
         // was flushed
         num_replays += batch_context->num_replays;
 
-        if (status == NV_WARN_MORE_PROCESSING_REQUIRED)
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_RESTARTED, service_start, false, status);
             continue;
+        }
 
         enable_disable_prefetch_faults(gpu->parent, batch_context);
 
@@ -2699,6 +3448,7 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
             // the cancel operation since this path is already returning an
             // error code.
             cancel_fault_batch(gpu, batch_context, uvm_tools_status_to_fatal_fault_reason(status));
+            record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_CANCELLED_ALL, service_start, false, status);
             break;
         }
 
@@ -2707,13 +3457,17 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
             if (status == NV_OK)
                 status = cancel_faults_precise(gpu, batch_context);
 
+            record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_CANCELLED, service_start, false, status);
             break;
         }
 
+        stage_start = fault_stage_begin();
         if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BATCH) {
             status = push_replay_on_gpu(gpu, UVM_FAULT_REPLAY_TYPE_START, batch_context);
-            if (status != NV_OK)
+            if (status != NV_OK) {
+                record_fault_batch(gpu->parent, batch_context, UVM_FAULT_BATCH_OUTCOME_FAILED, service_start, false, status);
                 break;
+            }
             ++num_replays;
         }
         else if (replayable_faults->replay_policy == UVM_PERF_FAULT_REPLAY_POLICY_BATCH_FLUSH) {
@@ -2722,20 +3476,40 @@ void uvm_gpu_service_replayable_faults(uvm_gpu_t *gpu)
             if (batch_context->num_duplicate_faults * 100 >
                 batch_context->num_cached_faults * replayable_faults->replay_update_put_ratio) {
                 flush_mode = UVM_GPU_BUFFER_FLUSH_MODE_UPDATE_PUT;
+                flush_update_put = true;
             }
 
             status = fault_buffer_flush_locked(gpu, flush_mode, UVM_FAULT_REPLAY_TYPE_START, batch_context);
-            if (status != NV_OK)
-                break;
-            ++num_replays;
-            status = uvm_tracker_wait(&replayable_faults->replay_tracker);
-            if (status != NV_OK)
+            if (status == NV_OK) {
+                ++num_replays;
+                status = uvm_tracker_wait(&replayable_faults->replay_tracker);
+            }
+            if (status != NV_OK) {
+                record_fault_batch(gpu->parent,
+                                   batch_context,
+                                   UVM_FAULT_BATCH_OUTCOME_FAILED,
+                                   service_start,
+                                   flush_update_put,
+                                   status);
                 break;
+            }
         }
 
+        fault_stage_end(gpu->parent, UVM_FAULT_STAGE_REPLAY, stage_start);
+        fault_stage_end(gpu->parent, UVM_FAULT_STAGE_BATCH, batch_start);
+
         if (batch_context->has_throttled_faults)
             ++num_throttled;
 
+        record_fault_batch(gpu->parent,
+                           batch_context,
+                           UVM_FAULT_BATCH_OUTCOME_REPLAYED,
+                           service_start,
+                           flush_update_put,
+                           NV_OK);
+
+        update_adaptive_batch_control(gpu->parent, batch_context, pending_entries, NV_GETTIME() - service_start);
+
         ++num_batches;
     }
 
@@ -2790,6 +3564,22 @@ const char *uvm_perf_fault_replay_policy_string(uvm_perf_fault_replay_policy_t r
     }
 }
 
+const char *uvm_fault_stage_string(uvm_fault_stage_t stage)
+{
+    BUILD_BUG_ON(UVM_FAULT_STAGE_COUNT != 7);
+
+    switch (stage) {
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_FETCH);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_TRANSLATE);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_SORT);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_BLOCK_SERVICE);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_BLOCK_APPLY);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_REPLAY);
+        UVM_ENUM_STRING_CASE(UVM_FAULT_STAGE_BATCH);
+        UVM_ENUM_STRING_DEFAULT();
+    }
+}
+
 NV_STATUS uvm_test_get_prefetch_faults_reenable_lapse(UVM_TEST_GET_PREFETCH_FAULTS_REENABLE_LAPSE_PARAMS *params,
                                                       struct file *filp)
 {
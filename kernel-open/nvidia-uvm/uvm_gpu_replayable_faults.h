@@ -52,6 +52,73 @@ typedef enum
 
 const char *uvm_perf_fault_replay_policy_string(uvm_perf_fault_replay_policy_t fault_replay);
 
+// Stages of replayable fault servicing whose latency is sampled into per-GPU
+// histograms when uvm_perf_fault_stage_histograms is set
+typedef enum
+{
+    // Reading a batch of entries from the hardware fault buffer
+    UVM_FAULT_STAGE_FETCH = 0,
+
+    // Translating the instance pointers of the batch to VA spaces
+    UVM_FAULT_STAGE_TRANSLATE,
+
+    // Sorting the batch by instance pointer and by VA space/address
+    UVM_FAULT_STAGE_SORT,
+
+    // Servicing the faults of one VA block, with the block lock held
+    UVM_FAULT_STAGE_BLOCK_SERVICE,
+
+    // Applying the new residency and mappings of one VA block. This pushes
+    // the CE copies, PTE writes and TLB invalidates of the block.
+    UVM_FAULT_STAGE_BLOCK_APPLY,
+
+    // Pushing the replay, or flushing the buffer and replaying
+    UVM_FAULT_STAGE_REPLAY,
+
+    // A whole batch, from fetch to replay
+    UVM_FAULT_STAGE_BATCH,
+
+    UVM_FAULT_STAGE_COUNT,
+} uvm_fault_stage_t;
+
+// Bucket i of a stage histogram counts the samples in [2^i, 2^(i+1)) ns. The
+// last bucket also collects everything longer.
+#define UVM_FAULT_STAGE_HISTOGRAM_BUCKETS 32
+
+const char *uvm_fault_stage_string(uvm_fault_stage_t stage);
+
+// Summary of one replayable fault batch, kept in the per-GPU flight recorder
+// of the last UVM_FAULT_BATCH_RECORDS batches. Recording is always on.
+typedef struct
+{
+    // Time the batch finished, and time spent servicing it after the fetch
+    NvU64 timestamp_ns;
+    NvU64 service_ns;
+
+    NvU32 batch_id;
+
+    NvU32 num_cached_faults;
+    NvU32 num_coalesced_faults;
+    NvU32 num_duplicate_faults;
+    NvU32 num_throttled_faults;
+    NvU32 num_invalid_prefetch_faults;
+    NvU32 num_replays;
+
+    NV_STATUS status;
+
+    // uvm_perf_fault_replay_policy_t in effect for the batch
+    NvU8 replay_policy;
+
+    // UVM_FAULT_BATCH_OUTCOME_* from uvm_ioctl.h
+    NvU8 outcome;
+
+    // Whether a BATCH_FLUSH replay updated PUT before flushing
+    bool flush_update_put;
+} uvm_fault_batch_record_t;
+
+// Must be a power of 2
+#define UVM_FAULT_BATCH_RECORDS 64
+
 NV_STATUS uvm_gpu_fault_buffer_init(uvm_parent_gpu_t *parent_gpu);
 void uvm_gpu_fault_buffer_deinit(uvm_parent_gpu_t *parent_gpu);
 
@@ -135,6 +135,11 @@ static bool is_canary(NvU32 val)
     return (val & ~UVM_SEMAPHORE_CANARY_MASK) == UVM_SEMAPHORE_CANARY_BASE;
 }
 
+static NvU32 semaphore_slot_count(uvm_gpu_semaphore_t *semaphore)
+{
+    return semaphore->payload_64bit ? 2 : 1;
+}
+
 static bool semaphore_uses_canary(uvm_gpu_semaphore_pool_t *pool)
 {
     // A pool allocated in the CPR of vidmem cannot be read/written from the
@@ -229,6 +234,31 @@ error:
     return status;
 }
 
+// Find slot_count free consecutive semaphore slots in the page, starting at a
+// multiple of slot_count. Returns UVM_SEMAPHORE_COUNT_PER_PAGE if there are
+// none.
+static NvU32 page_find_free_slots(uvm_gpu_semaphore_pool_page_t *page, NvU32 slot_count)
+{
+    NvU32 index;
+
+    for_each_set_bit(index, page->free_semaphores, UVM_SEMAPHORE_COUNT_PER_PAGE) {
+        NvU32 i;
+
+        if (index % slot_count != 0)
+            continue;
+
+        for (i = 1; i < slot_count; i++) {
+            if (!test_bit(index + i, page->free_semaphores))
+                break;
+        }
+
+        if (i == slot_count)
+            return index;
+    }
+
+    return UVM_SEMAPHORE_COUNT_PER_PAGE;
+}
+
 static void pool_free_page(uvm_gpu_semaphore_pool_page_t *page)
 {
     uvm_gpu_semaphore_pool_t *pool;
@@ -257,49 +287,99 @@ static void pool_free_page(uvm_gpu_semaphore_pool_page_t *page)
     uvm_kvfree(page);
 }
 
-NV_STATUS uvm_gpu_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_semaphore_t *semaphore)
+static NvU64 semaphore_get_payload_64(uvm_gpu_semaphore_t *semaphore)
+{
+    UVM_ASSERT(semaphore->payload_64bit);
+
+    return UVM_GPU_READ_ONCE(*(NvU64 *)semaphore->payload);
+}
+
+static void semaphore_set_payload_64(uvm_gpu_semaphore_t *semaphore, NvU64 payload)
+{
+    UVM_ASSERT(semaphore->payload_64bit);
+
+    // Same ordering as uvm_gpu_semaphore_set_payload()
+    mb();
+
+    UVM_GPU_WRITE_ONCE(*(NvU64 *)semaphore->payload, payload);
+}
+
+static uvm_gpu_semaphore_pool_page_t *pool_find_free_slots(uvm_gpu_semaphore_pool_t *pool,
+                                                           NvU32 slot_count,
+                                                           NvU32 *semaphore_index)
+{
+    uvm_gpu_semaphore_pool_page_t *page;
+
+    uvm_assert_mutex_locked(&pool->mutex);
+
+    if (pool->free_semaphores_count < slot_count)
+        return NULL;
+
+    list_for_each_entry(page, &pool->pages, all_pages_node) {
+        *semaphore_index = page_find_free_slots(page, slot_count);
+        if (*semaphore_index != UVM_SEMAPHORE_COUNT_PER_PAGE)
+            return page;
+    }
+
+    return NULL;
+}
+
+static NV_STATUS semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_semaphore_t *semaphore, bool payload_64bit)
 {
     NV_STATUS status = NV_OK;
     uvm_gpu_semaphore_pool_page_t *page;
+    NvU32 slot_count = payload_64bit ? 2 : 1;
+    NvU32 semaphore_index;
+    NvU32 i;
 
     memset(semaphore, 0, sizeof(*semaphore));
 
+    // Secure semaphores are only accessed through their cached payload
+    UVM_ASSERT(!payload_64bit || !gpu_semaphore_pool_is_secure(pool));
+
     uvm_mutex_lock(&pool->mutex);
 
-    if (pool->free_semaphores_count == 0)
+    // The free slots can also be too fragmented for a 64-bit semaphore, but a
+    // new page always has room.
+    page = pool_find_free_slots(pool, slot_count, &semaphore_index);
+    if (!page) {
         status = pool_alloc_page(pool);
+        if (status != NV_OK)
+            goto done;
 
-    if (status != NV_OK)
-        goto done;
-
-    list_for_each_entry(page, &pool->pages, all_pages_node) {
-        NvU32 semaphore_index = find_first_bit(page->free_semaphores, UVM_SEMAPHORE_COUNT_PER_PAGE);
-        if (semaphore_index == UVM_SEMAPHORE_COUNT_PER_PAGE)
-            continue;
-
-        if (gpu_semaphore_pool_is_secure(pool)) {
-            semaphore->conf_computing.index = semaphore_index;
-        }
-        else {
-            semaphore->payload = (NvU32*)((char*)uvm_rm_mem_get_cpu_va(page->memory) +
-                                                 semaphore_index * UVM_SEMAPHORE_SIZE);
+        page = pool_find_free_slots(pool, slot_count, &semaphore_index);
+        if (!page) {
+            UVM_ASSERT_MSG(0, "Failed to find a semaphore after allocating a new page\n");
+            status = NV_ERR_GENERIC;
+            goto done;
         }
+    }
+
+    if (gpu_semaphore_pool_is_secure(pool)) {
+        semaphore->conf_computing.index = semaphore_index;
+    }
+    else {
+        semaphore->payload = (NvU32*)((char*)uvm_rm_mem_get_cpu_va(page->memory) +
+                                             semaphore_index * UVM_SEMAPHORE_SIZE);
+    }
 
-        semaphore->page = page;
+    semaphore->page = page;
+    semaphore->payload_64bit = payload_64bit;
 
-        if (semaphore_uses_canary(pool))
-            UVM_ASSERT(is_canary(uvm_gpu_semaphore_get_payload(semaphore)));
+    if (semaphore_uses_canary(pool)) {
+        for (i = 0; i < slot_count; i++)
+            UVM_ASSERT(is_canary(UVM_GPU_READ_ONCE(semaphore->payload[i])));
+    }
 
+    if (payload_64bit)
+        semaphore_set_payload_64(semaphore, 0);
+    else
         uvm_gpu_semaphore_set_payload(semaphore, 0);
 
-        __clear_bit(semaphore_index, page->free_semaphores);
-        --pool->free_semaphores_count;
+    for (i = 0; i < slot_count; i++)
+        __clear_bit(semaphore_index + i, page->free_semaphores);
 
-        goto done;
-    }
-
-    UVM_ASSERT_MSG(0, "Failed to find a semaphore after allocating a new page\n");
-    status = NV_ERR_GENERIC;
+    pool->free_semaphores_count -= slot_count;
 
 done:
     uvm_mutex_unlock(&pool->mutex);
@@ -307,11 +387,18 @@ done:
     return status;
 }
 
+NV_STATUS uvm_gpu_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_semaphore_t *semaphore)
+{
+    return semaphore_alloc(pool, semaphore, false);
+}
+
 void uvm_gpu_semaphore_free(uvm_gpu_semaphore_t *semaphore)
 {
     uvm_gpu_semaphore_pool_page_t *page;
     uvm_gpu_semaphore_pool_t *pool;
     NvU32 index;
+    NvU32 slot_count;
+    NvU32 i;
 
     UVM_ASSERT(semaphore);
 
@@ -324,19 +411,30 @@ void uvm_gpu_semaphore_free(uvm_gpu_semaphore_t *semaphore)
 
     pool = page->pool;
     index = get_index(semaphore);
+    slot_count = semaphore_slot_count(semaphore);
 
     // Write a known value lower than the current payload in an attempt to catch
     // release-after-free and acquire-after-free.
-    if (semaphore_uses_canary(pool))
-        uvm_gpu_semaphore_set_payload(semaphore, make_canary(uvm_gpu_semaphore_get_payload(semaphore)));
+    if (semaphore_uses_canary(pool)) {
+        if (semaphore->payload_64bit) {
+            NvU64 payload = semaphore_get_payload_64(semaphore);
+            NvU64 canary = ((NvU64)make_canary(NvU64_HI32(payload)) << 32) | make_canary(NvU64_LO32(payload));
+
+            semaphore_set_payload_64(semaphore, canary);
+        }
+        else {
+            uvm_gpu_semaphore_set_payload(semaphore, make_canary(uvm_gpu_semaphore_get_payload(semaphore)));
+        }
+    }
 
     uvm_mutex_lock(&pool->mutex);
 
     semaphore->page = NULL;
     semaphore->payload = NULL;
 
-    ++pool->free_semaphores_count;
-    __set_bit(index, page->free_semaphores);
+    pool->free_semaphores_count += slot_count;
+    for (i = 0; i < slot_count; i++)
+        __set_bit(index + i, page->free_semaphores);
 
     uvm_mutex_unlock(&pool->mutex);
 }
@@ -463,6 +561,16 @@ NvU32 uvm_gpu_semaphore_get_payload(uvm_gpu_semaphore_t *semaphore)
     return UVM_GPU_READ_ONCE(*semaphore->payload);
 }
 
+const volatile NvU32 *uvm_gpu_semaphore_get_monitor_address(uvm_gpu_semaphore_t *semaphore)
+{
+    // Secure semaphores are read from a decrypted copy, and vidmem payloads
+    // are mapped uncached, so GPU releases don't end a monitored wait there.
+    if (gpu_semaphore_is_secure(semaphore) || semaphore->page->pool->aperture != UVM_APERTURE_SYS)
+        return NULL;
+
+    return semaphore->payload;
+}
+
 void uvm_gpu_semaphore_set_payload(uvm_gpu_semaphore_t *semaphore, NvU32 payload)
 {
     // Provide a guarantee that all memory accesses prior to setting the payload
@@ -519,14 +627,16 @@ bool tracking_semaphore_uses_mutex(uvm_gpu_tracking_semaphore_t *tracking_semaph
 }
 
 
-NV_STATUS uvm_gpu_tracking_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_tracking_semaphore_t *tracking_sem)
+static NV_STATUS tracking_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool,
+                                          uvm_gpu_tracking_semaphore_t *tracking_sem,
+                                          bool payload_64bit)
 {
     NV_STATUS status;
     uvm_lock_order_t order = UVM_LOCK_ORDER_LEAF;
 
     memset(tracking_sem, 0, sizeof(*tracking_sem));
 
-    status = uvm_gpu_semaphore_alloc(pool, &tracking_sem->semaphore);
+    status = semaphore_alloc(pool, &tracking_sem->semaphore, payload_64bit);
     if (status != NV_OK)
         return status;
 
@@ -546,6 +656,16 @@ NV_STATUS uvm_gpu_tracking_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_g
     return NV_OK;
 }
 
+NV_STATUS uvm_gpu_tracking_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_tracking_semaphore_t *tracking_sem)
+{
+    return tracking_semaphore_alloc(pool, tracking_sem, false);
+}
+
+NV_STATUS uvm_gpu_tracking_semaphore_alloc_64(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_tracking_semaphore_t *tracking_sem)
+{
+    return tracking_semaphore_alloc(pool, tracking_sem, true);
+}
+
 void uvm_gpu_tracking_semaphore_free(uvm_gpu_tracking_semaphore_t *tracking_sem)
 {
     uvm_gpu_semaphore_free(&tracking_sem->semaphore);
@@ -739,6 +859,45 @@ static NvU64 update_completed_value_locked(uvm_gpu_tracking_semaphore_t *trackin
     return new_value;
 }
 
+// With a 64-bit payload the GPU releases the full value, so there is no wrap
+// around to notice and the update doesn't need the lock: the payload is loaded
+// once and completed_value is raised to it if lower.
+static NvU64 update_completed_value_64(uvm_gpu_tracking_semaphore_t *tracking_semaphore)
+{
+    NvU64 old_value = atomic64_read(&tracking_semaphore->completed_value);
+    NvU64 new_value;
+
+    UVM_ASSERT(!uvm_global_is_suspended());
+
+    // The acquire orders all later accesses by this thread after the GPU
+    // semaphore read, like the smp_mb__after_atomic() in
+    // update_completed_value_locked().
+    new_value = smp_load_acquire((NvU64 *)tracking_semaphore->semaphore.payload);
+
+    if (new_value <= old_value)
+        return old_value;
+
+    UVM_ASSERT_MSG_RELEASE(new_value - old_value <= UVM_GPU_SEMAPHORE_MAX_JUMP,
+                           "GPU %s unexpected semaphore (CPU VA 0x%llx) jump from 0x%llx to 0x%llx\n",
+                           tracking_semaphore->semaphore.page->pool->gpu->parent->name,
+                           (NvU64)(uintptr_t)tracking_semaphore->semaphore.payload,
+                           old_value, new_value);
+
+    // Concurrent updaters can race, only ever move completed_value forward.
+    // The cmpxchg is a full barrier, so threads seeing the new completed_value
+    // also see everything this thread observed before the payload read.
+    while (old_value < new_value) {
+        NvU64 prev_value = atomic64_cmpxchg(&tracking_semaphore->completed_value, old_value, new_value);
+
+        if (prev_value == old_value)
+            break;
+
+        old_value = prev_value;
+    }
+
+    return max(old_value, new_value);
+}
+
 NvU64 uvm_gpu_tracking_semaphore_update_completed_value(uvm_gpu_tracking_semaphore_t *tracking_semaphore)
 {
     NvU64 completed;
@@ -746,6 +905,9 @@ NvU64 uvm_gpu_tracking_semaphore_update_completed_value(uvm_gpu_tracking_semapho
     // Check that the GPU which owns the semaphore is still present
     UVM_ASSERT(tracking_semaphore_check_gpu(tracking_semaphore));
 
+    if (tracking_semaphore->semaphore.payload_64bit)
+        return update_completed_value_64(tracking_semaphore);
+
     if (tracking_semaphore_uses_mutex(tracking_semaphore))
         uvm_mutex_lock(&tracking_semaphore->m_lock);
     else
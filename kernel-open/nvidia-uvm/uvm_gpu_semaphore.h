@@ -47,6 +47,13 @@ struct uvm_gpu_semaphore_struct
 
     // Pointer to the memory location
     NvU32 *payload;
+
+    // The semaphore occupies two consecutive 4-byte slots of its page,
+    // starting 8-byte aligned, and payload points to a 64-bit value. The
+    // bottom 32 bits are still at payload, so 32-bit acquires and
+    // uvm_gpu_semaphore_get_payload() keep working on it.
+    bool payload_64bit;
+
     struct {
         NvU16 index;
         NvU32 cached_payload;
@@ -67,6 +74,10 @@ struct uvm_gpu_semaphore_struct
 // to support 2^64 synchronization points instead of just 2^32. The logic relies
 // on being able to notice every time the 32-bit counter wraps around (see
 // update_completed_value()).
+//
+// If the semaphore has a 64-bit payload, released by the GPU as a whole, the
+// counter is simply the payload and updating the completed value doesn't take
+// the lock.
 struct uvm_gpu_tracking_semaphore_struct
 {
     uvm_gpu_semaphore_t semaphore;
@@ -157,6 +168,11 @@ NvU64 uvm_gpu_semaphore_get_gpu_va(uvm_gpu_semaphore_t *semaphore, uvm_gpu_t *gp
 // uvm_gpu_tracking_semaphore_update_completed_value().
 NvU32 uvm_gpu_semaphore_get_payload(uvm_gpu_semaphore_t *semaphore);
 
+// Get the CPU address a waiter can monitor for GPU releases of the semaphore,
+// see uvm_spin_loop_wait_on(). Returns NULL if the payload isn't released to
+// CPU cacheable memory.
+const volatile NvU32 *uvm_gpu_semaphore_get_monitor_address(uvm_gpu_semaphore_t *semaphore);
+
 // Set the 32-bit payload of the semaphore
 // Guarantees that all memory accesses preceding setting the payload won't be
 // moved past it.
@@ -166,6 +182,12 @@ void uvm_gpu_semaphore_set_payload(uvm_gpu_semaphore_t *semaphore, NvU32 payload
 // Locking same as uvm_gpu_semaphore_alloc()
 NV_STATUS uvm_gpu_tracking_semaphore_alloc(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_tracking_semaphore_t *tracking_sem);
 
+// Allocate a GPU tracking semaphore with a 64-bit payload from the pool. The
+// user of the tracking semaphore must release the full 64-bit queued values,
+// see uvm_hal_semaphore_release_64_t. Not supported on secure pools.
+// Locking same as uvm_gpu_semaphore_alloc()
+NV_STATUS uvm_gpu_tracking_semaphore_alloc_64(uvm_gpu_semaphore_pool_t *pool, uvm_gpu_tracking_semaphore_t *tracking_sem);
+
 // Free a GPU tracking semaphore
 // Locking same as uvm_gpu_semaphore_free()
 void uvm_gpu_tracking_semaphore_free(uvm_gpu_tracking_semaphore_t *tracking_sem);
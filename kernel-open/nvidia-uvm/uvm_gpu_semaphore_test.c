@@ -147,6 +147,70 @@ done:
     return status;
 }
 
+static NV_STATUS set_and_test_64(uvm_gpu_tracking_semaphore_t *tracking_sem, NvU64 new_value)
+{
+    mb();
+    UVM_WRITE_ONCE(*(NvU64 *)tracking_sem->semaphore.payload, new_value);
+    tracking_sem->queued_value = new_value;
+
+    TEST_CHECK_RET(uvm_gpu_semaphore_get_payload(&tracking_sem->semaphore) == (NvU32)new_value);
+    TEST_CHECK_RET(uvm_gpu_tracking_semaphore_update_completed_value(tracking_sem) == new_value);
+    TEST_CHECK_RET(uvm_gpu_tracking_semaphore_is_value_completed(tracking_sem, new_value - 1));
+    TEST_CHECK_RET(!uvm_gpu_tracking_semaphore_is_value_completed(tracking_sem, new_value + 1));
+    TEST_CHECK_RET(uvm_gpu_tracking_semaphore_is_completed(tracking_sem));
+
+    return NV_OK;
+}
+
+static NV_STATUS test_tracking_64(uvm_va_space_t *va_space)
+{
+    NV_STATUS status;
+    uvm_gpu_tracking_semaphore_t tracking_sem;
+    NvU64 completed;
+    int i;
+    uvm_gpu_t *gpu = uvm_va_space_find_first_gpu(va_space);
+
+    if (gpu == NULL)
+        return NV_ERR_INVALID_STATE;
+
+    status = uvm_gpu_tracking_semaphore_alloc_64(gpu->semaphore_pool, &tracking_sem);
+    if (status != NV_OK)
+        return status;
+
+    TEST_CHECK_GOTO(IS_ALIGNED((uintptr_t)tracking_sem.semaphore.payload, sizeof(NvU64)), done);
+    TEST_CHECK_GOTO(uvm_gpu_tracking_semaphore_update_completed_value(&tracking_sem) == 0, done);
+
+    for (i = 0; i < 100; ++i) {
+        completed = uvm_gpu_tracking_semaphore_update_completed_value(&tracking_sem);
+        status = set_and_test_64(&tracking_sem, completed + UVM_GPU_SEMAPHORE_MAX_JUMP - i);
+        if (status != NV_OK)
+            goto done;
+    }
+
+    // Crossing 2^32 boundaries needs no wrap detection
+    for (i = 0; i < 100; ++i) {
+        NvU64 starting_value = (1ULL<<32) * (i + 1) - i - 1;
+
+        mb();
+        UVM_WRITE_ONCE(*(NvU64 *)tracking_sem.semaphore.payload, starting_value);
+        atomic64_set(&tracking_sem.completed_value, starting_value);
+
+        status = set_and_test_64(&tracking_sem, (1ULL<<32) * (i + 1) + i);
+        if (status != NV_OK)
+            goto done;
+    }
+
+    // A lower payload never moves the completed value back
+    completed = uvm_gpu_tracking_semaphore_update_completed_value(&tracking_sem);
+    UVM_WRITE_ONCE(*(NvU64 *)tracking_sem.semaphore.payload, completed - 1);
+    TEST_CHECK_GOTO(uvm_gpu_tracking_semaphore_update_completed_value(&tracking_sem) == completed, done);
+    UVM_WRITE_ONCE(*(NvU64 *)tracking_sem.semaphore.payload, completed);
+
+done:
+    uvm_gpu_tracking_semaphore_free(&tracking_sem);
+    return status;
+}
+
 #define NUM_SEMAPHORES_PER_GPU 4096
 
 static NV_STATUS test_alloc(uvm_va_space_t *va_space)
@@ -221,6 +285,10 @@ NV_STATUS uvm_test_gpu_semaphore_sanity(UVM_TEST_GPU_SEMAPHORE_SANITY_PARAMS *pa
     if (status != NV_OK)
         goto done;
 
+    status = test_tracking_64(va_space);
+    if (status != NV_OK)
+        goto done;
+
 done:
     uvm_va_space_up_read_rm(va_space);
     uvm_mutex_unlock(&g_uvm_global.global_lock);
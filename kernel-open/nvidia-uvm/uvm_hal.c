@@ -68,6 +68,7 @@ static uvm_hal_class_ops_t ce_table[] =
             .init = uvm_hal_maxwell_ce_init,
             .method_is_valid = uvm_hal_method_is_valid_stub,
             .semaphore_release = uvm_hal_maxwell_ce_semaphore_release,
+            .semaphore_release_64 = uvm_hal_maxwell_ce_semaphore_release_64_unsupported,
             .semaphore_timestamp = uvm_hal_maxwell_ce_semaphore_timestamp,
             .semaphore_reduction_inc = uvm_hal_maxwell_ce_semaphore_reduction_inc,
             .offset_out = uvm_hal_maxwell_ce_offset_out,
@@ -149,6 +150,7 @@ static uvm_hal_class_ops_t ce_table[] =
         .parent_id = AMPERE_DMA_COPY_B,
         .u.ce_ops = {
             .semaphore_release = uvm_hal_hopper_ce_semaphore_release,
+            .semaphore_release_64 = uvm_hal_hopper_ce_semaphore_release_64,
             .semaphore_timestamp = uvm_hal_hopper_ce_semaphore_timestamp,
             .semaphore_reduction_inc = uvm_hal_hopper_ce_semaphore_reduction_inc,
             .offset_out = uvm_hal_hopper_ce_offset_out,
@@ -217,6 +217,15 @@ void uvm_hal_hopper_sec2_semaphore_release(uvm_push_t *push, NvU64 gpu_va, NvU32
 void uvm_hal_hopper_ce_semaphore_release(uvm_push_t *push, NvU64 gpu_va, NvU32 payload);
 void uvm_hal_hopper_host_semaphore_release(uvm_push_t *push, NvU64 gpu_va, NvU32 payload);
 
+// Release a 64-bit semaphore at the specific GPU VA with a single 8-byte
+// write. The VA needs to be 8-byte aligned. Only supported by the CE if
+// parent_gpu->ce_semaphore_release_64_supported is set.
+//
+// Membar behavior is the same as uvm_hal_semaphore_release_t.
+typedef void (*uvm_hal_semaphore_release_64_t)(uvm_push_t *push, NvU64 gpu_va, NvU64 payload);
+void uvm_hal_maxwell_ce_semaphore_release_64_unsupported(uvm_push_t *push, NvU64 gpu_va, NvU64 payload);
+void uvm_hal_hopper_ce_semaphore_release_64(uvm_push_t *push, NvU64 gpu_va, NvU64 payload);
+
 // Release a semaphore including a timestamp at the specific GPU VA.
 //
 // This operation writes 16 bytes of memory and the VA needs to be 16-byte
@@ -739,6 +748,7 @@ struct uvm_ce_hal_struct
     uvm_hal_init_t init;
     uvm_hal_ce_method_is_valid method_is_valid;
     uvm_hal_semaphore_release_t semaphore_release;
+    uvm_hal_semaphore_release_64_t semaphore_release_64;
     uvm_hal_semaphore_timestamp_t semaphore_timestamp;
     uvm_hal_ce_offset_out_t offset_out;
     uvm_hal_ce_offset_in_out_t offset_in_out;
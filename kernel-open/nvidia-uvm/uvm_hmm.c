@@ -1264,7 +1264,7 @@ void uvm_hmm_block_add_eviction_mappings(uvm_va_space_t *va_space,
                                                    block_context,
                                                    id,
                                                    region,
-                                                   &gpu_state->evicted,
+                                                   gpu_state->evicted,
                                                    UvmEventMapRemoteCauseEviction);
                 tracker_status = uvm_tracker_add_tracker_safe(&local_tracker, &va_block->tracker);
                 status = (status == NV_OK) ? tracker_status : status;
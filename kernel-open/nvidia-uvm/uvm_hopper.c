@@ -66,6 +66,7 @@ void uvm_hal_hopper_arch_init_properties(uvm_parent_gpu_t *parent_gpu)
     //                    some time and then failed even after reboot
     parent_gpu->peer_copy_mode = uvm_gpu_is_coherent(parent_gpu) ?
                                                            UVM_GPU_PEER_COPY_MODE_VIRTUAL : g_uvm_global.peer_copy_mode;
+    parent_gpu->peer_copy_auto = !uvm_gpu_is_coherent(parent_gpu) && g_uvm_global.peer_copy_auto;
 
     // All GR context buffers may be mapped to 57b wide VAs. All "compute" units
     // accessing GR context buffers support the 57-bit VA range.
@@ -103,5 +104,7 @@ void uvm_hal_hopper_arch_init_properties(uvm_parent_gpu_t *parent_gpu)
     parent_gpu->map_remap_larger_page_promotion = false;
 
     parent_gpu->plc_supported = true;
+
+    parent_gpu->ce_semaphore_release_64_supported = true;
 }
 
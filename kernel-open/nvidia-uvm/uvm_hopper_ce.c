@@ -103,6 +103,27 @@ void uvm_hal_hopper_ce_semaphore_release(uvm_push_t *push, NvU64 gpu_va, NvU32 p
        launch_dma_plc_mode);
 }
 
+void uvm_hal_hopper_ce_semaphore_release_64(uvm_push_t *push, NvU64 gpu_va, NvU64 payload)
+{
+    uvm_gpu_t *gpu = uvm_push_get_gpu(push);
+    NvU32 launch_dma_plc_mode;
+
+    UVM_ASSERT(IS_ALIGNED(gpu_va, sizeof(payload)));
+
+    NV_PUSH_4U(C8B5, SET_SEMAPHORE_A, HWVALUE(C8B5, SET_SEMAPHORE_A, UPPER, NvOffset_HI32(gpu_va)),
+                     SET_SEMAPHORE_B, HWVALUE(C8B5, SET_SEMAPHORE_B, LOWER, NvOffset_LO32(gpu_va)),
+                     SET_SEMAPHORE_PAYLOAD, NvU64_LO32(payload),
+                     SET_SEMAPHORE_PAYLOAD_UPPER, NvU64_HI32(payload));
+
+    launch_dma_plc_mode = gpu->parent->ce_hal->plc_mode();
+
+    NV_PUSH_1U(C8B5, LAUNCH_DMA, hopper_get_flush_value(push) |
+       HWCONST(C8B5, LAUNCH_DMA, DATA_TRANSFER_TYPE, NONE) |
+       HWCONST(C8B5, LAUNCH_DMA, SEMAPHORE_PAYLOAD_SIZE, TWO_WORD) |
+       HWCONST(C8B5, LAUNCH_DMA, SEMAPHORE_TYPE, RELEASE_SEMAPHORE_NO_TIMESTAMP) |
+       launch_dma_plc_mode);
+}
+
 void uvm_hal_hopper_ce_semaphore_reduction_inc(uvm_push_t *push, NvU64 gpu_va, NvU32 payload)
 {
     uvm_gpu_t *gpu = uvm_push_get_gpu(push);
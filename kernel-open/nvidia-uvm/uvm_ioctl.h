@@ -1083,6 +1083,301 @@ typedef struct
     NV_STATUS               rmStatus; // OUT
 } UVM_MM_INITIALIZE_PARAMS;
 
+//
+// Set or query the value of a performance heuristics tunable (UvmPerfTunable)
+// for the calling VA space. Values outside of the valid range of the tunable,
+// and tunables whose heuristic is disabled for the whole module, are rejected
+// with NV_ERR_INVALID_ARGUMENT and NV_ERR_NOT_SUPPORTED respectively.
+//
+#define UVM_SET_PERF_TUNABLE                                          UVM_IOCTL_BASE(76)
+typedef struct
+{
+    NvU32                   tunable;                                 // IN
+    NvU64                   value            NV_ALIGN_BYTES(8);      // IN
+    NV_STATUS               rmStatus;                                // OUT
+} UVM_SET_PERF_TUNABLE_PARAMS;
+
+#define UVM_GET_PERF_TUNABLE                                          UVM_IOCTL_BASE(77)
+typedef struct
+{
+    NvU32                   tunable;                                 // IN
+    NvU64                   value            NV_ALIGN_BYTES(8);      // OUT
+    NV_STATUS               rmStatus;                                // OUT
+} UVM_GET_PERF_TUNABLE_PARAMS;
+
+//
+// Migrate a batch of VA ranges with a single ioctl. Each entry behaves like
+// the base/length/destinationUuid/cpuNumaNode arguments of UVM_MIGRATE, and
+// flags, semaphoreAddress and semaphorePayload apply to the whole batch: the
+// VA space is locked once, the copies of all entries are in flight together,
+// and the semaphore is released once after all of them.
+//
+// Entries with the same destination that are adjacent or overlap are
+// coalesced. Only managed memory is supported, so cpuNumaNode is currently
+// unused and reserved for pageable destinations. On failure, failedEntryIndex
+// is the index of the first entry of the range that failed; migrations of
+// other ranges may have completed.
+//
+#define UVM_MIGRATE_BATCH_MAX_ENTRIES                                 64
+
+typedef struct
+{
+    NvU64           base               NV_ALIGN_BYTES(8); // IN
+    NvU64           length             NV_ALIGN_BYTES(8); // IN
+    NvProcessorUuid destinationUuid;                      // IN
+    NvU32           cpuNumaNode;                          // IN
+} UVM_MIGRATE_BATCH_ENTRY;
+
+#define UVM_MIGRATE_BATCH                                             UVM_IOCTL_BASE(78)
+typedef struct
+{
+    UVM_MIGRATE_BATCH_ENTRY entries[UVM_MIGRATE_BATCH_MAX_ENTRIES];     // IN
+    NvU32                   numEntries;                                 // IN
+    NvU32                   flags;                                      // IN
+    NvU64                   semaphoreAddress NV_ALIGN_BYTES(8);         // IN
+    NvU32                   semaphorePayload;                           // IN
+    NvU32                   failedEntryIndex;                           // OUT
+    NV_STATUS               rmStatus;                                   // OUT
+} UVM_MIGRATE_BATCH_PARAMS;
+
+//
+// Read the access counter heat of the VA space in [base, base + length). The
+// heat of a 2MB region is the sum of the access counter notification counts
+// of each GPU on the region, halved every
+// uvm_perf_access_counter_heat_half_life_ms. Regions are reported in
+// ascending order with one entry per GPU with non-zero heat.
+//
+// If the entries of all the regions do not fit, nextBase is the base of the
+// first region that was not reported, and base + length otherwise. The table
+// only tracks a bounded number of regions, evicting the coldest ones.
+//
+// Returns NV_ERR_NOT_SUPPORTED unless the uvm_perf_access_counter_heat module
+// parameter is set.
+//
+#define UVM_ACCESS_COUNTER_HEAT_MAX_ENTRIES                           64
+
+typedef struct
+{
+    NvU64           regionBase         NV_ALIGN_BYTES(8); // OUT
+    NvProcessorUuid processorUuid;                        // OUT
+    NvU32           heat;                                 // OUT
+} UVM_ACCESS_COUNTER_HEAT_ENTRY;
+
+#define UVM_GET_ACCESS_COUNTER_HEAT                                   UVM_IOCTL_BASE(79)
+typedef struct
+{
+    NvU64                         base      NV_ALIGN_BYTES(8);                 // IN
+    NvU64                         length    NV_ALIGN_BYTES(8);                 // IN
+    UVM_ACCESS_COUNTER_HEAT_ENTRY entries[UVM_ACCESS_COUNTER_HEAT_MAX_ENTRIES]; // OUT
+    NvU32                         numEntries;                                  // OUT
+    NvU64                         nextBase  NV_ALIGN_BYTES(8);                 // OUT
+    NV_STATUS                     rmStatus;                                    // OUT
+} UVM_GET_ACCESS_COUNTER_HEAT_PARAMS;
+
+//
+// Read the number of bytes and copies migrated between each pair of
+// processors registered in the VA space, along with the type of the link
+// between them. Only pairs with at least one copy are reported. The counters
+// are global to the driver and are never reset.
+//
+#define UVM_TOOLS_LINK_TYPE_NONE                                      0
+#define UVM_TOOLS_LINK_TYPE_PCIE                                      1
+#define UVM_TOOLS_LINK_TYPE_NVLINK_1                                  2
+#define UVM_TOOLS_LINK_TYPE_NVLINK_2                                  3
+#define UVM_TOOLS_LINK_TYPE_NVLINK_3                                  4
+#define UVM_TOOLS_LINK_TYPE_NVLINK_4                                  5
+#define UVM_TOOLS_LINK_TYPE_C2C                                       6
+
+#define UVM_TOOLS_MIGRATION_COUNTERS_MAX_ENTRIES                      64
+
+typedef struct
+{
+    NvProcessorUuid srcUuid;                        // OUT
+    NvProcessorUuid dstUuid;                        // OUT
+    NvU32           linkType;                       // OUT
+    NvU64           bytes         NV_ALIGN_BYTES(8); // OUT
+    NvU64           copies        NV_ALIGN_BYTES(8); // OUT
+} UVM_TOOLS_MIGRATION_COUNTER_ENTRY;
+
+#define UVM_TOOLS_GET_MIGRATION_COUNTERS                              UVM_IOCTL_BASE(80)
+typedef struct
+{
+    UVM_TOOLS_MIGRATION_COUNTER_ENTRY entries[UVM_TOOLS_MIGRATION_COUNTERS_MAX_ENTRIES]; // OUT
+    NvU32                             numEntries;                                       // OUT
+    NV_STATUS                         rmStatus;                                         // OUT
+} UVM_TOOLS_GET_MIGRATION_COUNTERS_PARAMS;
+
+//
+// Read the summaries of the last replayable fault batches serviced on the
+// given GPU, oldest first. The driver always records the last
+// UVM_FAULT_BATCH_RECORDS_MAX_ENTRIES batches of each GPU, and returns all but
+// the oldest one, whose slot may be getting overwritten. numCoalescedFaults
+// counts the faults left once duplicates of the same page are merged, and
+// replayPolicy is the uvm_perf_fault_replay_policy value in effect.
+//
+// Returns NV_ERR_INVALID_DEVICE if the GPU is not registered in the VA space
+// or does not support replayable faults.
+//
+#define UVM_FAULT_BATCH_OUTCOME_REPLAYED                              0
+#define UVM_FAULT_BATCH_OUTCOME_RESTARTED                             1
+#define UVM_FAULT_BATCH_OUTCOME_CANCELLED                             2
+#define UVM_FAULT_BATCH_OUTCOME_CANCELLED_ALL                         3
+#define UVM_FAULT_BATCH_OUTCOME_FAILED                                4
+
+#define UVM_FAULT_BATCH_RECORDS_MAX_ENTRIES                           64
+
+typedef struct
+{
+    NvU64     timestampNs        NV_ALIGN_BYTES(8); // OUT
+    NvU64     serviceNs          NV_ALIGN_BYTES(8); // OUT
+    NvU32     batchId;                              // OUT
+    NvU32     numFaults;                            // OUT
+    NvU32     numCoalescedFaults;                   // OUT
+    NvU32     numDuplicateFaults;                   // OUT
+    NvU32     numThrottledFaults;                   // OUT
+    NvU32     numInvalidPrefetchFaults;             // OUT
+    NvU32     numReplays;                           // OUT
+    NV_STATUS status;                               // OUT
+    NvU32     replayPolicy;                         // OUT
+    NvU32     outcome;                              // OUT
+    NvBool    flushUpdatePut;                       // OUT
+} UVM_FAULT_BATCH_RECORD;
+
+#define UVM_GET_FAULT_BATCH_RECORDS                                   UVM_IOCTL_BASE(81)
+typedef struct
+{
+    NvProcessorUuid        gpuUuid;                                       // IN
+    UVM_FAULT_BATCH_RECORD entries[UVM_FAULT_BATCH_RECORDS_MAX_ENTRIES]; // OUT
+    NvU32                  numEntries;                                    // OUT
+    NV_STATUS              rmStatus;                                      // OUT
+} UVM_GET_FAULT_BATCH_RECORDS_PARAMS;
+
+//
+// Reports how long the GPU memory backing the managed allocations in
+// [base, base + length) has gone unaccessed, as measured by the cold memory
+// scanner of each GPU. Each entry covers one 2MB region resident on one GPU,
+// and idleScans counts the scans in a row which found it unaccessed. Regions
+// the scanner doesn't track are not reported. If the entries don't fit,
+// nextBase is where the next query should continue from, otherwise it is
+// base + length.
+//
+// Error codes:
+//     NV_ERR_INVALID_ADDRESS: length is 0 or the range wraps around.
+//     NV_ERR_NOT_SUPPORTED: none of the GPUs registered in the VA space runs
+//         the cold memory scanner.
+//
+#define UVM_VIDMEM_COLDNESS_MAX_ENTRIES                               64
+
+typedef struct
+{
+    NvU64           regionBase NV_ALIGN_BYTES(8); // OUT
+    NvProcessorUuid processorUuid;                // OUT
+    NvU32           idleScans;                    // OUT
+} UVM_VIDMEM_COLDNESS_ENTRY;
+
+#define UVM_GET_VIDMEM_COLDNESS                                       UVM_IOCTL_BASE(82)
+typedef struct
+{
+    NvU64                     base      NV_ALIGN_BYTES(8);                   // IN
+    NvU64                     length    NV_ALIGN_BYTES(8);                   // IN
+    UVM_VIDMEM_COLDNESS_ENTRY entries[UVM_VIDMEM_COLDNESS_MAX_ENTRIES];       // OUT
+    NvU32                     numEntries;                                      // OUT
+    NvU64                     nextBase  NV_ALIGN_BYTES(8);                   // OUT
+    NV_STATUS                 rmStatus;                                        // OUT
+} UVM_GET_VIDMEM_COLDNESS_PARAMS;
+
+//
+// Migrate all the VA ranges of a range group to destinationUuid in bulk, for
+// spilling a process's working set to host memory and bringing it back. The
+// destination memory of the whole group is allocated before any copy is
+// pushed, the copies are spread across all the usable CEs, and the per-page
+// heuristics of UVM_MIGRATE_RANGE_GROUP are skipped: read duplication is not
+// honored, thrashing state of the migrated blocks is dropped, and no CPU
+// mappings are created for a CPU destination.
+//
+// flags only accepts UVM_MIGRATE_FLAG_ASYNC. semaphoreAddress and
+// semaphorePayload behave as in UVM_MIGRATE and signal the completion of the
+// whole group. Progress is reported to tools event trackers through the
+// migration events of each block. bytesMigrated is the number of bytes whose
+// residency changed, or whose copies were pushed for asynchronous calls.
+//
+// Returns NV_ERR_INVALID_STATE if the range group is not migratable.
+//
+#define UVM_MIGRATE_RANGE_GROUP_BULK                                  UVM_IOCTL_BASE(83)
+typedef struct
+{
+    NvU64           rangeGroupId       NV_ALIGN_BYTES(8); // IN
+    NvProcessorUuid destinationUuid;                      // IN
+    NvU32           flags;                                // IN
+    NvU64           semaphoreAddress   NV_ALIGN_BYTES(8); // IN
+    NvU32           semaphorePayload;                     // IN
+    NvU64           bytesMigrated      NV_ALIGN_BYTES(8); // OUT
+    NV_STATUS       rmStatus;                             // OUT
+} UVM_MIGRATE_RANGE_GROUP_BULK_PARAMS;
+
+//
+// Read the latency of the pushes completed on the given GPU for each CE
+// channel type, indexed by UVM_TOOLS_CHANNEL_TYPE_*. Queueing latency is the
+// time a push waited for a channel and pushbuffer space when it began, and
+// execution latency the time from the end of the push until the CPU observed
+// the release of its tracking semaphore. Histogram bucket i counts the
+// latencies in [2^i, 2^(i+1)) ns, bucket 0 also counts the 0 ns ones and the
+// last bucket everything above. Pushes begun on a given channel rather than
+// for a channel type are not accounted. The counters are never reset.
+//
+// Returns NV_ERR_INVALID_DEVICE if the GPU is not registered in the VA space.
+//
+#define UVM_TOOLS_CHANNEL_TYPE_CPU_TO_GPU                             0
+#define UVM_TOOLS_CHANNEL_TYPE_GPU_TO_CPU                             1
+#define UVM_TOOLS_CHANNEL_TYPE_GPU_INTERNAL                           2
+#define UVM_TOOLS_CHANNEL_TYPE_MEMOPS                                 3
+#define UVM_TOOLS_CHANNEL_TYPE_GPU_TO_GPU                             4
+#define UVM_TOOLS_CHANNEL_TYPE_COUNT                                  5
+
+#define UVM_TOOLS_PUSH_LATENCY_BUCKETS                                32
+
+typedef struct
+{
+    NvU64 pushes                                         NV_ALIGN_BYTES(8); // OUT
+    NvU64 queueNs                                        NV_ALIGN_BYTES(8); // OUT
+    NvU64 execNs                                         NV_ALIGN_BYTES(8); // OUT
+    NvU64 queueHistogram[UVM_TOOLS_PUSH_LATENCY_BUCKETS] NV_ALIGN_BYTES(8); // OUT
+    NvU64 execHistogram[UVM_TOOLS_PUSH_LATENCY_BUCKETS]  NV_ALIGN_BYTES(8); // OUT
+} UVM_TOOLS_PUSH_LATENCY_STATS;
+
+#define UVM_TOOLS_GET_PUSH_LATENCY                                    UVM_IOCTL_BASE(84)
+typedef struct
+{
+    NvProcessorUuid              gpuUuid;                               // IN
+    UVM_TOOLS_PUSH_LATENCY_STATS stats[UVM_TOOLS_CHANNEL_TYPE_COUNT];   // OUT
+    NV_STATUS                    rmStatus;                              // OUT
+} UVM_TOOLS_GET_PUSH_LATENCY_PARAMS;
+
+//
+// Read the replayable fault buffer occupancy of the given GPU, to size it from
+// measurements. bufferEntries is the number of entries of the buffer, and
+// maxPendingEntries the highest number of them found pending when the driver
+// read PUT. The buffer overflows when it is found full, as the GPU drops the
+// faults that arrive then, and each overflow lasts until the buffer is found
+// empty again. totalDrainNs and maxDrainNs only account the overflows that
+// ended, overflowed is set if one is ongoing. The counters are never reset.
+//
+// Returns NV_ERR_INVALID_DEVICE if the GPU is not registered in the VA space
+// or does not support replayable faults.
+//
+#define UVM_GET_FAULT_BUFFER_STATS                                    UVM_IOCTL_BASE(85)
+typedef struct
+{
+    NvProcessorUuid gpuUuid;                              // IN
+    NvU32           bufferEntries;                        // OUT
+    NvU32           maxPendingEntries;                    // OUT
+    NvU64           numOverflows       NV_ALIGN_BYTES(8); // OUT
+    NvU64           totalDrainNs       NV_ALIGN_BYTES(8); // OUT
+    NvU64           maxDrainNs         NV_ALIGN_BYTES(8); // OUT
+    NvBool          overflowed;                           // OUT
+    NV_STATUS       rmStatus;                             // OUT
+} UVM_GET_FAULT_BUFFER_STATS_PARAMS;
+
 //
 // Temporary ioctls which should be removed before UVM 8 release
 // Number backwards from 2047 - highest custom ioctl function number
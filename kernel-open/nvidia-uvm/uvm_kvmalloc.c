@@ -44,9 +44,30 @@ typedef struct
     const char *file;
     const char *function;
     int line;
+
+    // Cache the allocation came from, or NULL for uvm_kvmalloc allocations
+    uvm_kmem_cache_t *cache;
+
     uvm_rb_tree_node_t node;
 } uvm_kvmalloc_info_t;
 
+struct uvm_kmem_cache_struct
+{
+    heap cache;
+
+    const char *name;
+
+    // Size of the objects handed out by the cache. This may be larger than the
+    // size requested at creation.
+    size_t object_size;
+
+    uvm_kmem_cache_ctor_t ctor;
+
+    // Number of objects currently allocated from the cache. Only tracked when
+    // the leak checker is enabled.
+    atomic_long_t objects_allocated;
+};
+
 typedef enum
 {
     UVM_KVMALLOC_LEAK_CHECK_NONE = 0,
@@ -126,6 +147,29 @@ void uvm_kvmalloc_exit(void)
     if (uvm_leak_checker >= UVM_KVMALLOC_LEAK_CHECK_ORIGIN) {
         uvm_rb_tree_node_t *node, *next;
 
+        // Objects from caches which were never destroyed. Their memory can't
+        // be returned with uvm_kvfree, so only drop their tracking. This has
+        // to be done before the loop below, which might free the caches
+        // themselves.
+        uvm_rb_tree_for_each_safe(node, next, &g_uvm_leak_checker.allocation_info) {
+            uvm_kvmalloc_info_t *info = container_of(node, uvm_kvmalloc_info_t, node);
+
+            if (!info->cache)
+                continue;
+
+            printk(KERN_ERR NVIDIA_UVM_PRETTY_PRINTING_PREFIX "    Leaked %zu bytes from %s:%d:%s (0x%llx) in cache %s\n",
+                   info->cache->object_size,
+                   kbasename(info->file),
+                   info->line,
+                   info->function,
+                   info->node.key,
+                   info->cache->name);
+
+            atomic_long_sub(info->cache->object_size, &g_uvm_leak_checker.bytes_allocated);
+            uvm_rb_tree_remove(&g_uvm_leak_checker.allocation_info, node);
+            kmem_cache_free(g_uvm_leak_checker.info_cache, info);
+        }
+
         uvm_rb_tree_for_each_safe(node, next, &g_uvm_leak_checker.allocation_info) {
             uvm_kvmalloc_info_t *info = container_of(node, uvm_kvmalloc_info_t, node);
 
@@ -187,18 +231,17 @@ static uvm_kvmalloc_info_t *remove_info(void *p)
     return info;
 }
 
-static void alloc_tracking_add(void *p, const char *file, int line, const char *function)
+static void alloc_tracking_add_size(void *p,
+                                    size_t size,
+                                    uvm_kmem_cache_t *cache,
+                                    const char *file,
+                                    int line,
+                                    const char *function)
 {
-    // Add uvm_kvsize(p) instead of size because uvm_kvsize might be larger (due
-    // to ksize), and uvm_kvfree only knows about uvm_kvsize
-    size_t size = uvm_kvsize(p);
     uvm_kvmalloc_info_t *info;
 
     UVM_ASSERT(g_malloc_initialized);
 
-    if (ZERO_OR_NULL_PTR(p))
-        return;
-
     atomic_long_add(size, &g_uvm_leak_checker.bytes_allocated);
 
     if (uvm_leak_checker >= UVM_KVMALLOC_LEAK_CHECK_ORIGIN) {
@@ -213,21 +256,30 @@ static void alloc_tracking_add(void *p, const char *file, int line, const char *
         info->file      = file;
         info->function  = function;
         info->line      = line;
+        info->cache     = cache;
 
         insert_info(info);
     }
 }
 
-static void alloc_tracking_remove(void *p)
+static void alloc_tracking_add(void *p, const char *file, int line, const char *function)
 {
-    size_t size = uvm_kvsize(p);
-    uvm_kvmalloc_info_t *info;
-
     UVM_ASSERT(g_malloc_initialized);
 
     if (ZERO_OR_NULL_PTR(p))
         return;
 
+    // Add uvm_kvsize(p) instead of size because uvm_kvsize might be larger (due
+    // to ksize), and uvm_kvfree only knows about uvm_kvsize
+    alloc_tracking_add_size(p, uvm_kvsize(p), NULL, file, line, function);
+}
+
+static void alloc_tracking_remove_size(void *p, size_t size)
+{
+    uvm_kvmalloc_info_t *info;
+
+    UVM_ASSERT(g_malloc_initialized);
+
     atomic_long_sub(size, &g_uvm_leak_checker.bytes_allocated);
 
     if (uvm_leak_checker >= UVM_KVMALLOC_LEAK_CHECK_ORIGIN) {
@@ -237,6 +289,16 @@ static void alloc_tracking_remove(void *p)
     }
 }
 
+static void alloc_tracking_remove(void *p)
+{
+    UVM_ASSERT(g_malloc_initialized);
+
+    if (ZERO_OR_NULL_PTR(p))
+        return;
+
+    alloc_tracking_remove_size(p, uvm_kvsize(p));
+}
+
 static uvm_vmalloc_hdr_t *get_hdr(void *p)
 {
     uvm_vmalloc_hdr_t *hdr;
@@ -411,3 +473,130 @@ size_t uvm_kvsize(void *p)
         return get_hdr(p)->alloc_size;
     return ksize(p);
 }
+
+uvm_kmem_cache_t *uvm_kmem_cache_create(const char *name, size_t size, uvm_kmem_cache_ctor_t ctor)
+{
+    uvm_kmem_cache_t *cache;
+
+    UVM_ASSERT(g_malloc_initialized);
+    UVM_ASSERT(size > 0);
+
+    cache = uvm_kvmalloc_zero(sizeof(*cache));
+    if (!cache)
+        return NULL;
+
+    cache->cache = nv_kmem_cache_create(name, size, 0);
+    if (!cache->cache) {
+        uvm_kvfree(cache);
+        return NULL;
+    }
+
+    cache->name = name;
+    cache->object_size = cache->cache->pagesize;
+    cache->ctor = ctor;
+
+    return cache;
+}
+
+// Print and drop the origin tracking of all objects still allocated from the
+// given cache
+static void kmem_cache_leak_report_origins(uvm_kmem_cache_t *cache)
+{
+    uvm_rb_tree_node_t *node, *next;
+    unsigned long irq_flags;
+
+    spin_lock_irqsave(&g_uvm_leak_checker.lock, irq_flags);
+
+    uvm_rb_tree_for_each_safe(node, next, &g_uvm_leak_checker.allocation_info) {
+        uvm_kvmalloc_info_t *info = container_of(node, uvm_kvmalloc_info_t, node);
+
+        if (info->cache != cache)
+            continue;
+
+        printk(KERN_ERR NVIDIA_UVM_PRETTY_PRINTING_PREFIX "    Leaked %zu bytes from %s:%d:%s (0x%llx)\n",
+               cache->object_size,
+               kbasename(info->file),
+               info->line,
+               info->function,
+               info->node.key);
+
+        uvm_rb_tree_remove(&g_uvm_leak_checker.allocation_info, node);
+        kmem_cache_free(g_uvm_leak_checker.info_cache, info);
+    }
+
+    spin_unlock_irqrestore(&g_uvm_leak_checker.lock, irq_flags);
+}
+
+void uvm_kmem_cache_destroy_safe(uvm_kmem_cache_t **cache_ptr)
+{
+    uvm_kmem_cache_t *cache;
+    long leaked;
+
+    if (!cache_ptr || !*cache_ptr)
+        return;
+
+    cache = *cache_ptr;
+
+    leaked = atomic_long_read(&cache->objects_allocated);
+    if (leaked > 0) {
+        printk(KERN_ERR NVIDIA_UVM_PRETTY_PRINTING_PREFIX "Memory leak of %ld objects from cache %s detected.\n",
+               leaked,
+               cache->name);
+
+        if (uvm_leak_checker >= UVM_KVMALLOC_LEAK_CHECK_ORIGIN)
+            kmem_cache_leak_report_origins(cache);
+
+        // The objects go away with the cache, so they no longer count towards
+        // the outstanding bytes checked in uvm_kvmalloc_exit. Record the leak
+        // here instead.
+        atomic_long_sub(leaked * cache->object_size, &g_uvm_leak_checker.bytes_allocated);
+
+        if (g_uvm_global.unload_state.ptr)
+            *g_uvm_global.unload_state.ptr |= UVM_TEST_UNLOAD_STATE_MEMORY_LEAK;
+    }
+
+    kmem_cache_destroy(cache->cache);
+    uvm_kvfree(cache);
+    *cache_ptr = NULL;
+}
+
+void *__uvm_kmem_cache_alloc(uvm_kmem_cache_t *cache, bool zero_memory, const char *file, int line, const char *function)
+{
+    void *p;
+
+    UVM_ASSERT(cache);
+
+    if (zero_memory)
+        p = kmem_cache_zalloc(cache->cache, NV_UVM_GFP_FLAGS);
+    else
+        p = kmem_cache_alloc(cache->cache, NV_UVM_GFP_FLAGS);
+
+    if (!p)
+        return NULL;
+
+    if (cache->ctor)
+        cache->ctor(p);
+
+    if (uvm_leak_checker) {
+        atomic_long_inc(&cache->objects_allocated);
+        alloc_tracking_add_size(p, cache->object_size, cache, file, line, function);
+    }
+
+    return p;
+}
+
+void uvm_kmem_cache_free(uvm_kmem_cache_t *cache, void *p)
+{
+    if (!p)
+        return;
+
+    UVM_ASSERT(cache);
+
+    if (uvm_leak_checker) {
+        UVM_ASSERT(atomic_long_read(&cache->objects_allocated) > 0);
+        atomic_long_dec(&cache->objects_allocated);
+        alloc_tracking_remove_size(p, cache->object_size);
+    }
+
+    kmem_cache_free(cache->cache, p);
+}
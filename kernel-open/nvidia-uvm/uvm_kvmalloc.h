@@ -70,6 +70,39 @@ void *__uvm_kvrealloc(void *p, size_t new_size, const char *file, int line, cons
 // p must not be NULL.
 size_t uvm_kvsize(void *p);
 
+// Typed object caches for fixed-size objects which are allocated and freed
+// frequently, such as VA blocks and GPU chunks. They are backed by a dedicated
+// objcache so allocations avoid the general-purpose kmalloc heap.
+//
+// If a constructor is provided, it's called on every object returned by
+// uvm_kmem_cache_alloc and uvm_kmem_cache_zalloc, after the memory has been
+// zeroed in the latter case. Objects are not required to be returned to the
+// cache in their constructed state.
+//
+// Objects allocated from a cache are accounted by the leak checker just like
+// uvm_kvmalloc allocations. Objects still outstanding when their cache is
+// destroyed are reported as leaks.
+typedef struct uvm_kmem_cache_struct uvm_kmem_cache_t;
+
+typedef void (*uvm_kmem_cache_ctor_t)(void *object);
+
+// The name must remain valid until the cache is destroyed. Returns NULL on
+// failure.
+uvm_kmem_cache_t *uvm_kmem_cache_create(const char *name, size_t size, uvm_kmem_cache_ctor_t ctor);
+
+#define UVM_KMEM_CACHE_CREATE(__name, __type, __ctor) uvm_kmem_cache_create(__name, sizeof(__type), __ctor)
+
+// Destroys *cache_ptr, if not NULL, and sets it to NULL
+void uvm_kmem_cache_destroy_safe(uvm_kmem_cache_t **cache_ptr);
+
+void *__uvm_kmem_cache_alloc(uvm_kmem_cache_t *cache, bool zero_memory, const char *file, int line, const char *function);
+
+#define uvm_kmem_cache_alloc(__cache) __uvm_kmem_cache_alloc(__cache, false, __FILE__, __LINE__, __FUNCTION__)
+#define uvm_kmem_cache_zalloc(__cache) __uvm_kmem_cache_alloc(__cache, true, __FILE__, __LINE__, __FUNCTION__)
+
+// p may be NULL
+void uvm_kmem_cache_free(uvm_kmem_cache_t *cache, void *p);
+
 NV_STATUS uvm_test_kvmalloc(UVM_TEST_KVMALLOC_PARAMS *params, struct file *filp);
 
 #endif // __UVM_KVMALLOC_H__
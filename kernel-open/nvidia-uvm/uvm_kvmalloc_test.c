@@ -175,10 +175,69 @@ static NV_STATUS test_uvm_kvrealloc(void)
     return NV_OK;
 }
 
+typedef struct
+{
+    NvU64 ctor_marker;
+    NvU8 payload[200];
+} test_kmem_cache_object_t;
+
+#define TEST_KMEM_CACHE_CTOR_MARKER 0xcafe
+
+static void test_kmem_cache_ctor(void *object)
+{
+    test_kmem_cache_object_t *test_object = object;
+
+    test_object->ctor_marker = TEST_KMEM_CACHE_CTOR_MARKER;
+}
+
+static NV_STATUS test_uvm_kmem_cache(void)
+{
+    test_kmem_cache_object_t *objects[16] = {NULL};
+    uvm_kmem_cache_t *cache;
+    NV_STATUS status = NV_OK;
+    size_t i, j;
+
+    cache = UVM_KMEM_CACHE_CREATE("test_kmem_cache_object_t", test_kmem_cache_object_t, test_kmem_cache_ctor);
+    TEST_CHECK_RET(cache != NULL);
+
+    for (i = 0; i < ARRAY_SIZE(objects); i++) {
+        // Alternate between the zeroing and non-zeroing allocations
+        if (i % 2)
+            objects[i] = uvm_kmem_cache_zalloc(cache);
+        else
+            objects[i] = uvm_kmem_cache_alloc(cache);
+
+        TEST_CHECK_GOTO(objects[i] != NULL, done);
+        TEST_CHECK_GOTO(objects[i]->ctor_marker == TEST_KMEM_CACHE_CTOR_MARKER, done);
+
+        if (i % 2) {
+            for (j = 0; j < sizeof(objects[i]->payload); j++)
+                TEST_CHECK_GOTO(objects[i]->payload[j] == 0, done);
+        }
+
+        memset(objects[i]->payload, 0xff, sizeof(objects[i]->payload));
+        objects[i]->ctor_marker = 0;
+    }
+
+done:
+    for (i = 0; i < ARRAY_SIZE(objects); i++)
+        uvm_kmem_cache_free(cache, objects[i]);
+
+    uvm_kmem_cache_destroy_safe(&cache);
+    TEST_CHECK_RET(cache == NULL);
+
+    return status;
+}
+
 NV_STATUS uvm_test_kvmalloc(UVM_TEST_KVMALLOC_PARAMS *params, struct file *filp)
 {
     NV_STATUS status = test_uvm_kvmalloc();
     if (status != NV_OK)
         return status;
-    return test_uvm_kvrealloc();
+
+    status = test_uvm_kvrealloc();
+    if (status != NV_OK)
+        return status;
+
+    return test_uvm_kmem_cache();
 }
@@ -27,7 +27,7 @@
 
 const char *uvm_lock_order_to_string(uvm_lock_order_t lock_order)
 {
-    BUILD_BUG_ON(UVM_LOCK_ORDER_COUNT != 33);
+    BUILD_BUG_ON(UVM_LOCK_ORDER_COUNT != 34);
 
     switch (lock_order) {
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_INVALID);
@@ -41,6 +41,7 @@ const char *uvm_lock_order_to_string(uvm_lock_order_t lock_order)
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_VA_SPACE);
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_EXT_RANGE_TREE);
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_GPU_SEMAPHORE_POOL);
+        UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_RM_MEM_POOL);
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_RM_API);
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_RM_GPUS);
         UVM_ENUM_STRING_CASE(UVM_LOCK_ORDER_VA_BLOCK_MIGRATE);
@@ -374,3 +375,36 @@ void uvm_bit_locks_deinit(uvm_bit_locks_t *bit_locks)
     kfree(bit_locks->bits);
     memset(bit_locks, 0, sizeof(*bit_locks));
 }
+
+NV_STATUS uvm_init_rwsem_percpu(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_order)
+{
+    uvm_init_rwsem(uvm_sem, lock_order);
+
+    uvm_sem->percpu_readers = uvm_kvmalloc_zero(sizeof(*uvm_sem->percpu_readers) * present_processors);
+    if (!uvm_sem->percpu_readers)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_sem->percpu_reader_count = present_processors;
+
+    return NV_OK;
+}
+
+void uvm_deinit_rwsem(uvm_rw_semaphore_t *uvm_sem)
+{
+    uvm_assert_rwsem_unlocked(uvm_sem);
+
+    uvm_kvfree(uvm_sem->percpu_readers);
+    uvm_sem->percpu_readers = NULL;
+    uvm_sem->percpu_reader_count = 0;
+}
+
+void __uvm_rwsem_percpu_drain_readers(uvm_rw_semaphore_t *uvm_sem)
+{
+    UVM_ASSERT(uvm_sem->sem.l.w != 0);
+
+    // New readers back off as soon as they see sem.l.w, so the counts only go
+    // down from here. Summing them non-atomically can only overestimate the
+    // number of readers left, never report zero too early.
+    while (uvm_rwsem_percpu_readers(uvm_sem) != 0)
+        kern_pause();
+}
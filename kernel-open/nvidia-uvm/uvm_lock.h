@@ -234,6 +234,10 @@
 //      Write mode: Modification of the range state such as mmap and changes to
 //      logical permissions or location preferences. RM calls are never allowed.
 //
+//      Unless uvm_va_space_lock_percpu_readers is 0, the lock is reader-biased:
+//      readers only touch a per-CPU count, and writers drain the counts of all
+//      CPUs. See uvm_init_rwsem_percpu().
+//
 // - External Allocation Tree lock
 //      Order: UVM_LOCK_ORDER_EXT_RANGE_TREE
 //      Exclusive lock (mutex) per external VA range, per GPU.
@@ -246,6 +250,14 @@
 //
 //      Protects the state of the semaphore pool.
 //
+// - RM memory sub-allocation pool lock (gpu->rm_mem_pool.lock)
+//      Order: UVM_LOCK_ORDER_RM_MEM_POOL
+//      Exclusive lock (mutex) per GPU
+//
+//      Protects the slabs that small uvm_rm_mem_t allocations are carved out
+//      of. It is held across the RM calls that allocate and map the slabs, so
+//      it is ordered before the RM locks.
+//
 // - RM API lock
 //      Order: UVM_LOCK_ORDER_RM_API
 //      Exclusive lock
@@ -471,6 +483,7 @@ typedef enum
     UVM_LOCK_ORDER_VA_SPACE,
     UVM_LOCK_ORDER_EXT_RANGE_TREE,
     UVM_LOCK_ORDER_GPU_SEMAPHORE_POOL,
+    UVM_LOCK_ORDER_RM_MEM_POOL,
     UVM_LOCK_ORDER_RM_API,
     UVM_LOCK_ORDER_RM_GPUS,
     UVM_LOCK_ORDER_VA_BLOCK_MIGRATE,
@@ -705,14 +718,109 @@ bool __uvm_locking_initialized(void);
         uvm_record_unlock_rm_all();                     \
     })
 
+// Per-CPU reader count of a reader-biased uvm_rw_semaphore_t. Each count has a
+// cache line to itself so readers on different CPUs don't bounce it. A reader
+// may release the lock on a different CPU than the one it acquired it on, so
+// only the sum of all counts is meaningful.
+typedef struct
+{
+    NvU64 count;
+} ____cacheline_aligned_in_smp uvm_rwsem_percpu_reader_t;
+
 typedef struct
 {
     struct rw_spinlock sem;
+
+    // Per-CPU reader counts used instead of sem.readers, or NULL. Only
+    // allocated by uvm_init_rwsem_percpu().
+    uvm_rwsem_percpu_reader_t *percpu_readers;
+    NvU32 percpu_reader_count;
+
 #if UVM_IS_DEBUG()
     uvm_lock_order_t lock_order;
 #endif
 } uvm_rw_semaphore_t;
 
+static NvU64 uvm_rwsem_percpu_readers(uvm_rw_semaphore_t *uvm_sem)
+{
+    NvU64 readers = 0;
+    NvU32 i;
+
+    for (i = 0; i < uvm_sem->percpu_reader_count; i++)
+        readers += UVM_READ_ONCE(uvm_sem->percpu_readers[i].count);
+
+    return readers;
+}
+
+static bool uvm_rwsem_is_locked(uvm_rw_semaphore_t *uvm_sem)
+{
+    return (uvm_sem->sem.l.w != 0) || (uvm_sem->sem.readers != 0) || (uvm_rwsem_percpu_readers(uvm_sem) != 0);
+}
+
+// Reader count of the current CPU. The index is the CPU the count is taken on,
+// which doesn't need to match the CPU the count ends up being dropped on.
+static NvU64 *uvm_rwsem_percpu_count(uvm_rw_semaphore_t *uvm_sem)
+{
+    NvU32 cpu = current_cpu()->id;
+
+    UVM_ASSERT(cpu < uvm_sem->percpu_reader_count);
+
+    return &uvm_sem->percpu_readers[cpu].count;
+}
+
+static void uvm_rwsem_rlock(uvm_rw_semaphore_t *uvm_sem)
+{
+    if (!uvm_sem->percpu_readers) {
+        spin_rlock(&uvm_sem->sem);
+        return;
+    }
+
+    while (true) {
+        NvU64 *count = uvm_rwsem_percpu_count(uvm_sem);
+
+        // The atomic add is a full barrier, which orders the count increment
+        // against the writer check below. Writers set sem.l.w before draining
+        // the counts, so either the writer sees this reader or this reader
+        // sees the writer.
+        fetch_and_add(count, 1);
+        if (!UVM_READ_ONCE(uvm_sem->sem.l.w))
+            return;
+
+        fetch_and_add(count, -1);
+        while (UVM_READ_ONCE(uvm_sem->sem.l.w))
+            kern_pause();
+    }
+}
+
+static void uvm_rwsem_runlock(uvm_rw_semaphore_t *uvm_sem)
+{
+    if (uvm_sem->percpu_readers)
+        fetch_and_add(uvm_rwsem_percpu_count(uvm_sem), -1);
+    else
+        spin_runlock(&uvm_sem->sem);
+}
+
+// Waits for the per-CPU reader counts to drain. Called with sem.l.w set.
+void __uvm_rwsem_percpu_drain_readers(uvm_rw_semaphore_t *uvm_sem);
+
+static void uvm_rwsem_wlock(uvm_rw_semaphore_t *uvm_sem)
+{
+    spin_wlock(&uvm_sem->sem);
+    if (uvm_sem->percpu_readers)
+        __uvm_rwsem_percpu_drain_readers(uvm_sem);
+}
+
+// Turns the write lock into a read lock without letting other writers in
+static void uvm_rwsem_downgrade(uvm_rw_semaphore_t *uvm_sem)
+{
+    if (uvm_sem->percpu_readers)
+        fetch_and_add(uvm_rwsem_percpu_count(uvm_sem), 1);
+    else
+        fetch_and_add(&uvm_sem->sem.readers, 1);
+
+    spin_wunlock(&uvm_sem->sem);
+}
+
 //
 // Note that this is a macro, not an inline or static function so the
 // "uvm_sem" argument is subsituted as text. If this is invoked with
@@ -723,7 +831,7 @@ typedef struct
 //
 #define uvm_assert_rwsem_locked_mode(uvm_sem, flags) ({                               \
         typeof(uvm_sem) _sem_ = (uvm_sem);                                            \
-        UVM_ASSERT((_sem_->sem.l.w != 0) && uvm_check_locked(_sem_, (flags)));        \
+        UVM_ASSERT(uvm_rwsem_is_locked(_sem_) && uvm_check_locked(_sem_, (flags)));   \
     })
 
 #define uvm_assert_rwsem_locked(uvm_sem) \
@@ -733,11 +841,13 @@ typedef struct
 #define uvm_assert_rwsem_locked_write(uvm_sem) \
         uvm_assert_rwsem_locked_mode(uvm_sem, UVM_LOCK_FLAGS_MODE_EXCLUSIVE)
 
-#define uvm_assert_rwsem_unlocked(uvm_sem) UVM_ASSERT((uvm_sem)->sem.l.w == 0)
+#define uvm_assert_rwsem_unlocked(uvm_sem) UVM_ASSERT(!uvm_rwsem_is_locked(uvm_sem))
 
 static void uvm_init_rwsem(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_order)
 {
     spin_rw_lock_init(&uvm_sem->sem);
+    uvm_sem->percpu_readers = NULL;
+    uvm_sem->percpu_reader_count = 0;
 #if UVM_IS_DEBUG()
     uvm_locking_assert_initialized();
     uvm_sem->lock_order = lock_order;
@@ -745,17 +855,30 @@ static void uvm_init_rwsem(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_or
     uvm_assert_rwsem_unlocked(uvm_sem);
 }
 
+// Initialize a reader-biased rw semaphore. Readers only increment and decrement
+// a per-CPU count, so read acquisitions from different CPUs don't contend on a
+// shared cache line. Writers pay for it by waiting for the counts of all CPUs
+// to drain. This is only worth it for locks which are acquired for read much
+// more often than for write.
+//
+// The lock must be torn down with uvm_deinit_rwsem().
+NV_STATUS uvm_init_rwsem_percpu(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_order);
+
+// Free the resources of an unlocked rw semaphore. This is only required for
+// semaphores initialized with uvm_init_rwsem_percpu().
+void uvm_deinit_rwsem(uvm_rw_semaphore_t *uvm_sem);
+
 #define uvm_down_read(uvm_sem) ({                          \
         typeof(uvm_sem) _sem = (uvm_sem);                  \
         uvm_record_lock(_sem, UVM_LOCK_FLAGS_MODE_SHARED); \
-        spin_rlock(&_sem->sem);                            \
+        uvm_rwsem_rlock(_sem);                             \
         uvm_assert_rwsem_locked_read(_sem);                \
     })
 
 #define uvm_up_read(uvm_sem) ({                              \
         typeof(uvm_sem) _sem = (uvm_sem);                    \
         uvm_assert_rwsem_locked_read(_sem);                  \
-        spin_runlock(&_sem->sem);                            \
+        uvm_rwsem_runlock(_sem);                             \
         uvm_record_unlock(_sem, UVM_LOCK_FLAGS_MODE_SHARED); \
     })
 
@@ -772,7 +895,7 @@ static void uvm_init_rwsem(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_or
 #define uvm_down_write(uvm_sem) ({                            \
         typeof (uvm_sem) _sem = (uvm_sem);                    \
         uvm_record_lock(_sem, UVM_LOCK_FLAGS_MODE_EXCLUSIVE); \
-        spin_wlock(&_sem->sem);                               \
+        uvm_rwsem_wlock(_sem);                                \
         uvm_assert_rwsem_locked_write(_sem);                  \
     })
 
@@ -830,8 +953,7 @@ static void uvm_init_rwsem(uvm_rw_semaphore_t *uvm_sem, uvm_lock_order_t lock_or
 #define uvm_downgrade_write(uvm_sem) ({                 \
         typeof(uvm_sem) _sem = (uvm_sem);               \
         uvm_assert_rwsem_locked_write(_sem);            \
-        fetch_and_add(&_sem->sem.readers, 1);           \
-        spin_wunlock(&_sem->sem);                       \
+        uvm_rwsem_downgrade(_sem);                      \
         uvm_record_downgrade(_sem);                     \
     })
 
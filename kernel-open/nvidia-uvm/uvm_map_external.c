@@ -76,6 +76,9 @@ typedef struct
 
     // PTE offset at which the currently buffered PTEs start.
     size_t pte_offset;
+
+    // Whether the buffer was provided by the caller, already filled
+    bool borrowed;
 } uvm_pte_buffer_t;
 
 // Max PTE buffer size is the size of the buffer used for querying PTEs from RM.
@@ -86,6 +89,22 @@ typedef struct
 // some benchmarking on more systems though.
 #define MAX_PTE_BUFFER_SIZE ((size_t)96 * 1024)
 
+// Size in KB up to which the PTEs of a whole mapping are retrieved from RM at
+// once. Every RM query takes the RM lock and walks the allocation from the
+// requested offset, so mapping a large allocation with small pages in
+// MAX_PTE_BUFFER_SIZE pieces spends most of its time in those round-trips.
+// Mappings whose PTEs fit within this size are streamed in with a single
+// query and the buffer then serves all of their pushes. Larger mappings, or
+// failures to allocate the big buffer, fall back to MAX_PTE_BUFFER_SIZE
+// pieces. 0 disables streaming.
+static unsigned uvm_ext_pte_stream_size_kb = 2048;
+module_param(uvm_ext_pte_stream_size_kb, uint, S_IRUGO);
+
+static size_t pte_buffer_stream_size(void)
+{
+    return (size_t)UVM_READ_ONCE(uvm_ext_pte_stream_size_kb) * 1024;
+}
+
 static NV_STATUS uvm_pte_buffer_init(uvm_va_range_t *va_range,
                                      uvm_gpu_t *gpu,
                                      const uvm_map_rm_params_t *map_rm_params,
@@ -113,9 +132,29 @@ static NV_STATUS uvm_pte_buffer_init(uvm_va_range_t *va_range,
     pte_buffer->pte_size = uvm_mmu_pte_size(tree, page_size);
     num_all_ptes = uvm_div_pow2_64(length, page_size);
     pte_buffer->max_pte_offset = uvm_div_pow2_64(map_rm_params->map_offset, page_size) + num_all_ptes;
+
+    if (map_rm_params->ptes) {
+        pte_buffer->buffer_size = num_all_ptes * pte_buffer->pte_size;
+        pte_buffer->mapping_info.pteBuffer = map_rm_params->ptes;
+        pte_buffer->pte_offset = uvm_div_pow2_64(map_rm_params->map_offset, page_size);
+        pte_buffer->num_ptes = num_all_ptes;
+        pte_buffer->borrowed = true;
+        return NV_OK;
+    }
+
+    // Size the buffer for all of the mapping's PTEs when that's allowed, so
+    // the first query retrieves all of them.
+    if (num_all_ptes * pte_buffer->pte_size > MAX_PTE_BUFFER_SIZE &&
+        num_all_ptes * pte_buffer->pte_size <= pte_buffer_stream_size()) {
+        pte_buffer->buffer_size = num_all_ptes * pte_buffer->pte_size;
+        pte_buffer->mapping_info.pteBuffer = uvm_kvmalloc(pte_buffer->buffer_size);
+        if (pte_buffer->mapping_info.pteBuffer)
+            return NV_OK;
+    }
+
     pte_buffer->buffer_size = min(MAX_PTE_BUFFER_SIZE, num_all_ptes * pte_buffer->pte_size);
 
-    pte_buffer->mapping_info.pteBuffer = kmalloc(pte_buffer->buffer_size, 0);
+    pte_buffer->mapping_info.pteBuffer = uvm_kvmalloc(pte_buffer->buffer_size);
     if (!pte_buffer->mapping_info.pteBuffer)
         return NV_ERR_NO_MEMORY;
 
@@ -124,7 +163,10 @@ static NV_STATUS uvm_pte_buffer_init(uvm_va_range_t *va_range,
 
 static void uvm_pte_buffer_deinit(uvm_pte_buffer_t *pte_buffer)
 {
-    NV_KFREE(pte_buffer->mapping_info.pteBuffer, pte_buffer->buffer_size);
+    if (pte_buffer->borrowed)
+        return;
+
+    uvm_kvfree(pte_buffer->mapping_info.pteBuffer);
 }
 
 // Get the PTEs for mapping the [map_offset, map_offset + map_size) VA range.
@@ -747,6 +789,57 @@ static NV_STATUS uvm_ext_gpu_map_split(uvm_range_tree_t *tree,
     return NV_OK;
 }
 
+static NvU64 external_sparse_pte_maker(uvm_page_table_range_vec_t *range_vec, NvU64 offset, void *caller_data)
+{
+    return range_vec->tree->hal->make_sparse_pte();
+}
+
+// Sparse mappings use the biggest page sizes that fit, see
+// uvm_map_external_sparse_on_gpu(). If addr falls within a big sparse PTE,
+// replace it with sparse PTEs of the smaller page sizes until addr is aligned
+// to the page size, allocating the lower page table levels of the big page
+// only. The rest of the sparse mapping is left as is.
+static NV_STATUS split_sparse_ext_gpu_map_at(uvm_va_range_t *va_range, uvm_gpu_t *gpu, NvU64 addr)
+{
+    uvm_ext_gpu_range_tree_t *range_tree = uvm_ext_gpu_range_tree(va_range, gpu);
+    uvm_ext_gpu_map_t *ext_map = uvm_va_range_ext_gpu_map(va_range, gpu, addr);
+    NV_STATUS status;
+
+    uvm_assert_mutex_locked(&range_tree->lock);
+
+    while (ext_map && !ext_map->mem_handle) {
+        uvm_page_tree_t *tree = ext_map->pt_range_vec.tree;
+        NvU32 page_size = ext_map->pt_range_vec.page_size;
+        NvU64 page_start = UVM_ALIGN_DOWN(addr, page_size);
+
+        if (IS_ALIGNED(addr, page_size) || page_size <= tree->big_page_size)
+            break;
+
+        // Isolate the big page in its own ext_gpu_map
+        if (page_start > ext_map->node.start) {
+            status = uvm_ext_gpu_map_split(&range_tree->tree, ext_map, page_start - 1, &ext_map);
+            if (status != NV_OK)
+                return status;
+        }
+
+        if (page_start + page_size - 1 < ext_map->node.end) {
+            status = uvm_ext_gpu_map_split(&range_tree->tree, ext_map, page_start + page_size - 1, NULL);
+            if (status != NV_OK)
+                return status;
+        }
+
+        status = uvm_page_table_range_vec_split_pte(&ext_map->pt_range_vec,
+                                                    uvm_mmu_biggest_page_size_up_to(tree, page_size / 2),
+                                                    UVM_PMM_ALLOC_FLAGS_EVICT,
+                                                    external_sparse_pte_maker,
+                                                    NULL);
+        if (status != NV_OK)
+            return status;
+    }
+
+    return NV_OK;
+}
+
 static NV_STATUS uvm_unmap_external_in_range(uvm_va_range_t *va_range,
                                              uvm_gpu_t *gpu,
                                              NvU64 start,
@@ -759,6 +852,14 @@ static NV_STATUS uvm_unmap_external_in_range(uvm_va_range_t *va_range,
 
     uvm_assert_mutex_locked(&range_tree->lock);
 
+    status = split_sparse_ext_gpu_map_at(va_range, gpu, start);
+    if (status != NV_OK)
+        return status;
+
+    status = split_sparse_ext_gpu_map_at(va_range, gpu, end + 1);
+    if (status != NV_OK)
+        return status;
+
     // If a previously existing sub-range is found (ext_map != NULL), the
     // new sub-range can be overlapping with the existing one in one of the
     // following ways:
@@ -1004,6 +1105,7 @@ static NV_STATUS uvm_map_external_allocation(uvm_va_space_t *va_space, UVM_MAP_E
         map_rm_params.format_type = params->perGpuAttributes[i].gpuFormatType;
         map_rm_params.element_bits = params->perGpuAttributes[i].gpuElementBits;
         map_rm_params.compression_type = params->perGpuAttributes[i].gpuCompressionType;
+        map_rm_params.ptes = NULL;
         status = uvm_map_external_allocation_on_gpu(va_range,
                                                     mapping_gpu,
                                                     &user_rm_mem,
@@ -1057,47 +1159,70 @@ NV_STATUS uvm_api_map_external_allocation(UVM_MAP_EXTERNAL_ALLOCATION_PARAMS *pa
     return uvm_map_external_allocation(va_space, params);
 }
 
-static NvU64 external_sparse_pte_maker(uvm_page_table_range_vec_t *range_vec, NvU64 offset, void *caller_data)
+static NvU32 sparse_page_sizes(uvm_page_tree_t *tree)
 {
-    return range_vec->tree->hal->make_sparse_pte();
+    NvU32 page_sizes = tree->hal->page_sizes();
+
+    // The ATS lookup is disabled through the PDE1 entries, so keep them as
+    // PDEs on ATS systems.
+    if (g_uvm_global.ats.enabled)
+        page_sizes &= UVM_GMMU_ATS_GRANULARITY - 1;
+
+    return page_sizes;
 }
 
-static NV_STATUS uvm_map_external_sparse_on_gpu(uvm_va_range_t *va_range,
-                                                uvm_gpu_t *mapping_gpu,
-                                                NvU64 base,
-                                                NvU64 length,
-                                                struct list *deferred_free_list)
+// Biggest page size the sparse PTEs of [addr, end) can use at addr
+static NvU32 sparse_page_size(uvm_page_tree_t *tree, NvU64 addr, NvU64 end)
 {
-    uvm_va_space_t *va_space = va_range->va_space;
-    uvm_ext_gpu_map_t *ext_gpu_map = NULL;
-    uvm_ext_gpu_range_tree_t *range_tree = uvm_ext_gpu_range_tree(va_range, mapping_gpu);
-    uvm_gpu_va_space_t *gpu_va_space = uvm_gpu_va_space_get(va_space, mapping_gpu);
-    uvm_page_tree_t *page_tree;
-    NV_STATUS status;
+    NvU32 page_sizes = sparse_page_sizes(tree);
 
-    uvm_assert_rwsem_locked(&va_space->lock);
+    while (page_sizes) {
+        NvU32 page_size = 1 << __fls(page_sizes);
 
-    if (!uvm_gpu_can_address(mapping_gpu, base, length))
-        return NV_ERR_OUT_OF_RANGE;
+        if (IS_ALIGNED(addr, page_size) && addr + page_size <= end)
+            return page_size;
 
-    UVM_ASSERT(gpu_va_space);
+        page_sizes &= ~page_size;
+    }
 
-    page_tree = &gpu_va_space->page_tables;
+    return 0;
+}
 
-    uvm_mutex_lock(&range_tree->lock);
+// End of the run of page_size sparse PTEs starting at start, i.e. the first
+// address at which a bigger page size can be used, or the last page_size
+// boundary before end.
+static NvU64 sparse_segment_end(uvm_page_tree_t *tree, NvU64 start, NvU64 end, NvU32 page_size)
+{
+    NvU32 bigger_page_sizes = sparse_page_sizes(tree) & ~(page_size | (page_size - 1));
 
-    status = uvm_unmap_external_in_range(va_range, mapping_gpu, base, base + length - 1, deferred_free_list);
-    if (status != NV_OK)
-        goto error;
+    if (bigger_page_sizes) {
+        NvU32 bigger_page_size = bigger_page_sizes & ~(bigger_page_sizes - 1);
+        NvU64 bigger_start = UVM_ALIGN_UP(start, bigger_page_size);
 
-    ext_gpu_map = uvm_kvmalloc_zero(sizeof(*ext_gpu_map));
-    if (!ext_gpu_map) {
-        status = NV_ERR_NO_MEMORY;
-        goto error;
+        if (bigger_start + bigger_page_size <= end)
+            return bigger_start;
     }
 
-    ext_gpu_map->node.start = base;
-    ext_gpu_map->node.end = base + length - 1;
+    return UVM_ALIGN_DOWN(end, page_size);
+}
+
+static NV_STATUS map_external_sparse_segment(uvm_va_range_t *va_range,
+                                             uvm_gpu_t *mapping_gpu,
+                                             uvm_page_tree_t *page_tree,
+                                             NvU64 start,
+                                             NvU64 end,
+                                             NvU32 page_size)
+{
+    uvm_ext_gpu_map_t *ext_gpu_map;
+    uvm_ext_gpu_range_tree_t *range_tree = uvm_ext_gpu_range_tree(va_range, mapping_gpu);
+    NV_STATUS status;
+
+    ext_gpu_map = uvm_kvmalloc_zero(sizeof(*ext_gpu_map));
+    if (!ext_gpu_map)
+        return NV_ERR_NO_MEMORY;
+
+    ext_gpu_map->node.start = start;
+    ext_gpu_map->node.end = end - 1;
     RB_CLEAR_NODE(&ext_gpu_map->node.rb_node);
     uvm_tracker_init(&ext_gpu_map->tracker);
 
@@ -1109,12 +1234,12 @@ static NV_STATUS uvm_map_external_sparse_on_gpu(uvm_va_range_t *va_range,
     uvm_processor_mask_set_atomic(&va_range->external.mapped_gpus, mapping_gpu->id);
     ext_gpu_map->gpu = mapping_gpu;
 
-    UVM_ASSERT(uvm_va_range_ext_gpu_map(va_range, mapping_gpu, base) == ext_gpu_map);
+    UVM_ASSERT(uvm_va_range_ext_gpu_map(va_range, mapping_gpu, start) == ext_gpu_map);
 
     status = uvm_page_table_range_vec_init(page_tree,
                                            ext_gpu_map->node.start,
                                            uvm_range_tree_node_size(&ext_gpu_map->node),
-                                           UVM_PAGE_SIZE_64K,
+                                           page_size,
                                            UVM_PMM_ALLOC_FLAGS_EVICT,
                                            &ext_gpu_map->pt_range_vec);
     if (status != NV_OK)
@@ -1127,11 +1252,69 @@ static NV_STATUS uvm_map_external_sparse_on_gpu(uvm_va_range_t *va_range,
     if (status != NV_OK)
         goto error;
 
-    uvm_mutex_unlock(&range_tree->lock);
     return NV_OK;
 
 error:
     uvm_ext_gpu_map_destroy(va_range, ext_gpu_map, NULL);
+    return status;
+}
+
+// Sparse PTEs are valid at every level of the page tree, so the mapping is
+// split into runs of the biggest page sizes its alignment allows. Only the
+// unaligned edges use 64K PTEs, and multi-TB mappings only need a few upper
+// level directories. The lower levels of a big page are only allocated once
+// part of it gets mapped or unmapped, see split_sparse_ext_gpu_map_at().
+static NV_STATUS uvm_map_external_sparse_on_gpu(uvm_va_range_t *va_range,
+                                                uvm_gpu_t *mapping_gpu,
+                                                NvU64 base,
+                                                NvU64 length,
+                                                struct list *deferred_free_list)
+{
+    uvm_va_space_t *va_space = va_range->va_space;
+    uvm_ext_gpu_range_tree_t *range_tree = uvm_ext_gpu_range_tree(va_range, mapping_gpu);
+    uvm_gpu_va_space_t *gpu_va_space = uvm_gpu_va_space_get(va_space, mapping_gpu);
+    uvm_ext_gpu_map_t *ext_map, *ext_map_next;
+    uvm_page_tree_t *page_tree;
+    NvU64 end = base + length;
+    NvU64 start;
+    NV_STATUS status;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    if (!uvm_gpu_can_address(mapping_gpu, base, length))
+        return NV_ERR_OUT_OF_RANGE;
+
+    UVM_ASSERT(gpu_va_space);
+
+    page_tree = &gpu_va_space->page_tables;
+
+    uvm_mutex_lock(&range_tree->lock);
+
+    status = uvm_unmap_external_in_range(va_range, mapping_gpu, base, end - 1, deferred_free_list);
+    if (status != NV_OK)
+        goto out;
+
+    for (start = base; start < end;) {
+        NvU32 page_size = sparse_page_size(page_tree, start, end);
+        NvU64 segment_end;
+
+        UVM_ASSERT(page_size >= UVM_PAGE_SIZE_64K);
+
+        segment_end = sparse_segment_end(page_tree, start, end, page_size);
+
+        status = map_external_sparse_segment(va_range, mapping_gpu, page_tree, start, segment_end, page_size);
+        if (status != NV_OK)
+            break;
+
+        start = segment_end;
+    }
+
+    if (status != NV_OK && start > base) {
+        uvm_ext_gpu_map_for_each_in_safe(ext_map, ext_map_next, va_range, mapping_gpu, base, start - 1)
+            uvm_ext_gpu_map_destroy(va_range, ext_map, NULL);
+    }
+
+out:
     uvm_mutex_unlock(&range_tree->lock);
     return status;
 }
@@ -38,6 +38,10 @@ typedef struct
     UvmGpuFormatType format_type;
     UvmGpuFormatElementBits element_bits;
     UvmGpuCompressionType compression_type;
+
+    // Optional PTEs of the whole mapping, starting at map_offset, already
+    // retrieved from RM by the caller. RM is not queried when set.
+    NvU64 *ptes;
 } uvm_map_rm_params_t;
 
 static uvm_ext_gpu_range_tree_t *uvm_ext_gpu_range_tree(uvm_va_range_t *va_range, uvm_gpu_t *gpu)
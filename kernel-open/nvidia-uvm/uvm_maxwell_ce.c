@@ -71,6 +71,13 @@ void uvm_hal_maxwell_ce_semaphore_release(uvm_push_t *push, NvU64 gpu_va, NvU32
        HWCONST(B0B5, LAUNCH_DMA, SEMAPHORE_TYPE, RELEASE_ONE_WORD_SEMAPHORE));
 }
 
+void uvm_hal_maxwell_ce_semaphore_release_64_unsupported(uvm_push_t *push, NvU64 gpu_va, NvU64 payload)
+{
+    uvm_gpu_t *gpu = uvm_push_get_gpu(push);
+
+    UVM_ASSERT_MSG(false, "CE 64-bit semaphore release is not supported on GPU: %s.\n", uvm_gpu_name(gpu));
+}
+
 void uvm_hal_maxwell_ce_semaphore_reduction_inc(uvm_push_t *push, NvU64 gpu_va, NvU32 payload)
 {
     NvU32 flush_value;
@@ -210,6 +217,8 @@ void uvm_hal_maxwell_ce_memcopy(uvm_push_t *push, uvm_gpu_address_t dst, uvm_gpu
 
     gpu->parent->ce_hal->memcopy_patch_src(push, &src);
 
+    push->copy_bytes += size;
+
     launch_dma_src_dst_type = gpu->parent->ce_hal->phys_mode(push, dst, src);
     launch_dma_plc_mode = gpu->parent->ce_hal->plc_mode();
     copy_type_value = gpu->parent->ce_hal->memcopy_copy_type(push, dst, src);
@@ -38,6 +38,7 @@
 #include "uvm_tools.h"
 #include "uvm_migrate.h"
 #include "uvm_migrate_pageable.h"
+#include "uvm_perf_thrashing.h"
 #include "uvm_va_space_mm.h"
 #include "nv_speculation_barrier.h"
 
@@ -1113,3 +1114,615 @@ done:
 
     return status == NV_OK? tracker_status : status;
 }
+
+// Validated range of a UVM_MIGRATE_BATCH call. Ranges are kept sorted by
+// destination and base, so that adjacent entries end up next to each other.
+typedef struct
+{
+    NvU64 base;
+    NvU64 end;
+    uvm_processor_id_t dest_id;
+    uvm_gpu_t *dest_gpu;
+
+    // Lowest index of the entries coalesced into the range
+    NvU32 entry_index;
+} migrate_batch_range_t;
+
+static bool migrate_batch_range_before(const migrate_batch_range_t *a, const migrate_batch_range_t *b)
+{
+    if (!uvm_id_equal(a->dest_id, b->dest_id))
+        return uvm_id_value(a->dest_id) < uvm_id_value(b->dest_id);
+
+    return a->base < b->base;
+}
+
+// Merge ranges with the same destination that overlap or touch. Returns the
+// new number of ranges.
+static NvU32 migrate_batch_coalesce(migrate_batch_range_t *ranges, NvU32 num_ranges)
+{
+    NvU32 i;
+    NvU32 num_coalesced = 1;
+
+    for (i = 1; i < num_ranges; i++) {
+        migrate_batch_range_t *last = &ranges[num_coalesced - 1];
+
+        if (uvm_id_equal(last->dest_id, ranges[i].dest_id) && ranges[i].base <= last->end + 1) {
+            last->end = max(last->end, ranges[i].end);
+            last->entry_index = min(last->entry_index, ranges[i].entry_index);
+            continue;
+        }
+
+        ranges[num_coalesced++] = ranges[i];
+    }
+
+    return num_coalesced;
+}
+
+static bool migrate_batch_range_do_mappings(const migrate_batch_range_t *range, NvU32 migrate_flags)
+{
+    return UVM_ID_IS_GPU(range->dest_id) || !(migrate_flags & UVM_MIGRATE_FLAG_SKIP_CPU_MAP);
+}
+
+static NV_STATUS migrate_batch_range(uvm_va_space_t *va_space,
+                                     uvm_va_block_context_t *va_block_context,
+                                     const migrate_batch_range_t *range,
+                                     uvm_migrate_mode_t mode,
+                                     uvm_migrate_pass_t pass,
+                                     bool is_single_block,
+                                     uvm_tracker_t *out_tracker)
+{
+    // See uvm_migrate()
+    if (!uvm_va_space_processor_has_memory(va_space, range->dest_id))
+        return NV_OK;
+
+    return uvm_migrate_ranges(va_space,
+                              va_block_context,
+                              uvm_va_space_iter_first(va_space, range->base, range->base),
+                              range->base,
+                              range->end - range->base + 1,
+                              range->dest_id,
+                              mode,
+                              migration_should_do_cpu_preunmap(va_space, pass, is_single_block),
+                              out_tracker);
+}
+
+// Same two passes as uvm_migrate(), but each pass covers the whole batch: all
+// ranges are transferred before any of them is mapped, so the copies of
+// different ranges overlap instead of being serialized by the mapping work.
+//
+// Ranges that could not be fully migrated because of non-migratable range
+// groups don't stop the batch; NV_WARN_MORE_PROCESSING_REQUIRED is returned
+// for the first of them once the other ranges are done.
+static NV_STATUS migrate_batch_ranges(uvm_va_space_t *va_space,
+                                      const migrate_batch_range_t *ranges,
+                                      NvU32 num_ranges,
+                                      NvU32 migrate_flags,
+                                      uvm_tracker_t *out_tracker,
+                                      NvU32 *failed_entry_index)
+{
+    uvm_va_block_context_t *va_block_context;
+    NV_STATUS status = NV_OK;
+    NV_STATUS warning = NV_OK;
+    NvU32 warning_entry_index = 0;
+    bool is_single_block;
+    NvU32 i;
+
+    va_block_context = uvm_va_block_context_alloc(NULL);
+    if (!va_block_context)
+        return NV_ERR_NO_MEMORY;
+
+    is_single_block = (num_ranges == 1) &&
+                      is_migration_single_block(uvm_va_space_iter_first(va_space, ranges[0].base, ranges[0].base),
+                                                ranges[0].base,
+                                                ranges[0].end - ranges[0].base + 1);
+
+    for (i = 0; i < num_ranges * 2; i++) {
+        const migrate_batch_range_t *range = &ranges[i % num_ranges];
+        bool do_mappings = migrate_batch_range_do_mappings(range, migrate_flags);
+        bool do_two_passes = do_mappings && !is_single_block;
+        uvm_migrate_mode_t mode;
+        uvm_migrate_pass_t pass;
+
+        if (i < num_ranges) {
+            if (!do_two_passes)
+                continue;
+
+            mode = UVM_MIGRATE_MODE_MAKE_RESIDENT;
+            pass = UVM_MIGRATE_PASS_FIRST;
+        }
+        else {
+            mode = do_mappings ? UVM_MIGRATE_MODE_MAKE_RESIDENT_AND_MAP : UVM_MIGRATE_MODE_MAKE_RESIDENT;
+            pass = do_two_passes ? UVM_MIGRATE_PASS_SECOND : UVM_MIGRATE_PASS_FIRST;
+        }
+
+        status = migrate_batch_range(va_space, va_block_context, range, mode, pass, is_single_block, out_tracker);
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED) {
+            if (warning == NV_OK) {
+                warning = status;
+                warning_entry_index = range->entry_index;
+            }
+            status = NV_OK;
+        }
+        else if (status != NV_OK) {
+            *failed_entry_index = range->entry_index;
+            break;
+        }
+    }
+
+    uvm_va_block_context_free(va_block_context);
+
+    if (status == NV_OK && warning != NV_OK) {
+        *failed_entry_index = warning_entry_index;
+        status = warning;
+    }
+
+    return status;
+}
+
+NV_STATUS uvm_api_migrate_batch(UVM_MIGRATE_BATCH_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_tracker_t *tracker_ptr = NULL;
+    migrate_batch_range_t *ranges;
+    uvm_va_range_t *sema_va_range = NULL;
+    uvm_gpu_t *sema_gpu = NULL;
+    NvU32 num_ranges;
+    NvU32 i;
+    NV_STATUS status = NV_OK;
+    bool flush_events = false;
+    const bool synchronous = !(params->flags & UVM_MIGRATE_FLAG_ASYNC);
+
+    params->failedEntryIndex = 0;
+
+    if (params->numEntries == 0 || params->numEntries > UVM_MIGRATE_BATCH_MAX_ENTRIES)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->flags & ~UVM_MIGRATE_FLAGS_ALL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if ((params->flags & UVM_MIGRATE_FLAGS_TEST_ALL) && !uvm_enable_builtin_tests) {
+        UVM_INFO_PRINT("Test flag set for UVM_MIGRATE_BATCH. Did you mean to insmod with uvm_enable_builtin_tests=1?\n");
+        return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < params->numEntries; i++) {
+        if (uvm_api_range_invalid(params->entries[i].base, params->entries[i].length)) {
+            params->failedEntryIndex = i;
+            return NV_ERR_INVALID_ADDRESS;
+        }
+    }
+
+    ranges = uvm_kvmalloc(sizeof(*ranges) * params->numEntries);
+    if (!ranges)
+        return NV_ERR_NO_MEMORY;
+
+    // mmap_lock will be needed if we have to create CPU mappings
+    uvm_va_space_down_read(va_space);
+
+    if (synchronous) {
+        if (params->semaphoreAddress != 0) {
+            status = NV_ERR_INVALID_ARGUMENT;
+            goto done;
+        }
+    }
+    else {
+        if (params->semaphoreAddress == 0) {
+            if (params->semaphorePayload != 0) {
+                status = NV_ERR_INVALID_ARGUMENT;
+                goto done;
+            }
+        }
+        else {
+            sema_va_range = uvm_va_range_find(va_space, params->semaphoreAddress);
+            if (!IS_ALIGNED(params->semaphoreAddress, sizeof(params->semaphorePayload)) ||
+                    !sema_va_range || sema_va_range->type != UVM_VA_RANGE_TYPE_SEMAPHORE_POOL) {
+                status = NV_ERR_INVALID_ADDRESS;
+                goto done;
+            }
+        }
+    }
+
+    // Resolve the destinations and insertion-sort the ranges as they come,
+    // batches are small.
+    for (i = 0; i < params->numEntries; i++) {
+        const UVM_MIGRATE_BATCH_ENTRY *entry = &params->entries[i];
+        migrate_batch_range_t range;
+        NvU32 pos;
+
+        range.base = entry->base;
+        range.end = entry->base + entry->length - 1;
+        range.entry_index = i;
+        range.dest_gpu = NULL;
+        range.dest_id = UVM_ID_CPU;
+
+        if (!uvm_uuid_is_cpu(&entry->destinationUuid)) {
+            if (params->flags & UVM_MIGRATE_FLAG_NO_GPU_VA_SPACE)
+                range.dest_gpu = uvm_va_space_get_gpu_by_uuid(va_space, &entry->destinationUuid);
+            else
+                range.dest_gpu = uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, &entry->destinationUuid);
+
+            if (!range.dest_gpu) {
+                params->failedEntryIndex = i;
+                status = NV_ERR_INVALID_DEVICE;
+                goto done;
+            }
+
+            if (!uvm_gpu_can_address(range.dest_gpu, entry->base, entry->length)) {
+                params->failedEntryIndex = i;
+                status = NV_ERR_OUT_OF_RANGE;
+                goto done;
+            }
+
+            range.dest_id = range.dest_gpu->id;
+            sema_gpu = range.dest_gpu;
+        }
+
+        for (pos = i; pos > 0 && migrate_batch_range_before(&range, &ranges[pos - 1]); pos--)
+            ranges[pos] = ranges[pos - 1];
+        ranges[pos] = range;
+    }
+
+    num_ranges = migrate_batch_coalesce(ranges, params->numEntries);
+
+    for (i = 0; i < num_ranges; i++) {
+        uvm_api_range_type_t type = uvm_api_range_type_check(va_space,
+                                                             NULL,
+                                                             ranges[i].base,
+                                                             ranges[i].end - ranges[i].base + 1);
+
+        // Pageable memory is only migrated by UVM_MIGRATE, whose
+        // userSpaceStart/userSpaceLength protocol doesn't extend to batches.
+        if (type != UVM_API_RANGE_TYPE_MANAGED) {
+            params->failedEntryIndex = ranges[i].entry_index;
+            status = NV_ERR_INVALID_ADDRESS;
+            goto done;
+        }
+    }
+
+    // If we're synchronous or if we need to release a semaphore, use a tracker.
+    if (synchronous || params->semaphoreAddress)
+        tracker_ptr = &tracker;
+
+    status = migrate_batch_ranges(va_space, ranges, num_ranges, params->flags, tracker_ptr, &params->failedEntryIndex);
+
+done:
+    uvm_up_read_mmap_lock_out_of_order(NULL);
+
+    if (tracker_ptr) {
+        // A single release covers the whole batch
+        if (params->semaphoreAddress && (status == NV_OK)) {
+            status = semaphore_release(params->semaphoreAddress,
+                                       params->semaphorePayload,
+                                       &sema_va_range->semaphore_pool,
+                                       sema_gpu,
+                                       tracker_ptr);
+        }
+
+        // Wait on the tracker if we are synchronous or there was an error. The
+        // VA space lock must be held to prevent GPUs from being unregistered.
+        if (synchronous || (status != NV_OK)) {
+            NV_STATUS tracker_status = uvm_tracker_wait(tracker_ptr);
+
+            // Only clobber status if we didn't hit an earlier error
+            if (status == NV_OK)
+                status = tracker_status;
+
+            flush_events = true;
+        }
+
+        uvm_tracker_deinit(tracker_ptr);
+    }
+
+    uvm_va_space_up_read(va_space);
+
+    uvm_kvfree(ranges);
+
+    if (flush_events)
+        uvm_tools_flush_events();
+
+    return status;
+}
+
+// Bulk range group migration
+//
+// Checkpoint and preemption spill whole range groups to host memory and bring
+// them back, tens of GiBs at a time. UVM_MIGRATE_RANGE_GROUP goes through the
+// generic path, which interleaves allocation, copies, CPU pre-unmaps and
+// mappings block by block and never gets close to the interconnect bandwidth.
+// The bulk path instead walks every block of the group three times:
+//
+// 1- Populate the destination of every block. Allocation and eviction
+//    failures are hit before any data has moved.
+// 2- Push the copies of every block without waiting for any of them. The
+//    channel managers of the VA space are put in bulk mode so the copies are
+//    spread across all the balanced CEs from the start.
+// 3- Re-execute the make resident (in case someone moved pages since the
+//    previous pass) and map the destination. Skipped for the CPU, which maps
+//    spilled pages on first access.
+//
+// Read duplication is not honored, the pages are moved. The thrashing state of
+// each block is dropped once before its copies instead of being reset page by
+// page from the migration events.
+typedef enum
+{
+    MIGRATE_BULK_PASS_POPULATE,
+    MIGRATE_BULK_PASS_COPY,
+    MIGRATE_BULK_PASS_MAP,
+} migrate_bulk_pass_t;
+
+static NV_STATUS migrate_bulk_block_locked(uvm_va_block_t *va_block,
+                                           uvm_va_block_retry_t *va_block_retry,
+                                           uvm_va_block_context_t *va_block_context,
+                                           uvm_va_block_region_t region,
+                                           uvm_processor_id_t dest_id,
+                                           migrate_bulk_pass_t pass,
+                                           uvm_tracker_t *out_tracker,
+                                           NvU64 *bytes_migrated)
+{
+    NV_STATUS status;
+    NV_STATUS tracker_status = NV_OK;
+
+    if (pass == MIGRATE_BULK_PASS_POPULATE)
+        return uvm_va_block_populate_locked(va_block, va_block_retry, va_block_context, dest_id, region);
+
+    if (pass == MIGRATE_BULK_PASS_COPY)
+        uvm_perf_thrashing_info_destroy(va_block);
+
+    uvm_page_mask_zero(&va_block_context->make_resident.pages_changed_residency);
+
+    status = uvm_va_block_make_resident(va_block,
+                                        va_block_retry,
+                                        va_block_context,
+                                        dest_id,
+                                        region,
+                                        NULL,
+                                        NULL,
+                                        UVM_MAKE_RESIDENT_CAUSE_API_MIGRATE);
+    if (status == NV_OK) {
+        *bytes_migrated += uvm_page_mask_region_weight(&va_block_context->make_resident.pages_changed_residency,
+                                                       region) * PAGE_SIZE;
+    }
+
+    if (status == NV_OK && pass == MIGRATE_BULK_PASS_MAP)
+        status = block_migrate_add_mappings(va_block, va_block_retry, va_block_context, region, dest_id);
+
+    if (out_tracker)
+        tracker_status = uvm_tracker_add_tracker_safe(out_tracker, &va_block->tracker);
+
+    return status == NV_OK ? tracker_status : status;
+}
+
+static NV_STATUS migrate_bulk_va_range(uvm_va_range_t *va_range,
+                                       uvm_va_block_context_t *va_block_context,
+                                       NvU64 start,
+                                       NvU64 end,
+                                       uvm_processor_id_t dest_id,
+                                       migrate_bulk_pass_t pass,
+                                       uvm_tracker_t *out_tracker,
+                                       NvU64 *bytes_migrated)
+{
+    size_t i;
+    const size_t first_block_index = uvm_va_range_block_index(va_range, start);
+    const size_t last_block_index = uvm_va_range_block_index(va_range, end);
+
+    for (i = first_block_index; i <= last_block_index; i++) {
+        uvm_va_block_retry_t va_block_retry;
+        uvm_va_block_region_t region;
+        uvm_va_block_t *va_block;
+        NV_STATUS status = uvm_va_range_block_create(va_range, i, &va_block);
+
+        if (status != NV_OK)
+            return status;
+
+        region = uvm_va_block_region_from_start_end(va_block,
+                                                    max(start, va_block->start),
+                                                    min(end, va_block->end));
+
+        status = UVM_VA_BLOCK_LOCK_RETRY(va_block, &va_block_retry,
+                                         migrate_bulk_block_locked(va_block,
+                                                                   &va_block_retry,
+                                                                   va_block_context,
+                                                                   region,
+                                                                   dest_id,
+                                                                   pass,
+                                                                   out_tracker,
+                                                                   bytes_migrated));
+        if (status != NV_OK)
+            return status;
+    }
+
+    return NV_OK;
+}
+
+static NV_STATUS migrate_bulk_range_group(uvm_va_space_t *va_space,
+                                          uvm_range_group_t *range_group,
+                                          uvm_processor_id_t dest_id,
+                                          migrate_bulk_pass_t pass,
+                                          uvm_tracker_t *out_tracker,
+                                          NvU64 *bytes_migrated)
+{
+    uvm_va_block_context_t *va_block_context;
+    uvm_range_group_range_t *rgr;
+    NV_STATUS status = NV_OK;
+
+    va_block_context = uvm_va_block_context_alloc(NULL);
+    if (!va_block_context)
+        return NV_ERR_NO_MEMORY;
+
+    list_for_each_entry(rgr, &range_group->ranges, range_group_list_node) {
+        uvm_va_range_t *va_range;
+        uvm_va_range_t *va_range_last = NULL;
+
+        uvm_for_each_va_range_in_contig_from(va_range,
+                                             va_space,
+                                             uvm_va_space_iter_first(va_space, rgr->node.start, rgr->node.start),
+                                             rgr->node.end) {
+            va_range_last = va_range;
+
+            if (va_range->type != UVM_VA_RANGE_TYPE_MANAGED) {
+                status = NV_ERR_INVALID_ADDRESS;
+                break;
+            }
+
+            // See uvm_migrate_ranges()
+            if (uvm_processor_mask_test(&va_range->uvm_lite_gpus, dest_id) &&
+                !uvm_id_equal(dest_id, uvm_va_range_get_policy(va_range)->preferred_location)) {
+                status = NV_ERR_INVALID_DEVICE;
+                break;
+            }
+
+            status = migrate_bulk_va_range(va_range,
+                                           va_block_context,
+                                           max(rgr->node.start, va_range->node.start),
+                                           min(rgr->node.end, va_range->node.end),
+                                           dest_id,
+                                           pass,
+                                           out_tracker,
+                                           bytes_migrated);
+            if (status != NV_OK)
+                break;
+        }
+
+        if (status == NV_OK && (!va_range_last || va_range_last->node.end < rgr->node.end))
+            status = NV_ERR_INVALID_ADDRESS;
+
+        if (status != NV_OK)
+            break;
+    }
+
+    uvm_va_block_context_free(va_block_context);
+
+    return status;
+}
+
+NV_STATUS uvm_api_migrate_range_group_bulk(UVM_MIGRATE_RANGE_GROUP_BULK_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    uvm_range_group_t *range_group;
+    uvm_range_group_range_t *rgr;
+    uvm_va_range_t *sema_va_range = NULL;
+    uvm_processor_id_t dest_id = UVM_ID_CPU;
+    uvm_gpu_t *dest_gpu = NULL;
+    uvm_gpu_t *gpu;
+    NV_STATUS status = NV_OK;
+    NV_STATUS tracker_status;
+    const bool synchronous = !(params->flags & UVM_MIGRATE_FLAG_ASYNC);
+
+    params->bytesMigrated = 0;
+
+    if (params->flags & ~UVM_MIGRATE_FLAG_ASYNC)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (synchronous && (params->semaphoreAddress != 0 || params->semaphorePayload != 0))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (params->semaphoreAddress == 0 && params->semaphorePayload != 0)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    uvm_va_space_down_read(va_space);
+
+    if (params->semaphoreAddress != 0) {
+        sema_va_range = uvm_va_range_find(va_space, params->semaphoreAddress);
+        if (!IS_ALIGNED(params->semaphoreAddress, sizeof(params->semaphorePayload)) ||
+                !sema_va_range || sema_va_range->type != UVM_VA_RANGE_TYPE_SEMAPHORE_POOL) {
+            status = NV_ERR_INVALID_ADDRESS;
+            goto done;
+        }
+    }
+
+    if (!uvm_uuid_is_cpu(&params->destinationUuid)) {
+        dest_gpu = uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, &params->destinationUuid);
+        if (!dest_gpu) {
+            status = NV_ERR_INVALID_DEVICE;
+            goto done;
+        }
+
+        dest_id = dest_gpu->id;
+    }
+
+    range_group = table_find(va_space->range_groups, pointer_from_u64(params->rangeGroupId));
+    if (!range_group) {
+        status = NV_ERR_OBJECT_NOT_FOUND;
+        goto done;
+    }
+
+    if (!uvm_range_group_migratable(range_group)) {
+        status = NV_ERR_INVALID_STATE;
+        goto done;
+    }
+
+    if (dest_gpu) {
+        list_for_each_entry(rgr, &range_group->ranges, range_group_list_node) {
+            if (!uvm_gpu_can_address(dest_gpu, rgr->node.start, rgr->node.end - rgr->node.start + 1)) {
+                status = NV_ERR_OUT_OF_RANGE;
+                goto done;
+            }
+        }
+    }
+
+    // See uvm_migrate()
+    if (!uvm_va_space_processor_has_memory(va_space, dest_id))
+        goto done;
+
+    status = migrate_bulk_range_group(va_space,
+                                      range_group,
+                                      dest_id,
+                                      MIGRATE_BULK_PASS_POPULATE,
+                                      NULL,
+                                      &params->bytesMigrated);
+    if (status != NV_OK)
+        goto done;
+
+    for_each_va_space_gpu(gpu, va_space)
+        uvm_channel_manager_bulk_begin(gpu->channel_manager);
+
+    status = migrate_bulk_range_group(va_space,
+                                      range_group,
+                                      dest_id,
+                                      MIGRATE_BULK_PASS_COPY,
+                                      &tracker,
+                                      &params->bytesMigrated);
+
+    for_each_va_space_gpu(gpu, va_space)
+        uvm_channel_manager_bulk_end(gpu->channel_manager);
+
+    if (status == NV_OK && dest_gpu) {
+        status = migrate_bulk_range_group(va_space,
+                                          range_group,
+                                          dest_id,
+                                          MIGRATE_BULK_PASS_MAP,
+                                          &tracker,
+                                          &params->bytesMigrated);
+    }
+
+    if (status == NV_OK && params->semaphoreAddress) {
+        status = semaphore_release(params->semaphoreAddress,
+                                   params->semaphorePayload,
+                                   &sema_va_range->semaphore_pool,
+                                   dest_gpu,
+                                   &tracker);
+    }
+
+done:
+    uvm_up_read_mmap_lock_out_of_order(NULL);
+
+    // Wait on the tracker if we are synchronous or there was an error. The VA
+    // space lock must be held to prevent GPUs from being unregistered.
+    if (synchronous || status != NV_OK) {
+        tracker_status = uvm_tracker_wait_deinit(&tracker);
+        if (status == NV_OK)
+            status = tracker_status;
+    }
+    else {
+        uvm_tracker_deinit(&tracker);
+    }
+
+    uvm_va_space_up_read(va_space);
+
+    if (synchronous || status != NV_OK)
+        uvm_tools_flush_events();
+
+    return status;
+}
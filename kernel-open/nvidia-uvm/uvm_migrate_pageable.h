@@ -220,6 +220,10 @@ NV_STATUS uvm_migrate_pageable_init(void);
 void uvm_migrate_pageable_exit(void);
 #else // UVM_MIGRATE_VMA_SUPPORTED
 
+// Without migrate_vma, which is the case on Nanos, pageable memory can't be
+// migrated: the range is only populated and stays resident on the CPU. Callers
+// see NV_WARN_NOTHING_TO_DO and the GPUs access the memory through their
+// system memory mappings, so there is no copy to spread across CEs.
 static NV_STATUS uvm_migrate_pageable(uvm_migrate_args_t *uvm_migrate_args)
 {
     NV_STATUS status;
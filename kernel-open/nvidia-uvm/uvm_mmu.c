@@ -33,6 +33,8 @@
 #include "uvm_push.h"
 #include "uvm_mem.h"
 #include "uvm_va_space.h"
+#include "uvm_rm_mem.h"
+#include "uvm_conf_computing.h"
 
 // The page tree has 6 levels on Hopper+ GPUs, and the root is never freed by a
 // normal 'put' operation which leaves a maximum of 5 levels.
@@ -163,6 +165,235 @@ static NV_STATUS phys_mem_allocate_vidmem(uvm_page_tree_t *tree,
     return status;
 }
 
+// Page directories and tables of this size, in the location used by the
+// GPU's page trees, are taken from the GPU's page table pool when it isn't
+// empty. This is the size of all directories and of the 4K and 2M page tables.
+#define UVM_PAGE_TABLE_POOL_ALLOC_SIZE 4096
+
+// Number of page directory and table allocations kept preallocated per GPU.
+// The pool is refilled when GPU VA spaces are registered and when page tables
+// are pre-populated, so that faults rarely have to allocate page tables from
+// PMM or sysmem. 0 disables the pool.
+static unsigned uvm_page_table_pool_size = 64;
+module_param(uvm_page_table_pool_size, uint, S_IRUGO);
+
+static uvm_aperture_t page_table_pool_location(uvm_gpu_t *gpu)
+{
+    uvm_aperture_t location = uvm_gpu_page_tree_init_location(gpu);
+
+    // Same resolution as in page_tree_set_location, without the sysmem
+    // fallback
+    if (location == UVM_APERTURE_DEFAULT)
+        location = page_table_aperture == UVM_APERTURE_DEFAULT ? UVM_APERTURE_VID : page_table_aperture;
+
+    return location;
+}
+
+static NV_STATUS page_table_pool_alloc_entry(uvm_gpu_t *gpu, uvm_mmu_page_table_alloc_t *out)
+{
+    NV_STATUS status;
+
+    memset(out, 0, sizeof(*out));
+
+    if (gpu->page_table_pool.location == UVM_APERTURE_SYS) {
+        heap h = (heap)heap_physical(get_kernel_heaps());
+        NvU64 dma_addr;
+
+        out->handle.page = allocate_u64(h, UVM_PAGE_TABLE_POOL_ALLOC_SIZE);
+        if (out->handle.page == INVALID_PHYSICAL)
+            return NV_ERR_NO_MEMORY;
+
+        status = uvm_gpu_map_cpu_pages(gpu->parent,
+                                       out->handle.page,
+                                       UVM_PAGE_ALIGN_UP(UVM_PAGE_TABLE_POOL_ALLOC_SIZE),
+                                       &dma_addr);
+        if (status != NV_OK) {
+            deallocate_u64(h, out->handle.page, UVM_PAGE_TABLE_POOL_ALLOC_SIZE);
+            return status;
+        }
+
+        out->addr = uvm_gpu_phys_address(UVM_APERTURE_SYS, dma_addr);
+    }
+    else {
+        uvm_tracker_t local_tracker = UVM_TRACKER_INIT();
+
+        // Don't evict user memory to fill the pool
+        status = uvm_pmm_gpu_alloc_kernel(&gpu->pmm,
+                                          1,
+                                          UVM_PAGE_TABLE_POOL_ALLOC_SIZE,
+                                          UVM_PMM_ALLOC_FLAGS_NONE,
+                                          &out->handle.chunk,
+                                          &local_tracker);
+        if (status != NV_OK)
+            return status;
+
+        // The pool is filled off the fault path, so just wait for the chunk
+        // to be ready.
+        status = uvm_tracker_wait_deinit(&local_tracker);
+        if (status != NV_OK) {
+            uvm_pmm_gpu_free(&gpu->pmm, out->handle.chunk, NULL);
+            return status;
+        }
+
+        out->addr = uvm_gpu_phys_address(UVM_APERTURE_VID, out->handle.chunk->address);
+    }
+
+    out->size = UVM_PAGE_TABLE_POOL_ALLOC_SIZE;
+
+    return NV_OK;
+}
+
+static void page_table_pool_free_entry(uvm_gpu_t *gpu, uvm_mmu_page_table_alloc_t *alloc)
+{
+    if (alloc->addr.aperture == UVM_APERTURE_SYS) {
+        uvm_gpu_unmap_cpu_pages(gpu->parent, alloc->addr.address, UVM_PAGE_ALIGN_UP(alloc->size));
+        deallocate_u64((heap)heap_physical(get_kernel_heaps()), alloc->handle.page, alloc->size);
+    }
+    else {
+        uvm_pmm_gpu_free(&gpu->pmm, alloc->handle.chunk, NULL);
+    }
+}
+
+// Take an allocation of the given size and location from the pool of the
+// tree's GPU, if it has one available
+static bool page_table_pool_get(uvm_page_tree_t *tree,
+                                NvLength size,
+                                uvm_aperture_t location,
+                                uvm_mmu_page_table_alloc_t *out)
+{
+    uvm_gpu_t *gpu = tree->gpu;
+    bool found = false;
+
+    // Fake GPUs from the unit tests have no pool
+    if (gpu->page_table_pool.capacity == 0)
+        return false;
+
+    if (size != UVM_PAGE_TABLE_POOL_ALLOC_SIZE || location != gpu->page_table_pool.location)
+        return false;
+
+    uvm_spin_lock(&gpu->page_table_pool.lock);
+
+    if (gpu->page_table_pool.count > 0) {
+        *out = gpu->page_table_pool.entries[--gpu->page_table_pool.count];
+        found = true;
+    }
+
+    uvm_spin_unlock(&gpu->page_table_pool.lock);
+
+    return found;
+}
+
+// Return an allocation to the pool of the tree's GPU instead of freeing it, if
+// it fits and the pool isn't full. Only allocations which the GPU can no
+// longer be accessing, because the tree has no pending work, can be reused.
+static bool page_table_pool_put(uvm_page_tree_t *tree, uvm_mmu_page_table_alloc_t *alloc)
+{
+    uvm_gpu_t *gpu = tree->gpu;
+    bool added = false;
+
+    uvm_assert_mutex_locked(&tree->lock);
+
+    if (gpu->page_table_pool.capacity == 0)
+        return false;
+
+    if (alloc->size != UVM_PAGE_TABLE_POOL_ALLOC_SIZE || alloc->addr.aperture != gpu->page_table_pool.location)
+        return false;
+
+    if (!uvm_tracker_is_completed(&tree->tracker))
+        return false;
+
+    uvm_spin_lock(&gpu->page_table_pool.lock);
+
+    if (gpu->page_table_pool.entries && gpu->page_table_pool.count < gpu->page_table_pool.capacity) {
+        gpu->page_table_pool.entries[gpu->page_table_pool.count++] = *alloc;
+        added = true;
+    }
+
+    uvm_spin_unlock(&gpu->page_table_pool.lock);
+
+    return added;
+}
+
+void uvm_mmu_page_table_pool_refill(uvm_gpu_t *gpu)
+{
+    if (gpu->page_table_pool.capacity == 0)
+        return;
+
+    while (true) {
+        uvm_mmu_page_table_alloc_t alloc;
+        bool full;
+        bool added = false;
+
+        uvm_spin_lock(&gpu->page_table_pool.lock);
+        full = !gpu->page_table_pool.entries || gpu->page_table_pool.count >= gpu->page_table_pool.capacity;
+        uvm_spin_unlock(&gpu->page_table_pool.lock);
+
+        if (full)
+            break;
+
+        // Refilling is best effort
+        if (page_table_pool_alloc_entry(gpu, &alloc) != NV_OK)
+            break;
+
+        uvm_spin_lock(&gpu->page_table_pool.lock);
+
+        if (gpu->page_table_pool.entries && gpu->page_table_pool.count < gpu->page_table_pool.capacity) {
+            gpu->page_table_pool.entries[gpu->page_table_pool.count++] = alloc;
+            added = true;
+        }
+
+        uvm_spin_unlock(&gpu->page_table_pool.lock);
+
+        if (!added) {
+            page_table_pool_free_entry(gpu, &alloc);
+            break;
+        }
+    }
+}
+
+NV_STATUS uvm_mmu_create_page_table_pool(uvm_gpu_t *gpu)
+{
+    uvm_spin_lock_init(&gpu->page_table_pool.lock, UVM_LOCK_ORDER_LEAF);
+    gpu->page_table_pool.location = page_table_pool_location(gpu);
+    gpu->page_table_pool.count = 0;
+
+    if (uvm_page_table_pool_size == 0)
+        return NV_OK;
+
+    gpu->page_table_pool.entries = uvm_kvmalloc_zero(sizeof(*gpu->page_table_pool.entries) * uvm_page_table_pool_size);
+    if (!gpu->page_table_pool.entries)
+        return NV_ERR_NO_MEMORY;
+
+    gpu->page_table_pool.capacity = uvm_page_table_pool_size;
+
+    uvm_mmu_page_table_pool_refill(gpu);
+
+    return NV_OK;
+}
+
+void uvm_mmu_destroy_page_table_pool(uvm_gpu_t *gpu)
+{
+    uvm_mmu_page_table_alloc_t *entries;
+    NvU32 count;
+    NvU32 i;
+
+    if (gpu->page_table_pool.capacity == 0)
+        return;
+
+    // Page tables freed after this point go back to PMM or sysmem directly
+    uvm_spin_lock(&gpu->page_table_pool.lock);
+    entries = gpu->page_table_pool.entries;
+    count = gpu->page_table_pool.count;
+    gpu->page_table_pool.entries = NULL;
+    gpu->page_table_pool.count = 0;
+    uvm_spin_unlock(&gpu->page_table_pool.lock);
+
+    for (i = 0; i < count; i++)
+        page_table_pool_free_entry(gpu, &entries[i]);
+
+    uvm_kvfree(entries);
+}
+
 static NV_STATUS phys_mem_allocate(uvm_page_tree_t *tree,
                                    NvLength size,
                                    uvm_aperture_t location,
@@ -173,6 +404,9 @@ static NV_STATUS phys_mem_allocate(uvm_page_tree_t *tree,
 
     memset(out, 0, sizeof(*out));
 
+    if (page_table_pool_get(tree, size, location, out))
+        return NV_OK;
+
     if (location == UVM_APERTURE_SYS)
         return phys_mem_allocate_sysmem(tree, size, out);
     else
@@ -207,6 +441,11 @@ static void phys_mem_deallocate_sysmem(uvm_page_tree_t *tree, uvm_mmu_page_table
 
 static void phys_mem_deallocate(uvm_page_tree_t *tree, uvm_mmu_page_table_alloc_t *ptr)
 {
+    if (page_table_pool_put(tree, ptr)) {
+        memset(ptr, 0, sizeof(*ptr));
+        return;
+    }
+
     if (ptr->addr.aperture == UVM_APERTURE_SYS)
         phys_mem_deallocate_sysmem(tree, ptr);
     else
@@ -1962,6 +2201,75 @@ static NV_STATUS uvm_page_table_range_vec_write_ptes_cpu(uvm_page_table_range_ve
     return page_tree_end_and_wait(tree, &push);
 }
 
+// Runs of PTEs at least this large are written into the GPU's PTE staging
+// buffer by the CPU and copied with one CE operation per push, rather than
+// added to the pushbuffer as inline data.
+#define UVM_MMU_PTE_STAGING_MIN_SIZE (16 * 1024)
+#define UVM_MMU_PTE_STAGING_SIZE (512 * 1024)
+
+NV_STATUS uvm_mmu_create_pte_staging(uvm_gpu_t *gpu)
+{
+    atomic64_set(&gpu->pte_staging.in_use, 0);
+
+    // The staging buffer is in unprotected sysmem
+    if (uvm_conf_computing_mode_enabled(gpu))
+        return NV_OK;
+
+    return uvm_rm_mem_alloc_and_map_cpu(gpu,
+                                        UVM_RM_MEM_TYPE_SYS,
+                                        UVM_MMU_PTE_STAGING_SIZE,
+                                        0,
+                                        &gpu->pte_staging.buffer);
+}
+
+void uvm_mmu_destroy_pte_staging(uvm_gpu_t *gpu)
+{
+    UVM_ASSERT(atomic64_read(&gpu->pte_staging.in_use) == 0);
+
+    uvm_rm_mem_free(gpu->pte_staging.buffer);
+    gpu->pte_staging.buffer = NULL;
+}
+
+static bool pte_staging_try_acquire(uvm_gpu_t *gpu)
+{
+    if (!gpu->pte_staging.buffer)
+        return false;
+
+    return atomic64_cmpxchg(&gpu->pte_staging.in_use, 0, 1) == 0;
+}
+
+static void pte_staging_release(uvm_gpu_t *gpu)
+{
+    mb();
+    atomic64_set(&gpu->pte_staging.in_use, 0);
+}
+
+// Write entry_count PTEs starting at *offset into the staging buffer, and
+// advance *offset past them
+static void pte_staging_fill(uvm_page_table_range_vec_t *range_vec,
+                             NvU32 entry_size,
+                             NvU32 entry_count,
+                             NvU64 *offset,
+                             uvm_page_table_range_pte_maker_t pte_maker,
+                             void *caller_data)
+{
+    char *staging = uvm_rm_mem_get_cpu_va(range_vec->tree->gpu->pte_staging.buffer);
+    NvU32 i;
+
+    UVM_ASSERT(entry_size >= sizeof(NvU64));
+
+    for (i = 0; i < entry_count; ++i) {
+        NvU64 pte_bits = pte_maker(range_vec, *offset, caller_data);
+
+        memcpy(staging, &pte_bits, sizeof(pte_bits));
+        if (entry_size > sizeof(pte_bits))
+            memset(staging + sizeof(pte_bits), 0, entry_size - sizeof(pte_bits));
+
+        staging += entry_size;
+        *offset += range_vec->page_size;
+    }
+}
+
 static NV_STATUS uvm_page_table_range_vec_write_ptes_gpu(uvm_page_table_range_vec_t *range_vec,
                                                          uvm_membar_t tlb_membar,
                                                          uvm_page_table_range_pte_maker_t pte_maker,
@@ -1985,9 +2293,18 @@ static NV_STATUS uvm_page_table_range_vec_write_ptes_gpu(uvm_page_table_range_ve
     static const NvU32 max_total_entry_size_per_push = UVM_MAX_PUSH_SIZE - 1024;
 
     NvU32 max_entries_per_push = max_total_entry_size_per_push / entry_size;
+    bool staged = false;
 
     UVM_ASSERT(!uvm_mmu_use_cpu(tree));
 
+    // Skip the staging buffer in unit test mode, as the pushes are not tracked
+    if (tree->gpu->channel_manager &&
+        (range_vec->size / range_vec->page_size) * entry_size >= UVM_MMU_PTE_STAGING_MIN_SIZE)
+        staged = pte_staging_try_acquire(gpu);
+
+    if (staged)
+        max_entries_per_push = UVM_MMU_PTE_STAGING_SIZE / entry_size;
+
     for (i = 0; i < range_vec->range_count; ++i) {
         uvm_page_table_range_t *range = &range_vec->ranges[i];
         NvU64 range_start = range_vec_calc_range_start(range_vec, i);
@@ -1998,6 +2315,20 @@ static NV_STATUS uvm_page_table_range_vec_write_ptes_gpu(uvm_page_table_range_ve
         while (entry < range->entry_count) {
             NvU32 entry_limit_this_push = min(range->entry_count, entry + max_entries_per_push);
 
+            if (staged) {
+                // The previous push may still be reading the staging buffer
+                status = uvm_tracker_wait(&tracker);
+                if (status != NV_OK)
+                    goto done;
+
+                pte_staging_fill(range_vec,
+                                 entry_size,
+                                 entry_limit_this_push - entry,
+                                 &offset,
+                                 pte_maker,
+                                 caller_data);
+            }
+
             // Acquiring the previous push is not necessary for correctness as all
             // the PTE writes can be done independently, but scheduling a lot of
             // independent work for a big range could end up hogging the GPU
@@ -2019,6 +2350,16 @@ static NV_STATUS uvm_page_table_range_vec_write_ptes_gpu(uvm_page_table_range_ve
 
             uvm_pte_batch_begin(&push, &pte_batch);
 
+            if (staged) {
+                uvm_pte_batch_copy_ptes(&pte_batch,
+                                        entry_addr,
+                                        uvm_rm_mem_get_gpu_va(gpu->pte_staging.buffer, gpu, false),
+                                        entry_size,
+                                        entry_limit_this_push - entry);
+                entry_addr.address += (entry_limit_this_push - entry) * entry_size;
+                entry = entry_limit_this_push;
+            }
+
             for (; entry < entry_limit_this_push; ++entry) {
                 NvU64 pte_bits = pte_maker(range_vec, offset, caller_data);
                 uvm_pte_batch_write_pte(&pte_batch, entry_addr, pte_bits, entry_size);
@@ -2061,6 +2402,9 @@ static NV_STATUS uvm_page_table_range_vec_write_ptes_gpu(uvm_page_table_range_ve
 
 done:
     tracker_status = uvm_tracker_wait_deinit(&tracker);
+    if (staged)
+        pte_staging_release(gpu);
+
     if (status == NV_OK)
         status = tracker_status;
     return status;
@@ -2077,6 +2421,94 @@ NV_STATUS uvm_page_table_range_vec_write_ptes(uvm_page_table_range_vec_t *range_
         return uvm_page_table_range_vec_write_ptes_gpu(range_vec, tlb_membar, pte_maker, caller_data);
 }
 
+NV_STATUS uvm_page_table_range_vec_split_pte(uvm_page_table_range_vec_t *range_vec,
+                                             NvU32 page_size,
+                                             uvm_pmm_alloc_flags_t pmm_flags,
+                                             uvm_page_table_range_pte_maker_t pte_maker,
+                                             void *caller_data)
+{
+    NV_STATUS status;
+    uvm_push_t push;
+    uvm_page_tree_t *tree = range_vec->tree;
+    uvm_page_table_range_t *single = &range_vec->ranges[0];
+    uvm_page_table_range_t children;
+    uvm_page_table_range_vec_t children_vec;
+    uvm_membar_t membar_after_write = UVM_MEMBAR_GPU;
+
+    UVM_ASSERT(range_vec->range_count == 1);
+    UVM_ASSERT(single->entry_count == 1);
+    UVM_ASSERT(tree->hal->page_table_depth(page_size) == single->table->depth + 1);
+
+    status = uvm_page_tree_alloc_table(tree, page_size, pmm_flags, single, &children);
+    if (status != NV_OK)
+        return status;
+
+    // The new table is not reachable by the MMU until the PDE is written
+    // below, so its PTEs can be written first without any window in which the
+    // VA is not mapped.
+    children_vec = *range_vec;
+    children_vec.page_size = page_size;
+    children_vec.ranges = &children;
+    status = uvm_page_table_range_vec_write_ptes(&children_vec, UVM_MEMBAR_NONE, pte_maker, caller_data);
+
+    uvm_mutex_lock(&tree->lock);
+
+    if (status == NV_OK && uvm_mmu_use_cpu(tree)) {
+        status = uvm_tracker_wait(&tree->tracker);
+
+        // A CPU membar is needed between the PDE write and the subsequent TLB
+        // invalidate. Work submission guarantees such a membar.
+        if (status == NV_OK)
+            pde_write(tree, single->table, single->start_index, false, NULL);
+    }
+
+    if (status == NV_OK)
+        status = page_tree_begin_acquire(tree,
+                                         &tree->tracker,
+                                         &push,
+                                         "Splitting PTE at [0x%llx, 0x%llx)",
+                                         range_vec->start,
+                                         range_vec->start + range_vec->size);
+
+    // Failures can only come from fatal channel errors, which leave the PTE
+    // unusable anyway.
+    if (status != NV_OK) {
+        uvm_mutex_unlock(&tree->lock);
+        uvm_page_tree_put_ptes(tree, &children);
+        return status;
+    }
+
+    if (!uvm_mmu_use_cpu(tree)) {
+        uvm_push_set_flag(&push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
+        pde_write(tree, single->table, single->start_index, false, &push);
+
+        // See the comments in write_gpu_state_gpu()
+        if (single->table->phys_alloc.addr.aperture == UVM_APERTURE_SYS)
+            membar_after_write = UVM_MEMBAR_SYS;
+
+        uvm_hal_wfi_membar(&push, membar_after_write);
+    }
+
+    // The new PTEs are expected to translate like the PTE they replace, so no
+    // accesses need to be flushed out by the invalidate.
+    tree->gpu->parent->host_hal->tlb_invalidate_all(&push,
+                                                    uvm_page_tree_pdb(tree)->addr,
+                                                    single->table->depth,
+                                                    UVM_MEMBAR_NONE);
+    page_tree_end(tree, &push);
+    page_tree_tracker_overwrite_with_push(tree, &push);
+
+    uvm_mutex_unlock(&tree->lock);
+
+    // The new table holds a reference on the parent directory, so putting the
+    // PTE doesn't clear the PDE that was just written.
+    uvm_page_tree_put_ptes(tree, single);
+    *single = children;
+    range_vec->page_size = page_size;
+
+    return uvm_page_tree_wait(tree);
+}
+
 typedef struct identity_mapping_pte_maker_data_struct
 {
     NvU64 phys_offset;
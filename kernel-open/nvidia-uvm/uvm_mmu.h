@@ -528,6 +528,20 @@ NV_STATUS uvm_page_table_range_vec_write_ptes(uvm_page_table_range_vec_t *range_
                                               uvm_page_table_range_pte_maker_t pte_maker,
                                               void *caller_data);
 
+// Replace the single PTE covered by the range vector with a PDE pointing to a
+// newly allocated table of page_size PTEs, written with the given PTE making
+// function before the PDE, so the VA stays mapped throughout. page_size must
+// be the page size of the level right below the PTE. On success the range
+// vector refers to all the PTEs of the new table.
+//
+// Used to map part of a big page with smaller pages, without unmapping the
+// rest of it.
+NV_STATUS uvm_page_table_range_vec_split_pte(uvm_page_table_range_vec_t *range_vec,
+                                             NvU32 page_size,
+                                             uvm_pmm_alloc_flags_t pmm_flags,
+                                             uvm_page_table_range_pte_maker_t pte_maker,
+                                             void *caller_data);
+
 // Set all PTEs covered by the range vector to an empty PTE
 //
 // After clearing all PTEs a TLB invalidate is performed including the given
@@ -548,6 +562,20 @@ NV_STATUS uvm_mmu_create_flat_mappings(uvm_gpu_t *gpu);
 // Destroy the flat mappings created by uvm_mmu_create_flat_mappings().
 void uvm_mmu_destroy_flat_mappings(uvm_gpu_t *gpu);
 
+// Create or destroy the GPU's PTE staging buffer, see uvm_gpu_t::pte_staging
+NV_STATUS uvm_mmu_create_pte_staging(uvm_gpu_t *gpu);
+void uvm_mmu_destroy_pte_staging(uvm_gpu_t *gpu);
+
+// Create or destroy the GPU's page table pool, see uvm_gpu_t::page_table_pool.
+// Creation fills the pool.
+NV_STATUS uvm_mmu_create_page_table_pool(uvm_gpu_t *gpu);
+void uvm_mmu_destroy_page_table_pool(uvm_gpu_t *gpu);
+
+// Allocate page table memory into the GPU's page table pool until it is full
+// or an allocation fails. This must be called outside of the fault servicing
+// paths, which then find page table memory in the pool.
+void uvm_mmu_page_table_pool_refill(uvm_gpu_t *gpu);
+
 // Returns true if a static flat mapping covering the entire vidmem is required
 // for the given GPU.
 bool uvm_mmu_gpu_needs_static_vidmem_mapping(uvm_gpu_t *gpu);
@@ -17,11 +17,11 @@
 
 #include "nv-kthread-q.h"
 
-#define UVM_THREAD_AFFINITY_SUPPORTED() 0
+#define UVM_THREAD_AFFINITY_SUPPORTED() 1
 
 static inline const struct cpumask *uvm_cpumask_of_node(int node)
 {
-    return NULL;
+    return nv_cpumask_of_node(node);
 }
 
 #define BITS_PER_LONG   64
@@ -51,6 +51,13 @@ typedef unsigned long uintptr_t;
 #define cancel_delayed_work(dwork)  remove_timer(kernel_timers, dwork, 0)
 #define cancel_delayed_work_sync    cancel_delayed_work
 
+//
+// Nanos has no mm_struct and its vmap layer has no change notification that
+// a klib can subscribe to, so UVM cannot learn about CPU-side unmap, mprotect
+// or remap of a range. Until the kernel grows such a hook, pageable memory
+// stays pinned for the duration of each operation, and the
+// uvm_va_space_mm/HMM paths stay compiled out.
+//
 #define UVM_IS_CONFIG_HMM() 0
 
 #define UVM_CAN_USE_MMU_NOTIFIERS() 0
@@ -254,19 +261,33 @@ static inline boolean __test_and_clear_bit(u64 bit, unsigned long *addr)
          (bit) < (size);                                        \
          (bit) = find_next_zero_bit((addr), (size), (bit) + 1))
 
+// Mask of the bits of the word at index 'word' that fall in [start, end)
+static inline unsigned long bitmap_range_word_mask(unsigned int word, unsigned int start, unsigned int end)
+{
+    unsigned long mask = ~0ul;
+
+    if (start > (word << 6))
+        mask &= ~MASK(start & 63);
+    if (end < ((word + 1) << 6))
+        mask &= MASK(end & 63);
+    return mask;
+}
+
 static inline void bitmap_set_bits(unsigned long *map, unsigned int start, int len)
 {
-    unsigned int index = start;
-    for_each_clear_bit_from(index, map, start + len)
-        __set_bit(index, map);
+    unsigned int end = start + len;
+
+    for (unsigned int word = start >> 6; (word << 6) < end; word++)
+        map[word] |= bitmap_range_word_mask(word, start, end);
 }
 #define bitmap_set  bitmap_set_bits
 
 static inline void bitmap_clear(unsigned long *map, unsigned int start, int len)
 {
-    unsigned int index = start;
-    for_each_set_bit_from(index, map, start + len)
-        __clear_bit(index, map);
+    unsigned int end = start + len;
+
+    for (unsigned int word = start >> 6; (word << 6) < end; word++)
+        map[word] &= ~bitmap_range_word_mask(word, start, end);
 }
 
 static inline void bitmap_zero(unsigned long *map, unsigned int nbits)
@@ -377,6 +398,35 @@ static inline boolean bitmap_andnot(unsigned long *dst, const unsigned long *src
     return (result != 0);
 }
 
+// Same as bitmap_and() and bitmap_andnot(), but return the weight of dst
+static inline int bitmap_and_weight(unsigned long *dst, const unsigned long *src1,
+                                    const unsigned long *src2, unsigned int nbits)
+{
+    int w = 0;
+
+    while (nbits >= 64) {
+        w += __builtin_popcountll(*(dst++) = *(src1++) & *(src2++));
+        nbits -= 64;
+    }
+    if (nbits)
+        w += __builtin_popcountll(*dst = *src1 & *src2 & MASK(nbits));
+    return w;
+}
+
+static inline int bitmap_andnot_weight(unsigned long *dst, const unsigned long *src1,
+                                       const unsigned long *src2, unsigned int nbits)
+{
+    int w = 0;
+
+    while (nbits >= 64) {
+        w += __builtin_popcountll(*(dst++) = *(src1++) & ~(*(src2++)));
+        nbits -= 64;
+    }
+    if (nbits)
+        w += __builtin_popcountll(*dst = *src1 & ~(*src2) & MASK(nbits));
+    return w;
+}
+
 static inline void bitmap_xor(unsigned long *dst, const unsigned long *src1,
                               const unsigned long *src2, unsigned int nbits)
 {
@@ -434,20 +484,21 @@ static inline int bitmap_weight(const unsigned long *src, unsigned int nbits)
     int w = 0;
 
     while (nbits >= 64) {
-        unsigned long map = *src++;
-
-        for (unsigned int i = 0; i < 64; i++)
-            if (map & U64_FROM_BIT(i))
-                w++;
+        w += __builtin_popcountll(*src++);
         nbits -= 64;
     }
-    if (nbits) {
-        unsigned long map = *src;
+    if (nbits)
+        w += __builtin_popcountll(*src & MASK(nbits));
+    return w;
+}
 
-        for (unsigned int i = 0; i < nbits; i++)
-            if (map & U64_FROM_BIT(i))
-                w++;
-    }
+// Weight of the bits in [start, end)
+static inline int bitmap_weight_range(const unsigned long *src, unsigned int start, unsigned int end)
+{
+    int w = 0;
+
+    for (unsigned int word = start >> 6; (word << 6) < end; word++)
+        w += __builtin_popcountll(src[word] & bitmap_range_word_mask(word, start, end));
     return w;
 }
 
@@ -458,22 +509,12 @@ static inline u64 hash_64(u64 input)
 
 static inline unsigned int hweight32(u32 val)
 {
-    unsigned int w = 0;
-
-    for (unsigned int i = 0; i < 32; i++)
-        if (val & U64_FROM_BIT(i))
-            w++;
-    return w;
+    return __builtin_popcount(val);
 }
 
 static inline unsigned int hweight_long(long val)
 {
-    unsigned int w = 0;
-
-    for (unsigned int i = 0; i < 64; i++)
-        if (val & U64_FROM_BIT(i))
-            w++;
-    return w;
+    return __builtin_popcountll(val);
 }
 
 static inline boolean sort(void **elems, u64 num, boolean(*sort_fn)(void *, void *))
@@ -0,0 +1,440 @@
+/*******************************************************************************
+    Copyright (c) 2023 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_api.h"
+#include "uvm_channel.h"
+#include "uvm_conf_computing.h"
+#include "uvm_global.h"
+#include "uvm_gpu.h"
+#include "uvm_hal.h"
+#include "uvm_mem.h"
+#include "uvm_mmu.h"
+#include "uvm_pmm_gpu.h"
+#include "uvm_push.h"
+#include "uvm_test.h"
+#include "uvm_test_rng.h"
+#include "uvm_tracker.h"
+#include "uvm_va_block.h"
+#include "uvm_va_space.h"
+
+#define PERF_BENCHMARK_DEFAULT_ITERATIONS 64
+#define PERF_BENCHMARK_MAX_ITERATIONS 4096
+
+// Stride, in pages, of UVM_TEST_PERF_BENCHMARK_FAULT_STRIDED
+#define PERF_BENCHMARK_FAULT_STRIDE 16
+
+static NvU64 perf_benchmark_rate(NvU64 count, NvU64 elapsed_ns)
+{
+    return count * 1000000000ull / (elapsed_ns ? elapsed_ns : 1);
+}
+
+static NV_STATUS benchmark_push_round_trip(uvm_gpu_t *gpu,
+                                           NvU32 iterations,
+                                           bool tlb_invalidate,
+                                           NvU64 *avg_ns,
+                                           NvU64 *min_ns)
+{
+    uvm_page_tree_t *tree = &gpu->address_space_tree;
+    NvU64 total_ns = 0;
+    NvU64 best_ns = ~0ull;
+    NvU32 i;
+
+    for (i = 0; i < iterations; i++) {
+        uvm_push_t push;
+        NvU64 start = NV_GETTIME();
+        NvU64 elapsed_ns;
+
+        TEST_NV_CHECK_RET(uvm_push_begin(gpu->channel_manager,
+                                         UVM_CHANNEL_TYPE_MEMOPS,
+                                         &push,
+                                         "Benchmark push round-trip, TLB invalidate %d",
+                                         tlb_invalidate));
+
+        if (tlb_invalidate) {
+            gpu->parent->host_hal->tlb_invalidate_all(&push,
+                                                      uvm_page_tree_pdb(tree)->addr,
+                                                      tree->hal->page_table_depth(UVM_PAGE_SIZE_4K),
+                                                      UVM_MEMBAR_NONE);
+        }
+
+        TEST_NV_CHECK_RET(uvm_push_end_and_wait(&push));
+
+        elapsed_ns = NV_GETTIME() - start;
+        total_ns += elapsed_ns;
+        best_ns = min(best_ns, elapsed_ns);
+    }
+
+    *avg_ns = total_ns / iterations;
+    if (min_ns)
+        *min_ns = best_ns;
+
+    return NV_OK;
+}
+
+static NV_STATUS benchmark_copy(uvm_gpu_t *gpu,
+                                uvm_channel_type_t channel_type,
+                                uvm_gpu_address_t dst,
+                                uvm_gpu_address_t src,
+                                size_t size,
+                                NvU32 iterations,
+                                NvU64 *mbps)
+{
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    NvU64 start = NV_GETTIME();
+    NV_STATUS status = NV_OK;
+    NvU32 i;
+
+    // Pushes are not waited on individually, so that they can spread over all
+    // channels of the type
+    for (i = 0; i < iterations; i++) {
+        uvm_push_t push;
+
+        status = uvm_push_begin(gpu->channel_manager,
+                                channel_type,
+                                &push,
+                                "Benchmark %s copy, %zu bytes",
+                                uvm_channel_type_to_string(channel_type),
+                                size);
+        if (status != NV_OK)
+            break;
+
+        gpu->parent->ce_hal->memcopy(&push, dst, src, size);
+
+        uvm_push_end(&push);
+
+        status = uvm_tracker_add_push_safe(&tracker, &push);
+        if (status != NV_OK)
+            break;
+    }
+
+    if (status == NV_OK)
+        status = uvm_tracker_wait_deinit(&tracker);
+    else
+        uvm_tracker_wait_deinit(&tracker);
+
+    TEST_NV_CHECK_RET(status);
+
+    // Bytes per microsecond are decimal megabytes per second
+    *mbps = perf_benchmark_rate((NvU64)size * iterations, NV_GETTIME() - start) / 1000000;
+
+    return NV_OK;
+}
+
+static NV_STATUS benchmark_copies(uvm_gpu_t *gpu, NvU32 iterations, UVM_TEST_PERF_BENCHMARK_PARAMS *params)
+{
+    static const size_t sizes[UVM_TEST_PERF_BENCHMARK_COPY_SIZES] =
+    {
+        UVM_PAGE_SIZE_4K,
+        UVM_PAGE_SIZE_64K,
+        UVM_PAGE_SIZE_2M
+    };
+    uvm_mem_t *sys_mem = NULL;
+    uvm_mem_t *vid_mem[2] = { NULL, NULL };
+    uvm_gpu_address_t sys_addr;
+    uvm_gpu_address_t vid_addr[2];
+    NV_STATUS status = NV_OK;
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(sizes); i++)
+        params->copy_sizes[i] = sizes[i];
+
+    // CE can't access unprotected sysmem without encryption when Confidential
+    // Computing is enabled
+    if (uvm_conf_computing_mode_enabled(gpu))
+        return NV_OK;
+
+    TEST_NV_CHECK_GOTO(uvm_mem_alloc_sysmem(UVM_PAGE_SIZE_2M, NULL, &sys_mem), done);
+    TEST_NV_CHECK_GOTO(uvm_mem_map_gpu_kernel(sys_mem, gpu), done);
+    sys_addr = uvm_mem_gpu_address_virtual_kernel(sys_mem, gpu);
+
+    for (i = 0; i < ARRAY_SIZE(vid_mem); i++) {
+        TEST_NV_CHECK_GOTO(uvm_mem_alloc_vidmem(UVM_PAGE_SIZE_2M, gpu, &vid_mem[i]), done);
+        TEST_NV_CHECK_GOTO(uvm_mem_map_gpu_kernel(vid_mem[i], gpu), done);
+        vid_addr[i] = uvm_mem_gpu_address_virtual_kernel(vid_mem[i], gpu);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+        TEST_NV_CHECK_GOTO(benchmark_copy(gpu,
+                                          UVM_CHANNEL_TYPE_CPU_TO_GPU,
+                                          vid_addr[0],
+                                          sys_addr,
+                                          sizes[i],
+                                          iterations,
+                                          &params->copy_mbps[UVM_TEST_PERF_BENCHMARK_COPY_CPU_TO_GPU][i]),
+                           done);
+        TEST_NV_CHECK_GOTO(benchmark_copy(gpu,
+                                          UVM_CHANNEL_TYPE_GPU_TO_CPU,
+                                          sys_addr,
+                                          vid_addr[0],
+                                          sizes[i],
+                                          iterations,
+                                          &params->copy_mbps[UVM_TEST_PERF_BENCHMARK_COPY_GPU_TO_CPU][i]),
+                           done);
+        TEST_NV_CHECK_GOTO(benchmark_copy(gpu,
+                                          UVM_CHANNEL_TYPE_GPU_INTERNAL,
+                                          vid_addr[1],
+                                          vid_addr[0],
+                                          sizes[i],
+                                          iterations,
+                                          &params->copy_mbps[UVM_TEST_PERF_BENCHMARK_COPY_GPU_INTERNAL][i]),
+                           done);
+    }
+
+done:
+    for (i = 0; i < ARRAY_SIZE(vid_mem); i++)
+        uvm_mem_free(vid_mem[i]);
+    uvm_mem_free(sys_mem);
+
+    return status;
+}
+
+static NV_STATUS benchmark_pmm(uvm_gpu_t *gpu, uvm_chunk_size_t chunk_size, NvU32 iterations, NvU64 *per_sec)
+{
+    NvU64 start = NV_GETTIME();
+    NvU32 i;
+
+    for (i = 0; i < iterations; i++) {
+        uvm_gpu_chunk_t *chunk;
+
+        TEST_NV_CHECK_RET(uvm_pmm_gpu_alloc_kernel(&gpu->pmm, 1, chunk_size, UVM_PMM_ALLOC_FLAGS_NONE, &chunk, NULL));
+        uvm_pmm_gpu_free(&gpu->pmm, chunk, NULL);
+    }
+
+    *per_sec = perf_benchmark_rate(iterations, NV_GETTIME() - start);
+
+    return NV_OK;
+}
+
+// Migrate [start, end] to dest_id block by block, like UvmMigrate does
+static NV_STATUS benchmark_migrate(uvm_va_space_t *va_space,
+                                   uvm_va_block_context_t *block_context,
+                                   NvU64 start,
+                                   NvU64 end,
+                                   uvm_processor_id_t dest_id,
+                                   uvm_migrate_mode_t mode,
+                                   uvm_tracker_t *tracker)
+{
+    while (true) {
+        uvm_va_block_retry_t va_block_retry;
+        uvm_va_block_region_t region;
+        uvm_va_block_t *va_block;
+        NV_STATUS status;
+
+        status = uvm_va_block_find_create_managed(va_space, start, &va_block);
+        if (status != NV_OK)
+            return status;
+
+        region = uvm_va_block_region_from_start_end(va_block, start, min(end, va_block->end));
+
+        status = UVM_VA_BLOCK_LOCK_RETRY(va_block, &va_block_retry,
+                                         uvm_va_block_migrate_locked(va_block,
+                                                                     &va_block_retry,
+                                                                     block_context,
+                                                                     region,
+                                                                     dest_id,
+                                                                     mode,
+                                                                     tracker));
+        if (status != NV_OK)
+            return status;
+
+        if (va_block->end >= end)
+            return NV_OK;
+
+        start = va_block->end + 1;
+    }
+}
+
+static NvU64 gcd64(NvU64 a, NvU64 b)
+{
+    while (b) {
+        NvU64 t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+// Index of the page to service after page_index in the given pattern. Starting
+// from the first page of the pattern, num_pages calls visit every page exactly
+// once.
+static NvU64 fault_pattern_next(NvU32 pattern, NvU64 page_index, NvU64 num_pages, NvU64 random_stride)
+{
+    switch (pattern) {
+        case UVM_TEST_PERF_BENCHMARK_FAULT_STRIDED:
+            if (page_index + PERF_BENCHMARK_FAULT_STRIDE < num_pages)
+                return page_index + PERF_BENCHMARK_FAULT_STRIDE;
+            return page_index % PERF_BENCHMARK_FAULT_STRIDE + 1;
+        case UVM_TEST_PERF_BENCHMARK_FAULT_RANDOM:
+            return (page_index + random_stride) % num_pages;
+        default:
+            return page_index + 1;
+    }
+}
+
+static NV_STATUS benchmark_faults(uvm_va_space_t *va_space, uvm_gpu_t *gpu, UVM_TEST_PERF_BENCHMARK_PARAMS *params)
+{
+    uvm_va_block_context_t *block_context;
+    uvm_tracker_t tracker = UVM_TRACKER_INIT();
+    NvU64 num_pages = params->fault_length / PAGE_SIZE;
+    NvU64 end = params->fault_base + params->fault_length - 1;
+    NvU64 random_stride;
+    NvU64 random_first;
+    uvm_test_rng_t rng;
+    NV_STATUS status = NV_OK;
+    NvU32 pattern;
+
+    if (!PAGE_ALIGNED(params->fault_base) || !PAGE_ALIGNED(params->fault_length))
+        return NV_ERR_INVALID_ADDRESS;
+
+    block_context = uvm_va_block_context_alloc(NULL);
+    if (!block_context)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_test_rng_init(&rng, params->seed);
+
+    // Stepping with a stride coprime to the page count, wrapping around,
+    // visits every page exactly once
+    random_stride = uvm_test_rng_range_64(&rng, 1, num_pages);
+    while (gcd64(random_stride, num_pages) != 1)
+        random_stride++;
+    random_first = uvm_test_rng_range_64(&rng, 0, num_pages - 1);
+
+    for (pattern = 0; pattern < UVM_TEST_PERF_BENCHMARK_FAULT_PATTERNS; pattern++) {
+        NvU64 page_index = pattern == UVM_TEST_PERF_BENCHMARK_FAULT_RANDOM ? random_first : 0;
+        NvU64 start;
+        NvU64 i;
+
+        // Start each pattern with the whole range resident on the CPU and
+        // unmapped from the GPU
+        status = benchmark_migrate(va_space,
+                                   block_context,
+                                   params->fault_base,
+                                   end,
+                                   UVM_ID_CPU,
+                                   UVM_MIGRATE_MODE_MAKE_RESIDENT,
+                                   &tracker);
+        if (status == NV_OK)
+            status = uvm_tracker_wait(&tracker);
+        if (status != NV_OK)
+            break;
+
+        start = NV_GETTIME();
+
+        for (i = 0; i < num_pages; i++) {
+            NvU64 addr = params->fault_base + page_index * PAGE_SIZE;
+
+            status = benchmark_migrate(va_space,
+                                       block_context,
+                                       addr,
+                                       addr + PAGE_SIZE - 1,
+                                       gpu->id,
+                                       UVM_MIGRATE_MODE_MAKE_RESIDENT_AND_MAP,
+                                       &tracker);
+            if (status != NV_OK)
+                break;
+
+            page_index = fault_pattern_next(pattern, page_index, num_pages, random_stride);
+        }
+
+        if (status == NV_OK)
+            status = uvm_tracker_wait(&tracker);
+        if (status != NV_OK)
+            break;
+
+        params->fault_pages_per_sec[pattern] = perf_benchmark_rate(num_pages, NV_GETTIME() - start);
+    }
+
+    uvm_tracker_wait_deinit(&tracker);
+    uvm_va_block_context_free(block_context);
+
+    return status;
+}
+
+NV_STATUS uvm_test_perf_benchmark(UVM_TEST_PERF_BENCHMARK_PARAMS *params, struct file *filp)
+{
+    static const uvm_chunk_size_t pmm_sizes[UVM_TEST_PERF_BENCHMARK_PMM_SIZES] =
+    {
+        UVM_CHUNK_SIZE_4K,
+        UVM_CHUNK_SIZE_2M
+    };
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    NvU32 iterations = params->iterations ? params->iterations : PERF_BENCHMARK_DEFAULT_ITERATIONS;
+    NvU64 tlb_push_ns;
+    uvm_gpu_t *gpu;
+    NV_STATUS status;
+    size_t i;
+
+    iterations = min(iterations, (NvU32)PERF_BENCHMARK_MAX_ITERATIONS);
+
+    uvm_va_space_down_read_rm(va_space);
+
+    if (params->fault_length)
+        gpu = uvm_va_space_get_gpu_by_uuid_with_gpu_va_space(va_space, &params->gpu_uuid);
+    else
+        gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->gpu_uuid);
+
+    if (!gpu) {
+        status = NV_ERR_INVALID_DEVICE;
+        goto done;
+    }
+
+    // The first round warms up the channels
+    status = benchmark_push_round_trip(gpu, iterations, false, &params->push_round_trip_ns, NULL);
+    if (status != NV_OK)
+        goto done;
+
+    status = benchmark_push_round_trip(gpu,
+                                       iterations,
+                                       false,
+                                       &params->push_round_trip_ns,
+                                       &params->push_round_trip_min_ns);
+    if (status != NV_OK)
+        goto done;
+
+    status = benchmark_push_round_trip(gpu, iterations, true, &tlb_push_ns, NULL);
+    if (status != NV_OK)
+        goto done;
+
+    params->tlb_invalidate_ns = tlb_push_ns > params->push_round_trip_ns ? tlb_push_ns - params->push_round_trip_ns : 0;
+
+    status = benchmark_copies(gpu, iterations, params);
+    if (status != NV_OK)
+        goto done;
+
+    for (i = 0; i < ARRAY_SIZE(pmm_sizes); i++) {
+        params->pmm_chunk_sizes[i] = pmm_sizes[i];
+
+        status = benchmark_pmm(gpu, pmm_sizes[i], iterations, &params->pmm_alloc_free_per_sec[i]);
+        if (status != NV_OK)
+            goto done;
+    }
+
+    if (params->fault_length)
+        status = benchmark_faults(va_space, gpu, params);
+
+done:
+    uvm_va_space_up_read_rm(va_space);
+
+    return status;
+}
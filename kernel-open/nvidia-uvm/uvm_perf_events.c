@@ -76,6 +76,8 @@ NV_STATUS uvm_perf_register_event_callback_locked(uvm_perf_va_space_events_t *va
     callback_desc->callback = callback;
     list_add_tail(&callback_desc->callback_list_node, callback_list);
 
+    UVM_WRITE_ONCE(va_space_events->active_events, va_space_events->active_events | (1u << event_id));
+
     return NV_OK;
 }
 
@@ -110,6 +112,9 @@ void uvm_perf_unregister_event_callback_locked(uvm_perf_va_space_events_t *va_sp
 
     list_del(&callback_desc->callback_list_node);
 
+    if (list_empty(callback_list))
+        UVM_WRITE_ONCE(va_space_events->active_events, va_space_events->active_events & ~(1u << event_id));
+
     kmem_cache_free(g_callback_desc_cache, callback_desc);
 }
 
@@ -121,8 +126,8 @@ void uvm_perf_unregister_event_callback(uvm_perf_va_space_events_t *va_space_eve
     uvm_up_write(&va_space_events->lock);
 }
 
-void uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
-                           uvm_perf_event_data_t *event_data)
+void __uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
+                             uvm_perf_event_data_t *event_data)
 {
     callback_desc_t *callback_desc;
     struct list *callback_list;
@@ -161,12 +166,15 @@ NV_STATUS uvm_perf_init_va_space_events(uvm_va_space_t *va_space, uvm_perf_va_sp
 {
     unsigned event_id;
 
+    BUILD_BUG_ON(UVM_PERF_EVENT_COUNT > 8 * sizeof(va_space_events->active_events));
+
     uvm_init_rwsem(&va_space_events->lock, UVM_LOCK_ORDER_VA_SPACE_EVENTS);
 
     // Initialize event callback lists
     for (event_id = 0; event_id < UVM_PERF_EVENT_COUNT; ++event_id)
         INIT_LIST_HEAD(&va_space_events->event_callbacks[event_id]);
 
+    va_space_events->active_events = 0;
     va_space_events->va_space = va_space;
 
     return NV_OK;
@@ -194,6 +202,7 @@ void uvm_perf_destroy_va_space_events(uvm_perf_va_space_events_t *va_space_event
         }
     }
 
+    UVM_WRITE_ONCE(va_space_events->active_events, 0);
     va_space_events->va_space = NULL;
 }
 
@@ -230,6 +230,12 @@ typedef struct
     // Array of callbacks for event notification
     struct list event_callbacks[UVM_PERF_EVENT_COUNT];
 
+    // Mask of the events with at least one registered callback, one bit per
+    // uvm_perf_event_t. Only updated with the lock held in write mode, but read
+    // without the lock by uvm_perf_event_notify() so that notifying an event
+    // without callbacks costs a single branch.
+    NvU32 active_events;
+
     uvm_va_space_t *va_space;
 } uvm_perf_va_space_events_t;
 
@@ -258,10 +264,26 @@ void uvm_perf_unregister_event_callback(uvm_perf_va_space_events_t *va_space_eve
 void uvm_perf_unregister_event_callback_locked(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
                                                uvm_perf_event_callback_t callback);
 
+// Returns whether any callback is registered for the given event. This doesn't
+// take the va_space_events lock, so a callback being registered or unregistered
+// concurrently may or may not be reflected.
+static inline bool uvm_perf_event_is_active(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id)
+{
+    return (UVM_READ_ONCE(va_space_events->active_events) & (1u << event_id)) != 0;
+}
+
+void __uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
+                             uvm_perf_event_data_t *event_data);
+
 // Invoke the callbacks registered for the given event. Callbacks cannot fail.
-// Acquires the va_space_events lock internally
-void uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
-                           uvm_perf_event_data_t *event_data);
+// Acquires the va_space_events lock internally, unless no callback is
+// registered for the event.
+static inline void uvm_perf_event_notify(uvm_perf_va_space_events_t *va_space_events, uvm_perf_event_t event_id,
+                                         uvm_perf_event_data_t *event_data)
+{
+    if (uvm_perf_event_is_active(va_space_events, event_id))
+        __uvm_perf_event_notify(va_space_events, event_id, event_data);
+}
 
 // Checks if the given callback is already registered for the event.
 // va_space_events.lock must be held in either mode by the caller.
@@ -285,7 +307,12 @@ static inline void uvm_perf_event_notify_migration(uvm_perf_va_space_events_t *v
                                                    uvm_make_resident_cause_t cause,
                                                    uvm_make_resident_context_t *make_resident_context)
 {
-    uvm_perf_event_data_t event_data =
+    uvm_perf_event_data_t event_data;
+
+    if (!uvm_perf_event_is_active(va_space_events, UVM_PERF_EVENT_MIGRATION))
+        return;
+
+    event_data = (uvm_perf_event_data_t)
         {
             .migration =
                 {
@@ -301,7 +328,7 @@ static inline void uvm_perf_event_notify_migration(uvm_perf_va_space_events_t *v
                 }
         };
 
-    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_MIGRATION, &event_data);
+    __uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_MIGRATION, &event_data);
 }
 
 // Helper to notify gpu fault events
@@ -313,7 +340,12 @@ static inline void uvm_perf_event_notify_gpu_fault(uvm_perf_va_space_events_t *v
                                                    NvU32 batch_id,
                                                    bool is_duplicate)
 {
-    uvm_perf_event_data_t event_data =
+    uvm_perf_event_data_t event_data;
+
+    if (!uvm_perf_event_is_active(va_space_events, UVM_PERF_EVENT_FAULT))
+        return;
+
+    event_data = (uvm_perf_event_data_t)
         {
             .fault =
                 {
@@ -328,7 +360,7 @@ static inline void uvm_perf_event_notify_gpu_fault(uvm_perf_va_space_events_t *v
     event_data.fault.gpu.batch_id     = batch_id;
     event_data.fault.gpu.is_duplicate = is_duplicate;
 
-    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
+    __uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
 }
 
 // Helper to notify cpu fault events
@@ -339,7 +371,12 @@ static inline void uvm_perf_event_notify_cpu_fault(uvm_perf_va_space_events_t *v
                                                    bool is_write,
                                                    NvU64 pc)
 {
-    uvm_perf_event_data_t event_data =
+    uvm_perf_event_data_t event_data;
+
+    if (!uvm_perf_event_is_active(va_space_events, UVM_PERF_EVENT_FAULT))
+        return;
+
+    event_data = (uvm_perf_event_data_t)
         {
             .fault =
                 {
@@ -354,7 +391,7 @@ static inline void uvm_perf_event_notify_cpu_fault(uvm_perf_va_space_events_t *v
      event_data.fault.cpu.is_write = is_write,
      event_data.fault.cpu.pc       = pc,
 
-    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
+    __uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_FAULT, &event_data);
 }
 
 // Helper to notify permission revocation
@@ -366,7 +403,12 @@ static inline void uvm_perf_event_notify_revocation(uvm_perf_va_space_events_t *
                                                     uvm_prot_t old_prot,
                                                     uvm_prot_t new_prot)
 {
-    uvm_perf_event_data_t event_data =
+    uvm_perf_event_data_t event_data;
+
+    if (!uvm_perf_event_is_active(va_space_events, UVM_PERF_EVENT_REVOCATION))
+        return;
+
+    event_data = (uvm_perf_event_data_t)
         {
             .revocation =
                 {
@@ -379,7 +421,7 @@ static inline void uvm_perf_event_notify_revocation(uvm_perf_va_space_events_t *
                 }
         };
 
-    uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_REVOCATION, &event_data);
+    __uvm_perf_event_notify(va_space_events, UVM_PERF_EVENT_REVOCATION, &event_data);
 }
 
 #endif
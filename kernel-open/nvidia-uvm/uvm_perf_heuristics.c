@@ -25,6 +25,7 @@
 #include "uvm_perf_heuristics.h"
 #include "uvm_perf_thrashing.h"
 #include "uvm_perf_prefetch.h"
+#include "uvm_perf_tunables.h"
 #include "uvm_gpu_access_counters.h"
 #include "uvm_va_space.h"
 
@@ -44,6 +45,8 @@ NV_STATUS uvm_perf_heuristics_init(void)
     if (status != NV_OK)
         return status;
 
+    uvm_perf_tunables_init();
+
     return NV_OK;
 }
 
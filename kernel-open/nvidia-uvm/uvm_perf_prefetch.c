@@ -28,7 +28,10 @@
 #include "uvm_kvmalloc.h"
 #include "uvm_va_block.h"
 #include "uvm_va_range.h"
+#include "uvm_va_space.h"
+#include "uvm_range_group.h"
 #include "uvm_test.h"
+#include "uvm_perf_tunables.h"
 
 //
 // Tunables for prefetch detection/prevention (configurable via module parameters)
@@ -54,14 +57,40 @@ static unsigned uvm_perf_prefetch_threshold  = UVM_PREFETCH_THRESHOLD_DEFAULT;
 // logic
 static unsigned uvm_perf_prefetch_min_faults = UVM_PREFETCH_MIN_FAULTS_DEFAULT;
 
+// Enable/disable the stream prefetcher, which detects constant-stride and
+// sequential access patterns across VA blocks
+static unsigned uvm_perf_prefetch_streams_enable = 1;
+
+#define UVM_PREFETCH_STREAM_CONFIDENCE_DEFAULT 2
+#define UVM_PREFETCH_STREAM_CONFIDENCE_MAX     8
+
+// Number of consecutive stride matches required before a stream issues
+// ahead-of-fault migrations
+static unsigned uvm_perf_prefetch_stream_confidence = UVM_PREFETCH_STREAM_CONFIDENCE_DEFAULT;
+
 // Module parameters for the tunables
 module_param(uvm_perf_prefetch_enable, uint, S_IRUGO);
 module_param(uvm_perf_prefetch_threshold, uint, S_IRUGO);
 module_param(uvm_perf_prefetch_min_faults, uint, S_IRUGO);
+module_param(uvm_perf_prefetch_streams_enable, uint, S_IRUGO);
+module_param(uvm_perf_prefetch_stream_confidence, uint, S_IRUGO);
+
+// Deltas between consecutive accesses larger than this are not considered to
+// belong to the same stream
+#define UVM_PREFETCH_STREAM_MAX_STRIDE (64 * UVM_VA_BLOCK_SIZE)
+
+// Maximum number of strides predicted ahead of the last access
+#define UVM_PREFETCH_STREAM_MAX_DEPTH 4
+
+// Number of stream table updates without predictions after thrashing is
+// detected
+#define UVM_PREFETCH_STREAM_THRASHING_BACKOFF 64
 
 static bool g_uvm_perf_prefetch_enable;
 static unsigned g_uvm_perf_prefetch_threshold;
 static unsigned g_uvm_perf_prefetch_min_faults;
+static bool g_uvm_perf_prefetch_streams_enable;
+static unsigned g_uvm_perf_prefetch_stream_confidence;
 
 void uvm_perf_prefetch_bitmap_tree_iter_init(const uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
                                              uvm_page_index_t page_index,
@@ -100,7 +129,8 @@ NvU16 uvm_perf_prefetch_bitmap_tree_iter_get_count(const uvm_perf_prefetch_bitma
 
 static uvm_va_block_region_t compute_prefetch_region(uvm_page_index_t page_index,
                                                      uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
-                                                     uvm_va_block_region_t max_prefetch_region)
+                                                     uvm_va_block_region_t max_prefetch_region,
+                                                     unsigned threshold)
 {
     NvU16 counter;
     uvm_perf_prefetch_bitmap_tree_iter_t iter;
@@ -114,7 +144,7 @@ static uvm_va_block_region_t compute_prefetch_region(uvm_page_index_t page_index
         NvU16 subregion_pages = uvm_va_block_region_num_pages(subregion);
 
         UVM_ASSERT(counter <= subregion_pages);
-        if (counter * 100 > subregion_pages * g_uvm_perf_prefetch_threshold)
+        if (counter * 100 > subregion_pages * threshold)
             prefetch_region = subregion;
     }
 
@@ -295,19 +325,24 @@ static void update_bitmap_tree_from_va_block(uvm_perf_prefetch_bitmap_tree_t *bi
                            thrashing_pages);
 }
 
-static void compute_prefetch_mask(uvm_va_block_region_t faulted_region,
+static void compute_prefetch_mask(uvm_va_space_t *va_space,
+                                  uvm_va_block_region_t faulted_region,
                                   uvm_va_block_region_t max_prefetch_region,
                                   uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
                                   const uvm_page_mask_t *faulted_pages,
                                   uvm_page_mask_t *out_prefetch_mask)
 {
+    unsigned threshold = uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunablePrefetchThreshold);
     uvm_page_index_t page_index;
 
     uvm_page_mask_zero(out_prefetch_mask);
 
     // Update the tree using the faulted mask to compute the pages to prefetch.
     for_each_va_block_page_in_region_mask(page_index, faulted_pages, faulted_region) {
-        uvm_va_block_region_t region = compute_prefetch_region(page_index, bitmap_tree, max_prefetch_region);
+        uvm_va_block_region_t region = compute_prefetch_region(page_index,
+                                                               bitmap_tree,
+                                                               max_prefetch_region,
+                                                               threshold);
 
         uvm_page_mask_region_fill(out_prefetch_mask, region);
 
@@ -317,6 +352,255 @@ static void compute_prefetch_mask(uvm_va_block_region_t faulted_region,
     }
 }
 
+void uvm_perf_prefetch_streams_init(uvm_perf_prefetch_streams_t *streams)
+{
+    memset(streams, 0, sizeof(*streams));
+    uvm_spin_lock_init(&streams->lock, UVM_LOCK_ORDER_LEAF);
+}
+
+static void stream_queue_request(uvm_perf_prefetch_streams_t *streams,
+                                 NvU64 address,
+                                 NvU64 length,
+                                 uvm_processor_id_t residency)
+{
+    NvU32 i;
+
+    for (i = 0; i < streams->num_requests; i++) {
+        if (streams->requests[i].address == address && uvm_id_equal(streams->requests[i].residency, residency))
+            return;
+    }
+
+    if (streams->num_requests == UVM_PERF_PREFETCH_STREAM_REQUESTS)
+        return;
+
+    streams->requests[streams->num_requests].address = address;
+    streams->requests[streams->num_requests].length = length;
+    streams->requests[streams->num_requests].residency = residency;
+    streams->num_requests++;
+}
+
+// Find the stream that the access at address continues. A stream whose stride
+// matches is preferred, then the closest stream within
+// UVM_PREFETCH_STREAM_MAX_STRIDE, which is retrained with the new stride.
+// Otherwise the least-recently used entry is recycled.
+static uvm_perf_prefetch_stream_t *stream_find(uvm_perf_prefetch_streams_t *streams,
+                                               NvU64 address,
+                                               uvm_processor_id_t residency,
+                                               bool *stride_match)
+{
+    uvm_perf_prefetch_stream_t *closest = NULL;
+    uvm_perf_prefetch_stream_t *lru = &streams->streams[0];
+    NvU64 closest_distance = UVM_PREFETCH_STREAM_MAX_STRIDE + 1;
+    NvU32 i;
+
+    *stride_match = false;
+
+    for (i = 0; i < UVM_PERF_PREFETCH_STREAM_COUNT; i++) {
+        uvm_perf_prefetch_stream_t *stream = &streams->streams[i];
+        NvS64 delta = (NvS64)(address - stream->last_address);
+        NvU64 distance = delta < 0 ? -delta : delta;
+
+        if (stream->last_use < lru->last_use)
+            lru = stream;
+
+        if (stream->last_use == 0 || !uvm_id_equal(stream->residency, residency))
+            continue;
+
+        if (delta != 0 && delta == stream->stride) {
+            *stride_match = true;
+            return stream;
+        }
+
+        if (distance < closest_distance) {
+            closest = stream;
+            closest_distance = distance;
+        }
+    }
+
+    if (closest)
+        return closest;
+
+    memset(lru, 0, sizeof(*lru));
+    lru->residency = residency;
+    lru->last_address = address;
+
+    return lru;
+}
+
+// Record the fault on faulted_region of va_block in the stream table, and
+// predict the next accesses of its stream. Predictions that fall within
+// max_prefetch_region of this block are added to prefetch_pages, the rest are
+// queued for uvm_perf_prefetch_streams_issue().
+static void stream_update(uvm_va_block_t *va_block,
+                          uvm_processor_id_t new_residency,
+                          const uvm_page_mask_t *faulted_pages,
+                          uvm_va_block_region_t faulted_region,
+                          uvm_va_block_region_t max_prefetch_region,
+                          const uvm_page_mask_t *thrashing_pages,
+                          uvm_page_mask_t *prefetch_pages)
+{
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    uvm_perf_prefetch_streams_t *streams = &va_space->prefetch_streams;
+    unsigned confidence = uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunablePrefetchStreamConfidence);
+    NvU64 address = uvm_va_block_region_start(va_block, faulted_region);
+    NvU64 length = uvm_va_block_region_size(faulted_region);
+    uvm_perf_prefetch_stream_t *stream;
+    bool stride_match;
+    NvU32 depth;
+    NvU32 i;
+
+    uvm_spin_lock(&streams->lock);
+
+    stream = stream_find(streams, address, new_residency, &stride_match);
+
+    // Retried services of the same block are not new accesses
+    if (stream->last_use != 0 && stream->last_address == address)
+        goto done;
+
+    // Back off when the stream runs into thrashing pages, since prefetching
+    // ahead of it would only make thrashing worse
+    if (thrashing_pages && uvm_page_mask_intersects(thrashing_pages, faulted_pages)) {
+        stream->confidence = 0;
+        streams->backoff = UVM_PREFETCH_STREAM_THRASHING_BACKOFF;
+    }
+    else if (stride_match) {
+        stream->confidence = min(stream->confidence + 1, UVM_PREFETCH_STREAM_CONFIDENCE_MAX);
+    }
+    else {
+        stream->stride = (NvS64)(address - stream->last_address);
+        stream->confidence = stream->last_use != 0 && stream->stride != 0;
+    }
+
+    stream->last_address = address;
+    stream->length = length;
+    stream->last_use = ++streams->clock;
+
+    if (streams->backoff > 0) {
+        streams->backoff--;
+        goto done;
+    }
+
+    if (stream->confidence < confidence)
+        goto done;
+
+    depth = min(stream->confidence - confidence + 1,
+                (unsigned)UVM_PREFETCH_STREAM_MAX_DEPTH);
+
+    for (i = 1; i <= depth; i++) {
+        NvU64 next = address + (NvU64)(stream->stride * (NvS64)i);
+
+        // Stop at address space wrap-around
+        if ((stream->stride > 0) != (next > address))
+            break;
+
+        if (next >= va_block->start && next <= va_block->end) {
+            uvm_va_block_region_t region = uvm_va_block_region_from_start_end(va_block,
+                                                                              next,
+                                                                              min(next + length - 1, va_block->end));
+
+            region.first = max(region.first, max_prefetch_region.first);
+            region.outer = min(region.outer, max_prefetch_region.outer);
+            if (region.first < region.outer)
+                uvm_page_mask_region_fill(prefetch_pages, region);
+        }
+        else {
+            stream_queue_request(streams, next, length, new_residency);
+        }
+    }
+
+done:
+    uvm_spin_unlock(&streams->lock);
+}
+
+static NV_STATUS stream_prefetch_block_locked(uvm_va_block_t *va_block,
+                                              uvm_va_block_retry_t *va_block_retry,
+                                              uvm_va_block_context_t *va_block_context,
+                                              uvm_va_block_region_t region,
+                                              uvm_processor_id_t dest_id)
+{
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    uvm_va_policy_t *policy = uvm_va_range_get_policy(va_block->va_range);
+
+    if (uvm_va_policy_is_read_duplicate(policy, va_space)) {
+        return uvm_va_block_make_resident_read_duplicate(va_block,
+                                                         va_block_retry,
+                                                         va_block_context,
+                                                         dest_id,
+                                                         region,
+                                                         NULL,
+                                                         NULL,
+                                                         UVM_MAKE_RESIDENT_CAUSE_PREFETCH);
+    }
+
+    return uvm_va_block_make_resident(va_block,
+                                      va_block_retry,
+                                      va_block_context,
+                                      dest_id,
+                                      region,
+                                      NULL,
+                                      NULL,
+                                      UVM_MAKE_RESIDENT_CAUSE_PREFETCH);
+}
+
+void uvm_perf_prefetch_streams_issue(uvm_va_space_t *va_space, uvm_va_block_context_t *va_block_context)
+{
+    uvm_perf_prefetch_streams_t *streams = &va_space->prefetch_streams;
+    uvm_perf_prefetch_stream_request_t requests[UVM_PERF_PREFETCH_STREAM_REQUESTS];
+    NvU32 num_requests;
+    NvU32 i;
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    // Unlocked peek, a request queued concurrently is issued next time
+    if (streams->num_requests == 0)
+        return;
+
+    uvm_spin_lock(&streams->lock);
+    num_requests = streams->num_requests;
+    memcpy(requests, streams->requests, num_requests * sizeof(requests[0]));
+    streams->num_requests = 0;
+    uvm_spin_unlock(&streams->lock);
+
+    for (i = 0; i < num_requests; i++) {
+        uvm_perf_prefetch_stream_request_t *request = &requests[i];
+        uvm_va_block_retry_t va_block_retry;
+        uvm_va_block_region_t region;
+        uvm_va_range_t *va_range;
+        uvm_va_block_t *va_block;
+        NvU64 end;
+        NV_STATUS status;
+
+        if (UVM_ID_IS_GPU(request->residency) &&
+            !uvm_processor_mask_test(&va_space->registered_gpus, request->residency))
+            continue;
+
+        va_range = uvm_va_range_find(va_space, request->address);
+        if (!va_range || va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+            continue;
+
+        status = uvm_va_range_block_create(va_range,
+                                           uvm_va_range_block_index(va_range, request->address),
+                                           &va_block);
+        if (status != NV_OK)
+            break;
+
+        end = min(request->address + request->length - 1, va_block->end);
+        if (!uvm_range_group_all_migratable(va_space, request->address, end))
+            continue;
+
+        region = uvm_va_block_region_from_start_end(va_block, request->address, end);
+
+        status = UVM_VA_BLOCK_LOCK_RETRY(va_block, &va_block_retry,
+                                         stream_prefetch_block_locked(va_block,
+                                                                      &va_block_retry,
+                                                                      va_block_context,
+                                                                      region,
+                                                                      request->residency));
+        if (status != NV_OK)
+            break;
+    }
+}
+
 // Within a block we only allow prefetching to a single processor. Therefore,
 // if two processors are accessing non-overlapping regions within the same
 // block they won't benefit from prefetching.
@@ -331,6 +615,7 @@ static NvU32 uvm_perf_prefetch_prenotify_fault_migrations(uvm_va_block_t *va_blo
                                                           uvm_page_mask_t *prefetch_pages,
                                                           uvm_perf_prefetch_bitmap_tree_t *bitmap_tree)
 {
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
     const uvm_page_mask_t *resident_mask = NULL;
     const uvm_va_policy_t *policy = uvm_va_policy_get_region(va_block, faulted_region);
     uvm_va_block_region_t max_prefetch_region;
@@ -379,13 +664,27 @@ static NvU32 uvm_perf_prefetch_prenotify_fault_migrations(uvm_va_block_t *va_blo
         else
             uvm_page_mask_copy(&va_block_context->scratch_page_mask, faulted_pages);
 
-        compute_prefetch_mask(faulted_region,
+        compute_prefetch_mask(va_space,
+                              faulted_region,
                               max_prefetch_region,
                               bitmap_tree,
                               &va_block_context->scratch_page_mask,
                               prefetch_pages);
     }
 
+    if (g_uvm_perf_prefetch_streams_enable &&
+        uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunablePrefetchStreamsEnable) &&
+        UVM_ID_IS_GPU(new_residency) &&
+        !uvm_va_block_is_hmm(va_block)) {
+        stream_update(va_block,
+                      new_residency,
+                      faulted_pages,
+                      faulted_region,
+                      max_prefetch_region,
+                      thrashing_pages,
+                      prefetch_pages);
+    }
+
     // Do not prefetch pages that are going to be migrated/populated due to a
     // fault
     uvm_page_mask_andnot(prefetch_pages, prefetch_pages, faulted_pages);
@@ -402,11 +701,11 @@ static NvU32 uvm_perf_prefetch_prenotify_fault_migrations(uvm_va_block_t *va_blo
         uvm_page_mask_andnot(prefetch_pages, prefetch_pages, &va_block_context->scratch_page_mask);
     }
 
+    va_block->prefetch_info.fault_migrations_to_last_proc += uvm_page_mask_region_weight(faulted_pages, faulted_region);
+
     // Avoid prefetching pages that are thrashing
     if (thrashing_pages)
-        uvm_page_mask_andnot(prefetch_pages, prefetch_pages, thrashing_pages);
-
-    va_block->prefetch_info.fault_migrations_to_last_proc += uvm_page_mask_region_weight(faulted_pages, faulted_region);
+        return uvm_page_mask_andnot_weight(prefetch_pages, prefetch_pages, thrashing_pages);
 
     return uvm_page_mask_weight(prefetch_pages);
 }
@@ -418,6 +717,9 @@ bool uvm_perf_prefetch_enabled(uvm_va_space_t *va_space)
 
     UVM_ASSERT(va_space);
 
+    if (!uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunablePrefetchEnable))
+        return false;
+
     return va_space->test.page_prefetch_enabled;
 }
 
@@ -440,7 +742,12 @@ void uvm_perf_prefetch_compute_ats(uvm_va_space_t *va_space,
 
     init_bitmap_tree_from_region(bitmap_tree, max_prefetch_region, residency_mask, faulted_pages);
 
-    compute_prefetch_mask(faulted_region, max_prefetch_region, bitmap_tree, faulted_pages, out_prefetch_mask);
+    compute_prefetch_mask(va_space,
+                          faulted_region,
+                          max_prefetch_region,
+                          bitmap_tree,
+                          faulted_pages,
+                          out_prefetch_mask);
 }
 
 void uvm_perf_prefetch_get_hint_va_block(uvm_va_block_t *va_block,
@@ -473,7 +780,8 @@ void uvm_perf_prefetch_get_hint_va_block(uvm_va_block_t *va_block,
                                                                           prefetch_pages,
                                                                           bitmap_tree);
 
-    if (va_block->prefetch_info.fault_migrations_to_last_proc >= g_uvm_perf_prefetch_min_faults &&
+    if (va_block->prefetch_info.fault_migrations_to_last_proc >=
+            uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunablePrefetchMinFaults) &&
         pending_prefetch_pages > 0) {
         bool changed = false;
         uvm_range_group_range_t *rgr;
@@ -528,5 +836,36 @@ NV_STATUS uvm_perf_prefetch_init(void)
         g_uvm_perf_prefetch_min_faults = UVM_PREFETCH_MIN_FAULTS_DEFAULT;
     }
 
+    g_uvm_perf_prefetch_streams_enable = uvm_perf_prefetch_streams_enable != 0;
+
+    if (uvm_perf_prefetch_stream_confidence >= 1 &&
+        uvm_perf_prefetch_stream_confidence <= UVM_PREFETCH_STREAM_CONFIDENCE_MAX) {
+        g_uvm_perf_prefetch_stream_confidence = uvm_perf_prefetch_stream_confidence;
+    }
+    else {
+        pr_info("Invalid value %u for uvm_perf_prefetch_stream_confidence. Using %u instead\n",
+                uvm_perf_prefetch_stream_confidence, UVM_PREFETCH_STREAM_CONFIDENCE_DEFAULT);
+
+        g_uvm_perf_prefetch_stream_confidence = UVM_PREFETCH_STREAM_CONFIDENCE_DEFAULT;
+    }
+
+    uvm_perf_tunables_register(UvmPerfTunablePrefetchEnable, 1, 0, 1);
+    uvm_perf_tunables_register(UvmPerfTunablePrefetchThreshold, g_uvm_perf_prefetch_threshold, 0, 100);
+    uvm_perf_tunables_register(UvmPerfTunablePrefetchMinFaults,
+                               g_uvm_perf_prefetch_min_faults,
+                               UVM_PREFETCH_MIN_FAULTS_MIN,
+                               UVM_PREFETCH_MIN_FAULTS_MAX);
+
+    // Streams disabled for the whole module cannot be enabled per VA space,
+    // because the stream table is only updated when they are enabled.
+    uvm_perf_tunables_register(UvmPerfTunablePrefetchStreamsEnable,
+                               g_uvm_perf_prefetch_streams_enable,
+                               0,
+                               g_uvm_perf_prefetch_streams_enable);
+    uvm_perf_tunables_register(UvmPerfTunablePrefetchStreamConfidence,
+                               g_uvm_perf_prefetch_stream_confidence,
+                               1,
+                               UVM_PREFETCH_STREAM_CONFIDENCE_MAX);
+
     return NV_OK;
 }
@@ -27,6 +27,7 @@
 #include "uvm_nanos.h"
 #include "uvm_processors.h"
 #include "uvm_va_block_types.h"
+#include "uvm_lock.h"
 
 typedef struct
 {
@@ -58,6 +59,61 @@ typedef struct
     uvm_page_index_t node_idx;
 } uvm_perf_prefetch_bitmap_tree_iter_t;
 
+#define UVM_PERF_PREFETCH_STREAM_COUNT    8
+#define UVM_PERF_PREFETCH_STREAM_REQUESTS 8
+
+// Access stream detected across VA blocks. A stream is identified by the
+// address of the first page faulted in the last VA block that was serviced
+// for it, and the stride between consecutive blocks.
+typedef struct
+{
+    NvU64 last_address;
+
+    NvS64 stride;
+
+    // Size of the faulted region at last_address
+    NvU64 length;
+
+    uvm_processor_id_t residency;
+
+    // Number of consecutive accesses that matched the stride. Predictions are
+    // only made once it reaches the confidence threshold.
+    NvU8 confidence;
+
+    // Table clock of the last update, for LRU replacement. 0 if unused.
+    NvU64 last_use;
+} uvm_perf_prefetch_stream_t;
+
+// Ahead-of-fault migration predicted by a stream outside of the VA block that
+// was being serviced
+typedef struct
+{
+    NvU64 address;
+
+    NvU64 length;
+
+    uvm_processor_id_t residency;
+} uvm_perf_prefetch_stream_request_t;
+
+// Per-VA space table of access streams, which complements the per-VA block
+// bitmap tree with constant-stride and sequential patterns that cross VA
+// block boundaries.
+typedef struct
+{
+    uvm_spinlock_t lock;
+
+    NvU64 clock;
+
+    // Number of updates left without predictions after thrashing was detected
+    NvU32 backoff;
+
+    uvm_perf_prefetch_stream_t streams[UVM_PERF_PREFETCH_STREAM_COUNT];
+
+    NvU32 num_requests;
+
+    uvm_perf_prefetch_stream_request_t requests[UVM_PERF_PREFETCH_STREAM_REQUESTS];
+} uvm_perf_prefetch_streams_t;
+
 // Global initialization function (no clean up needed).
 NV_STATUS uvm_perf_prefetch_init(void);
 
@@ -97,6 +153,16 @@ void uvm_perf_prefetch_get_hint_va_block(uvm_va_block_t *va_block,
                                          uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
                                          uvm_perf_prefetch_hint_t *out_hint);
 
+// Initialize the stream table of a VA space. No clean up needed.
+void uvm_perf_prefetch_streams_init(uvm_perf_prefetch_streams_t *streams);
+
+// Migrate the pages predicted by the stream table of the VA space outside of
+// the VA blocks that were serviced. This is best effort: the requests are
+// dropped on error. va_block_context is used as scratch.
+//
+// Locking: The caller must hold the va_space lock and no VA block lock.
+void uvm_perf_prefetch_streams_issue(uvm_va_space_t *va_space, uvm_va_block_context_t *va_block_context);
+
 void uvm_perf_prefetch_bitmap_tree_iter_init(const uvm_perf_prefetch_bitmap_tree_t *bitmap_tree,
                                              uvm_page_index_t page_index,
                                              uvm_perf_prefetch_bitmap_tree_iter_t *iter);
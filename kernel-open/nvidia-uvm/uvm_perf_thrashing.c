@@ -26,6 +26,7 @@
 #include "uvm_perf_events.h"
 #include "uvm_perf_module.h"
 #include "uvm_perf_thrashing.h"
+#include "uvm_perf_tunables.h"
 #include "uvm_perf_utils.h"
 #include "uvm_va_block.h"
 #include "uvm_va_range.h"
@@ -142,6 +143,9 @@ typedef struct
 declare_closure_struct(0, 2, void, thrashing_unpin_pages,
                        u64, expiry, u64, overruns);
 
+declare_closure_struct(0, 2, void, thrashing_flip_read_duplication,
+                       u64, expiry, u64, overruns);
+
 // Per-VA space data structures and policy configuration
 typedef struct
 {
@@ -175,6 +179,18 @@ typedef struct
         bool                    in_va_space_teardown;
     } pinned_pages;
 
+    // Read duplication changes requested by the read-mostly detection. They
+    // need the VA space lock in write mode, so they are applied by a helper
+    // thread to the VA ranges with a pending_flip.
+    struct
+    {
+        struct timer                           dwork;
+        closure_struct(thrashing_flip_read_duplication, dwork_handler);
+
+        // Set while dwork is scheduled
+        atomic_t                          scheduled;
+    } read_mostly;
+
     struct
     {
         // Whether thrashing mitigation is enabled on this VA space
@@ -200,6 +216,8 @@ typedef struct
         unsigned                          max_resets;
 
         NvU64                                 pin_ns;
+
+        bool                        map_remote_first;
     } params;
 
     uvm_va_space_t                         *va_space;
@@ -308,6 +326,46 @@ static unsigned uvm_perf_thrashing_pin = UVM_PERF_THRASHING_PIN_DEFAULT;
 
 static unsigned uvm_perf_thrashing_max_resets = UVM_PERF_THRASHING_MAX_RESETS_DEFAULT;
 
+#define UVM_PERF_THRASHING_MAP_REMOTE_FIRST_DEFAULT 1
+
+// When a page starts thrashing and all the thrashing processors can access its
+// current residency, pin it there and map the rest of processors remotely
+// right away, instead of throttling them for uvm_perf_thrashing_pin_threshold
+// throttling periods first. The page is unpinned after uvm_perf_thrashing_pin
+// and the next faults decide again whether to migrate it or to keep mapping it
+// remotely. This avoids paying the throttling naps on ping-pong patterns, such
+// as a producer and a consumer on GPUs with peer access.
+static unsigned uvm_perf_thrashing_map_remote_first = UVM_PERF_THRASHING_MAP_REMOTE_FIRST_DEFAULT;
+
+#define UVM_PERF_THRASHING_AUTO_READ_DUP_DEFAULT 0
+
+// Automatically enable read duplication on VA ranges that several processors
+// read and rarely write, based on the fault and access counter history of the
+// range, and revert it on the first write storm. Ranges on which the user set
+// a read duplication policy are left alone.
+static unsigned uvm_perf_thrashing_auto_read_dup = UVM_PERF_THRASHING_AUTO_READ_DUP_DEFAULT;
+
+#define UVM_PERF_THRASHING_AUTO_READ_DUP_MIN_READS_DEFAULT 128
+
+// Number of read faults within a window, from at least two processors, needed
+// to consider a VA range read-mostly. The window is the thrashing epoch.
+static unsigned uvm_perf_thrashing_auto_read_dup_min_reads = UVM_PERF_THRASHING_AUTO_READ_DUP_MIN_READS_DEFAULT;
+
+#define UVM_PERF_THRASHING_AUTO_READ_DUP_MAX_WRITE_PCT_DEFAULT 1
+
+// Maximum percentage of write faults over read faults within a window for a
+// VA range to be considered read-mostly
+static unsigned uvm_perf_thrashing_auto_read_dup_max_write_pct = UVM_PERF_THRASHING_AUTO_READ_DUP_MAX_WRITE_PCT_DEFAULT;
+
+#define UVM_PERF_THRASHING_AUTO_READ_DUP_WRITE_STORM_DEFAULT 32
+
+// Number of write faults within a window that revert automatic read
+// duplication. Read duplication is then not enabled automatically on the
+// range again for UVM_PERF_THRASHING_AUTO_READ_DUP_HOLD_OFF_EPOCHS windows.
+static unsigned uvm_perf_thrashing_auto_read_dup_write_storm = UVM_PERF_THRASHING_AUTO_READ_DUP_WRITE_STORM_DEFAULT;
+
+#define UVM_PERF_THRASHING_AUTO_READ_DUP_HOLD_OFF_EPOCHS 8
+
 // Module parameters for the tunables
 module_param(uvm_perf_thrashing_enable,        uint, S_IRUGO);
 module_param(uvm_perf_thrashing_threshold,     uint, S_IRUGO);
@@ -317,6 +375,11 @@ module_param(uvm_perf_thrashing_nap,           uint, S_IRUGO);
 module_param(uvm_perf_thrashing_epoch,         uint, S_IRUGO);
 module_param(uvm_perf_thrashing_pin,           uint, S_IRUGO);
 module_param(uvm_perf_thrashing_max_resets,    uint, S_IRUGO);
+module_param(uvm_perf_thrashing_map_remote_first, uint, S_IRUGO);
+module_param(uvm_perf_thrashing_auto_read_dup, uint, S_IRUGO);
+module_param(uvm_perf_thrashing_auto_read_dup_min_reads, uint, S_IRUGO);
+module_param(uvm_perf_thrashing_auto_read_dup_max_write_pct, uint, S_IRUGO);
+module_param(uvm_perf_thrashing_auto_read_dup_write_storm, uint, S_IRUGO);
 
 // See map_remote_on_atomic_fault uvm_va_block.c
 unsigned uvm_perf_map_remote_on_native_atomics_fault = 0;
@@ -332,6 +395,11 @@ static NvU64 g_uvm_perf_thrashing_nap;
 static NvU64 g_uvm_perf_thrashing_epoch;
 static NvU64 g_uvm_perf_thrashing_pin;
 static unsigned g_uvm_perf_thrashing_max_resets;
+static unsigned g_uvm_perf_thrashing_map_remote_first;
+static unsigned g_uvm_perf_thrashing_auto_read_dup;
+static unsigned g_uvm_perf_thrashing_auto_read_dup_min_reads;
+static unsigned g_uvm_perf_thrashing_auto_read_dup_max_write_pct;
+static unsigned g_uvm_perf_thrashing_auto_read_dup_write_storm;
 
 // Helper macros to initialize thrashing parameters from module parameters
 //
@@ -405,14 +473,18 @@ static uvm_perf_module_t g_module_thrashing;
 static void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
 static void thrashing_block_destroy_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
 static void thrashing_block_munmap_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
+static void thrashing_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data);
 
+// The fault callback must be the last entry. It is only registered when
+// uvm_perf_thrashing_auto_read_dup is set, see uvm_perf_thrashing_init().
 static uvm_perf_module_event_callback_desc_t g_callbacks_thrashing[] = {
     { UVM_PERF_EVENT_BLOCK_DESTROY, thrashing_block_destroy_cb },
     { UVM_PERF_EVENT_MODULE_UNLOAD, thrashing_block_destroy_cb },
     { UVM_PERF_EVENT_BLOCK_SHRINK , thrashing_block_destroy_cb },
     { UVM_PERF_EVENT_BLOCK_MUNMAP , thrashing_block_munmap_cb  },
     { UVM_PERF_EVENT_MIGRATION,     thrashing_event_cb         },
-    { UVM_PERF_EVENT_REVOCATION,    thrashing_event_cb         }
+    { UVM_PERF_EVENT_REVOCATION,    thrashing_event_cb         },
+    { UVM_PERF_EVENT_FAULT,         thrashing_fault_cb         }
 };
 
 #define THRASHING_STATS_FILE_NAME "thrashing_stats"
@@ -515,35 +587,44 @@ static va_space_thrashing_info_t *va_space_thrashing_info_get(uvm_va_space_t *va
 
 static void va_space_thrashing_info_init_params(va_space_thrashing_info_t *va_space_thrashing)
 {
+    const uvm_perf_tunables_t *tunables = &va_space_thrashing->va_space->perf_tunables;
+    NvU64 lapse_usec = uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingLapseUsec);
+    NvU64 pin = uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingPin);
+
     UVM_ASSERT(!va_space_thrashing->params.test_overrides);
 
-    va_space_thrashing->params.enable = g_uvm_perf_thrashing_enable;
+    va_space_thrashing->params.enable = g_uvm_perf_thrashing_enable &&
+                                        uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingEnable);
 
-    // Snap the thrashing parameters so that they can be tuned per VA space
-    va_space_thrashing->params.threshold     = g_uvm_perf_thrashing_threshold;
-    va_space_thrashing->params.pin_threshold = g_uvm_perf_thrashing_pin_threshold;
+    // Snap the thrashing parameters of the VA space
+    va_space_thrashing->params.threshold     = uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingThreshold);
+    va_space_thrashing->params.pin_threshold = uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingPinThreshold);
 
     // Default thrashing parameters are overriden for simulated/emulated GPUs
-    if (g_uvm_global.num_simulated_devices > 0 &&
-        (g_uvm_perf_thrashing_lapse_usec == UVM_PERF_THRASHING_LAPSE_USEC_DEFAULT)) {
+    if (g_uvm_global.num_simulated_devices > 0 && (lapse_usec == UVM_PERF_THRASHING_LAPSE_USEC_DEFAULT)) {
         va_space_thrashing->params.lapse_ns  = UVM_PERF_THRASHING_LAPSE_USEC_DEFAULT_EMULATION * 1000;
     }
     else {
-        va_space_thrashing->params.lapse_ns  = g_uvm_perf_thrashing_lapse_usec * 1000;
+        va_space_thrashing->params.lapse_ns  = lapse_usec * 1000;
     }
 
-    va_space_thrashing->params.nap_ns        = va_space_thrashing->params.lapse_ns * g_uvm_perf_thrashing_nap;
-    va_space_thrashing->params.epoch_ns      = va_space_thrashing->params.lapse_ns * g_uvm_perf_thrashing_epoch;
+    va_space_thrashing->params.nap_ns        = va_space_thrashing->params.lapse_ns *
+                                               uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingNap);
+    va_space_thrashing->params.epoch_ns      = va_space_thrashing->params.lapse_ns *
+                                               uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingEpoch);
 
-    if (g_uvm_global.num_simulated_devices > 0 && (g_uvm_perf_thrashing_pin == UVM_PERF_THRASHING_PIN_DEFAULT)) {
+    if (g_uvm_global.num_simulated_devices > 0 && (pin == UVM_PERF_THRASHING_PIN_DEFAULT)) {
         va_space_thrashing->params.pin_ns    = va_space_thrashing->params.lapse_ns
                                                * UVM_PERF_THRASHING_PIN_DEFAULT_EMULATION;
     }
     else {
-        va_space_thrashing->params.pin_ns    = va_space_thrashing->params.lapse_ns * g_uvm_perf_thrashing_pin;
+        va_space_thrashing->params.pin_ns    = va_space_thrashing->params.lapse_ns * pin;
     }
 
-    va_space_thrashing->params.max_resets    = g_uvm_perf_thrashing_max_resets;
+    va_space_thrashing->params.max_resets    = uvm_perf_tunable_get(tunables, UvmPerfTunableThrashingMaxResets);
+
+    va_space_thrashing->params.map_remote_first = uvm_perf_tunable_get(tunables,
+                                                                       UvmPerfTunableThrashingMapRemoteFirst);
 }
 
 // Create the thrashing detection struct for the given VA space
@@ -1173,6 +1254,155 @@ static bool is_migration_pinned_pages_update(uvm_va_block_t *va_block,
     return ret;
 }
 
+// Read-mostly detection
+//
+// Each managed VA range counts the read and write faults it gets within a
+// window of one thrashing epoch, along with the processors that access it.
+// Once a window sees enough reads from at least two processors and few
+// enough writes, read duplication is enabled on the range. If a range that
+// was read-duplicated this way then gets a write storm, read duplication is
+// reverted and the range is held off for a few windows. Policy changes need
+// the VA space lock in write mode, so they are deferred to
+// thrashing_flip_read_duplication().
+typedef enum
+{
+    READ_MOSTLY_FLIP_NONE = 0,
+    READ_MOSTLY_FLIP_ENABLE,
+    READ_MOSTLY_FLIP_REVERT,
+} read_mostly_flip_t;
+
+static void read_mostly_request_flip(va_space_thrashing_info_t *va_space_thrashing,
+                                     uvm_va_range_read_mostly_t *read_mostly,
+                                     read_mostly_flip_t flip)
+{
+    if (nv_atomic_cmpxchg(&read_mostly->pending_flip, READ_MOSTLY_FLIP_NONE, flip) != READ_MOSTLY_FLIP_NONE)
+        return;
+
+    // The VA space lock is held in read mode by the callers, so this can't
+    // race with uvm_perf_thrashing_stop()
+    if (va_space_thrashing->pinned_pages.in_va_space_teardown)
+        return;
+
+    if (nv_atomic_cmpxchg(&va_space_thrashing->read_mostly.scheduled, 0, 1) == 0) {
+        register_timer(kernel_timers, &va_space_thrashing->read_mostly.dwork,
+            CLOCK_ID_MONOTONIC, 0, false, 0,
+            (timer_handler)&va_space_thrashing->read_mostly.dwork_handler);
+    }
+}
+
+// Start a new window if the current one is over. Racing updates may drop a
+// few samples, which the heuristic tolerates.
+static void read_mostly_update_window(va_space_thrashing_info_t *va_space_thrashing,
+                                      uvm_va_range_read_mostly_t *read_mostly,
+                                      NvU64 time_stamp)
+{
+    if (time_stamp - UVM_READ_ONCE(read_mostly->window_start) <= va_space_thrashing->params.epoch_ns)
+        return;
+
+    UVM_WRITE_ONCE(read_mostly->window_start, time_stamp);
+    atomic_set(&read_mostly->num_reads, 0);
+    atomic_set(&read_mostly->num_writes, 0);
+    uvm_processor_mask_zero(&read_mostly->accessors);
+}
+
+static bool read_mostly_is_tracked(uvm_va_range_t *va_range)
+{
+    const uvm_va_policy_t *policy = uvm_va_range_get_policy(va_range);
+
+    // Only ranges without a user-selected policy are considered
+    return policy->read_duplication == UVM_READ_DUPLICATION_UNSET || policy->read_duplication_auto;
+}
+
+static void read_mostly_record_fault(va_space_thrashing_info_t *va_space_thrashing,
+                                     uvm_va_range_t *va_range,
+                                     uvm_processor_id_t processor_id,
+                                     bool is_write)
+{
+    uvm_va_range_read_mostly_t *read_mostly = &va_range->managed.read_mostly;
+    const uvm_va_policy_t *policy = uvm_va_range_get_policy(va_range);
+    NvU64 time_stamp = NV_GETTIME();
+    unsigned num_reads;
+    unsigned num_writes;
+
+    if (!read_mostly_is_tracked(va_range))
+        return;
+
+    read_mostly_update_window(va_space_thrashing, read_mostly, time_stamp);
+    uvm_processor_mask_set_atomic(&read_mostly->accessors, processor_id);
+
+    if (is_write) {
+        num_writes = atomic_inc_return(&read_mostly->num_writes);
+        if (policy->read_duplication_auto && num_writes >= g_uvm_perf_thrashing_auto_read_dup_write_storm)
+            read_mostly_request_flip(va_space_thrashing, read_mostly, READ_MOSTLY_FLIP_REVERT);
+
+        return;
+    }
+
+    num_reads = atomic_inc_return(&read_mostly->num_reads);
+    if (policy->read_duplication_auto || num_reads < g_uvm_perf_thrashing_auto_read_dup_min_reads)
+        return;
+
+    if (time_stamp < UVM_READ_ONCE(read_mostly->hold_off_until))
+        return;
+
+    if (uvm_processor_mask_get_count(&read_mostly->accessors) < 2)
+        return;
+
+    num_writes = atomic_read(&read_mostly->num_writes);
+    if ((NvU64)num_writes * 100 > (NvU64)num_reads * g_uvm_perf_thrashing_auto_read_dup_max_write_pct)
+        return;
+
+    read_mostly_request_flip(va_space_thrashing, read_mostly, READ_MOSTLY_FLIP_ENABLE);
+}
+
+// Access counters don't report the access type, so migrations triggered by
+// them only count as evidence that the processor uses the range.
+static void read_mostly_record_accessor(va_space_thrashing_info_t *va_space_thrashing,
+                                        uvm_va_range_t *va_range,
+                                        uvm_processor_id_t processor_id)
+{
+    uvm_va_range_read_mostly_t *read_mostly = &va_range->managed.read_mostly;
+
+    if (!read_mostly_is_tracked(va_range))
+        return;
+
+    read_mostly_update_window(va_space_thrashing, read_mostly, NV_GETTIME());
+    uvm_processor_mask_set_atomic(&read_mostly->accessors, processor_id);
+}
+
+void thrashing_fault_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
+{
+    uvm_va_block_t *va_block = event_data->fault.block;
+    uvm_processor_id_t processor_id = event_data->fault.proc_id;
+    va_space_thrashing_info_t *va_space_thrashing;
+    bool is_write;
+
+    UVM_ASSERT(g_uvm_perf_thrashing_enable);
+    UVM_ASSERT(g_uvm_perf_thrashing_auto_read_dup);
+    UVM_ASSERT(event_id == UVM_PERF_EVENT_FAULT);
+
+    if (!va_block || uvm_va_block_is_hmm(va_block))
+        return;
+
+    va_space_thrashing = va_space_thrashing_info_get(event_data->fault.space);
+    if (!va_space_thrashing->params.enable)
+        return;
+
+    if (UVM_ID_IS_CPU(processor_id)) {
+        is_write = event_data->fault.cpu.is_write;
+    }
+    else {
+        uvm_fault_access_type_t access_type = event_data->fault.gpu.buffer_entry->fault_access_type;
+
+        if (event_data->fault.gpu.is_duplicate || access_type == UVM_FAULT_ACCESS_TYPE_PREFETCH)
+            return;
+
+        is_write = access_type >= UVM_FAULT_ACCESS_TYPE_WRITE;
+    }
+
+    read_mostly_record_fault(va_space_thrashing, va_block->va_range, processor_id, is_write);
+}
+
 // This function processes migration/revocation events and determines if the
 // affected pages are thrashing or not.
 void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_data)
@@ -1213,6 +1443,12 @@ void thrashing_event_cb(uvm_perf_event_t event_id, uvm_perf_event_data_t *event_
         if (!va_space_thrashing->params.enable)
             return;
 
+        if (g_uvm_perf_thrashing_auto_read_dup &&
+            event_data->migration.cause == UVM_MAKE_RESIDENT_CAUSE_ACCESS_COUNTER &&
+            !uvm_va_block_is_hmm(va_block)) {
+            read_mostly_record_accessor(va_space_thrashing, va_block->va_range, processor_id);
+        }
+
         // TODO: Bug 3660922: HMM will need to look up the policy when
         // read duplication is supported.
         read_duplication = uvm_va_block_is_hmm(va_block) ?
@@ -1455,6 +1691,17 @@ static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(va_space_thras
             hint.pin.residency = closest_resident_id;
         }
     }
+    else if (va_space_thrashing->params.map_remote_first &&
+             !page_thrashing->pinned &&
+             !preferred_location_is_thrashing(preferred_location, page_thrashing) &&
+             thrashing_processors_can_access(va_space, page_thrashing, closest_resident_id)) {
+        // First stage of mitigation: leave the page where it is and map the
+        // thrashing processors remotely. Throttling is only used if the page
+        // cannot be accessed from all of them. The pinning timeout ends this
+        // stage, after which faults decide again where the page should live.
+        hint.type = UVM_PERF_THRASHING_HINT_TYPE_PIN;
+        hint.pin.residency = closest_resident_id;
+    }
     else if (uvm_id_equal(requester, preferred_location)) {
         if (page_thrashing->pinned) {
             // If the faulting processor is the preferred location, we can
@@ -1541,7 +1788,9 @@ static uvm_perf_thrashing_hint_t get_hint_for_migration_thrashing(va_space_thras
 //   "throttling period". During that period, only one processor will be able
 //   to service faults on the page, and the rest will be throttled. All CPU
 //   faults are considered to belong to the same device, even if they come from
-//   different CPU threads.
+//   different CPU threads. If uvm_perf_thrashing_map_remote_first is set and
+//   all thrashing processors can access the current residency of the page,
+//   this phase is skipped and the page is pinned there right away.
 // - Phase2: Pinning. After a number of consecutive throttling periods, the page
 //   is pinned on a specific processor which all of the thrashing processors can
 //   access.
@@ -1845,6 +2094,80 @@ exit_no_list_lock:
     uvm_va_space_up_read(va_space);
 }
 
+static void read_mostly_flip(uvm_va_space_t *va_space, uvm_va_range_t *va_range, read_mostly_flip_t flip)
+{
+    uvm_va_range_read_mostly_t *read_mostly = &va_range->managed.read_mostly;
+    uvm_va_policy_t *policy = uvm_va_range_get_policy(va_range);
+    va_space_thrashing_info_t *va_space_thrashing = va_space_thrashing_info_get(va_space);
+
+    // The user may have set a policy since the flip was requested, see
+    // read_duplication_set()
+    if (flip == READ_MOSTLY_FLIP_ENABLE) {
+        if (policy->read_duplication != UVM_READ_DUPLICATION_UNSET || !uvm_va_space_can_read_duplicate(va_space, NULL))
+            return;
+
+        if (uvm_va_range_set_read_duplication(va_range, NULL) != NV_OK)
+            return;
+
+        policy->read_duplication = UVM_READ_DUPLICATION_ENABLED;
+        policy->read_duplication_auto = true;
+    }
+    else {
+        if (!policy->read_duplication_auto)
+            return;
+
+        // If unsetting read duplication fails, the pages are read-duplicated
+        // until they are written
+        (void)uvm_va_range_unset_read_duplication(va_range, NULL);
+
+        policy->read_duplication = UVM_READ_DUPLICATION_UNSET;
+        policy->read_duplication_auto = false;
+        read_mostly->hold_off_until = NV_GETTIME() +
+                                      va_space_thrashing->params.epoch_ns * UVM_PERF_THRASHING_AUTO_READ_DUP_HOLD_OFF_EPOCHS;
+    }
+
+    uvm_tools_record_read_duplication_policy(va_space,
+                                             va_range->node.start,
+                                             uvm_va_range_size(va_range),
+                                             flip == READ_MOSTLY_FLIP_ENABLE,
+                                             &read_mostly->accessors);
+
+    // Start over with a new window
+    read_mostly->window_start = 0;
+}
+
+define_closure_function(0, 2, void, thrashing_flip_read_duplication,
+                        u64, expiry, u64, overruns)
+{
+    if (overruns == timer_disabled)
+        return;
+
+    va_space_thrashing_info_t *va_space_thrashing =
+            container_of(closure_self(), va_space_thrashing_info_t, read_mostly.dwork_handler);
+    uvm_va_space_t *va_space = va_space_thrashing->va_space;
+    uvm_va_range_t *va_range;
+
+    uvm_va_space_down_write(va_space);
+
+    // Flips requested from now on need a new run
+    atomic_set(&va_space_thrashing->read_mostly.scheduled, 0);
+
+    if (!va_space_thrashing->pinned_pages.in_va_space_teardown) {
+        uvm_for_each_va_range(va_range, va_space) {
+            read_mostly_flip_t flip;
+
+            if (va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+                continue;
+
+            flip = nv_atomic_xchg(&va_range->managed.read_mostly.pending_flip, READ_MOSTLY_FLIP_NONE);
+            if (flip != READ_MOSTLY_FLIP_NONE)
+                read_mostly_flip(va_space, va_range, flip);
+        }
+    }
+
+    uvm_va_space_up_write(va_space);
+}
+
 NV_STATUS uvm_perf_thrashing_load(uvm_va_space_t *va_space)
 {
     va_space_thrashing_info_t *va_space_thrashing;
@@ -1862,6 +2185,8 @@ NV_STATUS uvm_perf_thrashing_load(uvm_va_space_t *va_space)
     INIT_LIST_HEAD(&va_space_thrashing->pinned_pages.list);
     init_timer(&va_space_thrashing->pinned_pages.dwork);
     init_closure(&va_space_thrashing->pinned_pages.dwork_handler, thrashing_unpin_pages);
+    init_timer(&va_space_thrashing->read_mostly.dwork);
+    init_closure(&va_space_thrashing->read_mostly.dwork_handler, thrashing_flip_read_duplication);
 
     return NV_OK;
 }
@@ -1883,8 +2208,10 @@ void uvm_perf_thrashing_stop(uvm_va_space_t *va_space)
     // because this function is called once from the VA space teardown path,
     // and the only function that frees it is uvm_perf_thrashing_unload,
     // which is called later in the teardown path.
-    if (va_space_thrashing)
+    if (va_space_thrashing) {
         (void)cancel_delayed_work_sync(&va_space_thrashing->pinned_pages.dwork);
+        (void)cancel_delayed_work_sync(&va_space_thrashing->read_mostly.dwork);
+    }
 }
 
 void uvm_perf_thrashing_unload(uvm_va_space_t *va_space)
@@ -1918,8 +2245,13 @@ NV_STATUS uvm_perf_thrashing_register_gpu(uvm_va_space_t *va_space, uvm_gpu_t *g
         va_space_thrashing_info_t *va_space_thrashing = va_space_thrashing_info_get(va_space);
 
         if (!va_space_thrashing->params.test_overrides) {
-            if (uvm_conf_computing_mode_enabled(gpu))
-                g_uvm_perf_thrashing_lapse_usec = UVM_PERF_THRASHING_LAPSE_USEC_DEFAULT_HCC;
+            // Only replace the lapse if it has not been tuned for the VA space
+            if (uvm_conf_computing_mode_enabled(gpu) &&
+                uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunableThrashingLapseUsec) ==
+                    g_uvm_perf_thrashing_lapse_usec) {
+                UVM_WRITE_ONCE(va_space->perf_tunables.values[UvmPerfTunableThrashingLapseUsec],
+                               UVM_PERF_THRASHING_LAPSE_USEC_DEFAULT_HCC);
+            }
 
             va_space_thrashing_info_init_params(va_space_thrashing);
         }
@@ -1928,18 +2260,59 @@ NV_STATUS uvm_perf_thrashing_register_gpu(uvm_va_space_t *va_space, uvm_gpu_t *g
     return NV_OK;
 }
 
+void uvm_perf_thrashing_apply_tunables(uvm_va_space_t *va_space)
+{
+    va_space_thrashing_info_t *va_space_thrashing;
+
+    uvm_assert_rwsem_locked_write(&va_space->lock);
+
+    if (!g_uvm_perf_thrashing_enable)
+        return;
+
+    va_space_thrashing = va_space_thrashing_info_get_or_null(va_space);
+    if (va_space_thrashing && !va_space_thrashing->params.test_overrides)
+        va_space_thrashing_info_init_params(va_space_thrashing);
+}
+
+static void thrashing_register_tunables(void)
+{
+    uvm_perf_tunables_register(UvmPerfTunableThrashingEnable, 1, 0, 1);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingThreshold,
+                               g_uvm_perf_thrashing_threshold,
+                               1,
+                               UVM_PERF_THRASHING_THRESHOLD_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingPinThreshold,
+                               g_uvm_perf_thrashing_pin_threshold,
+                               1,
+                               UVM_PERF_THRASHING_PIN_THRESHOLD_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingLapseUsec, g_uvm_perf_thrashing_lapse_usec, 1, UINT_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingNap, g_uvm_perf_thrashing_nap, 1, UVM_PERF_THRASHING_NAP_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingEpoch, g_uvm_perf_thrashing_epoch, 1, UINT_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingPin, g_uvm_perf_thrashing_pin, 0, UINT_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingMaxResets, g_uvm_perf_thrashing_max_resets, 0, UINT_MAX);
+    uvm_perf_tunables_register(UvmPerfTunableThrashingMapRemoteFirst, g_uvm_perf_thrashing_map_remote_first, 0, 1);
+}
+
 NV_STATUS uvm_perf_thrashing_init(void)
 {
     NV_STATUS status;
 
+    uvm_perf_tunables_register(UvmPerfTunableMapRemoteOnNativeAtomicsFault,
+                               uvm_perf_map_remote_on_native_atomics_fault != 0,
+                               0,
+                               1);
+
     INIT_THRASHING_PARAMETER_TOGGLE(uvm_perf_thrashing_enable, UVM_PERF_THRASHING_ENABLE_DEFAULT);
     if (!g_uvm_perf_thrashing_enable)
         return NV_OK;
 
+    INIT_THRASHING_PARAMETER_TOGGLE(uvm_perf_thrashing_auto_read_dup, UVM_PERF_THRASHING_AUTO_READ_DUP_DEFAULT);
+
+    // Don't make every fault notify the module unless it needs them
     uvm_perf_module_init("perf_thrashing",
                          UVM_PERF_MODULE_TYPE_THRASHING,
                          g_callbacks_thrashing,
-                         ARRAY_SIZE(g_callbacks_thrashing),
+                         ARRAY_SIZE(g_callbacks_thrashing) - (g_uvm_perf_thrashing_auto_read_dup ? 0 : 1),
                          &g_module_thrashing);
 
     INIT_THRASHING_PARAMETER_NONZERO_MAX(uvm_perf_thrashing_threshold,
@@ -1963,6 +2336,20 @@ NV_STATUS uvm_perf_thrashing_init(void)
 
     INIT_THRASHING_PARAMETER(uvm_perf_thrashing_max_resets, UVM_PERF_THRASHING_MAX_RESETS_DEFAULT);
 
+    INIT_THRASHING_PARAMETER_TOGGLE(uvm_perf_thrashing_map_remote_first, UVM_PERF_THRASHING_MAP_REMOTE_FIRST_DEFAULT);
+
+    INIT_THRASHING_PARAMETER_NONZERO(uvm_perf_thrashing_auto_read_dup_min_reads,
+                                     UVM_PERF_THRASHING_AUTO_READ_DUP_MIN_READS_DEFAULT);
+
+    INIT_THRASHING_PARAMETER_MAX(uvm_perf_thrashing_auto_read_dup_max_write_pct,
+                                 UVM_PERF_THRASHING_AUTO_READ_DUP_MAX_WRITE_PCT_DEFAULT,
+                                 100);
+
+    INIT_THRASHING_PARAMETER_NONZERO(uvm_perf_thrashing_auto_read_dup_write_storm,
+                                     UVM_PERF_THRASHING_AUTO_READ_DUP_WRITE_STORM_DEFAULT);
+
+    thrashing_register_tunables();
+
     g_va_block_thrashing_info_cache = NV_KMEM_CACHE_CREATE("uvm_block_thrashing_info_t", block_thrashing_info_t);
     if (!g_va_block_thrashing_info_cache) {
         status = NV_ERR_NO_MEMORY;
@@ -97,6 +97,12 @@ void uvm_perf_thrashing_remove_gpu(uvm_gpu_t *gpu);
 // uvm_perf_heuristics.h
 NV_STATUS uvm_perf_thrashing_load(uvm_va_space_t *va_space);
 NV_STATUS uvm_perf_thrashing_register_gpu(uvm_va_space_t *va_space, uvm_gpu_t *gpu);
+
+// Recompute the thrashing parameters of the VA space after its tunables
+// changed. Parameters overridden by tests are left untouched.
+//
+// VA space lock needs to be held in write mode
+void uvm_perf_thrashing_apply_tunables(uvm_va_space_t *va_space);
 void uvm_perf_thrashing_stop(uvm_va_space_t *va_space);
 void uvm_perf_thrashing_unload(uvm_va_space_t *va_space);
 
@@ -0,0 +1,201 @@
+/*******************************************************************************
+    Copyright (c) 2023 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_api.h"
+#include "uvm_perf_thrashing.h"
+#include "uvm_perf_tunables.h"
+#include "uvm_va_space.h"
+
+// Default value of the UvmPerfTunables registry key
+extern char *NVreg_UvmPerfTunables;
+
+typedef struct
+{
+    // Name of the module parameter that provides the default value, also used
+    // in the UvmPerfTunables registry key
+    const char *name;
+
+    bool registered;
+    NvU64 value;
+    NvU64 min;
+    NvU64 max;
+} uvm_perf_tunable_desc_t;
+
+static uvm_perf_tunable_desc_t g_uvm_perf_tunables[UvmPerfTunableCount] =
+{
+    [UvmPerfTunablePrefetchEnable]                = { .name = "uvm_perf_prefetch_enable" },
+    [UvmPerfTunablePrefetchThreshold]             = { .name = "uvm_perf_prefetch_threshold" },
+    [UvmPerfTunablePrefetchMinFaults]             = { .name = "uvm_perf_prefetch_min_faults" },
+    [UvmPerfTunablePrefetchStreamsEnable]         = { .name = "uvm_perf_prefetch_streams_enable" },
+    [UvmPerfTunablePrefetchStreamConfidence]      = { .name = "uvm_perf_prefetch_stream_confidence" },
+    [UvmPerfTunableThrashingEnable]               = { .name = "uvm_perf_thrashing_enable" },
+    [UvmPerfTunableThrashingThreshold]            = { .name = "uvm_perf_thrashing_threshold" },
+    [UvmPerfTunableThrashingPinThreshold]         = { .name = "uvm_perf_thrashing_pin_threshold" },
+    [UvmPerfTunableThrashingLapseUsec]            = { .name = "uvm_perf_thrashing_lapse_usec" },
+    [UvmPerfTunableThrashingNap]                  = { .name = "uvm_perf_thrashing_nap" },
+    [UvmPerfTunableThrashingEpoch]                = { .name = "uvm_perf_thrashing_epoch" },
+    [UvmPerfTunableThrashingPin]                  = { .name = "uvm_perf_thrashing_pin" },
+    [UvmPerfTunableThrashingMaxResets]            = { .name = "uvm_perf_thrashing_max_resets" },
+    [UvmPerfTunableMapRemoteOnNativeAtomicsFault] = { .name = "uvm_perf_map_remote_on_native_atomics_fault" },
+    [UvmPerfTunableMapRemoteOnEviction]           = { .name = "uvm_perf_map_remote_on_eviction" },
+    [UvmPerfTunableEvictionPriority]              = { .name = "uvm_perf_eviction_priority" },
+    [UvmPerfTunableThrashingMapRemoteFirst]       = { .name = "uvm_perf_thrashing_map_remote_first" },
+};
+
+static bool tunable_is_thrashing(UvmPerfTunable tunable)
+{
+    return (tunable >= UvmPerfTunableThrashingEnable && tunable <= UvmPerfTunableThrashingMaxResets) ||
+           tunable == UvmPerfTunableThrashingMapRemoteFirst;
+}
+
+void uvm_perf_tunables_register(UvmPerfTunable tunable, NvU64 value, NvU64 min, NvU64 max)
+{
+    uvm_perf_tunable_desc_t *desc;
+
+    UVM_ASSERT(tunable < UvmPerfTunableCount);
+    UVM_ASSERT(min <= value && value <= max);
+
+    desc = &g_uvm_perf_tunables[tunable];
+
+    desc->registered = true;
+    desc->value = value;
+    desc->min = min;
+    desc->max = max;
+}
+
+// Parse a single name=value pair of the registry key. The pair spans
+// [str, end).
+static void apply_registry_override(const char *str, const char *end)
+{
+    const char *equal = str;
+    NvU64 value = 0;
+    size_t name_len;
+    UvmPerfTunable tunable;
+
+    while (equal < end && *equal != '=')
+        equal++;
+
+    if (equal == end || equal + 1 == end)
+        goto invalid;
+
+    name_len = equal - str;
+
+    for (str = equal + 1; str < end; str++) {
+        if (*str < '0' || *str > '9' || value > (NV_U64_MAX - 9) / 10)
+            goto invalid;
+
+        value = value * 10 + (*str - '0');
+    }
+
+    for (tunable = 0; tunable < UvmPerfTunableCount; tunable++) {
+        uvm_perf_tunable_desc_t *desc = &g_uvm_perf_tunables[tunable];
+
+        if (strlen(desc->name) != name_len || memcmp(desc->name, equal - name_len, name_len) != 0)
+            continue;
+
+        if (!desc->registered) {
+            pr_info("Ignoring %s in UvmPerfTunables, the heuristic is disabled\n", desc->name);
+        }
+        else if (value < desc->min || value > desc->max) {
+            pr_info("Invalid value %llu for %s in UvmPerfTunables. Using %llu instead\n",
+                    value, desc->name, desc->value);
+        }
+        else {
+            desc->value = value;
+        }
+
+        return;
+    }
+
+invalid:
+    pr_info("Ignoring invalid entry in UvmPerfTunables\n");
+}
+
+void uvm_perf_tunables_init(void)
+{
+    const char *str = NVreg_UvmPerfTunables;
+
+    if (!str)
+        return;
+
+    while (*str) {
+        const char *end = strchr(str, ',');
+
+        if (!end)
+            end = str + strlen(str);
+
+        if (end > str)
+            apply_registry_override(str, end);
+
+        str = *end ? end + 1 : end;
+    }
+}
+
+void uvm_perf_tunables_init_va_space(uvm_perf_tunables_t *tunables)
+{
+    UvmPerfTunable tunable;
+
+    for (tunable = 0; tunable < UvmPerfTunableCount; tunable++)
+        tunables->values[tunable] = g_uvm_perf_tunables[tunable].value;
+}
+
+NV_STATUS uvm_api_set_perf_tunable(UVM_SET_PERF_TUNABLE_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_perf_tunable_desc_t *desc;
+
+    if (params->tunable >= UvmPerfTunableCount)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    desc = &g_uvm_perf_tunables[params->tunable];
+    if (!desc->registered)
+        return NV_ERR_NOT_SUPPORTED;
+
+    if (params->value < desc->min || params->value > desc->max)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    uvm_va_space_down_write(va_space);
+
+    UVM_WRITE_ONCE(va_space->perf_tunables.values[params->tunable], params->value);
+
+    // Thrashing detection keeps its own post-processed copy of the values, so
+    // recompute it while readers are still excluded.
+    if (tunable_is_thrashing(params->tunable))
+        uvm_perf_thrashing_apply_tunables(va_space);
+
+    uvm_va_space_up_write(va_space);
+
+    return NV_OK;
+}
+
+NV_STATUS uvm_api_get_perf_tunable(UVM_GET_PERF_TUNABLE_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+
+    if (params->tunable >= UvmPerfTunableCount)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    params->value = uvm_perf_tunable_get(&va_space->perf_tunables, params->tunable);
+
+    return NV_OK;
+}
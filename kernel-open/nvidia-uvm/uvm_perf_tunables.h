@@ -0,0 +1,58 @@
+/*******************************************************************************
+    Copyright (c) 2023 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_PERF_TUNABLES_H__
+#define __UVM_PERF_TUNABLES_H__
+
+#include "uvm_common.h"
+#include "uvm_types.h"
+
+// Per-VA space values of the performance heuristics tunables (UvmPerfTunable).
+//
+// Values are only written with the VA space lock held in write mode, so the
+// heuristics, which run with the lock held in read mode or not at all, read
+// them without taking any additional lock.
+typedef struct
+{
+    NvU64 values[UvmPerfTunableCount];
+} uvm_perf_tunables_t;
+
+static NvU64 uvm_perf_tunable_get(const uvm_perf_tunables_t *tunables, UvmPerfTunable tunable)
+{
+    return UVM_READ_ONCE(tunables->values[tunable]);
+}
+
+// Record the module-wide default value of a tunable and its valid range. This
+// is called by the heuristic that owns the tunable at init time, once it has
+// validated its module parameter. Tunables that are never registered, because
+// their heuristic is disabled, cannot be changed per VA space.
+void uvm_perf_tunables_register(UvmPerfTunable tunable, NvU64 value, NvU64 min, NvU64 max);
+
+// Apply the overrides of the UvmPerfTunables registry key to the registered
+// defaults. Must be called after all the heuristics have been initialized.
+void uvm_perf_tunables_init(void);
+
+// Initialize the tunables of a new VA space with the module-wide defaults
+void uvm_perf_tunables_init_va_space(uvm_perf_tunables_t *tunables);
+
+#endif // __UVM_PERF_TUNABLES_H__
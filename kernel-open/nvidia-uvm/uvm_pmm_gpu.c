@@ -87,6 +87,10 @@
 // chunk become free, they are merged into one bigger chunk. See
 // free_chunk_with_merges().
 //
+// A few zeroed free user root chunks are kept around instead of being returned
+// to PMA, so that populating new memory can skip zeroing it in the fault path.
+// They are zeroed by CE in the background, see zero_pool_refill().
+//
 // Splitting and merging already allocated chunks is also exposed to the users of
 // allocated chunks. See uvm_pmm_gpu_split_chunk() and uvm_pmm_gpu_merge_chunk().
 //
@@ -95,14 +99,23 @@
 // only as the last step and free_chunk() that similarly first tries performing
 // a quick free.
 //
+// In front of the free lists, 4K and 64K user chunks are kept in per-CPU
+// caches, see chunk_cache_alloc() and chunk_cache_free(). Cached chunks stay
+// pinned, so the caches are drained before picking a root chunk to evict,
+// before failing an allocation that needs a split and on PMA eviction. Chunks
+// overflowing a cache are freed with merges in batches from the lazy free
+// queue, see process_deferred_free().
+//
 // When a memory allocation from PMA fails and eviction is requested, PMM will
 // check whether it can evict any user memory chunks to satisfy the request.
 // All allocated user memory root chunks are tracked in an LRU list
 // (root_chunks.va_block_used). A root chunk is moved to the tail of that list
 // whenever any of its subchunks is allocated (unpinned) by a VA block (see
-// uvm_pmm_gpu_unpin_allocated()). When a root chunk is selected for eviction,
-// it has the eviction flag set (see pick_root_chunk_to_evict()). This flag
-// affects many of the PMM operations on all of the subchunks of the root chunk
+// uvm_pmm_gpu_unpin_allocated()). The victim is picked from that list with a
+// CLOCK scan that skips recently accessed chunks and chunks with a higher
+// eviction priority (see pick_used_root_chunk_locked()). When a root chunk is
+// selected for eviction, it has the eviction flag set (see
+// pick_root_chunk_to_evict()). This flag affects many of the PMM operations on all of the subchunks of the root chunk
 // being evicted. See usage of (root_)chunk_is_in_eviction(), in particular in
 // chunk_free_locked() and claim_free_chunk().
 //
@@ -166,6 +179,7 @@
 #include "uvm_pmm_gpu.h"
 #include "uvm_mem.h"
 #include "uvm_mmu.h"
+#include "uvm_push.h"
 #include "uvm_global.h"
 #include "uvm_kvmalloc.h"
 #include "uvm_va_space.h"
@@ -186,11 +200,44 @@ MODULE_PARM_DESC(uvm_global_oversubscription, "Enable (1) or disable (0) global
 static unsigned uvm_perf_pma_batch_nonpinned_order = UVM_PERF_PMA_BATCH_NONPINNED_ORDER_DEFAULT;
 module_param(uvm_perf_pma_batch_nonpinned_order, uint, S_IRUGO);
 
+// Keep per-CPU caches of free 4K and 64K user chunks in front of the free
+// lists (see uvm_pmm_gpu_chunk_cache_t). The caches are disabled when the
+// builtin tests are enabled, since the PMM tests check the state of freed
+// chunks.
+static unsigned uvm_perf_pmm_chunk_cache_enable = 1;
+module_param(uvm_perf_pmm_chunk_cache_enable, uint, S_IRUGO);
+
+// Maximum number of used root chunks visited by the CLOCK scan when picking a
+// root chunk to evict. 0 evicts the least recently used chunk, ignoring access
+// information and eviction priorities.
+static unsigned uvm_perf_pmm_eviction_clock_scan = 64;
+module_param(uvm_perf_pmm_eviction_clock_scan, uint, S_IRUGO);
+
+// Period of the cold memory scanner, which dumps the vidmem access bit buffer
+// of each GPU to find the root chunks that are no longer accessed (see
+// access_bits_scan()). The scanner only runs on GPUs for which RM provides an
+// access bit buffer. 0 disables it.
+static unsigned uvm_perf_pmm_access_bits_scan_period_ms = 200;
+module_param(uvm_perf_pmm_access_bits_scan_period_ms, uint, S_IRUGO);
+
+// Number of zeroed free user root chunks to keep, so that populating new
+// managed memory doesn't have to zero it in the fault path. The pool is
+// refilled in the background, see zero_pool_refill(). 0 disables the pool.
+static unsigned uvm_perf_pmm_zero_pool_root_chunks = 8;
+module_param(uvm_perf_pmm_zero_pool_root_chunks, uint, S_IRUGO);
+
+// Keep allocation latency histograms and eviction, split and merge counters
+// for each GPU (see uvm_pmm_gpu_stats_t). They are printed when the GPU is
+// removed, and the counters can be read with UVM_TEST_PMM_QUERY. 0 disables
+// them.
+static unsigned uvm_perf_pmm_stats = 0;
+module_param(uvm_perf_pmm_stats, uint, S_IRUGO);
+
 // Helper type for refcounting cache
 typedef struct
 {
     // Cache for given split size
-    heap cache;
+    uvm_kmem_cache_t *cache;
 
     // Number of GPUs using given split size
     NvU32 refcount;
@@ -309,7 +356,10 @@ static NV_STATUS alloc_root_chunk(uvm_pmm_gpu_t *pmm,
 static void free_root_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root_chunk, free_root_chunk_mode_t free_mode);
 static NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+static void free_chunk_uncached(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 static void free_chunk_with_merges(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+static bool chunk_caches_drain_locked(uvm_pmm_gpu_t *pmm);
+static void zero_pool_schedule_refill(uvm_pmm_gpu_t *pmm);
 static bool free_next_available_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type);
 static struct list *find_free_list(uvm_pmm_gpu_t *pmm,
                                         uvm_pmm_gpu_memory_type_t type,
@@ -546,6 +596,127 @@ static uvm_pmm_gpu_memory_type_t pmm_squash_memory_type(uvm_parent_gpu_t *parent
     return UVM_PMM_GPU_MEMORY_TYPE_KERNEL;
 }
 
+static size_t pmm_stats_chunk_size_index(uvm_pmm_gpu_t *pmm,
+                                         uvm_pmm_gpu_memory_type_t type,
+                                         uvm_chunk_size_t chunk_size)
+{
+    return hweight_long(pmm->chunk_sizes[type] & (chunk_size - 1));
+}
+
+static void pmm_stats_record_alloc(uvm_pmm_gpu_t *pmm,
+                                   uvm_pmm_gpu_memory_type_t type,
+                                   uvm_chunk_size_t chunk_size,
+                                   NvU64 start_time)
+{
+    NvU64 elapsed;
+    NvU32 bucket = 0;
+
+    if (!pmm->stats)
+        return;
+
+    elapsed = NV_GETTIME() - start_time;
+    if (elapsed > 0)
+        bucket = min((NvU32)ilog2(elapsed), (NvU32)UVM_PMM_ALLOC_LATENCY_BUCKETS - 1);
+
+    atomic64_inc(&pmm->stats->alloc_latency[type][pmm_stats_chunk_size_index(pmm, type, chunk_size)][bucket]);
+}
+
+#define PMM_STATS_INC(pmm, counter)                 \
+    do {                                            \
+        if ((pmm)->stats)                           \
+            atomic64_inc(&(pmm)->stats->counter);   \
+    } while (0)
+
+static void pmm_stats_print(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    uvm_pmm_gpu_stats_t *stats = pmm->stats;
+    uvm_pmm_gpu_memory_type_t type;
+    NvU64 free_root_chunks = 0;
+    size_t i;
+
+    if (!stats)
+        return;
+
+    for (i = 0; i < pmm->root_chunks.count; i++) {
+        if (pmm->root_chunks.array[i].chunk.state == UVM_PMM_GPU_CHUNK_STATE_FREE)
+            free_root_chunks++;
+    }
+
+    UVM_INFO_PRINT("PMM stats on GPU %s:\n", uvm_gpu_name(gpu));
+    UVM_INFO_PRINT("  root chunk splits %llu merges %llu, all chunk splits %llu merges %llu\n",
+                   atomic64_read(&stats->root_chunk_splits),
+                   atomic64_read(&stats->root_chunk_merges),
+                   atomic64_read(&stats->chunk_splits),
+                   atomic64_read(&stats->chunk_merges));
+    UVM_INFO_PRINT("  root chunks evicted for PMM allocations %llu, for PMA %llu\n",
+                   atomic64_read(&stats->root_chunks_evicted_for_alloc),
+                   atomic64_read(&stats->root_chunks_evicted_for_pma));
+    UVM_INFO_PRINT("  free root chunks held by PMM %llu, free 2M pages in PMA %llu\n",
+                   free_root_chunks,
+                   pmm->pma_stats ? (NvU64)UVM_READ_ONCE(pmm->pma_stats->numFreePages2m) : 0);
+
+    UVM_INFO_PRINT("  allocation latencies (calls per [2^i, 2^(i+1)) ns bucket):\n");
+    for (type = 0; type < UVM_PMM_GPU_MEMORY_TYPE_COUNT; type++) {
+        uvm_chunk_size_t chunk_size;
+
+        for_each_chunk_size(chunk_size, pmm->chunk_sizes[type]) {
+            size_t size_index = pmm_stats_chunk_size_index(pmm, type, chunk_size);
+            NvU32 bucket;
+
+            for (bucket = 0; bucket < UVM_PMM_ALLOC_LATENCY_BUCKETS; bucket++) {
+                NvU64 count = atomic64_read(&stats->alloc_latency[type][size_index][bucket]);
+
+                if (count != 0)
+                    UVM_INFO_PRINT("    %s chunk size 0x%x[%u]: %llu\n",
+                                   uvm_pmm_gpu_memory_type_string(type),
+                                   chunk_size,
+                                   bucket,
+                                   count);
+            }
+        }
+    }
+}
+
+NV_STATUS uvm_pmm_gpu_query_stat(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_stat_t stat, NvU64 *value)
+{
+    uvm_pmm_gpu_stats_t *stats = pmm->stats;
+
+    if (!stats)
+        return NV_ERR_INVALID_STATE;
+
+    switch (stat) {
+        case UVM_PMM_GPU_STAT_ROOT_CHUNK_SPLITS:
+            *value = atomic64_read(&stats->root_chunk_splits);
+            break;
+        case UVM_PMM_GPU_STAT_ROOT_CHUNK_MERGES:
+            *value = atomic64_read(&stats->root_chunk_merges);
+            break;
+        case UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_ALLOC:
+            *value = atomic64_read(&stats->root_chunks_evicted_for_alloc);
+            break;
+        case UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_PMA:
+            *value = atomic64_read(&stats->root_chunks_evicted_for_pma);
+            break;
+        case UVM_PMM_GPU_STAT_ALLOCS: {
+            uvm_pmm_gpu_memory_type_t type;
+            size_t size_index;
+            NvU32 bucket;
+
+            *value = 0;
+            for (type = 0; type < UVM_PMM_GPU_MEMORY_TYPE_COUNT; type++)
+                for (size_index = 0; size_index < UVM_MAX_CHUNK_SIZES; size_index++)
+                    for (bucket = 0; bucket < UVM_PMM_ALLOC_LATENCY_BUCKETS; bucket++)
+                        *value += atomic64_read(&stats->alloc_latency[type][size_index][bucket]);
+            break;
+        }
+        default:
+            return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_pmm_gpu_alloc(uvm_pmm_gpu_t *pmm,
                             size_t num_chunks,
                             uvm_chunk_size_t chunk_size,
@@ -557,6 +728,7 @@ NV_STATUS uvm_pmm_gpu_alloc(uvm_pmm_gpu_t *pmm,
     uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
     NV_STATUS status;
     uvm_tracker_t local_tracker = UVM_TRACKER_INIT();
+    NvU64 start_time = pmm->stats ? NV_GETTIME() : 0;
     size_t i;
 
     UVM_ASSERT((unsigned)mem_type < UVM_PMM_GPU_MEMORY_TYPE_COUNT);
@@ -600,6 +772,10 @@ NV_STATUS uvm_pmm_gpu_alloc(uvm_pmm_gpu_t *pmm,
     if (status != NV_OK)
         goto error;
 
+    // Replace the zeroed root chunks this allocation may have consumed
+    if (mem_type == UVM_PMM_GPU_MEMORY_TYPE_USER && num_chunks > 0)
+        zero_pool_schedule_refill(pmm);
+
     if (out_tracker) {
         status = uvm_tracker_add_tracker_safe(out_tracker, &local_tracker);
         uvm_tracker_clear(&local_tracker);
@@ -607,7 +783,10 @@ NV_STATUS uvm_pmm_gpu_alloc(uvm_pmm_gpu_t *pmm,
             goto error;
     }
 
-    return uvm_tracker_wait_deinit(&local_tracker);
+    status = uvm_tracker_wait_deinit(&local_tracker);
+    pmm_stats_record_alloc(pmm, mem_type, chunk_size, start_time);
+
+    return status;
 
 error:
     uvm_tracker_deinit(&local_tracker);
@@ -821,6 +1000,10 @@ static void merge_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     uvm_assert_mutex_locked(&pmm->lock);
     UVM_ASSERT(assert_chunk_mergeable(pmm, chunk));
 
+    PMM_STATS_INC(pmm, chunk_merges);
+    if (chunk_is_root_chunk(chunk))
+        PMM_STATS_INC(pmm, root_chunk_merges);
+
     // Transition the chunk state under the list lock first and then clean up
     // the subchunk state.
     uvm_spin_lock(&pmm->list_lock);
@@ -862,10 +1045,10 @@ static void merge_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
         if (child_state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED)
             UVM_ASSERT(subchunk->va_block != NULL);
 
-        kmem_cache_free(CHUNK_CACHE, subchunk);
+        uvm_kmem_cache_free(CHUNK_CACHE, subchunk);
     }
 
-    kmem_cache_free(chunk_split_cache[ilog2(num_sub)].cache, suballoc);
+    uvm_kmem_cache_free(chunk_split_cache[ilog2(num_sub)].cache, suballoc);
 }
 
 // Checks that chunk is below ancestor in the tree. Always returns true so it
@@ -1361,6 +1544,14 @@ NV_STATUS uvm_pmm_gpu_indirect_peer_map(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chu
     return status;
 }
 
+NvU64 uvm_pmm_gpu_free_memory(uvm_pmm_gpu_t *pmm)
+{
+    if (!pmm->pma_stats)
+        return 0;
+
+    return UVM_READ_ONCE(pmm->pma_stats->numFreePages64k) * UVM_PAGE_SIZE_64K;
+}
+
 NvU64 uvm_pmm_gpu_indirect_peer_addr(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, uvm_gpu_t *accessing_gpu)
 {
     uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
@@ -1407,17 +1598,22 @@ uvm_gpu_address_t uvm_pmm_gpu_peer_copy_address(uvm_pmm_gpu_t *pmm,
     uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
     uvm_gpu_peer_t *peer_caps = uvm_gpu_peer_caps(accessing_gpu, gpu);
     uvm_gpu_identity_mapping_t *gpu_peer_mapping;
+    uvm_gpu_peer_copy_mode_t copy_mode;
 
     UVM_ASSERT(peer_caps->link_type != UVM_GPU_LINK_INVALID);
 
-    if (peer_caps->is_indirect_peer ||
-        (accessing_gpu->parent->peer_copy_mode == UVM_GPU_PEER_COPY_MODE_PHYSICAL)) {
-        // Indirect peers are accessed as sysmem addresses, so they don't need
-        // to use identity mappings.
+    // Indirect peers are accessed as sysmem addresses, so they don't need to
+    // use identity mappings.
+    if (peer_caps->is_indirect_peer)
+        return uvm_gpu_address_from_phys(uvm_pmm_gpu_peer_phys_address(pmm, chunk, accessing_gpu));
+
+    // Copies can't cross the chunk, so its size is the size class of the
+    // largest copy done with the address.
+    copy_mode = uvm_gpu_peer_copy_mode(accessing_gpu, gpu, uvm_gpu_chunk_get_size(chunk));
+    if (copy_mode == UVM_GPU_PEER_COPY_MODE_PHYSICAL)
         return uvm_gpu_address_from_phys(uvm_pmm_gpu_peer_phys_address(pmm, chunk, accessing_gpu));
-    }
 
-    UVM_ASSERT(accessing_gpu->parent->peer_copy_mode == UVM_GPU_PEER_COPY_MODE_VIRTUAL);
+    UVM_ASSERT(copy_mode == UVM_GPU_PEER_COPY_MODE_VIRTUAL);
     gpu_peer_mapping = uvm_gpu_get_peer_mapping(accessing_gpu, gpu->id);
 
     return uvm_gpu_address_virtual(gpu_peer_mapping->base + chunk->address);
@@ -1605,6 +1801,11 @@ static NV_STATUS evict_root_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root
 
     UVM_ASSERT(check_chunk(pmm, chunk));
 
+    if (pmm_context == PMM_CONTEXT_PMA_EVICTION)
+        PMM_STATS_INC(pmm, root_chunks_evicted_for_pma);
+    else
+        PMM_STATS_INC(pmm, root_chunks_evicted_for_alloc);
+
     return NV_OK;
 
 error:
@@ -1671,10 +1872,17 @@ static void chunk_start_eviction(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     uvm_gpu_chunk_set_in_eviction(chunk, true);
 }
 
-static void root_chunk_update_eviction_list(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, struct list *list)
+static void root_chunk_update_eviction_list(uvm_pmm_gpu_t *pmm,
+                                            uvm_gpu_chunk_t *chunk,
+                                            struct list *list,
+                                            NvU32 eviction_priority)
 {
+    UVM_ASSERT(eviction_priority <= UVM_PMM_GPU_EVICTION_PRIORITY_MAX);
+
     uvm_spin_lock(&pmm->list_lock);
 
+    root_chunk_from_chunk(pmm, chunk)->eviction_priority = eviction_priority;
+
     UVM_ASSERT(uvm_gpu_chunk_get_size(chunk) == UVM_CHUNK_SIZE_MAX);
     UVM_ASSERT(uvm_pmm_gpu_memory_type_is_user(chunk->type));
     UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED ||
@@ -1691,14 +1899,100 @@ static void root_chunk_update_eviction_list(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t
     uvm_spin_unlock(&pmm->list_lock);
 }
 
-void uvm_pmm_gpu_mark_root_chunk_used(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+void uvm_pmm_gpu_mark_root_chunk_used(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, NvU32 eviction_priority)
 {
-    root_chunk_update_eviction_list(pmm, chunk, &pmm->root_chunks.va_block_used);
+    root_chunk_update_eviction_list(pmm, chunk, &pmm->root_chunks.va_block_used, eviction_priority);
+    UVM_WRITE_ONCE(root_chunk_from_chunk(pmm, chunk)->idle_scans, 0);
 }
 
 void uvm_pmm_gpu_mark_root_chunk_unused(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 {
-    root_chunk_update_eviction_list(pmm, chunk, &pmm->root_chunks.va_block_unused);
+    root_chunk_update_eviction_list(pmm, chunk, &pmm->root_chunks.va_block_unused, 0);
+}
+
+void uvm_pmm_gpu_mark_root_chunk_accessed(uvm_pmm_gpu_t *pmm, NvU64 address)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    uvm_gpu_root_chunk_t *root_chunk;
+    NvU8 access_count;
+
+    if (!uvm_gpu_supports_eviction(gpu) || address >= gpu->mem_info.max_allocatable_address)
+        return;
+
+    root_chunk = root_chunk_from_address(pmm, address);
+
+    access_count = UVM_READ_ONCE(root_chunk->access_count);
+    if (access_count < UVM_PMM_ROOT_CHUNK_ACCESS_COUNT_MAX)
+        UVM_WRITE_ONCE(root_chunk->access_count, access_count + 1);
+
+    if (UVM_READ_ONCE(root_chunk->idle_scans) != 0)
+        UVM_WRITE_ONCE(root_chunk->idle_scans, 0);
+}
+
+bool uvm_pmm_gpu_root_chunk_idle_scans(uvm_pmm_gpu_t *pmm, NvU64 address, NvU32 *idle_scans)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+
+    if (!UVM_READ_ONCE(pmm->access_bits.enabled) || address >= gpu->mem_info.max_allocatable_address)
+        return false;
+
+    *idle_scans = UVM_READ_ONCE(root_chunk_from_address(pmm, address)->idle_scans);
+    return true;
+}
+
+// Pick a root chunk to evict from the used list with a CLOCK scan over at most
+// uvm_perf_pmm_eviction_clock_scan chunks. The list is in the order in which
+// the chunks were last marked as used, and the scan gives every chunk that was
+// accessed since the last pass a second chance: its access count is halved and
+// the chunk is rotated to the tail. The first chunk with no recent accesses and
+// the lowest eviction priority is picked. Otherwise, the scanned chunk with the
+// lowest score is, preferring among equal scores the chunk that the access bit
+// scanner has found idle for the longest.
+static uvm_gpu_chunk_t *pick_used_root_chunk_locked(uvm_pmm_gpu_t *pmm)
+{
+    struct list *used = &pmm->root_chunks.va_block_used;
+    uvm_gpu_chunk_t *first = NULL;
+    uvm_gpu_chunk_t *victim = NULL;
+    unsigned victim_score = UINT_MAX;
+    NvU8 victim_idle_scans = 0;
+    unsigned scanned;
+
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    for (scanned = 0; scanned < uvm_perf_pmm_eviction_clock_scan; scanned++) {
+        uvm_gpu_chunk_t *chunk = list_first_chunk(used);
+        uvm_gpu_root_chunk_t *root_chunk;
+        NvU8 access_count;
+        unsigned score;
+
+        // Stop once the scan has wrapped around the list
+        if (!chunk || chunk == first)
+            break;
+
+        if (!first)
+            first = chunk;
+
+        root_chunk = root_chunk_from_chunk(pmm, chunk);
+        access_count = UVM_READ_ONCE(root_chunk->access_count);
+        score = root_chunk->eviction_priority * (UVM_PMM_ROOT_CHUNK_ACCESS_COUNT_MAX + 1) + access_count;
+        if (score == 0)
+            return chunk;
+
+        if (score < victim_score ||
+            (score == victim_score && UVM_READ_ONCE(root_chunk->idle_scans) > victim_idle_scans)) {
+            victim = chunk;
+            victim_score = score;
+            victim_idle_scans = UVM_READ_ONCE(root_chunk->idle_scans);
+        }
+
+        UVM_WRITE_ONCE(root_chunk->access_count, access_count / 2);
+        list_move_tail(&chunk->list, used);
+    }
+
+    if (victim)
+        return victim;
+
+    return list_first_chunk(used);
 }
 
 static uvm_gpu_root_chunk_t *pick_root_chunk_to_evict(uvm_pmm_gpu_t *pmm)
@@ -1728,10 +2022,11 @@ static uvm_gpu_root_chunk_t *pick_root_chunk_to_evict(uvm_pmm_gpu_t *pmm)
     if (!chunk)
         chunk = list_first_chunk(&pmm->root_chunks.va_block_unused);
 
-    // TODO: Bug 1765193: Move the chunks to the tail of the used list whenever
-    // they get mapped.
+    // The used list is only ordered by residency changes, so use the access
+    // information gathered by uvm_pmm_gpu_mark_root_chunk_accessed() to avoid
+    // evicting chunks that are still hot.
     if (!chunk)
-        chunk = list_first_chunk(&pmm->root_chunks.va_block_used);
+        chunk = pick_used_root_chunk_locked(pmm);
 
     if (chunk)
         chunk_start_eviction(pmm, chunk);
@@ -1815,6 +2110,10 @@ static NV_STATUS pick_and_evict_root_chunk_retry(uvm_pmm_gpu_t *pmm,
 {
     NV_STATUS status;
 
+    // Chunks sitting in the per-CPU caches keep their root chunks pinned, give
+    // them back first so that their root chunks can be picked.
+    chunk_caches_drain_locked(pmm);
+
     // Eviction can fail if the chunk gets selected for PMA eviction at
     // the same time. Keep retrying.
     do {
@@ -1864,11 +2163,13 @@ static uvm_gpu_chunk_t *find_free_chunk_locked(uvm_pmm_gpu_t *pmm,
     return NULL;
 }
 
-static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+static uvm_gpu_chunk_t *claim_free_chunk_locked(uvm_pmm_gpu_t *pmm,
+                                                uvm_pmm_gpu_memory_type_t type,
+                                                uvm_chunk_size_t chunk_size)
 {
     uvm_gpu_chunk_t *chunk;
 
-    uvm_spin_lock(&pmm->list_lock);
+    uvm_assert_spinlock_locked(&pmm->list_lock);
 
     // Prefer zero free chunks as they are likely going to be used for a new
     // allocation.
@@ -1881,7 +2182,7 @@ static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_
         chunk = find_free_chunk_locked(pmm, type, chunk_size, UVM_PMM_LIST_NO_ZERO);
 
     if (!chunk)
-        goto out;
+        return NULL;
 
     UVM_ASSERT_MSG(uvm_gpu_chunk_get_size(chunk) == chunk_size, "chunk size %u expected %u\n",
             uvm_gpu_chunk_get_size(chunk), chunk_size);
@@ -1899,12 +2200,323 @@ static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_
     chunk_pin(pmm, chunk);
     chunk_update_lists_locked(pmm, chunk);
 
-out:
+    return chunk;
+}
+
+static uvm_gpu_chunk_t *claim_free_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+{
+    uvm_gpu_chunk_t *chunk;
+
+    uvm_spin_lock(&pmm->list_lock);
+    chunk = claim_free_chunk_locked(pmm, type, chunk_size);
+    uvm_spin_unlock(&pmm->list_lock);
+
+    return chunk;
+}
+
+// Return the index of the chunk size in the per-CPU chunk caches, or -1 if
+// chunks of the given type and size are not cached.
+static int chunk_cache_size_index(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type, uvm_chunk_size_t chunk_size)
+{
+    if (!pmm->chunk_caches.cpus || type != UVM_PMM_GPU_MEMORY_TYPE_USER)
+        return -1;
+
+    if (!(pmm->chunk_sizes[type] & chunk_size))
+        return -1;
+
+    if (chunk_size == UVM_CHUNK_SIZE_4K)
+        return 0;
+
+    if (chunk_size == UVM_CHUNK_SIZE_64K)
+        return 1;
+
+    return -1;
+}
+
+static uvm_pmm_gpu_chunk_cache_t *chunk_cache_this_cpu(uvm_pmm_gpu_t *pmm)
+{
+    return &pmm->chunk_caches.cpus[current_cpu()->id % pmm->chunk_caches.count];
+}
+
+// Chunks that overflowed a cache are handed to the lazy free queue, which frees
+// them with the PMM lock taken once for the whole batch and performs any merges
+// that become possible.
+static void chunk_cache_defer_free(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t **chunks, NvU32 num_chunks)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    NvU32 i;
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    for (i = 0; i < num_chunks; i++) {
+        UVM_ASSERT(chunks[i]->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+        list_add_tail(&chunks[i]->list, &pmm->chunk_caches.deferred_free);
+    }
+
+    uvm_spin_unlock(&pmm->list_lock);
+
+    nv_kthread_q_schedule_q_item(&gpu->parent->lazy_free_q, &pmm->chunk_caches.deferred_free_q_item);
+}
+
+// Allocate a chunk from the cache of the current CPU. If the cache is empty,
+// claim a batch of free chunks with a single acquisition of the list lock and
+// keep all but one of them in the cache. Returns NULL if the chunk is not
+// cacheable, or if there is no free chunk of the given size and the caller has
+// to split a bigger one.
+static uvm_gpu_chunk_t *chunk_cache_alloc(uvm_pmm_gpu_t *pmm,
+                                          uvm_pmm_gpu_memory_type_t type,
+                                          uvm_chunk_size_t chunk_size)
+{
+    int size_index = chunk_cache_size_index(pmm, type, chunk_size);
+    uvm_gpu_chunk_t *batch[UVM_PMM_CHUNK_CACHE_BATCH];
+    uvm_pmm_gpu_chunk_cache_t *cache;
+    uvm_gpu_chunk_t *chunk = NULL;
+    NvU32 num_chunks = 0;
+    NvU32 num_cached;
+
+    if (size_index < 0)
+        return NULL;
+
+    cache = chunk_cache_this_cpu(pmm);
+
+    uvm_spin_lock(&cache->lock);
+    if (cache->sizes[size_index].count > 0)
+        chunk = cache->sizes[size_index].chunks[--cache->sizes[size_index].count];
+    uvm_spin_unlock(&cache->lock);
+
+    if (chunk)
+        return chunk;
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    while (num_chunks < ARRAY_SIZE(batch)) {
+        chunk = claim_free_chunk_locked(pmm, type, chunk_size);
+        if (!chunk)
+            break;
+
+        batch[num_chunks++] = chunk;
+    }
+
     uvm_spin_unlock(&pmm->list_lock);
 
+    if (num_chunks == 0)
+        return NULL;
+
+    chunk = batch[--num_chunks];
+
+    uvm_spin_lock(&cache->lock);
+
+    num_cached = min(num_chunks, (NvU32)UVM_PMM_CHUNK_CACHE_DEPTH - cache->sizes[size_index].count);
+    memcpy(&cache->sizes[size_index].chunks[cache->sizes[size_index].count],
+           batch,
+           num_cached * sizeof(batch[0]));
+    cache->sizes[size_index].count += num_cached;
+
+    uvm_spin_unlock(&cache->lock);
+
+    // The cache was refilled concurrently, by a thread that migrated to this
+    // CPU. Give the rest back.
+    if (num_cached < num_chunks)
+        chunk_cache_defer_free(pmm, batch + num_cached, num_chunks - num_cached);
+
     return chunk;
 }
 
+// Free a chunk into the cache of the current CPU. Returns false if the chunk
+// is not cacheable and has to be freed to the free lists.
+static bool chunk_cache_free(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    int size_index = chunk_cache_size_index(pmm, chunk->type, uvm_gpu_chunk_get_size(chunk));
+    uvm_gpu_chunk_t *overflow[UVM_PMM_CHUNK_CACHE_BATCH];
+    uvm_pmm_gpu_chunk_cache_t *cache;
+    NvU32 num_overflow = 0;
+    NvU32 count;
+
+    if (size_index < 0)
+        return false;
+
+    UVM_ASSERT(chunk->parent);
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    // Chunks of a root chunk picked for eviction are left to the evicting
+    // thread, see chunk_free_locked().
+    if (root_chunk_from_chunk(pmm, chunk)->chunk.in_eviction) {
+        uvm_spin_unlock(&pmm->list_lock);
+        return false;
+    }
+
+    UVM_ASSERT(chunk->state != UVM_PMM_GPU_CHUNK_STATE_ALLOCATED || !chunk->is_referenced);
+
+    // The chunk stays counted as allocated in its parent, so it only needs to
+    // be pinned to look like a chunk that has been claimed from a free list.
+    chunk->inject_split_error = false;
+    chunk->va_block_page_index = PAGES_PER_UVM_VA_BLOCK;
+    chunk->is_zero = false;
+
+    if (chunk->state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED) {
+        chunk->va_block = NULL;
+        chunk_pin(pmm, chunk);
+    }
+
+    chunk_update_lists_locked(pmm, chunk);
+
+    uvm_spin_unlock(&pmm->list_lock);
+
+    cache = chunk_cache_this_cpu(pmm);
+
+    uvm_spin_lock(&cache->lock);
+
+    // When the cache is full, hand its oldest chunks over to the lazy free
+    // queue and keep the most recently freed ones.
+    count = cache->sizes[size_index].count;
+    if (count == UVM_PMM_CHUNK_CACHE_DEPTH) {
+        num_overflow = ARRAY_SIZE(overflow);
+        memcpy(overflow, cache->sizes[size_index].chunks, sizeof(overflow));
+        memmove(cache->sizes[size_index].chunks,
+                cache->sizes[size_index].chunks + num_overflow,
+                (count - num_overflow) * sizeof(overflow[0]));
+        count -= num_overflow;
+    }
+
+    cache->sizes[size_index].chunks[count++] = chunk;
+    cache->sizes[size_index].count = count;
+
+    uvm_spin_unlock(&cache->lock);
+
+    if (num_overflow > 0)
+        chunk_cache_defer_free(pmm, overflow, num_overflow);
+
+    return true;
+}
+
+// Free all the chunks waiting on the deferred free list. Returns the number of
+// chunks freed.
+//
+// PMM lock needs to be held
+static NvU32 process_deferred_free_locked(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_chunk_t *chunk;
+    NvU32 num_freed = 0;
+
+    uvm_assert_mutex_locked(&pmm->lock);
+
+    uvm_spin_lock(&pmm->list_lock);
+
+    while (!list_empty(&pmm->chunk_caches.deferred_free)) {
+        chunk = list_first_entry(&pmm->chunk_caches.deferred_free, uvm_gpu_chunk_t, list);
+        list_del_init(&chunk->list);
+        uvm_spin_unlock(&pmm->list_lock);
+
+        free_chunk_with_merges(pmm, chunk);
+        num_freed++;
+
+        uvm_spin_lock(&pmm->list_lock);
+    }
+
+    uvm_spin_unlock(&pmm->list_lock);
+
+    return num_freed;
+}
+
+// Return the chunks of all the per-CPU caches, and the ones waiting for
+// deferred freeing, to the free lists. This makes them visible to the
+// allocation and eviction paths. Returns true if any chunk was freed.
+//
+// PMM lock needs to be held
+static bool chunk_caches_drain_locked(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_chunk_t *chunks[UVM_PMM_CHUNK_CACHE_DEPTH];
+    bool freed = false;
+    NvU32 cpu;
+
+    uvm_assert_mutex_locked(&pmm->lock);
+
+    for (cpu = 0; cpu < pmm->chunk_caches.count; cpu++) {
+        uvm_pmm_gpu_chunk_cache_t *cache = &pmm->chunk_caches.cpus[cpu];
+        size_t size_index;
+
+        for (size_index = 0; size_index < ARRAY_SIZE(cache->sizes); size_index++) {
+            NvU32 num_chunks;
+            NvU32 i;
+
+            uvm_spin_lock(&cache->lock);
+            num_chunks = cache->sizes[size_index].count;
+            memcpy(chunks, cache->sizes[size_index].chunks, num_chunks * sizeof(chunks[0]));
+            cache->sizes[size_index].count = 0;
+            uvm_spin_unlock(&cache->lock);
+
+            for (i = 0; i < num_chunks; i++)
+                free_chunk_with_merges(pmm, chunks[i]);
+
+            freed = freed || num_chunks > 0;
+        }
+    }
+
+    if (process_deferred_free_locked(pmm) > 0)
+        freed = true;
+
+    return freed;
+}
+
+static void process_deferred_free(uvm_pmm_gpu_t *pmm)
+{
+    NvU32 num_freed;
+
+    uvm_mutex_lock(&pmm->lock);
+    num_freed = process_deferred_free_locked(pmm);
+    uvm_mutex_unlock(&pmm->lock);
+
+    // Like free_chunk(), try to return a root chunk to PMA for every chunk
+    // freed through the merge path.
+    while (num_freed-- > 0) {
+        if (!free_next_available_root_chunk(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER))
+            break;
+    }
+}
+
+static void process_deferred_free_entry(void *args)
+{
+    UVM_ENTRY_VOID(process_deferred_free(args));
+}
+
+static NV_STATUS chunk_caches_init(uvm_pmm_gpu_t *pmm)
+{
+    NvU32 cpu;
+
+    if (!uvm_perf_pmm_chunk_cache_enable || uvm_enable_builtin_tests)
+        return NV_OK;
+
+    if (!(pmm->chunk_sizes[UVM_PMM_GPU_MEMORY_TYPE_USER] & (UVM_CHUNK_SIZE_4K | UVM_CHUNK_SIZE_64K)))
+        return NV_OK;
+
+    pmm->chunk_caches.cpus = uvm_kvmalloc_zero(sizeof(*pmm->chunk_caches.cpus) * present_processors);
+    if (!pmm->chunk_caches.cpus)
+        return NV_ERR_NO_MEMORY;
+
+    for (cpu = 0; cpu < present_processors; cpu++)
+        uvm_spin_lock_init(&pmm->chunk_caches.cpus[cpu].lock, UVM_LOCK_ORDER_LEAF);
+
+    pmm->chunk_caches.count = present_processors;
+
+    return NV_OK;
+}
+
+static void chunk_caches_deinit(uvm_pmm_gpu_t *pmm)
+{
+    if (pmm->chunk_caches.cpus) {
+        uvm_mutex_lock(&pmm->lock);
+        chunk_caches_drain_locked(pmm);
+        uvm_mutex_unlock(&pmm->lock);
+    }
+
+    UVM_ASSERT(list_empty(&pmm->chunk_caches.deferred_free));
+
+    uvm_kvfree(pmm->chunk_caches.cpus);
+    pmm->chunk_caches.cpus = NULL;
+    pmm->chunk_caches.count = 0;
+}
+
 static NV_STATUS alloc_or_evict_root_chunk(uvm_pmm_gpu_t *pmm,
                                            uvm_pmm_gpu_memory_type_t type,
                                            uvm_pmm_alloc_flags_t flags,
@@ -1961,10 +2573,12 @@ static NV_STATUS alloc_chunk_with_splits(uvm_pmm_gpu_t *pmm,
     uvm_chunk_size_t cur_size;
     uvm_gpu_chunk_t *chunk;
     uvm_chunk_sizes_mask_t chunk_sizes = pmm->chunk_sizes[type];
+    bool caches_drained = false;
 
     uvm_assert_mutex_locked(&pmm->lock);
     UVM_ASSERT(chunk_size != UVM_CHUNK_SIZE_MAX);
 
+retry:
     // Check for a free chunk again in case a different thread freed something
     // up while this thread was waiting for the PMM lock.
     chunk = claim_free_chunk(pmm, type, chunk_size);
@@ -1987,6 +2601,13 @@ static NV_STATUS alloc_chunk_with_splits(uvm_pmm_gpu_t *pmm,
 
     if (unlikely(!chunk)) {
         status = alloc_or_evict_root_chunk(pmm, type, flags, &chunk);
+        if (status == NV_ERR_NO_MEMORY && !caches_drained) {
+            // Chunks held by the per-CPU caches of other CPUs may be enough to
+            // satisfy the allocation once they are merged back.
+            caches_drained = true;
+            if (chunk_caches_drain_locked(pmm))
+                goto retry;
+        }
         if (status != NV_OK)
             return status;
         cur_size = UVM_CHUNK_SIZE_MAX;
@@ -2049,6 +2670,10 @@ NV_STATUS alloc_chunk(uvm_pmm_gpu_t *pmm,
     NV_STATUS status;
     uvm_gpu_chunk_t *chunk;
 
+    chunk = chunk_cache_alloc(pmm, type, chunk_size);
+    if (chunk)
+        goto out;
+
     chunk = claim_free_chunk(pmm, type, chunk_size);
     if (chunk) {
         // A free chunk could be claimed, we are done.
@@ -2127,6 +2752,8 @@ static void init_root_chunk(uvm_pmm_gpu_t *pmm,
     chunk->type = type;
     chunk->state = initial_state;
     chunk->is_zero = is_zero;
+    root_chunk->access_count = 0;
+    root_chunk->eviction_priority = 0;
 
     chunk_update_lists_locked(pmm, chunk);
 
@@ -2186,7 +2813,7 @@ NV_STATUS alloc_root_chunk(uvm_pmm_gpu_t *pmm,
         // Allocate a batch of root chunks in order to reduce the number of
         // calls to PMA. The first one is returned as allocated, the rest are
         // added to the corresponding free list.
-        pas = kmem_cache_alloc(g_pma_address_batch_cache_ref.cache, NV_UVM_GFP_FLAGS);
+        pas = uvm_kmem_cache_alloc(g_pma_address_batch_cache_ref.cache);
         if (!pas)
             return NV_ERR_NO_MEMORY;
 
@@ -2245,7 +2872,7 @@ exit_unlock:
     uvm_up_read(&pmm->pma_lock);
 
     if (used_kmem_cache)
-        kmem_cache_free(g_pma_address_batch_cache_ref.cache, pas);
+        uvm_kmem_cache_free(g_pma_address_batch_cache_ref.cache, pas);
 
     return status;
 }
@@ -2335,7 +2962,7 @@ NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
     cache_idx = ilog2(num_sub);
     UVM_ASSERT(chunk_split_cache[cache_idx].cache != NULL);
 
-    suballoc = nv_kmem_cache_zalloc(chunk_split_cache[cache_idx].cache, NV_UVM_GFP_FLAGS);
+    suballoc = uvm_kmem_cache_zalloc(chunk_split_cache[cache_idx].cache);
     if (suballoc == NULL)
         return NV_ERR_NO_MEMORY;
 
@@ -2346,7 +2973,7 @@ NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
             goto cleanup;
         }
 
-        subchunk = nv_kmem_cache_zalloc(CHUNK_CACHE, NV_UVM_GFP_FLAGS);
+        subchunk = uvm_kmem_cache_zalloc(CHUNK_CACHE);
         if (!subchunk) {
             status = NV_ERR_NO_MEMORY;
             goto cleanup;
@@ -2358,9 +2985,7 @@ NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
         subchunk->type = chunk->type;
         uvm_gpu_chunk_set_size(subchunk, subchunk_size);
         subchunk->parent = chunk;
-        subchunk->va_block_page_index = PAGES_PER_UVM_VA_BLOCK;
         subchunk->is_zero = chunk->is_zero;
-        INIT_LIST_HEAD(&subchunk->list);
 
         // The child inherits the parent's state.
         subchunk->state = chunk->state;
@@ -2402,14 +3027,18 @@ NV_STATUS split_gpu_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 
     uvm_spin_unlock(&pmm->list_lock);
 
+    PMM_STATS_INC(pmm, chunk_splits);
+    if (chunk_is_root_chunk(chunk))
+        PMM_STATS_INC(pmm, root_chunk_splits);
+
     return NV_OK;
 cleanup:
     for (i = 0; i < num_sub; i++) {
         if (suballoc->subchunks[i] == NULL)
             break;
-        kmem_cache_free(CHUNK_CACHE, suballoc->subchunks[i]);
+        uvm_kmem_cache_free(CHUNK_CACHE, suballoc->subchunks[i]);
     }
-    kmem_cache_free(chunk_split_cache[cache_idx].cache, suballoc);
+    uvm_kmem_cache_free(chunk_split_cache[cache_idx].cache, suballoc);
     return status;
 }
 
@@ -2639,7 +3268,7 @@ static void free_chunk_with_merges(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 // Mark the chunk as free and put it on the free list. If this is a suballocated
 // chunk and the parent has no more allocated chunks, the parent is freed and so
 // on up the tree.
-static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+static void free_chunk_uncached(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
 {
     bool try_free = true;
     const bool is_root = chunk_is_root_chunk(chunk);
@@ -2672,6 +3301,422 @@ static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
         (void)free_next_available_root_chunk(pmm, type);
 }
 
+static void free_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk)
+{
+    UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_ALLOCATED ||
+               chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+
+    if (chunk_cache_free(pmm, chunk))
+        return;
+
+    free_chunk_uncached(pmm, chunk);
+}
+
+// Count the zero free user root chunks, stopping at max.
+static NvU32 zero_pool_count_locked(uvm_pmm_gpu_t *pmm, NvU32 max)
+{
+    struct list *zero_list = find_free_list(pmm, UVM_PMM_GPU_MEMORY_TYPE_USER, UVM_CHUNK_SIZE_MAX, UVM_PMM_LIST_ZERO);
+    uvm_gpu_chunk_t *chunk;
+    NvU32 count = 0;
+
+    uvm_assert_spinlock_locked(&pmm->list_lock);
+
+    list_for_each_entry(chunk, zero_list, list) {
+        if (count == max)
+            break;
+
+        count++;
+    }
+
+    return count;
+}
+
+// Returns true if the zero free root chunks of the given type make up the zero
+// pool and must not be returned to PMA.
+static bool zero_pool_keep_locked(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type)
+{
+    NvU32 target = UVM_READ_ONCE(pmm->zero_pool.target);
+
+    if (target == 0 || type != UVM_PMM_GPU_MEMORY_TYPE_USER)
+        return false;
+
+    return zero_pool_count_locked(pmm, target + 1) <= target;
+}
+
+// Zero the whole root chunk with a CE memset. The memset is waited for, so
+// that allocating the chunk later doesn't add any dependency to the tracker of
+// the allocating thread.
+//
+// The root chunk has to be pinned by the caller.
+static NV_STATUS zero_root_chunk(uvm_pmm_gpu_t *pmm, uvm_gpu_root_chunk_t *root_chunk)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    uvm_gpu_chunk_t *chunk = &root_chunk->chunk;
+    uvm_tracker_t local_tracker = UVM_TRACKER_INIT();
+    uvm_gpu_address_t memset_addr;
+    uvm_push_t push;
+    NV_STATUS status;
+
+    UVM_ASSERT(chunk->state == UVM_PMM_GPU_CHUNK_STATE_TEMP_PINNED);
+
+    root_chunk_lock(pmm, root_chunk);
+    status = uvm_tracker_add_tracker_safe(&local_tracker, &root_chunk->tracker);
+    root_chunk_unlock(pmm, root_chunk);
+
+    if (status != NV_OK)
+        goto out;
+
+    status = uvm_push_begin_acquire(gpu->channel_manager,
+                                    UVM_CHANNEL_TYPE_GPU_INTERNAL,
+                                    &local_tracker,
+                                    &push,
+                                    "Zero out root chunk [0x%llx, 0x%llx) for the zero pool",
+                                    chunk->address,
+                                    chunk->address + UVM_CHUNK_SIZE_MAX);
+    if (status != NV_OK)
+        goto out;
+
+    memset_addr = uvm_gpu_address_copy(gpu, uvm_gpu_phys_address(UVM_APERTURE_VID, chunk->address));
+    gpu->parent->ce_hal->memset_8(&push, memset_addr, 0, UVM_CHUNK_SIZE_MAX);
+
+    // uvm_push_end provides the sysmembar needed before any PTE pointing to
+    // the chunk is written, see block_zero_new_gpu_chunk().
+    status = uvm_push_end_and_wait(&push);
+    if (status != NV_OK)
+        goto out;
+
+    root_chunk_lock(pmm, root_chunk);
+    uvm_tracker_remove_completed(&root_chunk->tracker);
+    root_chunk_unlock(pmm, root_chunk);
+
+out:
+    uvm_tracker_deinit(&local_tracker);
+
+    return status;
+}
+
+// Top up the zero pool, taking non-zero free root chunks first and allocating
+// new ones from PMA otherwise. Eviction is never triggered to refill the pool.
+static void zero_pool_refill(uvm_pmm_gpu_t *pmm)
+{
+    const uvm_pmm_gpu_memory_type_t type = UVM_PMM_GPU_MEMORY_TYPE_USER;
+
+    while (1) {
+        NvU32 target = UVM_READ_ONCE(pmm->zero_pool.target);
+        uvm_gpu_chunk_t *chunk;
+        NV_STATUS status = NV_OK;
+        bool pool_full;
+
+        uvm_spin_lock(&pmm->list_lock);
+
+        pool_full = zero_pool_count_locked(pmm, target) == target;
+
+        chunk = NULL;
+        if (!pool_full) {
+            chunk = find_free_chunk_locked(pmm, type, UVM_CHUNK_SIZE_MAX, UVM_PMM_LIST_NO_ZERO);
+            if (chunk) {
+                chunk_pin(pmm, chunk);
+                chunk_update_lists_locked(pmm, chunk);
+            }
+        }
+
+        uvm_spin_unlock(&pmm->list_lock);
+
+        if (pool_full)
+            break;
+
+        if (!chunk) {
+            status = alloc_root_chunk(pmm, type, UVM_PMM_ALLOC_FLAGS_DONT_BATCH, &chunk);
+            if (status != NV_OK)
+                break;
+        }
+
+        if (!chunk->is_zero)
+            status = zero_root_chunk(pmm, root_chunk_from_chunk(pmm, chunk));
+
+        if (status != NV_OK) {
+            free_chunk(pmm, chunk);
+            break;
+        }
+
+        uvm_spin_lock(&pmm->list_lock);
+        chunk_unpin(pmm, chunk, UVM_PMM_GPU_CHUNK_STATE_FREE);
+        chunk->is_zero = true;
+        chunk_update_lists_locked(pmm, chunk);
+        uvm_spin_unlock(&pmm->list_lock);
+    }
+}
+
+static void zero_pool_refill_entry(void *args)
+{
+    UVM_ENTRY_VOID(zero_pool_refill(args));
+}
+
+static void zero_pool_schedule_refill(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+
+    if (UVM_READ_ONCE(pmm->zero_pool.target) == 0)
+        return;
+
+    nv_kthread_q_schedule_q_item(&gpu->parent->lazy_free_q, &pmm->zero_pool.refill_q_item);
+}
+
+static void zero_pool_init(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+
+    nv_kthread_q_item_init(&pmm->zero_pool.refill_q_item, zero_pool_refill_entry, pmm);
+
+    // The PMM tests check the exact set of free root chunks, and with
+    // Confidential Computing user memory is scrubbed by PMA.
+    if (gpu->mem_info.size == 0 || uvm_enable_builtin_tests || uvm_conf_computing_mode_enabled(gpu))
+        return;
+
+    pmm->zero_pool.target = uvm_perf_pmm_zero_pool_root_chunks;
+}
+
+static void access_bits_scan_arm(uvm_pmm_gpu_t *pmm)
+{
+    uvm_spin_lock(&pmm->access_bits.lock);
+    if (!pmm->access_bits.stopping) {
+        register_timer(kernel_timers,
+                       &pmm->access_bits.timer,
+                       CLOCK_ID_MONOTONIC,
+                       microseconds(uvm_perf_pmm_access_bits_scan_period_ms * 1000ULL),
+                       false,
+                       0,
+                       (timer_handler)&pmm->access_bits.timer_handler);
+    }
+    uvm_spin_unlock(&pmm->access_bits.lock);
+}
+
+// Fold a dump of the vidmem access bits into the root chunks: a root chunk
+// with any of its bits set is marked as accessed, the others get one more idle
+// scan. Root chunks beyond the memory covered by the bits are left alone.
+static void access_bits_scan(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    const UvmGpuAccessBitsBufferAlloc *rm_info = &pmm->access_bits.rm_info;
+    const NvU64 *bits = pmm->access_bits.bits;
+    NV_STATUS status;
+    size_t i;
+
+    status = uvm_rm_locked_call(nvUvmInterfaceAccessBitsDump(uvm_gpu_device_handle(gpu),
+                                                             &pmm->access_bits.rm_info,
+                                                             pmm->access_bits.bits));
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("Dumping the access bits failed: %s, GPU %s. Stopping the cold memory scanner\n",
+                      nvstatusToString(status),
+                      uvm_gpu_name(gpu));
+        UVM_WRITE_ONCE(pmm->access_bits.enabled, false);
+        return;
+    }
+
+    for (i = 0; i < pmm->root_chunks.count; ++i) {
+        uvm_gpu_root_chunk_t *root_chunk = &pmm->root_chunks.array[i];
+        NvU64 first_bit = root_chunk->chunk.address / rm_info->granularity;
+        NvU64 last_bit = (root_chunk->chunk.address + UVM_CHUNK_SIZE_MAX - 1) / rm_info->granularity;
+        bool accessed = false;
+        NvU8 idle_scans;
+        NvU64 bit;
+
+        if (last_bit >= rm_info->numBits)
+            break;
+
+        for (bit = first_bit; bit <= last_bit && !accessed; ++bit)
+            accessed = (bits[bit / 64] >> (bit % 64)) & 1;
+
+        if (accessed) {
+            uvm_pmm_gpu_mark_root_chunk_accessed(pmm, root_chunk->chunk.address);
+            continue;
+        }
+
+        idle_scans = UVM_READ_ONCE(root_chunk->idle_scans);
+        if (idle_scans < UVM_PMM_ROOT_CHUNK_IDLE_SCANS_MAX)
+            UVM_WRITE_ONCE(root_chunk->idle_scans, idle_scans + 1);
+    }
+
+    access_bits_scan_arm(pmm);
+}
+
+static void access_bits_scan_entry(void *args)
+{
+    UVM_ENTRY_VOID(access_bits_scan(args));
+}
+
+define_closure_function(0, 2, void, access_bits_scan_timer,
+                        u64, expiry, u64, overruns)
+{
+    uvm_pmm_gpu_t *pmm;
+
+    if (overruns == timer_disabled)
+        return;
+
+    pmm = container_of(closure_self(), uvm_pmm_gpu_t, access_bits.timer_handler);
+
+    uvm_spin_lock(&pmm->access_bits.lock);
+    if (!pmm->access_bits.stopping)
+        nv_kthread_q_schedule_q_item(&uvm_pmm_to_gpu(pmm)->parent->lazy_free_q, &pmm->access_bits.scan_q_item);
+    uvm_spin_unlock(&pmm->access_bits.lock);
+}
+
+static void access_bits_init(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+    NV_STATUS status;
+
+    uvm_spin_lock_init(&pmm->access_bits.lock, UVM_LOCK_ORDER_LEAF);
+    init_timer(&pmm->access_bits.timer);
+    init_closure(&pmm->access_bits.timer_handler, access_bits_scan_timer);
+    nv_kthread_q_item_init(&pmm->access_bits.scan_q_item, access_bits_scan_entry, pmm);
+
+    // The PMM tests expect eviction to only depend on the accesses they make
+    if (uvm_perf_pmm_access_bits_scan_period_ms == 0 ||
+        gpu->mem_info.size == 0 ||
+        !uvm_gpu_supports_eviction(gpu) ||
+        uvm_enable_builtin_tests)
+        return;
+
+    pmm->access_bits.bits = uvm_kvmalloc_zero(UVM_ACCESS_BITS_MAX_BITS / 8);
+    if (!pmm->access_bits.bits)
+        return;
+
+    status = uvm_rm_locked_call(nvUvmInterfaceAccessBitsBufAlloc(uvm_gpu_device_handle(gpu),
+                                                                 gpu->mem_info.max_allocatable_address,
+                                                                 &pmm->access_bits.rm_info));
+    if (status != NV_OK) {
+        // Most configurations have no access bit buffer, this is not an error
+        uvm_kvfree(pmm->access_bits.bits);
+        pmm->access_bits.bits = NULL;
+        return;
+    }
+
+    pmm->access_bits.enabled = true;
+    access_bits_scan_arm(pmm);
+}
+
+static void access_bits_deinit(uvm_pmm_gpu_t *pmm)
+{
+    uvm_gpu_t *gpu = uvm_pmm_to_gpu(pmm);
+
+    if (!pmm->access_bits.bits)
+        return;
+
+    uvm_spin_lock(&pmm->access_bits.lock);
+    pmm->access_bits.stopping = true;
+    uvm_spin_unlock(&pmm->access_bits.lock);
+
+    // Once stopping is set, neither the timer nor the scan rearm, so removing
+    // the timer and flushing the queue stops the scanner.
+    remove_timer(kernel_timers, &pmm->access_bits.timer, 0);
+    nv_kthread_q_flush(&gpu->parent->lazy_free_q);
+
+    uvm_rm_locked_call_void(nvUvmInterfaceAccessBitsBufFree(uvm_gpu_device_handle(gpu), &pmm->access_bits.rm_info));
+    pmm->access_bits.enabled = false;
+
+    uvm_kvfree(pmm->access_bits.bits);
+    pmm->access_bits.bits = NULL;
+}
+
+// Returns whether the memory of the VA block resident on the GPU is tracked by
+// the access bit scanner, and if so, for how many scans the root chunk backing
+// it has been idle. Like the other PMM eviction heuristics, only root chunk
+// sized blocks are tracked.
+static bool va_block_gpu_idle_scans(uvm_va_block_t *va_block, uvm_gpu_t *gpu, NvU32 *idle_scans)
+{
+    uvm_va_block_gpu_state_t *gpu_state;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+
+    if (!uvm_processor_mask_test(&va_block->resident, gpu->id) ||
+        uvm_va_block_size(va_block) != UVM_CHUNK_SIZE_MAX)
+        return false;
+
+    gpu_state = uvm_va_block_gpu_state_get(va_block, gpu->id);
+    if (!gpu_state || !gpu_state->chunks[0])
+        return false;
+
+    return uvm_pmm_gpu_root_chunk_idle_scans(&gpu->pmm, gpu_state->chunks[0]->address, idle_scans);
+}
+
+NV_STATUS uvm_api_get_vidmem_coldness(UVM_GET_VIDMEM_COLDNESS_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_va_range_t *va_range;
+    uvm_gpu_t *gpu;
+    NvU64 end = params->base + params->length;
+    bool supported = false;
+    NvU32 idle_scans;
+
+    params->numEntries = 0;
+    params->nextBase = end;
+
+    if (params->length == 0 || end < params->base)
+        return NV_ERR_INVALID_ADDRESS;
+
+    uvm_va_space_down_read(va_space);
+
+    for_each_va_space_gpu(gpu, va_space) {
+        if (UVM_READ_ONCE(gpu->pmm.access_bits.enabled))
+            supported = true;
+    }
+
+    if (!supported) {
+        uvm_va_space_up_read(va_space);
+        return NV_ERR_NOT_SUPPORTED;
+    }
+
+    uvm_for_each_va_range_in(va_range, va_space, params->base, end - 1) {
+        uvm_va_block_t *va_block;
+
+        if (va_range->type != UVM_VA_RANGE_TYPE_MANAGED)
+            continue;
+
+        for_each_va_block_in_va_range(va_range, va_block) {
+            NvU32 num_gpus = 0;
+
+            if (va_block->end < params->base)
+                continue;
+            if (va_block->start >= end)
+                break;
+
+            uvm_mutex_lock(&va_block->lock);
+
+            for_each_va_space_gpu(gpu, va_space) {
+                if (va_block_gpu_idle_scans(va_block, gpu, &idle_scans))
+                    ++num_gpus;
+            }
+
+            // Report all the GPUs of a region or none of them
+            if (params->numEntries + num_gpus > UVM_VIDMEM_COLDNESS_MAX_ENTRIES) {
+                uvm_mutex_unlock(&va_block->lock);
+                params->nextBase = max(va_block->start, params->base);
+                goto done;
+            }
+
+            for_each_va_space_gpu(gpu, va_space) {
+                UVM_VIDMEM_COLDNESS_ENTRY *out = &params->entries[params->numEntries];
+
+                if (!va_block_gpu_idle_scans(va_block, gpu, &idle_scans))
+                    continue;
+
+                out->regionBase = va_block->start;
+                out->processorUuid = gpu->parent->uuid;
+                out->idleScans = idle_scans;
+                ++params->numEntries;
+            }
+
+            uvm_mutex_unlock(&va_block->lock);
+        }
+    }
+
+done:
+    uvm_va_space_up_read(va_space);
+
+    return NV_OK;
+}
+
 // Finds and frees the next root chunk of the given type (if any) that can be
 // freed. Returns true if a root chunk was freed, or false otherwise.
 bool free_next_available_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_t type)
@@ -2687,7 +3732,8 @@ bool free_next_available_root_chunk(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_memory_type_
     if (result)
         UVM_ASSERT(!result->is_zero);
 
-    if (!result) {
+    // Zero chunks of the zero pool are kept
+    if (!result && !zero_pool_keep_locked(pmm, type)) {
         result = list_first_chunk(find_free_list(pmm, type, UVM_CHUNK_SIZE_MAX, UVM_PMM_LIST_ZERO));
         if (result)
             UVM_ASSERT(result->is_zero);
@@ -2920,6 +3966,13 @@ static NV_STATUS uvm_pmm_gpu_pma_evict_range(void *void_pmm,
     uvm_down_write(&pmm->pma_lock);
     uvm_up_write(&pmm->pma_lock);
 
+    // Cached chunks are pinned and would otherwise stall the wait below.
+    if (pmm->chunk_caches.cpus) {
+        uvm_mutex_lock(&pmm->lock);
+        chunk_caches_drain_locked(pmm);
+        uvm_mutex_unlock(&pmm->lock);
+    }
+
     for (; address <= phys_end; address += UVM_CHUNK_SIZE_MAX) {
         uvm_gpu_root_chunk_t *root_chunk = root_chunk_from_address(pmm, address);
         uvm_gpu_chunk_t *chunk = &root_chunk->chunk;
@@ -3018,12 +4071,22 @@ static void deinit_chunk_split_cache(uvm_pmm_gpu_t *pmm)
         UVM_ASSERT(chunk_split_cache[subchunk_count_log2].cache);
 
         if (--chunk_split_cache[subchunk_count_log2].refcount == 0)
-            kmem_cache_destroy_safe(&chunk_split_cache[subchunk_count_log2].cache);
+            uvm_kmem_cache_destroy_safe(&chunk_split_cache[subchunk_count_log2].cache);
 
         __clear_bit(subchunk_count_log2, pmm->chunk_split_cache_initialized);
     }
 }
 
+// Constructor for CHUNK_CACHE. Subchunks come already zeroed, split_gpu_chunk()
+// initializes the fields inherited from the parent.
+static void gpu_chunk_ctor(void *object)
+{
+    uvm_gpu_chunk_t *chunk = object;
+
+    chunk->va_block_page_index = PAGES_PER_UVM_VA_BLOCK;
+    INIT_LIST_HEAD(&chunk->list);
+}
+
 static NV_STATUS init_chunk_split_cache_level(uvm_pmm_gpu_t *pmm, size_t level)
 {
     uvm_assert_mutex_locked(&g_uvm_global.global_lock);
@@ -3031,20 +4094,19 @@ static NV_STATUS init_chunk_split_cache_level(uvm_pmm_gpu_t *pmm, size_t level)
     if (!test_bit(level, pmm->chunk_split_cache_initialized)) {
         if (!chunk_split_cache[level].cache) {
             size_t size;
-            size_t align;
+            uvm_kmem_cache_ctor_t ctor = NULL;
             if (level == 0) {
                 strncpy(chunk_split_cache[level].name, "uvm_gpu_chunk_t", sizeof(chunk_split_cache[level].name) - 1);
                 size = sizeof(uvm_gpu_chunk_t);
-                align = __alignof__(uvm_gpu_chunk_t);
+                ctor = gpu_chunk_ctor;
             } else {
                 snprintf(chunk_split_cache[level].name,
                          sizeof(chunk_split_cache[level].name),
                          "uvm_gpu_chunk_%u", (unsigned)level);
                 size = sizeof(uvm_pmm_gpu_chunk_suballoc_t) + (sizeof(uvm_gpu_chunk_t *) << level);
-                align = __alignof__(uvm_pmm_gpu_chunk_suballoc_t);
             }
             chunk_split_cache[level].cache =
-                nv_kmem_cache_create(chunk_split_cache[level].name, size, align);
+                uvm_kmem_cache_create(chunk_split_cache[level].name, size, ctor);
 
 
             if (!chunk_split_cache[level].cache)
@@ -3111,8 +4173,7 @@ static NV_STATUS init_pma_address_batch_cache(uvm_pmm_gpu_t *pmm)
                  sizeof(g_pma_address_batch_cache_ref.name),
                  "pma_address_batch");
         g_pma_address_batch_cache_ref.cache =
-            nv_kmem_cache_create(g_pma_address_batch_cache_ref.name,
-                              address_batch_size, __alignof__(UvmGpuPointer));
+            uvm_kmem_cache_create(g_pma_address_batch_cache_ref.name, address_batch_size, NULL);
 
         if (!g_pma_address_batch_cache_ref.cache)
             return NV_ERR_NO_MEMORY;
@@ -3138,7 +4199,7 @@ static void deinit_pma_address_batch_cache(uvm_pmm_gpu_t *pmm)
         UVM_ASSERT(g_pma_address_batch_cache_ref.cache);
 
         if (--g_pma_address_batch_cache_ref.refcount == 0)
-            kmem_cache_destroy_safe(&g_pma_address_batch_cache_ref.cache);
+            uvm_kmem_cache_destroy_safe(&g_pma_address_batch_cache_ref.cache);
 
         pmm->pma_address_cache_initialized = false;
     }
@@ -3620,6 +4681,8 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
     INIT_LIST_HEAD(&pmm->root_chunks.va_block_unused);
     INIT_LIST_HEAD(&pmm->root_chunks.va_block_lazy_free);
     nv_kthread_q_item_init(&pmm->root_chunks.va_block_lazy_free_q_item, process_lazy_free_entry, pmm);
+    INIT_LIST_HEAD(&pmm->chunk_caches.deferred_free);
+    nv_kthread_q_item_init(&pmm->chunk_caches.deferred_free_q_item, process_deferred_free_entry, pmm);
 
     uvm_mutex_init(&pmm->lock, UVM_LOCK_ORDER_PMM);
     uvm_init_rwsem(&pmm->pma_lock, UVM_LOCK_ORDER_PMM_PMA);
@@ -3643,6 +4706,20 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
     if (status != NV_OK)
         goto cleanup;
 
+    status = chunk_caches_init(pmm);
+    if (status != NV_OK)
+        goto cleanup;
+
+    zero_pool_init(pmm);
+
+    if (uvm_perf_pmm_stats) {
+        pmm->stats = uvm_kvmalloc_zero(sizeof(*pmm->stats));
+        if (!pmm->stats) {
+            status = NV_ERR_NO_MEMORY;
+            goto cleanup;
+        }
+    }
+
     // Assert that max physical address of the GPU is not unreasonably big for
     // creating the flat array of root chunks. 256GB should provide a reasonable
     // amount of future-proofing and results in 128K chunks which is still
@@ -3695,6 +4772,8 @@ NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm)
         }
     }
 
+    access_bits_init(pmm);
+
     status = devmem_init(pmm);
     if (status != NV_OK)
         goto cleanup;
@@ -3734,7 +4813,17 @@ void uvm_pmm_gpu_deinit(uvm_pmm_gpu_t *pmm)
 
     gpu = uvm_pmm_to_gpu(pmm);
 
+    if (pmm->root_chunks.array)
+        pmm_stats_print(pmm);
+
+    access_bits_deinit(pmm);
+
     uvm_pmm_gpu_free_orphan_pages(pmm);
+    chunk_caches_deinit(pmm);
+
+    // Let release_free_root_chunks() return the zero pool to PMA
+    UVM_WRITE_ONCE(pmm->zero_pool.target, 0);
+
     nv_kthread_q_flush(&gpu->parent->lazy_free_q);
     UVM_ASSERT(list_empty(&pmm->root_chunks.va_block_lazy_free));
     release_free_root_chunks(pmm);
@@ -3774,6 +4863,9 @@ void uvm_pmm_gpu_deinit(uvm_pmm_gpu_t *pmm)
 
     deinit_caches(pmm);
 
+    uvm_kvfree(pmm->stats);
+    pmm->stats = NULL;
+
     devmem_deinit(pmm);
 
     pmm->initialized = false;
@@ -63,6 +63,9 @@
 #include <linux/memremap.h>
 #endif
 
+declare_closure_struct(0, 2, void, access_bits_scan_timer,
+                       u64, expiry, u64, overruns);
+
 typedef enum
 {
     UVM_CHUNK_SIZE_1       =           1ULL,
@@ -314,8 +317,39 @@ typedef struct uvm_gpu_root_chunk_struct
     // We can use a regular processor id because indirect peers are not allowed
     // between partitioned GPUs when SMC is enabled.
     uvm_processor_mask_t indirect_peers_mapped;
+
+    // Approximate access frequency of the root chunk, saturating at
+    // UVM_PMM_ROOT_CHUNK_ACCESS_COUNT_MAX. It is bumped by
+    // uvm_pmm_gpu_mark_root_chunk_accessed() and halved every time the CLOCK
+    // scan of pick_root_chunk_to_evict() passes over the chunk.
+    //
+    // Updated without any lock, losing an update only makes the estimate a bit
+    // less precise.
+    NvU8 access_count;
+
+    // Eviction priority of the VA space that last marked the chunk as used,
+    // see uvm_pmm_gpu_mark_root_chunk_used().
+    //
+    // Protected by the PMM list lock.
+    NvU8 eviction_priority;
+
+    // Number of consecutive access bit scans that found the root chunk not
+    // accessed, saturating at UVM_PMM_ROOT_CHUNK_IDLE_SCANS_MAX. Reset when
+    // the chunk is accessed or marked as used. Only counts while the access
+    // bit scanner of the PMM is enabled.
+    //
+    // Updated without any lock, like access_count.
+    NvU8 idle_scans;
 } uvm_gpu_root_chunk_t;
 
+#define UVM_PMM_ROOT_CHUNK_ACCESS_COUNT_MAX 15
+
+#define UVM_PMM_ROOT_CHUNK_IDLE_SCANS_MAX 255
+
+// Highest eviction priority of a root chunk. Chunks with a higher priority are
+// only evicted if no chunk of a lower priority is found by the eviction scan.
+#define UVM_PMM_GPU_EVICTION_PRIORITY_MAX 3
+
 typedef struct
 {
     // Indirect peers are GPUs which can coherently access this GPU's memory,
@@ -344,6 +378,73 @@ typedef struct
     atomic64_t map_count;
 } uvm_gpu_root_chunk_indirect_peer_t;
 
+// Chunk sizes kept in the per-CPU chunk caches: UVM_CHUNK_SIZE_4K and
+// UVM_CHUNK_SIZE_64K
+#define UVM_PMM_CHUNK_CACHE_SIZES 2
+
+// Number of chunks of each size a per-CPU chunk cache can hold
+#define UVM_PMM_CHUNK_CACHE_DEPTH 32
+
+// Number of chunks moved between a per-CPU chunk cache and the free lists at a
+// time
+#define UVM_PMM_CHUNK_CACHE_BATCH (UVM_PMM_CHUNK_CACHE_DEPTH / 2)
+
+// Cache of free user chunks owned by one CPU. Cached chunks are in the
+// TEMP_PINNED state, off the free lists and still counted as allocated in
+// their parent, so to the rest of PMM they look like chunks allocated but not
+// yet unpinned. Allocating one only takes the cache lock, and freeing one into
+// the cache never merges.
+typedef struct
+{
+    // Lock protecting the cache. Only contended if a thread migrates CPUs
+    // between picking the cache and taking the lock, or when the caches are
+    // drained.
+    uvm_spinlock_t lock;
+
+    struct
+    {
+        NvU32 count;
+        uvm_gpu_chunk_t *chunks[UVM_PMM_CHUNK_CACHE_DEPTH];
+    } sizes[UVM_PMM_CHUNK_CACHE_SIZES];
+} uvm_pmm_gpu_chunk_cache_t;
+
+// Counters of uvm_pmm_gpu_stats_t readable with uvm_pmm_gpu_query_stat()
+typedef enum
+{
+    // Successful uvm_pmm_gpu_alloc() calls
+    UVM_PMM_GPU_STAT_ALLOCS,
+    UVM_PMM_GPU_STAT_ROOT_CHUNK_SPLITS,
+    UVM_PMM_GPU_STAT_ROOT_CHUNK_MERGES,
+    UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_ALLOC,
+    UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_PMA,
+} uvm_pmm_gpu_stat_t;
+
+// Bucket i of a PMM allocation latency histogram counts the
+// uvm_pmm_gpu_alloc() calls that took [2^i, 2^(i+1)) ns. The last bucket also
+// collects everything longer.
+#define UVM_PMM_ALLOC_LATENCY_BUCKETS 32
+
+// Allocation telemetry of a PMM, kept when uvm_perf_pmm_stats is set
+typedef struct
+{
+    // Latency of uvm_pmm_gpu_alloc() calls, indexed like the free lists by
+    // memory type and chunk size
+    atomic64_t alloc_latency[UVM_PMM_GPU_MEMORY_TYPE_COUNT][UVM_MAX_CHUNK_SIZES][UVM_PMM_ALLOC_LATENCY_BUCKETS];
+
+    // Root chunks evicted to satisfy PMM allocations, and evicted on behalf
+    // of PMA for allocations of other PMA clients
+    atomic64_t root_chunks_evicted_for_alloc;
+    atomic64_t root_chunks_evicted_for_pma;
+
+    // Splits of root chunks, and merges of chunks back into root chunks
+    atomic64_t root_chunk_splits;
+    atomic64_t root_chunk_merges;
+
+    // Splits and merges of chunks of any size
+    atomic64_t chunk_splits;
+    atomic64_t chunk_merges;
+} uvm_pmm_gpu_stats_t;
+
 typedef struct uvm_pmm_gpu_struct
 {
     // Sizes of the MMU
@@ -408,6 +509,60 @@ typedef struct uvm_pmm_gpu_struct
     // Free chunk lists. There are separate lists for non-zero and zero chunks.
     struct list free_list[UVM_PMM_GPU_MEMORY_TYPE_COUNT][UVM_MAX_CHUNK_SIZES][UVM_PMM_LIST_ZERO_COUNT];
 
+    struct
+    {
+        // Per-CPU caches of free user chunks, indexed by CPU id modulo count.
+        // NULL if the caches are disabled.
+        uvm_pmm_gpu_chunk_cache_t *cpus;
+        NvU32 count;
+
+        // Chunks that overflowed a cache, waiting to be freed (and merged) by
+        // the lazy free queue. Protected by list_lock.
+        struct list deferred_free;
+        nv_kthread_q_item_t deferred_free_q_item;
+    } chunk_caches;
+
+    // Pool of zeroed free user root chunks. The pool is made of the root
+    // chunks on the zero free list of UVM_PMM_GPU_MEMORY_TYPE_USER, which
+    // free_next_available_root_chunk() doesn't return to PMA while there are
+    // no more than target of them. It is refilled in the background by
+    // refill_q_item on the lazy free queue.
+    struct
+    {
+        // 0 if the pool is disabled
+        NvU32 target;
+
+        nv_kthread_q_item_t refill_q_item;
+    } zero_pool;
+
+    // Cold memory scanner. Every uvm_perf_pmm_access_bits_scan_period_ms, the
+    // vidmem access bit buffer of the GPU is dumped from scan_q_item on the
+    // lazy free queue, and the access bits are folded into the access_count
+    // and idle_scans of the root chunks. See access_bits_scan().
+    struct
+    {
+        // False if the GPU or RM has no access bit buffer, or the scanner is
+        // disabled
+        bool enabled;
+
+        UvmGpuAccessBitsBufferAlloc rm_info;
+
+        // Last dump, UVM_ACCESS_BITS_MAX_BITS bits
+        NvU64 *bits;
+
+        // Set under lock before the scanner is stopped, so that it doesn't
+        // rearm the timer
+        uvm_spinlock_t lock;
+        bool stopping;
+
+        struct timer timer;
+        closure_struct(access_bits_scan_timer, timer_handler);
+        nv_kthread_q_item_t scan_q_item;
+    } access_bits;
+
+    // Allocation telemetry, NULL unless uvm_perf_pmm_stats is set
+    uvm_pmm_gpu_stats_t *stats;
+
     // Inject an error after evicting a number of chunks. 0 means no error left
     // to be injected.
     NvU32 inject_pma_evict_error_after_num_chunks;
@@ -426,6 +581,10 @@ uvm_gpu_t *uvm_pmm_to_gpu(uvm_pmm_gpu_t *pmm);
 // Initialize PMM on GPU
 NV_STATUS uvm_pmm_gpu_init(uvm_pmm_gpu_t *pmm);
 
+// Read one of the allocation telemetry counters. Returns
+// NV_ERR_INVALID_STATE if uvm_perf_pmm_stats is not set.
+NV_STATUS uvm_pmm_gpu_query_stat(uvm_pmm_gpu_t *pmm, uvm_pmm_gpu_stat_t stat, NvU64 *value);
+
 // Deinitialize the PMM on GPU
 void uvm_pmm_gpu_deinit(uvm_pmm_gpu_t *pmm);
 
@@ -592,6 +751,13 @@ void uvm_pmm_gpu_sync(uvm_pmm_gpu_t *pmm);
 // Mark an allocated chunk as evicted
 void uvm_pmm_gpu_mark_chunk_evicted(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 
+// Returns the amount of vidmem PMA can still hand out, in bytes. Free chunks
+// cached in the PMM free lists are not included. Returns 0 if the GPU has no
+// vidmem managed by PMA.
+//
+// The value is read without any locks and is only meant for heuristics.
+NvU64 uvm_pmm_gpu_free_memory(uvm_pmm_gpu_t *pmm);
+
 // Initialize indirect peer state so accessing_gpu is ready to create mappings
 // to pmm's root chunks.
 //
@@ -633,16 +799,31 @@ uvm_gpu_address_t uvm_pmm_gpu_peer_copy_address(uvm_pmm_gpu_t *pmm,
                                                 uvm_gpu_chunk_t *chunk,
                                                 uvm_gpu_t *accessing_gpu);
 
-// Mark a user chunk as used
+// Mark a user chunk as used, with the given eviction priority (at most
+// UVM_PMM_GPU_EVICTION_PRIORITY_MAX).
 //
 // If the chunk is pinned or selected for eviction, this won't do anything. The
 // chunk can be pinned when it's being initially populated by the VA block.
 // Allow that state to make this API easy to use for the caller.
-void uvm_pmm_gpu_mark_root_chunk_used(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
+void uvm_pmm_gpu_mark_root_chunk_used(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk, NvU32 eviction_priority);
+
+// Record an access to the user root chunk backing the given physical address.
+// This is called for access counter notifications and for faults serviced on
+// vidmem of the GPU, and makes the chunk less likely to be picked for eviction.
+//
+// This doesn't take any lock and can be called on any vidmem address.
+void uvm_pmm_gpu_mark_root_chunk_accessed(uvm_pmm_gpu_t *pmm, NvU64 address);
 
 // Mark an allocated user chunk as unused
 void uvm_pmm_gpu_mark_root_chunk_unused(uvm_pmm_gpu_t *pmm, uvm_gpu_chunk_t *chunk);
 
+// Get the number of consecutive access bit scans that found the user root
+// chunk backing the given physical address not accessed. Returns false if the
+// access bit scanner of the PMM isn't enabled.
+//
+// This doesn't take any lock and can be called on any vidmem address.
+bool uvm_pmm_gpu_root_chunk_idle_scans(uvm_pmm_gpu_t *pmm, NvU64 address, NvU32 *idle_scans);
+
 static bool uvm_gpu_chunk_same_root(uvm_gpu_chunk_t *chunk1, uvm_gpu_chunk_t *chunk2)
 {
     return UVM_ALIGN_DOWN(chunk1->address, UVM_CHUNK_SIZE_MAX) == UVM_ALIGN_DOWN(chunk2->address, UVM_CHUNK_SIZE_MAX);
@@ -84,8 +84,34 @@ void uvm_pmm_sysmem_mappings_deinit(uvm_pmm_sysmem_mappings_t *sysmem_mappings)
     sysmem_mappings->gpu = NULL;
 }
 
-// TODO: Bug 1995015: use a more efficient data structure for
-// physically-contiguous allocations.
+// Each reverse map descriptor is stored once in the tree, keyed by the first
+// page of the DMA region it covers. Regions are naturally aligned to their
+// size, so the descriptor covering a page can be found by probing the page's
+// key aligned down to every power-of-two region size up to a VA block.
+static uvm_reverse_map_t *reverse_map_find_locked(uvm_pmm_sysmem_mappings_t *sysmem_mappings, NvU64 key)
+{
+    const NvU32 max_order = ilog2(UVM_VA_BLOCK_SIZE / PAGE_SIZE);
+    NvU64 prev_base_key = ~0ULL;
+    NvU32 order;
+
+    uvm_assert_mutex_locked(&sysmem_mappings->reverse_map_lock);
+
+    for (order = 0; order <= max_order; ++order) {
+        NvU64 base_key = key & ~((1ULL << order) - 1);
+        uvm_reverse_map_t *reverse_map;
+
+        if (base_key == prev_base_key)
+            continue;
+
+        prev_base_key = base_key;
+        reverse_map = table_find(sysmem_mappings->reverse_map_tree, pointer_from_u64(base_key));
+        if (reverse_map && key < base_key + uvm_va_block_region_num_pages(reverse_map->region))
+            return reverse_map;
+    }
+
+    return NULL;
+}
+
 NV_STATUS uvm_pmm_sysmem_mappings_add_gpu_mapping(uvm_pmm_sysmem_mappings_t *sysmem_mappings,
                                                   NvU64 dma_addr,
                                                   NvU64 virt_addr,
@@ -93,9 +119,7 @@ NV_STATUS uvm_pmm_sysmem_mappings_add_gpu_mapping(uvm_pmm_sysmem_mappings_t *sys
                                                   uvm_va_block_t *va_block,
                                                   uvm_processor_id_t owner)
 {
-    NV_STATUS status = NV_OK;
     uvm_reverse_map_t *new_reverse_map;
-    NvU64 key;
     const NvU64 base_key = dma_addr / PAGE_SIZE;
     const NvU32 num_pages = region_size / PAGE_SIZE;
     uvm_page_index_t page_index;
@@ -124,17 +148,11 @@ NV_STATUS uvm_pmm_sysmem_mappings_add_gpu_mapping(uvm_pmm_sysmem_mappings_t *sys
     new_reverse_map->owner    = owner;
 
     uvm_mutex_lock(&sysmem_mappings->reverse_map_lock);
-    for (key = base_key; key < base_key + num_pages; ++key) {
-        table_set(sysmem_mappings->reverse_map_tree, pointer_from_u64(key), new_reverse_map);
-    }
+    UVM_ASSERT(!reverse_map_find_locked(sysmem_mappings, base_key));
+    table_set(sysmem_mappings->reverse_map_tree, pointer_from_u64(base_key), new_reverse_map);
     uvm_mutex_unlock(&sysmem_mappings->reverse_map_lock);
 
-    // The assert is added for Coverity's sake. It is equivalent to adding
-    // assert(num_pages > 0) before the loop. However, Coverity is not able to
-    // deduce that the loop has to execute at least once from num_pages > 0.
-    UVM_ASSERT(key != base_key || status != NV_OK);
-
-    return status;
+    return NV_OK;
 }
 
 static void pmm_sysmem_mappings_remove_gpu_mapping(uvm_pmm_sysmem_mappings_t *sysmem_mappings,
@@ -142,7 +160,6 @@ static void pmm_sysmem_mappings_remove_gpu_mapping(uvm_pmm_sysmem_mappings_t *sy
                                                    bool check_mapping)
 {
     uvm_reverse_map_t *reverse_map;
-    NvU64 key;
     const NvU64 base_key = dma_addr / PAGE_SIZE;
 
     if (!sysmem_mappings->gpu->parent->access_counters_supported)
@@ -161,11 +178,6 @@ static void pmm_sysmem_mappings_remove_gpu_mapping(uvm_pmm_sysmem_mappings_t *sy
 
     uvm_assert_mutex_locked(&reverse_map->va_block->lock);
 
-    for (key = base_key + 1; key < base_key + uvm_va_block_region_num_pages(reverse_map->region); ++key) {
-        uvm_reverse_map_t *curr_reverse_map = table_remove(sysmem_mappings->reverse_map_tree, pointer_from_u64(key));
-        UVM_ASSERT(curr_reverse_map == reverse_map);
-    }
-
     uvm_mutex_unlock(&sysmem_mappings->reverse_map_lock);
 
     kmem_cache_free(g_reverse_page_map_cache, reverse_map);
@@ -278,11 +290,9 @@ NV_STATUS uvm_pmm_sysmem_mappings_split_gpu_mappings(uvm_pmm_sysmem_mappings_t *
     uvm_mutex_lock(&sysmem_mappings->reverse_map_lock);
 
     for (subregion = 1; subregion < num_subregions; ++subregion) {
-        NvU64 key;
-
-        for (key = base_key + num_pages * subregion; key < base_key + num_pages * (subregion + 1); ++key) {
-            table_set(sysmem_mappings->reverse_map_tree, pointer_from_u64(key), new_reverse_maps[subregion - 1]);
-        }
+        table_set(sysmem_mappings->reverse_map_tree,
+                  pointer_from_u64(base_key + num_pages * subregion),
+                  new_reverse_maps[subregion - 1]);
     }
 
     orig_reverse_map->region = uvm_va_block_region(orig_reverse_map->region.first,
@@ -325,31 +335,24 @@ void uvm_pmm_sysmem_mappings_merge_gpu_mappings(uvm_pmm_sysmem_mappings_t *sysme
     if (num_pages == num_mapping_pages)
         goto unlock_no_update;
 
-    // Otherwise update the rest of slots to point at the same reverse map
-    // descriptor
+    // Otherwise drop the descriptors of the rest of the region, which is
+    // covered by the first one once it grows
     key = base_key + uvm_va_block_region_num_pages(first_reverse_map->region);
     running_page_index = first_reverse_map->region.outer;
     while (key < base_key + num_pages) {
         uvm_reverse_map_t *reverse_map = NULL;
-        size_t slot_index;
 
-        reverse_map = table_find(sysmem_mappings->reverse_map_tree, pointer_from_u64(key));
+        reverse_map = table_remove(sysmem_mappings->reverse_map_tree, pointer_from_u64(key));
         UVM_ASSERT(reverse_map);
         UVM_ASSERT(reverse_map != first_reverse_map);
         UVM_ASSERT(reverse_map->va_block == first_reverse_map->va_block);
         UVM_ASSERT(uvm_id_equal(reverse_map->owner, first_reverse_map->owner));
         UVM_ASSERT(reverse_map->region.first == running_page_index);
 
-        table_set(sysmem_mappings->reverse_map_tree, pointer_from_u64(key), first_reverse_map);
-
         num_mapping_pages = uvm_va_block_region_num_pages(reverse_map->region);
         UVM_ASSERT(IS_ALIGNED(key, num_mapping_pages));
         UVM_ASSERT(key + num_mapping_pages <= base_key + num_pages);
 
-        for (slot_index = 1; slot_index < num_mapping_pages; ++slot_index) {
-            table_set(sysmem_mappings->reverse_map_tree, pointer_from_u64(key + slot_index), first_reverse_map);
-        }
-
         key += num_mapping_pages;
         running_page_index = reverse_map->region.outer;
 
@@ -383,7 +386,7 @@ size_t uvm_pmm_sysmem_mappings_dma_to_virt(uvm_pmm_sysmem_mappings_t *sysmem_map
 
     key = base_key;
     do {
-        uvm_reverse_map_t *reverse_map = table_find(sysmem_mappings->reverse_map_tree, pointer_from_u64(key));
+        uvm_reverse_map_t *reverse_map = reverse_map_find_locked(sysmem_mappings, key);
 
         if (reverse_map) {
             size_t num_chunk_pages = uvm_va_block_region_num_pages(reverse_map->region);
@@ -478,8 +481,10 @@ static void cpu_chunk_release(nv_kref_t *kref)
 
         uvm_kvfree(phys_chunk->dirty_bitmap);
 
+        // put_page() is a no-op here, so the backing memory has to be
+        // returned to the physical heap explicitly.
         if (chunk->type != UVM_CPU_CHUNK_TYPE_HMM)
-            put_page(phys_chunk->common.page);
+            deallocate_u64((heap)heap_physical(get_kernel_heaps()), chunk->pa, uvm_cpu_chunk_get_size(chunk));
     }
     else {
         uvm_cpu_chunk_free(logical_chunk->parent);
@@ -987,6 +992,135 @@ uvm_cpu_chunk_t *uvm_cpu_chunk_merge(uvm_cpu_chunk_t **chunks)
     return parent;
 }
 
+static NvU64 cpu_chunk_get_dma_addr(uvm_cpu_physical_chunk_t *chunk, uvm_gpu_id_t id)
+{
+    uvm_cpu_phys_mapping_t *mapping;
+    NvU64 dma_addr = 0;
+
+    uvm_mutex_lock(&chunk->lock);
+    mapping = chunk_phys_mapping_get(chunk, id);
+    if (mapping)
+        dma_addr = mapping->dma_addr;
+    uvm_mutex_unlock(&chunk->lock);
+
+    return dma_addr;
+}
+
+// Release the bookkeeping of a physical chunk without touching the memory or
+// the DMA mappings it describes.
+static void cpu_chunk_free_descriptor(uvm_cpu_physical_chunk_t *chunk)
+{
+    if (chunk->gpu_mappings.max_entries > 1)
+        uvm_kvfree(chunk->gpu_mappings.dynamic_entries);
+
+    uvm_kvfree(chunk->dirty_bitmap);
+    uvm_kvfree(chunk);
+}
+
+static bool can_promote_chunks(uvm_cpu_chunk_t **chunks, size_t num_chunks, uvm_chunk_size_t new_size)
+{
+    uvm_cpu_physical_chunk_t *first_chunk = uvm_cpu_chunk_to_physical(chunks[0]);
+    NvU64 next_pa = chunks[0]->pa;
+    size_t i;
+
+    if (!IS_ALIGNED(chunks[0]->pa, new_size))
+        return false;
+
+    for (i = 0; i < num_chunks; i++) {
+        uvm_cpu_physical_chunk_t *phys_chunk;
+        uvm_processor_id_t id;
+
+        if (!uvm_cpu_chunk_is_physical(chunks[i]) || uvm_cpu_chunk_is_hmm(chunks[i]))
+            return false;
+
+        if (chunks[i]->pa != next_pa || nv_kref_read(&chunks[i]->refcount) != 1)
+            return false;
+
+        phys_chunk = uvm_cpu_chunk_to_physical(chunks[i]);
+        if (!uvm_processor_mask_equal(&phys_chunk->gpu_mappings.dma_addrs_mask,
+                                      &first_chunk->gpu_mappings.dma_addrs_mask))
+            return false;
+
+        // The DMA addresses of the chunks have to be contiguous as well, so
+        // that the promoted chunk can keep them.
+        for_each_id_in_mask(id, &phys_chunk->gpu_mappings.dma_addrs_mask) {
+            NvU64 first_dma_addr = cpu_chunk_get_dma_addr(first_chunk, id);
+
+            if (cpu_chunk_get_dma_addr(phys_chunk, id) != first_dma_addr + (chunks[i]->pa - chunks[0]->pa))
+                return false;
+        }
+
+        next_pa += uvm_cpu_chunk_get_size(chunks[i]);
+    }
+
+    return next_pa - chunks[0]->pa == new_size;
+}
+
+NV_STATUS uvm_cpu_chunk_promote(uvm_cpu_chunk_t **chunks, size_t num_chunks, uvm_cpu_chunk_t **new_chunk)
+{
+    uvm_cpu_physical_chunk_t *first_chunk;
+    uvm_cpu_physical_chunk_t *chunk;
+    uvm_chunk_size_t new_size = 0;
+    uvm_processor_id_t id;
+    size_t i;
+
+    UVM_ASSERT(chunks);
+    UVM_ASSERT(num_chunks > 1);
+    UVM_ASSERT(new_chunk);
+
+    for (i = 0; i < num_chunks; i++)
+        new_size += uvm_cpu_chunk_get_size(chunks[i]);
+
+    if (!is_power_of_2(new_size) || !(new_size & uvm_cpu_chunk_get_allocation_sizes()))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (!uvm_cpu_chunk_is_physical(chunks[0]) || !can_promote_chunks(chunks, num_chunks, new_size))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    first_chunk = uvm_cpu_chunk_to_physical(chunks[0]);
+
+    chunk = uvm_cpu_chunk_create(new_size);
+    if (!chunk)
+        return NV_ERR_NO_MEMORY;
+
+    chunk->common.type = UVM_CPU_CHUNK_TYPE_PHYSICAL;
+    chunk->common.pa = first_chunk->common.pa;
+
+    // The promoted chunk takes over the DMA mappings of the chunks. Their
+    // sizes already add up to the new chunk size in the mapped size
+    // accounting, so nothing is mapped or unmapped here.
+    for_each_id_in_mask(id, &first_chunk->gpu_mappings.dma_addrs_mask) {
+        NvU64 dma_addr = cpu_chunk_get_dma_addr(first_chunk, id);
+        uvm_cpu_phys_mapping_t *mapping;
+
+        uvm_mutex_lock(&chunk->lock);
+        mapping = chunk_phys_mapping_alloc(chunk, id);
+        if (mapping) {
+            mapping->dma_addr = dma_addr;
+            mapping->map_count = 1;
+            uvm_processor_mask_set(&chunk->gpu_mappings.dma_addrs_mask, id);
+        }
+        uvm_mutex_unlock(&chunk->lock);
+
+        if (!mapping) {
+            // The memory and the mappings still belong to the original chunks,
+            // so only the new descriptor is released.
+            cpu_chunk_free_descriptor(chunk);
+            return NV_ERR_NO_MEMORY;
+        }
+    }
+
+    bitmap_fill(chunk->dirty_bitmap, uvm_cpu_chunk_num_pages(&chunk->common));
+
+    // Only the descriptors of the original chunks are released. Their memory
+    // and DMA mappings now belong to the promoted chunk.
+    for (i = 0; i < num_chunks; i++)
+        cpu_chunk_free_descriptor(uvm_cpu_chunk_to_physical(chunks[i]));
+
+    *new_chunk = &chunk->common;
+    return NV_OK;
+}
+
 // Check the CPU PTE dirty bit and if set, clear it and fill the
 // physical chunk's dirty bitmap.
 static void check_cpu_dirty_flag(uvm_cpu_physical_chunk_t *chunk, uvm_page_index_t page_index)
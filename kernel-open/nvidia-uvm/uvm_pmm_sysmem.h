@@ -431,6 +431,18 @@ NV_STATUS uvm_cpu_chunk_split(uvm_cpu_chunk_t *chunk, uvm_cpu_chunk_t **new_chun
 // have the same size, parent, and set of mapped GPUs.
 uvm_cpu_chunk_t *uvm_cpu_chunk_merge(uvm_cpu_chunk_t **chunks);
 
+// Promote an array of physical chunks, ordered by address, into a single
+// physical chunk covering all of them. The chunks have to be physically
+// contiguous, start at an address aligned to the combined size, which has to
+// be an enabled CPU chunk size, and be DMA-mapped on the same set of GPUs.
+// Nothing is copied: the new chunk adopts the memory and the DMA mappings of
+// the input chunks, which can no longer be used on success.
+//
+// Returns NV_ERR_INVALID_ARGUMENT if the chunks can't be promoted and
+// NV_ERR_NO_MEMORY if the new chunk can't be allocated. The input chunks are
+// left untouched on failure.
+NV_STATUS uvm_cpu_chunk_promote(uvm_cpu_chunk_t **chunks, size_t num_chunks, uvm_cpu_chunk_t **new_chunk);
+
 // Mark the page_index sub-page of the chunk as dirty.
 // page_index is an offset into the chunk.
 //
@@ -841,6 +841,29 @@ NV_STATUS uvm_test_pmm_query(UVM_TEST_PMM_QUERY_PARAMS *params, struct file *fil
             params->value = gpu->pmm.chunk_sizes[UVM_PMM_GPU_MEMORY_TYPE_USER];
             status = NV_OK;
             break;
+        case UVM_TEST_PMM_QUERY_ALLOCS:
+            status = uvm_pmm_gpu_query_stat(&gpu->pmm, UVM_PMM_GPU_STAT_ALLOCS, &params->value);
+            break;
+        case UVM_TEST_PMM_QUERY_ROOT_CHUNK_SPLITS:
+            status = uvm_pmm_gpu_query_stat(&gpu->pmm, UVM_PMM_GPU_STAT_ROOT_CHUNK_SPLITS, &params->value);
+            break;
+        case UVM_TEST_PMM_QUERY_ROOT_CHUNK_MERGES:
+            status = uvm_pmm_gpu_query_stat(&gpu->pmm, UVM_PMM_GPU_STAT_ROOT_CHUNK_MERGES, &params->value);
+            break;
+        case UVM_TEST_PMM_QUERY_ROOT_CHUNKS_EVICTED_FOR_ALLOC:
+            status = uvm_pmm_gpu_query_stat(&gpu->pmm, UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_ALLOC, &params->value);
+            break;
+        case UVM_TEST_PMM_QUERY_ROOT_CHUNKS_EVICTED_FOR_PMA:
+            status = uvm_pmm_gpu_query_stat(&gpu->pmm, UVM_PMM_GPU_STAT_ROOT_CHUNKS_EVICTED_FOR_PMA, &params->value);
+            break;
+        case UVM_TEST_PMM_QUERY_PMA_FREE_2M_PAGES:
+            if (!gpu->pmm.pma_stats) {
+                status = NV_ERR_NOT_SUPPORTED;
+                break;
+            }
+            params->value = UVM_READ_ONCE(gpu->pmm.pma_stats->numFreePages2m);
+            status = NV_OK;
+            break;
         default:
             status = NV_ERR_INVALID_ARGUMENT;
             break;
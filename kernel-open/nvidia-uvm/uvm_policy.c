@@ -836,6 +836,9 @@ static NV_STATUS read_duplication_set(uvm_va_space_t *va_space, NvU64 base, NvU6
             }
 
             uvm_va_range_get_policy(va_range)->read_duplication = new_policy;
+
+            // The user's choice overrides the automatic read-mostly detection
+            uvm_va_range_get_policy(va_range)->read_duplication_auto = false;
         }
 
         UVM_ASSERT(va_range_last);
@@ -38,6 +38,11 @@
 #define UVM_HANDLE_MM_FAULT(vma, addr, flags)       handle_mm_fault(vma, addr, flags)
 #endif
 
+// Size and alignment of the windows uvm_populate_pageable_vma() populates at
+// a time
+#define UVM_POPULATE_PAGEABLE_WINDOW_SIZE  UVM_PAGE_SIZE_2M
+#define UVM_POPULATE_PAGEABLE_WINDOW_PAGES (UVM_POPULATE_PAGEABLE_WINDOW_SIZE / PAGE_SIZE)
+
 static bool is_write_populate(vmap vma, uvm_populate_permissions_t populate_permissions)
 {
     switch (populate_permissions) {
@@ -60,6 +65,57 @@ NV_STATUS uvm_handle_fault(vmap vma, unsigned long start, unsigned long vma_num_
     return status;
 }
 
+// Populate a window of at most pages_per_window pages starting at start, all
+// within the same vma.
+static NV_STATUS populate_pageable_window(vmap vma,
+                                          unsigned long start,
+                                          unsigned long num_pages,
+                                          bool touch,
+                                          bool write,
+                                          u64 *pages)
+{
+    unsigned int gup_flags = 0;
+    long ret;
+    NV_STATUS status;
+
+    status = uvm_handle_fault(vma, start, num_pages, write);
+    if (status != NV_OK)
+        return status;
+
+    if (touch)
+        ret = NV_PIN_USER_PAGES_REMOTE(NULL, start, num_pages, gup_flags, pages, NULL, NULL);
+    else
+        ret = NV_GET_USER_PAGES_REMOTE(NULL, start, num_pages, gup_flags, pages, NULL, NULL);
+
+    if (ret < 0)
+        return errno_to_nv_status(ret);
+
+    // We couldn't populate all pages, return error
+    if (ret < num_pages) {
+        if (touch) {
+            unsigned long i;
+
+            for (i = 0; i < ret; i++) {
+                UVM_ASSERT(pages[i]);
+                NV_UNPIN_USER_PAGE(pages[i]);
+            }
+        }
+
+        return NV_ERR_NO_MEMORY;
+    }
+
+    if (touch) {
+        unsigned long i;
+
+        for (i = 0; i < num_pages; i++) {
+            uvm_touch_page(pages[i]);
+            NV_UNPIN_USER_PAGE(pages[i]);
+        }
+    }
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_populate_pageable_vma(vmap vma,
                                     unsigned long start,
                                     unsigned long length,
@@ -67,11 +123,10 @@ NV_STATUS uvm_populate_pageable_vma(vmap vma,
                                     bool touch,
                                     uvm_populate_permissions_t populate_permissions)
 {
-    unsigned long vma_num_pages;
     unsigned long outer = start + length;
-    unsigned int gup_flags = 0;
     unsigned long vm_flags = vma->flags;
-    long ret;
+    unsigned long addr;
+    bool write = is_write_populate(vma, populate_permissions);
     u64 *pages = NULL;
     NV_STATUS status = NV_OK;
 
@@ -91,55 +146,26 @@ NV_STATUS uvm_populate_pageable_vma(vmap vma,
     start = max(start, vma->node.r.start);
     outer = min(outer, vma->node.r.end);
 
-    vma_num_pages = (outer - start) / PAGE_SIZE;
-
     // Please see the comment in uvm_ats_service_fault() regarding the usage of
-    // the touch parameter for more details.
+    // the touch parameter for more details. The page array only needs to hold
+    // one window, no matter how large the range is.
     if (touch) {
-        pages = uvm_kvmalloc(vma_num_pages * sizeof(pages[0]));
+        pages = uvm_kvmalloc(UVM_POPULATE_PAGEABLE_WINDOW_PAGES * sizeof(pages[0]));
         if (!pages)
             return NV_ERR_NO_MEMORY;
     }
 
-    status = uvm_handle_fault(vma, start, vma_num_pages, is_write_populate(vma, populate_permissions));
-    if (status != NV_OK)
-        goto out;
-
-    if (touch)
-        ret = NV_PIN_USER_PAGES_REMOTE(NULL, start, vma_num_pages, gup_flags, pages, NULL, NULL);
-    else
-        ret = NV_GET_USER_PAGES_REMOTE(NULL, start, vma_num_pages, gup_flags, pages, NULL, NULL);
-
-    if (ret < 0) {
-        status = errno_to_nv_status(ret);
-        goto out;
-    }
-
-    // We couldn't populate all pages, return error
-    if (ret < vma_num_pages) {
-        if (touch) {
-            unsigned long i;
-
-            for (i = 0; i < ret; i++) {
-                UVM_ASSERT(pages[i]);
-                NV_UNPIN_USER_PAGE(pages[i]);
-            }
-        }
-
-        status = NV_ERR_NO_MEMORY;
-        goto out;
-    }
-
-    if (touch) {
-        unsigned long i;
+    // Populate in windows aligned to UVM_POPULATE_PAGEABLE_WINDOW_SIZE, so that
+    // each window covers at most one 2M page of a huge page backed mapping.
+    for (addr = start; addr < outer && status == NV_OK;) {
+        unsigned long window_outer = min(UVM_ALIGN_DOWN(addr, UVM_POPULATE_PAGEABLE_WINDOW_SIZE) +
+                                         UVM_POPULATE_PAGEABLE_WINDOW_SIZE,
+                                         outer);
 
-        for (i = 0; i < vma_num_pages; i++) {
-            uvm_touch_page(pages[i]);
-            NV_UNPIN_USER_PAGE(pages[i]);
-        }
+        status = populate_pageable_window(vma, addr, (window_outer - addr) / PAGE_SIZE, touch, write, pages);
+        addr = window_outer;
     }
 
-out:
     uvm_kvfree(pages);
     return status;
 }
@@ -152,6 +178,11 @@ closure_function(6, 1, void, uvm_populate_handler,
     u64 end = bound(end);
     if (start == end)
         return;
+
+    // Skip the vmaps below the remaining range without populating anything
+    if (m->node.r.end <= start)
+        return;
+
     if (m->node.r.start > start) {
         *bound(status) = NV_ERR_INVALID_ADDRESS;
         return;
@@ -41,6 +41,8 @@ typedef enum
 // Populate the pages of the given vma that overlap with the
 // [start:start+length) range. If any of the pages was not populated, we return
 // NV_ERR_NO_MEMORY. See the comment below for details on the touch argument.
+// The range is populated in 2M aligned windows, so the memory needed to touch
+// the pages doesn't grow with the size of the range.
 //
 // Locking: vma->vm_mm->mmap_lock must be held in read or write mode
 NV_STATUS uvm_populate_pageable_vma(vmap vma,
@@ -191,6 +191,23 @@ void uvm_pte_batch_write_pte(uvm_pte_batch_t *batch, uvm_gpu_phys_address_t pte,
     uvm_pte_batch_write_consecutive(batch, pte_bits);
 }
 
+void uvm_pte_batch_copy_ptes(uvm_pte_batch_t *batch, uvm_gpu_phys_address_t first_pte, uvm_gpu_address_t src, NvU32 entry_size, NvU32 entry_count)
+{
+    uvm_gpu_t *gpu = uvm_push_get_gpu(batch->push);
+
+    uvm_pte_batch_flush_ptes(batch);
+
+    uvm_push_set_flag(batch->push, UVM_PUSH_FLAG_CE_NEXT_PIPELINED);
+    uvm_push_set_flag(batch->push, UVM_PUSH_FLAG_NEXT_MEMBAR_NONE);
+    gpu->parent->ce_hal->memcopy(batch->push,
+                                 uvm_mmu_gpu_address(gpu, first_pte),
+                                 src,
+                                 entry_size * entry_count);
+
+    if (first_pte.aperture == UVM_APERTURE_SYS)
+        batch->membar = UVM_MEMBAR_SYS;
+}
+
 void uvm_pte_batch_clear_ptes(uvm_pte_batch_t *batch, uvm_gpu_phys_address_t first_pte, NvU64 empty_pte_bits, NvU32 entry_size, NvU32 entry_count)
 {
     uvm_gpu_t *gpu = uvm_push_get_gpu(batch->push);
@@ -80,6 +80,11 @@ void uvm_pte_batch_write_ptes(uvm_pte_batch_t *batch,
 void uvm_pte_batch_write_pte(uvm_pte_batch_t *batch,
         uvm_gpu_phys_address_t pte, NvU64 pte_bits, NvU32 entry_size);
 
+// Queue up a copy of entry_count PTEs from src, which the caller must keep
+// unchanged until the push completes
+void uvm_pte_batch_copy_ptes(uvm_pte_batch_t *batch,
+        uvm_gpu_phys_address_t first_pte, uvm_gpu_address_t src, NvU32 entry_size, NvU32 entry_count);
+
 // Queue up a clear of PTEs
 void uvm_pte_batch_clear_ptes(uvm_pte_batch_t *batch,
         uvm_gpu_phys_address_t first_pte, NvU64 pte_bits, NvU32 entry_size, NvU32 entry_count);
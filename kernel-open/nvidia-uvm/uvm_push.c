@@ -189,6 +189,8 @@ static void push_fill_info(uvm_push_t *push,
 }
 
 static NV_STATUS push_begin_acquire_with_info(uvm_channel_t *channel,
+                                              uvm_channel_type_t channel_type,
+                                              NvU64 queue_start_ns,
                                               uvm_tracker_t *tracker,
                                               uvm_push_t *push,
                                               const char *filename,
@@ -207,6 +209,10 @@ static NV_STATUS push_begin_acquire_with_info(uvm_channel_t *channel,
     if (status != NV_OK)
         return status;
 
+    push->channel_type = channel_type;
+    if (channel_type < UVM_CHANNEL_TYPE_CE_COUNT)
+        push->queue_ns = NV_GETTIME() - queue_start_ns;
+
     push_fill_info(push, filename, function, line, format, args);
 
     uvm_push_acquire_tracker(push, tracker);
@@ -228,6 +234,7 @@ NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
     va_list args;
     NV_STATUS status;
     uvm_channel_t *channel;
+    NvU64 queue_start_ns = NV_GETTIME();
 
     if (dst_gpu != NULL) {
         UVM_ASSERT(type == UVM_CHANNEL_TYPE_GPU_TO_GPU);
@@ -241,7 +248,16 @@ NV_STATUS __uvm_push_begin_acquire_with_info(uvm_channel_manager_t *manager,
     UVM_ASSERT(channel);
 
     va_start(args, format);
-    status = push_begin_acquire_with_info(channel, tracker, push, filename, function, line, format, args);
+    status = push_begin_acquire_with_info(channel,
+                                          type,
+                                          queue_start_ns,
+                                          tracker,
+                                          push,
+                                          filename,
+                                          function,
+                                          line,
+                                          format,
+                                          args);
     va_end(args);
 
     return status;
@@ -264,7 +280,16 @@ NV_STATUS __uvm_push_begin_acquire_on_channel_with_info(uvm_channel_t *channel,
         return status;
 
     va_start(args, format);
-    status = push_begin_acquire_with_info(channel, tracker, push, filename, function, line, format, args);
+    status = push_begin_acquire_with_info(channel,
+                                          UVM_CHANNEL_TYPE_COUNT,
+                                          0,
+                                          tracker,
+                                          push,
+                                          filename,
+                                          function,
+                                          line,
+                                          format,
+                                          args);
     va_end(args);
 
     return status;
@@ -283,7 +308,16 @@ NV_STATUS __uvm_push_begin_acquire_on_reserved_channel_with_info(uvm_channel_t *
     NV_STATUS status;
 
     va_start(args, format);
-    status = push_begin_acquire_with_info(channel, tracker, push, filename, function, line, format, args);
+    status = push_begin_acquire_with_info(channel,
+                                          UVM_CHANNEL_TYPE_COUNT,
+                                          0,
+                                          tracker,
+                                          push,
+                                          filename,
+                                          function,
+                                          line,
+                                          format,
+                                          args);
     va_end(args);
 
     return status;
@@ -103,6 +103,19 @@ struct uvm_push_struct
 
     // Channel to use for indirect submission
     uvm_channel_t *launch_channel;
+
+    // Bytes copied by CE methods in this push, used to balance the load
+    // across CE channel pools.
+    NvU64 copy_bytes;
+
+    // Channel type the push was begun for. UVM_CHANNEL_TYPE_COUNT for pushes
+    // begun on a given channel, which are not accounted in the push latency
+    // stats of the channel manager.
+    uvm_channel_type_t channel_type;
+
+    // Time spent waiting for a channel and pushbuffer space when beginning the
+    // push, in ns.
+    NvU64 queue_ns;
 };
 
 #define UVM_PUSH_ACQUIRE_INFO_MAX_ENTRIES 16
@@ -56,8 +56,6 @@ NV_STATUS uvm_pushbuffer_create(uvm_channel_manager_t *channel_manager, uvm_push
 
     pushbuffer->channel_manager = channel_manager;
 
-    uvm_spin_lock_init(&pushbuffer->lock, UVM_LOCK_ORDER_LEAF);
-
     // Currently the pushbuffer supports UVM_PUSHBUFFER_CHUNKS of concurrent
     // pushes.
     uvm_sema_init(&pushbuffer->concurrent_pushes_sema, UVM_PUSHBUFFER_CHUNKS, UVM_LOCK_ORDER_PUSH);
@@ -124,8 +122,10 @@ NV_STATUS uvm_pushbuffer_create(uvm_channel_manager_t *channel_manager, uvm_push
     bitmap_fill(pushbuffer->idle_chunks, UVM_PUSHBUFFER_CHUNKS);
     bitmap_fill(pushbuffer->available_chunks, UVM_PUSHBUFFER_CHUNKS);
 
-    for (i = 0; i < UVM_PUSHBUFFER_CHUNKS; ++i)
+    for (i = 0; i < UVM_PUSHBUFFER_CHUNKS; ++i) {
+        uvm_spin_lock_init(&pushbuffer->chunks[i].lock, UVM_LOCK_ORDER_LEAF);
         INIT_LIST_HEAD(&pushbuffer->chunks[i].pending_gpfifos);
+    }
 
     status = create_procfs(pushbuffer);
     if (status != NV_OK)
@@ -140,28 +140,6 @@ error:
     return status;
 }
 
-static uvm_pushbuffer_chunk_t *get_chunk_in_mask(uvm_pushbuffer_t *pushbuffer, unsigned long *mask)
-{
-    NvU32 index = find_first_bit(mask, UVM_PUSHBUFFER_CHUNKS);
-
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
-
-    if (index == UVM_PUSHBUFFER_CHUNKS)
-        return NULL;
-
-    return &pushbuffer->chunks[index];
-}
-
-static uvm_pushbuffer_chunk_t *get_available_chunk(uvm_pushbuffer_t *pushbuffer)
-{
-    return get_chunk_in_mask(pushbuffer, pushbuffer->available_chunks);
-}
-
-static uvm_pushbuffer_chunk_t *get_idle_chunk(uvm_pushbuffer_t *pushbuffer)
-{
-    return get_chunk_in_mask(pushbuffer, pushbuffer->idle_chunks);
-}
-
 static NvU32 chunk_get_index(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chunk_t *chunk)
 {
     NvU32 index = chunk - pushbuffer->chunks;
@@ -174,52 +152,89 @@ static NvU32 chunk_get_offset(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chunk
     return chunk_get_index(pushbuffer, chunk) * UVM_PUSHBUFFER_CHUNK_SIZE;
 }
 
+// The bitmaps are shared by all chunks, so they are always updated with atomic
+// bit operations, but the bits of a chunk only change with its lock held.
 static void set_chunk(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chunk_t *chunk, unsigned long *mask)
 {
     NvU32 index = chunk_get_index(pushbuffer, chunk);
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_assert_spinlock_locked(&chunk->lock);
 
-    __set_bit(index, mask);
+    set_bit(index, mask);
 }
 
 static void clear_chunk(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chunk_t *chunk, unsigned long *mask)
 {
     NvU32 index = chunk_get_index(pushbuffer, chunk);
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_assert_spinlock_locked(&chunk->lock);
+
+    clear_bit(index, mask);
+}
 
-    __clear_bit(index, mask);
+// Each CPU starts looking for a chunk at a different index, so that CPUs doing
+// concurrent pushes mostly claim, and later complete, distinct chunks and
+// don't contend on the same chunk lock.
+static NvU32 chunk_home_index(void)
+{
+    return current_cpu()->id % UVM_PUSHBUFFER_CHUNKS;
 }
 
-static uvm_pushbuffer_chunk_t *pick_chunk(uvm_pushbuffer_t *pushbuffer)
+// Claim the chunk at the given index if it is still set in the given mask once
+// the chunk lock is taken.
+static bool try_claim_chunk_index(uvm_pushbuffer_t *pushbuffer,
+                                  uvm_push_t *push,
+                                  NvU32 index,
+                                  unsigned long *mask)
 {
-    uvm_pushbuffer_chunk_t *chunk = get_idle_chunk(pushbuffer);
+    uvm_pushbuffer_chunk_t *chunk = &pushbuffer->chunks[index];
+    bool claimed = false;
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_spin_lock(&chunk->lock);
 
-    if (chunk == NULL)
-        chunk = get_available_chunk(pushbuffer);
+    if (test_bit(index, mask) && test_bit(index, pushbuffer->available_chunks)) {
+        UVM_ASSERT(chunk->current_push == NULL);
 
-    return chunk;
+        clear_chunk(pushbuffer, chunk, pushbuffer->idle_chunks);
+        clear_chunk(pushbuffer, chunk, pushbuffer->available_chunks);
+        chunk->current_push = push;
+        claimed = true;
+    }
+
+    uvm_spin_unlock(&chunk->lock);
+
+    return claimed;
 }
 
-static bool try_claim_chunk(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push, uvm_pushbuffer_chunk_t **chunk_out)
+static uvm_pushbuffer_chunk_t *try_claim_chunk_in_mask(uvm_pushbuffer_t *pushbuffer,
+                                                       uvm_push_t *push,
+                                                       unsigned long *mask)
 {
-    uvm_pushbuffer_chunk_t *chunk;
+    NvU32 home = chunk_home_index();
+    NvU32 i;
+
+    for (i = 0; i < UVM_PUSHBUFFER_CHUNKS; ++i) {
+        NvU32 index = (home + i) % UVM_PUSHBUFFER_CHUNKS;
 
-    uvm_spin_lock(&pushbuffer->lock);
+        // Unlocked test to skip the chunks that are obviously not claimable
+        if (!test_bit(index, mask))
+            continue;
 
-    chunk = pick_chunk(pushbuffer);
-    if (!chunk)
-        goto done;
+        if (try_claim_chunk_index(pushbuffer, push, index, mask))
+            return &pushbuffer->chunks[index];
+    }
+
+    return NULL;
+}
+
+static bool try_claim_chunk(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push, uvm_pushbuffer_chunk_t **chunk_out)
+{
+    // Idle chunks are always preferred
+    uvm_pushbuffer_chunk_t *chunk = try_claim_chunk_in_mask(pushbuffer, push, pushbuffer->idle_chunks);
 
-    chunk->current_push = push;
-    clear_chunk(pushbuffer, chunk, pushbuffer->idle_chunks);
-    clear_chunk(pushbuffer, chunk, pushbuffer->available_chunks);
+    if (chunk == NULL)
+        chunk = try_claim_chunk_in_mask(pushbuffer, push, pushbuffer->available_chunks);
 
-done:
-    uvm_spin_unlock(&pushbuffer->lock);
     *chunk_out = chunk;
 
     return chunk != NULL;
@@ -322,7 +337,7 @@ static NvU32 chunk_get_cpu_put(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chun
 {
     uvm_gpfifo_entry_t *gpfifo = chunk_get_last_gpfifo(chunk);
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_assert_spinlock_locked(&chunk->lock);
 
     if (gpfifo != NULL)
         return gpfifo->pushbuffer_offset + gpfifo->pushbuffer_size - chunk_get_offset(pushbuffer, chunk);
@@ -335,7 +350,7 @@ static NvU32 chunk_get_gpu_get(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chun
 {
     uvm_gpfifo_entry_t *gpfifo = chunk_get_first_gpfifo(chunk);
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_assert_spinlock_locked(&chunk->lock);
 
     if (gpfifo != NULL)
         return gpfifo->pushbuffer_offset - chunk_get_offset(pushbuffer, chunk);
@@ -348,7 +363,8 @@ static void update_chunk(uvm_pushbuffer_t *pushbuffer, uvm_pushbuffer_chunk_t *c
     NvU32 gpu_get = chunk_get_gpu_get(pushbuffer, chunk);
     NvU32 cpu_put = chunk_get_cpu_put(pushbuffer, chunk);
 
-    uvm_assert_spinlock_locked(&pushbuffer->lock);
+    uvm_assert_spinlock_locked(&chunk->lock);
+    UVM_ASSERT(chunk->current_push == NULL);
 
     if (gpu_get == cpu_put) {
         // cpu_put can be equal to gpu_get both when the chunk is full and empty. We
@@ -477,7 +493,7 @@ void uvm_pushbuffer_mark_completed(uvm_channel_t *channel, uvm_gpfifo_entry_t *g
         push_info->on_complete_data = NULL;
     }
 
-    uvm_spin_lock(&pushbuffer->lock);
+    uvm_spin_lock(&chunk->lock);
 
     if (gpfifo == chunk_get_first_gpfifo(chunk))
         need_to_update_chunk = true;
@@ -491,7 +507,7 @@ void uvm_pushbuffer_mark_completed(uvm_channel_t *channel, uvm_gpfifo_entry_t *g
     if (need_to_update_chunk && chunk->current_push == NULL)
         update_chunk(pushbuffer, chunk);
 
-    uvm_spin_unlock(&pushbuffer->lock);
+    uvm_spin_unlock(&chunk->lock);
 }
 
 NvU32 uvm_pushbuffer_get_offset_for_push(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push)
@@ -581,16 +597,18 @@ void uvm_pushbuffer_end_push(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push, uvm
 
     uvm_channel_pool_assert_locked(push->channel->pool);
 
-    uvm_spin_lock(&pushbuffer->lock);
+    uvm_spin_lock(&chunk->lock);
 
     list_add_tail(&gpfifo->pending_list_node, &chunk->pending_gpfifos);
 
-    update_chunk(pushbuffer, chunk);
-
+    // The push has to be dropped before the update, which may make the chunk
+    // available to be claimed again.
     UVM_ASSERT(chunk->current_push == push);
     chunk->current_push = NULL;
 
-    uvm_spin_unlock(&pushbuffer->lock);
+    update_chunk(pushbuffer, chunk);
+
+    uvm_spin_unlock(&chunk->lock);
 
     // uvm_pushbuffer_end_push() needs to be called with the channel lock held
     // while the concurrent pushes sema has a higher lock order. To keep the
@@ -600,15 +618,8 @@ void uvm_pushbuffer_end_push(uvm_pushbuffer_t *pushbuffer, uvm_push_t *push, uvm
 
 bool uvm_pushbuffer_has_space(uvm_pushbuffer_t *pushbuffer)
 {
-    bool has_space;
-
-    uvm_spin_lock(&pushbuffer->lock);
-
-    has_space = pick_chunk(pushbuffer) != NULL;
-
-    uvm_spin_unlock(&pushbuffer->lock);
-
-    return has_space;
+    // Idle chunks are always also available
+    return !bitmap_empty(pushbuffer->available_chunks, UVM_PUSHBUFFER_CHUNKS);
 }
 
 void uvm_pushbuffer_print(uvm_pushbuffer_t *pushbuffer)
@@ -64,6 +64,13 @@
 // the CPU spin waits on the GPU to complete some of the pending pushes making
 // space for a new one.
 //
+// There is no pushbuffer-wide lock. Each chunk has its own lock protecting its
+// state and its bits in the bitmaps, which are updated with atomic bit
+// operations. Claiming a chunk scans the bitmaps without any lock, starting
+// at an index derived from the current CPU, and only takes the lock of the
+// candidate chunk to claim it. Completing a push only takes the lock of the
+// chunk the push used.
+//
 // To explain how chunks track pending pushes we will go through an example
 // modifying a chunk's state. Let's start with a few pending pushes in the
 // chunk:
@@ -203,6 +210,10 @@ typedef struct
 
     // Currently on-going push in the chunk. There can be only one at a time.
     uvm_push_t *current_push;
+
+    // Lock protecting the state of the chunk, and its bits in the pushbuffer
+    // bitmaps. Only one chunk lock is ever held at a time.
+    uvm_spinlock_t lock;
 } uvm_pushbuffer_chunk_t;
 
 struct uvm_pushbuffer_struct
@@ -228,9 +239,6 @@ struct uvm_pushbuffer_struct
     // Chunks that do not have an on-going push nor any pending pushes.
     DECLARE_BITMAP(idle_chunks, UVM_PUSHBUFFER_CHUNKS);
 
-    // Lock protecting chunk state and the bitmaps.
-    uvm_spinlock_t lock;
-
     // Semaphore enforcing a limited number of concurrent pushes.
     // Decremented in uvm_pushbuffer_begin_push(), incremented in
     // uvm_pushbuffer_end_push().
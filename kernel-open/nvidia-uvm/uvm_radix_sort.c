@@ -0,0 +1,89 @@
+/*******************************************************************************
+    Copyright (c) 2023 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "uvm_radix_sort.h"
+
+#define UVM_RADIX_SORT_DIGIT_BITS 8
+#define UVM_RADIX_SORT_BUCKETS    (1 << UVM_RADIX_SORT_DIGIT_BITS)
+#define UVM_RADIX_SORT_DIGITS     (128 / UVM_RADIX_SORT_DIGIT_BITS)
+
+static NvU32 entry_digit(const uvm_radix_sort_entry_t *entry, NvU32 digit)
+{
+    NvU32 shift = (digit % (64 / UVM_RADIX_SORT_DIGIT_BITS)) * UVM_RADIX_SORT_DIGIT_BITS;
+    NvU64 word = (digit < 64 / UVM_RADIX_SORT_DIGIT_BITS) ? entry->lo : entry->hi;
+
+    return (word >> shift) & (UVM_RADIX_SORT_BUCKETS - 1);
+}
+
+void uvm_radix_sort(uvm_radix_sort_entry_t *entries, uvm_radix_sort_entry_t *scratch, NvU32 count)
+{
+    uvm_radix_sort_entry_t *src = entries;
+    uvm_radix_sort_entry_t *dst = scratch;
+    NvU32 offsets[UVM_RADIX_SORT_BUCKETS];
+    NvU64 diff_hi = 0;
+    NvU64 diff_lo = 0;
+    NvU32 digit;
+    NvU32 i;
+
+    if (count <= 1)
+        return;
+
+    // Find the bits that differ in any key, so that passes over digits that
+    // are the same for all the keys can be skipped. Fault and notification
+    // batches typically share the VA space and most of the address bits.
+    for (i = 1; i < count; i++) {
+        diff_hi |= entries[i].hi ^ entries[0].hi;
+        diff_lo |= entries[i].lo ^ entries[0].lo;
+    }
+
+    for (digit = 0; digit < UVM_RADIX_SORT_DIGITS; digit++) {
+        uvm_radix_sort_entry_t diff = { diff_hi, diff_lo, NULL };
+        uvm_radix_sort_entry_t *tmp;
+        NvU32 sum = 0;
+
+        if (entry_digit(&diff, digit) == 0)
+            continue;
+
+        memset(offsets, 0, sizeof(offsets));
+
+        for (i = 0; i < count; i++)
+            offsets[entry_digit(&src[i], digit)]++;
+
+        for (i = 0; i < UVM_RADIX_SORT_BUCKETS; i++) {
+            NvU32 bucket_count = offsets[i];
+
+            offsets[i] = sum;
+            sum += bucket_count;
+        }
+
+        for (i = 0; i < count; i++)
+            dst[offsets[entry_digit(&src[i], digit)]++] = src[i];
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != entries)
+        memcpy(entries, src, count * sizeof(*entries));
+}
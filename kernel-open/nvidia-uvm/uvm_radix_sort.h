@@ -0,0 +1,57 @@
+/*******************************************************************************
+    Copyright (c) 2023 NVIDIA Corporation
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+        The above copyright notice and this permission notice shall be
+        included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef __UVM_RADIX_SORT_H__
+#define __UVM_RADIX_SORT_H__
+
+#include "uvm_common.h"
+
+// Element of a radix sort. Elements are sorted by the 128-bit key {hi, lo} in
+// ascending order, and elem is carried along. Callers that only need 64 bits
+// of key leave hi as 0; digits that are the same for all the elements are
+// skipped, so the unused half costs a single scan.
+typedef struct
+{
+    NvU64 hi;
+    NvU64 lo;
+    void *elem;
+} uvm_radix_sort_entry_t;
+
+// Stable LSD radix sort of count entries, using scratch (which must also hold
+// count entries) as the destination of every other pass. The sorted entries
+// are always left in entries.
+void uvm_radix_sort(uvm_radix_sort_entry_t *entries, uvm_radix_sort_entry_t *scratch, NvU32 count);
+
+// Sort an array of pointers given the keys of its elements in entries. On
+// return, elems holds the elem pointers of entries in key order.
+static void uvm_radix_sort_ptrs(void **elems, uvm_radix_sort_entry_t *entries, uvm_radix_sort_entry_t *scratch, NvU32 count)
+{
+    NvU32 i;
+
+    uvm_radix_sort(entries, scratch, count);
+
+    for (i = 0; i < count; i++)
+        elems[i] = entries[i].elem;
+}
+
+#endif // __UVM_RADIX_SORT_H__
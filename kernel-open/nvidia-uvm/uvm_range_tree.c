@@ -228,7 +228,27 @@ uvm_range_tree_node_t *uvm_range_tree_merge_next(uvm_range_tree_t *tree, uvm_ran
 
 uvm_range_tree_node_t *uvm_range_tree_find(uvm_range_tree_t *tree, NvU64 addr)
 {
-    return range_node_find(tree, addr, NULL, NULL);
+    uvm_range_tree_node_t *node = UVM_READ_ONCE(tree->last_hit);
+
+    if (node) {
+        if (addr >= node->start && addr <= node->end)
+            return node;
+
+        // Sorted lookups usually move on to the next node
+        if (addr > node->end) {
+            node = uvm_range_tree_next(tree, node);
+            if (node && addr >= node->start && addr <= node->end)
+                goto hit;
+        }
+    }
+
+    node = range_node_find(tree, addr, NULL, NULL);
+    if (!node)
+        return NULL;
+
+hit:
+    UVM_WRITE_ONCE(tree->last_hit, node);
+    return node;
 }
 
 uvm_range_tree_node_t *uvm_range_tree_iter_first(uvm_range_tree_t *tree, NvU64 start, NvU64 end)
@@ -47,6 +47,13 @@ typedef struct uvm_range_tree_struct
     // to avoid calling rb_next and rb_prev frequently, particularly while
     // iterating.
     struct list head;
+
+    // Node returned by the last successful uvm_range_tree_find(), or NULL.
+    // Lookups tend to be clustered, as with sorted fault batches, so this node
+    // and the one after it are checked before walking the tree. The hint is
+    // updated by concurrent lookups, which is safe because nodes can only be
+    // removed while lookups are excluded.
+    struct uvm_range_tree_node_struct *last_hit;
 } uvm_range_tree_t;
 
 typedef struct uvm_range_tree_node_struct
@@ -69,6 +76,9 @@ NV_STATUS uvm_range_tree_add(uvm_range_tree_t *tree, uvm_range_tree_node_t *node
 
 static void uvm_range_tree_remove(uvm_range_tree_t *tree, uvm_range_tree_node_t *node)
 {
+    if (UVM_READ_ONCE(tree->last_hit) == node)
+        UVM_WRITE_ONCE(tree->last_hit, NULL);
+
     rb_erase(&node->rb_node, &tree->rb_root);
     list_del(&node->list);
 }
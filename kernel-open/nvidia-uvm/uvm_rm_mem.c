@@ -28,6 +28,34 @@
 #include "uvm_nanos.h"
 #include "nv_uvm_interface.h"
 
+// Small allocations are carved out of UVM_RM_MEM_SLAB_SIZE slabs in
+// power-of-two runs of UVM_RM_MEM_SLAB_CHUNK_SIZE chunks. Runs are naturally
+// aligned within the slab, and the slab itself is mapped with
+// UVM_RM_MEM_SLAB_SIZE alignment on every GPU, so a run honors any alignment up
+// to its own size.
+#define UVM_RM_MEM_SLAB_SIZE            (64 * 1024)
+#define UVM_RM_MEM_SLAB_CHUNK_SIZE      256
+#define UVM_RM_MEM_SLAB_CHUNKS          (UVM_RM_MEM_SLAB_SIZE / UVM_RM_MEM_SLAB_CHUNK_SIZE)
+#define UVM_RM_MEM_SUBALLOC_MAX_SIZE    (UVM_RM_MEM_SLAB_SIZE / 4)
+
+struct uvm_rm_mem_slab_struct
+{
+    // Backing allocation, owned by the slab
+    uvm_rm_mem_t *rm_mem;
+
+    // Node in gpu->rm_mem_pool.slabs[type]
+    struct list_head list_node;
+
+    // Chunks in use by sub-allocations
+    DECLARE_BITMAP(used_chunks, UVM_RM_MEM_SLAB_CHUNKS);
+
+    NvU32 num_allocs;
+
+    // Number of sub-allocations mapped on each non-owner GPU. The backing
+    // allocation is mapped on a GPU for as long as its count is non-zero.
+    NvU32 gpu_map_count[UVM_GLOBAL_ID_MAX_PROCESSORS];
+};
+
 bool uvm_rm_mem_mapped_on_gpu(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu)
 {
     return uvm_global_processor_mask_test(&rm_mem->mapped_on, gpu->global_id);
@@ -188,6 +216,275 @@ static void rm_mem_unmap_gpu_proxy(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu)
     rm_mem_clear_gpu_proxy_va(rm_mem, gpu);
 }
 
+void uvm_rm_mem_pool_init(uvm_gpu_t *gpu)
+{
+    uvm_rm_mem_pool_t *pool = &gpu->rm_mem_pool;
+    int i;
+
+    uvm_mutex_init(&pool->lock, UVM_LOCK_ORDER_RM_MEM_POOL);
+
+    for (i = 0; i < UVM_RM_MEM_TYPE_COUNT; i++)
+        INIT_LIST_HEAD(&pool->slabs[i]);
+}
+
+void uvm_rm_mem_pool_deinit(uvm_gpu_t *gpu)
+{
+    uvm_rm_mem_pool_t *pool = &gpu->rm_mem_pool;
+    int i;
+
+    for (i = 0; i < UVM_RM_MEM_TYPE_COUNT; i++)
+        UVM_ASSERT_MSG(list_empty(&pool->slabs[i]), "Leaked rm_mem sub-allocations, GPU %s\n", uvm_gpu_name(gpu));
+}
+
+static bool rm_mem_can_suballoc(uvm_gpu_t *gpu, NvLength size, NvU64 gpu_alignment)
+{
+    // Confidential Computing buffers have their own protection and alignment
+    // requirements, and in SR-IOV heavy each allocation also needs its own
+    // proxy mapping, so both keep using dedicated allocations.
+    if (uvm_conf_computing_mode_enabled(gpu) || uvm_gpu_uses_proxy_channel_pool(gpu))
+        return false;
+
+    return (size <= UVM_RM_MEM_SUBALLOC_MAX_SIZE) && (gpu_alignment <= UVM_RM_MEM_SUBALLOC_MAX_SIZE);
+}
+
+static NvU32 rm_mem_suballoc_num_chunks(NvLength size, NvU64 gpu_alignment)
+{
+    NvU64 run_size;
+
+    // A zero alignment means 4K, same as for dedicated allocations
+    if (gpu_alignment == 0)
+        gpu_alignment = UVM_PAGE_SIZE_4K;
+
+    run_size = max((NvU64)roundup_pow_of_two(size), gpu_alignment);
+    run_size = max(run_size, (NvU64)UVM_RM_MEM_SLAB_CHUNK_SIZE);
+
+    return (NvU32)roundup_pow_of_two(run_size / UVM_RM_MEM_SLAB_CHUNK_SIZE);
+}
+
+// Find a free naturally-aligned run of the given number of chunks, or return
+// UVM_RM_MEM_SLAB_CHUNKS.
+static NvU32 rm_mem_slab_find_run(uvm_rm_mem_slab_t *slab, NvU32 num_chunks)
+{
+    NvU32 first;
+
+    for (first = 0; first < UVM_RM_MEM_SLAB_CHUNKS; first += num_chunks) {
+        if (find_next_bit(slab->used_chunks, first + num_chunks, first) >= first + num_chunks)
+            return first;
+    }
+
+    return UVM_RM_MEM_SLAB_CHUNKS;
+}
+
+static void rm_mem_slab_destroy(uvm_rm_mem_slab_t *slab)
+{
+    UVM_ASSERT(slab->num_allocs == 0);
+
+    list_del(&slab->list_node);
+    uvm_rm_mem_free(slab->rm_mem);
+    uvm_kvfree(slab);
+}
+
+static NV_STATUS rm_mem_slab_create(uvm_gpu_t *gpu, uvm_rm_mem_type_t type, uvm_rm_mem_slab_t **slab_out)
+{
+    NV_STATUS status;
+    uvm_rm_mem_slab_t *slab;
+    uvm_rm_mem_t *rm_mem;
+    UvmGpuAllocInfo alloc_info = { 0 };
+    NvU64 gpu_va;
+
+    uvm_assert_mutex_locked(&gpu->rm_mem_pool.lock);
+
+    slab = uvm_kvmalloc_zero(sizeof(*slab));
+    if (!slab)
+        return NV_ERR_NO_MEMORY;
+
+    rm_mem = uvm_kvmalloc_zero(sizeof(*rm_mem));
+    if (!rm_mem) {
+        uvm_kvfree(slab);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    alloc_info.bUnprotected = NV_TRUE;
+    alloc_info.alignment = UVM_RM_MEM_SLAB_SIZE;
+
+    if (type == UVM_RM_MEM_TYPE_SYS)
+        status = uvm_rm_locked_call(nvUvmInterfaceMemoryAllocSys(gpu->rm_address_space,
+                                                                 UVM_RM_MEM_SLAB_SIZE,
+                                                                 &gpu_va,
+                                                                 &alloc_info));
+    else
+        status = uvm_rm_locked_call(nvUvmInterfaceMemoryAllocFB(gpu->rm_address_space,
+                                                                UVM_RM_MEM_SLAB_SIZE,
+                                                                &gpu_va,
+                                                                &alloc_info));
+
+    if (status != NV_OK) {
+        UVM_ERR_PRINT("nvUvmInterfaceMemoryAlloc%s() failed for slab: %s, GPU %s\n",
+                      type == UVM_RM_MEM_TYPE_SYS ? "Sys" : "FB",
+                      nvstatusToString(status),
+                      uvm_gpu_name(gpu));
+        uvm_kvfree(rm_mem);
+        uvm_kvfree(slab);
+        return status;
+    }
+
+    rm_mem->gpu_owner = gpu;
+    rm_mem->type = type;
+    rm_mem->size = UVM_RM_MEM_SLAB_SIZE;
+    rm_mem_set_gpu_va(rm_mem, gpu, gpu_va);
+
+    slab->rm_mem = rm_mem;
+    list_add(&slab->list_node, &gpu->rm_mem_pool.slabs[type]);
+
+    *slab_out = slab;
+    return NV_OK;
+}
+
+static NV_STATUS rm_mem_suballoc(uvm_gpu_t *gpu,
+                                 uvm_rm_mem_type_t type,
+                                 NvLength size,
+                                 NvU64 gpu_alignment,
+                                 uvm_rm_mem_t **rm_mem_out)
+{
+    NV_STATUS status = NV_OK;
+    uvm_rm_mem_pool_t *pool = &gpu->rm_mem_pool;
+    uvm_rm_mem_slab_t *slab;
+    uvm_rm_mem_t *rm_mem;
+    NvU32 num_chunks = rm_mem_suballoc_num_chunks(size, gpu_alignment);
+    NvU32 first = UVM_RM_MEM_SLAB_CHUNKS;
+
+    rm_mem = uvm_kvmalloc_zero(sizeof(*rm_mem));
+    if (rm_mem == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    uvm_mutex_lock(&pool->lock);
+
+    list_for_each_entry(slab, &pool->slabs[type], list_node) {
+        first = rm_mem_slab_find_run(slab, num_chunks);
+        if (first < UVM_RM_MEM_SLAB_CHUNKS)
+            break;
+    }
+
+    if (first == UVM_RM_MEM_SLAB_CHUNKS) {
+        status = rm_mem_slab_create(gpu, type, &slab);
+        if (status != NV_OK)
+            goto out;
+
+        first = 0;
+    }
+
+    bitmap_set(slab->used_chunks, first, num_chunks);
+    slab->num_allocs++;
+
+    rm_mem->gpu_owner = gpu;
+    rm_mem->type = type;
+    rm_mem->size = size;
+    rm_mem->slab = slab;
+    rm_mem->slab_offset = (NvU64)first * UVM_RM_MEM_SLAB_CHUNK_SIZE;
+    rm_mem->slab_num_chunks = num_chunks;
+    rm_mem_set_gpu_va(rm_mem, gpu, uvm_rm_mem_get_gpu_uvm_va(slab->rm_mem, gpu) + rm_mem->slab_offset);
+
+    *rm_mem_out = rm_mem;
+
+out:
+    uvm_mutex_unlock(&pool->lock);
+
+    if (status != NV_OK)
+        uvm_kvfree(rm_mem);
+
+    return status;
+}
+
+static NV_STATUS rm_mem_suballoc_map_cpu(uvm_rm_mem_t *rm_mem)
+{
+    NV_STATUS status;
+    uvm_rm_mem_slab_t *slab = rm_mem->slab;
+    uvm_rm_mem_pool_t *pool = &rm_mem->gpu_owner->rm_mem_pool;
+
+    // The slab stays mapped on the CPU until it is freed
+    uvm_mutex_lock(&pool->lock);
+    status = uvm_rm_mem_map_cpu(slab->rm_mem);
+    if (status == NV_OK)
+        rm_mem_set_cpu_va(rm_mem, (char *)uvm_rm_mem_get_cpu_va(slab->rm_mem) + rm_mem->slab_offset);
+    uvm_mutex_unlock(&pool->lock);
+
+    return status;
+}
+
+static NV_STATUS rm_mem_suballoc_map_gpu(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu)
+{
+    NV_STATUS status = NV_OK;
+    uvm_rm_mem_slab_t *slab = rm_mem->slab;
+    uvm_rm_mem_pool_t *pool = &rm_mem->gpu_owner->rm_mem_pool;
+    NvU32 *map_count = &slab->gpu_map_count[uvm_global_id_value(gpu->global_id)];
+
+    UVM_ASSERT(gpu != rm_mem->gpu_owner);
+    UVM_ASSERT(!uvm_gpu_uses_proxy_channel_pool(gpu));
+
+    uvm_mutex_lock(&pool->lock);
+
+    if (*map_count == 0)
+        status = uvm_rm_mem_map_gpu(slab->rm_mem, gpu, UVM_RM_MEM_SLAB_SIZE);
+
+    if (status == NV_OK) {
+        (*map_count)++;
+        rm_mem_set_gpu_va(rm_mem, gpu, uvm_rm_mem_get_gpu_uvm_va(slab->rm_mem, gpu) + rm_mem->slab_offset);
+    }
+
+    uvm_mutex_unlock(&pool->lock);
+
+    return status;
+}
+
+static void rm_mem_suballoc_unmap_gpu(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu)
+{
+    uvm_rm_mem_slab_t *slab = rm_mem->slab;
+    uvm_rm_mem_pool_t *pool = &rm_mem->gpu_owner->rm_mem_pool;
+    NvU32 *map_count = &slab->gpu_map_count[uvm_global_id_value(gpu->global_id)];
+
+    UVM_ASSERT(gpu != rm_mem->gpu_owner);
+
+    uvm_mutex_lock(&pool->lock);
+
+    UVM_ASSERT(*map_count > 0);
+    if (--(*map_count) == 0)
+        uvm_rm_mem_unmap_gpu(slab->rm_mem, gpu);
+
+    uvm_mutex_unlock(&pool->lock);
+
+    rm_mem_clear_gpu_va(rm_mem, gpu);
+}
+
+static void rm_mem_suballoc_free(uvm_rm_mem_t *rm_mem)
+{
+    uvm_global_gpu_id_t gpu_id;
+    uvm_gpu_t *gpu_owner = rm_mem->gpu_owner;
+    uvm_rm_mem_slab_t *slab = rm_mem->slab;
+    uvm_rm_mem_pool_t *pool = &gpu_owner->rm_mem_pool;
+
+    uvm_rm_mem_unmap_cpu(rm_mem);
+
+    for_each_global_gpu_id_in_mask(gpu_id, &rm_mem->mapped_on) {
+        if (!uvm_global_id_equal(gpu_id, gpu_owner->global_id))
+            rm_mem_suballoc_unmap_gpu(rm_mem, uvm_gpu_get(gpu_id));
+    }
+
+    rm_mem_clear_gpu_va(rm_mem, gpu_owner);
+
+    uvm_mutex_lock(&pool->lock);
+
+    bitmap_clear(slab->used_chunks,
+                 rm_mem->slab_offset / UVM_RM_MEM_SLAB_CHUNK_SIZE,
+                 rm_mem->slab_num_chunks);
+
+    UVM_ASSERT(slab->num_allocs > 0);
+    if (--slab->num_allocs == 0)
+        rm_mem_slab_destroy(slab);
+
+    uvm_mutex_unlock(&pool->lock);
+
+    uvm_kvfree(rm_mem);
+}
 
 NV_STATUS uvm_rm_mem_alloc(uvm_gpu_t *gpu,
                            uvm_rm_mem_type_t type,
@@ -204,6 +501,9 @@ NV_STATUS uvm_rm_mem_alloc(uvm_gpu_t *gpu,
     UVM_ASSERT((type == UVM_RM_MEM_TYPE_SYS) || (type == UVM_RM_MEM_TYPE_GPU));
     UVM_ASSERT(size != 0);
 
+    if (rm_mem_can_suballoc(gpu, size, gpu_alignment))
+        return rm_mem_suballoc(gpu, type, size, gpu_alignment, rm_mem_out);
+
     rm_mem = uvm_kvmalloc_zero(sizeof(*rm_mem));
     if (rm_mem == NULL)
         return NV_ERR_NO_MEMORY;
@@ -255,6 +555,9 @@ NV_STATUS uvm_rm_mem_map_cpu(uvm_rm_mem_t *rm_mem)
     if (uvm_rm_mem_mapped_on_cpu(rm_mem))
         return NV_OK;
 
+    if (rm_mem->slab)
+        return rm_mem_suballoc_map_cpu(rm_mem);
+
     gpu = rm_mem->gpu_owner;
     gpu_va = uvm_rm_mem_get_gpu_uvm_va(rm_mem, gpu);
     if (uvm_conf_computing_mode_enabled(gpu))
@@ -282,6 +585,12 @@ void uvm_rm_mem_unmap_cpu(uvm_rm_mem_t *rm_mem)
     if (!uvm_rm_mem_mapped_on_cpu(rm_mem))
         return;
 
+    // The slab's CPU mapping is torn down with the slab
+    if (rm_mem->slab) {
+        rm_mem_clear_cpu_va(rm_mem);
+        return;
+    }
+
     uvm_rm_locked_call_void(nvUvmInterfaceMemoryCpuUnMap(rm_mem->gpu_owner->rm_address_space,
                                                          uvm_rm_mem_get_cpu_va(rm_mem)));
 
@@ -304,6 +613,9 @@ NV_STATUS uvm_rm_mem_map_gpu(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu, NvU64 gpu_ali
     // Peer mappings are not supported yet
     UVM_ASSERT(rm_mem->type == UVM_RM_MEM_TYPE_SYS);
 
+    if (rm_mem->slab)
+        return rm_mem_suballoc_map_gpu(rm_mem, gpu);
+
     gpu_owner = rm_mem->gpu_owner;
     gpu_owner_va = uvm_rm_mem_get_gpu_uvm_va(rm_mem, gpu_owner);
 
@@ -352,6 +664,12 @@ void uvm_rm_mem_unmap_gpu(uvm_rm_mem_t *rm_mem, uvm_gpu_t *gpu)
     if (gpu == rm_mem->gpu_owner)
         return;
 
+    if (rm_mem->slab) {
+        if (uvm_rm_mem_mapped_on_gpu(rm_mem, gpu))
+            rm_mem_suballoc_unmap_gpu(rm_mem, gpu);
+        return;
+    }
+
     rm_mem_unmap_gpu(rm_mem, gpu);
 }
 
@@ -370,6 +688,11 @@ void uvm_rm_mem_free(uvm_rm_mem_t *rm_mem)
         return;
     }
 
+    if (rm_mem->slab) {
+        rm_mem_suballoc_free(rm_mem);
+        return;
+    }
+
     uvm_rm_mem_unmap_cpu(rm_mem);
 
     // Don't use for_each_global_gpu_in_mask() as the owning GPU might be being
@@ -28,13 +28,28 @@
 #include "uvm_processors.h"
 #include "uvm_test_ioctl.h"
 #include "uvm_hal_types.h"
+#include "uvm_lock.h"
 
 typedef enum
 {
     UVM_RM_MEM_TYPE_GPU,
     UVM_RM_MEM_TYPE_SYS,
+    UVM_RM_MEM_TYPE_COUNT,
 } uvm_rm_mem_type_t;
 
+typedef struct uvm_rm_mem_slab_struct uvm_rm_mem_slab_t;
+
+// Per-GPU pool of slabs that small allocations are sub-allocated from, so that
+// they don't each need their own RM allocation and mappings.
+typedef struct
+{
+    uvm_mutex_t lock;
+
+    // Slabs with at least one live sub-allocation, per memory type. A slab is
+    // freed as soon as its last sub-allocation is.
+    struct list_head slabs[UVM_RM_MEM_TYPE_COUNT];
+} uvm_rm_mem_pool_t;
+
 // Abstraction for memory allocations done through the UVM-RM interface
 struct uvm_rm_mem_struct
 {
@@ -62,8 +77,20 @@ struct uvm_rm_mem_struct
 
     // Size of the allocation
     NvLength size;
+
+    // Slab this allocation was carved out of, or NULL if it owns its RM
+    // allocation. Sub-allocations share the mappings of the slab: their VAs
+    // are the slab's VAs plus slab_offset.
+    uvm_rm_mem_slab_t *slab;
+    NvU64 slab_offset;
+    NvU32 slab_num_chunks;
 };
 
+// Initialize/deinitialize the GPU's sub-allocation pool. All sub-allocations
+// must have been freed before the pool is deinitialized.
+void uvm_rm_mem_pool_init(uvm_gpu_t *gpu);
+void uvm_rm_mem_pool_deinit(uvm_gpu_t *gpu);
+
 // Allocate memory of the given type and size in the GPU's UVM internal address
 // space, and (in SR-IOV heavy) map it on the proxy address space as well.
 //
@@ -75,6 +102,10 @@ struct uvm_rm_mem_struct
 // Alignment affects only the GPU VA mapping. If gpu_alignment is 0, then 4K
 // alignment is enforced.
 //
+// Small allocations are sub-allocated from a per-GPU slab instead of getting
+// their own RM allocation, unless Confidential Computing or SR-IOV heavy is
+// enabled on the GPU.
+//
 // Locking:
 //  - Internally acquires:
 //    - RM API lock
@@ -190,4 +190,6 @@ NV_STATUS uvm_test_rb_tree_random(UVM_TEST_RB_TREE_RANDOM_PARAMS *params, struct
 NV_STATUS uvm_test_sec2_sanity(UVM_TEST_SEC2_SANITY_PARAMS *params, struct file *filp);
 NV_STATUS uvm_test_sec2_cpu_gpu_roundtrip(UVM_TEST_SEC2_CPU_GPU_ROUNDTRIP_PARAMS *params, struct file *filp);
 NV_STATUS uvm_test_cpu_chunk_api(UVM_TEST_CPU_CHUNK_API_PARAMS *params, struct file *filp);
+NV_STATUS uvm_test_perf_benchmark(UVM_TEST_PERF_BENCHMARK_PARAMS *params, struct file *filp);
+NV_STATUS uvm_test_ce_usage(UVM_TEST_CE_USAGE_PARAMS *params, struct file *filp);
 #endif
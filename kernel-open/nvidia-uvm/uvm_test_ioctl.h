@@ -416,7 +416,18 @@ typedef struct
 typedef enum
 {
     // Get the value of valid user allocations as key
-    UVM_TEST_CHUNK_SIZE_GET_USER_SIZE
+    UVM_TEST_CHUNK_SIZE_GET_USER_SIZE,
+
+    // Allocation telemetry counters, only available when the
+    // uvm_perf_pmm_stats module parameter is set
+    UVM_TEST_PMM_QUERY_ALLOCS,
+    UVM_TEST_PMM_QUERY_ROOT_CHUNK_SPLITS,
+    UVM_TEST_PMM_QUERY_ROOT_CHUNK_MERGES,
+    UVM_TEST_PMM_QUERY_ROOT_CHUNKS_EVICTED_FOR_ALLOC,
+    UVM_TEST_PMM_QUERY_ROOT_CHUNKS_EVICTED_FOR_PMA,
+
+    // Free 2M pages in PMA
+    UVM_TEST_PMM_QUERY_PMA_FREE_2M_PAGES,
 } uvm_test_pmm_query_key_t;
 
 typedef struct
@@ -1434,6 +1445,105 @@ typedef struct
 {
     NV_STATUS rmStatus;                                  // Out
 } UVM_TEST_CPU_CHUNK_API_PARAMS;
+
+// Measure the cost of common driver operations on the given GPU, which has to
+// be registered in the VA space. All results are average values, except for
+// the minimum push round-trip.
+//
+// If fault_length is not 0, [fault_base, fault_base + fault_length) has to be
+// covered by managed allocations and the GPU has to have a GPU VA space in the
+// VA space. The pages of the range are then made resident and mapped on the
+// GPU one at a time in each UVM_TEST_PERF_BENCHMARK_FAULT_* order, as done when
+// servicing replayable faults, and the range is moved back to the CPU between
+// patterns. The hardware fault buffer is not involved.
+//
+// Copy results are left 0 when Confidential Computing is enabled.
+//
+// Error returns:
+// NV_ERR_INVALID_DEVICE
+//  - gpu_uuid is not registered in the VA space, or has no GPU VA space while
+//    fault_length is not 0
+// NV_ERR_INVALID_ADDRESS
+//  - the fault range is not aligned or not fully covered by managed ranges
+#define UVM_TEST_PERF_BENCHMARK                          UVM_TEST_IOCTL_BASE(101)
+
+// Copy sizes are 4K, 64K and 2M
+#define UVM_TEST_PERF_BENCHMARK_COPY_SIZES               3
+
+#define UVM_TEST_PERF_BENCHMARK_COPY_CPU_TO_GPU          0
+#define UVM_TEST_PERF_BENCHMARK_COPY_GPU_TO_CPU          1
+#define UVM_TEST_PERF_BENCHMARK_COPY_GPU_INTERNAL        2
+#define UVM_TEST_PERF_BENCHMARK_COPY_TYPES               3
+
+#define UVM_TEST_PERF_BENCHMARK_FAULT_SEQUENTIAL         0
+// Every 16th page from the first one, then from the second one and so on
+#define UVM_TEST_PERF_BENCHMARK_FAULT_STRIDED            1
+// Steps of a random stride coprime with the page count, wrapping around
+#define UVM_TEST_PERF_BENCHMARK_FAULT_RANDOM             2
+#define UVM_TEST_PERF_BENCHMARK_FAULT_PATTERNS           3
+
+// PMM chunk sizes are 4K and 2M
+#define UVM_TEST_PERF_BENCHMARK_PMM_SIZES                2
+
+typedef struct
+{
+    NvProcessorUuid gpu_uuid;                                                           // In
+
+    // Number of samples per measurement. 0 selects a default.
+    NvU32           iterations;                                                         // In
+    NvU32           seed;                                                               // In
+    NvU64           fault_base                                      NV_ALIGN_BYTES(8);  // In
+    NvU64           fault_length                                    NV_ALIGN_BYTES(8);  // In
+
+    // Time from beginning an empty push to its completion being observed on
+    // the CPU
+    NvU64           push_round_trip_ns                              NV_ALIGN_BYTES(8);  // Out
+    NvU64           push_round_trip_min_ns                          NV_ALIGN_BYTES(8);  // Out
+
+    // CE copy bandwidth, with one copy per push
+    NvU64           copy_sizes[UVM_TEST_PERF_BENCHMARK_COPY_SIZES]  NV_ALIGN_BYTES(8);  // Out
+    NvU64           copy_mbps[UVM_TEST_PERF_BENCHMARK_COPY_TYPES][UVM_TEST_PERF_BENCHMARK_COPY_SIZES]
+                                                                    NV_ALIGN_BYTES(8);  // Out
+
+    // Pages made resident and mapped per second
+    NvU64           fault_pages_per_sec[UVM_TEST_PERF_BENCHMARK_FAULT_PATTERNS]
+                                                                    NV_ALIGN_BYTES(8);  // Out
+
+    // Kernel chunk allocation and free pairs per second
+    NvU64           pmm_chunk_sizes[UVM_TEST_PERF_BENCHMARK_PMM_SIZES]
+                                                                    NV_ALIGN_BYTES(8);  // Out
+    NvU64           pmm_alloc_free_per_sec[UVM_TEST_PERF_BENCHMARK_PMM_SIZES]
+                                                                    NV_ALIGN_BYTES(8);  // Out
+
+    // Time a full TLB invalidate adds to a push round-trip
+    NvU64           tlb_invalidate_ns                               NV_ALIGN_BYTES(8);  // Out
+
+    NV_STATUS       rmStatus;                                                           // Out
+} UVM_TEST_PERF_BENCHMARK_PARAMS;
+
+// Report CE usage by UVM channels on the given GPU, which has to be registered
+// in the VA space. Counters are indexed by CE and aggregate all the CE channel
+// pools bound to that CE. Completed counters are totals since the GPU was
+// registered and only advance as channel progress is observed by the driver,
+// so sampling them twice gives the CE throughput over the interval.
+//
+// Error returns:
+// NV_ERR_INVALID_DEVICE
+//  - gpu_uuid is not registered in the VA space
+#define UVM_TEST_CE_USAGE                                UVM_TEST_IOCTL_BASE(102)
+typedef struct
+{
+    NvProcessorUuid gpu_uuid;                                                           // In
+
+    // Bit i is set if UVM has channels on CE i
+    NvU32           ce_mask;                                                            // Out
+    NvU64           completed_pushes[UVM_COPY_ENGINE_COUNT_MAX]     NV_ALIGN_BYTES(8);  // Out
+    NvU64           completed_copy_bytes[UVM_COPY_ENGINE_COUNT_MAX] NV_ALIGN_BYTES(8);  // Out
+    NvU64           outstanding_copy_bytes[UVM_COPY_ENGINE_COUNT_MAX]
+                                                                    NV_ALIGN_BYTES(8);  // Out
+
+    NV_STATUS       rmStatus;                                                           // Out
+} UVM_TEST_CE_USAGE_PARAMS;
 #ifdef __cplusplus
 }
 #endif
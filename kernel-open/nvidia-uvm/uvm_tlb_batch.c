@@ -86,7 +86,7 @@ static void tlb_batch_flush_invalidate_all(uvm_tlb_batch_t *batch, uvm_push_t *p
     gpu->parent->host_hal->tlb_invalidate_all(push, uvm_page_tree_pdb(tree)->addr, page_table_depth, batch->membar);
 }
 
-static bool tlb_batch_should_invalidate_all(uvm_tlb_batch_t *batch)
+static bool tlb_batch_should_invalidate_all(const uvm_tlb_batch_t *batch)
 {
     if (!batch->tree->gpu->parent->tlb_batch.va_invalidate_supported)
         return true;
@@ -113,12 +113,47 @@ void uvm_tlb_batch_end(uvm_tlb_batch_t *batch, uvm_push_t *push, uvm_membar_t tl
         tlb_batch_flush_invalidate_per_va(batch, push);
 }
 
+// Extend a queued up range with the same page sizes which overlaps or is
+// adjacent to [start, start + size), if any. Returns whether a range was
+// extended.
+static bool tlb_batch_coalesce(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, NvU32 page_sizes)
+{
+    NvU64 end = start + size;
+    NvU32 i;
+
+    if (tlb_batch_should_invalidate_all(batch))
+        return false;
+
+    for (i = 0; i < batch->count; ++i) {
+        uvm_tlb_batch_range_t *entry = &batch->ranges[i];
+        NvU64 entry_end = entry->start + entry->size;
+
+        if (entry->page_sizes != page_sizes || start > entry_end || end < entry->start)
+            continue;
+
+        // Per-page invalidates are accounted for conservatively, overlapping
+        // pages are counted twice.
+        if (!batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
+            batch->total_pages += uvm_div_pow2_64(size, smallest_page_size(page_sizes));
+
+        entry->start = min(entry->start, start);
+        entry->size = max(entry_end, end) - entry->start;
+
+        return true;
+    }
+
+    return false;
+}
+
 void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, NvU32 page_sizes, uvm_membar_t tlb_membar)
 {
     uvm_tlb_batch_range_t *new_entry;
 
     batch->membar = uvm_membar_max(tlb_membar, batch->membar);
 
+    if (tlb_batch_coalesce(batch, start, size, page_sizes))
+        return;
+
     ++batch->count;
 
     if (batch->tree->gpu->parent->tlb_batch.va_range_invalidate_supported)
@@ -136,3 +171,26 @@ void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, N
     new_entry->size = size;
     new_entry->page_sizes = page_sizes;
 }
+
+void uvm_tlb_batch_merge(uvm_tlb_batch_t *batch, const uvm_tlb_batch_t *other)
+{
+    NvU32 i;
+
+    UVM_ASSERT(batch->tree == other->tree);
+
+    if (other->count == 0)
+        return;
+
+    if (tlb_batch_should_invalidate_all(other)) {
+        // The ranges of other weren't kept, so this batch has to invalidate
+        // all too.
+        batch->count = max(batch->count, (NvU32)UVM_TLB_BATCH_MAX_ENTRIES + 1);
+        batch->biggest_page_size = max(batch->biggest_page_size, other->biggest_page_size);
+    }
+    else {
+        for (i = 0; i < other->count; ++i)
+            uvm_tlb_batch_invalidate(batch, other->ranges[i].start, other->ranges[i].size, other->ranges[i].page_sizes, UVM_MEMBAR_NONE);
+    }
+
+    batch->membar = uvm_membar_max(other->membar, batch->membar);
+}
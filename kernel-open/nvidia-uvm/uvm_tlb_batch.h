@@ -74,6 +74,8 @@ void uvm_tlb_batch_begin(uvm_page_tree_t *tree, uvm_tlb_batch_t *batch);
 
 // Queue up an invalidate of the [start, start + size) range that will invalidate
 // all TLB cache entries for all page sizes included in the page sizes mask.
+// If the range overlaps or is adjacent to an already queued up range with the
+// same page sizes, that range is extended instead.
 // The smallest page size in the mask affects the density of the per VA TLB
 // invalidate (if one ends up being used) and the largest page size affects the
 // depth of the issued TLB invalidates.
@@ -83,6 +85,14 @@ void uvm_tlb_batch_begin(uvm_page_tree_t *tree, uvm_tlb_batch_t *batch);
 // accesses using the old translations are ordered to the scope of the membar.
 void uvm_tlb_batch_invalidate(uvm_tlb_batch_t *batch, NvU64 start, NvU64 size, NvU32 page_sizes, uvm_membar_t tlb_membar);
 
+// Queue up all the invalidates of other into batch. Both batches must have
+// been begun on the same page tree. Ranges which overlap or are adjacent are
+// coalesced, and batch falls back to invalidating all if other already did.
+//
+// This allows a caller to collect the invalidates of several independent
+// operations and to push them once.
+void uvm_tlb_batch_merge(uvm_tlb_batch_t *batch, const uvm_tlb_batch_t *other);
+
 // End a TLB invalidate batch
 //
 // This will push the required TLB invalidate to invalidate all the queued up
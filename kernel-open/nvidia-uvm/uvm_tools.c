@@ -191,6 +191,41 @@ static uvm_spinlock_t g_tools_channel_list_lock;
 static LIST_HEAD(g_tools_channel_list);
 static nv_kthread_q_t g_tools_queue;
 
+// Must be a power of 2
+#define TOOLS_COPY_CACHE_ENTRIES 16
+
+// Bytes and copies migrated from src to dst, accumulated on one CPU. An entry
+// with no copies is free.
+typedef struct
+{
+    NvU32 src;
+    NvU32 dst;
+    NvU64 bytes;
+    NvU64 copies;
+} tools_copy_cache_entry_t;
+
+// Small direct-mapped cache of processor pairs, one per CPU. Entries are
+// folded into g_tools_copy_counters when they get evicted by another pair, or
+// when the counters are read.
+typedef struct
+{
+    uvm_spinlock_t lock;
+    tools_copy_cache_entry_t entries[TOOLS_COPY_CACHE_ENTRIES];
+} ____cacheline_aligned_in_smp tools_copy_cache_t;
+
+typedef struct
+{
+    atomic64_t bytes;
+    atomic64_t copies;
+} tools_copy_counter_t;
+
+static struct
+{
+    tools_copy_cache_t *cpus;
+    NvU32 count;
+} g_tools_copy_caches;
+static tools_copy_counter_t g_tools_copy_counters[UVM_ID_MAX_PROCESSORS][UVM_ID_MAX_PROCESSORS];
+
 static NV_STATUS tools_update_status(uvm_va_space_t *va_space);
 
 static uvm_tools_event_tracker_t *tools_event_tracker(uvm_tools_fd filp)
@@ -559,15 +594,13 @@ static bool tools_is_event_enabled(uvm_va_space_t *va_space, UvmEventType event)
     return !list_empty(va_space->tools.queues + event);
 }
 
+// Called on every replay and access counter notification, so it doesn't take
+// g_tools_va_space_list_lock. Racing with a queue being (un)subscribed only
+// means that an event around the subscription change is dropped or generated
+// for nobody, which uvm_tools_broadcast_event() handles under the lock.
 static bool tools_is_event_enabled_in_any_va_space(UvmEventType event)
 {
-    bool ret = false;
-
-    uvm_down_read(&g_tools_va_space_list_lock);
-    ret = g_tools_enabled_event_count[event] != 0;
-    uvm_up_read(&g_tools_va_space_list_lock);
-
-    return ret;
+    return UVM_READ_ONCE(g_tools_enabled_event_count[event]) != 0;
 }
 
 static bool tools_are_enabled(uvm_va_space_t *va_space)
@@ -1370,6 +1403,38 @@ void uvm_tools_record_thrashing(uvm_va_space_t *va_space,
     uvm_up_read(&va_space->tools.lock);
 }
 
+void uvm_tools_record_read_duplication_policy(uvm_va_space_t *va_space,
+                                              NvU64 address,
+                                              NvU64 size,
+                                              bool enabled,
+                                              const uvm_processor_mask_t *processors)
+{
+    UVM_ASSERT(PAGE_ALIGNED(address));
+    UVM_ASSERT(size > 0);
+
+    uvm_assert_rwsem_locked(&va_space->lock);
+
+    if (!va_space->tools.enabled)
+        return;
+
+    uvm_down_read(&va_space->tools.lock);
+    if (tools_is_event_enabled(va_space, UvmEventTypeReadDuplicationPolicy)) {
+        UvmEventEntry entry;
+        UvmEventReadDuplicationPolicyInfo *info = &entry.eventData.readDuplicationPolicy;
+        memset(&entry, 0, sizeof(entry));
+
+        info->eventType = UvmEventTypeReadDuplicationPolicy;
+        info->enabled   = enabled;
+        info->address   = address;
+        info->size      = size;
+        info->timeStamp = NV_GETTIME();
+        bitmap_copy((long unsigned *)&info->processors, processors->bitmap, UVM_ID_MAX_PROCESSORS);
+
+        uvm_tools_record_event(va_space, &entry);
+    }
+    uvm_up_read(&va_space->tools.lock);
+}
+
 void uvm_tools_record_throttling_start(uvm_va_space_t *va_space, NvU64 address, uvm_processor_id_t processor)
 {
     UVM_ASSERT(address);
@@ -1886,6 +1951,193 @@ NV_STATUS uvm_api_tools_get_processor_uuid_table(UVM_TOOLS_GET_PROCESSOR_UUID_TA
     return NV_OK;
 }
 
+static void tools_copy_cache_entry_flush(tools_copy_cache_entry_t *entry)
+{
+    tools_copy_counter_t *counter = &g_tools_copy_counters[entry->src][entry->dst];
+
+    atomic64_add(entry->bytes, &counter->bytes);
+    atomic64_add(entry->copies, &counter->copies);
+    entry->bytes = 0;
+    entry->copies = 0;
+}
+
+void uvm_tools_record_copy(uvm_processor_id_t src, uvm_processor_id_t dst, NvU64 bytes)
+{
+    tools_copy_cache_t *cache;
+    tools_copy_cache_entry_t *entry;
+    NvU32 src_value = uvm_id_value(src);
+    NvU32 dst_value = uvm_id_value(dst);
+
+    if (!g_tools_copy_caches.cpus || bytes == 0)
+        return;
+
+    cache = &g_tools_copy_caches.cpus[current_cpu()->id % g_tools_copy_caches.count];
+    entry = &cache->entries[(src_value ^ (dst_value * 5)) & (TOOLS_COPY_CACHE_ENTRIES - 1)];
+
+    uvm_spin_lock(&cache->lock);
+
+    if (entry->copies != 0 && (entry->src != src_value || entry->dst != dst_value))
+        tools_copy_cache_entry_flush(entry);
+
+    entry->src = src_value;
+    entry->dst = dst_value;
+    entry->bytes += bytes;
+    entry->copies++;
+
+    uvm_spin_unlock(&cache->lock);
+}
+
+static void tools_copy_caches_flush(void)
+{
+    NvU32 cpu;
+    NvU32 i;
+
+    for (cpu = 0; cpu < g_tools_copy_caches.count; cpu++) {
+        tools_copy_cache_t *cache = &g_tools_copy_caches.cpus[cpu];
+
+        uvm_spin_lock(&cache->lock);
+        for (i = 0; i < TOOLS_COPY_CACHE_ENTRIES; i++) {
+            if (cache->entries[i].copies != 0)
+                tools_copy_cache_entry_flush(&cache->entries[i]);
+        }
+        uvm_spin_unlock(&cache->lock);
+    }
+}
+
+static NvU32 tools_link_type(uvm_gpu_link_type_t link)
+{
+    switch (link) {
+        case UVM_GPU_LINK_PCIE:
+            return UVM_TOOLS_LINK_TYPE_PCIE;
+        case UVM_GPU_LINK_NVLINK_1:
+            return UVM_TOOLS_LINK_TYPE_NVLINK_1;
+        case UVM_GPU_LINK_NVLINK_2:
+            return UVM_TOOLS_LINK_TYPE_NVLINK_2;
+        case UVM_GPU_LINK_NVLINK_3:
+            return UVM_TOOLS_LINK_TYPE_NVLINK_3;
+        case UVM_GPU_LINK_NVLINK_4:
+            return UVM_TOOLS_LINK_TYPE_NVLINK_4;
+        case UVM_GPU_LINK_C2C:
+            return UVM_TOOLS_LINK_TYPE_C2C;
+        default:
+            return UVM_TOOLS_LINK_TYPE_NONE;
+    }
+}
+
+static NvU32 tools_copy_link_type(uvm_gpu_t *src_gpu, uvm_gpu_t *dst_gpu)
+{
+    if (!src_gpu)
+        return tools_link_type(dst_gpu->parent->system_bus.link);
+    if (!dst_gpu)
+        return tools_link_type(src_gpu->parent->system_bus.link);
+
+    return tools_link_type(uvm_gpu_peer_caps(src_gpu, dst_gpu)->link_type);
+}
+
+NV_STATUS uvm_api_tools_get_migration_counters(UVM_TOOLS_GET_MIGRATION_COUNTERS_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_processor_mask_t processors;
+    uvm_processor_id_t src_id;
+    uvm_processor_id_t dst_id;
+
+    params->numEntries = 0;
+
+    tools_copy_caches_flush();
+
+    uvm_va_space_down_read(va_space);
+
+    uvm_processor_mask_copy(&processors, &va_space->registered_gpus);
+    uvm_processor_mask_set(&processors, UVM_ID_CPU);
+
+    for_each_id_in_mask(src_id, &processors) {
+        for_each_id_in_mask(dst_id, &processors) {
+            tools_copy_counter_t *counter = &g_tools_copy_counters[uvm_id_value(src_id)][uvm_id_value(dst_id)];
+            UVM_TOOLS_MIGRATION_COUNTER_ENTRY *entry;
+            uvm_gpu_t *src_gpu = NULL;
+            uvm_gpu_t *dst_gpu = NULL;
+            NvU64 copies = atomic64_read(&counter->copies);
+
+            if (copies == 0)
+                continue;
+
+            if (params->numEntries == UVM_TOOLS_MIGRATION_COUNTERS_MAX_ENTRIES)
+                goto done;
+
+            entry = &params->entries[params->numEntries++];
+
+            if (UVM_ID_IS_CPU(src_id)) {
+                uvm_processor_uuid_copy(&entry->srcUuid, &NV_PROCESSOR_UUID_CPU_DEFAULT);
+            }
+            else {
+                src_gpu = uvm_va_space_get_gpu(va_space, src_id);
+                uvm_processor_uuid_copy(&entry->srcUuid, uvm_gpu_uuid(src_gpu));
+            }
+
+            if (UVM_ID_IS_CPU(dst_id)) {
+                uvm_processor_uuid_copy(&entry->dstUuid, &NV_PROCESSOR_UUID_CPU_DEFAULT);
+            }
+            else {
+                dst_gpu = uvm_va_space_get_gpu(va_space, dst_id);
+                uvm_processor_uuid_copy(&entry->dstUuid, uvm_gpu_uuid(dst_gpu));
+            }
+
+            entry->linkType = tools_copy_link_type(src_gpu, dst_gpu);
+            entry->bytes = atomic64_read(&counter->bytes);
+            entry->copies = copies;
+        }
+    }
+
+done:
+    uvm_va_space_up_read(va_space);
+
+    return NV_OK;
+}
+
+static void tools_copy_push_latency(UVM_TOOLS_PUSH_LATENCY_STATS *dst, uvm_push_latency_stats_t *src)
+{
+    NvU32 i;
+
+    dst->pushes = atomic64_read(&src->pushes);
+    dst->queueNs = atomic64_read(&src->queue_ns);
+    dst->execNs = atomic64_read(&src->exec_ns);
+
+    for (i = 0; i < UVM_PUSH_LATENCY_BUCKETS; i++) {
+        dst->queueHistogram[i] = atomic64_read(&src->queue_histogram[i]);
+        dst->execHistogram[i] = atomic64_read(&src->exec_histogram[i]);
+    }
+}
+
+NV_STATUS uvm_api_tools_get_push_latency(UVM_TOOLS_GET_PUSH_LATENCY_PARAMS *params, fdesc filp)
+{
+    uvm_va_space_t *va_space = uvm_va_space_get(filp);
+    uvm_gpu_t *gpu;
+    NvU32 type;
+
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_CPU_TO_GPU != UVM_CHANNEL_TYPE_CPU_TO_GPU);
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_GPU_TO_CPU != UVM_CHANNEL_TYPE_GPU_TO_CPU);
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_GPU_INTERNAL != UVM_CHANNEL_TYPE_GPU_INTERNAL);
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_MEMOPS != UVM_CHANNEL_TYPE_MEMOPS);
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_GPU_TO_GPU != UVM_CHANNEL_TYPE_GPU_TO_GPU);
+    BUILD_BUG_ON(UVM_TOOLS_CHANNEL_TYPE_COUNT != UVM_CHANNEL_TYPE_CE_COUNT);
+    BUILD_BUG_ON(UVM_TOOLS_PUSH_LATENCY_BUCKETS != UVM_PUSH_LATENCY_BUCKETS);
+
+    uvm_va_space_down_read(va_space);
+
+    gpu = uvm_va_space_get_gpu_by_uuid(va_space, &params->gpuUuid);
+    if (!gpu) {
+        uvm_va_space_up_read(va_space);
+        return NV_ERR_INVALID_DEVICE;
+    }
+
+    for (type = 0; type < UVM_CHANNEL_TYPE_CE_COUNT; type++)
+        tools_copy_push_latency(&params->stats[type], &gpu->channel_manager->push_latency[type]);
+
+    uvm_va_space_up_read(va_space);
+
+    return NV_OK;
+}
+
 void uvm_tools_flush_events(void)
 {
     tools_schedule_completed_events();
@@ -1916,6 +2168,7 @@ int uvm_tools_init(dev_t uvm_base_dev)
     dev_t uvm_tools_dev = MKDEV(MAJOR(uvm_base_dev), NVIDIA_UVM_TOOLS_MINOR_NUMBER);
     int ret = -ENOMEM; // This will be updated later if allocations succeed
     spec_file_open open;
+    NvU32 i;
 
     uvm_init_rwsem(&g_tools_va_space_list_lock, UVM_LOCK_ORDER_TOOLS_VA_SPACE_LIST);
 
@@ -1951,6 +2204,15 @@ int uvm_tools_init(dev_t uvm_base_dev)
 
     uvm_spin_lock_init(&g_tools_channel_list_lock, UVM_LOCK_ORDER_LEAF);
 
+    g_tools_copy_caches.cpus = uvm_kvmalloc_zero(sizeof(*g_tools_copy_caches.cpus) * present_processors);
+    if (!g_tools_copy_caches.cpus)
+        goto err_cache_destroy;
+
+    for (i = 0; i < present_processors; i++)
+        uvm_spin_lock_init(&g_tools_copy_caches.cpus[i].lock, UVM_LOCK_ORDER_LEAF);
+
+    g_tools_copy_caches.count = present_processors;
+
     ret = nv_kthread_q_init(&g_tools_queue, "UVM Tools Event Queue");
     if (ret < 0)
         goto err_cache_destroy;
@@ -1969,6 +2231,8 @@ err_stop_thread:
     nv_kthread_q_stop(&g_tools_queue);
 
 err_cache_destroy:
+    uvm_kvfree(g_tools_copy_caches.cpus);
+    g_tools_copy_caches.cpus = NULL;
     _uvm_tools_destroy_cache_all();
     return ret;
 }
@@ -1984,5 +2248,8 @@ void uvm_tools_exit(void)
 
     UVM_ASSERT(list_empty(&g_tools_va_space_list));
 
+    uvm_kvfree(g_tools_copy_caches.cpus);
+    g_tools_copy_caches.cpus = NULL;
+
     _uvm_tools_destroy_cache_all();
 }
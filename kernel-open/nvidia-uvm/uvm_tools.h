@@ -73,6 +73,14 @@ void uvm_tools_record_thrashing(uvm_va_space_t *va_space,
                                 size_t region_size,
                                 const uvm_processor_mask_t *processors);
 
+// Record that read duplication was automatically enabled (enabled == true) or
+// reverted on the VA range [address, address + size)
+void uvm_tools_record_read_duplication_policy(uvm_va_space_t *va_space,
+                                              NvU64 address,
+                                              NvU64 size,
+                                              bool enabled,
+                                              const uvm_processor_mask_t *processors);
+
 void uvm_tools_record_throttling_start(uvm_va_space_t *va_space, NvU64 address, uvm_processor_id_t processor);
 
 void uvm_tools_record_throttling_end(uvm_va_space_t *va_space, NvU64 address, uvm_processor_id_t processor);
@@ -120,4 +128,9 @@ void uvm_tools_test_hmm_split_invalidate(uvm_va_space_t *va_space);
 // schedules completed events and then waits from the to be dispatched
 void uvm_tools_flush_events(void);
 
+// Account one copy of the given number of bytes from src to dst in the
+// per processor-pair migration counters. Unlike the tools counters, these are
+// always enabled.
+void uvm_tools_record_copy(uvm_processor_id_t src, uvm_processor_id_t dst, NvU64 bytes);
+
 #endif // __UVM_TOOLS_H__
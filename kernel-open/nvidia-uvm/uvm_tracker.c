@@ -30,16 +30,50 @@
 #include "uvm_common.h"
 #include "uvm_nanos.h"
 
+// Size of the first dynamic entries array of a tracker. Trackers outgrowing
+// their static entry are common in the fault and migration paths, so arrays of
+// this size come from a dedicated cache. Larger arrays use uvm_kvmalloc.
+#define UVM_TRACKER_CACHED_ENTRIES 8
+
+static uvm_kmem_cache_t *g_uvm_tracker_entries_cache __read_mostly;
+
+NV_STATUS uvm_tracker_global_init(void)
+{
+    BUILD_BUG_ON(ARRAY_SIZE(((uvm_tracker_t *)0)->static_entries) >= UVM_TRACKER_CACHED_ENTRIES);
+
+    g_uvm_tracker_entries_cache = uvm_kmem_cache_create("uvm_tracker_entries",
+                                                        sizeof(uvm_tracker_entry_t) * UVM_TRACKER_CACHED_ENTRIES,
+                                                        NULL);
+    if (!g_uvm_tracker_entries_cache)
+        return NV_ERR_NO_MEMORY;
+
+    return NV_OK;
+}
+
+void uvm_tracker_global_exit(void)
+{
+    uvm_kmem_cache_destroy_safe(&g_uvm_tracker_entries_cache);
+}
+
 static bool tracker_is_using_static_entries(uvm_tracker_t *tracker)
 {
     return tracker->max_size == ARRAY_SIZE(tracker->static_entries);
 }
 
+static bool tracker_is_using_cached_entries(uvm_tracker_t *tracker)
+{
+    return tracker->max_size == UVM_TRACKER_CACHED_ENTRIES;
+}
+
 static void free_entries(uvm_tracker_t *tracker)
 {
     if (tracker_is_using_static_entries(tracker))
         return;
-    uvm_kvfree(tracker->dynamic_entries);
+
+    if (tracker_is_using_cached_entries(tracker))
+        uvm_kmem_cache_free(g_uvm_tracker_entries_cache, tracker->dynamic_entries);
+    else
+        uvm_kvfree(tracker->dynamic_entries);
 }
 
 uvm_tracker_entry_t *uvm_tracker_get_entries(uvm_tracker_t *tracker)
@@ -106,13 +140,20 @@ NV_STATUS uvm_tracker_reserve(uvm_tracker_t *tracker, NvU32 min_free_entries)
         // This is based on a guess that if a tracker needs more than 1
         // entry it likely needs much more.
         // TODO: Bug 1764961: Verify that guess.
-        NvU32 new_max_size = max((NvU32)8, (NvU32)roundup_pow_of_two(tracker->size + min_free_entries));
+        NvU32 new_max_size = max((NvU32)UVM_TRACKER_CACHED_ENTRIES,
+                                 (NvU32)roundup_pow_of_two(tracker->size + min_free_entries));
         uvm_tracker_entry_t *new_entries;
 
-        if (tracker_is_using_static_entries(tracker)) {
-            new_entries = uvm_kvmalloc(sizeof(*new_entries) * new_max_size);
-            if (new_entries)
-                memcpy(new_entries, tracker->static_entries, sizeof(*new_entries) * tracker->size);
+        if (tracker_is_using_static_entries(tracker) || tracker_is_using_cached_entries(tracker)) {
+            if (new_max_size == UVM_TRACKER_CACHED_ENTRIES)
+                new_entries = uvm_kmem_cache_alloc(g_uvm_tracker_entries_cache);
+            else
+                new_entries = uvm_kvmalloc(sizeof(*new_entries) * new_max_size);
+
+            if (new_entries) {
+                memcpy(new_entries, uvm_tracker_get_entries(tracker), sizeof(*new_entries) * tracker->size);
+                free_entries(tracker);
+            }
         } else {
             new_entries = uvm_kvrealloc(tracker->dynamic_entries, sizeof(*new_entries) * new_max_size);
         }
@@ -290,12 +331,30 @@ static void uvm_tracker_print_pending_pushes(uvm_tracker_t *tracker)
         uvm_tracker_entry_print_pending_pushes(entry);
 }
 
+// One iteration of waiting for a pending entry. Parks on the completion
+// interrupt of the entry's channel once the wait has lasted long enough, and
+// otherwise waits for the channel's tracking semaphore to be released. Returns
+// NV_ERR_TIMEOUT_RETRY if pending pushes should be printed.
+static NV_STATUS wait_for_entry_iteration(uvm_tracker_entry_t *tracker_entry, uvm_spin_loop_t *spin)
+{
+    uvm_gpu_semaphore_t *semaphore = &tracker_entry->channel->tracking_sem.semaphore;
+
+    if (uvm_channel_wait_for_completion_interrupt(tracker_entry->channel,
+                                                  tracker_entry->value,
+                                                  uvm_spin_loop_elapsed(spin)))
+        return uvm_spin_loop_check_timeout(spin);
+
+    return UVM_SPIN_LOOP_WAIT_ON(spin,
+                                 uvm_gpu_semaphore_get_monitor_address(semaphore),
+                                 uvm_gpu_semaphore_get_payload(semaphore));
+}
+
 static NV_STATUS wait_for_entry_with_spin(uvm_tracker_entry_t *tracker_entry, uvm_spin_loop_t *spin)
 {
     NV_STATUS status = NV_OK;
 
     while (!uvm_tracker_is_entry_completed(tracker_entry) && status == NV_OK) {
-        if (UVM_SPIN_LOOP(spin) == NV_ERR_TIMEOUT_RETRY)
+        if (wait_for_entry_iteration(tracker_entry, spin) == NV_ERR_TIMEOUT_RETRY)
             uvm_tracker_entry_print_pending_pushes(tracker_entry);
 
         status = uvm_channel_check_errors(tracker_entry->channel);
@@ -326,7 +385,8 @@ NV_STATUS uvm_tracker_wait(uvm_tracker_t *tracker)
 
     uvm_spin_loop_init(&spin);
     while (!uvm_tracker_is_completed(tracker) && status == NV_OK) {
-        if (UVM_SPIN_LOOP(&spin) == NV_ERR_TIMEOUT_RETRY)
+        // Only pending entries are left, wait on the first one.
+        if (wait_for_entry_iteration(&uvm_tracker_get_entries(tracker)[0], &spin) == NV_ERR_TIMEOUT_RETRY)
             uvm_tracker_print_pending_pushes(tracker);
 
         status = uvm_tracker_check_errors(tracker);
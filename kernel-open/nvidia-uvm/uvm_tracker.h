@@ -77,6 +77,10 @@ static void uvm_tracker_init(uvm_tracker_t *tracker)
     *tracker = (uvm_tracker_t)UVM_TRACKER_INIT();
 }
 
+// Module-wide initialization and teardown of the tracker entry cache
+NV_STATUS uvm_tracker_global_init(void);
+void uvm_tracker_global_exit(void);
+
 // Deinitialize a tracker
 // This will free any dynamic entries from the tracker
 void uvm_tracker_deinit(uvm_tracker_t *tracker);
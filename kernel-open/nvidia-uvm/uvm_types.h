@@ -351,6 +351,7 @@ typedef enum
     UvmEventTypeThrottlingEnd              = 12,
     UvmEventTypeMapRemote                  = 13,
     UvmEventTypeEviction                   = 14,
+    UvmEventTypeReadDuplicationPolicy      = 15,
 
     // ---- Add new values above this line
     UvmEventNumTypes,
@@ -384,6 +385,7 @@ typedef enum
 #define UVM_EVENT_ENABLE_THROTTLING_END               ((NvU64)1 << UvmEventTypeThrottlingEnd)
 #define UVM_EVENT_ENABLE_MAP_REMOTE                   ((NvU64)1 << UvmEventTypeMapRemote)
 #define UVM_EVENT_ENABLE_EVICTION                     ((NvU64)1 << UvmEventTypeEviction)
+#define UVM_EVENT_ENABLE_READ_DUPLICATION_POLICY      ((NvU64)1 << UvmEventTypeReadDuplicationPolicy)
 #define UVM_EVENT_ENABLE_TEST_ACCESS_COUNTER          ((NvU64)1 << UvmEventTypeTestAccessCounter)
 #define UVM_EVENT_ENABLE_TEST_HMM_SPLIT_INVALIDATE    ((NvU64)1 << UvmEventTypeTestHmmSplitInvalidate)
 
@@ -920,6 +922,30 @@ typedef struct
     NvU64 timeStamp;        // cpu time stamp when eviction starts on the cpu
 } UvmEventEvictionInfo;
 
+typedef struct
+{
+    //
+    // eventType has to be the 1st argument of this structure.
+    // Setting eventType = UvmEventTypeReadDuplicationPolicy helps to identify
+    // event data in a queue.
+    //
+    NvU8 eventType;
+    NvU8 enabled;           // 1 if read duplication was automatically
+                            // enabled on the range, 0 if it was reverted
+    //
+    // This structure is shared between UVM kernel and tools.
+    // Manually padding the structure so that compiler options like pragma pack
+    // or malign-double will have no effect on the field offsets
+    //
+    NvU16 padding16bits;
+    NvU32 padding32bits;
+    NvU64 processors;       // mask of the processors that accessed the range
+                            // in the window that triggered the change
+    NvU64 address;          // start address of the VA range
+    NvU64 size;             // size of the VA range
+    NvU64 timeStamp;        // cpu time stamp when the policy changed
+} UvmEventReadDuplicationPolicyInfo;
+
 // TODO: Bug 1870362: [uvm] Provide virtual address and processor index in
 // AccessCounter events
 //
@@ -1009,6 +1035,7 @@ typedef struct
             UvmEventThrottlingEndInfo throttlingEnd;
             UvmEventMapRemoteInfo mapRemote;
             UvmEventEvictionInfo eviction;
+            UvmEventReadDuplicationPolicyInfo readDuplicationPolicy;
         } eventData;
 
         union
@@ -1058,6 +1085,34 @@ typedef enum
     UvmDebugAccessTypeWrite = 1,
 } UvmDebugAccessType;
 
+//------------------------------------------------------------------------------
+// Performance heuristics tunables that can be set per VA space with
+// UVM_SET_PERF_TUNABLE. Each one starts at the value of the module parameter of
+// the same name (see uvm_perf_tunables.c for the names and valid ranges).
+//------------------------------------------------------------------------------
+typedef enum
+{
+    UvmPerfTunablePrefetchEnable                 = 0,
+    UvmPerfTunablePrefetchThreshold              = 1,
+    UvmPerfTunablePrefetchMinFaults              = 2,
+    UvmPerfTunablePrefetchStreamsEnable          = 3,
+    UvmPerfTunablePrefetchStreamConfidence       = 4,
+    UvmPerfTunableThrashingEnable                = 5,
+    UvmPerfTunableThrashingThreshold             = 6,
+    UvmPerfTunableThrashingPinThreshold          = 7,
+    UvmPerfTunableThrashingLapseUsec             = 8,
+    UvmPerfTunableThrashingNap                   = 9,
+    UvmPerfTunableThrashingEpoch                 = 10,
+    UvmPerfTunableThrashingPin                   = 11,
+    UvmPerfTunableThrashingMaxResets             = 12,
+    UvmPerfTunableMapRemoteOnNativeAtomicsFault  = 13,
+    UvmPerfTunableMapRemoteOnEviction            = 14,
+    UvmPerfTunableEvictionPriority               = 15,
+    UvmPerfTunableThrashingMapRemoteFirst        = 16,
+    // ---- Add new values above this line
+    UvmPerfTunableCount
+} UvmPerfTunable;
+
 typedef struct UvmEventControlData_tag {
     // entries between get_ahead and get_behind are currently being read
     volatile NvU32 get_ahead;
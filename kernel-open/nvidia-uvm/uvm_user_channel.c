@@ -484,6 +484,113 @@ out:
     return status;
 }
 
+// Upper bound on the PTEs retrieved for all resources of a channel at once.
+// Channels with larger resources query RM per resource instead.
+#define MAX_CHANNEL_PTES_SIZE ((size_t)2 * 1024 * 1024)
+
+// Retrieve the PTEs of all the channel's resources which still need to be
+// mapped with a single RM call, instead of one call per resource. On success
+// ptes[i] points to the PTEs of resource i, or is NULL if that resource is
+// already mapped, and the caller must free *buffer_out.
+static NV_STATUS get_rm_channel_resource_ptes(uvm_user_channel_t *user_channel,
+                                              const uvm_map_rm_params_t *map_rm_params,
+                                              NvU64 **ptes,
+                                              NvU64 **buffer_out)
+{
+    uvm_page_tree_t *tree = &user_channel->gpu_va_space->page_tables;
+    NvU32 num_resources = user_channel->num_resources;
+    NvP64 *descriptors = NULL;
+    NvU64 *sizes = NULL;
+    UvmGpuExternalMappingInfo *mapping_infos = NULL;
+    NvU64 *buffer = NULL;
+    size_t buffer_size = 0;
+    size_t buffer_offset = 0;
+    NvU32 i, count = 0;
+    NV_STATUS status;
+
+    *buffer_out = NULL;
+
+    for (i = 0; i < num_resources; i++) {
+        UvmGpuMemoryInfo *mem_info = &user_channel->resources[i].resourceInfo;
+
+        ptes[i] = NULL;
+        if (user_channel->va_ranges[i]->channel.pt_range_vec.ranges)
+            continue;
+
+        buffer_size += uvm_div_pow2_64(mem_info->size, mem_info->pageSize) * uvm_mmu_pte_size(tree, mem_info->pageSize);
+        count++;
+    }
+
+    if (count == 0)
+        return NV_OK;
+
+    if (buffer_size > MAX_CHANNEL_PTES_SIZE)
+        return NV_ERR_NOT_SUPPORTED;
+
+    descriptors = uvm_kvmalloc(count * sizeof(descriptors[0]));
+    sizes = uvm_kvmalloc(count * sizeof(sizes[0]));
+    mapping_infos = uvm_kvmalloc_zero(count * sizeof(mapping_infos[0]));
+    buffer = uvm_kvmalloc(buffer_size);
+    if (!descriptors || !sizes || !mapping_infos || !buffer) {
+        status = NV_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    for (i = 0, count = 0; i < num_resources; i++) {
+        UvmGpuMemoryInfo *mem_info = &user_channel->resources[i].resourceInfo;
+        UvmGpuExternalMappingInfo *mapping_info = &mapping_infos[count];
+        NvU64 num_ptes = uvm_div_pow2_64(mem_info->size, mem_info->pageSize);
+
+        if (user_channel->va_ranges[i]->channel.pt_range_vec.ranges)
+            continue;
+
+        descriptors[count] = user_channel->va_ranges[i]->channel.rm_descriptor;
+        sizes[count] = mem_info->size;
+
+        mapping_info->cachingType = map_rm_params->caching_type;
+        mapping_info->mappingType = map_rm_params->mapping_type;
+        mapping_info->formatType = map_rm_params->format_type;
+        mapping_info->elementBits = map_rm_params->element_bits;
+        mapping_info->compressionType = map_rm_params->compression_type;
+        mapping_info->pteBuffer = (NvU64 *)((char *)buffer + buffer_offset);
+        mapping_info->pteBufferSize = num_ptes * uvm_mmu_pte_size(tree, mem_info->pageSize);
+
+        ptes[i] = mapping_info->pteBuffer;
+        buffer_offset += mapping_info->pteBufferSize;
+        count++;
+    }
+
+    status = uvm_rm_locked_call(nvUvmInterfaceGetChannelResourcesPtes(user_channel->gpu_va_space->duped_gpu_va_space,
+                                                                      count,
+                                                                      descriptors,
+                                                                      sizes,
+                                                                      mapping_infos));
+    if (status != NV_OK)
+        goto out;
+
+    for (i = 0; i < count; i++) {
+        if (mapping_infos[i].numRemainingPtes != 0) {
+            status = NV_ERR_BUFFER_TOO_SMALL;
+            goto out;
+        }
+    }
+
+    *buffer_out = buffer;
+    buffer = NULL;
+
+out:
+    if (status != NV_OK) {
+        for (i = 0; i < num_resources; i++)
+            ptes[i] = NULL;
+    }
+
+    uvm_kvfree(buffer);
+    uvm_kvfree(mapping_infos);
+    uvm_kvfree(sizes);
+    uvm_kvfree(descriptors);
+    return status;
+}
+
 // Map the already-created VA ranges by getting the PTEs for each allocation
 // from RM. The caller is responsible for destroying the VA ranges if the
 // mappings fail.
@@ -492,6 +599,8 @@ static NV_STATUS uvm_user_channel_map_resources(uvm_user_channel_t *user_channel
     uvm_tracker_t tracker = UVM_TRACKER_INIT();
     NvU32 i;
     NV_STATUS status = NV_OK, tracker_status;
+    NvU64 **ptes = NULL;
+    NvU64 *ptes_buffer = NULL;
     uvm_map_rm_params_t map_rm_params =
     {
         // Some of these resources need to be privileged and/or read- only, so
@@ -504,6 +613,15 @@ static NV_STATUS uvm_user_channel_map_resources(uvm_user_channel_t *user_channel
         .compression_type = UvmGpuCompressionTypeDefault,
     };
 
+    // Fetching all PTEs upfront is only an optimization. If it fails, the
+    // resources are mapped with per-resource queries, which report any actual
+    // error.
+    if (user_channel->num_resources > 0) {
+        ptes = uvm_kvmalloc_zero(user_channel->num_resources * sizeof(ptes[0]));
+        if (ptes)
+            (void)get_rm_channel_resource_ptes(user_channel, &map_rm_params, ptes, &ptes_buffer);
+    }
+
     for (i = 0; i < user_channel->num_resources; i++) {
         UvmGpuMemoryInfo *mem_info;
         uvm_va_range_t *range = user_channel->va_ranges[i];
@@ -520,6 +638,7 @@ static NV_STATUS uvm_user_channel_map_resources(uvm_user_channel_t *user_channel
         }
 
         mem_info = &user_channel->resources[i].resourceInfo;
+        map_rm_params.ptes = ptes ? ptes[i] : NULL;
         status = uvm_va_range_map_rm_allocation(range, user_channel->gpu, mem_info, &map_rm_params, NULL, &tracker);
         if (status != NV_OK) {
             // We can't destroy the VA ranges here since we only have the VA
@@ -531,6 +650,10 @@ static NV_STATUS uvm_user_channel_map_resources(uvm_user_channel_t *user_channel
     // Always wait for the tracker even on error so we don't have any pending
     // map operations happening during the subsequent destroy.
     tracker_status = uvm_tracker_wait_deinit(&tracker);
+
+    uvm_kvfree(ptes_buffer);
+    uvm_kvfree(ptes);
+
     return status == NV_OK ? tracker_status : status;
 }
 
@@ -35,6 +35,7 @@
 #include "uvm_hal.h"
 #include "uvm_perf_thrashing.h"
 #include "uvm_perf_prefetch.h"
+#include "uvm_perf_tunables.h"
 #include "uvm_mem.h"
 #include "uvm_gpu_access_counters.h"
 #include "uvm_va_space_mm.h"
@@ -50,18 +51,49 @@ typedef enum
 
 static NvU64 uvm_perf_authorized_cpu_fault_tracking_window_ns = 300000;
 
-static heap g_uvm_va_block_cache __read_mostly;
-static heap g_uvm_va_block_gpu_state_cache __read_mostly;
-static heap g_uvm_page_mask_cache __read_mostly;
-static heap g_uvm_va_block_context_cache __read_mostly;
+static uvm_kmem_cache_t *g_uvm_va_block_cache __read_mostly;
+static uvm_kmem_cache_t *g_uvm_va_block_gpu_state_cache __read_mostly;
+static uvm_kmem_cache_t *g_uvm_page_mask_cache __read_mostly;
+static uvm_kmem_cache_t *g_uvm_va_block_context_cache __read_mostly;
 
 static int uvm_fault_force_sysmem __read_mostly = 0;
 module_param(uvm_fault_force_sysmem, int, S_IRUGO|S_IWUSR);
 MODULE_PARM_DESC(uvm_fault_force_sysmem, "Force (1) using sysmem storage for pages that faulted. Default: 0.");
 
+// Size of the aligned window around a CPU fault whose already resident pages
+// are serviced along with the faulting page, see block_cpu_fault_around().
+// Rounded down to a power of two and capped to UVM_VA_BLOCK_SIZE; a value of
+// PAGE_SIZE or less disables fault-around.
+static unsigned uvm_perf_cpu_fault_around_size __read_mostly = 64 * 1024;
+module_param(uvm_perf_cpu_fault_around_size, uint, S_IRUGO|S_IWUSR);
+MODULE_PARM_DESC(uvm_perf_cpu_fault_around_size,
+                 "Bytes around a CPU fault to map or migrate along with it. Default: 64K.");
+
 static int uvm_perf_map_remote_on_eviction __read_mostly = 1;
 module_param(uvm_perf_map_remote_on_eviction, int, S_IRUGO);
 
+// Evict user memory to the NVLink peer with the most free vidmem instead of to
+// sysmem, as long as the peer keeps at least UVM_EVICT_TO_PEER_MIN_FREE free.
+static int uvm_perf_evict_to_peer __read_mostly = 1;
+module_param(uvm_perf_evict_to_peer, int, S_IRUGO);
+
+// Free vidmem a peer must have left after receiving evicted memory, so that
+// evicting to peers doesn't just move the oversubscription around
+#define UVM_EVICT_TO_PEER_MIN_FREE (256 * UVM_SIZE_1MB)
+
+// Default priority of the vidmem of VA spaces in eviction decisions, from 0 to
+// UVM_PMM_GPU_EVICTION_PRIORITY_MAX. Memory of VA spaces with a higher priority
+// is evicted last. Can be changed per VA space with UVM_SET_PERF_TUNABLE.
+static unsigned uvm_perf_eviction_priority __read_mostly = 0;
+module_param(uvm_perf_eviction_priority, uint, S_IRUGO);
+
+// When a page is resident on several equally close GPUs, as read-duplicated
+// pages end up being, spread the copies to new GPUs across them instead of
+// always copying from the first one. Every new replica becomes a source for
+// the next copies, so N GPUs are reached in a fan-out tree.
+static int uvm_perf_read_dup_fan_out __read_mostly = 1;
+module_param(uvm_perf_read_dup_fan_out, int, S_IRUGO);
+
 // Caching is always disabled for mappings to remote memory. The following two
 // module parameters can be used to force caching for GPU peer/sysmem mappings.
 //
@@ -153,7 +185,7 @@ static bool is_uvm_fault_force_sysmem_set(void)
 
 bool uvm_va_space_map_remote_on_eviction(uvm_va_space_t *va_space)
 {
-    return uvm_perf_map_remote_on_eviction &&
+    return uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunableMapRemoteOnEviction) &&
            uvm_va_space_has_access_counter_migrations(va_space);
 }
 
@@ -177,6 +209,7 @@ void uvm_va_block_retry_init(uvm_va_block_retry_t *retry)
     uvm_tracker_init(&retry->tracker);
     INIT_LIST_HEAD(&retry->used_chunks);
     INIT_LIST_HEAD(&retry->free_chunks);
+    retry->in_eviction = false;
 }
 
 // The bottom bit of uvm_va_block_t::chunks is used to indicate how CPU chunks
@@ -627,42 +660,69 @@ static block_phys_page_t block_phys_page(uvm_processor_id_t processor, uvm_page_
     return (block_phys_page_t){ processor, page_index };
 }
 
+// Constructor for g_uvm_va_block_cache. Objects come already zeroed, so this
+// only initializes the fields which don't depend on the block's range.
+static void va_block_ctor(void *object)
+{
+    uvm_va_block_t *block = object;
+
+    nv_kref_init(&block->kref);
+    uvm_mutex_init(&block->lock, UVM_LOCK_ORDER_VA_BLOCK);
+    uvm_tracker_init(&block->tracker);
+    block->prefetch_info.last_migration_proc_id = UVM_ID_INVALID;
+
+    nv_kthread_q_item_init(&block->eviction_mappings_q_item, block_add_eviction_mappings_entry, block);
+}
+
 NV_STATUS uvm_va_block_init(void)
 {
     if (uvm_enable_builtin_tests)
-        g_uvm_va_block_cache = NV_KMEM_CACHE_CREATE("uvm_va_block_wrapper_t", uvm_va_block_wrapper_t);
+        g_uvm_va_block_cache = UVM_KMEM_CACHE_CREATE("uvm_va_block_wrapper_t", uvm_va_block_wrapper_t, va_block_ctor);
     else
-        g_uvm_va_block_cache = NV_KMEM_CACHE_CREATE("uvm_va_block_t", uvm_va_block_t);
+        g_uvm_va_block_cache = UVM_KMEM_CACHE_CREATE("uvm_va_block_t", uvm_va_block_t, va_block_ctor);
 
     if (!g_uvm_va_block_cache)
         return NV_ERR_NO_MEMORY;
 
-    g_uvm_va_block_gpu_state_cache = NV_KMEM_CACHE_CREATE("uvm_va_block_gpu_state_t", uvm_va_block_gpu_state_t);
+    g_uvm_va_block_gpu_state_cache = UVM_KMEM_CACHE_CREATE("uvm_va_block_gpu_state_t", uvm_va_block_gpu_state_t, NULL);
     if (!g_uvm_va_block_gpu_state_cache)
         return NV_ERR_NO_MEMORY;
 
-    g_uvm_page_mask_cache = NV_KMEM_CACHE_CREATE("uvm_page_mask_t", uvm_page_mask_t);
+    g_uvm_page_mask_cache = UVM_KMEM_CACHE_CREATE("uvm_page_mask_t", uvm_page_mask_t, NULL);
     if (!g_uvm_page_mask_cache)
         return NV_ERR_NO_MEMORY;
 
-    g_uvm_va_block_context_cache = NV_KMEM_CACHE_CREATE("uvm_va_block_context_t", uvm_va_block_context_t);
+    g_uvm_va_block_context_cache = UVM_KMEM_CACHE_CREATE("uvm_va_block_context_t", uvm_va_block_context_t, NULL);
     if (!g_uvm_va_block_context_cache)
         return NV_ERR_NO_MEMORY;
 
+    uvm_perf_tunables_register(UvmPerfTunableMapRemoteOnEviction, uvm_perf_map_remote_on_eviction != 0, 0, 1);
+
+    if (uvm_perf_eviction_priority > UVM_PMM_GPU_EVICTION_PRIORITY_MAX) {
+        pr_info("Invalid value %u for uvm_perf_eviction_priority. Using %u instead\n",
+                uvm_perf_eviction_priority,
+                UVM_PMM_GPU_EVICTION_PRIORITY_MAX);
+        uvm_perf_eviction_priority = UVM_PMM_GPU_EVICTION_PRIORITY_MAX;
+    }
+    uvm_perf_tunables_register(UvmPerfTunableEvictionPriority,
+                               uvm_perf_eviction_priority,
+                               0,
+                               UVM_PMM_GPU_EVICTION_PRIORITY_MAX);
+
     return NV_OK;
 }
 
 void uvm_va_block_exit(void)
 {
-    kmem_cache_destroy_safe(&g_uvm_va_block_context_cache);
-    kmem_cache_destroy_safe(&g_uvm_page_mask_cache);
-    kmem_cache_destroy_safe(&g_uvm_va_block_gpu_state_cache);
-    kmem_cache_destroy_safe(&g_uvm_va_block_cache);
+    uvm_kmem_cache_destroy_safe(&g_uvm_va_block_context_cache);
+    uvm_kmem_cache_destroy_safe(&g_uvm_page_mask_cache);
+    uvm_kmem_cache_destroy_safe(&g_uvm_va_block_gpu_state_cache);
+    uvm_kmem_cache_destroy_safe(&g_uvm_va_block_cache);
 }
 
 uvm_va_block_context_t *uvm_va_block_context_alloc(struct mm_struct *mm)
 {
-    uvm_va_block_context_t *block_context = kmem_cache_alloc(g_uvm_va_block_context_cache, NV_UVM_GFP_FLAGS);
+    uvm_va_block_context_t *block_context = uvm_kmem_cache_alloc(g_uvm_va_block_context_cache);
     if (block_context)
         uvm_va_block_context_init(block_context, mm);
 
@@ -671,8 +731,7 @@ uvm_va_block_context_t *uvm_va_block_context_alloc(struct mm_struct *mm)
 
 void uvm_va_block_context_free(uvm_va_block_context_t *va_block_context)
 {
-    if (va_block_context)
-        kmem_cache_free(g_uvm_va_block_context_cache, va_block_context);
+    uvm_kmem_cache_free(g_uvm_va_block_context_cache, va_block_context);
 }
 
 // Convert from page_index to chunk_index. The goal is for each system page in
@@ -921,20 +980,14 @@ NV_STATUS uvm_va_block_create(uvm_va_range_t *va_range,
     // Blocks can't span a block alignment boundary
     UVM_ASSERT(UVM_VA_BLOCK_ALIGN_DOWN(start) == UVM_VA_BLOCK_ALIGN_DOWN(end));
 
-    block = nv_kmem_cache_zalloc(g_uvm_va_block_cache, NV_UVM_GFP_FLAGS);
+    block = uvm_kmem_cache_zalloc(g_uvm_va_block_cache);
 
     if (!block)
         return NV_ERR_NO_MEMORY;
 
-    nv_kref_init(&block->kref);
-    uvm_mutex_init(&block->lock, UVM_LOCK_ORDER_VA_BLOCK);
     block->start = start;
     block->end = end;
     block->va_range = va_range;
-    uvm_tracker_init(&block->tracker);
-    block->prefetch_info.last_migration_proc_id = UVM_ID_INVALID;
-
-    nv_kthread_q_item_init(&block->eviction_mappings_q_item, block_add_eviction_mappings_entry, block);
 
     *out_block = block;
     return NV_OK;
@@ -1128,7 +1181,7 @@ static uvm_va_block_gpu_state_t *block_gpu_state_get_alloc(uvm_va_block_t *block
     if (gpu_state)
         return gpu_state;
 
-    gpu_state = nv_kmem_cache_zalloc(g_uvm_va_block_gpu_state_cache, NV_UVM_GFP_FLAGS);
+    gpu_state = uvm_kmem_cache_zalloc(g_uvm_va_block_gpu_state_cache);
     if (!gpu_state)
         return NULL;
 
@@ -1146,7 +1199,7 @@ static uvm_va_block_gpu_state_t *block_gpu_state_get_alloc(uvm_va_block_t *block
 
 error:
     uvm_kvfree(gpu_state->chunks);
-    kmem_cache_free(g_uvm_va_block_gpu_state_cache, gpu_state);
+    uvm_kmem_cache_free(g_uvm_va_block_gpu_state_cache, gpu_state);
     block->gpus[uvm_id_gpu_index(gpu->id)] = NULL;
 
     return NULL;
@@ -1245,12 +1298,8 @@ static NV_STATUS block_map_indirect_peers_to_gpu_chunk(uvm_va_block_t *block, uv
 
     // Unlike uvm_va_block_map_cpu_chunk_on_gpus, this function isn't called on
     // the eviction path, so we can assume that the VA space is locked.
-    //
-    // TODO: Bug 2007346: In the future we may want to enable eviction to peers,
-    //       meaning we may need to allocate peer memory and map it on the
-    //       eviction path. That will require making sure that peers can't be
-    //       enabled or disabled either in the VA space or globally within this
-    //       function.
+    // Evictions to peers skip it, as they only target GPUs without indirect
+    // peers. See block_evict_pick_peer().
     uvm_assert_rwsem_locked(&va_space->lock);
     uvm_assert_mutex_locked(&block->lock);
 
@@ -1339,6 +1388,82 @@ static NV_STATUS block_alloc_cpu_chunk(uvm_va_block_t *block,
     return uvm_cpu_chunk_alloc(alloc_size, flags, chunk);
 }
 
+// Try to replace the CPU chunks of a fully-populated 2M block with a single 2M
+// chunk. This only succeeds if the chunks are physically contiguous, in which
+// case nothing is copied: the new chunk adopts their memory and DMA mappings,
+// and the reverse sysmem mappings collapse to one entry per GPU. GPU PTEs keep
+// pointing at the same addresses, and the 2M chunk lets the next mapping of the
+// block use big pages.
+static void block_promote_cpu_chunks(uvm_va_block_t *block, uvm_chunk_sizes_mask_t cpu_allocation_sizes)
+{
+    uvm_cpu_chunk_storage_mixed_t *mixed;
+    uvm_cpu_chunk_t **chunks;
+    uvm_cpu_chunk_t *chunk;
+    uvm_page_index_t page_index;
+    size_t num_chunks = 0;
+    size_t i;
+    uvm_gpu_id_t id;
+    NV_STATUS status;
+
+    if (uvm_va_block_is_hmm(block) ||
+        uvm_va_block_size(block) != UVM_CHUNK_SIZE_2M ||
+        !(cpu_allocation_sizes & UVM_CHUNK_SIZE_2M) ||
+        uvm_cpu_storage_get_type(block) != UVM_CPU_CHUNK_STORAGE_MIXED ||
+        !uvm_page_mask_full(&block->cpu.allocated))
+        return;
+
+    for_each_cpu_chunk_in_block(chunk, page_index, block)
+        num_chunks++;
+
+    chunks = uvm_kvmalloc(sizeof(*chunks) * num_chunks);
+    if (!chunks)
+        return;
+
+    i = 0;
+    for_each_cpu_chunk_in_block(chunk, page_index, block)
+        chunks[i++] = chunk;
+
+    if (uvm_cpu_chunk_promote(chunks, num_chunks, &chunk) != NV_OK) {
+        uvm_kvfree(chunks);
+        return;
+    }
+
+    uvm_kvfree(chunks);
+
+    // The old chunk descriptors were released by the promotion, so the mixed
+    // storage is torn down without looking at them.
+    mixed = uvm_cpu_storage_get_ptr(block);
+    for (i = 0; i < MAX_BIG_CPU_CHUNK_SLOTS_PER_UVM_VA_BLOCK; i++) {
+        if (!test_bit(i, mixed->big_chunks))
+            uvm_kvfree(mixed->slots[i]);
+    }
+
+    uvm_kvfree(mixed);
+    block->cpu.chunks = 0;
+    uvm_page_mask_zero(&block->cpu.allocated);
+
+    // Inserting a 2M chunk doesn't allocate any storage, so it can't fail.
+    status = uvm_cpu_chunk_insert_in_block(block, chunk, 0);
+    UVM_ASSERT(status == NV_OK);
+
+    for_each_gpu_id(id) {
+        NvU64 gpu_mapping_addr;
+        uvm_gpu_t *gpu;
+
+        if (!uvm_va_block_gpu_state_get(block, id))
+            continue;
+
+        gpu = block_get_gpu(block, id);
+        gpu_mapping_addr = uvm_cpu_chunk_get_gpu_phys_addr(chunk, gpu->parent);
+        if (gpu_mapping_addr == 0)
+            continue;
+
+        uvm_pmm_sysmem_mappings_merge_gpu_mappings(&gpu->pmm_reverse_sysmem_mappings,
+                                                   gpu_mapping_addr,
+                                                   UVM_CHUNK_SIZE_2M);
+    }
+}
+
 // Allocates the input page in the block, if it doesn't already exist
 //
 // Also maps the page for physical access by all GPUs used by the block, which
@@ -1466,6 +1591,9 @@ static NV_STATUS block_populate_pages_cpu(uvm_va_block_t *block,
         uvm_cpu_chunk_free(chunk);
     }
 
+    if (status == NV_OK)
+        block_promote_cpu_chunks(block, cpu_allocation_sizes);
+
     return status;
 }
 
@@ -1496,6 +1624,10 @@ static NV_STATUS block_alloc_gpu_chunk(uvm_va_block_t *block,
             status = uvm_pmm_gpu_alloc_user(&gpu->pmm, 1, size, UVM_PMM_ALLOC_FLAGS_NONE, &gpu_chunk, &retry->tracker);
         }
 
+        // Allocations done while evicting another GPU must not evict
+        if (status == NV_ERR_NO_MEMORY && retry->in_eviction)
+            return status;
+
         if (status == NV_ERR_NO_MEMORY) {
             // If that fails with no memory, try allocating with eviction and
             // return back to the caller immediately so that the operation can
@@ -1848,11 +1980,46 @@ const uvm_page_mask_t *uvm_va_block_map_mask_get(uvm_va_block_t *block, uvm_proc
 }
 
 static const uvm_page_mask_t *block_evicted_mask_get(uvm_va_block_t *block, uvm_gpu_id_t gpu_id)
+{
+    static const uvm_page_mask_t no_evicted_pages = {};
+    uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, gpu_id);
+    UVM_ASSERT(gpu_state);
+
+    if (!gpu_state->evicted)
+        return &no_evicted_pages;
+
+    return gpu_state->evicted;
+}
+
+static NV_STATUS block_gpu_evicted_mask_alloc(uvm_va_block_gpu_state_t *gpu_state)
+{
+    if (gpu_state->evicted)
+        return NV_OK;
+
+    gpu_state->evicted = uvm_kmem_cache_zalloc(g_uvm_page_mask_cache);
+    if (!gpu_state->evicted)
+        return NV_ERR_NO_MEMORY;
+
+    return NV_OK;
+}
+
+// Free the evicted mask of the GPU if no evicted pages are left in it, and
+// update the block's evicted_gpus mask accordingly.
+static void block_gpu_evicted_mask_collapse(uvm_va_block_t *block, uvm_gpu_id_t gpu_id)
 {
     uvm_va_block_gpu_state_t *gpu_state = uvm_va_block_gpu_state_get(block, gpu_id);
+
     UVM_ASSERT(gpu_state);
 
-    return &gpu_state->evicted;
+    if (gpu_state->evicted && uvm_page_mask_empty(gpu_state->evicted)) {
+        uvm_kmem_cache_free(g_uvm_page_mask_cache, gpu_state->evicted);
+        gpu_state->evicted = NULL;
+    }
+
+    if (gpu_state->evicted)
+        uvm_processor_mask_set(&block->evicted_gpus, gpu_id);
+    else
+        uvm_processor_mask_clear(&block->evicted_gpus, gpu_id);
 }
 
 static bool block_is_page_resident_anywhere(uvm_va_block_t *block, uvm_page_index_t page_index)
@@ -2222,7 +2389,7 @@ static NV_STATUS block_zero_new_gpu_chunk(uvm_va_block_t *block,
         return NV_OK;
 
     uvm_va_block_gpu_state_get(block, gpu->id);
-    zero_mask = kmem_cache_alloc(g_uvm_page_mask_cache, NV_UVM_GFP_FLAGS);
+    zero_mask = uvm_kmem_cache_alloc(g_uvm_page_mask_cache);
 
     if (!zero_mask)
         return NV_ERR_NO_MEMORY;
@@ -2308,7 +2475,7 @@ static NV_STATUS block_zero_new_gpu_chunk(uvm_va_block_t *block,
 
 out:
     if (zero_mask)
-        kmem_cache_free(g_uvm_page_mask_cache, zero_mask);
+        uvm_kmem_cache_free(g_uvm_page_mask_cache, zero_mask);
 
     return status;
 }
@@ -2363,9 +2530,11 @@ static NV_STATUS block_populate_gpu_chunk(uvm_va_block_t *block,
     // compile-time that it can store VA Block page indexes.
     BUILD_BUG_ON(PAGES_PER_UVM_VA_BLOCK >= PAGE_SIZE);
 
-    status = block_map_indirect_peers_to_gpu_chunk(block, gpu, chunk);
-    if (status != NV_OK)
-        goto chunk_unmap;
+    if (!retry->in_eviction) {
+        status = block_map_indirect_peers_to_gpu_chunk(block, gpu, chunk);
+        if (status != NV_OK)
+            goto chunk_unmap;
+    }
 
     if (block_test && block_test->inject_populate_error) {
         block_test->inject_populate_error = false;
@@ -2779,12 +2948,39 @@ static void block_mark_memory_used(uvm_va_block_t *block, uvm_processor_id_t id)
     if (!uvm_va_block_is_hmm(block) &&
         uvm_va_block_size(block) == UVM_CHUNK_SIZE_MAX &&
         uvm_gpu_supports_eviction(gpu)) {
+        uvm_va_space_t *va_space = uvm_va_block_get_va_space(block);
+        NvU32 eviction_priority = uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunableEvictionPriority);
+
         // The chunk has to be there if this GPU is resident
         UVM_ASSERT(uvm_processor_mask_test(&block->resident, id));
-        uvm_pmm_gpu_mark_root_chunk_used(&gpu->pmm, uvm_va_block_gpu_state_get(block, gpu->id)->chunks[0]);
+        uvm_pmm_gpu_mark_root_chunk_used(&gpu->pmm,
+                                         uvm_va_block_gpu_state_get(block, gpu->id)->chunks[0],
+                                         eviction_priority);
     }
 }
 
+// Record an access to the GPU memory of the block, for the eviction heuristics
+// of PMM.
+static void block_mark_memory_accessed(uvm_va_block_t *block, uvm_processor_id_t id)
+{
+    uvm_va_block_gpu_state_t *gpu_state;
+    uvm_gpu_t *gpu;
+
+    if (UVM_ID_IS_CPU(id) || !uvm_processor_mask_test(&block->resident, id))
+        return;
+
+    gpu = block_get_gpu(block, id);
+
+    if (uvm_va_block_is_hmm(block) ||
+        uvm_va_block_size(block) != UVM_CHUNK_SIZE_MAX ||
+        !uvm_gpu_supports_eviction(gpu))
+        return;
+
+    gpu_state = uvm_va_block_gpu_state_get(block, gpu->id);
+    if (gpu_state && gpu_state->chunks[0])
+        uvm_pmm_gpu_mark_root_chunk_accessed(&gpu->pmm, gpu_state->chunks[0]->address);
+}
+
 static void block_set_resident_processor(uvm_va_block_t *block, uvm_processor_id_t id)
 {
     UVM_ASSERT(!uvm_page_mask_empty(uvm_va_block_resident_mask_get(block, id)));
@@ -2918,23 +3114,19 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
     else if (uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_GPU))
         membar_flag = UVM_PUSH_FLAG_NEXT_MEMBAR_GPU;
 
-    // kmap() only guarantees PAGE_SIZE contiguity, all encryption and
-    // decryption must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_region(page_index, region) {
-        void *src_cpu_virt_addr;
+    // The caller guarantees that all pages in region are contiguous, so they
+    // are also contiguous in the linear mapping. Encrypt the whole region
+    // upfront with a single CSL context lock round trip. The CE decrypts still
+    // happen on a PAGE_SIZE basis, with one authentication tag per page.
+    uvm_conf_computing_cpu_encrypt_pages(push->channel,
+                                         cpu_va_staging_buffer,
+                                         pointer_from_u64(virt_from_linear_backed_phys(src_pa)),
+                                         uvm_va_block_region_num_pages(region),
+                                         cpu_auth_tag_buffer);
 
-        // The caller guarantees that all pages in region are contiguous,
-        // meaning they're guaranteed to be part of the same compound page.
+    for_each_va_block_page_in_region(page_index, region) {
         UVM_ASSERT(src_pa == uvm_cpu_chunk_get_cpu_page(block, page_index));
 
-        src_cpu_virt_addr = pointer_from_u64(virt_from_linear_backed_phys(src_pa));
-        uvm_conf_computing_cpu_encrypt(push->channel,
-                                       cpu_va_staging_buffer,
-                                       src_cpu_virt_addr,
-                                       NULL,
-                                       PAGE_SIZE,
-                                       cpu_auth_tag_buffer);
-
         // First LCE operation should be non-pipelined to guarantee ordering as
         // we do not know when was the last non-pipelined copy.
         // Last one applies the membar originally planned for the push if any
@@ -2952,9 +3144,7 @@ static void conf_computing_block_copy_push_cpu_to_gpu(uvm_va_block_t *block,
 
         src_pa += PAGE_SIZE;
         dst_address.address += PAGE_SIZE;
-        cpu_va_staging_buffer += PAGE_SIZE;
         staging_buffer.address += PAGE_SIZE;
-        cpu_auth_tag_buffer += UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
         auth_tag_buffer.address += UVM_CONF_COMPUTING_AUTH_TAG_SIZE;
     }
 }
@@ -2988,12 +3178,13 @@ static void conf_computing_block_copy_push_gpu_to_cpu(uvm_va_block_t *block,
     else if (uvm_push_get_and_reset_flag(push, UVM_PUSH_FLAG_NEXT_MEMBAR_GPU))
         membar_flag = UVM_PUSH_FLAG_NEXT_MEMBAR_GPU;
 
-    // Because we use kmap() for mapping pages for CPU side
-    // crypto-operations and it only guarantees PAGE_SIZE contiguity, all
-    // encryptions and decryptions must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_region(page_index, region) {
-        uvm_conf_computing_log_gpu_encryption(push->channel, &dma_buffer->decrypt_iv[page_index]);
+    // Encryptions happen on a PAGE_SIZE basis so that the CPU can decrypt
+    // each page on its own. Log all of them at once.
+    uvm_conf_computing_log_gpu_encryptions(push->channel,
+                                           &dma_buffer->decrypt_iv[region.first],
+                                           uvm_va_block_region_num_pages(region));
 
+    for_each_va_block_page_in_region(page_index, region) {
         // First LCE operation should be non-pipelined to guarantee ordering as
         // we do not know when was the last non-pipelined copy.
         // Last one applies the membar originally planned for the push if any
@@ -3023,6 +3214,7 @@ static NV_STATUS conf_computing_copy_pages_finish(uvm_va_block_t *block,
 {
     NV_STATUS status;
     uvm_page_index_t page_index;
+    uvm_va_block_region_t subregion;
     uvm_conf_computing_dma_buffer_t *dma_buffer = copy_state->dma_buffer;
     uvm_page_mask_t *encrypted_page_mask = &dma_buffer->encrypted_page_mask;
     void *auth_tag_buffer_base = uvm_mem_get_cpu_addr_kernel(dma_buffer->auth_tag);
@@ -3039,20 +3231,30 @@ static NV_STATUS conf_computing_copy_pages_finish(uvm_va_block_t *block,
     if (status != NV_OK)
         return status;
 
-    // kmap() only guarantees PAGE_SIZE contiguity, all encryption and
-    // decryption must happen on a PAGE_SIZE basis.
-    for_each_va_block_page_in_mask(page_index, encrypted_page_mask, block) {
-        NvU64 dst_pa = uvm_cpu_chunk_get_cpu_page(block, page_index);
-        void *staging_buffer = (char *)staging_buffer_base + (page_index * PAGE_SIZE);
-        void *auth_tag_buffer = (char *)auth_tag_buffer_base + (page_index * UVM_CONF_COMPUTING_AUTH_TAG_SIZE);
-        void *cpu_page_address = pointer_from_u64(virt_from_linear_backed_phys(dst_pa));
-
-        status = uvm_conf_computing_cpu_decrypt(push->channel,
-                                                cpu_page_address,
-                                                staging_buffer,
-                                                &dma_buffer->decrypt_iv[page_index],
-                                                PAGE_SIZE,
-                                                auth_tag_buffer);
+    // Pages were encrypted one by one, but runs of physically contiguous
+    // destination pages are decrypted with a single CSL context lock round
+    // trip.
+    for_each_va_block_subregion_in_mask(subregion, encrypted_page_mask, uvm_va_block_region_from_block(block)) {
+        for (page_index = subregion.first; page_index < subregion.outer && status == NV_OK;) {
+            NvU64 dst_pa = uvm_cpu_chunk_get_cpu_page(block, page_index);
+            void *staging_buffer = (char *)staging_buffer_base + (page_index * PAGE_SIZE);
+            void *auth_tag_buffer = (char *)auth_tag_buffer_base + (page_index * UVM_CONF_COMPUTING_AUTH_TAG_SIZE);
+            void *cpu_page_address = pointer_from_u64(virt_from_linear_backed_phys(dst_pa));
+            uvm_page_index_t run_first = page_index;
+
+            do {
+                ++page_index;
+            } while (page_index < subregion.outer &&
+                     uvm_cpu_chunk_get_cpu_page(block, page_index) == dst_pa + (page_index - run_first) * PAGE_SIZE);
+
+            status = uvm_conf_computing_cpu_decrypt_pages(push->channel,
+                                                          cpu_page_address,
+                                                          staging_buffer,
+                                                          &dma_buffer->decrypt_iv[run_first],
+                                                          page_index - run_first,
+                                                          auth_tag_buffer);
+        }
+
         if (status != NV_OK) {
             // TODO: Bug 3814087: [UVM][HCC] Handle CSL auth_tag verification
             //                    failures & other failures gracefully.
@@ -3163,6 +3365,7 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
     block_copy_state_t copy_state = {0};
     uvm_va_range_t *va_range = block->va_range;
     uvm_va_space_t *va_space = uvm_va_block_get_va_space(block);
+    NvU32 pushed_pages = 0;
 
     copy_state.src.id = src_id;
     copy_state.dst.id = dst_id;
@@ -3330,6 +3533,7 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
             block_copy_push(block, &copy_state, uvm_va_block_region_for_page(page_index), &push);
 
         last_index = page_index;
+        pushed_pages++;
     }
 
     // Copy the remaining pages
@@ -3352,6 +3556,9 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
                                         &block_context->make_resident);
 
         status = block_copy_end_push(block, &copy_state, copy_tracker, status, &push);
+
+        if (status == NV_OK)
+            uvm_tools_record_copy(src_id, dst_id, (NvU64)pushed_pages * PAGE_SIZE);
     }
 
     // Update VA block status bits
@@ -3373,6 +3580,39 @@ static NV_STATUS block_copy_resident_pages_between(uvm_va_block_t *block,
 // The function adds the pages that were successfully copied to the output
 // migrated_pages mask and returns the number of pages in copied_pages. These
 // fields are reliable even if an error is returned.
+// Like uvm_processor_mask_find_closest_id(), but when the closest candidate is
+// a GPU, picks one of the candidate GPUs that are as close to dst_id as it is,
+// based on dst_id. See uvm_perf_read_dup_fan_out.
+static uvm_processor_id_t block_find_copy_source(uvm_va_space_t *va_space,
+                                                 const uvm_processor_mask_t *candidates,
+                                                 uvm_processor_id_t dst_id)
+{
+    const uvm_processor_mask_t *nvlink_peers = &va_space->has_nvlink[uvm_id_value(dst_id)];
+    const uvm_processor_mask_t *indirect_peers = &va_space->indirect_peers[uvm_id_value(dst_id)];
+    uvm_processor_id_t closest = uvm_processor_mask_find_closest_id(va_space, candidates, dst_id);
+    uvm_processor_mask_t tier;
+    uvm_processor_id_t id;
+    NvU32 index;
+
+    if (!uvm_perf_read_dup_fan_out || UVM_ID_IS_CPU(dst_id) || !UVM_ID_IS_GPU(closest))
+        return closest;
+
+    uvm_processor_mask_zero(&tier);
+    for_each_gpu_id_in_mask(id, candidates) {
+        if (uvm_processor_mask_test(nvlink_peers, id) == uvm_processor_mask_test(nvlink_peers, closest) &&
+            uvm_processor_mask_test(indirect_peers, id) == uvm_processor_mask_test(indirect_peers, closest))
+            uvm_processor_mask_set(&tier, id);
+    }
+
+    index = uvm_id_gpu_index(dst_id) % uvm_processor_mask_get_count(&tier);
+    for_each_gpu_id_in_mask(id, &tier) {
+        if (index-- == 0)
+            return id;
+    }
+
+    return closest;
+}
+
 static NV_STATUS block_copy_resident_pages_mask(uvm_va_block_t *block,
                                                 uvm_va_block_context_t *block_context,
                                                 uvm_processor_id_t dst_id,
@@ -3395,7 +3635,10 @@ static NV_STATUS block_copy_resident_pages_mask(uvm_va_block_t *block,
 
     *copied_pages_out = 0;
 
-    for_each_closest_id(src_id, &search_mask, dst_id, va_space) {
+    for (src_id = block_find_copy_source(va_space, &search_mask, dst_id);
+         UVM_ID_IS_VALID(src_id);
+         uvm_processor_mask_clear(&search_mask, src_id),
+         src_id = block_find_copy_source(va_space, &search_mask, dst_id)) {
         uvm_page_mask_t *src_resident_mask = uvm_va_block_resident_mask_get(block, src_id);
         NV_STATUS status;
         NvU32 copied_pages_from_src;
@@ -3534,9 +3777,6 @@ static NV_STATUS block_copy_resident_pages(uvm_va_block_t *block,
         goto out;
 
     // TODO: Bug 1753731: Add P2P2P copies staged through a GPU
-    // TODO: Bug 1753731: When a page is resident in multiple locations due to
-    //       read-duplication, spread out the source of the copy so we don't
-    //       bottleneck on a single location.
 
     uvm_processor_mask_zero(&src_processor_mask);
 
@@ -3730,9 +3970,10 @@ static void block_make_resident_clear_evicted(uvm_va_block_t *va_block,
     uvm_va_block_gpu_state_t *dst_gpu_state = uvm_va_block_gpu_state_get(va_block, dst_id);
 
     UVM_ASSERT(dst_gpu_state);
+    UVM_ASSERT(dst_gpu_state->evicted);
 
-    if (!uvm_page_mask_andnot(&dst_gpu_state->evicted, &dst_gpu_state->evicted, page_mask))
-        uvm_processor_mask_clear(&va_block->evicted_gpus, dst_id);
+    uvm_page_mask_andnot(dst_gpu_state->evicted, dst_gpu_state->evicted, page_mask);
+    block_gpu_evicted_mask_collapse(va_block, dst_id);
 }
 
 static void block_make_resident_update_state(uvm_va_block_t *va_block,
@@ -3757,24 +3998,33 @@ static void block_make_resident_update_state(uvm_va_block_t *va_block,
     uvm_page_mask_andnot(&va_block->maybe_mapped_pages, &va_block->maybe_mapped_pages, copy_mask);
 
     // If we are migrating due to an eviction, set the GPU as evicted and
-    // mark the evicted pages. If we are migrating away from the CPU this
-    // means that those pages are not evicted.
+    // mark the evicted pages. If we are migrating to a GPU this means that
+    // those pages are not evicted from it.
     if (cause == UVM_MAKE_RESIDENT_CAUSE_EVICTION) {
         uvm_processor_id_t src_id;
 
-        UVM_ASSERT(UVM_ID_IS_CPU(dst_id));
-
-        // Note that the destination is the CPU so this loop excludes it.
+        // Evictions go to the CPU or to a peer of the evicted GPU, exclude
+        // the latter.
         for_each_gpu_id_in_mask(src_id, &va_block_context->make_resident.all_involved_processors) {
-            uvm_va_block_gpu_state_t *src_gpu_state = uvm_va_block_gpu_state_get(va_block, src_id);
+            uvm_va_block_gpu_state_t *src_gpu_state;
 
+            if (uvm_id_equal(src_id, dst_id))
+                continue;
+
+            src_gpu_state = uvm_va_block_gpu_state_get(va_block, src_id);
             UVM_ASSERT(src_gpu_state);
 
-            uvm_page_mask_or(&src_gpu_state->evicted, &src_gpu_state->evicted, copy_mask);
+            // Evicted pages are only tracked for the heuristics bringing them
+            // back, so they can be dropped if the mask can't be allocated.
+            if (block_gpu_evicted_mask_alloc(src_gpu_state) != NV_OK)
+                continue;
+
+            uvm_page_mask_or(src_gpu_state->evicted, src_gpu_state->evicted, copy_mask);
             uvm_processor_mask_set(&va_block->evicted_gpus, src_id);
         }
     }
-    else if (UVM_ID_IS_GPU(dst_id) && uvm_processor_mask_test(&va_block->evicted_gpus, dst_id))
+
+    if (UVM_ID_IS_GPU(dst_id) && uvm_processor_mask_test(&va_block->evicted_gpus, dst_id))
         block_make_resident_clear_evicted(va_block, dst_id, copy_mask);
 }
 
@@ -3848,6 +4098,26 @@ NV_STATUS uvm_va_block_make_resident(uvm_va_block_t *va_block,
     return NV_OK;
 }
 
+NV_STATUS uvm_va_block_populate_locked(uvm_va_block_t *va_block,
+                                       uvm_va_block_retry_t *va_block_retry,
+                                       uvm_va_block_context_t *va_block_context,
+                                       uvm_processor_id_t dest_id,
+                                       uvm_va_block_region_t region)
+{
+    NV_STATUS status;
+    NV_STATUS tracker_status;
+
+    uvm_assert_mutex_locked(&va_block->lock);
+    UVM_ASSERT(!uvm_va_block_is_hmm(va_block));
+
+    status = block_populate_pages(va_block, va_block_retry, va_block_context, dest_id, region, NULL);
+
+    // Order the zeroing of the new chunks before any later copy into them
+    tracker_status = uvm_tracker_add_tracker_safe(&va_block->tracker, &va_block_retry->tracker);
+
+    return status == NV_OK ? tracker_status : status;
+}
+
 // Combination function which prepares the input {region, page_mask} for
 // entering read-duplication. It:
 // - Unmaps all processors but revoke_id
@@ -3982,9 +4252,7 @@ NV_STATUS uvm_va_block_make_resident_read_duplicate(uvm_va_block_t *va_block,
     migrated_pages = &va_block_context->make_resident.pages_migrated;
     first_touch_mask = &va_block_context->scratch_page_mask;
     uvm_page_mask_init_from_region(first_touch_mask, region, page_mask);
-    uvm_page_mask_andnot(first_touch_mask, first_touch_mask, migrated_pages);
-
-    if (!uvm_page_mask_empty(first_touch_mask))
+    if (uvm_page_mask_andnot(first_touch_mask, first_touch_mask, migrated_pages))
         block_copy_set_first_touch_residency(va_block, va_block_context, dest_id, region, first_touch_mask);
 
     staged_pages = &va_block_context->make_resident.pages_staged;
@@ -5359,6 +5627,30 @@ static uvm_membar_t block_pte_op_membar(block_pte_op_t pte_op, uvm_gpu_t *gpu, u
     return uvm_hal_downgrade_membar_type(gpu, uvm_id_equal(gpu->id, resident_id));
 }
 
+// End a TLB batch which only contains upgrades when pte_op is MAP. Upgrades
+// are merged into block_context->mapping.deferred_tlb_batch, if there is one
+// for the same page tree: a stale TLB entry only grants less access than the
+// new PTE, so until the deferred batch is pushed an access can at worst fault
+// again.
+static void block_gpu_tlb_batch_end_upgrade(uvm_va_block_context_t *block_context,
+                                            uvm_tlb_batch_t *tlb_batch,
+                                            uvm_push_t *push,
+                                            block_pte_op_t pte_op,
+                                            uvm_membar_t tlb_membar)
+{
+    uvm_tlb_batch_t *deferred_tlb_batch = block_context->mapping.deferred_tlb_batch;
+
+    if (pte_op == BLOCK_PTE_OP_MAP &&
+        tlb_membar == UVM_MEMBAR_NONE &&
+        deferred_tlb_batch &&
+        deferred_tlb_batch->tree == tlb_batch->tree) {
+        uvm_tlb_batch_merge(deferred_tlb_batch, tlb_batch);
+        return;
+    }
+
+    uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+}
+
 // Write the 2M PTE for {block, gpu} to the memory on resident_id with new_prot
 // permissions. If the 2M entry is currently a PDE, it is first merged into a
 // PTE.
@@ -5380,12 +5672,13 @@ static void block_gpu_map_to_2m(uvm_va_block_t *block,
     uvm_pte_batch_t *pte_batch = &block_context->mapping.pte_batch;
     uvm_tlb_batch_t *tlb_batch = &block_context->mapping.tlb_batch;
     uvm_membar_t tlb_membar;
+    bool merged = !gpu_state->pte_is_2m;
 
     UVM_ASSERT(new_prot != UVM_PROT_NONE);
 
     // If we have a mix of big and 4k PTEs, we have to first merge them to an
     // invalid 2M PTE.
-    if (!gpu_state->pte_is_2m) {
+    if (merged) {
         block_gpu_pte_merge_2m(block, block_context, gpu, push, UVM_MEMBAR_NONE);
 
         gpu_state->pte_is_2m = true;
@@ -5400,8 +5693,13 @@ static void block_gpu_map_to_2m(uvm_va_block_t *block,
 
     uvm_pte_batch_end(pte_batch);
 
+    // If the PTEs were merged, pages which were mapped before are invalid
+    // until this invalidate, so it can't be deferred.
     tlb_membar = block_pte_op_membar(pte_op, gpu, resident_id);
-    uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+    if (merged)
+        uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+    else
+        block_gpu_tlb_batch_end_upgrade(block_context, tlb_batch, push, pte_op, tlb_membar);
 }
 
 // Combination split + map operation, called when only part of a 2M PTE mapping
@@ -5720,6 +6018,7 @@ static void block_gpu_map_big_and_4k(uvm_va_block_t *block,
     size_t big_page_index;
     NvU32 big_page_size = tree->big_page_size;
     uvm_membar_t tlb_membar = block_pte_op_membar(pte_op, gpu, resident_id);
+    bool unmapped_ptes;
 
     UVM_ASSERT(!gpu_state->pte_is_2m);
 
@@ -5799,6 +6098,7 @@ static void block_gpu_map_big_and_4k(uvm_va_block_t *block,
     }
 
     block_gpu_pte_clear_big(block, gpu, big_ptes_mask, tree->hal->unmapped_pte(big_page_size), pte_batch, tlb_batch);
+    unmapped_ptes = !bitmap_empty(big_ptes_mask, MAX_BIG_PAGES_PER_UVM_VA_BLOCK);
 
     // Case 3: Write the currently-big PTEs which remain big PTEs, and are
     // wholly changing permissions.
@@ -5829,12 +6129,18 @@ static void block_gpu_map_big_and_4k(uvm_va_block_t *block,
         // Remove uncovered big PTEs. We needed to merge them to unmapped above,
         // but they shouldn't get new_prot below.
         bitmap_and(big_ptes_merge, big_ptes_merge, new_pte_state->big_ptes_covered, MAX_BIG_PAGES_PER_UVM_VA_BLOCK);
+
+        unmapped_ptes = true;
     }
     else {
         // End the batches. We have to commit the membars and TLB invalidates
-        // before we finish splitting formerly-big PTEs.
+        // before we finish splitting formerly-big PTEs, unless none of the
+        // split big PTEs was valid.
         uvm_pte_batch_end(pte_batch);
-        uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+        if (unmapped_ptes)
+            uvm_tlb_batch_end(tlb_batch, push, tlb_membar);
+        else
+            block_gpu_tlb_batch_end_upgrade(block_context, tlb_batch, push, pte_op, tlb_membar);
     }
 
     if (!bitmap_empty(big_ptes_split, MAX_BIG_PAGES_PER_UVM_VA_BLOCK) ||
@@ -5860,7 +6166,13 @@ static void block_gpu_map_big_and_4k(uvm_va_block_t *block,
         if (block_gpu_needs_to_activate_table(block, gpu))
             block_gpu_write_pde(block, gpu, push, tlb_batch);
 
-        uvm_tlb_batch_end(tlb_batch, push, UVM_MEMBAR_NONE);
+        // Everything written in this step only replaces unmapped or invalid
+        // entries. Defer the invalidate unless those were written above over
+        // valid PTEs, as the pages they covered are inaccessible until then.
+        if (unmapped_ptes)
+            uvm_tlb_batch_end(tlb_batch, push, UVM_MEMBAR_NONE);
+        else
+            block_gpu_tlb_batch_end_upgrade(block_context, tlb_batch, push, pte_op, UVM_MEMBAR_NONE);
     }
 
     // Update gpu_state
@@ -6706,18 +7018,20 @@ NV_STATUS uvm_va_block_unmap(uvm_va_block_t *va_block,
     return block_unmap_gpu(va_block, va_block_context, block_get_gpu(va_block, id), region_page_mask, out_tracker);
 }
 
-// This function essentially works as a wrapper around vm_insert_page (hence
-// the similar function prototype). This is needed since vm_insert_page
-// doesn't take permissions as input, but uses vma->vm_page_prot instead.
-// Since we may have multiple VA blocks under one VMA which need to map
-// with different permissions, we have to manually change vma->vm_page_prot for
-// each call to vm_insert_page. Multiple faults under one VMA in separate
-// blocks can be serviced concurrently, so the VMA wrapper lock is used
-// to protect access to vma->vm_page_prot.
+// Maps the CPU page at addr to the physical page. Called with the block lock
+// held, so the mapping exists by the time any other processor can look at the
+// block's CPU mapping state again.
 static NV_STATUS uvm_cpu_insert_page(NvU64 addr,
                                      u64 page,
                                      uvm_prot_t new_prot)
 {
+    pageflags prot = pageflags_user(pageflags_noexec(pageflags_memory()));
+
+    if (new_prot >= UVM_PROT_READ_WRITE)
+        prot = pageflags_writable(prot);
+
+    map(addr, page, PAGE_SIZE, prot);
+
     return NV_OK;
 }
 
@@ -7703,7 +8017,8 @@ static void block_destroy_gpu_state(uvm_va_block_t *block, uvm_gpu_id_t id)
     block_gpu_unmap_phys_all_cpu_pages(block, gpu);
     uvm_processor_mask_clear(&block->evicted_gpus, id);
 
-    kmem_cache_free(g_uvm_va_block_gpu_state_cache, gpu_state);
+    uvm_kmem_cache_free(g_uvm_page_mask_cache, gpu_state->evicted);
+    uvm_kmem_cache_free(g_uvm_va_block_gpu_state_cache, gpu_state);
     block->gpus[uvm_id_gpu_index(id)] = NULL;
 }
 
@@ -8134,7 +8449,7 @@ void uvm_va_block_destroy(nv_kref_t *nv_kref)
     block_kill(block);
     uvm_mutex_unlock(&block->lock);
 
-    kmem_cache_free(g_uvm_va_block_cache, block);
+    uvm_kmem_cache_free(g_uvm_va_block_cache, block);
 }
 
 void uvm_va_block_kill(uvm_va_block_t *va_block)
@@ -8204,9 +8519,10 @@ void uvm_va_block_munmap_region(uvm_va_block_t *va_block,
         if (!gpu_state)
             continue;
 
-        uvm_page_mask_region_clear(&gpu_state->evicted, region);
-        if (uvm_page_mask_empty(&gpu_state->evicted))
-            uvm_processor_mask_clear(&va_block->evicted_gpus, gpu_id);
+        if (gpu_state->evicted) {
+            uvm_page_mask_region_clear(gpu_state->evicted, region);
+            block_gpu_evicted_mask_collapse(va_block, gpu_id);
+        }
 
         if (gpu_state->chunks) {
             block_gpu_release_region(va_block, gpu_id, gpu_state, NULL, region);
@@ -8842,6 +9158,13 @@ static NV_STATUS block_split_preallocate_no_retry(uvm_va_block_t *existing, uvm_
             status = NV_ERR_NO_MEMORY;
             goto error;
         }
+
+        // Some of the evicted pages may end up in new
+        if (uvm_va_block_gpu_state_get(existing, id)->evicted) {
+            status = block_gpu_evicted_mask_alloc(uvm_va_block_gpu_state_get(new, id));
+            if (status != NV_OK)
+                goto error;
+        }
     }
 
     block_test = uvm_va_block_get_test(existing);
@@ -8949,10 +9272,8 @@ static void block_set_processor_masks(uvm_va_block_t *block)
         else
             block_set_resident_processor(block, id);
 
-        if (uvm_page_mask_region_empty(&gpu_state->evicted, block_region))
-            uvm_processor_mask_clear(&block->evicted_gpus, id);
-        else
-            uvm_processor_mask_set(&block->evicted_gpus, id);
+        // Either half of a split block may be left without evicted pages
+        block_gpu_evicted_mask_collapse(block, id);
     }
 }
 
@@ -9303,7 +9624,10 @@ static void block_split_gpu(uvm_va_block_t *existing, uvm_va_block_t *new, uvm_g
         existing_gpu_state->activated_4k = false;
     }
 
-    block_split_page_mask(&existing_gpu_state->evicted, existing_pages, &new_gpu_state->evicted, new_pages);
+    if (existing_gpu_state->evicted) {
+        UVM_ASSERT(new_gpu_state->evicted);
+        block_split_page_mask(existing_gpu_state->evicted, existing_pages, new_gpu_state->evicted, new_pages);
+    }
 }
 
 NV_STATUS uvm_va_block_split(uvm_va_block_t *existing_va_block,
@@ -9957,8 +10281,9 @@ static bool map_remote_on_atomic_fault(uvm_va_space_t *va_space,
                                        uvm_processor_id_t processor_id,
                                        uvm_processor_id_t residency)
 {
-    // This policy can be enabled/disabled using a module parameter
-    if (!uvm_perf_map_remote_on_native_atomics_fault)
+    // This policy can be enabled/disabled using a module parameter, and
+    // overridden per VA space
+    if (!uvm_perf_tunable_get(&va_space->perf_tunables, UvmPerfTunableMapRemoteOnNativeAtomicsFault))
         return false;
 
     // Only consider atomics faults
@@ -10351,6 +10676,8 @@ NV_STATUS uvm_va_block_service_finish(uvm_processor_id_t processor_id,
                                           service_context->region,
                                           caller_page_mask);
 
+    block_mark_memory_accessed(va_block, new_residency);
+
     uvm_page_mask_andnot(&service_context->did_not_migrate_mask, new_residency_mask, did_migrate_mask);
 
     // The loops below depend on the enums having the following values in order
@@ -10754,6 +11081,77 @@ static bool skip_cpu_fault_with_valid_permissions(uvm_va_block_t *va_block,
     return false;
 }
 
+// Adds the pages around a CPU fault at page_index which are already resident
+// somewhere, but not mapped by the CPU, to the fault being serviced. They are
+// made resident on new_residency and mapped together with the faulting page,
+// so GPU-resident neighbors are migrated in the same copy push. Only pages
+// that a read fault of their own would also send to new_residency, without
+// read duplication or a thrashing hint, are added.
+//
+// The window is the uvm_perf_cpu_fault_around_size aligned range around the
+// fault, clamped to the block. Returns the region to service.
+static uvm_va_block_region_t block_cpu_fault_around(uvm_va_block_t *va_block,
+                                                    uvm_page_index_t page_index,
+                                                    uvm_processor_id_t new_residency,
+                                                    const uvm_va_policy_t *policy,
+                                                    uvm_service_block_context_t *service_context)
+{
+    uvm_va_space_t *va_space = uvm_va_block_get_va_space(va_block);
+    uvm_page_mask_t *new_residency_mask = &service_context->per_processor_masks[uvm_id_value(new_residency)].new_residency;
+    uvm_va_block_region_t region = uvm_va_block_region_for_page(page_index);
+    uvm_va_block_region_t window;
+    NvU64 size = uvm_perf_cpu_fault_around_size;
+    NvU64 start;
+    NvU64 end;
+    uvm_page_index_t i;
+
+    if (size <= PAGE_SIZE || uvm_va_block_is_hmm(va_block))
+        return region;
+
+    size = min(rounddown_pow_of_two(size), (NvU64)UVM_VA_BLOCK_SIZE);
+    start = UVM_ALIGN_DOWN(uvm_va_block_cpu_page_address(va_block, page_index), size);
+    end = start + size - 1;
+    window = uvm_va_block_region_from_start_end(va_block,
+                                                max(start, va_block->start),
+                                                min(end, va_block->end));
+
+    for_each_va_block_page_in_region(i, window) {
+        NvU64 addr = uvm_va_block_cpu_page_address(va_block, i);
+        uvm_perf_thrashing_hint_t thrashing_hint;
+        uvm_processor_id_t id;
+        bool read_duplicate;
+
+        if (i == page_index ||
+            uvm_page_mask_test(&va_block->cpu.pte_bits[UVM_PTE_BITS_CPU_READ], i) ||
+            uvm_va_block_page_resident_processors_count(va_block, i) == 0 ||
+            !uvm_range_group_address_migratable(va_space, addr))
+            continue;
+
+        thrashing_hint = uvm_perf_thrashing_get_hint(va_block, addr, UVM_ID_CPU);
+        if (thrashing_hint.type != UVM_PERF_THRASHING_HINT_TYPE_NONE)
+            continue;
+
+        id = uvm_va_block_select_residency(va_block,
+                                           &service_context->block_context,
+                                           i,
+                                           UVM_ID_CPU,
+                                           uvm_fault_access_type_mask_bit(UVM_FAULT_ACCESS_TYPE_READ),
+                                           policy,
+                                           &thrashing_hint,
+                                           UVM_SERVICE_OPERATION_REPLAYABLE_FAULTS,
+                                           &read_duplicate);
+        if (!uvm_id_equal(id, new_residency) || read_duplicate)
+            continue;
+
+        uvm_page_mask_set(new_residency_mask, i);
+        service_context->access_type[i] = UVM_FAULT_ACCESS_TYPE_READ;
+        region.first = min(region.first, i);
+        region.outer = max(region.outer, i + 1);
+    }
+
+    return region;
+}
+
 static NV_STATUS block_cpu_fault_locked(uvm_va_block_t *va_block,
                                         uvm_va_block_retry_t *va_block_retry,
                                         NvU64 fault_addr,
@@ -10850,6 +11248,9 @@ static NV_STATUS block_cpu_fault_locked(uvm_va_block_t *va_block,
 
     service_context->region = uvm_va_block_region_for_page(page_index);
 
+    if (!read_duplicate && thrashing_hint.type == UVM_PERF_THRASHING_HINT_TYPE_NONE)
+        service_context->region = block_cpu_fault_around(va_block, page_index, new_residency, policy, service_context);
+
     status = uvm_va_block_service_locked(UVM_ID_CPU, va_block, va_block_retry, service_context);
 
     ++service_context->num_retries;
@@ -11344,7 +11745,7 @@ static void block_add_eviction_mappings(void *args)
                                                                            block_context,
                                                                            id,
                                                                            uvm_va_block_region_from_block(va_block),
-                                                                           &gpu_state->evicted,
+                                                                           block_evicted_mask_get(va_block, id),
                                                                            UvmEventMapRemoteCauseEviction));
                 if (status != NV_OK)
                     break;
@@ -11373,6 +11774,127 @@ static void block_add_eviction_mappings_entry(void *args)
     UVM_ENTRY_VOID(block_add_eviction_mappings(args));
 }
 
+// Pick the NVLink peer of gpu with the most free vidmem to evict the given
+// pages of the block to, or return NULL to evict them to sysmem.
+//
+// The VA space lock isn't held on the eviction path, so the VA space masks are
+// read racily. This is safe: NVLink peer access is only disabled when one of
+// the GPUs is unregistered from the VA space, and the unregistration marks the
+// GPU in gpu_unregister_in_progress before walking all the blocks with their
+// lock held. Not seeing the mark with the block lock held means the walk will
+// reach this block later, and tear down the state created here. Enabling
+// indirect peers also walks the blocks after updating the mask, so peers with
+// indirect peers are skipped for the same reason, as their chunks would need
+// mappings which can't be created here.
+static uvm_gpu_t *block_evict_pick_peer(uvm_va_block_t *va_block,
+                                        uvm_va_space_t *va_space,
+                                        uvm_gpu_t *gpu,
+                                        const uvm_page_mask_t *pages_to_evict)
+{
+    uvm_processor_mask_t candidates;
+    uvm_gpu_t *best_peer = NULL;
+    uvm_gpu_id_t peer_id;
+    NvU64 best_free = 0;
+    NvU64 size;
+
+    if (!uvm_perf_evict_to_peer || g_uvm_global.conf_computing_enabled)
+        return NULL;
+
+    // UVM-Lite GPUs only map the preferred location, don't move the pages
+    // anywhere else
+    if (!uvm_processor_mask_empty(block_get_uvm_lite_gpus(va_block)))
+        return NULL;
+
+    if (uvm_processor_mask_test(&va_space->gpu_unregister_in_progress, gpu->id))
+        return NULL;
+
+    // The peers need to be able to map the pages and copy them from gpu
+    uvm_processor_mask_and(&candidates,
+                           &va_space->has_nvlink[uvm_id_value(gpu->id)],
+                           &va_space->can_access[uvm_id_value(gpu->id)]);
+    uvm_processor_mask_andnot(&candidates, &candidates, &va_space->gpu_unregister_in_progress);
+    uvm_processor_mask_clear(&candidates, UVM_ID_CPU);
+
+    // Round up to whole root chunks, which is what the peer may end up
+    // allocating
+    size = UVM_ALIGN_UP((NvU64)uvm_page_mask_weight(pages_to_evict) * PAGE_SIZE, UVM_CHUNK_SIZE_MAX);
+
+    for_each_gpu_id_in_mask(peer_id, &candidates) {
+        uvm_gpu_t *peer = uvm_va_space_get_gpu(va_space, peer_id);
+        NvU64 free;
+
+        if (!uvm_processor_mask_test(&va_space->can_copy_from[uvm_id_value(peer_id)], gpu->id))
+            continue;
+
+        if (!uvm_processor_mask_empty(&va_space->indirect_peers[uvm_id_value(peer_id)]))
+            continue;
+
+        if (!block_processor_has_memory(va_block, peer_id))
+            continue;
+
+        free = uvm_pmm_gpu_free_memory(&peer->pmm);
+        if (free < size + UVM_EVICT_TO_PEER_MIN_FREE || free <= best_free)
+            continue;
+
+        best_peer = peer;
+        best_free = free;
+    }
+
+    return best_peer;
+}
+
+static NV_STATUS block_evict_to_peer(uvm_va_block_t *va_block,
+                                     uvm_va_block_context_t *block_context,
+                                     uvm_gpu_t *peer,
+                                     const uvm_page_mask_t *pages_to_evict)
+{
+    uvm_va_block_retry_t va_block_retry;
+    NV_STATUS status;
+
+    uvm_va_block_retry_init(&va_block_retry);
+    va_block_retry.in_eviction = true;
+
+    status = uvm_va_block_make_resident(va_block,
+                                        &va_block_retry,
+                                        block_context,
+                                        peer->id,
+                                        uvm_va_block_region_from_block(va_block),
+                                        pages_to_evict,
+                                        NULL,
+                                        UVM_MAKE_RESIDENT_CAUSE_EVICTION);
+
+    uvm_va_block_retry_deinit(&va_block_retry, va_block);
+
+    return status;
+}
+
+// Drop the data of the given pages resident on the GPU rather than moving it.
+// This is only done for blocks of VA spaces being torn down, which nothing can
+// access anymore. All processors are unmapped from the whole block, as the
+// block is about to be destroyed anyway and unmapping it whole never requires
+// splitting PTEs.
+static NV_STATUS block_evict_discard(uvm_va_block_t *va_block,
+                                     uvm_va_block_context_t *block_context,
+                                     uvm_gpu_t *gpu,
+                                     const uvm_page_mask_t *pages_to_evict)
+{
+    uvm_page_mask_t *resident_mask = uvm_va_block_resident_mask_get(va_block, gpu->id);
+    NV_STATUS status;
+
+    status = uvm_va_block_unmap_mask(va_block,
+                                     block_context,
+                                     &va_block->mapped,
+                                     uvm_va_block_region_from_block(va_block),
+                                     NULL);
+    if (status != NV_OK)
+        return status;
+
+    if (!uvm_page_mask_andnot(resident_mask, resident_mask, pages_to_evict))
+        block_clear_resident_processor(va_block, gpu->id);
+
+    return NV_OK;
+}
+
 NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
                                     uvm_gpu_t *gpu,
                                     uvm_gpu_chunk_t *root_chunk,
@@ -11455,21 +11977,37 @@ NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
                                                uvm_va_block_region_from_block(va_block),
                                                &accessed_by_set);
     }
+    else if (UVM_READ_ONCE(va_space->discard_on_eviction)) {
+        status = block_evict_discard(va_block, block_context, gpu, pages_to_evict);
+    }
     else {
         const uvm_va_policy_t *policy = uvm_va_range_get_policy(va_block->va_range);
+        uvm_gpu_t *peer = block_evict_pick_peer(va_block, va_space, gpu, pages_to_evict);
+
         accessed_by_set = uvm_processor_mask_get_count(&policy->accessed_by) > 0;
 
-        // TODO: Bug 1765193: make_resident() breaks read-duplication, but it's
-        // not necessary to do so for eviction. Add a version that unmaps only
-        // the processors that have mappings to the pages being evicted.
-        status = uvm_va_block_make_resident(va_block,
-                                            NULL,
-                                            block_context,
-                                            UVM_ID_CPU,
-                                            uvm_va_block_region_from_block(va_block),
-                                            pages_to_evict,
-                                            NULL,
-                                            UVM_MAKE_RESIDENT_CAUSE_EVICTION);
+        // Peer memory is the first tier, fall back to sysmem if the peer runs
+        // out of free memory or the copy fails. Pages already moved to the
+        // peer are then moved on to the CPU.
+        if (peer)
+            status = block_evict_to_peer(va_block, block_context, peer, pages_to_evict);
+
+        if (!peer || status != NV_OK) {
+            uvm_processor_mask_zero(&block_context->make_resident.all_involved_processors);
+
+            // TODO: Bug 1765193: make_resident() breaks read-duplication, but
+            // it's not necessary to do so for eviction. Add a version that
+            // unmaps only the processors that have mappings to the pages being
+            // evicted.
+            status = uvm_va_block_make_resident(va_block,
+                                                NULL,
+                                                block_context,
+                                                UVM_ID_CPU,
+                                                uvm_va_block_region_from_block(va_block),
+                                                pages_to_evict,
+                                                NULL,
+                                                UVM_MAKE_RESIDENT_CAUSE_EVICTION);
+        }
     }
     if (status != NV_OK)
         goto out;
@@ -11496,7 +12034,10 @@ NV_STATUS uvm_va_block_evict_chunks(uvm_va_block_t *va_block,
     // without holding the VA space lock. However, this is fine as
     // block_add_eviction_mappings() reexamines the value with the VA space
     // lock being held.
-    if (accessed_by_set || (gpu->parent->access_counters_supported && uvm_va_space_map_remote_on_eviction(va_space))) {
+    //
+    // Blocks of VA spaces being torn down don't get any new mappings.
+    if (!UVM_READ_ONCE(va_space->discard_on_eviction) &&
+        (accessed_by_set || (gpu->parent->access_counters_supported && uvm_va_space_map_remote_on_eviction(va_space)))) {
         // Always retain the VA block first so that it's safe for the deferred
         // callback to release it immediately after it runs.
         uvm_va_block_retain(va_block);
@@ -105,8 +105,13 @@ typedef struct
     // physical GPU memory is tracked by an array of GPU chunks below.
     uvm_page_mask_t resident;
 
-    // Pages that have been evicted to sysmem
-    uvm_page_mask_t evicted;
+    // Pages that have been evicted to sysmem or to a peer GPU.
+    //
+    // Most blocks never have evicted pages, so the mask is only allocated
+    // when the GPU gets pages evicted in the block and freed again once none
+    // are left. A NULL mask means no evicted pages. The mask is never NULL
+    // when the GPU is set in uvm_va_block_t::evicted_gpus.
+    uvm_page_mask_t *evicted;
 
     NvU64 *cpu_chunks_dma_addrs;
 
@@ -552,6 +557,11 @@ struct uvm_va_block_retry_struct
     // can contain chunks from multiple GPUs. All the used chunks are unpinned
     // when the operation is finished with uvm_va_block_retry_deinit().
     struct list used_chunks;
+
+    // Set when the block operation is part of evicting memory of another GPU.
+    // GPU allocations then fail with NV_ERR_NO_MEMORY rather than evicting in
+    // turn, and the VA space lock is not held.
+    bool in_eviction;
 };
 
 // Module load/exit
@@ -675,6 +685,7 @@ static void uvm_va_block_context_init(uvm_va_block_context_t *va_block_context,
         memset(va_block_context, 0xff, sizeof(*va_block_context));
 
     va_block_context->mm = mm;
+    va_block_context->mapping.deferred_tlb_batch = NULL;
 }
 
 // TODO: Bug 1766480: Using only page masks instead of a combination of regions
@@ -746,6 +757,24 @@ NV_STATUS uvm_va_block_make_resident(uvm_va_block_t *va_block,
                                      const uvm_page_mask_t *prefetch_page_mask,
                                      uvm_make_resident_cause_t cause);
 
+// Allocate dest_id memory for all the pages in region that are not resident
+// on dest_id, without copying anything or changing residency. A later
+// uvm_va_block_make_resident to dest_id uses the populated memory. This lets
+// callers reserve the destination of large migrations before pushing any
+// copy.
+//
+// Allocation-retry: same as uvm_va_block_make_resident. va_block_retry must
+// not be NULL.
+//
+// Only managed va_blocks are supported.
+//
+// LOCKING: The caller must hold the va_block lock.
+NV_STATUS uvm_va_block_populate_locked(uvm_va_block_t *va_block,
+                                       uvm_va_block_retry_t *va_block_retry,
+                                       uvm_va_block_context_t *va_block_context,
+                                       uvm_processor_id_t dest_id,
+                                       uvm_va_block_region_t region);
+
 // Similar to uvm_va_block_make_resident (read documentation there). The main
 // differences are:
 // - Pages are copied not moved (i.e. other copies of the page are not
@@ -1699,12 +1728,7 @@ static bool uvm_page_mask_region_test(const uvm_page_mask_t *mask,
 
 static NvU32 uvm_page_mask_region_weight(const uvm_page_mask_t *mask, uvm_va_block_region_t region)
 {
-    NvU32 weight_before = 0;
-
-    if (region.first > 0)
-        weight_before = bitmap_weight(mask->bitmap, region.first);
-
-    return bitmap_weight(mask->bitmap, region.outer) - weight_before;
+    return bitmap_weight_range(mask->bitmap, region.first, region.outer);
 }
 
 static bool uvm_page_mask_region_empty(const uvm_page_mask_t *mask, uvm_va_block_region_t region)
@@ -1760,6 +1784,22 @@ static bool uvm_page_mask_andnot(uvm_page_mask_t *mask_out, const uvm_page_mask_
     return bitmap_andnot(mask_out->bitmap, mask_in1->bitmap, mask_in2->bitmap, PAGES_PER_UVM_VA_BLOCK);
 }
 
+// Same as uvm_page_mask_and and uvm_page_mask_andnot, but return the weight
+// of mask_out computed in the same pass
+static NvU32 uvm_page_mask_and_weight(uvm_page_mask_t *mask_out,
+                                      const uvm_page_mask_t *mask_in1,
+                                      const uvm_page_mask_t *mask_in2)
+{
+    return bitmap_and_weight(mask_out->bitmap, mask_in1->bitmap, mask_in2->bitmap, PAGES_PER_UVM_VA_BLOCK);
+}
+
+static NvU32 uvm_page_mask_andnot_weight(uvm_page_mask_t *mask_out,
+                                         const uvm_page_mask_t *mask_in1,
+                                         const uvm_page_mask_t *mask_in2)
+{
+    return bitmap_andnot_weight(mask_out->bitmap, mask_in1->bitmap, mask_in2->bitmap, PAGES_PER_UVM_VA_BLOCK);
+}
+
 static void uvm_page_mask_or(uvm_page_mask_t *mask_out, const uvm_page_mask_t *mask_in1, const uvm_page_mask_t *mask_in2)
 {
     bitmap_or(mask_out->bitmap, mask_in1->bitmap, mask_in2->bitmap, PAGES_PER_UVM_VA_BLOCK);
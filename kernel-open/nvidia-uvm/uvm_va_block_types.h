@@ -210,6 +210,13 @@ typedef struct
         uvm_pte_batch_t pte_batch;
         uvm_tlb_batch_t tlb_batch;
 
+        // If not NULL, the TLB invalidates of permission upgrades (MAP) on
+        // the page tree of this batch are merged into it instead of being
+        // pushed with the PTE writes. The caller that set it is responsible
+        // for pushing the batch, ordered after the PTE writes, before any
+        // processor relies on the new mappings, and for resetting it to NULL.
+        uvm_tlb_batch_t *deferred_tlb_batch;
+
         // Event that triggered the call to the mapping function
         UvmEventMapRemoteCause cause;
     } mapping;
@@ -58,6 +58,11 @@ struct uvm_va_policy_struct
     // Read duplication policy for this VA range (unset, enabled, or disabled).
     uvm_read_duplication_policy_t read_duplication;
 
+    // True if read_duplication was set to UVM_READ_DUPLICATION_ENABLED by the
+    // read-mostly detection of the thrashing module instead of by the user.
+    // Only used by managed allocations.
+    bool read_duplication_auto;
+
     // Processor ID of the preferred location for this VA range.
     // This is set to UVM_ID_INVALID if no preferred location is set.
     uvm_processor_id_t preferred_location;
@@ -187,6 +187,7 @@ NV_STATUS uvm_va_range_create_mmap(uvm_va_space_t *va_space,
     NV_STATUS status;
     vmap vma = vma_wrapper->vma;
     uvm_va_range_t *va_range = NULL;
+    uvm_gpu_va_space_t *gpu_va_space;
 
     // Check for no overlap with HMM blocks.
     status = uvm_hmm_va_block_reclaim(va_space, mm, vma->node.r.start, vma->node.r.end - 1);
@@ -206,6 +207,9 @@ NV_STATUS uvm_va_range_create_mmap(uvm_va_space_t *va_space,
     if (status != NV_OK)
         goto error;
 
+    for_each_gpu_va_space(gpu_va_space, va_space)
+        uvm_gpu_va_space_prepopulate_ptes(gpu_va_space, va_range->node.start, va_range->node.end);
+
     if (out_va_range)
         *out_va_range = va_range;
 
@@ -603,6 +607,8 @@ static NV_STATUS va_range_add_gpu_va_space_managed(uvm_va_range_t *va_range,
         uvm_va_range_get_policy(va_range)->read_duplication == UVM_READ_DUPLICATION_ENABLED &&
         (uvm_va_space_can_read_duplicate(va_space, NULL) != uvm_va_space_can_read_duplicate(va_space, gpu));
 
+    uvm_gpu_va_space_prepopulate_ptes(gpu_va_space, va_range->node.start, va_range->node.end);
+
     // Combine conditions to perform a single VA block traversal
     if (gpu_va_space->ats.enabled || should_add_remote_mappings || should_disable_read_duplication) {
         uvm_va_block_t *va_block;
@@ -1166,6 +1172,7 @@ NV_STATUS uvm_va_range_split(uvm_va_range_t *existing_va_range,
     // Copy over state before splitting blocks so any block lookups happening
     // concurrently on the eviction path will see the new range's data.
     uvm_va_range_get_policy(new)->read_duplication = uvm_va_range_get_policy(existing_va_range)->read_duplication;
+    uvm_va_range_get_policy(new)->read_duplication_auto = uvm_va_range_get_policy(existing_va_range)->read_duplication_auto;
     uvm_va_range_get_policy(new)->preferred_location = uvm_va_range_get_policy(existing_va_range)->preferred_location;
     uvm_processor_mask_copy(&uvm_va_range_get_policy(new)->accessed_by,
                             &uvm_va_range_get_policy(existing_va_range)->accessed_by);
@@ -121,6 +121,9 @@ typedef struct
     vmap vma;
 
     uvm_rw_semaphore_t lock;
+
+    // CPU fault handler installed on the vma, see uvm_vm_fault()
+    closure_struct(vmap_fault, fault);
 } uvm_vma_wrapper_t;
 
 // TODO: Bug 1733295. VA range types should really be inverted. Instead of
@@ -132,6 +135,30 @@ typedef struct
 //       which really belongs in the per-type structs (for example, blocks).
 //       We're deferring that cleanup to the full refactor.
 
+// Access history of a managed va_range used by the thrashing module to detect
+// read-mostly ranges and enable read duplication on them automatically. It is
+// updated from fault servicing with the VA space lock held in read mode, so
+// the counters are only approximate.
+typedef struct
+{
+    // Processors that faulted on the range, or had pages migrated to them by
+    // access counters, during the current window
+    uvm_processor_mask_t accessors;
+
+    atomic_t num_reads;
+    atomic_t num_writes;
+
+    // Time stamp of the start of the current window
+    NvU64 window_start;
+
+    // Read duplication is not enabled automatically again before this time
+    // stamp after being reverted
+    NvU64 hold_off_until;
+
+    // Policy change requested to the thrashing module worker, if any
+    atomic_t pending_flip;
+} uvm_va_range_read_mostly_t;
+
 // va_range state when va_range.type == UVM_VA_RANGE_TYPE_MANAGED
 typedef struct
 {
@@ -146,6 +173,8 @@ typedef struct
     uvm_va_policy_t policy;
 
     uvm_perf_module_data_desc_t perf_modules_data[UVM_PERF_MODULE_TYPE_COUNT];
+
+    uvm_va_range_read_mostly_t read_mostly;
 } uvm_va_range_managed_t;
 
 typedef struct
@@ -41,6 +41,13 @@
 #include "nv_uvm_interface.h"
 #include "nv-kthread-q.h"
 
+// Use a reader-biased lock with per-CPU reader counts for the VA space lock.
+// Read acquisitions from the fault, migration and mapping paths then don't
+// contend on a shared cache line, at the cost of writers having to drain the
+// counts of all CPUs.
+static unsigned uvm_va_space_lock_percpu_readers = 1;
+module_param(uvm_va_space_lock_percpu_readers, uint, S_IRUGO);
+
 static bool processor_mask_array_test(const uvm_processor_mask_t *mask,
                                       uvm_processor_id_t mask_id,
                                       uvm_processor_id_t id)
@@ -174,11 +181,22 @@ NV_STATUS uvm_va_space_create(uvm_va_space_t **va_space_ptr, NvU64 flags)
         return NV_ERR_INVALID_ARGUMENT;
     }
 
-    uvm_init_rwsem(&va_space->lock, UVM_LOCK_ORDER_VA_SPACE);
+    if (uvm_va_space_lock_percpu_readers) {
+        status = uvm_init_rwsem_percpu(&va_space->lock, UVM_LOCK_ORDER_VA_SPACE);
+        if (status != NV_OK) {
+            uvm_kvfree(va_space);
+            return status;
+        }
+    }
+    else {
+        uvm_init_rwsem(&va_space->lock, UVM_LOCK_ORDER_VA_SPACE);
+    }
+
     uvm_mutex_init(&va_space->serialize_writers_lock, UVM_LOCK_ORDER_VA_SPACE_SERIALIZE_WRITERS);
     uvm_mutex_init(&va_space->read_acquire_write_release_lock,
                    UVM_LOCK_ORDER_VA_SPACE_READ_ACQUIRE_WRITE_RELEASE_LOCK);
     uvm_spin_lock_init(&va_space->va_space_mm.lock, UVM_LOCK_ORDER_LEAF);
+    uvm_perf_prefetch_streams_init(&va_space->prefetch_streams);
     uvm_range_tree_init(&va_space->va_range_tree);
     uvm_ats_init_va_space(va_space);
 
@@ -217,6 +235,8 @@ NV_STATUS uvm_va_space_create(uvm_va_space_t **va_space_ptr, NvU64 flags)
 
     va_space->test.page_prefetch_enabled = true;
 
+    uvm_perf_tunables_init_va_space(&va_space->perf_tunables);
+
     init_tools_data(va_space);
 
     uvm_va_space_down_write(va_space);
@@ -264,6 +284,7 @@ fail:
     uvm_va_space_mm_unregister(va_space);
 
 table_fail:
+    uvm_deinit_rwsem(&va_space->lock);
     uvm_kvfree(va_space);
 
     return status;
@@ -440,6 +461,8 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
     // registered GPUs in the VA space, so those faults will be canceled.
     uvm_va_space_down_write(va_space);
 
+    UVM_WRITE_ONCE(va_space->discard_on_eviction, true);
+
     uvm_va_space_global_gpus(va_space, &retained_gpus);
 
     bitmap_copy(va_space->enabled_peers_teardown, va_space->enabled_peers, UVM_MAX_UNIQUE_GPU_PAIRS);
@@ -563,6 +586,7 @@ void uvm_va_space_destroy(uvm_va_space_t *va_space)
     uvm_mutex_unlock(&g_uvm_global.global_lock);
 
     deallocate_table(va_space->range_groups);
+    uvm_deinit_rwsem(&va_space->lock);
     uvm_kvfree(va_space);
 }
 
@@ -1149,6 +1173,116 @@ void uvm_gpu_va_space_unset_page_dir(uvm_gpu_va_space_t *gpu_va_space)
     }
 }
 
+// Largest VA range, in MiB, whose page directories are pre-populated when it
+// is created or when a GPU VA space is registered. Each GB of VA needs a
+// directory for its 2M entries. 0 disables pre-population.
+static unsigned uvm_page_table_prepopulate_max_mb = 0;
+module_param(uvm_page_table_prepopulate_max_mb, uint, S_IRUGO);
+
+typedef struct
+{
+    uvm_range_tree_node_t node;
+
+    // 2M PTE ranges reference all the directories above the 2M entries. The
+    // 2M entries themselves are left to the VA blocks.
+    uvm_page_table_range_vec_t range_vec;
+} gpu_va_space_prepopulated_ptes_t;
+
+static NV_STATUS gpu_va_space_prepopulate_hole(uvm_gpu_va_space_t *gpu_va_space, NvU64 start, NvU64 end)
+{
+    NV_STATUS status;
+    gpu_va_space_prepopulated_ptes_t *prepopulated;
+
+    prepopulated = uvm_kvmalloc_zero(sizeof(*prepopulated));
+    if (!prepopulated)
+        return NV_ERR_NO_MEMORY;
+
+    // Pre-population must not evict user memory
+    status = uvm_page_table_range_vec_init(&gpu_va_space->page_tables,
+                                           start,
+                                           end - start + 1,
+                                           UVM_PAGE_SIZE_2M,
+                                           UVM_PMM_ALLOC_FLAGS_NONE,
+                                           &prepopulated->range_vec);
+    if (status != NV_OK) {
+        uvm_kvfree(prepopulated);
+        return status;
+    }
+
+    prepopulated->node.start = start;
+    prepopulated->node.end = end;
+    status = uvm_range_tree_add(&gpu_va_space->prepopulated_ptes, &prepopulated->node);
+    UVM_ASSERT(status == NV_OK);
+
+    return NV_OK;
+}
+
+void uvm_gpu_va_space_prepopulate_ptes(uvm_gpu_va_space_t *gpu_va_space, NvU64 start, NvU64 end)
+{
+    uvm_page_tree_t *tree = &gpu_va_space->page_tables;
+    NvU64 addr;
+
+    uvm_assert_rwsem_locked_write(&gpu_va_space->va_space->lock);
+
+    if (uvm_page_table_prepopulate_max_mb == 0)
+        return;
+
+    // On ATS systems the presence of GMMU PDEs changes how the GPU translates
+    // the range, see block_pre_populate_pde1_gpu
+    if (gpu_va_space->ats.enabled)
+        return;
+
+    if (!(tree->hal->page_sizes() & UVM_PAGE_SIZE_2M))
+        return;
+
+    if (end - start + 1 > (NvU64)uvm_page_table_prepopulate_max_mb * 1024 * 1024)
+        return;
+
+    start = UVM_ALIGN_DOWN(start, UVM_PAGE_SIZE_2M);
+    end = UVM_ALIGN_UP(end + 1, UVM_PAGE_SIZE_2M) - 1;
+
+    if (!uvm_gpu_can_address(gpu_va_space->gpu, start, end - start + 1))
+        return;
+
+    // Only pre-populate the parts of the range which aren't yet. Parts pre-
+    // populated for a VA range which has since been destroyed are reused.
+    for (addr = start; addr <= end;) {
+        uvm_range_tree_node_t *node = uvm_range_tree_find(&gpu_va_space->prepopulated_ptes, addr);
+        NvU64 hole_start = addr;
+        NvU64 hole_end = end;
+        NV_STATUS status;
+
+        if (node) {
+            addr = node->end + 1;
+            continue;
+        }
+
+        status = uvm_range_tree_find_hole_in(&gpu_va_space->prepopulated_ptes, addr, &hole_start, &hole_end);
+        UVM_ASSERT(status == NV_OK);
+
+        if (gpu_va_space_prepopulate_hole(gpu_va_space, hole_start, hole_end) != NV_OK)
+            break;
+
+        addr = hole_end + 1;
+    }
+
+    // Replace the pool entries used by the directories
+    uvm_mmu_page_table_pool_refill(gpu_va_space->gpu);
+}
+
+static void gpu_va_space_release_prepopulated_ptes(uvm_gpu_va_space_t *gpu_va_space)
+{
+    uvm_range_tree_node_t *node, *next;
+
+    uvm_range_tree_for_each_safe(node, next, &gpu_va_space->prepopulated_ptes) {
+        gpu_va_space_prepopulated_ptes_t *prepopulated = container_of(node, gpu_va_space_prepopulated_ptes_t, node);
+
+        uvm_range_tree_remove(&gpu_va_space->prepopulated_ptes, node);
+        uvm_page_table_range_vec_deinit(&prepopulated->range_vec);
+        uvm_kvfree(prepopulated);
+    }
+}
+
 static void destroy_gpu_va_space(uvm_gpu_va_space_t *gpu_va_space)
 {
     NvU64 delay_us = 0;
@@ -1188,8 +1322,10 @@ static void destroy_gpu_va_space(uvm_gpu_va_space_t *gpu_va_space)
     if (state != UVM_GPU_VA_SPACE_STATE_INIT)
         uvm_va_space_up_read_rm(va_space);
 
-    if (gpu_va_space->page_tables.root)
+    if (gpu_va_space->page_tables.root) {
+        gpu_va_space_release_prepopulated_ptes(gpu_va_space);
         uvm_page_tree_deinit(&gpu_va_space->page_tables);
+    }
 
     if (gpu_va_space->duped_gpu_va_space)
         uvm_rm_locked_call_void(nvUvmInterfaceAddressSpaceDestroy(gpu_va_space->duped_gpu_va_space));
@@ -1233,6 +1369,7 @@ static NV_STATUS create_gpu_va_space(uvm_gpu_t *gpu,
     gpu_va_space->va_space = va_space;
     INIT_LIST_HEAD(&gpu_va_space->registered_channels);
     INIT_LIST_HEAD(&gpu_va_space->channel_va_ranges);
+    uvm_range_tree_init(&gpu_va_space->prepopulated_ptes);
     nv_kref_init(&gpu_va_space->kref);
 
     // TODO: Bug 1624521: This interface needs to use rm_control_fd to do
@@ -1293,6 +1430,10 @@ static NV_STATUS create_gpu_va_space(uvm_gpu_t *gpu,
     if (status != NV_OK)
         goto error;
 
+    // Registration is off the fault path, top up the page table pool for the
+    // first faults in this GPU VA space
+    uvm_mmu_page_table_pool_refill(gpu);
+
     *out_gpu_va_space = gpu_va_space;
     return NV_OK;
 
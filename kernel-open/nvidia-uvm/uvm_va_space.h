@@ -37,6 +37,7 @@
 #include "nv-nanos.h"
 #include "uvm_perf_events.h"
 #include "uvm_perf_module.h"
+#include "uvm_perf_tunables.h"
 #include "uvm_va_block_types.h"
 #include "uvm_va_block.h"
 #include "uvm_hmm.h"
@@ -136,6 +137,11 @@ struct uvm_gpu_va_space_struct
 
     // ATS specific state
     uvm_ats_gpu_va_space_t ats;
+
+    // VA ranges of page_tables whose page directories, down to the ones
+    // holding the 2M entries, are referenced ahead of the first fault. See
+    // uvm_gpu_va_space_prepopulate_ptes(). Protected by the VA space lock.
+    uvm_range_tree_t prepopulated_ptes;
 };
 
 typedef struct
@@ -294,6 +300,12 @@ struct uvm_va_space_struct
     // Per-va_space event notification information for performance heuristics
     uvm_perf_va_space_events_t perf_events;
 
+    // Access streams detected by the prefetcher across VA blocks
+    uvm_perf_prefetch_streams_t prefetch_streams;
+
+    // Values of the performance heuristics tunables for this VA space
+    uvm_perf_tunables_t perf_tunables;
+
     uvm_perf_module_data_desc_t perf_modules_data[UVM_PERF_MODULE_TYPE_COUNT];
 
     // Array of modules that are loaded in the va_space, indexed by module type
@@ -327,6 +339,12 @@ struct uvm_va_space_struct
 
     bool user_channel_stops_are_immediate;
 
+    // Set when the VA space starts being torn down, with its lock held in
+    // write mode and all of its channels stopped. Nothing can access the VA
+    // space's memory anymore, so eviction drops the data of its blocks instead
+    // of copying it out. Read without the VA space lock on the eviction path.
+    bool discard_on_eviction;
+
     // Block context used for GPU unmap operations so that allocation is not
     // required on the teardown path. This can only be used while the VA space
     // lock is held in write mode. Access using uvm_va_space_block_context().
@@ -591,6 +609,16 @@ void uvm_gpu_va_space_release(uvm_gpu_va_space_t *gpu_va_space);
 // Wrapper for nvUvmInterfaceUnsetPageDirectory
 void uvm_gpu_va_space_unset_page_dir(uvm_gpu_va_space_t *gpu_va_space);
 
+// Allocate the page directories of gpu_va_space down to the ones holding the
+// 2M entries covering [start, end], so that the first faults in the range only
+// have to allocate the lowest level page tables. This is a no-op unless the
+// uvm_page_table_prepopulate_max_mb module parameter is set, and it is best
+// effort: failures are ignored. The directories stay allocated until the GPU
+// VA space is destroyed.
+//
+// LOCKING: The caller must hold the VA space lock in write mode.
+void uvm_gpu_va_space_prepopulate_ptes(uvm_gpu_va_space_t *gpu_va_space, NvU64 start, NvU64 end);
+
 static uvm_gpu_va_space_state_t uvm_gpu_va_space_state(uvm_gpu_va_space_t *gpu_va_space)
 {
     UVM_ASSERT(gpu_va_space->gpu);
@@ -122,6 +122,8 @@ void uvm_hal_volta_ce_memcopy(uvm_push_t *push, uvm_gpu_address_t dst, uvm_gpu_a
 
     gpu->parent->ce_hal->memcopy_patch_src(push, &src);
 
+    push->copy_bytes += size;
+
     launch_dma_src_dst_type = gpu->parent->ce_hal->phys_mode(push, dst, src);
     launch_dma_plc_mode = gpu->parent->ce_hal->plc_mode();
 
@@ -27,6 +27,7 @@
 #ifdef USE_LKCA
 #define BUFFER_SIZE (2 * 1024 * 1024)
 #define AUTH_TAG_SIZE 16
+#define MAX_KEY_SIZE 32
 struct lkca_aead_ctx
 {
     struct crypto_aead *aead;
@@ -35,6 +36,12 @@ struct lkca_aead_ctx
     char *in_buffer;
     char *out_buffer;
     char tag[AUTH_TAG_SIZE];
+
+    // Key last programmed into aead. Callers such as CCSL use the same key
+    // for every message until it is rotated, so setting it (and expanding
+    // the key schedule) again is skipped while it doesn't change.
+    uint8_t key[MAX_KEY_SIZE];
+    size_t key_size;
 };
 #endif
 
@@ -103,6 +110,7 @@ void libspdm_aead_free(void *context)
 {
 #ifdef USE_LKCA
     struct lkca_aead_ctx *ctx = context;
+    memzero_explicit(ctx->key, sizeof(ctx->key));
     crypto_free_aead(ctx->aead);
     aead_request_free(ctx->req);
     kfree(ctx->a_data_buffer);
@@ -119,10 +127,20 @@ void libspdm_aead_free(void *context)
 #define SG_AEAD_LEN 3
 
 #ifdef USE_LKCA
-// This function doesn't do any allocs, it uses temp buffers instead
+static int lkca_aead_setkey(struct crypto_aead *aead, const uint8_t *key, size_t key_size)
+{
+    if (crypto_aead_setkey(aead, key, key_size)) {
+        pr_info("key could not be set\n");
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+// This function doesn't do any allocs, it uses temp buffers instead. The key
+// must already be set on aead.
 static int lkca_aead_internal(struct crypto_aead *aead,
                               struct aead_request *req,
-                              const uint8_t *key, size_t key_size,
                               const uint8_t *iv, size_t iv_size,
                               struct scatterlist sg_in[],
                               struct scatterlist sg_out[],
@@ -135,11 +153,6 @@ static int lkca_aead_internal(struct crypto_aead *aead,
     DECLARE_CRYPTO_WAIT(wait);
     int rc = 0;
 
-    if (crypto_aead_setkey(aead, key, key_size)) {
-        pr_info("key could not be set\n");
-        return -EINVAL;
-    }
-
     if (crypto_aead_ivsize(aead) != iv_size) {
         pr_info("iv could not be set\n");
         return -EINVAL;
@@ -231,7 +244,22 @@ int libspdm_aead_prealloced(void *context,
     if(!enc)
         memcpy(ctx->tag, tag, tag_size);
 
-    rc = lkca_aead_internal(ctx->aead, ctx->req, key, key_size, iv, iv_size,
+    if ((key_size > MAX_KEY_SIZE) ||
+        (ctx->key_size != key_size) ||
+        (memcmp(ctx->key, key, key_size) != 0)) {
+        ctx->key_size = 0;
+
+        rc = lkca_aead_setkey(ctx->aead, key, key_size);
+        if (rc != 0)
+            return rc;
+
+        if (key_size <= MAX_KEY_SIZE) {
+            memcpy(ctx->key, key, key_size);
+            ctx->key_size = key_size;
+        }
+    }
+
+    rc = lkca_aead_internal(ctx->aead, ctx->req, iv, iv_size,
                             sg_in, sg_out, a_data_size, data_in_size,
                             data_out_size, tag_size, enc);
 
@@ -343,7 +371,11 @@ int libspdm_aead(const uint8_t *key, size_t key_size,
         sg_set_buf(&sg_out[SG_AEAD_SIG], tag, tag_size);
     }
 
-    rc = lkca_aead_internal(aead, req, key, key_size, iv, iv_size,
+    rc = lkca_aead_setkey(aead, key, key_size);
+    if (rc != 0)
+        goto out;
+
+    rc = lkca_aead_internal(aead, req, iv, iv_size,
                             sg_in, sg_out, a_data_size, data_in_size,
                             data_out_size, tag_size, enc);
 
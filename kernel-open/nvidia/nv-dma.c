@@ -338,6 +338,167 @@ static void nv_dma_unmap_scatterlist(nv_dma_map_t *dma_map)
     nv_destroy_dma_map_scatterlist(dma_map);
 }
 
+/*
+ * Without an IOMMU the DMA address of a page is its physical address, so no
+ * scatterlist is needed: the DMA addresses are the page addresses, and only
+ * the addressability check remains, done once per run of adjacent pages.
+ */
+static NV_STATUS nv_dma_map_identity(
+    nv_dma_device_t *dma_dev,
+    nv_dma_map_t    *dma_map,
+    NvU64           *va_array
+)
+{
+    NvU64 i, start = 0;
+    NvU64 extents = 0;
+
+    for (i = 0; i < dma_map->page_count; i++)
+    {
+        va_array[i] = dma_map->pages[i];
+
+        if ((i + 1 < dma_map->page_count) &&
+            (dma_map->pages[i + 1] == dma_map->pages[i] + PAGE_SIZE))
+        {
+            continue;
+        }
+
+        if (!nv_dma_is_addressable(dma_dev, dma_map->pages[start],
+                                   (i - start + 1) * PAGE_SIZE))
+        {
+            NV_DMA_DEV_PRINTF(NV_DBG_ERRORS, dma_dev,
+                    "DMA address not in addressable range of device "
+                    "(0x%lx-0x%lx, 0x%lx-0x%lx)\n",
+                    dma_map->pages[start],
+                    dma_map->pages[i] + PAGE_SIZE - 1,
+                    dma_dev->addressable_range.start,
+                    dma_dev->addressable_range.limit);
+            return NV_ERR_INVALID_ADDRESS;
+        }
+
+        extents++;
+        start = i + 1;
+    }
+
+    dma_map->identity = NV_TRUE;
+    dma_map->mapping.identity.extent_count = extents;
+
+    return NV_OK;
+}
+
+static void nv_dma_stats_update_max(atomic64_t *max, NvU64 value)
+{
+    NvU64 old = atomic64_read(max);
+
+    while (value > old)
+    {
+        NvU64 prev = atomic64_cmpxchg(max, old, value);
+        if (prev == old)
+            break;
+        old = prev;
+    }
+}
+
+static NvU64 nv_dma_count_segments(NvU64 *va_array, NvU64 page_count)
+{
+    NvU64 i, segments = 1;
+
+    for (i = 1; i < page_count; i++)
+    {
+        if (va_array[i] != va_array[i - 1] + PAGE_SIZE)
+            segments++;
+    }
+
+    return segments;
+}
+
+/*
+ * Account a mapping attempt started at start_ns. va_array must not have been
+ * compressed for NVLink yet, so that segments are counted in DMA addresses.
+ */
+static void nv_dma_stats_map(
+    nv_dma_device_t *dma_dev,
+    nv_dma_map_t    *dma_map,
+    NvU64           *va_array,
+    NvU64            start_ns,
+    NV_STATUS        status
+)
+{
+    NvU64 now = os_get_current_tick_hr();
+    NvU64 segments;
+
+    if (status != NV_OK)
+    {
+        atomic64_inc(&dma_dev->stats.failed_maps);
+        return;
+    }
+
+    if (dma_map->identity)
+    {
+        segments = dma_map->mapping.identity.extent_count;
+        atomic64_inc(&dma_dev->stats.identity_maps);
+    }
+    else if (dma_map->contiguous)
+    {
+        segments = 1;
+        atomic64_inc(&dma_dev->stats.contig_maps);
+    }
+    else
+    {
+        segments = nv_dma_count_segments(va_array, dma_map->page_count);
+        atomic64_inc(&dma_dev->stats.scatterlist_maps);
+    }
+
+    atomic64_inc(&dma_dev->stats.maps);
+    atomic64_add(dma_map->page_count * PAGE_SIZE, &dma_dev->stats.bytes_mapped);
+    atomic64_add(segments, &dma_dev->stats.segments);
+    atomic64_add(now - start_ns, &dma_dev->stats.map_ns);
+    nv_dma_stats_update_max(&dma_dev->stats.max_map_ns, now - start_ns);
+    nv_dma_stats_update_max(&dma_dev->stats.peak_outstanding,
+                            atomic64_inc_return(&dma_dev->stats.outstanding));
+
+    atomic64_cmpxchg(&dma_dev->stats.first_map_ns, 0, now);
+    dma_dev->stats.last_map_ns = now;
+}
+
+static void nv_dma_stats_unmap(nv_dma_device_t *dma_dev)
+{
+    atomic64_inc(&dma_dev->stats.unmaps);
+    atomic64_sub(1, &dma_dev->stats.outstanding);
+}
+
+void nv_dma_print_stats(nv_dma_device_t *dma_dev)
+{
+    NvU64 maps = atomic64_read(&dma_dev->stats.maps);
+    NvU64 elapsed_ns;
+
+    if (maps == 0)
+        return;
+
+    elapsed_ns = dma_dev->stats.last_map_ns - atomic64_read(&dma_dev->stats.first_map_ns);
+
+    NV_DMA_DEV_PRINTF(NV_DBG_INFO, dma_dev,
+            "DMA maps: %llu (%llu identity, %llu contig, %llu scatterlist), "
+            "%llu failed, %llu unmaps\n",
+            maps,
+            atomic64_read(&dma_dev->stats.identity_maps),
+            atomic64_read(&dma_dev->stats.contig_maps),
+            atomic64_read(&dma_dev->stats.scatterlist_maps),
+            atomic64_read(&dma_dev->stats.failed_maps),
+            atomic64_read(&dma_dev->stats.unmaps));
+    NV_DMA_DEV_PRINTF(NV_DBG_INFO, dma_dev,
+            "DMA maps: %llu bytes, avg %llu segments, "
+            "%llu outstanding (peak %llu), %llu maps/s\n",
+            atomic64_read(&dma_dev->stats.bytes_mapped),
+            atomic64_read(&dma_dev->stats.segments) / maps,
+            atomic64_read(&dma_dev->stats.outstanding),
+            atomic64_read(&dma_dev->stats.peak_outstanding),
+            (elapsed_ns != 0) ? (maps * 1000000000ull) / elapsed_ns : 0);
+    NV_DMA_DEV_PRINTF(NV_DBG_INFO, dma_dev,
+            "DMA map latency: avg %llu ns, max %llu ns\n",
+            atomic64_read(&dma_dev->stats.map_ns) / maps,
+            atomic64_read(&dma_dev->stats.max_map_ns));
+}
+
 static void nv_dma_nvlink_addr_compress
 (
     nv_dma_device_t *dma_dev,
@@ -388,6 +549,7 @@ NV_STATUS NV_API_CALL nv_dma_map_sgt(
 {
     NV_STATUS status;
     nv_dma_map_t *dma_map = NULL;
+    NvU64 start_ns = os_get_current_tick_hr();
 
     if (priv == NULL)
     {
@@ -413,11 +575,14 @@ NV_STATUS NV_API_CALL nv_dma_map_sgt(
     dma_map->import_sgt = (sg_list) *priv;
     dma_map->page_count = page_count;
     dma_map->contiguous = NV_FALSE;
+    dma_map->identity = NV_FALSE;
     dma_map->cache_type = cache_type;
 
     dma_map->mapping.discontig.submap_count = 0;
     status = nv_dma_map_scatterlist(dma_dev, dma_map, va_array);
 
+    nv_dma_stats_map(dma_dev, dma_map, va_array, start_ns, status);
+
     if (status != NV_OK)
     {
         os_free_mem(dma_map);
@@ -452,6 +617,8 @@ NV_STATUS NV_API_CALL nv_dma_unmap_sgt(
 
     os_free_mem(dma_map);
 
+    nv_dma_stats_unmap(dma_dev);
+
     return NV_OK;
 }
 
@@ -466,6 +633,7 @@ NV_STATUS NV_API_CALL nv_dma_map_pages(
 {
     NV_STATUS status;
     nv_dma_map_t *dma_map = NULL;
+    NvU64 start_ns = os_get_current_tick_hr();
 
     if (priv == NULL)
     {
@@ -495,9 +663,15 @@ NV_STATUS NV_API_CALL nv_dma_map_pages(
     dma_map->import_sgt = NULL;
     dma_map->page_count = page_count;
     dma_map->contiguous = contig;
+    dma_map->identity = NV_FALSE;
     dma_map->cache_type = cache_type;
 
-    if (dma_map->page_count > 1 && !dma_map->contiguous)
+    if (dma_map->page_count > 1 && !dma_map->contiguous &&
+        nv_dma_is_identity_mapped(dma_dev))
+    {
+        status = nv_dma_map_identity(dma_dev, dma_map, va_array);
+    }
+    else if (dma_map->page_count > 1 && !dma_map->contiguous)
     {
         dma_map->mapping.discontig.submap_count = 0;
         status = nv_dma_map_scatterlist(dma_dev, dma_map, va_array);
@@ -513,6 +687,8 @@ NV_STATUS NV_API_CALL nv_dma_map_pages(
         status = nv_dma_map_contig(dma_dev, dma_map, va_array);
     }
 
+    nv_dma_stats_map(dma_dev, dma_map, va_array, start_ns, status);
+
     if (status != NV_OK)
     {
         os_free_mem(dma_map);
@@ -564,7 +740,11 @@ NV_STATUS NV_API_CALL nv_dma_unmap_pages(
 
     *priv = dma_map->pages;
 
-    if (dma_map->contiguous)
+    if (dma_map->identity)
+    {
+        /* Nothing was mapped. */
+    }
+    else if (dma_map->contiguous)
     {
         nv_dma_unmap_contig(dma_map);
     }
@@ -575,6 +755,8 @@ NV_STATUS NV_API_CALL nv_dma_unmap_pages(
 
     os_free_mem(dma_map);
 
+    nv_dma_stats_unmap(dma_dev);
+
     return NV_OK;
 }
 
@@ -264,6 +264,9 @@ int init(status_handler complete)
 {
     extern int uvm_init(void);
 
+    // The allocator works uncached until this succeeds, so failure is not fatal.
+    nv_kmem_init();
+
     // initialise nvidia module table;
     nv_num_instances = 0;
     memset(nv_minor_num_table, 0, sizeof(nv_minor_num_table));
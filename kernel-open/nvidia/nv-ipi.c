@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#define  __NO_VERSION__
+
+#include "os-interface.h"
+#include "nv-nanos.h"
+
+/*
+ * Cross-CPU function calls, the Nanos counterpart of Linux on_each_cpu().
+ *
+ * One IPI vector is shared by all callers and a single call is in flight at a
+ * time: the caller publishes the function, sends the IPI to every other CPU,
+ * runs the function locally with interrupts disabled, and then spins until all
+ * other CPUs have run it. The caller waits even when the Linux "wait" argument
+ * is 0, since the next call reuses the same slot.
+ *
+ * The caller must not hold a spinlock that an IPI target could be spinning on
+ * with interrupts disabled, and must be able to take interrupts itself while
+ * it waits for the lock, so that concurrent callers can't deadlock each other.
+ */
+declare_closure_struct(0, 0, void, nv_ipi_handler);
+
+static struct
+{
+    struct spinlock lock;
+    u64 vector;
+    nv_ipi_func_t func;
+    void *info;
+    volatile NvU32 pending;
+    volatile NvU32 init_state;
+    closure_struct(nv_ipi_handler, handler);
+} nv_ipi;
+
+define_closure_function(0, 0, void, nv_ipi_handler)
+{
+    nv_ipi.func(nv_ipi.info);
+    memory_barrier();
+    __sync_fetch_and_sub(&nv_ipi.pending, 1);
+}
+
+static void nv_ipi_init(void)
+{
+    if (nv_ipi.init_state == 2)
+        return;
+
+    if (__sync_bool_compare_and_swap(&nv_ipi.init_state, 0, 1))
+    {
+        spin_lock_init(&nv_ipi.lock);
+        nv_ipi.vector = allocate_ipi_interrupt();
+        register_interrupt(nv_ipi.vector, init_closure(&nv_ipi.handler, nv_ipi_handler),
+                           "nvidia ipi");
+        memory_barrier();
+        nv_ipi.init_state = 2;
+        return;
+    }
+
+    while (nv_ipi.init_state != 2)
+        kern_pause();
+}
+
+void nv_on_each_cpu(nv_ipi_func_t func, void *info, int wait)
+{
+    u64 flags;
+    NvU32 self;
+    NvU32 cpu;
+
+    nv_ipi_init();
+
+    spin_lock(&nv_ipi.lock);
+
+    flags = irq_disable_save();
+    self = current_cpu()->id;
+
+    nv_ipi.func = func;
+    nv_ipi.info = info;
+    nv_ipi.pending = present_processors - 1;
+    memory_barrier();
+
+    for (cpu = 0; cpu < present_processors; cpu++)
+    {
+        if (cpu != self)
+            send_ipi(cpu, nv_ipi.vector);
+    }
+
+    func(info);
+    irq_restore(flags);
+
+    while (nv_ipi.pending != 0)
+        kern_pause();
+
+    spin_unlock(&nv_ipi.lock);
+}
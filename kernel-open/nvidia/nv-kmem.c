@@ -0,0 +1,403 @@
+#include "nv-nanos.h"
+#include "nv-kmem.h"
+
+/*
+ * Magazine allocator (Bonwick & Adams) in front of heap_locked().
+ *
+ * Each CPU owns a "loaded" and a "previous" magazine for every size class.
+ * Allocations pop from the loaded magazine and frees push onto it; when the
+ * loaded magazine runs empty (or full), it is swapped with the previous one,
+ * and only if both are exhausted does the CPU go to the per-class depot, which
+ * is protected by a spinlock. The depot in turn falls back to the locked
+ * kernel heap for refills and drains.
+ *
+ * The per-CPU state is only ever touched by its own CPU with interrupts
+ * disabled, which also makes the fast path safe for NV_KMALLOC_ATOMIC callers
+ * running in interrupt context.
+ */
+
+typedef struct nv_kmem_magazine {
+    struct list l;
+    NvU32 rounds;
+    void *objs[NV_KMEM_MAGAZINE_ROUNDS];
+} *nv_kmem_magazine;
+
+typedef struct nv_kmem_cpu_cache {
+    struct {
+        nv_kmem_magazine loaded;
+        nv_kmem_magazine previous;
+    } classes[NV_KMEM_CLASS_COUNT];
+    struct {
+        NvU32 count;
+        void *objs[NV_KMEM_STACK_POOL_DEPTH];
+    } stacks;
+} __attribute__((aligned(64))) nv_kmem_cpu_cache_t;
+
+typedef struct nv_kmem_depot {
+    struct spinlock lock;
+    struct list full;
+    struct list empty;
+    NvU32 full_count;
+} __attribute__((aligned(64))) nv_kmem_depot_t;
+
+static struct {
+    nv_kmem_cpu_cache_t *cpus;
+    NvU32 cpu_count;
+    nv_kmem_depot_t depot[NV_KMEM_CLASS_COUNT];
+} nv_kmem;
+
+static inline int nv_kmem_size_class(NvU64 size)
+{
+    int order;
+
+    if (size > NV_KMEM_MAX_CACHED_SIZE)
+        return -1;
+
+    order = find_order(size);
+    if (order < NV_KMEM_MIN_ORDER)
+        order = NV_KMEM_MIN_ORDER;
+
+    return order - NV_KMEM_MIN_ORDER;
+}
+
+static inline NvU64 nv_kmem_class_size(int c)
+{
+    return U64_FROM_BIT(c + NV_KMEM_MIN_ORDER);
+}
+
+static void *nv_kmem_heap_alloc(NvU64 size)
+{
+    void *p = allocate(heap_locked(get_kernel_heaps()), size);
+
+    return (p != INVALID_ADDRESS) ? p : NULL;
+}
+
+static void nv_kmem_heap_free(void *p, NvU64 size)
+{
+    deallocate(heap_locked(get_kernel_heaps()), p, size);
+}
+
+static nv_kmem_magazine nv_kmem_magazine_alloc(void)
+{
+    nv_kmem_magazine m = nv_kmem_heap_alloc(sizeof(*m));
+
+    if (m != NULL)
+        m->rounds = 0;
+    return m;
+}
+
+static void nv_kmem_magazine_drain(nv_kmem_magazine m, int c)
+{
+    NvU64 size = nv_kmem_class_size(c);
+
+    while (m->rounds > 0)
+        nv_kmem_heap_free(m->objs[--m->rounds], size);
+}
+
+static void nv_kmem_magazine_refill(nv_kmem_magazine m, int c)
+{
+    NvU64 size = nv_kmem_class_size(c);
+
+    while (m->rounds < NV_KMEM_MAGAZINE_ROUNDS / 2)
+    {
+        void *p = nv_kmem_heap_alloc(size);
+
+        if (p == NULL)
+            break;
+        m->objs[m->rounds++] = p;
+    }
+}
+
+/*
+ * Trade an empty magazine for a full one from the depot. Returns the full
+ * magazine, or NULL (and keeps the empty one) if the depot has none.
+ */
+static nv_kmem_magazine nv_kmem_depot_get_full(int c, nv_kmem_magazine empty)
+{
+    nv_kmem_depot_t *d = &nv_kmem.depot[c];
+    nv_kmem_magazine full = NULL;
+    struct list *l;
+
+    spin_lock(&d->lock);
+    l = list_get_next(&d->full);
+    if (l != NULL)
+    {
+        list_delete(l);
+        d->full_count--;
+        full = struct_from_list(l, nv_kmem_magazine, l);
+        list_push_back(&d->empty, &empty->l);
+    }
+    spin_unlock(&d->lock);
+
+    return full;
+}
+
+/*
+ * Trade a full magazine for an empty one. If the depot is already holding
+ * NV_KMEM_DEPOT_MAX_FULL magazines, or no empty magazine can be found, the
+ * full magazine is drained back to the heap and returned as the empty one.
+ */
+static nv_kmem_magazine nv_kmem_depot_put_full(int c, nv_kmem_magazine full)
+{
+    nv_kmem_depot_t *d = &nv_kmem.depot[c];
+    nv_kmem_magazine empty = NULL;
+    NvBool depot_has_room;
+    struct list *l;
+
+    spin_lock(&d->lock);
+    depot_has_room = (d->full_count < NV_KMEM_DEPOT_MAX_FULL);
+    if (depot_has_room)
+    {
+        l = list_get_next(&d->empty);
+        if (l != NULL)
+        {
+            list_delete(l);
+            empty = struct_from_list(l, nv_kmem_magazine, l);
+            list_push_back(&d->full, &full->l);
+            d->full_count++;
+        }
+    }
+    spin_unlock(&d->lock);
+
+    if (empty != NULL)
+        return empty;
+
+    // The depot cap is a soft limit: a concurrent put may overshoot it by one.
+    if (depot_has_room)
+        empty = nv_kmem_magazine_alloc();
+
+    if (empty != NULL)
+    {
+        spin_lock(&d->lock);
+        list_push_back(&d->full, &full->l);
+        d->full_count++;
+        spin_unlock(&d->lock);
+    }
+    else
+    {
+        nv_kmem_magazine_drain(full, c);
+        empty = full;
+    }
+
+    return empty;
+}
+
+static inline nv_kmem_cpu_cache_t *nv_kmem_this_cpu(void)
+{
+    NvU32 cpu = current_cpu()->id;
+
+    return (cpu < nv_kmem.cpu_count) ? &nv_kmem.cpus[cpu] : NULL;
+}
+
+void *nv_kmem_alloc(NvU64 size)
+{
+    int c = nv_kmem_size_class(size);
+    nv_kmem_cpu_cache_t *cc;
+    nv_kmem_magazine m;
+    void *p = NULL;
+    u64 flags;
+
+    if (c < 0)
+        return nv_kmem_heap_alloc(size);
+
+    flags = irq_disable_save();
+
+    cc = nv_kmem.cpus ? nv_kmem_this_cpu() : NULL;
+    if (cc == NULL)
+        goto out;
+
+    m = cc->classes[c].loaded;
+    if (m->rounds == 0)
+    {
+        nv_kmem_magazine prev = cc->classes[c].previous;
+
+        if (prev->rounds > 0)
+        {
+            cc->classes[c].previous = m;
+            cc->classes[c].loaded = m = prev;
+        }
+        else
+        {
+            nv_kmem_magazine full = nv_kmem_depot_get_full(c, prev);
+
+            if (full != NULL)
+            {
+                cc->classes[c].previous = m;
+                cc->classes[c].loaded = m = full;
+            }
+            else
+            {
+                nv_kmem_magazine_refill(m, c);
+            }
+        }
+    }
+
+    if (m->rounds > 0)
+        p = m->objs[--m->rounds];
+
+out:
+    irq_restore(flags);
+
+    //
+    // Always allocate the full class size, even when the cache is not
+    // initialized yet, so that any object of a class can later be recycled
+    // through that class.
+    //
+    if (p == NULL)
+        p = nv_kmem_heap_alloc(nv_kmem_class_size(c));
+
+    return p;
+}
+
+void nv_kmem_free(void *ptr, NvU64 size)
+{
+    int c = nv_kmem_size_class(size);
+    nv_kmem_cpu_cache_t *cc;
+    nv_kmem_magazine m;
+    u64 flags;
+
+    if (c < 0)
+    {
+        nv_kmem_heap_free(ptr, size);
+        return;
+    }
+
+    flags = irq_disable_save();
+
+    cc = nv_kmem.cpus ? nv_kmem_this_cpu() : NULL;
+    if (cc == NULL)
+    {
+        irq_restore(flags);
+        nv_kmem_heap_free(ptr, nv_kmem_class_size(c));
+        return;
+    }
+
+    m = cc->classes[c].loaded;
+    if (m->rounds == NV_KMEM_MAGAZINE_ROUNDS)
+    {
+        nv_kmem_magazine prev = cc->classes[c].previous;
+
+        if (prev->rounds == 0)
+        {
+            cc->classes[c].previous = m;
+            cc->classes[c].loaded = m = prev;
+        }
+        else
+        {
+            cc->classes[c].previous = m;
+            cc->classes[c].loaded = m = nv_kmem_depot_put_full(c, prev);
+        }
+    }
+
+    m->objs[m->rounds++] = ptr;
+
+    irq_restore(flags);
+}
+
+void *nv_kmem_stack_alloc(void)
+{
+    nv_kmem_cpu_cache_t *cc;
+    void *p = NULL;
+    u64 flags;
+
+    flags = irq_disable_save();
+    cc = nv_kmem.cpus ? nv_kmem_this_cpu() : NULL;
+    if ((cc != NULL) && (cc->stacks.count > 0))
+        p = cc->stacks.objs[--cc->stacks.count];
+    irq_restore(flags);
+
+    if (p == NULL)
+        p = nv_kmem_heap_alloc(sizeof(nvidia_stack_t));
+
+    return p;
+}
+
+void nv_kmem_stack_free(void *stack)
+{
+    nv_kmem_cpu_cache_t *cc;
+    u64 flags;
+
+    flags = irq_disable_save();
+    cc = nv_kmem.cpus ? nv_kmem_this_cpu() : NULL;
+    if ((cc != NULL) && (cc->stacks.count < NV_KMEM_STACK_POOL_DEPTH))
+    {
+        cc->stacks.objs[cc->stacks.count++] = stack;
+        stack = NULL;
+    }
+    irq_restore(flags);
+
+    if (stack != NULL)
+        nv_kmem_heap_free(stack, sizeof(nvidia_stack_t));
+}
+
+int nv_kmem_init(void)
+{
+    nv_kmem_cpu_cache_t *cpus;
+    NvU32 cpu_count = present_processors;
+    NvU32 i;
+    int c;
+
+    if (nv_kmem.cpus != NULL)
+        return 0;
+
+    for (c = 0; c < NV_KMEM_CLASS_COUNT; c++)
+    {
+        spin_lock_init(&nv_kmem.depot[c].lock);
+        list_init(&nv_kmem.depot[c].full);
+        list_init(&nv_kmem.depot[c].empty);
+        nv_kmem.depot[c].full_count = 0;
+    }
+
+    cpus = nv_kmem_heap_alloc(sizeof(*cpus) * cpu_count);
+    if (cpus == NULL)
+        return -ENOMEM;
+    zero(cpus, sizeof(*cpus) * cpu_count);
+
+    for (i = 0; i < cpu_count; i++)
+    {
+        for (c = 0; c < NV_KMEM_CLASS_COUNT; c++)
+        {
+            cpus[i].classes[c].loaded = nv_kmem_magazine_alloc();
+            cpus[i].classes[c].previous = nv_kmem_magazine_alloc();
+            if ((cpus[i].classes[c].loaded == NULL) ||
+                (cpus[i].classes[c].previous == NULL))
+            {
+                goto fail;
+            }
+        }
+
+        // A short prefill is only an optimization, so allocation failures
+        // here are not fatal.
+        while (cpus[i].stacks.count < NV_KMEM_STACK_POOL_PREFILL)
+        {
+            void *p = nv_kmem_heap_alloc(sizeof(nvidia_stack_t));
+
+            if (p == NULL)
+                break;
+            cpus[i].stacks.objs[cpus[i].stacks.count++] = p;
+        }
+    }
+
+    nv_kmem.cpu_count = cpu_count;
+    memory_barrier();
+    nv_kmem.cpus = cpus;
+
+    return 0;
+
+fail:
+    for (i = 0; i < cpu_count; i++)
+    {
+        for (c = 0; c < NV_KMEM_CLASS_COUNT; c++)
+        {
+            if (cpus[i].classes[c].loaded != NULL)
+                nv_kmem_heap_free(cpus[i].classes[c].loaded, sizeof(struct nv_kmem_magazine));
+            if (cpus[i].classes[c].previous != NULL)
+                nv_kmem_heap_free(cpus[i].classes[c].previous, sizeof(struct nv_kmem_magazine));
+        }
+        while (cpus[i].stacks.count > 0)
+            nv_kmem_heap_free(cpus[i].stacks.objs[--cpus[i].stacks.count], sizeof(nvidia_stack_t));
+    }
+    nv_kmem_heap_free(cpus, sizeof(*cpus) * cpu_count);
+
+    return -ENOMEM;
+}
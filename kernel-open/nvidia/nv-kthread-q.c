@@ -34,12 +34,19 @@
 //
 // 1. Each nv_kthread_q instance is a first-in, first-out queue.
 //
-// 2. Each nv_kthread_q instance is serviced by exactly one kthread.
+// 2. Each nv_kthread_q instance is serviced by exactly one kthread, unless it
+//    was created with nv_kthread_q_init_multi().
 //
 // You can create any number of queues, each of which gets its own
 // named kernel thread (kthread). You can then insert arbitrary functions
 // into the queue, and those functions will be run in the context of the
 // queue's kthread.
+//
+// A multi-worker queue keeps one deque per worker context. The q_sem count is
+// the number of runnable items across all deques, plus one while serialized
+// items are waiting and none of them is running. A worker that gets a count
+// is therefore guaranteed to find an item somewhere: the serialized list
+// first, then its own deque (FIFO), then the tail of any other deque.
 
 #ifndef WARN
     // Only *really* old kernels (2.6.9) end up here. Just use a simple printk
@@ -127,58 +134,303 @@ void nv_kthread_q_stop(nv_kthread_q_t *q)
         NVQ_WARN("list not empty after flushing\n");
 
     if (likely(!atomic_read(&q->main_loop_should_exit))) {
+        NvU32 i;
 
         atomic_set(&q->main_loop_should_exit, 1);
 
+        if (q->workers) {
+            NvU32 worker_count = q->worker_count;
+
+            for (i = 0; i < worker_count; i++)
+                up(&q->q_sem);
+
+            // Wait for all workers to stop touching the worker array.
+            while (atomic_read(&q->live_workers))
+                os_schedule();
+
+            NV_KFREE(q->workers, sizeof(*q->workers) * worker_count);
+            q->workers = NULL;
+            q->worker_count = 0;
+            q->ctx = NULL;
+            return;
+        }
+
         // Wake up the kthread so that it can see that it needs to stop:
         up(&q->q_sem);
     }
 }
 
-int nv_kthread_q_init_on_node(nv_kthread_q_t *q, const char *q_name, int preferred_node)
+// Returns the n-th CPU (modulo the node size) of the given node, or -1 if the
+// node is unknown.
+static int _node_cpu(int node, unsigned n)
 {
+    const struct cpumask *mask = nv_cpumask_of_node(node);
+    int weight, cpu;
+
+    if ((node == NV_KTHREAD_NO_NODE) || cpumask_empty(mask))
+        return -1;
+
+    weight = cpumask_weight(mask);
+    n %= weight;
+    for (cpu = 0; cpu < NV_MAX_CPUS; cpu++) {
+        if (cpumask_test_cpu(cpu, mask) && (n-- == 0))
+            return cpu;
+    }
+
+    return -1;
+}
+
+// Creates a kernel context that runs main_loop(args), or returns NULL. The
+// context is allocated from, and first scheduled by, the given CPU (or the
+// current one if cpu is negative).
+static context _start_context(int (*main_loop)(void *), void *args, int cpu)
+{
+    cpuinfo ci = (cpu >= 0) ? cpuinfo_from_id(cpu) : current_cpu();
+    context ctx = (context)allocate_kernel_context(ci);
     u64 *f;
 
+    if (ctx == INVALID_ADDRESS)
+        return NULL;
+
+    f = ctx->frame;
+#if defined(NVCPU_X86_64)
+    f[FRAME_RIP] = u64_from_pointer(main_loop);
+    f[FRAME_RDI] = u64_from_pointer(args);
+    f[FRAME_CS] = 0x8;
+    f[FRAME_SS] = 0x0;
+#elif defined(NVCPU_AARCH64)
+    f[FRAME_ELR] = u64_from_pointer(main_loop);
+    f[FRAME_X0] = u64_from_pointer(args);
+#endif
+    frame_reset_stack(f);
+    f[FRAME_FULL] = true;
+    context_schedule_return(ctx);
+
+    return ctx;
+}
+
+int nv_kthread_q_init_on_node(nv_kthread_q_t *q, const char *q_name, int preferred_node)
+{
     memset(q, 0, sizeof(*q));
 
     INIT_LIST_HEAD(&q->q_list_head);
     spin_lock_init(&q->q_lock);
     sema_init(&q->q_sem, 0);
 
-    if (preferred_node == NV_KTHREAD_NO_NODE) {
-        q->ctx = (context)allocate_kernel_context(current_cpu());
+    // Unknown nodes fall back to the current CPU, the way kernel allocators
+    // fall back to another node.
+    //
+    // q->ctx stays NULL on failure, so that nv_kthread_q_stop() can be safely
+    // called on it making error handling easier.
+    q->ctx = _start_context(_main_loop, q, _node_cpu(preferred_node, 0));
+    if (q->ctx == NULL)
+        return -ENOMEM;
+
+    return 0;
+}
+
+// Takes one runnable item off a multi-worker queue, or returns NULL if another
+// worker got there first. *serialized is set if the item came from the
+// serialized list, in which case the caller now owns q->serial_running.
+static nv_kthread_q_item_t *_multi_q_take(nv_kthread_q_worker_t *w, int *serialized)
+{
+    nv_kthread_q_t *q = w->q;
+    nv_kthread_q_item_t *q_item = NULL;
+    unsigned long flags;
+    NvU32 i;
+
+    *serialized = 0;
+
+    spin_lock_irqsave(&q->q_lock, flags);
+    if (!q->serial_running && !list_empty(&q->q_list_head)) {
+        q_item = list_first_entry(&q->q_list_head,
+                                  nv_kthread_q_item_t,
+                                  q_list_node);
+        list_del_init(&q_item->q_list_node);
+        q->serial_running = 1;
+        *serialized = 1;
     }
-    else {
-        return -ENOTSUPP;
+    spin_unlock_irqrestore(&q->q_lock, flags);
+
+    if (q_item)
+        return q_item;
+
+    // Own deque from the head, everybody else's from the tail.
+    for (i = 0; i < q->worker_count && !q_item; i++) {
+        nv_kthread_q_worker_t *victim = &q->workers[(w->id + i) % q->worker_count];
+
+        spin_lock_irqsave(&victim->q_lock, flags);
+        if (!list_empty(&victim->q_list_head)) {
+            if (victim == w)
+                q_item = list_first_entry(&victim->q_list_head,
+                                          nv_kthread_q_item_t,
+                                          q_list_node);
+            else
+                q_item = list_last_entry(&victim->q_list_head,
+                                         nv_kthread_q_item_t,
+                                         q_list_node);
+            list_del_init(&q_item->q_list_node);
+        }
+        spin_unlock_irqrestore(&victim->q_lock, flags);
     }
 
-    if (q->ctx == INVALID_ADDRESS) {
-        int err = -ENOMEM;
+    return q_item;
+}
+
+static int _multi_main_loop(void *args)
+{
+    nv_kthread_q_worker_t *w = (nv_kthread_q_worker_t *)args;
+    nv_kthread_q_t *q = w->q;
+    nv_kthread_q_item_t *q_item;
+    unsigned long flags;
+    int serialized;
+    int reissue;
 
-        // Clear q_kthread before returning so that nv_kthread_q_stop() can be
-        // safely called on it making error handling easier.
-        q->ctx = NULL;
+    while (1) {
+        while (down_interruptible(&q->q_sem))
+            NVQ_WARN("Interrupted during semaphore wait\n");
 
-        return err;
+        if (atomic_read(&q->main_loop_should_exit))
+            break;
+
+        // Our count guarantees an item for us, but a concurrent taker may
+        // have emptied the deque we looked at before a new one landed in
+        // a deque we had already scanned.
+        while (!(q_item = _multi_q_take(w, &serialized)))
+            kern_pause();
+
+        q_item->q_pending = 0;
+        memory_barrier();
+
+        q_item->function_to_run(q_item->function_args);
+
+        if (serialized) {
+            spin_lock_irqsave(&q->q_lock, flags);
+            q->serial_running = 0;
+            reissue = !list_empty(&q->q_list_head);
+            spin_unlock_irqrestore(&q->q_lock, flags);
+
+            if (reissue)
+                up(&q->q_sem);
+        }
+
+        atomic_dec_return(&q->active_items);
     }
 
-    f = q->ctx->frame;
-#if defined(NVCPU_X86_64)
-    f[FRAME_RIP] = u64_from_pointer(_main_loop);
-    f[FRAME_RDI] = u64_from_pointer(q);
-    f[FRAME_CS] = 0x8;
-    f[FRAME_SS] = 0x0;
-#elif defined(NVCPU_AARCH64)
-    f[FRAME_ELR] = u64_from_pointer(_main_loop);
-    f[FRAME_X0] = u64_from_pointer(q);
-#endif
-    frame_reset_stack(f);
-    f[FRAME_FULL] = true;
-    context_schedule_return(q->ctx);
+    w->ctx = NULL;
+    atomic_dec_return(&q->live_workers);
+    kern_yield();
+}
+
+int nv_kthread_q_init_multi_on_node(nv_kthread_q_t *q,
+                                    const char *q_name,
+                                    unsigned worker_count,
+                                    int preferred_node)
+{
+    NvU32 i;
+
+    memset(q, 0, sizeof(*q));
+
+    INIT_LIST_HEAD(&q->q_list_head);
+    spin_lock_init(&q->q_lock);
+    sema_init(&q->q_sem, 0);
+
+    if (worker_count == 0) {
+        const struct cpumask *mask = nv_cpumask_of_node(preferred_node);
+
+        if ((preferred_node != NV_KTHREAD_NO_NODE) && !cpumask_empty(mask))
+            worker_count = cpumask_weight(mask);
+        else
+            worker_count = present_processors;
+    }
+
+    NV_KZALLOC(q->workers, sizeof(*q->workers) * worker_count);
+    if (q->workers == NULL)
+        return -ENOMEM;
+
+    for (i = 0; i < worker_count; i++) {
+        nv_kthread_q_worker_t *w = &q->workers[i];
+
+        INIT_LIST_HEAD(&w->q_list_head);
+        spin_lock_init(&w->q_lock);
+        w->q = q;
+        w->id = i;
+        w->cpu = _node_cpu(preferred_node, i);
+        if (w->cpu < 0)
+            w->cpu = i % present_processors;
+    }
+    q->worker_count = worker_count;
+
+    for (i = 0; i < worker_count; i++) {
+        atomic_inc(&q->live_workers);
+        q->workers[i].ctx = _start_context(_multi_main_loop, &q->workers[i], q->workers[i].cpu);
+        if (q->workers[i].ctx == NULL) {
+            atomic_dec_return(&q->live_workers);
+            break;
+        }
+    }
+
+    if (i == 0) {
+        NV_KFREE(q->workers, sizeof(*q->workers) * worker_count);
+        q->workers = NULL;
+        q->worker_count = 0;
+        return -ENOMEM;
+    }
+
+    // Run with however many workers could be started.
+    q->worker_count = i;
+    q->ctx = q->workers[0].ctx;
 
     return 0;
 }
 
+// Picks the deque for a submission: the worker homed on the current CPU if
+// there is one, so that items stay node-local, or else any worker.
+static nv_kthread_q_worker_t *_local_worker(nv_kthread_q_t *q)
+{
+    int cpu = current_cpu()->id;
+    NvU32 i;
+
+    for (i = 0; i < q->worker_count; i++) {
+        if (q->workers[i].cpu == cpu)
+            return &q->workers[i];
+    }
+
+    return &q->workers[cpu % q->worker_count];
+}
+
+// Returns true (non-zero) if the item was actually scheduled, and false if the
+// item was already pending in the queue.
+static int _multi_q_schedule(nv_kthread_q_t *q, nv_kthread_q_item_t *q_item, int serialized)
+{
+    unsigned long flags;
+    int wake = 1;
+
+    if (!__sync_bool_compare_and_swap(&q_item->q_pending, 0, 1))
+        return 0;
+
+    atomic_inc(&q->active_items);
+
+    if (serialized) {
+        spin_lock_irqsave(&q->q_lock, flags);
+        wake = !q->serial_running && list_empty(&q->q_list_head);
+        list_add_tail(&q_item->q_list_node, &q->q_list_head);
+        spin_unlock_irqrestore(&q->q_lock, flags);
+    }
+    else {
+        nv_kthread_q_worker_t *w = _local_worker(q);
+
+        spin_lock_irqsave(&w->q_lock, flags);
+        list_add_tail(&q_item->q_list_node, &w->q_list_head);
+        spin_unlock_irqrestore(&w->q_lock, flags);
+    }
+
+    if (wake)
+        up(&q->q_sem);
+
+    return 1;
+}
+
 // Returns true (non-zero) if the item was actually scheduled, and false if the
 // item was already pending in a queue.
 static int _raw_q_schedule(nv_kthread_q_t *q, nv_kthread_q_item_t *q_item)
@@ -208,6 +460,7 @@ void nv_kthread_q_item_init(nv_kthread_q_item_t *q_item,
     INIT_LIST_HEAD(&q_item->q_list_node);
     q_item->function_to_run = function_to_run;
     q_item->function_args   = function_args;
+    q_item->q_pending       = 0;
 }
 
 // Returns true (non-zero) if the q_item got scheduled, false otherwise.
@@ -220,6 +473,24 @@ int nv_kthread_q_schedule_q_item(nv_kthread_q_t *q,
         return 0;
     }
 
+    if (q->workers)
+        return _multi_q_schedule(q, q_item, 0);
+
+    return _raw_q_schedule(q, q_item);
+}
+
+int nv_kthread_q_schedule_q_item_serialized(nv_kthread_q_t *q,
+                                            nv_kthread_q_item_t *q_item)
+{
+    if (unlikely(atomic_read(&q->main_loop_should_exit))) {
+        NVQ_WARN("Not allowed: nv_kthread_q_schedule_q_item_serialized was "
+                   "called with a non-alive q: 0x%p\n", q);
+        return 0;
+    }
+
+    if (q->workers)
+        return _multi_q_schedule(q, q_item, 1);
+
     return _raw_q_schedule(q, q_item);
 }
 
@@ -254,6 +525,14 @@ void nv_kthread_q_flush(nv_kthread_q_t *q)
         return;
     }
 
+    // Items can be stolen in any order, so there is no flush item that could
+    // mark a point in a multi-worker queue; wait for it to drain instead.
+    if (q->workers) {
+        while (atomic_read(&q->active_items))
+            os_schedule();
+        return;
+    }
+
     // This 2x flush is not a typing mistake. The queue really does have to be
     // flushed twice, in order to take care of the case of a q_item that
     // reschedules itself.
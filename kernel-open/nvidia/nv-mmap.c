@@ -126,6 +126,7 @@ sysreturn static nvidia_mmap_sysmem(
 )
 {
     NvU64 j;
+    NvU64 run;
     int ret = 0;
     unsigned long start = 0;
 
@@ -133,7 +134,7 @@ sysreturn static nvidia_mmap_sysmem(
 
     start = vma->node.r.start;
 
-    for (j = page_index; j < (page_index + pages); j++)
+    for (j = page_index; j < (page_index + pages); j += run)
     {
         /*
          * For PPC64LE build, nv_array_index_no_speculate() is not defined
@@ -146,6 +147,8 @@ sysreturn static nvidia_mmap_sysmem(
         nv_speculation_barrier();
 #endif
 
+        run = 1;
+
 #if defined(NV_VGPU_KVM_BUILD)
         if (at->flags.guest)
         {
@@ -155,7 +158,22 @@ sysreturn static nvidia_mmap_sysmem(
         else
 #endif
         {
-            remap(start, at->page_table[j]->phys_addr, PAGE_SIZE, flags);
+            //
+            // Map each physically contiguous run in one go, so that it can
+            // be backed by large pages. The mapping is fully populated here,
+            // so first accesses do not fault.
+            //
+            if (NVreg_MmapLargePages)
+            {
+                while (((j + run) < (page_index + pages)) &&
+                       (at->page_table[j + run]->phys_addr ==
+                        (at->page_table[j]->phys_addr + run * PAGE_SIZE)))
+                {
+                    run++;
+                }
+            }
+
+            remap(start, at->page_table[j]->phys_addr, run * PAGE_SIZE, flags);
         }
 
         if (ret)
@@ -163,7 +181,7 @@ sysreturn static nvidia_mmap_sysmem(
             NV_ATOMIC_DEC(at->usage_count);
             return -EAGAIN;
         }
-        start += PAGE_SIZE;
+        start += run * PAGE_SIZE;
     }
 
     return vma->node.r.start;
@@ -108,6 +108,76 @@ define_closure_function(0, 0, void, nvidia_isr_msix_kthread_bh)
     os_release_mutex(nvl->msix_bh_mutex);
 }
 
+/*
+ * Per-vector mode: each vector runs the UVM top half on its own, without
+ * waiting for the RM top half of another vector, and has its own bottom half
+ * with a private alt-stack. rm_isr() still shares device interrupt state and
+ * the ISR alt-stack, so it remains serialized by msix_isr_lock. rm_isr_bh()
+ * takes the GPU locks it needs itself.
+ */
+define_closure_function(0, 0, void, nvidia_isr_msix_vector)
+{
+    nv_msix_vector_t *v = struct_from_field(closure_self(), nv_msix_vector_t *, isr);
+    nv_nanos_state_t *nvl = v->nvl;
+
+#if defined(NV_UVM_ENABLE)
+    nv_uvm_event_interrupt(nv_get_cached_uuid(NV_STATE_PTR(nvl)));
+#endif
+
+    NV_SPIN_LOCK(&nvl->msix_isr_lock);
+
+    nvidia_isr_service(nvl, NV_FALSE, (thunk)&v->bh);
+
+    NV_SPIN_UNLOCK(&nvl->msix_isr_lock);
+}
+
+define_closure_function(0, 0, void, nvidia_isr_msix_vector_bh)
+{
+    nv_msix_vector_t *v = struct_from_field(closure_self(), nv_msix_vector_t *, bh);
+
+    rm_isr_bh(v->bh_sp, &v->nvl->nv_state);
+}
+
+void nv_free_msix_vectors(nv_nanos_state_t *nvl)
+{
+    int i;
+
+    if (nvl->msix_vectors == NULL)
+        return;
+
+    for (i = 0; i < nvl->num_intr; i++)
+        nv_kmem_cache_free_stack(nvl->msix_vectors[i].bh_sp);
+
+    NV_KFREE(nvl->msix_vectors, sizeof(nv_msix_vector_t) * nvl->num_intr);
+    nvl->msix_vectors = NULL;
+}
+
+static int nv_alloc_msix_vectors(nv_nanos_state_t *nvl)
+{
+    int i;
+
+    NV_KZALLOC(nvl->msix_vectors, sizeof(nv_msix_vector_t) * nvl->num_intr);
+    if (nvl->msix_vectors == NULL)
+        return -ENOMEM;
+
+    for (i = 0; i < nvl->num_intr; i++)
+    {
+        nv_msix_vector_t *v = &nvl->msix_vectors[i];
+
+        v->nvl = nvl;
+        v->index = i;
+        init_closure(&v->isr, nvidia_isr_msix_vector);
+        init_closure(&v->bh, nvidia_isr_msix_vector_bh);
+        if (nv_kmem_cache_alloc_stack(&v->bh_sp) != 0)
+        {
+            nv_free_msix_vectors(nvl);
+            return -ENOMEM;
+        }
+    }
+
+    return 0;
+}
+
 void NV_API_CALL nv_init_msix(nv_state_t *nv)
 {
     nv_nanos_state_t *nvl = NV_GET_NVL_FROM_NV_STATE(nv);
@@ -171,8 +241,19 @@ NvS32 NV_API_CALL nv_request_msix_irq(nv_nanos_state_t *nvl)
     int rc = NV_ERR_INVALID_ARGUMENT;
 
     init_closure(&nvl->isr_msix_bh, nvidia_isr_msix_kthread_bh);
+
+    if (NVreg_MsixPerVector && (nv_alloc_msix_vectors(nvl) != 0))
+    {
+        NV_DEV_PRINTF(NV_DBG_WARNINGS, NV_STATE_PTR(nvl),
+                      "Failed to allocate per-vector MSI-X state, "
+                      "serializing all vectors.\n");
+    }
+
     for (i = 0; i < nvl->num_intr; i++)
     {
+        if (nvl->msix_vectors != NULL)
+            h = (thunk)&nvl->msix_vectors[i].isr;
+
         rc = pci_setup_msix(nvl->pci_dev, i, h, nv_device_name);
         if (rc < 0)
         {
@@ -180,6 +261,7 @@ NvS32 NV_API_CALL nv_request_msix_irq(nv_nanos_state_t *nvl)
             {
                 pci_teardown_msix(nvl->pci_dev, j);
             }
+            nv_free_msix_vectors(nvl);
             break;
         }
         rc = 0;
@@ -26,14 +26,14 @@
 #include "os-interface.h"
 #include "nv-nanos.h"
 
-#define NV_NANO_TIMER_USE_HRTIMER 0
+#define NV_NANO_TIMER_USE_HRTIMER 1
 
 declare_closure_struct(0, 0, void, nv_nano_timer_handler);
 struct nv_nano_timer
 {
 #if NV_NANO_TIMER_USE_HRTIMER
-    struct hrtimer hr_timer; // This parameter holds linux high resolution timer object
-                             // can get replaced with platform specific timer object
+    struct list hr_list;     // On nv_nano_timer_base.timers while pending
+    timestamp hr_deadline;
 #else
     struct timer jiffy_timer;
     closure_struct(nv_nano_timer_handler, h);
@@ -94,14 +94,174 @@ static nv_nano_timer_t *nv_alloc_nano_timer(void)
 }
 
 #if NV_NANO_TIMER_USE_HRTIMER
-static enum hrtimer_restart nv_nano_timer_callback_typed_data(struct hrtimer *hrtmr)
+/*
+ * High resolution backend on kernel_timers.
+ *
+ * All nano timers share one deadline-ordered list. Expiry is driven by
+ * one-shot "wakeup" kernel timers, each of which runs every nano timer due
+ * within NVreg_NanoTimerSlack ns of the wakeup. A new wakeup is only
+ * registered when no existing one already fires within the slack window after
+ * the new deadline, so timers with close deadlines share one interrupt.
+ * Wakeups are never cancelled; one that finds nothing due just re-arms for
+ * the new head of the list, if needed.
+ */
+declare_closure_struct(0, 0, void, nv_nano_timer_wakeup_handler);
+typedef struct nv_nano_timer_wakeup
 {
-    struct nv_nano_timer *nv_nstimer =
-        container_of(hrtmr, struct nv_nano_timer, hr_timer);
+    struct list l;
+    struct timer t;
+    timestamp when;
+    closure_struct(nv_nano_timer_wakeup_handler, h);
+} nv_nano_timer_wakeup_t;
 
-    nv_nstimer->nv_nano_timer_callback(nv_nstimer);
+static struct
+{
+    struct spinlock lock;
+    struct list timers;         // pending nv_nano_timer_t, by deadline
+    struct list wakeups;        // registered wakeups, by expiry
+    struct list free_wakeups;
+    volatile NvU32 init_state;
+} nv_nano_timer_base;
+
+static void nv_nano_timer_base_init(void)
+{
+    if (nv_nano_timer_base.init_state == 2)
+        return;
+
+    if (__sync_bool_compare_and_swap(&nv_nano_timer_base.init_state, 0, 1))
+    {
+        spin_lock_init(&nv_nano_timer_base.lock);
+        list_init(&nv_nano_timer_base.timers);
+        list_init(&nv_nano_timer_base.wakeups);
+        list_init(&nv_nano_timer_base.free_wakeups);
+        memory_barrier();
+        nv_nano_timer_base.init_state = 2;
+        return;
+    }
+
+    while (nv_nano_timer_base.init_state != 2)
+        kern_pause();
+}
+
+static inline timestamp nv_nano_timer_slack(void)
+{
+    return nanoseconds(NVreg_NanoTimerSlack);
+}
+
+// Makes sure some wakeup fires no later than deadline + slack. Called with the
+// base lock held.
+static void nv_nano_timer_ensure_wakeup(timestamp deadline)
+{
+    nv_nano_timer_wakeup_t *w;
+    struct list *l;
+
+    // Only the earliest wakeup matters: if it fires before the deadline, it
+    // re-arms for it once it has run.
+    l = list_get_next(&nv_nano_timer_base.wakeups);
+    if ((l != NULL) &&
+        (struct_from_list(l, nv_nano_timer_wakeup_t *, l)->when <= deadline + nv_nano_timer_slack()))
+    {
+        return;
+    }
+
+    l = list_get_next(&nv_nano_timer_base.free_wakeups);
+    if (l != NULL)
+    {
+        list_delete(l);
+        w = struct_from_list(l, nv_nano_timer_wakeup_t *, l);
+    }
+    else
+    {
+        NV_KMALLOC_ATOMIC(w, sizeof(*w));
+        if (w == NULL)
+        {
+            nv_printf(NV_DBG_ERRORS, "NVRM: no memory for nano timer wakeup\n");
+            return;
+        }
+        memset(w, 0, sizeof(*w));
+        init_timer(&w->t);
+        init_closure(&w->h, nv_nano_timer_wakeup_handler);
+    }
+
+    // Wakeups are sorted, and the new one is the earliest.
+    w->when = deadline;
+    list_insert_after(&nv_nano_timer_base.wakeups, &w->l);
+    register_timer(kernel_timers, &w->t, CLOCK_ID_MONOTONIC, deadline, true, 0,
+                   (timer_handler)&w->h);
+}
 
-    return HRTIMER_NORESTART;
+define_closure_function(0, 0, void, nv_nano_timer_wakeup_handler)
+{
+    nv_nano_timer_wakeup_t *w =
+        struct_from_field(closure_self(), nv_nano_timer_wakeup_t *, h);
+    nv_nano_timer_t *nv_nstimer;
+    struct list *l;
+    u64 flags;
+
+    flags = spin_lock_irq(&nv_nano_timer_base.lock);
+    list_delete(&w->l);
+
+    while ((l = list_get_next(&nv_nano_timer_base.timers)) != NULL)
+    {
+        nv_nstimer = struct_from_list(l, nv_nano_timer_t *, hr_list);
+        if (nv_nstimer->hr_deadline > kern_now(CLOCK_ID_MONOTONIC) + nv_nano_timer_slack())
+            break;
+
+        list_delete(l);
+        list_init(l);
+        spin_unlock_irq(&nv_nano_timer_base.lock, flags);
+
+        nv_nstimer->nv_nano_timer_callback(nv_nstimer);
+
+        flags = spin_lock_irq(&nv_nano_timer_base.lock);
+    }
+
+    l = list_get_next(&nv_nano_timer_base.timers);
+    if (l != NULL)
+    {
+        nv_nstimer = struct_from_list(l, nv_nano_timer_t *, hr_list);
+        nv_nano_timer_ensure_wakeup(nv_nstimer->hr_deadline);
+    }
+
+    list_push_back(&nv_nano_timer_base.free_wakeups, &w->l);
+    spin_unlock_irq(&nv_nano_timer_base.lock, flags);
+}
+
+static void nv_nano_timer_hr_start(nv_nano_timer_t *nv_nstimer, NvU64 time_ns)
+{
+    timestamp deadline = kern_now(CLOCK_ID_MONOTONIC) + nanoseconds(time_ns);
+    struct list *l;
+    u64 flags;
+
+    flags = spin_lock_irq(&nv_nano_timer_base.lock);
+
+    if (!list_empty(&nv_nstimer->hr_list))
+        list_delete(&nv_nstimer->hr_list);
+
+    for (l = nv_nano_timer_base.timers.prev; l != &nv_nano_timer_base.timers; l = l->prev)
+    {
+        if (struct_from_list(l, nv_nano_timer_t *, hr_list)->hr_deadline <= deadline)
+            break;
+    }
+    nv_nstimer->hr_deadline = deadline;
+    list_insert_after(l, &nv_nstimer->hr_list);
+
+    nv_nano_timer_ensure_wakeup(deadline);
+
+    spin_unlock_irq(&nv_nano_timer_base.lock, flags);
+}
+
+static void nv_nano_timer_hr_cancel(nv_nano_timer_t *nv_nstimer)
+{
+    u64 flags;
+
+    flags = spin_lock_irq(&nv_nano_timer_base.lock);
+    if (!list_empty(&nv_nstimer->hr_list))
+    {
+        list_delete(&nv_nstimer->hr_list);
+        list_init(&nv_nstimer->hr_list);
+    }
+    spin_unlock_irq(&nv_nano_timer_base.lock, flags);
 }
 #else
 define_closure_function(0, 0, void, nv_nano_timer_handler)
@@ -148,8 +308,8 @@ void NV_API_CALL nv_create_nano_timer(
     nv_nstimer->nv_nano_timer_callback = nvidia_nano_timer_callback;
 
 #if NV_NANO_TIMER_USE_HRTIMER
-    hrtimer_init(&nv_nstimer->hr_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
-    nv_nstimer->hr_timer.function = nv_nano_timer_callback_typed_data;
+    nv_nano_timer_base_init();
+    list_init(&nv_nstimer->hr_list);
 #else
 #if defined(NV_TIMER_SETUP_PRESENT)
     timer_setup(&nv_nstimer->jiffy_timer, nv_jiffy_timer_callback_typed_data, 0);
@@ -175,8 +335,7 @@ void NV_API_CALL nv_start_nano_timer(
     NvU64 time_ns)
 {
 #if NV_NANO_TIMER_USE_HRTIMER
-    ktime_t ktime = ktime_set(0, time_ns);
-    hrtimer_start(&nv_nstimer->hr_timer, ktime, HRTIMER_MODE_REL);
+    nv_nano_timer_hr_start(nv_nstimer, time_ns);
 #else
     NvU32 time_us;
 
@@ -203,7 +362,7 @@ void NV_API_CALL nv_cancel_nano_timer(
     nv_nano_timer_t *nv_nstimer)
 {
 #if NV_NANO_TIMER_USE_HRTIMER
-    hrtimer_cancel(&nv_nstimer->hr_timer);
+    nv_nano_timer_hr_cancel(nv_nstimer);
 #else
     remove_timer(kernel_timers, &nv_nstimer->jiffy_timer, 0);
 #endif
@@ -0,0 +1,89 @@
+#include "nv-nanos.h"
+
+/*
+ * Without firmware topology, nodes are modelled the way the common
+ * dual-socket platforms enumerate them: CPUs are numbered socket by socket,
+ * and the PCI bus number space is split between the root complexes of the
+ * sockets in ascending order.
+ */
+
+static struct {
+    int node_count;
+    int cpu_count;
+    struct cpumask node_cpus[NV_MAX_NUMNODES];
+} nv_numa = {
+    .node_count = 1,
+};
+
+void nv_numa_init(void)
+{
+    int node_count = NVreg_NumaNodeCount;
+    int cpu_count = MIN(present_processors, NV_MAX_CPUS);
+    int cpu;
+
+    if (node_count < 1)
+        node_count = 1;
+    if (node_count > NV_MAX_NUMNODES)
+        node_count = NV_MAX_NUMNODES;
+    if (node_count > cpu_count)
+        node_count = cpu_count;
+
+    memset(nv_numa.node_cpus, 0, sizeof(nv_numa.node_cpus));
+    nv_numa.node_count = node_count;
+    nv_numa.cpu_count = cpu_count;
+
+    for (cpu = 0; cpu < cpu_count; cpu++)
+    {
+        int node = nv_cpu_to_node(cpu);
+
+        nv_numa.node_cpus[node].bits[cpu / 64] |= U64_FROM_BIT(cpu % 64);
+    }
+
+    if (node_count > 1)
+        nv_printf(NV_DBG_INFO, "NVRM: %d CPUs split over %d NUMA nodes\n",
+                  cpu_count, node_count);
+}
+
+int nv_num_nodes(void)
+{
+    return nv_numa.node_count;
+}
+
+int nv_cpu_to_node(int cpu)
+{
+    if ((nv_numa.node_count <= 1) || (cpu < 0) || (cpu >= nv_numa.cpu_count))
+        return 0;
+
+    return (cpu * nv_numa.node_count) / nv_numa.cpu_count;
+}
+
+const struct cpumask *nv_cpumask_of_node(int node)
+{
+    if ((node < 0) || (node >= nv_numa.node_count))
+        return NULL;
+
+    return &nv_numa.node_cpus[node];
+}
+
+//
+// Returns the node closest to the device, or NUMA_NO_NODE on single-node
+// systems so that callers keep their topology-agnostic paths.
+//
+int nv_pci_dev_to_node(struct pci_dev *d)
+{
+    if ((d == NULL) || (nv_numa.node_count <= 1))
+        return NUMA_NO_NODE;
+
+    return (d->bus * nv_numa.node_count) / 256;
+}
+
+//
+// Returns the linear-backed heap that node-directed allocations of the node
+// come from. The kernel keeps a single physical memory pool, which backs every
+// node; node affinity is still resolved by the callers, so that this is the
+// only place that changes once the kernel provides per-node heaps.
+//
+heap nv_numa_node_heap(int node)
+{
+    return (heap)heap_linear_backed(get_kernel_heaps());
+}
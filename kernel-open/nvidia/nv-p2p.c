@@ -39,6 +39,7 @@ typedef enum nv_p2p_page_table_type {
 typedef struct nv_p2p_dma_mapping {
     struct list list_node;
     struct nvidia_p2p_dma_mapping *dma_mapping;
+    NvU32 refcount;
 } nv_p2p_dma_mapping_t;
 
 typedef struct nv_p2p_mem_info {
@@ -50,8 +51,93 @@ typedef struct nv_p2p_mem_info {
         struct semaphore lock;
     } dma_mapping_list;
     void *private;
+    struct {
+        struct rbnode rb_node;
+        NvU64 virtual_address;
+        NvU64 length;
+        NvU32 refcount;
+        NvBool inserted;
+    } cache;
 } nv_p2p_mem_info_t;
 
+/*
+ * Registration cache for persistent page tables.
+ *
+ * RDMA users register the same GPU buffers over and over, so a persistent
+ * page table is kept in a tree keyed by its GPU VA range and refcounted, and
+ * a repeat nvidia_p2p_get_pages_persistent() of the same range only costs a
+ * lookup. DMA mappings of a page table are likewise shared per peer device.
+ * An entry leaves the tree when its last reference is put, or when RM tears
+ * the page table down (nv_p2p_free_page_table()).
+ *
+ * Non-persistent page tables are not cached: each one carries the free
+ * callback of its caller, and nvidia_p2p_put_pages() gives no way to tell
+ * sharers apart.
+ */
+declare_closure_struct(0, 2, int, nv_p2p_cache_compare,
+                       rbnode, a, rbnode, b);
+declare_closure_struct(0, 1, boolean, nv_p2p_cache_print,
+                       rbnode, n);
+static struct
+{
+    struct rbtree tree;
+    struct semaphore lock;
+    closure_struct(nv_p2p_cache_compare, compare);
+    closure_struct(nv_p2p_cache_print, print);
+} nv_p2p_cache;
+
+#define NV_P2P_CACHE_ENTRY(n) \
+    struct_from_field(n, nv_p2p_mem_info_t *, cache.rb_node)
+
+define_closure_function(0, 2, int, nv_p2p_cache_compare,
+                        rbnode, a, rbnode, b)
+{
+    nv_p2p_mem_info_t *ma = NV_P2P_CACHE_ENTRY(a);
+    nv_p2p_mem_info_t *mb = NV_P2P_CACHE_ENTRY(b);
+
+    if (ma->cache.virtual_address != mb->cache.virtual_address)
+        return (ma->cache.virtual_address < mb->cache.virtual_address) ? -1 : 1;
+    if (ma->cache.length != mb->cache.length)
+        return (ma->cache.length < mb->cache.length) ? -1 : 1;
+    return 0;
+}
+
+define_closure_function(0, 1, boolean, nv_p2p_cache_print,
+                        rbnode, n)
+{
+    rprintf(" 0x%lx", NV_P2P_CACHE_ENTRY(n)->cache.virtual_address);
+    return true;
+}
+
+void nv_p2p_init(void)
+{
+    NV_INIT_MUTEX(&nv_p2p_cache.lock);
+    init_rbtree(&nv_p2p_cache.tree,
+                init_closure(&nv_p2p_cache.compare, nv_p2p_cache_compare),
+                init_closure(&nv_p2p_cache.print, nv_p2p_cache_print));
+}
+
+// Called with nv_p2p_cache.lock held. Takes a reference on a hit.
+static struct nvidia_p2p_page_table *nv_p2p_cache_get(
+    NvU64 virtual_address,
+    NvU64 length
+)
+{
+    nv_p2p_mem_info_t k;
+    rbnode n;
+
+    k.cache.virtual_address = virtual_address;
+    k.cache.length = length;
+
+    n = rbtree_lookup(&nv_p2p_cache.tree, &k.cache.rb_node);
+    if (n == INVALID_ADDRESS)
+        return NULL;
+
+    NV_P2P_CACHE_ENTRY(n)->cache.refcount++;
+
+    return &NV_P2P_CACHE_ENTRY(n)->page_table;
+}
+
 // declared and created in nv.c
 extern void *nvidia_p2p_page_t_cache;
 
@@ -131,6 +217,7 @@ static NV_STATUS nv_p2p_insert_dma_mapping(
     down(&mem_info->dma_mapping_list.lock);
 
     node->dma_mapping = dma_mapping;
+    node->refcount = 1;
     list_add_tail(&node->list_node, &mem_info->dma_mapping_list.list_head);
 
     up(&mem_info->dma_mapping_list.lock);
@@ -152,6 +239,12 @@ static struct nvidia_p2p_dma_mapping* nv_p2p_remove_dma_mapping(
     {
         if (dma_mapping == NULL || dma_mapping == cur->dma_mapping)
         {
+            // Other users of a shared mapping keep it alive.
+            if ((dma_mapping != NULL) && (--cur->refcount > 0))
+            {
+                break;
+            }
+
             ret_dma_mapping = cur->dma_mapping;
             list_del(&cur->list_node);
             os_free_mem(cur);
@@ -164,6 +257,31 @@ static struct nvidia_p2p_dma_mapping* nv_p2p_remove_dma_mapping(
     return ret_dma_mapping;
 }
 
+static struct nvidia_p2p_dma_mapping* nv_p2p_get_dma_mapping(
+    struct nv_p2p_mem_info *mem_info,
+    struct pci_dev *peer
+)
+{
+    struct nv_p2p_dma_mapping *cur;
+    struct nvidia_p2p_dma_mapping *ret_dma_mapping = NULL;
+
+    down(&mem_info->dma_mapping_list.lock);
+
+    list_for_each_entry(cur, &mem_info->dma_mapping_list.list_head, list_node)
+    {
+        if (cur->dma_mapping->pci_dev == peer)
+        {
+            cur->refcount++;
+            ret_dma_mapping = cur->dma_mapping;
+            break;
+        }
+    }
+
+    up(&mem_info->dma_mapping_list.lock);
+
+    return ret_dma_mapping;
+}
+
 static void nv_p2p_free_dma_mapping(
     struct nvidia_p2p_dma_mapping *dma_mapping
 )
@@ -211,6 +329,14 @@ static void nv_p2p_free_page_table(
 
     mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
 
+    down(&nv_p2p_cache.lock);
+    if (mem_info->cache.inserted)
+    {
+        rbtree_remove_node(&nv_p2p_cache.tree, &mem_info->cache.rb_node);
+        mem_info->cache.inserted = NV_FALSE;
+    }
+    up(&nv_p2p_cache.lock);
+
     dma_mapping = nv_p2p_remove_dma_mapping(mem_info, NULL);
     while (dma_mapping != NULL)
     {
@@ -590,14 +716,60 @@ int nvidia_p2p_get_pages_persistent(
     uint32_t flags
 )
 {
+    struct nvidia_p2p_page_table *cached;
+    struct nv_p2p_mem_info *mem_info;
+    int rc;
+
     if (flags != 0)
     {
         return -EINVAL;
     }
 
-    return nv_p2p_get_pages(NV_P2P_PAGE_TABLE_TYPE_PERSISTENT, 0, 0,
-                            virtual_address, length, page_table,
-                            NULL, NULL);
+    down(&nv_p2p_cache.lock);
+    cached = nv_p2p_cache_get(virtual_address, length);
+    up(&nv_p2p_cache.lock);
+
+    if (cached != NULL)
+    {
+        *page_table = cached;
+        return 0;
+    }
+
+    rc = nv_p2p_get_pages(NV_P2P_PAGE_TABLE_TYPE_PERSISTENT, 0, 0,
+                          virtual_address, length, page_table,
+                          NULL, NULL);
+    if (rc != 0)
+    {
+        return rc;
+    }
+
+    mem_info = container_of(*page_table, nv_p2p_mem_info_t, page_table);
+    mem_info->cache.virtual_address = virtual_address;
+    mem_info->cache.length = length;
+    mem_info->cache.refcount = 1;
+
+    //
+    // RM is not called with the cache lock held, so a concurrent caller may
+    // have registered the same range meanwhile; keep its entry then.
+    //
+    down(&nv_p2p_cache.lock);
+    cached = nv_p2p_cache_get(virtual_address, length);
+    if (cached == NULL)
+    {
+        init_rbnode(&mem_info->cache.rb_node);
+        rbtree_insert_node(&nv_p2p_cache.tree, &mem_info->cache.rb_node);
+        mem_info->cache.inserted = NV_TRUE;
+    }
+    up(&nv_p2p_cache.lock);
+
+    if (cached != NULL)
+    {
+        mem_info->cache.refcount = 0;
+        nvidia_p2p_put_pages_persistent(virtual_address, *page_table, 0);
+        *page_table = cached;
+    }
+
+    return 0;
 }
 EXPORT_SYMBOL(nvidia_p2p_get_pages_persistent);
 
@@ -653,6 +825,7 @@ int nvidia_p2p_put_pages_persistent(
 )
 {
     NvU8 uuid[NVIDIA_P2P_GPU_UUID_LEN] = {0};
+    struct nv_p2p_mem_info *mem_info;
     NV_STATUS status;
     nvidia_stack_t *sp = NULL;
     int rc = 0;
@@ -667,6 +840,21 @@ int nvidia_p2p_put_pages_persistent(
         return 0;
     }
 
+    mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
+
+    down(&nv_p2p_cache.lock);
+    if ((mem_info->cache.refcount > 0) && (--mem_info->cache.refcount > 0))
+    {
+        up(&nv_p2p_cache.lock);
+        return 0;
+    }
+    if (mem_info->cache.inserted)
+    {
+        rbtree_remove_node(&nv_p2p_cache.tree, &mem_info->cache.rb_node);
+        mem_info->cache.inserted = NV_FALSE;
+    }
+    up(&nv_p2p_cache.lock);
+
     rc = nv_kmem_cache_alloc_stack(&sp);
     if (rc != 0)
     {
@@ -712,6 +900,12 @@ int nvidia_p2p_dma_map_pages(
 
     mem_info = container_of(page_table, nv_p2p_mem_info_t, page_table);
 
+    *dma_mapping = nv_p2p_get_dma_mapping(mem_info, peer);
+    if (*dma_mapping != NULL)
+    {
+        return 0;
+    }
+
     rc = nv_kmem_cache_alloc_stack(&sp);
     if (rc != 0)
     {
@@ -855,6 +1049,187 @@ int nvidia_p2p_free_dma_mapping(
 
 EXPORT_SYMBOL(nvidia_p2p_free_dma_mapping);
 
+typedef struct nv_p2p_net_region {
+    struct nvidia_p2p_net_region region;
+    struct nvidia_p2p_page_table *page_table;
+    struct nvidia_p2p_dma_mapping *dma_mapping;
+} nv_p2p_net_region_t;
+
+//
+// Merge the per-GPU-page DMA addresses into extents. BAR1 mappings of a
+// vidmem allocation are usually contiguous, so large registrations collapse
+// into a handful of extents.
+//
+static NvU32 nv_p2p_net_build_extents(
+    struct nvidia_p2p_dma_mapping *dma_mapping,
+    NvU64 page_size,
+    struct nvidia_p2p_net_extent *extents
+)
+{
+    NvU32 count = 0;
+    NvU32 i;
+
+    for (i = 0; i < dma_mapping->entries; i++)
+    {
+        NvU64 dma_address = dma_mapping->dma_addresses[i];
+
+        if ((count > 0) &&
+            (extents[count - 1].dma_address + extents[count - 1].length == dma_address))
+        {
+            extents[count - 1].length += page_size;
+            continue;
+        }
+
+        extents[count].offset = (NvU64)i * page_size;
+        extents[count].dma_address = dma_address;
+        extents[count].length = page_size;
+        count++;
+    }
+
+    return count;
+}
+
+int nvidia_p2p_net_register(
+    struct pci_dev *nic,
+    uint64_t virtual_address,
+    uint64_t length,
+    struct nvidia_p2p_net_region **region
+)
+{
+    nv_p2p_net_region_t *net_region = NULL;
+    struct nvidia_p2p_net_extent *extents = NULL;
+    NV_STATUS status;
+    NvU64 page_size;
+    int rc;
+
+    if ((nic == NULL) || (region == NULL) || (length == 0))
+    {
+        return -EINVAL;
+    }
+
+    status = os_alloc_mem((void **)&net_region, sizeof(*net_region));
+    if (status != NV_OK)
+    {
+        return -ENOMEM;
+    }
+    memset(net_region, 0, sizeof(*net_region));
+
+    rc = nvidia_p2p_get_pages_persistent(virtual_address, length,
+                                         &net_region->page_table, 0);
+    if (rc != 0)
+    {
+        goto failed;
+    }
+
+    rc = nvidia_p2p_dma_map_pages(nic, net_region->page_table,
+                                  &net_region->dma_mapping);
+    if (rc != 0)
+    {
+        goto put_pages;
+    }
+
+    status = os_alloc_mem((void **)&extents,
+                          net_region->dma_mapping->entries * sizeof(*extents));
+    if (status != NV_OK)
+    {
+        rc = -ENOMEM;
+        goto unmap_pages;
+    }
+
+    page_size = nvidia_p2p_page_size_mappings[net_region->dma_mapping->page_size_type];
+
+    net_region->region.version = NVIDIA_P2P_NET_REGION_VERSION;
+    net_region->region.extent_count =
+        nv_p2p_net_build_extents(net_region->dma_mapping, page_size, extents);
+    net_region->region.virtual_address = virtual_address;
+    net_region->region.length = length;
+    net_region->region.extents = extents;
+    net_region->region.pci_dev = nic;
+
+    *region = &net_region->region;
+
+    return 0;
+
+unmap_pages:
+    nvidia_p2p_dma_unmap_pages(nic, net_region->page_table,
+                               net_region->dma_mapping);
+
+put_pages:
+    nvidia_p2p_put_pages_persistent(virtual_address, net_region->page_table, 0);
+
+failed:
+    os_free_mem(net_region);
+
+    return rc;
+}
+
+EXPORT_SYMBOL(nvidia_p2p_net_register);
+
+int nvidia_p2p_net_dma_address(
+    struct nvidia_p2p_net_region *region,
+    uint64_t offset,
+    uint64_t *dma_address,
+    uint64_t *contig_length
+)
+{
+    NvU32 lo = 0;
+    NvU32 hi;
+
+    if ((region == NULL) || (offset >= region->length))
+    {
+        return -EINVAL;
+    }
+
+    // Extents are sorted by offset and cover the region without gaps.
+    hi = region->extent_count;
+    while (hi - lo > 1)
+    {
+        NvU32 mid = lo + (hi - lo) / 2;
+
+        if (region->extents[mid].offset <= offset)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    offset -= region->extents[lo].offset;
+    *dma_address = region->extents[lo].dma_address + offset;
+    *contig_length = NV_MIN(region->extents[lo].length,
+                            region->length - region->extents[lo].offset) - offset;
+
+    return 0;
+}
+
+EXPORT_SYMBOL(nvidia_p2p_net_dma_address);
+
+int nvidia_p2p_net_unregister(
+    struct nvidia_p2p_net_region *region
+)
+{
+    nv_p2p_net_region_t *net_region;
+    int rc;
+
+    if (region == NULL)
+    {
+        return -EINVAL;
+    }
+
+    net_region = container_of(region, nv_p2p_net_region_t, region);
+
+    nvidia_p2p_dma_unmap_pages(region->pci_dev, net_region->page_table,
+                               net_region->dma_mapping);
+
+    rc = nvidia_p2p_put_pages_persistent(region->virtual_address,
+                                         net_region->page_table, 0);
+
+    os_free_mem(region->extents);
+    os_free_mem(net_region);
+
+    return rc;
+}
+
+EXPORT_SYMBOL(nvidia_p2p_net_unregister);
+
 int nvidia_p2p_register_rsync_driver(
     nvidia_p2p_rsync_driver_t *driver,
     void *data
@@ -367,6 +367,99 @@ int nvidia_p2p_free_page_table(struct nvidia_p2p_page_table *page_table);
  */
 int nvidia_p2p_free_dma_mapping(struct nvidia_p2p_dma_mapping *dma_mapping);
 
+/*
+ * A range of GPU memory pinned and DMA-mapped for one network device, so
+ * that the device's send and receive descriptors can point straight at it.
+ * The mapping is described as physically contiguous extents in DMA address
+ * space, which is the form descriptor rings consume.
+ */
+#define NVIDIA_P2P_NET_REGION_VERSION   0x00010001
+
+#define NVIDIA_P2P_NET_REGION_VERSION_COMPATIBLE(p) \
+    NVIDIA_P2P_VERSION_COMPATIBLE(p, NVIDIA_P2P_NET_REGION_VERSION)
+
+typedef struct nvidia_p2p_net_extent {
+    uint64_t offset;        /* from the start of the region */
+    uint64_t dma_address;
+    uint64_t length;
+} nvidia_p2p_net_extent_t;
+
+typedef
+struct nvidia_p2p_net_region {
+    uint32_t version;
+    uint32_t extent_count;
+    uint64_t virtual_address;
+    uint64_t length;
+    struct nvidia_p2p_net_extent *extents;
+    struct pci_dev *pci_dev;
+} nvidia_p2p_net_region_t;
+
+/*
+ * @brief
+ *   Pin a range of GPU virtual memory and map it for DMA by a network device.
+ *
+ *   The pages are pinned persistently, so the region stays valid until
+ *   nvidia_p2p_net_unregister() is called. This API may sleep.
+ *
+ * @param[in]     nic
+ *   The struct pci_dev * of the network device.
+ * @param[in]     virtual_address
+ *   The start address in the GPU virtual address space, aligned to 64KB.
+ * @param[in]     length
+ *   The length of the range, a multiple of 64KB.
+ * @param[out]    region
+ *   The registered region.
+ *
+ * @return
+ *    0           upon successful completion.
+ *    -EINVAL     if an invalid argument was supplied.
+ *    -ENOMEM     if the driver failed to allocate memory.
+ *    -ENOTSUPP   if the requested operation is not supported.
+ *    -EIO        if an unknown error occurred.
+ */
+int nvidia_p2p_net_register(struct pci_dev *nic,
+        uint64_t virtual_address, uint64_t length,
+        struct nvidia_p2p_net_region **region);
+
+/*
+ * @brief
+ *   Translate an offset into a registered region to a DMA address.
+ *
+ *   This API does not sleep, so it can be used while filling descriptors.
+ *
+ * @param[in]     region
+ *   A region returned by nvidia_p2p_net_register().
+ * @param[in]     offset
+ *   The offset into the region.
+ * @param[out]    dma_address
+ *   The DMA address of the byte at offset.
+ * @param[out]    contig_length
+ *   The number of bytes from offset that are contiguous in DMA address space.
+ *
+ * @return
+ *    0           upon successful completion.
+ *    -EINVAL     if offset is outside the region.
+ */
+int nvidia_p2p_net_dma_address(struct nvidia_p2p_net_region *region,
+        uint64_t offset, uint64_t *dma_address, uint64_t *contig_length);
+
+/*
+ * @brief
+ *   Unmap and unpin a region registered with nvidia_p2p_net_register().
+ *
+ *   The network device must have stopped using the region's DMA addresses.
+ *   This API may sleep.
+ *
+ * @param[in]     region
+ *   The region to release.
+ *
+ * @return
+ *    0           upon successful completion.
+ *    -EINVAL     if an invalid argument was supplied.
+ *    -EIO        if an unknown error occurred.
+ */
+int nvidia_p2p_net_unregister(struct nvidia_p2p_net_region *region);
+
 #define NVIDIA_P2P_RSYNC_DRIVER_VERSION   0x00010001
 
 #define NVIDIA_P2P_RSYNC_DRIVER_VERSION_COMPATIBLE(p) \
@@ -201,6 +201,7 @@ nv_procfs_read_power(
     const char *dynamic_power_status;
     const char *gc6_support;
     const char *gcoff_support;
+    nv_dynamic_power_stats_t stats;
 
     if (nv_kmem_cache_alloc_stack(&sp) != 0)
     {
@@ -220,6 +221,16 @@ nv_procfs_read_power(
     gcoff_support = rm_get_gpu_gcx_support(sp, nv, NV_FALSE);
     seq_printf(s, " Video Memory Off:          %s\n", gcoff_support);
 
+    rm_get_dynamic_power_stats(sp, nv, &stats);
+    seq_printf(s, "\nRuntime D3 Transitions:\n");
+    seq_printf(s, " GC6 Entries:               %u\n", stats.gc6_entries);
+    seq_printf(s, " GCOFF Entries:             %u\n", stats.gcoff_entries);
+    seq_printf(s, " Predicted Idle Time:       %llu us\n", stats.predicted_idle_us);
+    seq_printf(s, " Last Exit:                 %s, %llu us (lock %llu us, resume %llu us)\n",
+               stats.last_exit_gcoff ? "GCOFF" : "GC6", stats.last_exit_total_us,
+               stats.last_exit_lock_us, stats.last_exit_resume_us);
+    seq_printf(s, " Max Exit:                  %llu us\n", stats.max_exit_total_us);
+
     nv_kmem_cache_free_stack(sp);
     return 0;
 }
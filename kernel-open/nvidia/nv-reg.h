@@ -827,6 +827,112 @@
 #define __NV_RM_NVLINK_BW RmNvlinkBandwidth
 #define NV_RM_NVLINK_BW NV_REG_STRING(__NV_RM_NVLINK_BW)
 
+/*
+ * Option: NumaNodeCount
+ *
+ * Description:
+ *
+ * Nanos does not expose the platform NUMA topology. This option tells the
+ * driver how many NUMA nodes (CPU sockets) the system has. CPUs are assigned
+ * to nodes in contiguous, equally sized blocks, and each GPU to the node
+ * owning its share of the PCI bus number space. Kernel queues serving a GPU
+ * are then placed on the CPUs of its node.
+ *
+ * Possible Values:
+ *  1 = single node, no placement (default)
+ *  N = N nodes (at most 8)
+ */
+#define __NV_NUMA_NODE_COUNT NumaNodeCount
+#define NV_REG_NUMA_NODE_COUNT NV_REG_STRING(__NV_NUMA_NODE_COUNT)
+
+/*
+ * Option: NanoTimerSlack
+ *
+ * Description:
+ *
+ * RM nano timers whose deadlines fall within this many nanoseconds of each
+ * other are expired together by a single kernel timer interrupt. Larger
+ * values save wakeups at the cost of running timers up to this late.
+ *
+ * Default value: 10000 (10 usec)
+ */
+#define __NV_NANO_TIMER_SLACK NanoTimerSlack
+#define NV_REG_NANO_TIMER_SLACK NV_REG_STRING(__NV_NANO_TIMER_SLACK)
+
+/*
+ * Option: MsixPerVector
+ *
+ * Description:
+ *
+ * When this option is enabled, each MSI-X vector gets its own top half and
+ * bottom half. The UVM top half runs without the per-device ISR lock, and
+ * bottom halves for different vectors run concurrently on their own
+ * alt-stacks. Only the RM top half stays serialized across vectors. When
+ * disabled, all vectors are serialized through one top half and one bottom
+ * half.
+ *
+ * Possible Values:
+ *  0 = serialize all MSI-X vectors
+ *  1 = service MSI-X vectors independently (default)
+ */
+#define __NV_MSIX_PER_VECTOR MsixPerVector
+#define NV_REG_MSIX_PER_VECTOR NV_REG_STRING(__NV_MSIX_PER_VECTOR)
+
+/*
+ * Option: MmapLargePages
+ *
+ * Description:
+ *
+ * When this option is enabled, physically contiguous runs of a system memory
+ * allocation are installed into a user mapping with a single remap, which
+ * lets the kernel use 2 MiB and 1 GiB page table entries wherever the user
+ * address and the physical address are equally aligned. When disabled,
+ * system memory is mapped one 4 KiB page at a time.
+ *
+ * Possible Values:
+ *  0 = map system memory with 4 KiB pages
+ *  1 = map contiguous runs with the largest possible pages (default)
+ */
+#define __NV_MMAP_LARGE_PAGES MmapLargePages
+#define NV_REG_MMAP_LARGE_PAGES NV_REG_STRING(__NV_MMAP_LARGE_PAGES)
+
+/*
+ * Option: InitDevicesAtLoad
+ *
+ * Description:
+ *
+ * When this option is enabled, every GPU is brought up (RM adapter init, GSP
+ * boot, NVLink training) from the driver's work queue right after the module
+ * has loaded, instead of on the first open of the device. Devices are started
+ * concurrently and stay initialized until the module is unloaded, so the
+ * first application to open a GPU does not pay for its initialization, and
+ * later closes do not tear it down. Parts of adapter init that hold the RM API
+ * lock still run one GPU at a time.
+ *
+ * Possible Values:
+ *  0 = initialize a GPU on its first open (default)
+ *  1 = initialize all GPUs at module load and keep them initialized
+ */
+#define __NV_INIT_DEVICES_AT_LOAD InitDevicesAtLoad
+#define NV_REG_INIT_DEVICES_AT_LOAD NV_REG_STRING(__NV_INIT_DEVICES_AT_LOAD)
+
+/*
+ * Option: UvmPerfTunables
+ *
+ * Description:
+ *
+ * Module parameters of the UVM performance heuristics cannot be set at load
+ * time on Nanos. This option overrides their defaults with a comma-separated
+ * list of name=value pairs, using the module parameter names, e.g.
+ * "uvm_perf_prefetch_threshold=75,uvm_perf_thrashing_enable=0". Every VA
+ * space starts with these values and can change them at runtime with
+ * UVM_SET_PERF_TUNABLE. Unknown names and out-of-range values are ignored.
+ *
+ * Default value: NULL (use the module parameter defaults)
+ */
+#define __NV_UVM_PERF_TUNABLES UvmPerfTunables
+#define NV_REG_UVM_PERF_TUNABLES NV_REG_STRING(__NV_UVM_PERF_TUNABLES)
+
 #if defined(NV_DEFINE_REGISTRY_KEY_TABLE)
 
 /*
@@ -865,6 +971,11 @@ NV_DEFINE_REG_ENTRY_GLOBAL(__NV_ENABLE_PCIE_RELAXED_ORDERING_MODE, 0);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_REGISTER_PCI_DRIVER, 1);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_ENABLE_RESIZABLE_BAR, 0);
 NV_DEFINE_REG_ENTRY_GLOBAL(__NV_ENABLE_DBG_BREAKPOINT, 0);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_NUMA_NODE_COUNT, 1);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_NANO_TIMER_SLACK, 10000);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_MSIX_PER_VECTOR, 1);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_MMAP_LARGE_PAGES, 1);
+NV_DEFINE_REG_ENTRY_GLOBAL(__NV_INIT_DEVICES_AT_LOAD, 0);
 
 NV_DEFINE_REG_STRING_ENTRY(__NV_REGISTRY_DWORDS, NULL);
 NV_DEFINE_REG_STRING_ENTRY(__NV_REGISTRY_DWORDS_PER_DEVICE, NULL);
@@ -874,6 +985,7 @@ NV_DEFINE_REG_STRING_ENTRY(__NV_TEMPORARY_FILE_PATH, NULL);
 NV_DEFINE_REG_STRING_ENTRY(__NV_EXCLUDED_GPUS, NULL);
 NV_DEFINE_REG_ENTRY(__NV_DMA_REMAP_PEER_MMIO, NV_DMA_REMAP_PEER_MMIO_ENABLE);
 NV_DEFINE_REG_STRING_ENTRY(__NV_RM_NVLINK_BW, NULL);
+NV_DEFINE_REG_STRING_ENTRY(__NV_UVM_PERF_TUNABLES, NULL);
 
 /*
  *----------------registry database definition----------------------
@@ -920,6 +1032,11 @@ nv_parm_t nv_parms[] = {
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_ENABLE_DBG_BREAKPOINT),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_OPENRM_ENABLE_UNSUPPORTED_GPUS),
     NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_DMA_REMAP_PEER_MMIO),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_NUMA_NODE_COUNT),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_NANO_TIMER_SLACK),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_MSIX_PER_VECTOR),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_MMAP_LARGE_PAGES),
+    NV_DEFINE_PARAMS_TABLE_ENTRY(__NV_INIT_DEVICES_AT_LOAD),
     {NULL, NULL}
 };
 
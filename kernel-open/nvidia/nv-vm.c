@@ -200,12 +200,45 @@ static inline void nv_set_memory_type(nv_alloc_t *at, NvU32 type)
     // If the set_{memory,page}_array_* functions aren't present in the kernel
     // interface, each page has to be set individually, which has been measured
     // to be ~10x slower than using the set_{memory,page}_array_* functions.
+    // Chunks that are virtually contiguous are changed with one call.
     //
     else
     {
-        for (i = 0; i < at->num_pages; i++)
-            nv_set_contig_memory_type(at->page_table[i], 1, type);
+        NvU32 run_start = 0;
+        NvU32 run_pages = 0;
+
+        for (i = 0; i < at->num_pages; i += at->page_table[i]->chunk_pages)
+        {
+            nvidia_pte_t *page_ptr = at->page_table[i];
+
+            if ((run_pages != 0) &&
+                (page_ptr->virt_addr == at->page_table[run_start]->virt_addr +
+                                        run_pages * PAGE_SIZE))
+            {
+                run_pages += page_ptr->chunk_pages;
+                continue;
+            }
+
+            if (run_pages != 0)
+                nv_set_contig_memory_type(at->page_table[run_start], run_pages, type);
+
+            run_start = i;
+            run_pages = page_ptr->chunk_pages;
+        }
+
+        if (run_pages != 0)
+            nv_set_contig_memory_type(at->page_table[run_start], run_pages, type);
     }
+
+#if defined(NVCPU_X86_64)
+    //
+    // Write back and drop any line of the pages still cached, and any stale
+    // translation, on every CPU once for the whole allocation, now that they
+    // are no longer mapped cacheable.
+    //
+    if (type == NV_MEMORY_UNCACHED)
+        CACHE_FLUSH_ALL();
+#endif
 }
 
 /*
@@ -289,7 +322,7 @@ NV_STATUS nv_alloc_contig_pages(
 {
     NV_STATUS status;
     nvidia_pte_t *page_ptr;
-    NvU32 i, j;
+    NvU32 i = 0, j;
     unsigned long virt_addr = 0;
     NvU64 phys_addr;
     struct device *dev = at->dev;
@@ -331,18 +364,19 @@ NV_STATUS nv_alloc_contig_pages(
         memset((void *)virt_addr, 0, (at->num_pages * PAGE_SIZE));
 #endif
 
-    for (i = 0; i < at->num_pages; i++, virt_addr += PAGE_SIZE)
+    // The allocation is physically contiguous, only look up its base.
+    phys_addr = nv_get_kern_phys_address(virt_addr);
+    if (phys_addr == 0)
     {
-        phys_addr = nv_get_kern_phys_address(virt_addr);
-        if (phys_addr == 0)
-        {
-            nv_printf(NV_DBG_ERRORS,
-                "NVRM: VM: %s: failed to look up physical address\n",
-                __FUNCTION__);
-            status = NV_ERR_OPERATING_SYSTEM;
-            goto failed;
-        }
+        nv_printf(NV_DBG_ERRORS,
+            "NVRM: VM: %s: failed to look up physical address\n",
+            __FUNCTION__);
+        status = NV_ERR_OPERATING_SYSTEM;
+        goto failed;
+    }
 
+    for (i = 0; i < at->num_pages; i++, virt_addr += PAGE_SIZE, phys_addr += PAGE_SIZE)
+    {
         page_ptr = at->page_table[i];
         page_ptr->phys_addr = phys_addr;
         page_ptr->page_count = NV_GET_PAGE_COUNT(page_ptr);
@@ -419,6 +453,49 @@ void nv_free_contig_pages(
     NV_FREE_PAGES(page_ptr->virt_addr, at->order);
 }
 
+/*
+ * Non-coherent system memory is allocated in the largest physically
+ * contiguous chunks (1 GiB, 2 MiB, then single pages) that fit the remaining
+ * size. The first entry of each chunk records the chunk size, so that the
+ * chunk can be released in one go and later handled as one extent.
+ */
+#define NV_SYSMEM_CHUNK_ORDER_2M    (21 - PAGE_SHIFT)
+#define NV_SYSMEM_CHUNK_ORDER_1G    (30 - PAGE_SHIFT)
+
+static inline NvU32 nv_sysmem_chunk_order(NvU32 remaining_pages, NvS32 max_order)
+{
+    if ((max_order >= NV_SYSMEM_CHUNK_ORDER_1G) &&
+        (remaining_pages >= (1U << NV_SYSMEM_CHUNK_ORDER_1G)))
+    {
+        return NV_SYSMEM_CHUNK_ORDER_1G;
+    }
+
+    if ((max_order >= NV_SYSMEM_CHUNK_ORDER_2M) &&
+        (remaining_pages >= (1U << NV_SYSMEM_CHUNK_ORDER_2M)))
+    {
+        return NV_SYSMEM_CHUNK_ORDER_2M;
+    }
+
+    return 0;
+}
+
+static void nv_free_system_chunk(
+    nv_alloc_t *at,
+    nvidia_pte_t *page_ptr
+)
+{
+    backed_heap bh = heap_page_backed(get_kernel_heaps());
+
+    if (at->flags.coherent)
+    {
+        dealloc_unmap(bh, (void *)page_ptr->virt_addr, page_ptr->dma_addr, PAGE_SIZE);
+    }
+    else
+    {
+        NV_FREE_PAGES(page_ptr->virt_addr, find_order(page_ptr->chunk_pages));
+    }
+}
+
 NV_STATUS nv_alloc_system_pages(
     nv_state_t *nv,
     nv_alloc_t *at
@@ -426,7 +503,9 @@ NV_STATUS nv_alloc_system_pages(
 {
     NV_STATUS status;
     nvidia_pte_t *page_ptr;
-    NvU32 i, j;
+    NvU32 i, j, k;
+    NvU32 order, chunk_pages;
+    NvS32 max_order = NV_SYSMEM_CHUNK_ORDER_1G;
     backed_heap bh = heap_page_backed(get_kernel_heaps());
     unsigned long virt_addr = 0;
     NvU64 phys_addr;
@@ -436,8 +515,10 @@ NV_STATUS nv_alloc_system_pages(
     nv_printf(NV_DBG_MEMINFO,
             "NVRM: VM: %s: %u pages\n", __FUNCTION__, at->num_pages);
 
-    for (i = 0; i < at->num_pages; i++)
+    for (i = 0; i < at->num_pages; i += chunk_pages)
     {
+        order = 0;
+
         if (at->flags.unencrypted && (dev != NULL))
         {
             virt_addr = u64_from_pointer(alloc_map(bh, PAGE_SIZE, &bus_addr));
@@ -445,14 +526,29 @@ NV_STATUS nv_alloc_system_pages(
                 virt_addr = 0;
             at->flags.coherent = NV_TRUE;
         }
-        else if (at->flags.node)
-        {
-            NV_ALLOC_PAGES_NODE(virt_addr, at->node_id, 0);
-        }
         else
         {
-            NV_GET_FREE_PAGES(virt_addr, 0);
+            order = nv_sysmem_chunk_order(at->num_pages - i, max_order);
+            for (;;)
+            {
+                if (at->flags.node)
+                {
+                    NV_ALLOC_PAGES_NODE(virt_addr, at->node_id, order);
+                }
+                else
+                {
+                    NV_GET_FREE_PAGES(virt_addr, order);
+                }
+
+                if ((virt_addr != 0) || (order == 0))
+                    break;
+
+                // Don't retry an order that already failed for this allocation.
+                max_order = order - 1;
+                order = nv_sysmem_chunk_order(at->num_pages - i, max_order);
+            }
         }
+        chunk_pages = 1U << order;
 
         if (virt_addr == 0)
         {
@@ -463,7 +559,7 @@ NV_STATUS nv_alloc_system_pages(
         }
 #if !defined(__GFP_ZERO)
         if (at->flags.zeroed)
-            memset((void *)virt_addr, 0, PAGE_SIZE);
+            memset((void *)virt_addr, 0, chunk_pages * PAGE_SIZE);
 #endif
 
         phys_addr = nv_get_kern_phys_address(virt_addr);
@@ -472,7 +568,7 @@ NV_STATUS nv_alloc_system_pages(
             nv_printf(NV_DBG_ERRORS,
                 "NVRM: VM: %s: failed to look up physical address\n",
                 __FUNCTION__);
-            NV_FREE_PAGES(virt_addr, 0);
+            NV_FREE_PAGES(virt_addr, order);
             status = NV_ERR_OPERATING_SYSTEM;
             goto failed;
         }
@@ -484,28 +580,32 @@ NV_STATUS nv_alloc_system_pages(
             nv_printf(NV_DBG_SETUP,
                 "NVRM: VM: %s: discarding page @ 0x%llx\n",
                 __FUNCTION__, phys_addr);
-            --i;
+            chunk_pages = 0;
             continue;
         }
 #endif
 
-        page_ptr = at->page_table[i];
-        page_ptr->phys_addr = phys_addr;
-        page_ptr->page_count = NV_GET_PAGE_COUNT(page_ptr);
-        page_ptr->virt_addr = virt_addr;
-
-        //
-        // Use unencrypted dma_addr returned by dma_alloc_coherent() as
-        // nv_phys_to_dma() returns encrypted dma_addr when AMD SEV is enabled.
-        //
-        if (at->flags.coherent)
-            page_ptr->dma_addr = bus_addr;
-        else if (dev)
-            page_ptr->dma_addr = nv_phys_to_dma(dev, page_ptr->phys_addr);
-        else
-            page_ptr->dma_addr = page_ptr->phys_addr;
+        for (k = 0; k < chunk_pages; k++)
+        {
+            page_ptr = at->page_table[i + k];
+            page_ptr->phys_addr = phys_addr + k * PAGE_SIZE;
+            page_ptr->page_count = NV_GET_PAGE_COUNT(page_ptr);
+            page_ptr->virt_addr = virt_addr + k * PAGE_SIZE;
+            page_ptr->chunk_pages = (k == 0) ? chunk_pages : 0;
+
+            //
+            // Use unencrypted dma_addr returned by dma_alloc_coherent() as
+            // nv_phys_to_dma() returns encrypted dma_addr when AMD SEV is enabled.
+            //
+            if (at->flags.coherent)
+                page_ptr->dma_addr = bus_addr;
+            else if (dev)
+                page_ptr->dma_addr = nv_phys_to_dma(dev, page_ptr->phys_addr);
+            else
+                page_ptr->dma_addr = page_ptr->phys_addr;
 
-        NV_MAYBE_RESERVE_PAGE(page_ptr);
+            NV_MAYBE_RESERVE_PAGE(page_ptr);
+        }
     }
 
     if (at->cache_type != NV_MEMORY_CACHED)
@@ -514,21 +614,11 @@ NV_STATUS nv_alloc_system_pages(
     return NV_OK;
 
 failed:
-    if (i > 0)
+    for (j = 0; j < i; j += at->page_table[j]->chunk_pages)
     {
-        for (j = 0; j < i; j++)
-        {
-            page_ptr = at->page_table[j];
-            NV_MAYBE_UNRESERVE_PAGE(page_ptr);
-            if (at->flags.coherent)
-            {
-                dealloc_unmap(bh, (void *)page_ptr->virt_addr, page_ptr->dma_addr, PAGE_SIZE);
-            }
-            else
-            {
-                NV_FREE_PAGES(page_ptr->virt_addr, 0);
-            }
-        }
+        for (k = 0; k < at->page_table[j]->chunk_pages; k++)
+            NV_MAYBE_UNRESERVE_PAGE(at->page_table[j + k]);
+        nv_free_system_chunk(at, at->page_table[j]);
     }
 
     return status;
@@ -539,8 +629,7 @@ void nv_free_system_pages(
 )
 {
     nvidia_pte_t *page_ptr;
-    unsigned int i;
-    backed_heap bh = heap_page_backed(get_kernel_heaps());
+    unsigned int i, k;
 
     nv_printf(NV_DBG_MEMINFO,
             "NVRM: VM: %s: %u pages\n", __FUNCTION__, at->num_pages);
@@ -548,31 +637,28 @@ void nv_free_system_pages(
     if (at->cache_type != NV_MEMORY_CACHED)
         nv_set_memory_type(at, NV_MEMORY_WRITEBACK);
 
-    for (i = 0; i < at->num_pages; i++)
+    for (i = 0; i < at->num_pages; i += at->page_table[i]->chunk_pages)
     {
-        page_ptr = at->page_table[i];
-
-        if (NV_GET_PAGE_COUNT(page_ptr) != page_ptr->page_count)
+        for (k = 0; k < at->page_table[i]->chunk_pages; k++)
         {
-            static int count = 0;
-            if (count++ < NV_MAX_RECURRING_WARNING_MESSAGES)
+            page_ptr = at->page_table[i + k];
+
+            if (NV_GET_PAGE_COUNT(page_ptr) != page_ptr->page_count)
             {
-                nv_printf(NV_DBG_ERRORS,
-                    "NVRM: VM: %s: page count != initial page count (%u,%u)\n",
-                    __FUNCTION__, NV_GET_PAGE_COUNT(page_ptr),
-                    page_ptr->page_count);
+                static int count = 0;
+                if (count++ < NV_MAX_RECURRING_WARNING_MESSAGES)
+                {
+                    nv_printf(NV_DBG_ERRORS,
+                        "NVRM: VM: %s: page count != initial page count (%u,%u)\n",
+                        __FUNCTION__, NV_GET_PAGE_COUNT(page_ptr),
+                        page_ptr->page_count);
+                }
             }
-        }
 
-        NV_MAYBE_UNRESERVE_PAGE(page_ptr);
-        if (at->flags.coherent)
-        {
-            dealloc_unmap(bh, (void *)page_ptr->virt_addr, page_ptr->dma_addr, PAGE_SIZE);
-        }
-        else
-        {
-            NV_FREE_PAGES(page_ptr->virt_addr, 0);
+            NV_MAYBE_UNRESERVE_PAGE(page_ptr);
         }
+
+        nv_free_system_chunk(at, at->page_table[i]);
     }
 }
 
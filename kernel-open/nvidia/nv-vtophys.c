@@ -26,8 +26,22 @@
 #include "os-interface.h"
 #include "nv-nanos.h"
 
+//
+// The linear-backed region maps all of physical memory at a fixed offset, so
+// its addresses are translated without walking the page tables.
+//
+static inline NvBool nv_is_linear_backed(NvU64 address, NvU64 size)
+{
+    return (address >= LINEAR_BACKED_BASE) &&
+           (address < LINEAR_BACKED_LIMIT) &&
+           (size <= LINEAR_BACKED_LIMIT - address);
+}
+
 NvU64 NV_API_CALL nv_get_kern_phys_address(NvU64 address)
 {
+    if (nv_is_linear_backed(address, 1))
+        return address - LINEAR_BACKED_BASE;
+
     /* direct-mapped kernel address */
     if ((address >= LINEAR_BACKED_BASE) && (address < KERNEL_LIMIT))
         return physical_from_virtual(pointer_from_u64(address));
@@ -37,3 +51,38 @@ NvU64 NV_API_CALL nv_get_kern_phys_address(NvU64 address)
     return 0;
 }
 
+/*
+ * Translates page_count pages starting at the page aligned address into
+ * phys_array. Returns the number of pages translated, which is less than
+ * page_count if a page isn't mapped.
+ *
+ * Ranges in the linear-backed region are translated arithmetically. Other
+ * ranges take one page table walk per page: Nanos doesn't report the size of
+ * the mapping backing an address, so a translation can't be reused for the
+ * rest of a large page.
+ */
+NvU64 nv_vtophys_range(NvU64 address, NvU64 page_count, NvU64 *phys_array)
+{
+    NvU64 phys;
+    NvU64 i;
+
+    if (nv_is_linear_backed(address, page_count * PAGE_SIZE))
+    {
+        phys = address - LINEAR_BACKED_BASE;
+        for (i = 0; i < page_count; i++)
+            phys_array[i] = phys + i * PAGE_SIZE;
+
+        return page_count;
+    }
+
+    for (i = 0; i < page_count; i++)
+    {
+        phys = physical_from_virtual(pointer_from_u64(address + i * PAGE_SIZE));
+        if (phys == INVALID_PHYSICAL)
+            break;
+
+        phys_array[i] = phys;
+    }
+
+    return i;
+}
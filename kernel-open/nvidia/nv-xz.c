@@ -0,0 +1,174 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "os-interface.h"
+#include "nv-xz.h"
+
+#include "xz.h"
+
+#define NV_XZ_HEADER_SIZE       12
+#define NV_XZ_FOOTER_SIZE       12
+
+static const NvU8 nv_xz_header_magic[] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+static const NvU8 nv_xz_footer_magic[] = { 'Y', 'Z' };
+
+static NvU32 nv_xz_get_le32(const NvU8 *p)
+{
+    return (NvU32)p[0] | ((NvU32)p[1] << 8) |
+           ((NvU32)p[2] << 16) | ((NvU32)p[3] << 24);
+}
+
+// Decodes one multibyte integer of the index; returns NV_FALSE if malformed.
+static NvBool nv_xz_get_vli(const NvU8 **p, const NvU8 *end, NvU64 *value)
+{
+    NvU32 shift;
+
+    *value = 0;
+    for (shift = 0; shift < 63; shift += 7)
+    {
+        NvU8 byte;
+
+        if (*p >= end)
+        {
+            return NV_FALSE;
+        }
+
+        byte = *(*p)++;
+        *value |= (NvU64)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return NV_TRUE;
+        }
+    }
+
+    return NV_FALSE;
+}
+
+/*
+ * The uncompressed size is not stored in the stream header, but the index at
+ * the end of the stream records it for every block. Reading it up front lets
+ * the caller allocate the exact output buffer and decode in a single call,
+ * without a dictionary or an intermediate copy.
+ */
+NV_STATUS nv_xz_get_uncompressed_size(
+    const NvU8 *in,
+    NvU64 in_size,
+    NvU64 *out_size
+)
+{
+    const NvU8 *footer;
+    const NvU8 *p;
+    const NvU8 *end;
+    NvU64 index_size;
+    NvU64 records;
+    NvU64 total = 0;
+
+    // Stream padding: the stream may be followed by groups of four zeros.
+    while ((in_size >= 4) && (nv_xz_get_le32(in + in_size - 4) == 0))
+    {
+        in_size -= 4;
+    }
+
+    if ((in_size < NV_XZ_HEADER_SIZE + NV_XZ_FOOTER_SIZE) ||
+        (os_mem_cmp(in, nv_xz_header_magic, sizeof(nv_xz_header_magic)) != 0))
+    {
+        return NV_ERR_INVALID_DATA;
+    }
+
+    footer = in + in_size - NV_XZ_FOOTER_SIZE;
+    if (os_mem_cmp(footer + 10, nv_xz_footer_magic, sizeof(nv_xz_footer_magic)) != 0)
+    {
+        return NV_ERR_INVALID_DATA;
+    }
+
+    // Backward Size is stored in units of four bytes, minus one.
+    index_size = ((NvU64)nv_xz_get_le32(footer + 4) + 1) * 4;
+    if (index_size > in_size - NV_XZ_HEADER_SIZE - NV_XZ_FOOTER_SIZE)
+    {
+        return NV_ERR_INVALID_DATA;
+    }
+
+    p = footer - index_size;
+    end = footer;
+
+    // Index Indicator, then Number of Records and the records themselves.
+    if ((*p++ != 0x00) || !nv_xz_get_vli(&p, end, &records))
+    {
+        return NV_ERR_INVALID_DATA;
+    }
+
+    while (records-- > 0)
+    {
+        NvU64 unpadded_size;
+        NvU64 uncompressed_size;
+
+        if (!nv_xz_get_vli(&p, end, &unpadded_size) ||
+            !nv_xz_get_vli(&p, end, &uncompressed_size) ||
+            (total + uncompressed_size < total))
+        {
+            return NV_ERR_INVALID_DATA;
+        }
+
+        total += uncompressed_size;
+    }
+
+    *out_size = total;
+    return NV_OK;
+}
+
+NV_STATUS nv_xz_decompress(
+    const NvU8 *in,
+    NvU64 in_size,
+    NvU8 *out,
+    NvU64 out_size
+)
+{
+    struct xz_dec *s;
+    struct xz_buf b;
+    enum xz_ret ret;
+
+    xz_crc32_init();
+
+    s = xz_dec_init(XZ_SINGLE, 0);
+    if (s == NULL)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    b.in = in;
+    b.in_pos = 0;
+    b.in_size = in_size;
+    b.out = out;
+    b.out_pos = 0;
+    b.out_size = out_size;
+
+    ret = xz_dec_run(s, &b);
+    xz_dec_end(s);
+
+    if ((ret != XZ_STREAM_END) || (b.out_pos != out_size))
+    {
+        return NV_ERR_INVALID_DATA;
+    }
+
+    return NV_OK;
+}
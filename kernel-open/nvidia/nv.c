@@ -52,6 +52,7 @@
 #include "nv-kthread-q.h"
 #include "nv-pat.h"
 #include "nv-dmabuf.h"
+#include "nv-xz.h"
 
 #if !defined(CONFIG_RETPOLINE)
 #include "nv-retpoline.h"
@@ -157,6 +158,9 @@ NvBool nv_ats_supported = NVCPU_IS_PPC64LE
 static nv_alloc_t  *nvos_create_alloc(struct device *, NvU64);
 static int          nvos_free_alloc(nv_alloc_t *);
 
+static void         nv_firmware_cache_init(void);
+static void         nv_firmware_cache_exit(void);
+
 /***
  *** EXPORTS to Linux Kernel
  ***/
@@ -231,9 +235,10 @@ nv_alloc_t *nvos_create_alloc(
     NvU64          num_pages
 )
 {
-    nv_alloc_t  *at;
-    NvU64        pt_size;
-    unsigned int i;
+    nv_alloc_t   *at;
+    nvidia_pte_t *ptes;
+    NvU64         pt_size;
+    unsigned int  i;
 
     NV_KZALLOC(at, sizeof(nv_alloc_t));
     if (at == NULL)
@@ -243,11 +248,16 @@ nv_alloc_t *nvos_create_alloc(
     }
 
     at->dev = dev;
-    pt_size = num_pages *  sizeof(nvidia_pte_t *);
+    //
+    // The page table and its entries are carved from a single allocation,
+    // so that large allocations do not cost one heap allocation per page.
+    //
+    pt_size = num_pages * (sizeof(nvidia_pte_t *) + sizeof(nvidia_pte_t));
     //
     // Check for multiplication overflow and check whether num_pages value can fit in at->num_pages.
     //
-    if ((num_pages != 0) && ((pt_size / num_pages) != sizeof(nvidia_pte_t*)))
+    if ((num_pages != 0) &&
+        ((pt_size / num_pages) != (sizeof(nvidia_pte_t *) + sizeof(nvidia_pte_t))))
     {
         nv_printf(NV_DBG_ERRORS, "NVRM: Invalid page table allocation - Number of pages exceeds max value.\n");
         NV_KFREE(at, sizeof(nv_alloc_t));
@@ -272,17 +282,10 @@ nv_alloc_t *nvos_create_alloc(
     memset(at->page_table, 0, pt_size);
     NV_ATOMIC_SET(at->usage_count, 0);
 
+    ptes = (nvidia_pte_t *)&at->page_table[at->num_pages];
     for (i = 0; i < at->num_pages; i++)
     {
-        NV_KMALLOC(at->page_table[i], sizeof(nvidia_pte_t));
-        if (at->page_table[i] == NULL)
-        {
-            nv_printf(NV_DBG_ERRORS,
-                      "NVRM: failed to allocate page table entry\n");
-            nvos_free_alloc(at);
-            return NULL;
-        }
-        memset(at->page_table[i], 0, sizeof(nvidia_pte_t));
+        at->page_table[i] = &ptes[i];
     }
 
     at->pid = os_get_current_process();
@@ -295,19 +298,12 @@ int nvos_free_alloc(
     nv_alloc_t *at
 )
 {
-    unsigned int i;
-
     if (at == NULL)
         return -1;
 
     if (NV_ATOMIC_READ(at->usage_count))
         return 1;
 
-    for (i = 0; i < at->num_pages; i++)
-    {
-        if (at->page_table[i] != NULL)
-            NV_KFREE(at->page_table[i], sizeof(nvidia_pte_t));
-    }
     os_free_mem(at->page_table);
 
     NV_KFREE(at, sizeof(nv_alloc_t));
@@ -389,6 +385,8 @@ nv_module_state_exit(nv_stack_t *sp)
 
     nv_kthread_q_stop(&nv_kthread_q);
 
+    nv_firmware_cache_exit();
+
     nv_lock_destroy_locks(sp, nv);
 }
 
@@ -405,7 +403,11 @@ nv_module_state_init(nv_stack_t *sp)
         return -ENOMEM;
     }
 
-    rc = nv_kthread_q_init(&nv_kthread_q, "nv_queue");
+    nv_firmware_cache_init();
+
+    // The global queue only carries RM work items that take their own locks,
+    // so let it run on every CPU. Per-device queues stay single-worker.
+    rc = nv_kthread_q_init_multi(&nv_kthread_q, "nv_queue", 0);
     if (rc != 0)
     {
         goto exit;
@@ -690,6 +692,15 @@ static void nv_free_file_private(nvfd nvlfp)
         os_free_mem(nvlfp->mmap_context.page_array);
     }
 
+    //
+    // Like sysmem mappings, a mapped ring is not torn down with the fd, so
+    // its pages must outlive any user mapping of them.
+    //
+    if ((nvlfp->event_ring != NULL) && !nvlfp->event_ring_mapped)
+    {
+        NV_FREE_PAGES((unsigned long)nvlfp->event_ring, nvlfp->event_ring_order);
+    }
+
     deallocate_blockq(nvlfp->waitqueue);
     NV_KFREE(nvlfp, sizeof(*nvlfp));
 }
@@ -894,10 +905,12 @@ nv_schedule_uvm_isr(nv_state_t *nv)
 /*
  * driver receives an interrupt
  *    if someone waiting, then hand it off.
+ *
+ * service_uvm selects whether the UVM top half is run from here; bh is the
+ * locked bottom half to schedule if RM asks for one.
  */
-define_closure_function(0, 0, void, nvidia_isr)
+void nvidia_isr_service(nv_nanos_state_t *nvl, NvBool service_uvm, thunk bh)
 {
-    nv_nanos_state_t *nvl = struct_from_field(closure_self(), nv_nanos_state_t *, isr);
     nv_state_t *nv = NV_STATE_PTR(nvl);
     NvU32 need_to_run_bottom_half_gpu_lock_held = 0;
     NvBool rm_fault_handling_needed = NV_FALSE;
@@ -920,7 +933,8 @@ define_closure_function(0, 0, void, nvidia_isr)
     // NV_ERR_NO_INTR_PENDING, but in some cases the extra information may
     // be helpful.
     //
-    nv_uvm_event_interrupt(nv_get_cached_uuid(nv));
+    if (service_uvm)
+        nv_uvm_event_interrupt(nv_get_cached_uuid(nv));
 #endif
 
     rm_isr(nvl->sp[NV_DEV_STACK_ISR], nv,
@@ -928,7 +942,7 @@ define_closure_function(0, 0, void, nvidia_isr)
 
     if (need_to_run_bottom_half_gpu_lock_held)
     {
-        async_apply_bh((thunk)&nvl->isr_bh);
+        async_apply_bh(bh);
     }
     else
     {
@@ -942,6 +956,13 @@ define_closure_function(0, 0, void, nvidia_isr)
     }
 }
 
+define_closure_function(0, 0, void, nvidia_isr)
+{
+    nv_nanos_state_t *nvl = struct_from_field(closure_self(), nv_nanos_state_t *, isr);
+
+    nvidia_isr_service(nvl, NV_TRUE, (thunk)&nvl->isr_bh);
+}
+
 define_closure_function(0, 0, void, nvidia_isr_kthread_bh)
 {
     nv_nanos_state_t *data = struct_from_field(closure_self(), nv_nanos_state_t *, isr_bh);
@@ -1322,6 +1343,8 @@ void nv_shutdown_adapter(nvidia_stack_t *sp,
     }
 
     rm_shutdown_adapter(sp, nv);
+
+    nv_dma_print_stats(&nvl->dma_dev);
 }
 
 /*
@@ -1418,6 +1441,85 @@ static void nv_close_device(nv_state_t *nv, nvidia_stack_t *sp)
         nv_stop_device(nv, sp);
 }
 
+/*
+ * Load-time initialization (NVreg_InitDevicesAtLoad): each device is opened
+ * from its own nv_kthread_q item, so devices come up concurrently on the
+ * queue's workers and off the module load path. The reference taken here is
+ * only dropped at module unload.
+ */
+static void nv_preinit_device(void *args)
+{
+    nv_nanos_state_t *nvl = args;
+    nv_state_t *nv = NV_STATE_PTR(nvl);
+    nvidia_stack_t *sp = NULL;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        NV_DEV_PRINTF(NV_DBG_ERRORS, nv, "No memory to initialize GPU at load\n");
+        return;
+    }
+
+    down(&nvl->ldata_lock);
+
+    if (((nv->flags & NV_FLAG_EXCLUDE) == 0) && !nvl->preinit_opened)
+    {
+        if (nv_open_device(nv, sp) == 0)
+            nvl->preinit_opened = NV_TRUE;
+        else
+            NV_DEV_PRINTF(NV_DBG_ERRORS, nv, "Failed to initialize GPU at load\n");
+    }
+
+    up(&nvl->ldata_lock);
+
+    nv_kmem_cache_free_stack(sp);
+}
+
+static void nv_preinit_devices(void)
+{
+    nv_nanos_state_t *nvl;
+
+    if (!NVreg_InitDevicesAtLoad)
+        return;
+
+    LOCK_NV_LINUX_DEVICES();
+
+    for (nvl = nv_linux_devices; nvl != NULL; nvl = nvl->next)
+    {
+        nv_kthread_q_item_init(&nvl->preinit_q_item, nv_preinit_device, nvl);
+        nv_kthread_q_schedule_q_item(&nv_kthread_q, &nvl->preinit_q_item);
+    }
+
+    UNLOCK_NV_LINUX_DEVICES();
+}
+
+static void nv_preinit_devices_release(nvidia_stack_t *sp)
+{
+    nv_nanos_state_t *nvl;
+
+    if (!NVreg_InitDevicesAtLoad)
+        return;
+
+    // Wait for initializations still in flight
+    nv_kthread_q_flush(&nv_kthread_q);
+
+    LOCK_NV_LINUX_DEVICES();
+
+    for (nvl = nv_linux_devices; nvl != NULL; nvl = nvl->next)
+    {
+        down(&nvl->ldata_lock);
+
+        if (nvl->preinit_opened)
+        {
+            nvl->preinit_opened = NV_FALSE;
+            nv_close_device(NV_STATE_PTR(nvl), sp);
+        }
+
+        up(&nvl->ldata_lock);
+    }
+
+    UNLOCK_NV_LINUX_DEVICES();
+}
+
 #define NV_CTL_DEVICE_ONLY(nv)                 \
 {                                              \
     if (((nv)->flags & NV_FLAG_CONTROL) == 0)  \
@@ -1487,6 +1589,122 @@ out:
     return rc;
 }
 
+static NvU64 nv_event_ring_size(NvU32 entry_count)
+{
+    return PAGE_SIZE + (NvU64)entry_count * sizeof(nv_event_ring_entry_t);
+}
+
+static inline nv_event_ring_entry_t *nv_event_ring_entries(nv_event_ring_header_t *ring)
+{
+    return (nv_event_ring_entry_t *)((NvU8 *)ring + PAGE_SIZE);
+}
+
+static NvU32 nv_event_ring_alloc(nvfd nvlfp, nv_ioctl_event_ring_t *params)
+{
+    NvU32 entry_count = params->entry_count;
+    NvU64 size;
+    NvU32 order;
+    unsigned long virt_addr;
+    unsigned long eflags;
+    NvBool installed = NV_FALSE;
+
+    if ((entry_count == 0) || (entry_count > NV_EVENT_RING_MAX_ENTRIES) ||
+        ((entry_count & (entry_count - 1)) != 0))
+    {
+        return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    size = nv_event_ring_size(entry_count);
+    order = find_order(NV_ALIGN_UP(size, PAGE_SIZE) >> PAGE_SHIFT);
+
+    NV_GET_FREE_PAGES(virt_addr, order);
+    if (virt_addr == 0)
+        return NV_ERR_NO_MEMORY;
+
+    memset((void *)virt_addr, 0, PAGE_SIZE << order);
+    ((nv_event_ring_header_t *)virt_addr)->entry_count = entry_count;
+
+    NV_SPIN_LOCK_IRQSAVE(&nvlfp->fp_lock, eflags);
+    if (nvlfp->event_ring == NULL)
+    {
+        nvlfp->event_ring_order = order;
+        nvlfp->event_ring = (nv_event_ring_header_t *)virt_addr;
+        installed = NV_TRUE;
+    }
+    NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->fp_lock, eflags);
+
+    if (!installed)
+    {
+        NV_FREE_PAGES(virt_addr, order);
+        return NV_ERR_STATE_IN_USE;
+    }
+
+    params->mmap_offset = NV_EVENT_RING_MMAP_OFFSET;
+    params->mmap_length = NV_ALIGN_UP(size, PAGE_SIZE);
+
+    return NV_OK;
+}
+
+static sysreturn nv_event_ring_mmap(nvfd nvlfp, vmap vm)
+{
+    nv_event_ring_header_t *ring = nvlfp->event_ring;
+    NvU64 phys_addr;
+
+    if (ring == NULL)
+        return -EINVAL;
+
+    if (range_span(vm->node.r) > (PAGE_SIZE << nvlfp->event_ring_order))
+        return -EINVAL;
+
+    phys_addr = nv_get_kern_phys_address((NvU64)ring);
+    if (phys_addr == 0)
+        return -EINVAL;
+
+    nvlfp->event_ring_mapped = NV_TRUE;
+
+    return nv_io_remap_page_range(vm, phys_addr, range_span(vm->node.r),
+                                  pageflags_from_vmflags(vm->flags));
+}
+
+//
+// Append an event to the fd's ring, with fp_lock held. Returns NV_FALSE if
+// the ring is full, in which case the caller queues the event instead.
+//
+static NvBool nv_event_ring_post(
+    nvfd nvlfp,
+    NvHandle handle,
+    NvU32 index,
+    NvU32 info32,
+    NvU16 info16,
+    NvBool *was_empty
+)
+{
+    nv_event_ring_header_t *ring = nvlfp->event_ring;
+    NvU32 head = ring->head;
+    NvU32 tail = ring->tail;
+    nv_event_ring_entry_t *entry;
+
+    if ((head - tail) >= ring->entry_count)
+    {
+        ring->overflow_count++;
+        return NV_FALSE;
+    }
+
+    entry = &nv_event_ring_entries(ring)[head & (ring->entry_count - 1)];
+    entry->hObject = handle;
+    entry->index = index;
+    entry->info32 = info32;
+    entry->info16 = info16;
+
+    // Publish the entry before the head that covers it.
+    memory_barrier();
+    ring->head = head + 1;
+
+    *was_empty = (head == tail);
+
+    return NV_TRUE;
+}
+
 closure_func_basic(fdesc_ioctl, sysreturn, nvfd_ioctl,
                    unsigned long request, vlist ap)
 {
@@ -1505,7 +1723,8 @@ closure_func_basic(fdesc_ioctl, sysreturn, nvfd_ioctl,
     nv_ioctl_xfer_t ioc_xfer;
     int arg_cmd = IOC_NR(request);
 
-    sp = nv_nvlfp_get_sp(nvlfp, NV_FOPS_STACK_INDEX_IOCTL);
+    if (rm_is_altstack_in_use() && (nv_kmem_cache_alloc_stack(&sp) != 0))
+        return -ENOMEM;
 
     if (arg_cmd == NV_ESC_IOCTL_XFER_CMD)
     {
@@ -1517,13 +1736,12 @@ closure_func_basic(fdesc_ioctl, sysreturn, nvfd_ioctl,
             goto done;
         }
 
-        if (NV_COPY_FROM_USER(&ioc_xfer, arg_ptr, sizeof(ioc_xfer)))
-        {
-            nv_printf(NV_DBG_ERRORS,
-                    "NVRM: failed to copy in ioctl XFER data!\n");
-            status = -EFAULT;
-            goto done;
-        }
+        //
+        // The XFER header was validated above and user memory is directly
+        // addressable, so read it in place. The payload it points to is used
+        // in place too, once it has been validated the same way.
+        //
+        ioc_xfer = *(volatile nv_ioctl_xfer_t *)arg_ptr;
 
         arg_cmd  = ioc_xfer.cmd;
         arg_size = ioc_xfer.size;
@@ -1535,6 +1753,15 @@ closure_func_basic(fdesc_ioctl, sysreturn, nvfd_ioctl,
             status = -EINVAL;
             goto done;
         }
+
+        // RM writes results back into XFER payloads.
+        if (!validate_user_memory(arg_ptr, arg_size, true))
+        {
+            nv_printf(NV_DBG_ERRORS,
+                    "NVRM: invalid ioctl XFER data pointer!\n");
+            status = -EFAULT;
+            goto done;
+        }
     }
     switch (arg_cmd)
     {
@@ -1783,6 +2010,21 @@ unlock:
             break;
         }
 
+        case NV_ESC_EVENT_RING:
+        {
+            nv_ioctl_event_ring_t *params = arg_ptr;
+
+            if (arg_size != sizeof(nv_ioctl_event_ring_t))
+            {
+                status = -EINVAL;
+                goto done;
+            }
+
+            params->status = nv_event_ring_alloc(nvlfp, params);
+
+            break;
+        }
+
         default:
             rmStatus = rm_ioctl(sp, nv, &nvlfp->nvfp, arg_cmd, arg_ptr, arg_size);
             status = ((rmStatus == NV_OK) ? 0 : -EINVAL);
@@ -1790,7 +2032,7 @@ unlock:
     }
 
 done:
-    nv_nvlfp_put_sp(nvlfp, NV_FOPS_STACK_INDEX_IOCTL);
+    nv_kmem_cache_free_stack(sp);
 
     return status;
 }
@@ -1803,7 +2045,9 @@ closure_func_basic(fdesc_events, u32, nvfd_events,
     unsigned long eflags;
     NV_SPIN_LOCK_IRQSAVE(&nvlfp->fp_lock, eflags);
 
-    if ((nvlfp->event_data_head != NULL) || nvlfp->dataless_event_pending)
+    if ((nvlfp->event_data_head != NULL) || nvlfp->dataless_event_pending ||
+        ((nvlfp->event_ring != NULL) &&
+         (nvlfp->event_ring->head != nvlfp->event_ring->tail)))
     {
         mask = (EPOLLPRI | EPOLLIN);
         nvlfp->dataless_event_pending = NV_FALSE;
@@ -1832,6 +2076,9 @@ closure_func_basic(fdesc_mmap, sysreturn, nvfd_mmap,
         return -EINVAL;
     }
 
+    if (offset == NV_EVENT_RING_MMAP_OFFSET)
+        return nv_event_ring_mmap(nvlfp, vm);
+
     sp = nv_nvlfp_get_sp(nvlfp, NV_FOPS_STACK_INDEX_MMAP);
 
     rc = nvidia_mmap_helper(nv, nvlfp, sp, vm, offset);
@@ -2042,6 +2289,8 @@ int nvidia_init_module(void)
     const NvBool is_nvswitch_present = os_is_nvswitch_present();
 
     nv_memdbg_init();
+    nv_numa_init();
+    nv_p2p_init();
 
     rc = nv_procfs_init();
     if (rc < 0)
@@ -2063,6 +2312,12 @@ int nvidia_init_module(void)
         goto module_exit;
     }
 
+    //
+    // Probe has scheduled the GSP firmware loads; wait for them here rather
+    // than at first open, where the filesystem may not be readable.
+    //
+    nv_kthread_q_flush(&nv_kthread_q);
+
     if ((num_probed_nv_devices == 0) && (!is_nvswitch_present))
     {
         rc = -ENODEV;
@@ -2106,6 +2361,8 @@ int nvidia_init_module(void)
 
     __nv_init_sp = sp;
 
+    nv_preinit_devices();
+
     return 0;
 
 drivers_exit:
@@ -2124,6 +2381,8 @@ void nvidia_exit_module(void)
 {
     nvidia_stack_t *sp = __nv_init_sp;
 
+    nv_preinit_devices_release(sp);
+
 #if defined(NV_UVM_ENABLE)
     nv_uvm_exit();
 #endif
@@ -2447,6 +2706,8 @@ NV_STATUS NV_API_CALL nv_register_user_pages(
     NvU64 *user_pages;
     nv_nanos_state_t *nvl;
     nvidia_pte_t *page_ptr;
+    nvidia_pte_t *chunk_ptr = NULL;
+    NvU64 chunk_count = 0;
 
     nv_printf(NV_DBG_MEMINFO, "NVRM: VM: nv_register_user_pages: 0x%x\n", page_count);
     user_pages = *priv_data;
@@ -2481,9 +2742,31 @@ NV_STATUS NV_API_CALL nv_register_user_pages(
         page_ptr = at->page_table[i];
         page_ptr->phys_addr = user_pages[i];
 
+        //
+        // Record physically contiguous runs of the pinned range as chunks,
+        // so that they can be DMA-mapped as extents rather than page by page.
+        //
+        if ((chunk_ptr != NULL) &&
+            (page_ptr->phys_addr == (chunk_ptr->phys_addr +
+                                     chunk_ptr->chunk_pages * PAGE_SIZE)) &&
+            (chunk_ptr->chunk_pages < NV_U32_MAX))
+        {
+            chunk_ptr->chunk_pages++;
+        }
+        else
+        {
+            chunk_ptr = page_ptr;
+            chunk_ptr->chunk_pages = 1;
+            chunk_count++;
+        }
+
         phys_addr[i] = page_ptr->phys_addr;
     }
 
+    nv_printf(NV_DBG_MEMINFO,
+              "NVRM: VM: nv_register_user_pages: 0x%llx contiguous chunks\n",
+              chunk_count);
+
     /* Save off the user pages array to be restored later */
     at->user_pages = user_pages;
 
@@ -2885,6 +3168,13 @@ NV_STATUS NV_API_CALL nv_alloc_pages(
     }
 #endif
 
+    //
+    // Without an explicit node, allocations made for a GPU default to the
+    // node its PCIe root complex is attached to.
+    //
+    if ((node_id == NUMA_NO_NODE) && (nvl != NULL))
+        node_id = nv_pci_dev_to_node(nvl->pci_dev);
+
     if (node_id != NUMA_NO_NODE)
     {
         at->flags.node = NV_TRUE;
@@ -3014,18 +3304,42 @@ void NV_API_CALL nv_post_event(
     nvfd nvlfp = nv_get_nvlfp_from_nvfp(event->nvfp);
     unsigned long eflags;
     nvidia_event_t *nvet;
+    NvBool wake = NV_TRUE;
 
-    NV_SPIN_LOCK_IRQSAVE(&nvlfp->f->f.lock, eflags);
+    NV_SPIN_LOCK_IRQSAVE(&nvlfp->fp_lock, eflags);
+
+    //
+    // Ring consumers drain without syscalls, so only the transition from
+    // empty needs a wakeup. Events that don't fit go to the list below.
+    //
+    if (data_valid && (nvlfp->event_ring != NULL) &&
+        (nvlfp->event_data_head == NULL) &&
+        nv_event_ring_post(nvlfp, handle, index, info32, info16, &wake))
+    {
+        NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->fp_lock, eflags);
+
+        if (wake)
+            blockq_wake_one(nvlfp->waitqueue);
+        return;
+    }
 
     if (data_valid)
     {
         NV_KMALLOC_ATOMIC(nvet, sizeof(nvidia_event_t));
         if (nvet == NULL)
         {
-            NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->f->f.lock, eflags);
+            NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->fp_lock, eflags);
             return;
         }
 
+        //
+        // Readers drain the list until NV04_GET_EVENT_DATA reports no more
+        // events, so as with the ring only the transition from empty needs
+        // a wakeup. Several events posted to an fd for the same interrupt
+        // thus cost a single wakeup.
+        //
+        wake = (nvlfp->event_data_head == NULL);
+
         if (nvlfp->event_data_tail != NULL)
             nvlfp->event_data_tail->next = nvet;
         if (nvlfp->event_data_head == NULL)
@@ -3046,12 +3360,14 @@ void NV_API_CALL nv_post_event(
     //
     else
     {
+        wake = !nvlfp->dataless_event_pending;
         nvlfp->dataless_event_pending = NV_TRUE;
     }
 
-    NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->f->f.lock, eflags);
+    NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->fp_lock, eflags);
 
-    blockq_wake_one(nvlfp->waitqueue);
+    if (wake)
+        blockq_wake_one(nvlfp->waitqueue);
 }
 
 NvBool NV_API_CALL nv_is_rm_firmware_active(
@@ -3061,46 +3377,341 @@ NvBool NV_API_CALL nv_is_rm_firmware_active(
     return NV_FALSE;
 }
 
-void NV_API_CALL nv_fetch_firmware(
+/*
+ * GSP images are identical for every GPU of a chip family, so they are
+ * loaded once per (fw_type, fw_chip_family) and shared. An image is not
+ * copied out of the page cache: its page-cache pages are mapped read-only
+ * into a contiguous kernel virtual range, which is what RM is handed.
+ *
+ * Probe only schedules the load on nv_kthread_q, so that images are brought
+ * in while the remaining GPUs are being probed; nv_get_firmware() waits for
+ * a load in flight, or performs it itself if none was scheduled. Cached
+ * images stay mapped until module unload, since RM requests them again on
+ * every adapter init.
+ *
+ * If the image is only present as an xz file ("<path>.xz"), it is decoded
+ * once into a page-backed kernel buffer instead, and the compressed file is
+ * dropped as soon as the decode is done. Shipping the images compressed keeps
+ * the unikernel image and the boot-time read small.
+ */
+typedef enum
+{
+    NV_FIRMWARE_CACHE_EMPTY = 0,
+    NV_FIRMWARE_CACHE_READY,
+    NV_FIRMWARE_CACHE_FAILED,
+} nv_firmware_cache_state_t;
+
+typedef struct nv_firmware_cache_entry
+{
+    struct semaphore lock;
+    nv_firmware_cache_state_t state;
+    nv_firmware_type_t fw_type;
+    nv_firmware_chip_family_t fw_chip_family;
+    NvU32 refcount;
+    fsfile fsf;
+    pagecache_node pn;
+    void *data;
+    NvU32 size;
+    NvU64 map_size;
+    NvBool decompressed;
+    nv_kthread_q_item_t fetch_item;
+} nv_firmware_cache_entry_t;
+
+#define NV_FIRMWARE_TYPE_COUNT  (NV_FIRMWARE_TYPE_GSP_LOG + 1)
+
+static nv_firmware_cache_entry_t
+    nv_firmware_cache[NV_FIRMWARE_TYPE_COUNT][NV_FIRMWARE_CHIP_FAMILY_END];
+
+static nv_firmware_cache_entry_t *nv_firmware_cache_lookup(
     nv_firmware_type_t fw_type,
     nv_firmware_chip_family_t fw_chip_family
 )
 {
-    const char *file_path = nv_firmware_path(fw_type, fw_chip_family);
-    fsfile fsf;
+    if (((unsigned)fw_type >= NV_FIRMWARE_TYPE_COUNT) ||
+        (fw_chip_family <= NV_FIRMWARE_CHIP_FAMILY_NULL) ||
+        (fw_chip_family >= NV_FIRMWARE_CHIP_FAMILY_END))
+    {
+        return NULL;
+    }
+
+    return &nv_firmware_cache[fw_type][fw_chip_family];
+}
+
+closure_function(2, 1, void, nv_firmware_cache_mapped,
+                 context, ctx, status *, s_ret,
+                 status, s)
+{
+    *bound(s_ret) = s;
+    context_schedule_return(bound(ctx));
+}
+
+static NV_STATUS nv_firmware_cache_map(nv_firmware_cache_entry_t *e)
+{
+    heap h = heap_locked(get_kernel_heaps());
+    heap vh = (heap)heap_virtual_page(get_kernel_heaps());
+    context ctx = get_current_context(current_cpu());
+    pageflags flags = pageflags_noexec(pageflags_memory());
+    status s = STATUS_OK;
+    status_handler completion;
+    status_handler sh;
+    merge m;
+    u64 vaddr;
+    u64 offset;
+
+    vaddr = allocate_u64(vh, e->map_size);
+    if (vaddr == INVALID_PHYSICAL)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    completion = closure(h, nv_firmware_cache_mapped, ctx, &s);
+    if (completion == INVALID_ADDRESS)
+    {
+        deallocate_u64(vh, vaddr, e->map_size);
+        return NV_ERR_NO_MEMORY;
+    }
+    m = allocate_merge(h, completion);
+    if (m == INVALID_ADDRESS)
+    {
+        deallocate_closure(completion);
+        deallocate_u64(vh, vaddr, e->map_size);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    // Each page is mapped as soon as the page cache has it filled.
+    context_pre_suspend(ctx);
+    sh = apply_merge(m);
+    for (offset = 0; offset < e->map_size; offset += PAGESIZE)
+    {
+        pagecache_map_page(e->pn, offset, vaddr + offset, flags, apply_merge(m));
+    }
+    apply(sh, STATUS_OK);
+    context_suspend();
+    deallocate_closure(completion);
+
+    if (s != STATUS_OK)
+    {
+        timm_dealloc(s);
+        pagecache_node_unmap_pages(e->pn, irangel(vaddr, e->map_size), 0);
+        deallocate_u64(vh, vaddr, e->map_size);
+        return NV_ERR_OPERATING_SYSTEM;
+    }
+
+    e->data = pointer_from_u64(vaddr);
+    return NV_OK;
+}
+
+static void nv_firmware_cache_unmap(nv_firmware_cache_entry_t *e)
+{
+    heap vh = (heap)heap_virtual_page(get_kernel_heaps());
+
+    pagecache_node_unmap_pages(e->pn,
+            irangel(u64_from_pointer(e->data), e->map_size), 0);
+    deallocate_u64(vh, u64_from_pointer(e->data), e->map_size);
+    fsfile_release(e->fsf);
+    e->fsf = NULL;
+    e->data = NULL;
+}
+
+// Opens the file at path and maps it; e->size is the file length.
+static NV_STATUS nv_firmware_cache_open(nv_firmware_cache_entry_t *e, const char *path)
+{
     u64 len;
-    pagecache_node pn;
-    range r;
 
-    fsf = fsfile_open(alloca_wrap_cstring(file_path));
-    if (!fsf)
+    e->fsf = fsfile_open(alloca_wrap_cstring(path));
+    if (!e->fsf)
+    {
+        return NV_ERR_OBJECT_NOT_FOUND;
+    }
+
+    len = fsfile_get_length(e->fsf);
+    if ((len == 0) || (len > NV_U32_MAX))
+    {
+        goto failed;
+    }
+
+    e->pn = fsfile_get_cachenode(e->fsf);
+    e->size = len;
+    e->map_size = pad(len, PAGESIZE);
+
+    if (nv_firmware_cache_map(e) == NV_OK)
+    {
+        return NV_OK;
+    }
+
+failed:
+    fsfile_release(e->fsf);
+    e->fsf = NULL;
+    return NV_ERR_INVALID_DATA;
+}
+
+//
+// Replaces the mapped xz file with its decoded contents. The output buffer is
+// sized from the stream index, so the image is decoded straight into the
+// buffer RM is handed.
+//
+static NV_STATUS nv_firmware_cache_decompress(nv_firmware_cache_entry_t *e)
+{
+    heap bh = (heap)heap_page_backed(get_kernel_heaps());
+    NvU64 size;
+    NvU64 alloc_size;
+    void *data;
+    NV_STATUS status;
+
+    status = nv_xz_get_uncompressed_size(e->data, e->size, &size);
+    if ((status == NV_OK) && ((size == 0) || (size > NV_U32_MAX)))
+    {
+        status = NV_ERR_INVALID_DATA;
+    }
+    if (status != NV_OK)
+    {
+        nv_firmware_cache_unmap(e);
+        return status;
+    }
+
+    alloc_size = pad(size, PAGESIZE);
+    data = allocate(bh, alloc_size);
+    if (data == INVALID_ADDRESS)
+    {
+        nv_firmware_cache_unmap(e);
+        return NV_ERR_NO_MEMORY;
+    }
+
+    status = nv_xz_decompress(e->data, e->size, data, size);
+    nv_firmware_cache_unmap(e);
+    if (status != NV_OK)
+    {
+        deallocate(bh, data, alloc_size);
+        return status;
+    }
+
+    e->data = data;
+    e->size = size;
+    e->map_size = alloc_size;
+    e->decompressed = NV_TRUE;
+    return NV_OK;
+}
+
+// Called with e->lock held.
+static void nv_firmware_cache_load(nv_firmware_cache_entry_t *e)
+{
+    const char *file_path = nv_firmware_path(e->fw_type, e->fw_chip_family);
+    char xz_path[128];
+    NV_STATUS status;
+    int ret;
+
+    if (e->state != NV_FIRMWARE_CACHE_EMPTY)
+    {
+        return;
+    }
+
+    e->state = NV_FIRMWARE_CACHE_FAILED;
+
+    status = nv_firmware_cache_open(e, file_path);
+    if (status == NV_ERR_OBJECT_NOT_FOUND)
+    {
+        ret = snprintf(xz_path, sizeof(xz_path), "%s.xz", file_path);
+        if ((ret > 0) && (ret < sizeof(xz_path)))
+        {
+            status = nv_firmware_cache_open(e, xz_path);
+            if (status == NV_OK)
+            {
+                status = nv_firmware_cache_decompress(e);
+            }
+        }
+    }
+
+    if (status != NV_OK)
+    {
+        nv_printf(NV_DBG_ERRORS, "NVRM: failed to load firmware %s\n", file_path);
         return;
-    len = fsfile_get_length(fsf);
-    pn = fsfile_get_cachenode(fsf);
-    r = irange(0, PAGECACHE_MAX_SG_ENTRIES * PAGESIZE);
-    do {
-        pagecache_node_fetch_pages(pn, r);
-        r = range_add(r, PAGECACHE_MAX_SG_ENTRIES * PAGESIZE);
-    } while (r.start < len);
-    fsfile_release(fsf);
+    }
+
+    e->state = NV_FIRMWARE_CACHE_READY;
 }
 
-closure_function(2, 1, status, nv_get_firmware_ok,
-                 context, ctx, buffer *, b_ret,
-                 buffer, b)
+static void nv_firmware_cache_fetch(void *args)
 {
-    *bound(b_ret) = b;
-    context_schedule_return(bound(ctx));
-    return STATUS_OK;
+    nv_firmware_cache_entry_t *e = args;
+
+    down(&e->lock);
+    nv_firmware_cache_load(e);
+    up(&e->lock);
 }
 
-closure_function(2, 1, void, nv_get_firmware_error,
-                 context, ctx, buffer *, b_ret,
-                 status, s)
+static void nv_firmware_cache_init(void)
 {
-    *bound(b_ret) = 0;
-    context_schedule_return(bound(ctx));
-    timm_dealloc(s);
+    nv_firmware_type_t fw_type;
+    nv_firmware_chip_family_t fw_chip_family;
+
+    for (fw_type = 0; fw_type < NV_FIRMWARE_TYPE_COUNT; fw_type++)
+    {
+        for (fw_chip_family = 0; fw_chip_family < NV_FIRMWARE_CHIP_FAMILY_END;
+             fw_chip_family++)
+        {
+            nv_firmware_cache_entry_t *e = &nv_firmware_cache[fw_type][fw_chip_family];
+
+            memset(e, 0, sizeof(*e));
+            NV_INIT_MUTEX(&e->lock);
+            e->fw_type = fw_type;
+            e->fw_chip_family = fw_chip_family;
+            nv_kthread_q_item_init(&e->fetch_item, nv_firmware_cache_fetch, e);
+        }
+    }
+}
+
+// Must be called after nv_kthread_q has been stopped.
+static void nv_firmware_cache_exit(void)
+{
+    heap bh = (heap)heap_page_backed(get_kernel_heaps());
+    nv_firmware_type_t fw_type;
+    nv_firmware_chip_family_t fw_chip_family;
+
+    for (fw_type = 0; fw_type < NV_FIRMWARE_TYPE_COUNT; fw_type++)
+    {
+        for (fw_chip_family = 0; fw_chip_family < NV_FIRMWARE_CHIP_FAMILY_END;
+             fw_chip_family++)
+        {
+            nv_firmware_cache_entry_t *e = &nv_firmware_cache[fw_type][fw_chip_family];
+
+            if (e->state != NV_FIRMWARE_CACHE_READY)
+            {
+                continue;
+            }
+
+            WARN_ON(e->refcount != 0);
+
+            if (e->decompressed)
+            {
+                deallocate(bh, e->data, e->map_size);
+                e->data = NULL;
+                e->decompressed = NV_FALSE;
+            }
+            else
+            {
+                nv_firmware_cache_unmap(e);
+            }
+            e->state = NV_FIRMWARE_CACHE_EMPTY;
+        }
+    }
+}
+
+void NV_API_CALL nv_fetch_firmware(
+    nv_firmware_type_t fw_type,
+    nv_firmware_chip_family_t fw_chip_family
+)
+{
+    nv_firmware_cache_entry_t *e = nv_firmware_cache_lookup(fw_type, fw_chip_family);
+
+    //
+    // GPUs of the same family share the entry; scheduling is a no-op while
+    // the fetch item is already pending, and the fetch itself returns early
+    // once the image has been loaded.
+    //
+    if (e != NULL)
+    {
+        nv_kthread_q_schedule_q_item(&nv_kthread_q, &e->fetch_item);
+    }
 }
 
 const void* NV_API_CALL nv_get_firmware(
@@ -3111,52 +3722,46 @@ const void* NV_API_CALL nv_get_firmware(
     NvU32 *fw_size
 )
 {
-    filesystem fs = get_root_fs();
-    const char *file_path = nv_firmware_path(fw_type, fw_chip_family);
-    heap h = heap_locked(get_kernel_heaps());
-    context ctx = get_current_context(current_cpu());
-    vector fwfile_v;
-    tuple fwfile_t;
-    buffer b;
-    buffer_handler bh;
-    status_handler sh;
+    nv_firmware_cache_entry_t *e = nv_firmware_cache_lookup(fw_type, fw_chip_family);
 
-    fwfile_v = split(h, alloca_wrap_cstring(file_path), '/');
-    fwfile_t = resolve_path(filesystem_getroot(fs), fwfile_v);
-    split_dealloc(fwfile_v);
-    if (!fwfile_t)
+    if (e == NULL)
     {
         return NULL;
     }
-    bh = closure(h, nv_get_firmware_ok, get_current_context(current_cpu()), &b);
-    if (bh == INVALID_ADDRESS)
-    {
-        return NULL;
-    }
-    sh = closure(h, nv_get_firmware_error, ctx, &b);
-    if (sh == INVALID_ADDRESS)
+
+    down(&e->lock);
+    nv_firmware_cache_load(e);
+    if (e->state != NV_FIRMWARE_CACHE_READY)
     {
-        deallocate_closure(bh);
+        up(&e->lock);
         return NULL;
     }
-    context_pre_suspend(ctx);
-    filesystem_read_entire(fs, fwfile_t, h, bh, sh);
-    context_suspend();
-    deallocate_closure(bh);
-    deallocate_closure(sh);
-    if (b)
-    {
-        *fw_buf = buffer_ref(b, 0);
-        *fw_size = buffer_length(b);
-        return INVALID_ADDRESS; /* any non-NULL value is OK */
-    }
-    return NULL;
+    e->refcount++;
+    *fw_buf = e->data;
+    *fw_size = e->size;
+    up(&e->lock);
+
+    return e;
 }
 
 void NV_API_CALL nv_put_firmware(
     const void *fw_handle
 )
 {
+    nv_firmware_cache_entry_t *e = (nv_firmware_cache_entry_t *)fw_handle;
+
+    if (e == NULL)
+    {
+        return;
+    }
+
+    down(&e->lock);
+    WARN_ON(e->refcount == 0);
+    if (e->refcount > 0)
+    {
+        e->refcount--;
+    }
+    up(&e->lock);
 }
 
 nv_file_private_t* NV_API_CALL nv_get_file_private(
@@ -3262,6 +3867,50 @@ int NV_API_CALL nv_get_event(
     return NV_OK;
 }
 
+/*
+ * Dequeue up to max_events events with data in one go, for
+ * NV_ESC_RM_GET_EVENT_DATA_BATCH. Returns the number dequeued.
+ */
+NvU32 NV_API_CALL nv_get_events(
+    nv_file_private_t  *nvfp,
+    nv_event_t         *events,
+    NvU32               max_events,
+    NvU32              *pending
+)
+{
+    nvfd nvlfp = nv_get_nvlfp_from_nvfp(nvfp);
+    nvidia_event_t *nvet;
+    nvidia_event_t *next;
+    nvidia_event_t *head;
+    unsigned long eflags;
+    NvU32 count = 0;
+    NvU32 i;
+
+    NV_SPIN_LOCK_IRQSAVE(&nvlfp->fp_lock, eflags);
+
+    head = nvlfp->event_data_head;
+    for (nvet = head; (nvet != NULL) && (count < max_events); nvet = nvet->next)
+    {
+        events[count++] = nvet->event;
+        if (nvlfp->event_data_tail == nvet)
+            nvlfp->event_data_tail = NULL;
+        nvlfp->event_data_head = nvet->next;
+    }
+
+    *pending = (nvlfp->event_data_head != NULL);
+
+    NV_SPIN_UNLOCK_IRQRESTORE(&nvlfp->fp_lock, eflags);
+
+    // The dequeued nodes are still chained from head; free them unlocked
+    for (nvet = head, i = 0; i < count; nvet = next, i++)
+    {
+        next = nvet->next;
+        NV_KFREE(nvet, sizeof(nvidia_event_t));
+    }
+
+    return count;
+}
+
 int NV_API_CALL nv_start_rc_timer(
     nv_state_t *nv
 )
@@ -1045,6 +1045,65 @@ NV_STATUS nvUvmInterfaceDisableAccessCntr(uvmGpuDeviceHandle device,
 }
 EXPORT_SYMBOL(nvUvmInterfaceDisableAccessCntr);
 
+NV_STATUS nvUvmInterfaceAccessBitsBufAlloc(uvmGpuDeviceHandle device,
+                                           NvU64 fbSize,
+                                           UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo)
+{
+    nvidia_stack_t *sp = NULL;
+    NV_STATUS status;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    status = rm_gpu_ops_access_bits_buf_alloc(sp,
+                                              (gpuDeviceHandle)device,
+                                              fbSize,
+                                              pAccessBitsInfo);
+
+    nv_kmem_cache_free_stack(sp);
+    return status;
+}
+EXPORT_SYMBOL(nvUvmInterfaceAccessBitsBufAlloc);
+
+NV_STATUS nvUvmInterfaceAccessBitsBufFree(uvmGpuDeviceHandle device,
+                                          UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo)
+{
+    nvidia_stack_t *sp = nvUvmGetSafeStack();
+    NV_STATUS status;
+
+    status = rm_gpu_ops_access_bits_buf_free(sp,
+                                             (gpuDeviceHandle)device,
+                                             pAccessBitsInfo);
+
+    nvUvmFreeSafeStack(sp);
+    return status;
+}
+EXPORT_SYMBOL(nvUvmInterfaceAccessBitsBufFree);
+
+NV_STATUS nvUvmInterfaceAccessBitsDump(uvmGpuDeviceHandle device,
+                                       UvmGpuAccessBitsBufferAlloc *pAccessBitsInfo,
+                                       NvU64 *pAccessBits)
+{
+    nvidia_stack_t *sp = NULL;
+    NV_STATUS status;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    status = rm_gpu_ops_access_bits_dump(sp,
+                                         (gpuDeviceHandle)device,
+                                         pAccessBitsInfo,
+                                         pAccessBits);
+
+    nv_kmem_cache_free_stack(sp);
+    return status;
+}
+EXPORT_SYMBOL(nvUvmInterfaceAccessBitsDump);
+
 // this function is called by the UVM driver to register the ops
 NV_STATUS nvUvmInterfaceRegisterUvmCallbacks(struct UvmOpsUvmEvents *importedUvmOps)
 {
@@ -1369,6 +1428,32 @@ NV_STATUS nvUvmInterfaceGetChannelResourcePtes(uvmGpuAddressSpaceHandle vaSpace,
 }
 EXPORT_SYMBOL(nvUvmInterfaceGetChannelResourcePtes);
 
+NV_STATUS nvUvmInterfaceGetChannelResourcesPtes(uvmGpuAddressSpaceHandle vaSpace,
+                                                NvU32 resourceCount,
+                                                const NvP64 *resourceDescriptors,
+                                                const NvU64 *sizes,
+                                                UvmGpuExternalMappingInfo *externalMappingInfos)
+{
+    nvidia_stack_t *sp = NULL;
+    NV_STATUS status;
+
+    if (nv_kmem_cache_alloc_stack(&sp) != 0)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    status = rm_gpu_ops_get_channel_resources_ptes(sp,
+                                                   (gpuAddressSpaceHandle)vaSpace,
+                                                   resourceCount,
+                                                   resourceDescriptors,
+                                                   sizes,
+                                                   externalMappingInfos);
+
+    nv_kmem_cache_free_stack(sp);
+    return status;
+}
+EXPORT_SYMBOL(nvUvmInterfaceGetChannelResourcesPtes);
+
 NV_STATUS nvUvmInterfaceReportNonReplayableFault(uvmGpuDeviceHandle device,
                                                  const void *pFaultPacket)
 {
@@ -640,70 +640,100 @@ NvU64 NV_API_CALL os_get_current_tick_hr(void)
     return nsec_from_timestamp(kern_now(CLOCK_ID_MONOTONIC));
 }
 
-#if BITS_PER_LONG >= 64
-
+//
+// RM's timeouts (gpuTimeoutInit() and friends) and tmr callbacks are built on
+// os_get_current_tick(), so it uses the same clock as the HR tick instead of
+// the scheduler tick. kern_now() is computed from the TSC (or the hypervisor
+// clock scaled from it) without entering the kernel timer code, so reading it
+// in a polling loop is cheap, and waits no longer round up to a timer tick.
+//
 NvU64 NV_API_CALL os_get_current_tick(void)
 {
-#if defined(NV_JIFFIES_TO_TIMESPEC_PRESENT)
-    struct timespec ts;
-    jiffies_to_timespec(jiffies, &ts);
-    return (NvU64) timespec_to_ns(&ts);
-#else
-    struct timespec64 ts;
-    jiffies_to_timespec64(jiffies, &ts);
-    return (NvU64) timespec64_to_ns(&ts);
-#endif
+    return os_get_current_tick_hr();
 }
 
 NvU64 NV_API_CALL os_get_tick_resolution(void)
 {
-    return (NvU64)jiffies_to_usecs(1) * NSEC_PER_USEC;
+    return 1ULL;
 }
 
-#else
+//---------------------------------------------------------------------------
+//
+//  Misc services.
+//
+//---------------------------------------------------------------------------
 
-NvU64 NV_API_CALL os_get_current_tick(void)
-{
-    /*
-     * 'jiffies' overflows regularly on 32-bit builds (unsigned long is 4 bytes
-     * instead of 8 bytes), so it's unwise to build a tick counter on it, since
-     * the rest of the Resman assumes the 'tick' returned from this function is
-     * monotonically increasing and never overflows.
-     *
-     * Instead, use the previous implementation that we've lived with since the
-     * beginning, which uses system clock time to calculate the tick. This is
-     * subject to problems if the system clock time changes dramatically
-     * (more than a second or so) while the Resman is actively tracking a
-     * timeout.
-     */
-    NvU32 seconds, useconds;
+/*
+ * Most os_delay_us() calls come from RM poll loops (GSP RPC, bus flushes,
+ * falcon handshakes) that wait a few microseconds at a time, so the delay is
+ * spun unless it is long enough to be worth giving up the CPU. A longer delay
+ * parks the context on a kernel timer that fires early by the measured
+ * wakeup latency, and spins the remainder, so that it neither oversleeps nor
+ * burns the CPU for its whole length. The latency is a running average of
+ * how late parked waits actually resume, and the park threshold follows it.
+ */
+#define NV_DELAY_PARK_MIN_US        20
+#define NV_DELAY_PARK_LATENCY_MAX   microseconds(500)
 
-    (void) os_get_current_time(&seconds, &useconds);
+static timestamp nv_delay_park_latency = microseconds(10);
 
-    return ((NvU64)seconds * BILLION +
-                 (NvU64)useconds * 1000);
+define_closure_function(1, 0, void, nv_delay_wakeup,
+                        context, ctx)
+{
+    context ctx = bound(ctx);
+
+    // The timer may fire before the parking context is fully suspended.
+    while (!frame_is_full(ctx->frame))
+        kern_pause();
+    context_schedule_return(ctx);
 }
 
-NvU64 NV_API_CALL os_get_tick_resolution(void)
+static void nv_delay_spin_until(timestamp deadline)
 {
-    /*
-     * os_get_current_tick() uses os_get_current_time(), which has
-     * microsecond resolution.
-     */
-    return 1000ULL;
+    while (kern_now(CLOCK_ID_MONOTONIC) < deadline)
+        kern_pause();
 }
 
-#endif
+static void nv_delay_park(timestamp start, timestamp delay, timestamp latency)
+{
+    closure_struct(nv_delay_wakeup, h);
+    struct timer t;
+    context ctx = get_current_context(current_cpu());
+    timestamp late;
 
-//---------------------------------------------------------------------------
-//
-//  Misc services.
-//
-//---------------------------------------------------------------------------
+    init_timer(&t);
+    init_closure(&h, nv_delay_wakeup, ctx);
+
+    context_pre_suspend(ctx);
+    register_timer(kernel_timers, &t, CLOCK_ID_MONOTONIC, delay - latency,
+                   false, 0, (timer_handler)&h);
+    context_suspend();
+
+    late = kern_now(CLOCK_ID_MONOTONIC) - (start + delay - latency);
+    if (late > NV_DELAY_PARK_LATENCY_MAX)
+        late = NV_DELAY_PARK_LATENCY_MAX;
+
+    // Races between concurrent updates only lose a sample.
+    nv_delay_park_latency = (nv_delay_park_latency * 7 + late) / 8;
+}
 
 NV_STATUS NV_API_CALL os_delay_us(NvU32 MicroSeconds)
 {
-    return nv_sleep_us(MicroSeconds);
+    timestamp start, delay, latency;
+
+    if (!NV_MAY_SLEEP())
+        return nv_sleep_us(MicroSeconds);
+
+    start = kern_now(CLOCK_ID_MONOTONIC);
+    delay = microseconds(MicroSeconds);
+    latency = *(volatile timestamp *)&nv_delay_park_latency;
+
+    if ((MicroSeconds >= NV_DELAY_PARK_MIN_US) && (delay > 2 * latency))
+        nv_delay_park(start, delay, latency);
+
+    nv_delay_spin_until(start + delay);
+
+    return NV_OK;
 }
 
 NV_STATUS NV_API_CALL os_delay(NvU32 MilliSeconds)
@@ -983,7 +1013,7 @@ NV_STATUS NV_API_CALL os_flush_cpu_cache(void)
 // flush the cache of all cpus
 NV_STATUS NV_API_CALL os_flush_cpu_cache_all(void)
 {
-#if defined(NVCPU_AARCH64)
+#if defined(NVCPU_AARCH64) || defined(NVCPU_X86_64)
     CACHE_FLUSH_ALL();
     return NV_OK;
 #endif
@@ -55,20 +55,14 @@ static NV_STATUS get_io_ptes(NvUPtr start,
                              NvU64 **pte_array)
 {
     NvU64 i;
-    unsigned long pfn;
 
-    for (i = 0; i < page_count; i++)
+    if (nv_vtophys_range(start, page_count, (NvU64 *)pte_array) != page_count)
     {
-        if (nv_follow_pfn((start + (i * PAGE_SIZE)), &pfn) < 0)
-        {
-            return NV_ERR_INVALID_ADDRESS;
-        }
-
-        pte_array[i] = (NvU64 *)(pfn << PAGE_SHIFT);
-
-        if (i == 0)
-            continue;
+        return NV_ERR_INVALID_ADDRESS;
+    }
 
+    for (i = 1; i < page_count; i++)
+    {
         //
         // This interface is to be used for contiguous, uncacheable I/O regions.
         // Internally, osCreateOsDescriptorFromIoMemory() checks the user-provided
@@ -102,21 +96,18 @@ static NV_STATUS get_io_pages(NvUPtr start,
                               NvU64 *page_array)
 {
     NV_STATUS rmStatus = NV_OK;
-    NvU64 i, pinned = 0;
-    unsigned long pfn;
+    NvU64 i, pinned;
+
+    pinned = nv_vtophys_range(start, page_count, page_array);
 
-    for (i = 0; i < page_count; i++)
+    for (i = 0; i < pinned; i++)
     {
-        if ((nv_follow_pfn((start + (i * PAGE_SIZE)), &pfn) < 0) ||
-            (!pfn_valid(pfn)))
+        // Page-backed memory mapped to userspace with remap_pfn_range
+        if (!pfn_valid(page_array[i] >> PAGE_SHIFT))
         {
-            rmStatus = NV_ERR_INVALID_ADDRESS;
+            pinned = i;
             break;
         }
-
-        // Page-backed memory mapped to userspace with remap_pfn_range
-        page_array[i] = pfn << PAGE_SHIFT;
-        pinned++;
     }
 
     if (pinned < page_count)
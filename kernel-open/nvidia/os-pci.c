@@ -26,6 +26,238 @@
 #include "os-interface.h"
 #include "nv-nanos.h"
 
+/*
+ * Config space shadow.
+ *
+ * Config space accesses trap to the hypervisor on virtualized hosts, and RM
+ * reads the same registers over and over. The dwords below can only change
+ * through a config write, so they are read from the hardware once and then
+ * served from a per-function shadow: the IDs, class code, BARs, subsystem
+ * IDs and capability pointer of the header, and the capability registers of
+ * the PCI Express capability. Everything else, in particular the command,
+ * status, control and error registers, always goes to the hardware.
+ *
+ * Any write to a function drops its shadow, and a write to the bridge
+ * control register, through which a secondary bus reset is issued, drops
+ * all of them.
+ */
+#define NV_PCI_CFG_SHADOW_FUNCTIONS     32
+
+#define NV_PCI_CAP_ID_EXP               0x10
+#define NV_PCI_CFG_BRIDGE_CONTROL       0x3c
+
+static const NvU16 nv_pci_cfg_shadow_header[] = {
+    0x00,                               /* vendor, device */
+    0x08,                               /* revision, class code */
+    0x10, 0x14, 0x18, 0x1c, 0x20, 0x24, /* BARs */
+    0x2c,                               /* subsystem vendor, subsystem */
+    0x34,                               /* capability pointer */
+};
+
+/* Offsets in the PCI Express capability */
+static const NvU16 nv_pci_cfg_shadow_pcie[] = {
+    0x00,                               /* capability ID, PCIe capabilities */
+    0x04,                               /* device capabilities */
+    0x0c,                               /* link capabilities */
+    0x24,                               /* device capabilities 2 */
+    0x2c,                               /* link capabilities 2 */
+};
+
+#define NV_PCI_CFG_SHADOW_DWORDS \
+    (ARRAY_SIZE(nv_pci_cfg_shadow_header) + ARRAY_SIZE(nv_pci_cfg_shadow_pcie))
+
+typedef struct
+{
+    NvBool in_use;
+    NvU8   bus;
+    NvU8   slot;
+    NvU8   function;
+    NvU16  pcie_cap;        /* 0 if the function has none */
+    NvU32  valid_mask;
+    NvU32  dwords[NV_PCI_CFG_SHADOW_DWORDS];
+} nv_pci_cfg_shadow_t;
+
+static struct {
+    struct spinlock lock;
+    NvBool initialized;
+    unsigned next_victim;
+    nv_pci_cfg_shadow_t functions[NV_PCI_CFG_SHADOW_FUNCTIONS];
+} nv_pci_cfg_shadow;
+
+static void nv_pci_cfg_shadow_init_once(void)
+{
+    if (nv_pci_cfg_shadow.initialized)
+        return;
+
+    spin_lock_init(&nv_pci_cfg_shadow.lock);
+    nv_pci_cfg_shadow.initialized = NV_TRUE;
+}
+
+static int nv_pci_cfg_shadow_index(const nv_pci_cfg_shadow_t *shadow, NvU32 offset)
+{
+    NvU32 i;
+
+    for (i = 0; i < ARRAY_SIZE(nv_pci_cfg_shadow_header); i++)
+    {
+        if (offset == nv_pci_cfg_shadow_header[i])
+            return i;
+    }
+
+    if ((shadow->pcie_cap == 0) || (offset < shadow->pcie_cap))
+        return -1;
+
+    for (i = 0; i < ARRAY_SIZE(nv_pci_cfg_shadow_pcie); i++)
+    {
+        if (offset == shadow->pcie_cap + nv_pci_cfg_shadow_pcie[i])
+            return ARRAY_SIZE(nv_pci_cfg_shadow_header) + i;
+    }
+
+    return -1;
+}
+
+/* Called with the shadow lock held */
+static nv_pci_cfg_shadow_t *nv_pci_cfg_shadow_find(struct pci_dev *dev)
+{
+    nv_pci_cfg_shadow_t *shadow;
+    unsigned i;
+
+    for (i = 0; i < NV_PCI_CFG_SHADOW_FUNCTIONS; i++)
+    {
+        shadow = &nv_pci_cfg_shadow.functions[i];
+        if (shadow->in_use && (shadow->bus == dev->bus) &&
+            (shadow->slot == dev->slot) && (shadow->function == dev->function))
+        {
+            return shadow;
+        }
+    }
+
+    return NULL;
+}
+
+static nv_pci_cfg_shadow_t *nv_pci_cfg_shadow_create(struct pci_dev *dev, NvU16 pcie_cap)
+{
+    nv_pci_cfg_shadow_t *shadow = NULL;
+    unsigned i;
+
+    for (i = 0; i < NV_PCI_CFG_SHADOW_FUNCTIONS; i++)
+    {
+        if (!nv_pci_cfg_shadow.functions[i].in_use)
+        {
+            shadow = &nv_pci_cfg_shadow.functions[i];
+            break;
+        }
+    }
+
+    if (shadow == NULL)
+    {
+        shadow = &nv_pci_cfg_shadow.functions[nv_pci_cfg_shadow.next_victim];
+        nv_pci_cfg_shadow.next_victim = (nv_pci_cfg_shadow.next_victim + 1) %
+                                        NV_PCI_CFG_SHADOW_FUNCTIONS;
+    }
+
+    memset(shadow, 0, sizeof(*shadow));
+    shadow->in_use   = NV_TRUE;
+    shadow->bus      = dev->bus;
+    shadow->slot     = dev->slot;
+    shadow->function = dev->function;
+    shadow->pcie_cap = pcie_cap;
+
+    return shadow;
+}
+
+//
+// Returns the dword of config space at the dword aligned offset, from the
+// shadow if it is one of the shadowed dwords.
+//
+static NvU32 nv_pci_cfg_read_dword(struct pci_dev *dev, NvU32 offset)
+{
+    nv_pci_cfg_shadow_t *shadow;
+    u64 flags;
+    NvU16 pcie_cap;
+    NvU32 value;
+    int index;
+
+    nv_pci_cfg_shadow_init_once();
+
+    spin_lock_irqsave(&nv_pci_cfg_shadow.lock, flags);
+    shadow = nv_pci_cfg_shadow_find(dev);
+    if (shadow != NULL)
+    {
+        index = nv_pci_cfg_shadow_index(shadow, offset);
+        if ((index >= 0) && (shadow->valid_mask & NVBIT(index)))
+        {
+            value = shadow->dwords[index];
+            spin_unlock_irqrestore(&nv_pci_cfg_shadow.lock, flags);
+            return value;
+        }
+    }
+    spin_unlock_irqrestore(&nv_pci_cfg_shadow.lock, flags);
+
+    // Locate the PCIe capability the first time the function is accessed
+    pcie_cap = (shadow == NULL) ? nv_find_pci_capability(dev, NV_PCI_CAP_ID_EXP) : 0;
+
+    value = pci_cfgread(dev, offset, 4);
+
+    //
+    // An all-ones read usually means the function is gone or in reset, don't
+    // keep it.
+    //
+    if (value == 0xffffffff)
+        return value;
+
+    spin_lock_irqsave(&nv_pci_cfg_shadow.lock, flags);
+    shadow = nv_pci_cfg_shadow_find(dev);
+    if (shadow == NULL)
+        shadow = nv_pci_cfg_shadow_create(dev, pcie_cap);
+
+    index = nv_pci_cfg_shadow_index(shadow, offset);
+    if (index >= 0)
+    {
+        shadow->dwords[index] = value;
+        shadow->valid_mask |= NVBIT(index);
+    }
+    spin_unlock_irqrestore(&nv_pci_cfg_shadow.lock, flags);
+
+    return value;
+}
+
+//
+// Drops the shadow of the function before it is written to, or the shadows of
+// all functions for writes to the bridge control register.
+//
+static void nv_pci_cfg_shadow_invalidate(struct pci_dev *dev, NvU32 offset)
+{
+    nv_pci_cfg_shadow_t *shadow;
+    u64 flags;
+    unsigned i;
+
+    nv_pci_cfg_shadow_init_once();
+
+    spin_lock_irqsave(&nv_pci_cfg_shadow.lock, flags);
+    if ((offset & ~0x3) == NV_PCI_CFG_BRIDGE_CONTROL)
+    {
+        for (i = 0; i < NV_PCI_CFG_SHADOW_FUNCTIONS; i++)
+            nv_pci_cfg_shadow.functions[i].in_use = NV_FALSE;
+    }
+    else
+    {
+        shadow = nv_pci_cfg_shadow_find(dev);
+        if (shadow != NULL)
+            shadow->in_use = NV_FALSE;
+    }
+    spin_unlock_irqrestore(&nv_pci_cfg_shadow.lock, flags);
+}
+
+static NvBool nv_pci_cfg_is_shadowable(struct pci_dev *dev, NvU32 offset)
+{
+    //
+    // Only the registers of the header and of the PCIe capability can be
+    // shadowed, which all sit in the legacy config space. Extended config
+    // space (AER and friends) always goes to the hardware.
+    //
+    return offset < 0x100;
+}
+
 void* NV_API_CALL os_pci_init_handle(
     NvU32 domain,
     NvU8  bus,
@@ -49,7 +281,15 @@ NV_STATUS NV_API_CALL os_pci_read_byte(
         *pReturnValue = 0xff;
         return NV_ERR_NOT_SUPPORTED;
     }
-    *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 1);
+    if (nv_pci_cfg_is_shadowable(handle, offset) && (((offset & 0x3) + 1) <= 4))
+    {
+        *pReturnValue = (NvU8)(nv_pci_cfg_read_dword(handle, offset & ~0x3) >>
+                                 ((offset & 0x3) * 8));
+    }
+    else
+    {
+        *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 1);
+    }
     return NV_OK;
 }
 
@@ -64,7 +304,15 @@ NV_STATUS NV_API_CALL os_pci_read_word(
         *pReturnValue = 0xffff;
         return NV_ERR_NOT_SUPPORTED;
     }
-    *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 2);
+    if (nv_pci_cfg_is_shadowable(handle, offset) && (((offset & 0x3) + 2) <= 4))
+    {
+        *pReturnValue = (NvU16)(nv_pci_cfg_read_dword(handle, offset & ~0x3) >>
+                                 ((offset & 0x3) * 8));
+    }
+    else
+    {
+        *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 2);
+    }
     return NV_OK;
 }
 
@@ -79,7 +327,10 @@ NV_STATUS NV_API_CALL os_pci_read_dword(
         *pReturnValue = 0xffffffff;
         return NV_ERR_NOT_SUPPORTED;
     }
-    *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 4);
+    if (nv_pci_cfg_is_shadowable(handle, offset) && ((offset & 0x3) == 0))
+        *pReturnValue = nv_pci_cfg_read_dword(handle, offset);
+    else
+        *pReturnValue = pci_cfgread( (struct pci_dev *) handle, offset, 4);
     return NV_OK;
 }
 
@@ -92,6 +343,7 @@ NV_STATUS NV_API_CALL os_pci_write_byte(
     if (offset >= NV_PCIE_CFG_MAX_OFFSET)
         return NV_ERR_NOT_SUPPORTED;
 
+    nv_pci_cfg_shadow_invalidate(handle, offset);
     pci_cfgwrite( (struct pci_dev *) handle, offset, 1, value);
     return NV_OK;
 }
@@ -105,6 +357,7 @@ NV_STATUS NV_API_CALL os_pci_write_word(
     if (offset >= NV_PCIE_CFG_MAX_OFFSET)
         return NV_ERR_NOT_SUPPORTED;
 
+    nv_pci_cfg_shadow_invalidate(handle, offset);
     pci_cfgwrite( (struct pci_dev *) handle, offset, 2, value);
     return NV_OK;
 }
@@ -118,6 +371,7 @@ NV_STATUS NV_API_CALL os_pci_write_dword(
     if (offset >= NV_PCIE_CFG_MAX_OFFSET)
         return NV_ERR_NOT_SUPPORTED;
 
+    nv_pci_cfg_shadow_invalidate(handle, offset);
     pci_cfgwrite( (struct pci_dev *) handle, offset, 4, value);
     return NV_OK;
 }
@@ -136,6 +390,7 @@ void NV_API_CALL os_pci_remove(
 )
 {
 #if defined(NV_PCI_STOP_AND_REMOVE_BUS_DEVICE)
+    nv_pci_cfg_shadow_invalidate(handle, 0);
     NV_PCI_STOP_AND_REMOVE_BUS_DEVICE(handle);
 #elif defined(DEBUG)
     nv_printf(NV_DBG_ERRORS,
@@ -172,6 +172,12 @@ struct nvlink_link
     // Lock for per link structure
     void *linkLock;
 
+    //
+    // Last endpoint state read by the core, packed so that it is written and
+    // read with a single 64-bit access. See nvlink_lib_get_link_state_snapshot()
+    //
+    volatile NvU64 stateSnapshot;
+
     // Uniquely identifies a link in the core
     NvU64 linkId;
 
@@ -461,6 +467,13 @@ NvlStatus nvlink_lib_get_link(nvlink_device  *device,
                               NvU32           link_id,
                               nvlink_link   **link);
 
+/*
+ * Get the last known link and sublink states of the link without taking any
+ * lock or accessing the hardware
+ */
+NvlStatus nvlink_lib_get_link_state_snapshot(nvlink_link       *link,
+                                             nvlink_link_state *linkState);
+
 /*
  * Set the link endpoint as the link master
  */
@@ -27,6 +27,24 @@ extern "C" {
 
 #include "nvlink_common.h"
 
+//
+// Lock ordering
+//
+// The top-level lock protects the topology: the device list, the link list
+// of each device and the connection lists. Entry points take it only to look
+// up the links they operate on, take the per-link locks of those links and
+// then drop it before touching the hardware, so that an operation on some
+// links (training, state queries) doesn't block operations on other links.
+//
+// 1. Top-level lock
+// 2. Per-link locks, always all at once with nvlink_lib_link_locks_acquire(),
+//    which takes them in increasing (DBDF, link#) order
+//
+// A per-link lock must never be held while acquiring the top-level lock.
+// Readers that only need the last known state of a link use
+// nvlink_lib_get_link_state_snapshot(), which takes no lock.
+//
+
 /*
  * Allocate top level lock. Return NVL_SUCCESS if 
  * the lock was allocated else return NVL_ERR_GENERIC.
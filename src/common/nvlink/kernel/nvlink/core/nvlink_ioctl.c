@@ -330,6 +330,9 @@ nvlink_core_get_endpoint_state
     nvlink_assert(status == NVL_SUCCESS);
 
     linkState->rxSubLinkMode = _nvlink_core_map_rx_sublink_state(state);
+
+    // Publish the state for lock-free readers of the link state
+    nvlink_memWr64(&link->stateSnapshot, NVLINK_STATE_SNAPSHOT(linkState));
 }
 
 /**
@@ -49,6 +49,47 @@ nvlink_lib_is_link_list_empty
     return isEmpty;
 }
 
+/**
+ * Get the last known link and sublink states of the link.
+ *
+ * The state is the one read the last time the core queried the link, for
+ * instance for CTRL_NVLINK_GET_DEVICE_LINK_STATES or after training. No lock
+ * is taken and the hardware isn't accessed, so periodic monitoring doesn't
+ * contend with training and discovery. The caller must guarantee the link
+ * stays registered for the duration of the call.
+ *
+ * @param[in]   link       NVLink Link pointer
+ * @param[out]  linkState  Last known state of the link
+ *
+ * return NVL_SUCCESS on success, NVL_NOT_FOUND if the state was never read
+ */
+NvlStatus
+nvlink_lib_get_link_state_snapshot
+(
+    nvlink_link       *link,
+    nvlink_link_state *linkState
+)
+{
+    NvU64 snapshot;
+
+    if ((link == NULL) || (linkState == NULL))
+    {
+        return NVL_BAD_ARGS;
+    }
+
+    snapshot = nvlink_memRd64(&link->stateSnapshot);
+    if (!(snapshot & NVLINK_STATE_SNAPSHOT_VALID))
+    {
+        return NVL_NOT_FOUND;
+    }
+
+    linkState->linkMode      = NVLINK_STATE_SNAPSHOT_LINK_MODE(snapshot);
+    linkState->txSubLinkMode = NVLINK_STATE_SNAPSHOT_TX_MODE(snapshot);
+    linkState->rxSubLinkMode = NVLINK_STATE_SNAPSHOT_RX_MODE(snapshot);
+
+    return NVL_SUCCESS;
+}
+
 /**
  * Get the link associated with the given link id.
  *
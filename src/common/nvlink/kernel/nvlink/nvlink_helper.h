@@ -30,6 +30,20 @@
 #define NVLINK_FABRIC_NODE_ID_MASK 0xFFFF
 #define NVLINK_FABRIC_NODE_ID_POS  48
 
+//
+// Layout of nvlink_link::stateSnapshot. The valid bit is clear until the core
+// has read the endpoint state of the link once.
+//
+#define NVLINK_STATE_SNAPSHOT_LINK_MODE(s)      ((NvU8)((s) & 0xFF))
+#define NVLINK_STATE_SNAPSHOT_TX_MODE(s)        ((NvU8)(((s) >> 8) & 0xFF))
+#define NVLINK_STATE_SNAPSHOT_RX_MODE(s)        ((NvU8)(((s) >> 16) & 0xFF))
+#define NVLINK_STATE_SNAPSHOT_VALID             (1ULL << 32)
+#define NVLINK_STATE_SNAPSHOT(linkState)                \
+    (NVLINK_STATE_SNAPSHOT_VALID                      | \
+     ((NvU64)(linkState)->linkMode)                   | \
+     ((NvU64)(linkState)->txSubLinkMode << 8)         | \
+     ((NvU64)(linkState)->rxSubLinkMode << 16))
+
 /**
  * Check if the device type is supported
  */
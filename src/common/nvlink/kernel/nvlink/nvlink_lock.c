@@ -27,8 +27,8 @@
 
 //
 // Only enabling top level locking for linux as required by Bug 4108674.
-// Per link locking is still disabled at all times. It will be enabled 
-// after other locking related clean up is done.
+// Per link locking is enabled along with it, see nvlink_lock.h for the
+// lock ordering.
 // 
 
 static void   _sort_links(nvlink_link **, NvU32, NvBool (*)(void *, void *));
@@ -37,6 +37,8 @@ static NvBool _compare(void *, void *);
 #if defined(NV_LINUX)
 #undef TOP_LEVEL_LOCKING_DISABLED 
 #   define TOP_LEVEL_LOCKING_DISABLED 0
+#undef PER_LINK_LOCKING_DISABLED
+#   define PER_LINK_LOCKING_DISABLED 0
 #endif  /* defined(NV_LINUX) */
 /*
  * Allocate top level lock. Return NVL_SUCCESS if 
@@ -2653,6 +2653,58 @@ typedef struct
     NV_DECLARE_ALIGNED(NvU64 nvlinkCounters[NVSWITCH_NVLINK_COUNTER_MAX_TYPES], 8);
 } NVSWITCH_NVLINK_GET_COUNTERS_PARAMS;
 
+/*
+ * CTRL_NVSWITCH_GET_COUNTER_SNAPSHOT
+ *  This command reads the throughput counters and the nvlink counters of all
+ *  the requested links in one call, instead of one
+ *  CTRL_NVSWITCH_GET_THROUGHPUT_COUNTERS call and one CTRL_NVSWITCH_GET_COUNTERS
+ *  call per link.
+ *
+ * [in] linkMask
+ *  This parameter specifies the links to read the counters of.
+ *
+ * [in] throughputCounterMask
+ *  This parameter specifies the throughput counter types to read, as a mask
+ *  of NVSWITCH_THROUGHPUT_COUNTERS_TYPE_*.
+ *
+ * [in] nvlinkCounterMask
+ *  This parameter specifies the nvlink counter types to read, as for
+ *  CTRL_NVSWITCH_GET_COUNTERS.
+ *
+ * [in] bUseSample
+ *  If NV_TRUE, the counters are returned from the last sample taken by the
+ *  driver's periodic counter sampler (see the CounterSampleIntervalMsec
+ *  regkey) and the hardware is not accessed. Fails with
+ *  NVL_ERR_NOT_SUPPORTED if the sampler is disabled or has no sample yet, and
+ *  with NVL_BAD_ARGS if a requested counter type isn't sampled.
+ *
+ * [out] timestampNs
+ *  Platform time at which the counters were read.
+ *
+ * [out] validLinkMask
+ *  The links of linkMask whose counters were read.
+ *
+ * [out] throughput
+ *  The throughput counters, indexed by link and then as for
+ *  CTRL_NVSWITCH_GET_THROUGHPUT_COUNTERS.
+ *
+ * [out] nvlinkCounters
+ *  The nvlink counters, indexed by link and then as for
+ *  CTRL_NVSWITCH_GET_COUNTERS.
+ */
+
+typedef struct
+{
+    NV_DECLARE_ALIGNED(NvU64 linkMask, 8);
+    NvU16  throughputCounterMask;
+    NvU32  nvlinkCounterMask;
+    NvBool bUseSample;
+    NV_DECLARE_ALIGNED(NvU64 timestampNs, 8);
+    NV_DECLARE_ALIGNED(NvU64 validLinkMask, 8);
+    NVSWITCH_THROUGHPUT_COUNTER_VALUES throughput[NVSWITCH_MAX_PORTS];
+    NV_DECLARE_ALIGNED(NvU64 nvlinkCounters[NVSWITCH_MAX_PORTS][NVSWITCH_NVLINK_COUNTER_MAX_TYPES], 8);
+} NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS;
+
 /*
  * Structure to store the ECC error data.
  * valid
@@ -3848,6 +3900,7 @@ typedef struct
 #define CTRL_NVSWITCH_RESERVED_11                           0x55
 #define CTRL_NVSWITCH_GET_BOARD_PART_NUMBER                 0x56
 #define CTRL_NVSWITCH_GET_POWER                             0x57
+#define CTRL_NVSWITCH_GET_COUNTER_SNAPSHOT                  0x58
 
 #ifdef __cplusplus
 }
@@ -219,6 +219,12 @@ nvswitch_record_error
     }
     errors->error_total++;
     device->error_total++;
+
+    // Poll at the base period again until the interrupt path proves itself
+    if (errors == &device->log_FATAL_ERRORS)
+    {
+        nvswitch_task_reset_backoff(device);
+    }
 }
 
 //
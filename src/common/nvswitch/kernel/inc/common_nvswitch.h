@@ -271,6 +271,8 @@ typedef struct
     NvU32 surpress_link_errors_for_gpu_reset;
     NvU32 block_code_mode;
     NvU32 reference_clock_mode;
+    NvU32 counter_sample_interval;
+    NvU32 counter_sample_nvlink_mask;
 } NVSWITCH_REGKEY_TYPE;
 
 //
@@ -291,6 +293,16 @@ typedef struct NVSWITCH_TASK
 #define NVSWITCH_TASK_TYPE_FLAGS_RUN_EVEN_IF_DEVICE_NOT_INITIALIZED     0x1    // Run even the if not initialized
 #define NVSWITCH_TASK_TYPE_FLAGS_RUN_ONCE                               0x2    // Only run the task once. Memory for task struct and args will be freed by dispatcher after running.
 #define NVSWITCH_TASK_TYPE_FLAGS_VOID_PTR_ARGS                          0x4    // Function accepts args as void * args. 
+#define NVSWITCH_TASK_TYPE_FLAGS_BACKOFF_WHEN_INTR_HEALTHY              0x8    // Stretch the period while interrupts are being serviced cleanly.
+
+//
+// Polling backoff. Every NVSWITCH_TASK_BACKOFF_HEALTHY_INTRS interrupts
+// serviced without error double the period of the backoff tasks and the
+// dispatcher idle wakeup, up to 1 << NVSWITCH_TASK_BACKOFF_MAX_SHIFT. A failed
+// service or a fatal error drops back to the base period.
+//
+#define NVSWITCH_TASK_BACKOFF_HEALTHY_INTRS                             16
+#define NVSWITCH_TASK_BACKOFF_MAX_SHIFT                                 3
 
 //
 // Wrapper struct for deffered SXID errors
@@ -363,6 +375,11 @@ struct nvswitch_device
 
     // Tasks
     NVSWITCH_TASK_TYPE                  *tasks;
+    NvU32                               task_backoff_shift;
+    NvU32                               intr_healthy_count;
+
+    // Last sample of the counter sampler, NULL if it is disabled
+    NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS *counter_sample;
 
     // Errors
     NvU64                               error_total;    // Total errors recorded across all error logs
@@ -524,6 +541,7 @@ typedef struct NVSWITCH_TIMEOUT
 #define NVSWITCH_INTERVAL_4SEC_IN_NS      4000000000LL
 
 #define NVSWITCH_HEARTBEAT_INTERVAL_NS    NVSWITCH_INTERVAL_1SEC_IN_NS
+#define NVSWITCH_TASK_IDLE_INTERVAL_NS    (100*NVSWITCH_INTERVAL_1MSEC_IN_NS)
 
 // This should only be used for short delays
 #define NVSWITCH_NSEC_DELAY(nsec_delay)                         \
@@ -555,6 +573,7 @@ NvlStatus nvswitch_task_create(nvswitch_device *device,
 NvlStatus nvswitch_task_create_args(nvswitch_device* device, void *fn_args,
                                void (*task_fn)(nvswitch_device* device, void *fn_args), 
                                NvU64 period_nsec, NvU32 flags);
+void nvswitch_task_reset_backoff(nvswitch_device *device);
 void nvswitch_tasks_destroy(nvswitch_device *device);
 
 void nvswitch_free_chipdevice(nvswitch_device *device);
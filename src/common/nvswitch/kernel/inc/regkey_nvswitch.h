@@ -620,4 +620,28 @@
 #define NV_SWITCH_REGKEY_REFERENCE_CLOCK_MODE_NON_COMMON_NO_SS  0x2
 #define NV_SWITCH_REGKEY_REFERENCE_CLOCK_MODE_NON_COMMON_SS     0x3
 
+/*
+ * NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL - Period of the counter sampler
+ *
+ * When non-zero, the throughput counters of all enabled links, and the nvlink
+ * counters selected by NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK, are read
+ * every this many milliseconds. CTRL_NVSWITCH_GET_COUNTER_SNAPSHOT with
+ * bUseSample set returns the last sample without accessing the hardware.
+ *
+ * Public: Available in release drivers
+ */
+#define NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL                "CounterSampleIntervalMsec"
+#define NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL_DISABLE        0x0
+
+/*
+ * NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK - nvlink counters sampled
+ *
+ * Mask of the CTRL_NVSWITCH_GET_COUNTERS counter types read by the counter
+ * sampler. 0 samples only the throughput counters.
+ *
+ * Public: Available in release drivers
+ */
+#define NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK             "CounterSampleNvlinkMask"
+#define NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK_DEFAULT     0x0
+
 #endif //_REGKEY_NVSWITCH_H_
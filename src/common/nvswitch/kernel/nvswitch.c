@@ -543,6 +543,14 @@ _nvswitch_init_device_regkeys
     NVSWITCH_INIT_REGKEY(_PRIVATE, reference_clock_mode,
                          NV_SWITCH_REGKEY_REFERENCE_CLOCK_MODE,
                          NV_SWITCH_REGKEY_REFERENCE_CLOCK_MODE_DEFAULT);
+
+    NVSWITCH_INIT_REGKEY(_PUBLIC, counter_sample_interval,
+                         NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL,
+                         NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL_DISABLE);
+
+    NVSWITCH_INIT_REGKEY(_PUBLIC, counter_sample_nvlink_mask,
+                         NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK,
+                         NV_SWITCH_REGKEY_COUNTER_SAMPLE_NVLINK_MASK_DEFAULT);
 }
 NvU64
 nvswitch_lib_deferred_task_dispatcher
@@ -551,7 +559,9 @@ nvswitch_lib_deferred_task_dispatcher
 )
 {
     NvU64 time_nsec;
-    NvU64 time_next_nsec = nvswitch_os_get_platform_time() + 100*NVSWITCH_INTERVAL_1MSEC_IN_NS;
+    NvU64 time_next_nsec;
+    NvU64 period_nsec;
+    NvU32 backoff_shift;
     NVSWITCH_TASK_TYPE *task;
     NVSWITCH_TASK_TYPE *prev_task;
 
@@ -560,6 +570,10 @@ nvswitch_lib_deferred_task_dispatcher
         return NV_U64_MAX;
     }
 
+    backoff_shift = device->task_backoff_shift;
+    time_next_nsec = nvswitch_os_get_platform_time() +
+                     (NVSWITCH_TASK_IDLE_INTERVAL_NS << backoff_shift);
+
     prev_task = NULL;
     task = device->tasks;
 
@@ -569,7 +583,13 @@ nvswitch_lib_deferred_task_dispatcher
         // Get current time (nsec) for scheduling
         time_nsec = nvswitch_os_get_platform_time();
 
-        if (time_nsec >= task->last_run_nsec + task->period_nsec)
+        period_nsec = task->period_nsec;
+        if (task->flags & NVSWITCH_TASK_TYPE_FLAGS_BACKOFF_WHEN_INTR_HEALTHY)
+        {
+            period_nsec <<= backoff_shift;
+        }
+
+        if (time_nsec >= task->last_run_nsec + period_nsec)
         {
             //
             // The task has never been run or it is time to run
@@ -588,7 +608,7 @@ nvswitch_lib_deferred_task_dispatcher
         }
         
         // Determine its next run time
-        time_next_nsec = NV_MIN(task->last_run_nsec + task->period_nsec, time_next_nsec);
+        time_next_nsec = NV_MIN(task->last_run_nsec + period_nsec, time_next_nsec);
 
         // Advance pointer. If run once flag is set and task ran, remove task from list.
         if((task->flags & NVSWITCH_TASK_TYPE_FLAGS_RUN_ONCE) &&
@@ -1335,6 +1355,156 @@ _nvswitch_ctrl_therm_get_temperature_limit
     return device->hal.nvswitch_ctrl_therm_get_temperature_limit(device, pParams);
 }
 
+//
+// Reads the counters requested by p for all the links of p->linkMask. Links
+// whose counters can't be read are left out of p->validLinkMask.
+//
+static NvlStatus
+_nvswitch_read_counter_snapshot
+(
+    nvswitch_device *device,
+    NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS *p
+)
+{
+    NVSWITCH_GET_THROUGHPUT_COUNTERS_PARAMS *throughput;
+    NVSWITCH_NVLINK_GET_COUNTERS_PARAMS counters;
+    NvlStatus status;
+    NvU32 i;
+
+    p->validLinkMask = 0;
+    nvswitch_os_memset(p->throughput, 0, sizeof(p->throughput));
+    nvswitch_os_memset(p->nvlinkCounters, 0, sizeof(p->nvlinkCounters));
+
+    // The throughput counters of all the links are read in one HAL call
+    if (p->throughputCounterMask != 0)
+    {
+        throughput = nvswitch_os_malloc(sizeof(*throughput));
+        if (throughput == NULL)
+        {
+            return -NVL_NO_MEM;
+        }
+
+        throughput->counterMask = p->throughputCounterMask;
+        throughput->linkMask = p->linkMask;
+
+        status = device->hal.nvswitch_ctrl_get_throughput_counters(device, throughput);
+        if (status == NVL_SUCCESS)
+        {
+            nvswitch_os_memcpy(p->throughput, throughput->counters, sizeof(p->throughput));
+        }
+
+        nvswitch_os_free(throughput);
+
+        if (status != NVL_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    FOR_EACH_INDEX_IN_MASK(64, i, p->linkMask)
+    {
+        if (!nvswitch_is_link_valid(device, i))
+        {
+            continue;
+        }
+
+        if (p->nvlinkCounterMask != 0)
+        {
+            nvswitch_os_memset(&counters, 0, sizeof(counters));
+            counters.linkId = i;
+            counters.counterMask = p->nvlinkCounterMask;
+
+            status = device->hal.nvswitch_ctrl_get_counters(device, &counters);
+            if (status != NVL_SUCCESS)
+            {
+                NVSWITCH_PRINT(device, INFO,
+                    "%s: Failed to read counters of link %d, rc: %d\n",
+                    __FUNCTION__, i, status);
+                continue;
+            }
+
+            nvswitch_os_memcpy(p->nvlinkCounters[i], counters.nvlinkCounters,
+                               sizeof(p->nvlinkCounters[i]));
+        }
+
+        p->validLinkMask |= NVBIT64(i);
+    }
+    FOR_EACH_INDEX_IN_MASK_END;
+
+    p->timestampNs = nvswitch_os_get_platform_time();
+
+    return NVL_SUCCESS;
+}
+
+static void
+_nvswitch_counter_sample_task
+(
+    nvswitch_device *device
+)
+{
+    NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS *sample = device->counter_sample;
+
+    if (sample == NULL)
+    {
+        return;
+    }
+
+    sample->linkMask = nvswitch_get_enabled_link_mask(device);
+    sample->throughputCounterMask = NVSWITCH_THROUGHPUT_COUNTERS_TYPE_DATA_TX |
+                                    NVSWITCH_THROUGHPUT_COUNTERS_TYPE_DATA_RX |
+                                    NVSWITCH_THROUGHPUT_COUNTERS_TYPE_RAW_TX |
+                                    NVSWITCH_THROUGHPUT_COUNTERS_TYPE_RAW_RX;
+    sample->nvlinkCounterMask = device->regkeys.counter_sample_nvlink_mask;
+
+    // A failed sample is not returned to clients
+    if (_nvswitch_read_counter_snapshot(device, sample) != NVL_SUCCESS)
+    {
+        sample->timestampNs = 0;
+    }
+}
+
+static NvlStatus
+_nvswitch_ctrl_get_counter_snapshot
+(
+    nvswitch_device *device,
+    NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS *p
+)
+{
+    NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS *sample = device->counter_sample;
+    NvU32 i;
+
+    if (!p->bUseSample)
+    {
+        return _nvswitch_read_counter_snapshot(device, p);
+    }
+
+    if ((sample == NULL) || (sample->timestampNs == 0))
+    {
+        return -NVL_ERR_NOT_SUPPORTED;
+    }
+
+    if ((p->throughputCounterMask & ~sample->throughputCounterMask) ||
+        (p->nvlinkCounterMask & ~sample->nvlinkCounterMask))
+    {
+        return -NVL_BAD_ARGS;
+    }
+
+    p->timestampNs = sample->timestampNs;
+    p->validLinkMask = p->linkMask & sample->validLinkMask;
+    nvswitch_os_memset(p->throughput, 0, sizeof(p->throughput));
+    nvswitch_os_memset(p->nvlinkCounters, 0, sizeof(p->nvlinkCounters));
+
+    FOR_EACH_INDEX_IN_MASK(64, i, p->validLinkMask)
+    {
+        p->throughput[i] = sample->throughput[i];
+        nvswitch_os_memcpy(p->nvlinkCounters[i], sample->nvlinkCounters[i],
+                           sizeof(p->nvlinkCounters[i]));
+    }
+    FOR_EACH_INDEX_IN_MASK_END;
+
+    return NVL_SUCCESS;
+}
+
 NvlStatus
 nvswitch_lib_initialize_device
 (
@@ -1564,7 +1734,25 @@ nvswitch_lib_initialize_device
     else
     {
         nvswitch_task_create(device, &nvswitch_monitor_thermal_alert,
-            100*NVSWITCH_INTERVAL_1MSEC_IN_NS, 0);
+            100*NVSWITCH_INTERVAL_1MSEC_IN_NS,
+            NVSWITCH_TASK_TYPE_FLAGS_BACKOFF_WHEN_INTR_HEALTHY);
+    }
+
+    if (device->regkeys.counter_sample_interval != NV_SWITCH_REGKEY_COUNTER_SAMPLE_INTERVAL_DISABLE)
+    {
+        device->counter_sample = nvswitch_os_malloc(sizeof(*device->counter_sample));
+        if (device->counter_sample != NULL)
+        {
+            nvswitch_os_memset(device->counter_sample, 0, sizeof(*device->counter_sample));
+            nvswitch_task_create(device, &_nvswitch_counter_sample_task,
+                device->regkeys.counter_sample_interval * NVSWITCH_INTERVAL_1MSEC_IN_NS, 0);
+        }
+        else
+        {
+            NVSWITCH_PRINT(device, ERROR,
+                "%s: Failed to allocate the counter sample, sampling disabled\n",
+                __FUNCTION__);
+        }
     }
 
     device->nvlink_device->initialized = 1;
@@ -2005,6 +2193,12 @@ nvswitch_lib_shutdown_device
 
     nvswitch_tasks_destroy(device);
 
+    if (device->counter_sample != NULL)
+    {
+        nvswitch_os_free(device->counter_sample);
+        device->counter_sample = NULL;
+    }
+
     return NVL_SUCCESS;
 }
 
@@ -3963,12 +4157,44 @@ nvswitch_lib_service_interrupts
     nvswitch_device *device
 )
 {
+    NvlStatus retval;
+
     if (!NVSWITCH_IS_DEVICE_INITIALIZED(device))
     {
         return -NVL_BAD_ARGS;
     }
 
-    return device->hal.nvswitch_lib_service_interrupts(device);
+    retval = device->hal.nvswitch_lib_service_interrupts(device);
+
+    //
+    // Stretch the polling tasks while the interrupt path keeps up on its own,
+    // and go back to the base period as soon as it doesn't.
+    //
+    if (retval == NVL_SUCCESS)
+    {
+        if ((device->task_backoff_shift < NVSWITCH_TASK_BACKOFF_MAX_SHIFT) &&
+            (++device->intr_healthy_count >= NVSWITCH_TASK_BACKOFF_HEALTHY_INTRS))
+        {
+            device->task_backoff_shift++;
+            device->intr_healthy_count = 0;
+        }
+    }
+    else
+    {
+        nvswitch_task_reset_backoff(device);
+    }
+
+    return retval;
+}
+
+void
+nvswitch_task_reset_backoff
+(
+    nvswitch_device *device
+)
+{
+    device->intr_healthy_count = 0;
+    device->task_backoff_shift = 0;
 }
 
 NvU64
@@ -5181,6 +5407,11 @@ nvswitch_lib_ctrl
         NVSWITCH_DEV_CMD_DISPATCH(CTRL_NVSWITCH_GET_POWER,
                 _nvswitch_ctrl_therm_read_power,
                 NVSWITCH_GET_POWER_PARAMS);
+        NVSWITCH_DEV_CMD_DISPATCH_PRIVILEGED(
+                CTRL_NVSWITCH_GET_COUNTER_SNAPSHOT,
+                _nvswitch_ctrl_get_counter_snapshot,
+                NVSWITCH_GET_COUNTER_SNAPSHOT_PARAMS,
+                osPrivate, flags);
 
         default:
             nvswitch_os_print(NVSWITCH_DBG_LEVEL_INFO, "unknown ioctl %x\n", cmd);
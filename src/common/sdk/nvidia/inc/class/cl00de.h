@@ -37,6 +37,18 @@ typedef struct NV00DE_SHARED_DATA {
     NvU32 bar1AvailSize;
 
     NvU32 gspAssertCount;
+
+    // Newest GSP perfmon utilization sample, in units of pct*100. Refreshed
+    // about once a second; utilTimeStamp stays 0 until the first sample.
+    NV_DECLARE_ALIGNED(NvU64 utilTimeStamp, 8);
+    NvU32 grUtil;
+    NvU32 fbUtil;
+    NvU32 nvencUtil;
+    NvU32 nvdecUtil;
+
+    // Framebuffer free/total bytes from PMA, refreshed with each util sample
+    NV_DECLARE_ALIGNED(NvU64 fbFreeBytes, 8);
+    NV_DECLARE_ALIGNED(NvU64 fbTotalBytes, 8);
     // New data members always add to bottom
 } NV00DE_SHARED_DATA;
 
@@ -204,7 +204,8 @@ extern "C" {
 #define NV2080_NOTIFIERS_HDMI_FRL_RETRAINING_REQUEST               (178)
 #define NV2080_NOTIFIERS_VRR_SET_TIMEOUT                           (179)
 #define NV2080_NOTIFIERS_AUX_POWER_STATE_CHANGE                    (180)
-#define NV2080_NOTIFIERS_MAXCOUNT                                  (181)
+#define NV2080_NOTIFIERS_PMA_STREAM_WATERMARK                      (181)
+#define NV2080_NOTIFIERS_MAXCOUNT                                  (182)
 
 // Indexed GR notifier reference
 #define NV2080_NOTIFIERS_GR(x)         ((x == 0) ? (NV2080_NOTIFIERS_GR0) : (NV2080_NOTIFIERS_GR1 + (x - 1)))
@@ -253,3 +253,67 @@ typedef struct NV0000_CTRL_GPUACCT_CLEAR_ACCOUNTING_DATA_PARAMS {
 } NV0000_CTRL_GPUACCT_CLEAR_ACCOUNTING_DATA_PARAMS;
 
 
+
+/*
+ * NV0000_CTRL_CMD_GPUACCT_GET_CHANGED_PROCS
+ *
+ * This command returns the accounting data of the processes whose data
+ * changed since a previous call, so that a monitoring client can poll the
+ * accounting data without fetching the data of every process each time.
+ * Processes are returned in the order in which their data changed.
+ *
+ *   gpuId
+ *     This parameter should specify a valid GPU ID value. Refer to the
+ *     description of NV0000_CTRL_CMD_GPU_GET_ATTACHED_IDS for more
+ *     information. If there is no GPU present with the specified ID,
+ *     a status of NV_ERR_INVALID_ARGUMENT is returned.
+ *   pid
+ *     This input parameter has the same meaning as the pid parameter of
+ *     NV0000_CTRL_CMD_GPUACCT_GET_ACCOUNTING_PIDS.
+ *   cursor
+ *     On input, this parameter specifies the cursor returned by the previous
+ *     call, or zero to get the data of all the processes. On output, it
+ *     returns the cursor to pass to the next call.
+ *   procCount
+ *     This parameter returns the number of entries in procTbl.
+ *   bMore
+ *     This parameter returns NV_TRUE if more processes changed than fit in
+ *     procTbl. The caller should call again with the returned cursor.
+ *   procTbl
+ *     This parameter returns the accounting data of the processes. The
+ *     fields have the same meaning as the fields of
+ *     NV0000_CTRL_GPUACCT_GET_PROC_ACCOUNTING_INFO_PARAMS, and bRunning is
+ *     NV_TRUE for processes still running on the GPU.
+ *
+ * Processes whose accounting data is cleared or evicted are not reported.
+ *
+ * Possible status values returned are:
+ *   NV_OK
+ *   NV_ERR_INVALID_ARGUMENT
+ *   NV_ERR_NOT_SUPPORTED
+ */
+#define NV0000_CTRL_CMD_GPUACCT_GET_CHANGED_PROCS (0xb06) /* finn: Evaluated from "(FINN_NV01_ROOT_GPUACCT_INTERFACE_ID << 8) | NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS_MESSAGE_ID" */
+
+/* max size of procTbl */
+#define NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT      64
+
+typedef struct NV0000_CTRL_GPUACCT_CHANGED_PROC {
+    NvU32  pid;
+    NvU32  gpuUtil;
+    NvU32  fbUtil;
+    NvBool bRunning;
+    NV_DECLARE_ALIGNED(NvU64 maxFbUsage, 8);
+    NV_DECLARE_ALIGNED(NvU64 startTime, 8);
+    NV_DECLARE_ALIGNED(NvU64 endTime, 8);
+} NV0000_CTRL_GPUACCT_CHANGED_PROC;
+
+#define NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS_MESSAGE_ID (0x6U)
+
+typedef struct NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS {
+    NvU32  gpuId;
+    NvU32  pid;
+    NV_DECLARE_ALIGNED(NvU64 cursor, 8);
+    NvU32  procCount;
+    NvBool bMore;
+    NV_DECLARE_ALIGNED(NV0000_CTRL_GPUACCT_CHANGED_PROC procTbl[NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT], 8);
+} NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS;
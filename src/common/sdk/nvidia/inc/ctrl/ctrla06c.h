@@ -400,6 +400,90 @@ typedef struct NVA06C_CTRL_MAKE_REALTIME_PARAMS {
     NvBool bRealtime;
 } NVA06C_CTRL_MAKE_REALTIME_PARAMS;
 
+/*
+ * Scheduling classes
+ *
+ * A scheduling class bundles the timeslice, the preemption timeout and the
+ * interleave level of a TSG. The settings of each class are owned by RM and
+ * are the same for all TSGs of the class on a GPU.
+ *
+ *       - DEFAULT:     The RM defaults a TSG is created with
+ *       - LATENCY:     HIGH interleave level and a short preemption timeout,
+ *                      for latency-sensitive work such as interactive
+ *                      inference
+ *       - THROUGHPUT:  MEDIUM interleave level and a long timeslice, for
+ *                      batch work such as training
+ *       - BEST_EFFORT: LOW interleave level, for background work
+ *
+ * A TSG is put in a class at allocation time through the schedClass field of
+ * NV_CHANNEL_GROUP_ALLOCATION_PARAMETERS, or later through
+ * NVA06C_CTRL_CMD_SET_SCHED_CLASS.
+ */
+#define NVA06C_CTRL_SCHED_CLASS_DEFAULT     (0x00000000)
+#define NVA06C_CTRL_SCHED_CLASS_LATENCY     (0x00000001)
+#define NVA06C_CTRL_SCHED_CLASS_THROUGHPUT  (0x00000002)
+#define NVA06C_CTRL_SCHED_CLASS_BEST_EFFORT (0x00000003)
+#define NVA06C_CTRL_SCHED_CLASS_COUNT       (0x00000004)
+
+/*
+ * NVA06C_CTRL_CMD_SET_SCHED_CLASS
+ *
+ * Moves the channel group to another scheduling class. The timeslice,
+ * preemption timeout and interleave level of the class are applied to the
+ * TSG as a whole, without reconfiguring its channels. If any of them cannot
+ * be applied, the TSG is left in its previous class.
+ *
+ * A later NVA06C_CTRL_CMD_SET_TIMESLICE or
+ * NVA06C_CTRL_CMD_SET_INTERLEAVE_LEVEL overrides the class setting for the
+ * TSG, which stays in its class.
+ *
+ * schedClass
+ *   Input parameter. One of NVA06C_CTRL_SCHED_CLASS_*.
+ * interleaveLevel
+ *   Output parameter containing the interleave level of the class.
+ * preemptTimeoutUs
+ *   Output parameter containing the preemption timeout of the class in
+ *   microseconds. It is used for NVA06C_CTRL_CMD_PREEMPT requests on the TSG
+ *   that don't set bManualTimeout. Zero means the RM default.
+ * timesliceUs
+ *   Output parameter containing the timeslice of the class in microseconds.
+ *
+ * Possible status values returned are:
+ *   NV_OK
+ *   NV_ERR_INVALID_ARGUMENT
+ *   NV_ERR_INVALID_OBJECT
+ *   NV_ERR_NOT_SUPPORTED
+ */
+#define NVA06C_CTRL_CMD_SET_SCHED_CLASS (0xa06c0111) /* finn: Evaluated from "(FINN_KEPLER_CHANNEL_GROUP_A_GPFIFO_INTERFACE_ID << 8) | NVA06C_CTRL_SET_SCHED_CLASS_PARAMS_MESSAGE_ID" */
+
+typedef struct NVA06C_CTRL_SCHED_CLASS_PARAMS {
+    NvU32 schedClass;
+    NvU32 interleaveLevel;
+    NvU32 preemptTimeoutUs;
+    NV_DECLARE_ALIGNED(NvU64 timesliceUs, 8);
+} NVA06C_CTRL_SCHED_CLASS_PARAMS;
+
+#define NVA06C_CTRL_SET_SCHED_CLASS_PARAMS_MESSAGE_ID (0x11U)
+
+typedef NVA06C_CTRL_SCHED_CLASS_PARAMS NVA06C_CTRL_SET_SCHED_CLASS_PARAMS;
+
+/*
+ * NVA06C_CTRL_CMD_GET_SCHED_CLASS
+ *
+ * Returns the scheduling class of the channel group and the settings of that
+ * class. See NVA06C_CTRL_CMD_SET_SCHED_CLASS for the parameters, which are
+ * all output parameters here.
+ *
+ * Possible status values returned are:
+ *   NV_OK
+ *   NV_ERR_INVALID_OBJECT
+ */
+#define NVA06C_CTRL_CMD_GET_SCHED_CLASS (0xa06c0112) /* finn: Evaluated from "(FINN_KEPLER_CHANNEL_GROUP_A_GPFIFO_INTERFACE_ID << 8) | NVA06C_CTRL_GET_SCHED_CLASS_PARAMS_MESSAGE_ID" */
+
+#define NVA06C_CTRL_GET_SCHED_CLASS_PARAMS_MESSAGE_ID (0x12U)
+
+typedef NVA06C_CTRL_SCHED_CLASS_PARAMS NVA06C_CTRL_GET_SCHED_CLASS_PARAMS;
+
 
 
 /*
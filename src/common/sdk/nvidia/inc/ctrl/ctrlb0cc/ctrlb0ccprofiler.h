@@ -556,4 +556,43 @@ typedef struct NVB0CC_CTRL_RELEASE_HES_PARAMS {
     NVB0CC_CTRL_HES_TYPE type;
 } NVB0CC_CTRL_RELEASE_HES_PARAMS;
 
+/*!
+ * NVB0CC_CTRL_CMD_PMA_STREAM_SET_WATERMARK
+ *
+ * Arms a watermark on a PMA stream allocated with
+ * @ref NVB0CC_CTRL_CMD_ALLOC_PMA_STREAM. RM polls the stream's bytes
+ * available and raises NV2080_NOTIFIERS_PMA_STREAM_WATERMARK, with the PMA
+ * channel index in info32, the first time the level reaches the watermark.
+ * The notification is re-armed once the client has consumed the stream
+ * below the watermark again, so it fires once per crossing.
+ *
+ * Continuous profilers can block on the notifier instead of busy-polling
+ * @ref NVB0CC_CTRL_CMD_PMA_STREAM_UPDATE_GET_PUT.
+ */
+#define NVB0CC_CTRL_CMD_PMA_STREAM_SET_WATERMARK (0xb0cc0115) /* finn: Evaluated from "(FINN_MAXWELL_PROFILER_PROFILER_INTERFACE_ID << 8) | NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS_MESSAGE_ID" */
+
+#define NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS_MESSAGE_ID (0x15U)
+
+typedef struct NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS {
+    /*!
+     * [in] The PMA channel index associated with the stream.
+     */
+    NvU32 pmaChannelIdx;
+
+    /*!
+     * [in] Bytes available in the stream at which to notify. 0 disarms the
+     * watermark.
+     */
+    NV_DECLARE_ALIGNED(NvU64 watermarkBytes, 8);
+
+    /*!
+     * [in] Interval at which RM samples the stream, in microseconds. 0 selects
+     * NVB0CC_PMA_STREAM_WATERMARK_POLL_INTERVAL_US_DEFAULT.
+     */
+    NvU32 pollIntervalUs;
+} NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS;
+
+#define NVB0CC_PMA_STREAM_WATERMARK_POLL_INTERVAL_US_DEFAULT    1000
+#define NVB0CC_PMA_STREAM_WATERMARK_POLL_INTERVAL_US_MIN        100
+
 /* _ctrlb0ccprofiler_h_ */
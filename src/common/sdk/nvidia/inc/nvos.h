@@ -515,6 +515,53 @@ typedef struct
     NvV32    status;            // [OUT] status
 } NVOS65_PARAMETERS;
 
+/*
+ * Batched NV04_ALLOC and NV01_FREE
+ *
+ * Allocates, or frees, up to NVOS_BATCH_MAX_ENTRIES objects of one client
+ * with a single call. The entries are processed in order under one RM lock
+ * acquisition, so an entry may use an object allocated by an earlier entry
+ * as its parent. Every entry is attempted and reports its own status; the
+ * top-level status is that of the first entry that failed, or NV_OK.
+ *
+ * Clients themselves cannot be allocated or freed through a batch.
+ */
+#define NVOS_BATCH_MAX_ENTRIES  64
+
+/* function OS66 */
+typedef struct
+{
+    NvHandle hObjectParent;                       // [IN] parent handle of new object
+    NvHandle hObjectNew;                          // [INOUT] new object handle, 0 to generate
+    NvV32    hClass;                              // [IN] class num of new object
+    NvU32    paramsSize;                          // [IN] size of alloc params
+    NvP64    pAllocParms NV_ALIGN_BYTES(8);       // [IN] class-specific alloc parameters
+    NvV32    status;                              // [OUT] status of this entry
+} NVOS66_ALLOC_ENTRY;
+
+typedef struct
+{
+    NvHandle hRoot;                               // [IN] client handle
+    NvU32    numEntries;                          // [IN] number of entries at pEntries
+    NvP64    pEntries NV_ALIGN_BYTES(8);          // [INOUT] NVOS66_ALLOC_ENTRY[numEntries]
+    NvV32    status;                              // [OUT] status
+} NVOS66_PARAMETERS;
+
+/* function OS67 */
+typedef struct
+{
+    NvHandle hObjectOld;                          // [IN] handle of object to free
+    NvV32    status;                              // [OUT] status of this entry
+} NVOS67_FREE_ENTRY;
+
+typedef struct
+{
+    NvHandle hRoot;                               // [IN] client handle
+    NvU32    numEntries;                          // [IN] number of entries at pEntries
+    NvP64    pEntries NV_ALIGN_BYTES(8);          // [INOUT] NVOS67_FREE_ENTRY[numEntries]
+    NvV32    status;                              // [OUT] status
+} NVOS67_PARAMETERS;
+
 /* function OS30 */
 #define NV04_IDLE_CHANNELS                                         (0x0000001E)
 
@@ -2447,6 +2494,7 @@ typedef struct
     NvHandle hVASpace;                   // VA space handle for TSG
     NvU32    engineType;                 // Engine to which all channels in this TSG are associated with
     NvBool   bIsCallingContextVgpuPlugin;
+    NvU32    schedClass;                 // NVA06C_CTRL_SCHED_CLASS_* the TSG is created in
 } NV_CHANNEL_GROUP_ALLOCATION_PARAMETERS;
 
 /*
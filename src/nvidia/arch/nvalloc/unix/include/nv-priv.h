@@ -29,6 +29,7 @@
 #include <ctrl/ctrl402c.h>
 #include <gpu/disp/kern_disp_max.h>
 #include <gpu/disp/kern_disp_type.h>
+#include <diagnostics/profiler.h>
 
 #define NV_PRIV_REG_WR08(b,o,d)   (*((volatile NvV8*)&(b)->Reg008[(o)/1])=(NvV8)(d))
 #define NV_PRIV_REG_WR16(b,o,d)   (*((volatile NvV16*)&(b)->Reg016[(o)/2])=(NvV16)(d))
@@ -92,6 +93,7 @@ typedef enum
 typedef struct nv_reg_entry_s
 {
     char *regParmStr;
+    NvU32 hash;   // case-insensitive hash of regParmStr
     NvU32 type;
     NvU32 data;   // used when type == NV_REGISTRY_ENTRY_TYPE_DWORD
     NvU8 *pdata;  // used when type == NV_REGISTRY_ENTRY_TYPE_{BINARY,STRING}
@@ -319,6 +321,24 @@ typedef struct nv_dynamic_power_s
      * NVreg_DynamicPowerManagement regkey value set by the user
      */
     NvU32 dynamic_power_regkey;
+
+    /*
+     * Period of the deferred idle checks, see
+     * NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS.
+     */
+    NvU64 idle_check_period_ns;
+
+    /*
+     * GC6/GCOFF selection for dynamic PM. predicted_idle_ns is a moving
+     * average of how long the GPU stayed in GC6/GCOFF, and GCOFF is only used
+     * when it is at least gcoff_min_idle_ns. gcx_entry_ns is when the GPU
+     * last entered GC6/GCOFF. These are protected by the GPU lock.
+     */
+    NvU64 gcoff_min_idle_ns;
+    NvU64 predicted_idle_ns;
+    NvU64 gcx_entry_ns;
+
+    nv_dynamic_power_stats_t stats;
 } nv_dynamic_power_t;
 
 typedef struct
@@ -359,6 +379,9 @@ typedef struct
     NvU64 s0ix_gcoff_max_fb_size;
 
     NvU32 pmc_boot_42;
+
+    /* Timestamped steps of the last RmInitAdapter. */
+    RM_PROF_TRACE init_trace;
 } nv_priv_t;
 
 #define NV_SET_NV_PRIV(nv,p) ((nv)->priv = (p))
@@ -45,5 +45,22 @@ typedef struct
     int fd;
 } nv_ioctl_nvos33_parameters_with_fd;
 
+/*
+ * Parameters for NV_ESC_RM_GET_EVENT_DATA_BATCH, which dequeues up to
+ * maxEvents pending events with data into the NvUnixEvent array at pEvents
+ * in a single call. It fails with NV_ERR_OPERATING_SYSTEM, like
+ * NV04_GET_EVENT_DATA, if no event is pending.
+ */
+#define NV_GET_EVENT_DATA_BATCH_MAX_EVENTS  64
+
+typedef struct
+{
+    NvP64 pEvents NV_ALIGN_BYTES(8);    /* in: NvUnixEvent[maxEvents] */
+    NvU32 maxEvents;                    /* in */
+    NvU32 numEvents;                    /* out */
+    NvU32 MoreEvents;                   /* out */
+    NvU32 status;                       /* out */
+} nv_ioctl_get_event_data_batch_t;
+
 #endif // _NV_UNIX_NVOS_PARAMS_WRAPPERS_H_
 
@@ -537,6 +537,7 @@ typedef struct UvmGpuEccInfo_tag                    *nvgpuEccInfo_t;
 typedef struct UvmGpuFaultInfo_tag                  *nvgpuFaultInfo_t;
 typedef struct UvmGpuAccessCntrInfo_tag             *nvgpuAccessCntrInfo_t;
 typedef struct UvmGpuAccessCntrConfig_tag           *nvgpuAccessCntrConfig_t;
+typedef struct UvmGpuAccessBitsBufferAlloc_tag      *nvgpuAccessBitsBufferAlloc_t;
 typedef struct UvmGpuInfo_tag                       nvgpuInfo_t;
 typedef struct UvmGpuClientInfo_tag                 nvgpuClientInfo_t;
 typedef struct UvmPmaAllocationOptions_tag          *nvgpuPmaAllocationOptions_t;
@@ -596,6 +597,23 @@ typedef enum
     NV_DYNAMIC_PM_FINE
 } nv_dynamic_power_mode_t;
 
+/*
+ * Runtime D3 statistics. Exit times are split into the wait for the GPU locks
+ * and the GC6 exit or GCOFF resume itself, which includes restoring video
+ * memory. Times are in microseconds.
+ */
+typedef struct
+{
+    NvU32  gc6_entries;
+    NvU32  gcoff_entries;
+    NvU64  predicted_idle_us;
+    NvBool last_exit_gcoff;
+    NvU64  last_exit_lock_us;
+    NvU64  last_exit_resume_us;
+    NvU64  last_exit_total_us;
+    NvU64  max_exit_total_us;
+} nv_dynamic_power_stats_t;
+
 typedef enum
 {
     NV_POWER_STATE_IN_HIBERNATE,
@@ -802,6 +820,7 @@ NvS32  NV_API_CALL  nv_stop_rc_timer             (nv_state_t *);
 
 void   NV_API_CALL  nv_post_event                (nv_event_t *, NvHandle, NvU32, NvU32, NvU16, NvBool);
 NvS32  NV_API_CALL  nv_get_event                 (nv_file_private_t *, nv_event_t *, NvU32 *);
+NvU32  NV_API_CALL  nv_get_events                (nv_file_private_t *, nv_event_t *, NvU32, NvU32 *);
 
 void*  NV_API_CALL  nv_i2c_add_adapter           (nv_state_t *, NvU32);
 void   NV_API_CALL  nv_i2c_del_adapter           (nv_state_t *, void *);
@@ -1013,6 +1032,7 @@ NV_STATUS  NV_API_CALL rm_transition_dynamic_power(nvidia_stack_t *, nv_state_t
 const char* NV_API_CALL rm_get_vidmem_power_status(nvidia_stack_t *, nv_state_t *);
 const char* NV_API_CALL rm_get_dynamic_power_management_status(nvidia_stack_t *, nv_state_t *);
 const char* NV_API_CALL rm_get_gpu_gcx_support(nvidia_stack_t *, nv_state_t *, NvBool);
+void       NV_API_CALL rm_get_dynamic_power_stats(nvidia_stack_t *, nv_state_t *, nv_dynamic_power_stats_t *);
 
 void       NV_API_CALL rm_acpi_notify(nvidia_stack_t *, nv_state_t *, NvU32);
 void       NV_API_CALL rm_acpi_nvpcf_notify(nvidia_stack_t *);
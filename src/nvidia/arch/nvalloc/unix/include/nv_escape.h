@@ -51,5 +51,8 @@
 #define NV_ESC_RM_IMPORT_OBJECT_FROM_FD             0x5D
 #define NV_ESC_RM_UPDATE_DEVICE_MAPPING_INFO        0x5E
 #define NV_ESC_RM_NVLOG_CTRL                        0x5F
+#define NV_ESC_RM_GET_EVENT_DATA_BATCH              0x60
+#define NV_ESC_RM_ALLOC_BATCH                       0x61
+#define NV_ESC_RM_FREE_BATCH                        0x62
 
 #endif // NV_ESCAPE_H_INCLUDED
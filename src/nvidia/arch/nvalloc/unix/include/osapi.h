@@ -144,6 +144,7 @@ NV_STATUS  rm_get_adapter_status    (nv_state_t *, NvU32 *);
 NV_STATUS  rm_alloc_os_event        (NvHandle, nv_file_private_t *, NvU32);
 NV_STATUS  rm_free_os_event         (NvHandle, NvU32);
 NV_STATUS  rm_get_event_data        (nv_file_private_t *, NvP64, NvU32 *);
+NV_STATUS  rm_get_event_data_batch  (nv_file_private_t *, NvP64, NvU32, NvU32 *, NvU32 *);
 void       rm_client_free_os_events (NvHandle);
 
 NV_STATUS  rm_create_mmap_context   (NvHandle, NvHandle, NvHandle, NvP64, NvU64, NvU64, NvU32, NvU32);
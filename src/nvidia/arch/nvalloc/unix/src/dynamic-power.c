@@ -78,6 +78,8 @@
 #include <nv_ref.h>
 
 #include <osapi.h>
+#include <os/os.h>
+#include "nvrm_registry.h"
 
 #include <gpu/mem_mgr/mem_mgr.h>
 #include <gpu/kern_gpu_power.h>
@@ -93,13 +95,14 @@
 // Schedule timer based callback, to check for the complete GPU Idleness.
 // Windows has idle time from 70msec to 10sec, we opted for present duration
 // considering windows limit. Duration is not much aggressive or slow, hence
-// less thrashing.
+// less thrashing. This is the default, the period can be changed with
+// NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS.
 //
-#define GC6_PRECONDITION_CHECK_TIME    ((NvU64)5 * 1000 * 1000 * 1000)
+#define GC6_PRECONDITION_CHECK_TIME    ((NvU64)NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS_DEFAULT * 1000 * 1000)
 
 //
 // Timeout needed for back to back GC6 cycles.
-// Timeout is kept same as the timeout selected for GC6 precondition check.
+// Timeout is kept same as the period selected for GC6 precondition check.
 // There are cases where GPU is in GC6 and then kernel wakes GPU out of GC6
 // as part of say accessing pci tree through lspci and then again ask driver
 // to put GPU in GC6 state after access to device info is done.
@@ -109,15 +112,22 @@
 // P-state case returns error to kernel, resulting in corrupted sysfs entry
 // and then kernel never calls driver to put device in low power state.
 //
-#define GC6_CYCLE_IDLE_HOLDOFF_CHECK_TIME    GC6_PRECONDITION_CHECK_TIME
+#define GC6_CYCLE_IDLE_HOLDOFF_CHECK_TIME(nvp)   ((nvp)->dynamic_power.idle_check_period_ns)
 
 //
 // Once GPU is found to be idle, driver will schedule another callback of
 // smaller duration. Driver needs to be sure that methods that are present
 // in host pipeline are flushed to the respective engines and engines become
-// idle upon consumption.
+// idle upon consumption. It is shortened to the precondition check period
+// when that is smaller.
 //
-#define GC6_BAR1_BLOCKER_CHECK_AND_METHOD_FLUSH_TIME (200 * 1000 * 1000)
+#define GC6_BAR1_BLOCKER_CHECK_AND_METHOD_FLUSH_TIME ((NvU64)200 * 1000 * 1000)
+
+//
+// Weight, as a power of 2, of the history in the moving average of GC6/GCOFF
+// residencies used to predict the next idle period.
+//
+#define GCX_IDLE_PREDICTION_HISTORY_SHIFT    2
 
 //
 // Cap Maximum FB allocation size for GCOFF. If regkey value is greater
@@ -677,6 +687,56 @@ done:
     return pSupported;
 }
 
+/*!
+ * @brief: Function to get the runtime D3 statistics of the GPU.
+ *
+ * @param[in]   sp      nvidia_stack_t pointer.
+ * @param[in]   pNv     nv_state_t pointer.
+ * @param[out]  pStats  Statistics, zeroed if they couldn't be read.
+ */
+void NV_API_CALL rm_get_dynamic_power_stats(
+    nvidia_stack_t           *sp,
+    nv_state_t               *pNv,
+    nv_dynamic_power_stats_t *pStats
+)
+{
+    THREAD_STATE_NODE threadState;
+    void              *fp;
+    GPU_MASK          gpuMask;
+
+    NV_ENTER_RM_RUNTIME(sp,fp);
+    threadStateInit(&threadState, THREAD_STATE_FLAGS_NONE);
+
+    portMemSet(pStats, 0, sizeof(*pStats));
+
+    // LOCK: acquire API lock
+    if ((rmapiLockAcquire(API_LOCK_FLAGS_NONE, RM_LOCK_MODULES_DYN_POWER)) == NV_OK)
+    {
+        OBJGPU *pGpu = NV_GET_NV_PRIV_PGPU(pNv);
+
+        // LOCK: acquire per device lock
+        if ((pGpu != NULL) &&
+            ((rmGpuGroupLockAcquire(pGpu->gpuInstance, GPU_LOCK_GRP_SUBDEVICE,
+                                    GPUS_LOCK_FLAGS_NONE, RM_LOCK_MODULES_DYN_POWER,
+                                    &gpuMask)) == NV_OK))
+        {
+            nv_priv_t *nvp = NV_GET_NV_PRIV(pNv);
+
+            *pStats = nvp->dynamic_power.stats;
+            pStats->predicted_idle_us = nvp->dynamic_power.predicted_idle_ns / 1000;
+
+            // UNLOCK: release per device lock
+            rmGpuGroupLockRelease(gpuMask, GPUS_LOCK_FLAGS_NONE);
+        }
+
+        //UNLOCK: release API lock
+        rmapiLockRelease();
+    }
+
+    threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
+    NV_EXIT_RM_RUNTIME(sp,fp);
+}
+
 /*!
  * @brief Function to increment/decrement global Gcoff disallow refcount.
  *
@@ -841,6 +901,7 @@ void NV_API_CALL rm_init_dynamic_power_management(
     NvBool bUefiConsole;
     NvU32 status;
     NvU32 regkeyValue;
+    NvU32 data;
 
     NV_ENTER_RM_RUNTIME(sp,fp);
 
@@ -897,6 +958,32 @@ void NV_API_CALL rm_init_dynamic_power_management(
     nvp->dynamic_power.gcoff_max_fb_size =
             (NvU64)gcOffMaxFbSizeMb * 1024 * 1024;
 
+    if (osReadRegistryDword(NULL,
+                            NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS,
+                            &data) == NV_OK)
+    {
+        data = NV_MAX(data, NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS_MIN);
+        nvp->dynamic_power.idle_check_period_ns = (NvU64)data * 1000 * 1000;
+    }
+    else
+    {
+        nvp->dynamic_power.idle_check_period_ns = GC6_PRECONDITION_CHECK_TIME;
+    }
+
+    if (osReadRegistryDword(NULL,
+                            NV_REG_STR_RM_DYNAMIC_POWER_GCOFF_MIN_IDLE_MS,
+                            &data) != NV_OK)
+    {
+        data = NV_REG_STR_RM_DYNAMIC_POWER_GCOFF_MIN_IDLE_MS_DEFAULT;
+    }
+    nvp->dynamic_power.gcoff_min_idle_ns = (NvU64)data * 1000 * 1000;
+
+    //
+    // Without any history, predict an idle period long enough for GCOFF, as
+    // was always picked when the video memory usage allows.
+    //
+    nvp->dynamic_power.predicted_idle_ns = nvp->dynamic_power.gcoff_min_idle_ns;
+
     nvp->dynamic_power.mutex = portSyncMutexCreate(portMemAllocatorGetGlobalNonPaged());
     if (nvp->dynamic_power.mutex == NULL)
     {
@@ -1805,7 +1892,7 @@ static void RmScheduleCallbackForIdlePreConditionsUnderGpuLock(
         portMemSet(&scheduleEventParams, 0, sizeof(scheduleEventParams));
 
         scheduleEventParams.pEvent = nvp->dynamic_power.idle_precondition_check_event;
-        scheduleEventParams.timeNs = GC6_PRECONDITION_CHECK_TIME;
+        scheduleEventParams.timeNs = nvp->dynamic_power.idle_check_period_ns;
         scheduleEventParams.bUseTimeAbs = NV_FALSE;
 
         status = tmrCtrlCmdEventSchedule(pGpu, &scheduleEventParams);
@@ -1872,7 +1959,8 @@ static void RmScheduleCallbackToIndicateIdle(
         portMemSet(&scheduleEventParams, 0, sizeof(scheduleEventParams));
 
         scheduleEventParams.pEvent = nvp->dynamic_power.indicate_idle_event;
-        scheduleEventParams.timeNs = GC6_BAR1_BLOCKER_CHECK_AND_METHOD_FLUSH_TIME;
+        scheduleEventParams.timeNs = NV_MIN(GC6_BAR1_BLOCKER_CHECK_AND_METHOD_FLUSH_TIME,
+                                            nvp->dynamic_power.idle_check_period_ns);
         scheduleEventParams.bUseTimeAbs = NV_FALSE;
 
         status = tmrCtrlCmdEventSchedule(pGpu, &scheduleEventParams);
@@ -1905,7 +1993,7 @@ static void RmScheduleCallbackToRemoveIdleHoldoff(
         portMemSet(&scheduleEventParams, 0, sizeof(scheduleEventParams));
 
         scheduleEventParams.pEvent = nvp->dynamic_power.remove_idle_holdoff;
-        scheduleEventParams.timeNs = GC6_CYCLE_IDLE_HOLDOFF_CHECK_TIME;
+        scheduleEventParams.timeNs = GC6_CYCLE_IDLE_HOLDOFF_CHECK_TIME(nvp);
         scheduleEventParams.bUseTimeAbs = NV_FALSE;
 
         status = tmrCtrlCmdEventSchedule(pGpu, &scheduleEventParams);
@@ -2063,6 +2151,16 @@ static NvBool RmCheckForGcOffPM(
             return NV_FALSE;
 
         gcoff_max_fb_size = nvp->dynamic_power.gcoff_max_fb_size;
+
+        /*
+         * GCOFF has to restore video memory on exit, which GC6 does not.
+         * If the GPU is predicted to be woken up again soon, prefer GC6.
+         */
+        if (pGpu->getProperty(pGpu, PDB_PROP_GPU_RTD3_GC6_SUPPORTED) &&
+            (nvp->dynamic_power.predicted_idle_ns < nvp->dynamic_power.gcoff_min_idle_ns))
+        {
+            return NV_FALSE;
+        }
     }
     else
     {
@@ -2075,6 +2173,8 @@ static NvBool RmCheckForGcOffPM(
      *
      * 1. The GCOFF has not been disabled with regkey by setting it to zero.
      * 2. Used FB allocation size are within limits.
+     * 3. For dynamic PM, the predicted idle period is long enough, or GC6
+     *    is not supported.
      */
     return (gcoff_max_fb_size > 0) &&
            (usedFbSize <= gcoff_max_fb_size);
@@ -2461,15 +2561,59 @@ NV_STATUS NV_API_CALL rm_power_management(
  */
 static NV_STATUS RmTransitionDynamicPower(
     OBJGPU *pGpu,
-    NvBool  bEnter
+    NvBool  bEnter,
+    NvU64   startNs,
+    NvU64   lockWaitNs
 )
 {
     nv_state_t *nv   = NV_GET_NV_STATE(pGpu);
+    nv_priv_t  *nvp  = NV_GET_NV_PRIV(nv);
+    nv_dynamic_power_stats_t *pStats = &nvp->dynamic_power.stats;
+    NvBool      bGcoff = pGpu->getProperty(pGpu, PDB_PROP_GPU_GCOFF_STATE_ENTERED);
+    NvU64       resumeStartNs;
+    NvU64       now;
     NV_STATUS   status;
 
+    osGetPerformanceCounter(&resumeStartNs);
+
     status = RmGcxPowerManagement(pGpu, bEnter, NV_TRUE);
 
-    if (!bEnter && status == NV_OK)
+    osGetPerformanceCounter(&now);
+
+    if (bEnter)
+    {
+        if (status == NV_OK)
+        {
+            nvp->dynamic_power.gcx_entry_ns = now;
+
+            if (pGpu->getProperty(pGpu, PDB_PROP_GPU_GCOFF_STATE_ENTERED))
+                pStats->gcoff_entries++;
+            else
+                pStats->gc6_entries++;
+        }
+
+        return status;
+    }
+
+    if (nvp->dynamic_power.gcx_entry_ns != 0)
+    {
+        NvU64 idleNs = startNs - nvp->dynamic_power.gcx_entry_ns;
+
+        nvp->dynamic_power.predicted_idle_ns =
+            (((nvp->dynamic_power.predicted_idle_ns << GCX_IDLE_PREDICTION_HISTORY_SHIFT) -
+              nvp->dynamic_power.predicted_idle_ns) + idleNs) >> GCX_IDLE_PREDICTION_HISTORY_SHIFT;
+        nvp->dynamic_power.gcx_entry_ns = 0;
+    }
+
+    pStats->predicted_idle_us   = nvp->dynamic_power.predicted_idle_ns / 1000;
+    pStats->last_exit_gcoff     = bGcoff;
+    pStats->last_exit_lock_us   = lockWaitNs / 1000;
+    pStats->last_exit_resume_us = (now - resumeStartNs) / 1000;
+    pStats->last_exit_total_us  = (now - startNs) / 1000;
+    pStats->max_exit_total_us   = NV_MAX(pStats->max_exit_total_us,
+                                         pStats->last_exit_total_us);
+
+    if (status == NV_OK)
     {
         nv_idle_holdoff(nv);
         RmScheduleCallbackToRemoveIdleHoldoff(pGpu);
@@ -2500,16 +2644,22 @@ NV_STATUS NV_API_CALL rm_transition_dynamic_power(
     NV_STATUS           status = NV_OK;
     THREAD_STATE_NODE   threadState;
     void               *fp;
+    NvU64               startNs;
+    NvU64               lockedNs;
 
     NV_ENTER_RM_RUNTIME(sp,fp);
 
     threadStateInit(&threadState, THREAD_STATE_FLAGS_NONE);
 
+    osGetPerformanceCounter(&startNs);
+
     // LOCK: acquire GPUs lock
     status = rmGpuLocksAcquire(GPUS_LOCK_FLAGS_NONE, RM_LOCK_MODULES_DYN_POWER);
     if (status == NV_OK)
     {
-        status = RmTransitionDynamicPower(pGpu, bEnter);
+        osGetPerformanceCounter(&lockedNs);
+
+        status = RmTransitionDynamicPower(pGpu, bEnter, startNs, lockedNs - startNs);
 
         // UNLOCK: release GPUs lock
         rmGpuLocksRelease(GPUS_LOCK_FLAGS_NONE, NULL);
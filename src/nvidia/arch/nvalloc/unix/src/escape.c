@@ -448,6 +448,38 @@ NV_STATUS RmIoctl(
             break;
         }
 
+        case NV_ESC_RM_ALLOC_BATCH:
+        {
+            NVOS66_PARAMETERS *pApi = data;
+
+            NV_CTL_DEVICE_ONLY(nv);
+
+            if (dataSize != sizeof(NVOS66_PARAMETERS))
+            {
+                rmStatus = NV_ERR_INVALID_ARGUMENT;
+                goto done;
+            }
+
+            Nv04AllocBatchWithSecInfo(pApi, secInfo);
+            break;
+        }
+
+        case NV_ESC_RM_FREE_BATCH:
+        {
+            NVOS67_PARAMETERS *pApi = data;
+
+            NV_CTL_DEVICE_ONLY(nv);
+
+            if (dataSize != sizeof(NVOS67_PARAMETERS))
+            {
+                rmStatus = NV_ERR_INVALID_ARGUMENT;
+                goto done;
+            }
+
+            Nv01FreeBatchWithSecInfo(pApi, secInfo);
+            break;
+        }
+
         case NV_ESC_RM_VID_HEAP_CONTROL:
         {
             NVOS32_PARAMETERS *pApi = data;
@@ -727,6 +759,24 @@ NV_STATUS RmIoctl(
             break;
         }
 
+        case NV_ESC_RM_GET_EVENT_DATA_BATCH:
+        {
+            nv_ioctl_get_event_data_batch_t *pApi = data;
+
+            if (dataSize != sizeof(nv_ioctl_get_event_data_batch_t))
+            {
+                rmStatus = NV_ERR_INVALID_ARGUMENT;
+                goto done;
+            }
+
+            pApi->status = rm_get_event_data_batch(nvfp,
+                                                   pApi->pEvents,
+                                                   pApi->maxEvents,
+                                                   &pApi->numEvents,
+                                                   &pApi->MoreEvents);
+            break;
+        }
+
         case NV_ESC_STATUS_CODE:
         {
             nv_state_t *pNv;
@@ -28,6 +28,7 @@
 #include <nv-priv.h>
 #include <os/os.h>
 #include <osapi.h>
+#include <nv-unix-nvos-params-wrappers.h>
 #include <class/cl0000.h>
 #include <rmosxfac.h> // Declares RmInitRm().
 #include "gpu/gpu.h"
@@ -680,6 +681,69 @@ static NV_STATUS RmGetEventData(
     return NV_OK;
 }
 
+static NV_STATUS RmGetEventDataBatch(
+    nv_file_private_t *nvfp,
+    NvP64 pEvents,
+    NvU32 maxEvents,
+    NvU32 *pNumEvents,
+    NvU32 *MoreEvents,
+    NvBool bUserModeArgs
+)
+{
+    NV_STATUS         RmStatus;
+    NvUnixEvent      *pKernelEvents = NULL;
+    nv_event_t       *pEventData;
+    RMAPI_PARAM_COPY  paramCopy;
+    NvU32             numEvents;
+    NvU32             i;
+
+    *pNumEvents = 0;
+
+    if ((maxEvents == 0) || (maxEvents > NV_GET_EVENT_DATA_BATCH_MAX_EVENTS))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    pEventData = portMemAllocNonPaged(maxEvents * sizeof(nv_event_t));
+    if (pEventData == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    numEvents = nv_get_events(nvfp, pEventData, maxEvents, MoreEvents);
+    if (numEvents == 0)
+    {
+        RmStatus = NV_ERR_OPERATING_SYSTEM;
+        goto done;
+    }
+
+    // setup for access to client's parameters
+    RMAPI_PARAM_COPY_INIT(paramCopy, pKernelEvents, pEvents, numEvents, sizeof(NvUnixEvent));
+    RmStatus = rmapiParamsAcquire(&paramCopy, bUserModeArgs);
+    if (RmStatus != NV_OK)
+    {
+        RmStatus = NV_ERR_OPERATING_SYSTEM;
+        goto done;
+    }
+
+    for (i = 0; i < numEvents; i++)
+    {
+        pKernelEvents[i].hObject     = pEventData[i].hObject;
+        pKernelEvents[i].NotifyIndex = pEventData[i].index;
+        pKernelEvents[i].info32      = pEventData[i].info32;
+        pKernelEvents[i].info16      = pEventData[i].info16;
+    }
+
+    // release client buffer access, with copyout as needed
+    if (rmapiParamsRelease(&paramCopy) != NV_OK)
+    {
+        RmStatus = NV_ERR_OPERATING_SYSTEM;
+        goto done;
+    }
+
+    *pNumEvents = numEvents;
+
+done:
+    portMemFree(pEventData);
+    return RmStatus;
+}
+
 static NV_STATUS RmAccessRegistry(
     NvHandle   hClient,
     NvHandle   hObject,
@@ -2749,6 +2813,29 @@ NV_STATUS rm_get_event_data(
     return RmStatus;
 }
 
+NV_STATUS rm_get_event_data_batch(
+    nv_file_private_t  *nvfp,
+    NvP64               pEvents,
+    NvU32               maxEvents,
+    NvU32              *pNumEvents,
+    NvU32              *MoreEvents
+)
+{
+    NV_STATUS RmStatus;
+
+    // LOCK: acquire API lock
+    if ((RmStatus = rmapiLockAcquire(RMAPI_LOCK_FLAGS_READ, RM_LOCK_MODULES_EVENT)) == NV_OK)
+    {
+        RmStatus = RmGetEventDataBatch(nvfp, pEvents, maxEvents, pNumEvents,
+                                       MoreEvents, NV_TRUE);
+
+        // UNLOCK: release API lock
+        rmapiLockRelease();
+    }
+
+    return RmStatus;
+}
+
 NV_STATUS NV_API_CALL rm_read_registry_dword(
     nvidia_stack_t *sp,
     nv_state_t *nv,
@@ -899,6 +899,7 @@ RmInitNvDevice(
         RM_SET_ERROR(*status, RM_INIT_GPU_PRE_INIT_FAILED);
         return;
     }
+    rmProfTraceStep(pGpu->pBootTrace, "state pre-init");
 
     os_disable_console_access();
 
@@ -911,6 +912,7 @@ RmInitNvDevice(
         return;
     }
     nvp->flags |= NV_INIT_FLAG_GPU_STATE;
+    rmProfTraceStep(pGpu->pBootTrace, "state init");
 
     KernelBif *pKernelBif = GPU_GET_KERNEL_BIF(pGpu);
     //
@@ -941,6 +943,7 @@ RmInitNvDevice(
         return;
     }
     nvp->flags |= NV_INIT_FLAG_GPU_STATE_LOAD;
+    rmProfTraceStep(pGpu->pBootTrace, "state load");
 
     os_enable_console_access();
 
@@ -954,6 +957,7 @@ RmInitNvDevice(
 
     // Setup GPU scalability
     (void) RmInitScalability(pGpu);
+    rmProfTraceStep(pGpu->pBootTrace, "validation");
 
     return;
 }
@@ -1540,7 +1544,7 @@ NvBool RmInitAdapter(
 {
     NvU32           devicereference = 0;
     UNIX_STATUS     status = INIT_UNIX_STATUS;
-    nv_priv_t      *nvp;
+    nv_priv_t      *nvp = NULL;
     NvBool          retVal = NV_FALSE;
     OBJSYS         *pSys;
     OBJGPU         *pGpu = NULL;
@@ -1548,12 +1552,15 @@ NvBool RmInitAdapter(
     KernelDisplay  *pKernelDisplay;
     const void     *gspFwHandle = NULL;
     const void     *gspFwLogHandle = NULL;
+    NvU64           initStartNs;
 
     GSP_FIRMWARE    gspFw = {0};
     PORT_UNREFERENCED_VARIABLE(gspFw);
 
     NV_DEV_PRINTF(NV_DBG_SETUP, nv, "RmInitAdapter\n");
 
+    osGetPerformanceCounter(&initStartNs);
+
     nv->flags &= ~NV_FLAG_PASSTHRU;
 
     RmSetupRegisters(nv, &status);
@@ -1563,6 +1570,9 @@ NvBool RmInitAdapter(
     nvp = NV_GET_NV_PRIV(nv);
     nvp->status = NV_ERR_OPERATING_SYSTEM;
 
+    rmProfTraceStart(&nvp->init_trace, initStartNs);
+    rmProfTraceStep(&nvp->init_trace, "setup registers");
+
     status.rmStatus = RmInitDeviceDma(nv);
     if (status.rmStatus != NV_OK)
     {
@@ -1572,6 +1582,7 @@ NvBool RmInitAdapter(
     }
 
     nvp->flags |= NV_INIT_FLAG_DMA;
+    rmProfTraceStep(&nvp->init_trace, "device DMA");
 
     pSys = SYS_GET_INSTANCE();
 
@@ -1605,6 +1616,7 @@ NvBool RmInitAdapter(
             RM_SET_ERROR(status, RM_INIT_FIRMWARE_FETCH_FAILED);
             goto shutdown;
         }
+        rmProfTraceStep(&nvp->init_trace, "firmware fetch");
     }
 
     // initialize the RM device register mapping
@@ -1629,6 +1641,9 @@ NvBool RmInitAdapter(
 
     pOS    = SYS_GET_OS(pSys);
 
+    pGpu->pBootTrace = &nvp->init_trace;
+    rmProfTraceStep(pGpu->pBootTrace, "device mapping");
+
     status.rmStatus = osInitScalability(pGpu);
     if (status.rmStatus == NV_OK)
     {
@@ -1650,11 +1665,13 @@ NvBool RmInitAdapter(
             RM_SET_ERROR(status, RM_INIT_FIRMWARE_INIT_FAILED);
             goto shutdown;
         }
+        rmProfTraceStep(pGpu->pBootTrace, "FSP boot");
     }
 
     RmSetConsolePreservationParams(pGpu);
 
     RmInitAcpiMethods(pOS, pSys, pGpu);
+    rmProfTraceStep(pGpu->pBootTrace, "ACPI methods");
 
     //
     // If GSP fw RM support is enabled then start the GSP microcode
@@ -1671,6 +1688,7 @@ NvBool RmInitAdapter(
             RM_SET_ERROR(status, RM_INIT_FIRMWARE_INIT_FAILED);
             goto shutdown;
         }
+        rmProfTraceStep(pGpu->pBootTrace, "GSP init");
     }
     else if (nv->request_fw_client_rm)
     {
@@ -1713,6 +1731,7 @@ NvBool RmInitAdapter(
     {
         confComputeEarlyInit(pGpu, GPU_GET_CONF_COMPUTE(pGpu));
     }
+    rmProfTraceStep(pGpu->pBootTrace, "device attributes");
 
     // finally, initialize the device
     RmInitNvDevice(devicereference, &status);
@@ -1756,6 +1775,7 @@ NvBool RmInitAdapter(
         NV_PRINTF(LEVEL_ERROR, "RmVerifySystemEnvironment failed, bailing!\n");
         goto shutdown;
     }
+    rmProfTraceStep(pGpu->pBootTrace, "system environment");
 
     Intr *pIntr = GPU_GET_INTR(pGpu);
     if (pIntr != NULL)
@@ -1798,6 +1818,7 @@ NvBool RmInitAdapter(
     // UNLOCK: release GPUs lock
     rmGpuLocksRelease(GPUS_LOCK_FLAGS_NONE, NULL);
     nv_start_rc_timer(nv);
+    rmProfTraceStep(pGpu->pBootTrace, "watchdog");
 
     nvp->status = NV_OK;
 
@@ -1813,6 +1834,7 @@ NvBool RmInitAdapter(
         RM_SET_ERROR(status, RM_INIT_GPUINFO_WITH_RMAPI_FAILED);
         goto shutdown;
     }
+    rmProfTraceStep(pGpu->pBootTrace, "RM API clients");
 
     status.rmStatus = RmInitX86Emu(pGpu);
     if (status.rmStatus != NV_OK)
@@ -1918,6 +1940,8 @@ NvBool RmInitAdapter(
         }
     }
 
+    rmProfTraceStep(pGpu->pBootTrace, "finalize");
+
     NV_DEV_PRINTF(NV_DBG_SETUP, nv, "RmInitAdapter succeeded!\n");
 
     retVal = NV_TRUE;
@@ -1937,6 +1961,20 @@ done:
     nv_put_firmware(gspFwHandle);
     nv_put_firmware(gspFwLogHandle);
 
+    //
+    // The trace stays in nv_priv_t after init, only the GPU stops adding
+    // to it.
+    //
+    if (pGpu != NULL)
+    {
+        pGpu->pBootTrace = NULL;
+    }
+
+    if (nvp != NULL)
+    {
+        rmProfTracePrint(&nvp->init_trace, "RmInitAdapter");
+    }
+
     return retVal;
 }
 
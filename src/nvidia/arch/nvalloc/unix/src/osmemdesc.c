@@ -54,6 +54,117 @@ static void osDestroyOsDescriptorFromSgt(PMEMORY_DESCRIPTOR);
 
 static NV_STATUS osCheckGpuBarsOverlapAddrRange(NvRangeU64 addrRange);
 
+//
+// Cache of the memory descriptors created from user page arrays.
+//
+// Frameworks register the same host buffers over and over, and each
+// registration used to build a new memory descriptor, register the pages
+// with the OS layer and map them through the IOMMU. A registration whose
+// freshly pinned pages are identical to those of a live descriptor created
+// for the same GPU, process and flags shares that descriptor instead, taking
+// a reference on it. Comparing the pinned pages rather than the virtual
+// range keeps stale entries from ever matching once the range has been
+// unmapped or remapped, and an entry goes away with the last reference to
+// its descriptor. All accesses are made under the API lock.
+//
+#define OS_DESC_IMPORT_CACHE_SIZE   256
+
+typedef struct
+{
+    MEMORY_DESCRIPTOR         *pMemDesc;
+    NvU64                     *pPageArray;  // Pinned pages owned by pMemDesc
+    NvU64                      osPageCount;
+    NvU64                      limit;
+    NvU32                      flags;
+    NvU32                      processId;
+    MEM_DESC_DESTROY_CALLBACK  destroyCallback;
+} OS_DESC_IMPORT;
+
+static OS_DESC_IMPORT osDescImportCache[OS_DESC_IMPORT_CACHE_SIZE];
+
+static void
+_osDescImportDestroyCallback
+(
+    OBJGPU            *pGpu,
+    void              *pObject,
+    MEMORY_DESCRIPTOR *pMemDesc
+)
+{
+    OS_DESC_IMPORT *pImport = pObject;
+
+    portMemSet(pImport, 0, sizeof(*pImport));
+}
+
+static OS_DESC_IMPORT *
+_osDescImportFind
+(
+    OBJGPU *pGpu,
+    NvU64  *pPageArray,
+    NvU64   osPageCount,
+    NvU64   limit,
+    NvU32   flags
+)
+{
+    NvU32 processId = osGetCurrentProcess();
+    NvU32 i;
+
+    for (i = 0; i < OS_DESC_IMPORT_CACHE_SIZE; i++)
+    {
+        OS_DESC_IMPORT *pImport = &osDescImportCache[i];
+
+        if ((pImport->pMemDesc == NULL) ||
+            (pImport->pMemDesc->pGpu != pGpu) ||
+            (pImport->osPageCount != osPageCount) ||
+            (pImport->limit != limit) ||
+            (pImport->flags != flags) ||
+            (pImport->processId != processId) ||
+            (pImport->pPageArray[0] != pPageArray[0]))
+        {
+            continue;
+        }
+
+        if (portMemCmp(pImport->pPageArray, pPageArray,
+                       osPageCount * sizeof(NvU64)) == 0)
+        {
+            return pImport;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+_osDescImportAdd
+(
+    MEMORY_DESCRIPTOR *pMemDesc,
+    NvU64             *pPageArray,
+    NvU64              osPageCount,
+    NvU64              limit,
+    NvU32              flags
+)
+{
+    NvU32 i;
+
+    for (i = 0; i < OS_DESC_IMPORT_CACHE_SIZE; i++)
+    {
+        OS_DESC_IMPORT *pImport = &osDescImportCache[i];
+
+        if (pImport->pMemDesc != NULL)
+            continue;
+
+        pImport->pMemDesc    = pMemDesc;
+        pImport->pPageArray  = pPageArray;
+        pImport->osPageCount = osPageCount;
+        pImport->limit       = limit;
+        pImport->flags       = flags;
+        pImport->processId   = osGetCurrentProcess();
+        pImport->destroyCallback.destroyCallback = &_osDescImportDestroyCallback;
+        pImport->destroyCallback.pObject = pImport;
+        memdescAddDestroyCallback(pMemDesc, &pImport->destroyCallback);
+        return;
+    }
+}
+
 NV_STATUS
 osCreateMemFromOsDescriptor
 (
@@ -279,6 +390,9 @@ osCreateOsDescriptorFromPageArray
 )
 {
     NV_STATUS rmStatus;
+    NvU64 *pPageArray = NvP64_VALUE(pDescriptor);
+    NvU64 osPageCount;
+    OS_DESC_IMPORT *pImport;
 
     *ppPrivate = NvP64_VALUE(pDescriptor);
 
@@ -304,6 +418,21 @@ osCreateOsDescriptorFromPageArray
         return NV_ERR_INVALID_FLAGS;
     }
 
+    osPageCount = 1 + (*pLimit / os_page_size);
+
+    if (!IS_VIRTUAL(pGpu))
+    {
+        pImport = _osDescImportFind(pGpu, pPageArray, osPageCount, *pLimit, flags);
+        if (pImport != NULL)
+        {
+            // The caller's pin is released by osCompleteMemFromOsDescriptor()
+            memdescAddRef(pImport->pMemDesc);
+            *ppMemDesc = pImport->pMemDesc;
+            *ppPrivate = memdescGetMemData(pImport->pMemDesc);
+            return NV_OK;
+        }
+    }
+
     rmStatus = osCreateMemdescFromPages(pGpu, (*pLimit + 1), flags,
                                         NV_MEMORY_CACHED, ppMemDesc,
                                         NULL /* pImportPriv */, ppPrivate);
@@ -316,9 +445,48 @@ osCreateOsDescriptorFromPageArray
     memdescSetMemData(*ppMemDesc, memdescGetMemData(*ppMemDesc),
                       osDestroyOsDescriptorPageArray);
 
+    if (!IS_VIRTUAL(pGpu))
+        _osDescImportAdd(*ppMemDesc, pPageArray, osPageCount, *pLimit, flags);
+
     return NV_OK;
 }
 
+/*!
+ * @brief Completes a successful osCreateMemFromOsDescriptor() of an object.
+ *
+ * If a page array descriptor was satisfied by sharing the memory descriptor
+ * of an identical earlier import, the pages pinned for it by the caller are
+ * not owned by anything, so they are released here.
+ */
+void
+osCompleteMemFromOsDescriptor
+(
+    MEMORY_DESCRIPTOR *pMemDesc,
+    NvP64              pDescriptor,
+    NvU32              descriptorType
+)
+{
+    NvU32 i;
+
+    if (descriptorType != NVOS32_DESCRIPTOR_TYPE_OS_PAGE_ARRAY)
+        return;
+
+    for (i = 0; i < OS_DESC_IMPORT_CACHE_SIZE; i++)
+    {
+        OS_DESC_IMPORT *pImport = &osDescImportCache[i];
+
+        if (pImport->pMemDesc != pMemDesc)
+            continue;
+
+        if (pImport->pPageArray != NvP64_VALUE(pDescriptor))
+        {
+            NV_ASSERT_OK(os_unlock_user_pages(pImport->osPageCount,
+                                              NvP64_VALUE(pDescriptor)));
+        }
+        return;
+    }
+}
+
 /*!
  * @brief Checks if the given address range overlaps with the BARs for any of
  * the GPUs.
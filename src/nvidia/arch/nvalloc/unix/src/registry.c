@@ -53,6 +53,27 @@ static NvS32 stringCaseCompare(
     return (c1 - c2);
 }
 
+//
+// FNV-1a over the lowercased string. Lets lookups reject non-matching keys
+// with one integer compare instead of a string compare.
+//
+static NvU32 stringCaseHash(
+    const char *string
+)
+{
+    NvU32 hash = 0x811c9dc5;
+    NvU8 c;
+
+    while ((c = *string++) != '\0')
+    {
+        if (c >= 'A' && c <= 'Z')
+            c += ('a' - 'A');
+        hash = (hash ^ c) * 0x01000193;
+    }
+
+    return hash;
+}
+
 static nv_reg_entry_t *the_registry = NULL;
 
 static nv_reg_entry_t* regCreateNewRegistryKey(
@@ -103,6 +124,7 @@ static nv_reg_entry_t* regCreateNewRegistryKey(
     }
 
     new_reg->regParmStr = new_ParmStr;
+    new_reg->hash       = stringCaseHash(new_ParmStr);
     new_reg->type       = NV_REGISTRY_ENTRY_TYPE_UNKNOWN;
 
     if (nvp != NULL)
@@ -144,6 +166,7 @@ static nv_reg_entry_t* regFindRegistryEntry(
 {
     nv_priv_t *nvp = NV_GET_NV_PRIV(nv);
     nv_reg_entry_t *tmp;
+    NvU32 hash = stringCaseHash(regParmStr);
 
     DBG_REG_PRINTF("%s: %s\n", __FUNCTION__, regParmStr);
 
@@ -156,8 +179,8 @@ static nv_reg_entry_t* regFindRegistryEntry(
         {
             DBG_REG_PRINTF("  Testing against %s\n",
                     tmp->regParmStr);
-            if ((stringCaseCompare(tmp->regParmStr, regParmStr) == 0) &&
-                (type == tmp->type))
+            if ((hash == tmp->hash) && (type == tmp->type) &&
+                (stringCaseCompare(tmp->regParmStr, regParmStr) == 0))
             {
                 DBG_REG_PRINTF("    found a match!\n");
                 if (bGlobalEntry)
@@ -175,8 +198,8 @@ static nv_reg_entry_t* regFindRegistryEntry(
     {
         DBG_REG_PRINTF("  Testing against %s\n",
                 tmp->regParmStr);
-        if ((stringCaseCompare(tmp->regParmStr, regParmStr) == 0) &&
-            (type == tmp->type))
+        if ((hash == tmp->hash) && (type == tmp->type) &&
+            (stringCaseCompare(tmp->regParmStr, regParmStr) == 0))
         {
             DBG_REG_PRINTF("    found a match!\n");
             if (bGlobalEntry)
@@ -654,6 +654,44 @@ NV_STATUS  NV_API_CALL  rm_gpu_ops_disable_access_cntr(nvidia_stack_t *sp,
     return rmStatus;
 }
 
+NV_STATUS  NV_API_CALL  rm_gpu_ops_access_bits_buf_alloc(nvidia_stack_t *sp,
+                                                         gpuDeviceHandle device,
+                                                         NvU64 fbSize,
+                                                         gpuAccessBitsBufferAlloc *accessBitsInfo)
+{
+    NV_STATUS rmStatus;
+    void *fp;
+    NV_ENTER_RM_RUNTIME(sp,fp);
+    rmStatus = nvGpuOpsAccessBitsBufAlloc(device, fbSize, accessBitsInfo);
+    NV_EXIT_RM_RUNTIME(sp,fp);
+    return rmStatus;
+}
+
+NV_STATUS  NV_API_CALL  rm_gpu_ops_access_bits_buf_free(nvidia_stack_t *sp,
+                                                        gpuDeviceHandle device,
+                                                        gpuAccessBitsBufferAlloc *accessBitsInfo)
+{
+    NV_STATUS rmStatus;
+    void *fp;
+    NV_ENTER_RM_RUNTIME(sp,fp);
+    rmStatus = nvGpuOpsAccessBitsBufFree(device, accessBitsInfo);
+    NV_EXIT_RM_RUNTIME(sp,fp);
+    return rmStatus;
+}
+
+NV_STATUS  NV_API_CALL  rm_gpu_ops_access_bits_dump(nvidia_stack_t *sp,
+                                                    gpuDeviceHandle device,
+                                                    gpuAccessBitsBufferAlloc *accessBitsInfo,
+                                                    NvU64 *accessBits)
+{
+    NV_STATUS rmStatus;
+    void *fp;
+    NV_ENTER_RM_RUNTIME(sp,fp);
+    rmStatus = nvGpuOpsAccessBitsDump(device, accessBitsInfo, accessBits);
+    NV_EXIT_RM_RUNTIME(sp,fp);
+    return rmStatus;
+}
+
 NV_STATUS NV_API_CALL
 rm_gpu_ops_p2p_object_create(nvidia_stack_t *sp,
                              gpuDeviceHandle device1,
@@ -766,6 +804,24 @@ rm_gpu_ops_get_channel_resource_ptes(nvidia_stack_t* sp,
     return rmStatus;
 }
 
+NV_STATUS  NV_API_CALL
+rm_gpu_ops_get_channel_resources_ptes(nvidia_stack_t* sp,
+                                      nvgpuAddressSpaceHandle_t vaSpace,
+                                      NvU32 resourceCount,
+                                      const NvP64 *resourceDescriptors,
+                                      const NvU64 *sizes,
+                                      nvgpuExternalMappingInfo_t gpuExternalMappingInfos)
+{
+    NV_STATUS rmStatus;
+    void *fp;
+    NV_ENTER_RM_RUNTIME(sp, fp);
+    rmStatus = nvGpuOpsGetChannelResourcesPtes(vaSpace, resourceCount,
+                                               resourceDescriptors, sizes,
+                                               gpuExternalMappingInfos);
+    NV_EXIT_RM_RUNTIME(sp, fp);
+    return rmStatus;
+}
+
 NV_STATUS NV_API_CALL
 rm_gpu_ops_report_non_replayable_fault(nvidia_stack_t *sp,
                                        nvgpuDeviceHandle_t device,
@@ -449,6 +449,7 @@ static void RmIsrBottomHalf(
             {
                 MC_ENGINE_BITVECTOR intrPending;
                 intrServiceNonStall_HAL(pGpu, pIntr, &intrPending, &threadState);
+                intrModerateNonStall(pGpu, pIntr);
             }
         }
 
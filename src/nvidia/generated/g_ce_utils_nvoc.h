@@ -151,6 +151,17 @@ static inline NvU64 ceutilsUpdateProgress(struct CeUtils *pCeUtils) {
 #define ceutilsUpdateProgress(pCeUtils) ceutilsUpdateProgress_IMPL(pCeUtils)
 #endif //__nvoc_ce_utils_h_disabled
 
+NV_STATUS ceutilsWaitForWorkId_IMPL(struct CeUtils *pCeUtils, NvU64 workId);
+
+#ifdef __nvoc_ce_utils_h_disabled
+static inline NV_STATUS ceutilsWaitForWorkId(struct CeUtils *pCeUtils, NvU64 workId) {
+    NV_ASSERT_FAILED_PRECOMP("CeUtils was disabled!");
+    return NV_ERR_NOT_SUPPORTED;
+}
+#else //__nvoc_ce_utils_h_disabled
+#define ceutilsWaitForWorkId(pCeUtils, workId) ceutilsWaitForWorkId_IMPL(pCeUtils, workId)
+#endif //__nvoc_ce_utils_h_disabled
+
 void ceutilsServiceInterrupts_IMPL(struct CeUtils *pCeUtils);
 
 #ifdef __nvoc_ce_utils_h_disabled
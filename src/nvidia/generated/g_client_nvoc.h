@@ -147,6 +147,9 @@ struct RmClient {
     struct UserInfo *pUserInfo;
     NvBool bIsClientVirtualMode;
     PNODE pCliSyncGpuBoostTree;
+    NvBool bBulkFree;
+    NvU32 bulkFreeGpuMask;
+    struct MEM_DEFERRED_FREE *pDeferredFreeList;
 };
 
 #ifndef __NVOC_CLASS_RmClient_TYPEDEF__
@@ -297,6 +300,16 @@ static inline NvBool rmclientIsCapable(struct RmClient *pClient, NvU32 capabilit
 
 #undef PRIVATE_FIELD
 
+//
+// True once GSP-RM has already torn down this client's objects on the given
+// GPU as part of a bulk client free, so per-object RPCs can be skipped.
+//
+static inline NvBool
+rmclientIsBulkFreedOnGpu(RmClient *pClient, NvU32 gpuInstance)
+{
+    return (pClient != NULL) && ((pClient->bulkFreeGpuMask & NVBIT(gpuInstance)) != 0);
+}
+
 
 MAKE_LIST(RmClientList, RmClient*);
 extern RmClientList g_clientListBehindGpusLock;
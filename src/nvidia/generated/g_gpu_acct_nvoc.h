@@ -84,17 +84,23 @@ typedef struct
     // Following members are only used on Grid host.
     NvU32  isGuestProcess; // Set if the entry corresponds to a guest VM process.
 
-    MapNode  mapNode;   // Node in the Map.
-    ListNode listNode;  // Node in the list.
+    NvU64  addSeq;      // Order in which the entry was added to its data
+                        // store, 0 if the slot is free.
+    NvU64  changeSeq;   // Value of the GPU's change counter when the entry
+                        // last changed.
 } GPUACCT_PROC_ENTRY;
 
-MAKE_INTRUSIVE_MAP (GPU_ACCT_PROC_MAP,  GPUACCT_PROC_ENTRY, mapNode);
-MAKE_INTRUSIVE_LIST(GPU_ACCT_PROC_LIST, GPUACCT_PROC_ENTRY, listNode);
-
+//
+// Open addressed table of process entries, keyed by pid. The table grows by
+// doubling and entries are stored by value, so pointers to entries are only
+// valid until the next add or remove on the same data store.
+//
 typedef struct
 {
-    GPU_ACCT_PROC_MAP  procMap;
-    GPU_ACCT_PROC_LIST procList;
+    GPUACCT_PROC_ENTRY *pEntries;   // Table of entries, NULL until first add.
+    NvU32  tableSize;               // Number of slots, a power of 2.
+    NvU32  count;                   // Number of slots in use.
+    NvU64  nextAddSeq;              // addSeq of the next entry added.
 } GPU_ACCT_PROC_DATA_STORE;
 
 typedef struct
@@ -113,6 +119,7 @@ typedef struct
     TMR_EVENT        *pTmrEvent;                // Pointer to the timer event created to schedule main callback
     NvU64             lastUpdateTimestamp;      // Time stamp of last PMU sample set.
     NvU32             totalSampleCount;         // Total samples of GPU of since accounting started for this GPU.
+    NvU64             changeSeq;                // Bumped whenever a process entry of this GPU changes.
 
     // Pre-allocated buffer for making ctrl calls in callbacks
     NV2080_CTRL_PERF_GET_GPUMON_PERFMON_UTIL_SAMPLES_V2_PARAMS *pSamplesParams;
@@ -281,6 +288,17 @@ static inline NV_STATUS gpuacctSetProcType(struct GpuAccounting *arg0, NvU32 arg
 #define gpuacctSetProcType(arg0, arg1, arg2, arg3, arg4) gpuacctSetProcType_IMPL(arg0, arg1, arg2, arg3, arg4)
 #endif //__nvoc_gpu_acct_h_disabled
 
+NV_STATUS gpuacctGetChangedProcs_IMPL(struct GpuAccounting *arg0, NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS *arg1);
+
+#ifdef __nvoc_gpu_acct_h_disabled
+static inline NV_STATUS gpuacctGetChangedProcs(struct GpuAccounting *arg0, NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS *arg1) {
+    NV_ASSERT_FAILED_PRECOMP("GpuAccounting was disabled!");
+    return NV_ERR_NOT_SUPPORTED;
+}
+#else //__nvoc_gpu_acct_h_disabled
+#define gpuacctGetChangedProcs(arg0, arg1) gpuacctGetChangedProcs_IMPL(arg0, arg1)
+#endif //__nvoc_gpu_acct_h_disabled
+
 #undef PRIVATE_FIELD
 
 
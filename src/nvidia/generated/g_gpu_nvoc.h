@@ -1194,6 +1194,7 @@ struct OBJGPU {
     NvBool bIsGspOwnedFaultBuffersEnabled;
     NvBool bEnableBar1SparseForFillPteMemUnmap;
     _GPU_GC6_STATE gc6State;
+    struct RM_PROF_TRACE *pBootTrace;
 };
 
 #ifndef __NVOC_CLASS_OBJGPU_TYPEDEF__
@@ -201,8 +201,18 @@ struct MMU_WALK_USER_CTX
     const GVAS_BLOCK  *pBlock;
     const NvU32       *pChID;
     NvU32             gfid;
+
+    //
+    // Set by the caller before acquire to batch CPU writes to page tables.
+    // Walker callbacks then skip the per-write BAR2 flush and a single flush
+    // is issued on release if anything was written.
+    //
+    NvBool            bDeferFlush;
+    NvBool            bFlushPending;
 };
 
+NvU32 gvaspaceWalkUserCtxTransferFlags(struct MMU_WALK_USER_CTX *pUserCtx, NvU32 flags);
+
 
 /*!
  * RM-registered/managed GPU virtual address space.
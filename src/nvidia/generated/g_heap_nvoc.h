@@ -311,6 +311,7 @@ struct Heap {
     NvU64 peakExternalUsage;
     NvU64 currInternalUsage;
     NvU64 currExternalUsage;
+    struct CTX_BUF_POOL_CACHE *pCtxBufPoolCache;
 };
 
 #ifndef __NVOC_CLASS_Heap_TYPEDEF__
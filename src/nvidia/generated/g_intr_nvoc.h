@@ -262,6 +262,10 @@ struct Intr {
     NvU32 intrEn0Orig;
     NvBool halIntrEnabled;
     NvU32 saveIntrEn0;
+    NvU64 nonStallHoldoffNs;
+    NvU64 nonStallLastServiceNs;
+    NvBool bNonStallHeldOff;
+    struct TMR_EVENT *pNonStallHoldoffEvent;
 };
 
 #ifndef __NVOC_CLASS_Intr_TYPEDEF__
@@ -1641,6 +1645,16 @@ static inline NV_STATUS intrServiceNonStallBottomHalf(OBJGPU *pGpu, struct Intr
 #define intrServiceNonStallBottomHalf(pGpu, pIntr, arg0, arg1) intrServiceNonStallBottomHalf_IMPL(pGpu, pIntr, arg0, arg1)
 #endif //__nvoc_intr_h_disabled
 
+void intrModerateNonStall_IMPL(OBJGPU *pGpu, struct Intr *pIntr);
+
+#ifdef __nvoc_intr_h_disabled
+static inline void intrModerateNonStall(OBJGPU *pGpu, struct Intr *pIntr) {
+    NV_ASSERT_FAILED_PRECOMP("Intr was disabled!");
+}
+#else //__nvoc_intr_h_disabled
+#define intrModerateNonStall(pGpu, pIntr) intrModerateNonStall_IMPL(pGpu, pIntr)
+#endif //__nvoc_intr_h_disabled
+
 NV_STATUS intrServiceNotificationRecords_IMPL(OBJGPU *pGpu, struct Intr *pIntr, NvU16 mcEngineIdx, struct THREAD_STATE_NODE *arg0);
 
 #ifdef __nvoc_intr_h_disabled
@@ -410,6 +410,36 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_KernelCh
 #endif
     },
     {               /*  [14] */
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x110u)
+        /*pFunc=*/      (void (*)(void)) NULL,
+#else
+        /*pFunc=*/      (void (*)(void)) kchangrpapiCtrlCmdSetSchedClass_IMPL,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x110u)
+        /*flags=*/      0x110u,
+        /*accessRight=*/0x2u,
+        /*methodId=*/   0xa06c0111u,
+        /*paramSize=*/  sizeof(NVA06C_CTRL_SCHED_CLASS_PARAMS),
+        /*pClassInfo=*/ &(__nvoc_class_def_KernelChannelGroupApi.classInfo),
+#if NV_PRINTF_STRINGS_ALLOWED
+        /*func=*/       "kchangrpapiCtrlCmdSetSchedClass"
+#endif
+    },
+    {               /*  [15] */
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x10u)
+        /*pFunc=*/      (void (*)(void)) NULL,
+#else
+        /*pFunc=*/      (void (*)(void)) kchangrpapiCtrlCmdGetSchedClass_IMPL,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x10u)
+        /*flags=*/      0x10u,
+        /*accessRight=*/0x0u,
+        /*methodId=*/   0xa06c0112u,
+        /*paramSize=*/  sizeof(NVA06C_CTRL_SCHED_CLASS_PARAMS),
+        /*pClassInfo=*/ &(__nvoc_class_def_KernelChannelGroupApi.classInfo),
+#if NV_PRINTF_STRINGS_ALLOWED
+        /*func=*/       "kchangrpapiCtrlCmdGetSchedClass"
+#endif
+    },
+    {               /*  [16] */
 #if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x2610u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
@@ -424,7 +454,7 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_KernelCh
         /*func=*/       "kchangrpapiCtrlCmdInternalGpFifoSchedule"
 #endif
     },
-    {               /*  [15] */
+    {               /*  [17] */
 #if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x2610u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
@@ -444,7 +474,7 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_KernelCh
 
 const struct NVOC_EXPORT_INFO __nvoc_export_info_KernelChannelGroupApi = 
 {
-    /*numEntries=*/     16,
+    /*numEntries=*/     18,
     /*pExportEntries=*/ __nvoc_exported_method_def_KernelChannelGroupApi
 };
 
@@ -527,6 +557,14 @@ static void __nvoc_init_funcTable_KernelChannelGroupApi_1(KernelChannelGroupApi
     pThis->__kchangrpapiCtrlCmdMakeRealtime__ = &kchangrpapiCtrlCmdMakeRealtime_IMPL;
 #endif
 
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x110u)
+    pThis->__kchangrpapiCtrlCmdSetSchedClass__ = &kchangrpapiCtrlCmdSetSchedClass_IMPL;
+#endif
+
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x10u)
+    pThis->__kchangrpapiCtrlCmdGetSchedClass__ = &kchangrpapiCtrlCmdGetSchedClass_IMPL;
+#endif
+
 #if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x2610u)
     pThis->__kchangrpapiCtrlCmdInternalGpFifoSchedule__ = &kchangrpapiCtrlCmdInternalGpFifoSchedule_IMPL;
 #endif
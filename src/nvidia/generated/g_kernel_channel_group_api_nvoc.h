@@ -96,6 +96,8 @@ struct KernelChannelGroupApi {
     NV_STATUS (*__kchangrpapiCtrlCmdProgramVidmemPromote__)(struct KernelChannelGroupApi *, NVA06C_CTRL_PROGRAM_VIDMEM_PROMOTE_PARAMS *);
     NV_STATUS (*__kchangrpapiCtrlCmdInternalPromoteFaultMethodBuffers__)(struct KernelChannelGroupApi *, NVA06C_CTRL_INTERNAL_PROMOTE_FAULT_METHOD_BUFFERS_PARAMS *);
     NV_STATUS (*__kchangrpapiCtrlCmdMakeRealtime__)(struct KernelChannelGroupApi *, NVA06C_CTRL_MAKE_REALTIME_PARAMS *);
+    NV_STATUS (*__kchangrpapiCtrlCmdSetSchedClass__)(struct KernelChannelGroupApi *, NVA06C_CTRL_SCHED_CLASS_PARAMS *);
+    NV_STATUS (*__kchangrpapiCtrlCmdGetSchedClass__)(struct KernelChannelGroupApi *, NVA06C_CTRL_SCHED_CLASS_PARAMS *);
     NV_STATUS (*__kchangrpapiCtrlCmdInternalGpFifoSchedule__)(struct KernelChannelGroupApi *, NVA06C_CTRL_GPFIFO_SCHEDULE_PARAMS *);
     NV_STATUS (*__kchangrpapiCtrlCmdInternalSetTimeslice__)(struct KernelChannelGroupApi *, NVA06C_CTRL_TIMESLICE_PARAMS *);
     NV_STATUS (*__kchangrpapiCtrlGetTpcPartitionMode__)(struct KernelChannelGroupApi *, NV0090_CTRL_TPC_PARTITION_MODE_PARAMS *);
@@ -175,6 +177,8 @@ NV_STATUS __nvoc_objCreate_KernelChannelGroupApi(KernelChannelGroupApi**, Dynami
 #define kchangrpapiCtrlCmdProgramVidmemPromote(pKernelChannelGroupApi, pParams) kchangrpapiCtrlCmdProgramVidmemPromote_DISPATCH(pKernelChannelGroupApi, pParams)
 #define kchangrpapiCtrlCmdInternalPromoteFaultMethodBuffers(pKernelChannelGroupApi, pParams) kchangrpapiCtrlCmdInternalPromoteFaultMethodBuffers_DISPATCH(pKernelChannelGroupApi, pParams)
 #define kchangrpapiCtrlCmdMakeRealtime(pKernelChannelGroupApi, pParams) kchangrpapiCtrlCmdMakeRealtime_DISPATCH(pKernelChannelGroupApi, pParams)
+#define kchangrpapiCtrlCmdSetSchedClass(pKernelChannelGroupApi, pParams) kchangrpapiCtrlCmdSetSchedClass_DISPATCH(pKernelChannelGroupApi, pParams)
+#define kchangrpapiCtrlCmdGetSchedClass(pKernelChannelGroupApi, pParams) kchangrpapiCtrlCmdGetSchedClass_DISPATCH(pKernelChannelGroupApi, pParams)
 #define kchangrpapiCtrlCmdInternalGpFifoSchedule(pKernelChannelGroupApi, pSchedParams) kchangrpapiCtrlCmdInternalGpFifoSchedule_DISPATCH(pKernelChannelGroupApi, pSchedParams)
 #define kchangrpapiCtrlCmdInternalSetTimeslice(pKernelChannelGroupApi, pTsParams) kchangrpapiCtrlCmdInternalSetTimeslice_DISPATCH(pKernelChannelGroupApi, pTsParams)
 #define kchangrpapiCtrlGetTpcPartitionMode(pKernelChannelGroupApi, pParams) kchangrpapiCtrlGetTpcPartitionMode_DISPATCH(pKernelChannelGroupApi, pParams)
@@ -282,6 +286,18 @@ static inline NV_STATUS kchangrpapiCtrlCmdMakeRealtime_DISPATCH(struct KernelCha
     return pKernelChannelGroupApi->__kchangrpapiCtrlCmdMakeRealtime__(pKernelChannelGroupApi, pParams);
 }
 
+NV_STATUS kchangrpapiCtrlCmdSetSchedClass_IMPL(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams);
+
+static inline NV_STATUS kchangrpapiCtrlCmdSetSchedClass_DISPATCH(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams) {
+    return pKernelChannelGroupApi->__kchangrpapiCtrlCmdSetSchedClass__(pKernelChannelGroupApi, pParams);
+}
+
+NV_STATUS kchangrpapiCtrlCmdGetSchedClass_IMPL(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams);
+
+static inline NV_STATUS kchangrpapiCtrlCmdGetSchedClass_DISPATCH(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams) {
+    return pKernelChannelGroupApi->__kchangrpapiCtrlCmdGetSchedClass__(pKernelChannelGroupApi, pParams);
+}
+
 NV_STATUS kchangrpapiCtrlCmdInternalGpFifoSchedule_IMPL(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_GPFIFO_SCHEDULE_PARAMS *pSchedParams);
 
 static inline NV_STATUS kchangrpapiCtrlCmdInternalGpFifoSchedule_DISPATCH(struct KernelChannelGroupApi *pKernelChannelGroupApi, NVA06C_CTRL_GPFIFO_SCHEDULE_PARAMS *pSchedParams) {
@@ -130,6 +130,8 @@ struct KernelChannelGroup {
     struct OBJEHEAP *pSubctxIdHeap;
     CHANNEL_LIST *pChanList;
     NvU64 timesliceUs;
+    NvU32 schedClass;
+    NvU32 preemptTimeoutUs;
     ENGINE_CTX_DESCRIPTOR **ppEngCtxDesc;
     NvBool bAllocatedByRm;
     NvBool bLegacyMode;
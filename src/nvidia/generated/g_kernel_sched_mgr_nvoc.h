@@ -45,12 +45,25 @@ extern "C" {
 #include "gpu/gpu.h"
 
 #include "ctrl/ctrl2080/ctrl2080fifo.h" // NV2080_CTRL_FIFO_*
+#include "ctrl/ctrla06c.h"              // NVA06C_CTRL_SCHED_CLASS_*
 
 /* ------------------------------- Datatypes  --------------------------------*/
 
 #define SCHED_POLICY_DEFAULT 0
 typedef NvU32 SCHED_POLICY;
 
+/*!
+ * Settings applied to the TSGs of a scheduling class.
+ * A timesliceUs of zero is the hardware default timeslice, a preemptTimeoutUs
+ * of zero is the RM default preemption timeout.
+ */
+typedef struct
+{
+    NvU64 timesliceUs;
+    NvU32 preemptTimeoutUs;
+    NvU32 interleaveLevel;
+} KSCHEDMGR_SCHED_CLASS_CONFIG;
+
 /*!
  * Class of scheduling manager for all the runlists.
  */
@@ -66,6 +79,7 @@ struct KernelSchedMgr {
     struct KernelSchedMgr *__nvoc_pbase_KernelSchedMgr;
     NvBool bIsSchedSwEnabled;
     NvU32 configSchedPolicy;
+    KSCHEDMGR_SCHED_CLASS_CONFIG schedClassConfig[4];
 };
 
 #ifndef __NVOC_CLASS_KernelSchedMgr_TYPEDEF__
@@ -104,6 +118,10 @@ static inline NvU32 kschedmgrGetSchedPolicy(struct KernelSchedMgr *pKernelSchedM
     return pKernelSchedMgr->configSchedPolicy;
 }
 
+static inline const KSCHEDMGR_SCHED_CLASS_CONFIG *kschedmgrGetSchedClassConfig(struct KernelSchedMgr *pKernelSchedMgr, NvU32 schedClass) {
+    return &pKernelSchedMgr->schedClassConfig[schedClass];
+}
+
 static inline NvBool kschedmgrIsPvmrlEnabled(struct KernelSchedMgr *pKernelSchedMgr) {
     return ((NvBool)(0 != 0));
 }
@@ -377,6 +377,9 @@ typedef struct MEMORY_DESCRIPTOR
     //
     CTX_BUF_POOL_INFO *pCtxBufPool;
 
+    // Memory descriptor cache chunk this descriptor lives in, NULL if heap allocated
+    void *_pCacheChunk;
+
     // Max physical address width to be override
     NvU32 _overridenAddressWidth;
 
@@ -418,6 +421,10 @@ NvU32 memdescAddrSpaceListToU32(const NV_ADDRESS_SPACE *addrlist);
 const NV_ADDRESS_SPACE *memdescU32ToAddrSpaceList(NvU32 index);
 
 NV_STATUS _memdescUpdateSpaArray(PMEMORY_DESCRIPTOR   pMemDesc);
+// Global cache backing small memory descriptors. See memdescCreate().
+NV_STATUS memdescCacheInit(void);
+void memdescCacheDestroy(void);
+
 // Create a memory descriptor data structure (without allocating any physical
 // storage).
 NV_STATUS memdescCreate(MEMORY_DESCRIPTOR **ppMemDesc, OBJGPU *pGpu, NvU64 Size,
@@ -79,6 +79,18 @@ typedef struct RsClient RsClient;
 #endif /* __nvoc_class_id_RsClient */
 
 
+struct RmClient;
+
+#ifndef __NVOC_CLASS_RmClient_TYPEDEF__
+#define __NVOC_CLASS_RmClient_TYPEDEF__
+typedef struct RmClient RmClient;
+#endif /* __NVOC_CLASS_RmClient_TYPEDEF__ */
+
+#ifndef __nvoc_class_id_RmClient
+#define __nvoc_class_id_RmClient 0xb23d83
+#endif /* __nvoc_class_id_RmClient */
+
+
 struct Heap;
 
 #ifndef __NVOC_CLASS_Heap_TYPEDEF__
@@ -492,6 +504,9 @@ NV_STATUS memGetByHandleAndDevice_IMPL(struct RsClient *pClient, NvHandle hMemor
 NV_STATUS memGetByHandleAndGroupedGpu_IMPL(struct RsClient *pClient, NvHandle hMemory, struct OBJGPU *pGpu, struct Memory **ppMemory);
 
 #define memGetByHandleAndGroupedGpu(pClient, hMemory, pGpu, ppMemory) memGetByHandleAndGroupedGpu_IMPL(pClient, hMemory, pGpu, ppMemory)
+void memFlushDeferredFrees_IMPL(struct RmClient *pClient);
+
+#define memFlushDeferredFrees(pClient) memFlushDeferredFrees_IMPL(pClient)
 #undef PRIVATE_FIELD
 
 
@@ -148,6 +148,7 @@ struct TMR_EVENT_PVT
     NvU64               timens;      //<! Absolute time to perform callback
     NvU64               startTimeNs; //<! Store system time at timer callback schedule
     PTMR_EVENT_PVT      pNext;       //<! Next element in the list
+    PTMR_EVENT_PVT      pPrev;       //<! Previous element, OS timer list only
 };
 
 /*!
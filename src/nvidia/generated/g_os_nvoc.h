@@ -961,6 +961,10 @@ NV_STATUS osCreateMemFromOsDescriptor(OBJGPU *pGpu, NvP64 pDescriptor,
                                       NvU32 descriptorType,
                                       RS_PRIV_LEVEL privilegeLevel);
 
+void osCompleteMemFromOsDescriptor(MEMORY_DESCRIPTOR *pMemDesc,
+                                   NvP64 pDescriptor,
+                                   NvU32 descriptorType);
+
 void* osMapKernelSpace(RmPhysAddr Start,
                        NvU64 Size,
                        NvU32 Mode,
@@ -52,6 +52,14 @@ typedef struct
     NvBool bDevProfilingPermitted;
 } PROFILER_CLIENT_PERMISSIONS;
 
+typedef struct
+{
+    // Bytes available at which to notify, 0 if disarmed
+    NvU64  watermarkBytes;
+    // Set once notified, cleared when the level drops below the watermark
+    NvBool bNotified;
+} PROFILER_PMA_STREAM_WATERMARK;
+
 #ifdef NVOC_PROFILER_V2_H_PRIVATE_ACCESS_ALLOWED
 #define PRIVATE_FIELD(x) x
 #else
@@ -90,6 +98,7 @@ struct ProfilerBase {
     NV_STATUS (*__profilerBaseCtrlCmdSetHsCredits__)(struct ProfilerBase *, NVB0CC_CTRL_SET_HS_CREDITS_PARAMS *);
     NV_STATUS (*__profilerBaseCtrlCmdReserveHes__)(struct ProfilerBase *, NVB0CC_CTRL_RESERVE_HES_PARAMS *);
     NV_STATUS (*__profilerBaseCtrlCmdReleaseHes__)(struct ProfilerBase *, NVB0CC_CTRL_RELEASE_HES_PARAMS *);
+    NV_STATUS (*__profilerBaseCtrlCmdPmaStreamSetWatermark__)(struct ProfilerBase *, NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS *);
     NV_STATUS (*__profilerBaseCtrlCmdRequestCgControls__)(struct ProfilerBase *, NVB0CC_CTRL_POWER_REQUEST_FEATURES_PARAMS *);
     NV_STATUS (*__profilerBaseCtrlCmdReleaseCgControls__)(struct ProfilerBase *, NVB0CC_CTRL_POWER_RELEASE_FEATURES_PARAMS *);
     NvBool (*__profilerBaseShareCallback__)(struct ProfilerBase *, struct RsClient *, struct RsResourceRef *, RS_SHARE_POLICY *);
@@ -124,6 +133,9 @@ struct ProfilerBase {
     struct RsResourceRef **ppStreamBuffers;
     struct RsResourceRef *pBoundCntBuf;
     struct RsResourceRef *pBoundPmaBuf;
+    PROFILER_PMA_STREAM_WATERMARK *pPmaWatermarks;
+    struct TMR_EVENT *pPmaWatermarkEvent;
+    NvU32 pmaWatermarkPollIntervalUs;
 };
 
 #ifndef __NVOC_CLASS_ProfilerBase_TYPEDEF__
@@ -178,6 +190,7 @@ NV_STATUS __nvoc_objCreate_ProfilerBase(ProfilerBase**, Dynamic*, NvU32, struct
 #define profilerBaseCtrlCmdSetHsCredits(pProfiler, pParams) profilerBaseCtrlCmdSetHsCredits_DISPATCH(pProfiler, pParams)
 #define profilerBaseCtrlCmdReserveHes(pProfiler, pParams) profilerBaseCtrlCmdReserveHes_DISPATCH(pProfiler, pParams)
 #define profilerBaseCtrlCmdReleaseHes(pProfiler, pParams) profilerBaseCtrlCmdReleaseHes_DISPATCH(pProfiler, pParams)
+#define profilerBaseCtrlCmdPmaStreamSetWatermark(pProfiler, pParams) profilerBaseCtrlCmdPmaStreamSetWatermark_DISPATCH(pProfiler, pParams)
 #define profilerBaseCtrlCmdRequestCgControls(pProfiler, pParams) profilerBaseCtrlCmdRequestCgControls_DISPATCH(pProfiler, pParams)
 #define profilerBaseCtrlCmdReleaseCgControls(pProfiler, pParams) profilerBaseCtrlCmdReleaseCgControls_DISPATCH(pProfiler, pParams)
 #define profilerBaseShareCallback(pGpuResource, pInvokingClient, pParentRef, pSharePolicy) profilerBaseShareCallback_DISPATCH(pGpuResource, pInvokingClient, pParentRef, pSharePolicy)
@@ -380,6 +393,12 @@ static inline NV_STATUS profilerBaseCtrlCmdReleaseHes_DISPATCH(struct ProfilerBa
     return pProfiler->__profilerBaseCtrlCmdReleaseHes__(pProfiler, pParams);
 }
 
+NV_STATUS profilerBaseCtrlCmdPmaStreamSetWatermark_IMPL(struct ProfilerBase *pProfiler, NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS *pParams);
+
+static inline NV_STATUS profilerBaseCtrlCmdPmaStreamSetWatermark_DISPATCH(struct ProfilerBase *pProfiler, NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS *pParams) {
+    return pProfiler->__profilerBaseCtrlCmdPmaStreamSetWatermark__(pProfiler, pParams);
+}
+
 NV_STATUS profilerBaseCtrlCmdRequestCgControls_IMPL(struct ProfilerBase *pProfiler, NVB0CC_CTRL_POWER_REQUEST_FEATURES_PARAMS *pParams);
 
 static inline NV_STATUS profilerBaseCtrlCmdRequestCgControls_DISPATCH(struct ProfilerBase *pProfiler, NVB0CC_CTRL_POWER_REQUEST_FEATURES_PARAMS *pParams) {
@@ -789,6 +808,8 @@ void profilerDevDestruct_IMPL(struct ProfilerDev *pResource);
 #define __nvoc_profilerDevDestruct(pResource) profilerDevDestruct_IMPL(pResource)
 #undef PRIVATE_FIELD
 
+void profilerBasePmaWatermarkDestroy(struct ProfilerBase *pProfiler);
+
 #endif // PROFILER_V2_H
 
 #ifdef __cplusplus
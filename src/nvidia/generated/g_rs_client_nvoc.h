@@ -97,6 +97,7 @@ struct RsClient {
     NvBool bDisabled;
     NvBool bHighPriorityFreeDone;
     RsRefMap resourceMap;
+    RsResourceRef *pLookupCache[RS_CLIENT_LOOKUP_CACHE_SIZE];
     AccessBackRefList accessBackRefList;
     NvHandle handleRangeStart;
     NvHandle handleRangeSize;
@@ -643,6 +643,16 @@ extern NV_STATUS serverAllocResourceUnderLock(RsServer *pServer, RS_RES_ALLOC_PA
  */
 extern NV_STATUS serverFreeResourceRpcUnderLock(RsServer *pServer, RS_RES_FREE_PARAMS *pFreeParams);
 
+/**
+ * Prepare for freeing a client's entire resource tree in one pass. Called once
+ * the pending free list has been built, before any resource is freed. Assumes
+ * the client lock has been taken. User-implemented.
+ *
+ * @param[in]    pServer This server instance
+ * @param[in]    pClient The client being freed
+ */
+extern NV_STATUS serverBulkFreeClientUnderLock(RsServer *pServer, struct RsClient *pClient);
+
 /**
  * Copy-in parameters supplied by caller, and initialize API state. User-implemented.
  * @param[in]   pServer
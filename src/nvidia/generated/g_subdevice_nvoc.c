@@ -1198,12 +1198,12 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_Subdevic
 #endif
     },
     {               /*  [64] */
-#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x50u)
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x4050u)
         /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) subdeviceCtrlCmdGpuGetMaxSupportedPageSize_IMPL,
-#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x50u)
-        /*flags=*/      0x50u,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x4050u)
+        /*flags=*/      0x4050u,
         /*accessRight=*/0x0u,
         /*methodId=*/   0x20800188u,
         /*paramSize=*/  sizeof(NV2080_CTRL_GPU_GET_MAX_SUPPORTED_PAGE_SIZE_PARAMS),
@@ -408,6 +408,7 @@ struct OBJSYS {
     NvBool PDB_PROP_SYS_BUGCHECK_ON_TIMEOUT;
     NvBool PDB_PROP_SYS_CLIENT_HANDLE_LOOKUP;
     NvU32 apiLockMask;
+    NvU32 clientLockMask;
     NvU32 apiLockModuleMask;
     NvU32 gpuLockModuleMask;
     NvBool PDB_PROP_SYS_ROUTE_TO_PHYSICAL_LOCK_BYPASS;
@@ -240,6 +240,36 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_VidmemAc
     {               /*  [0] */
 #if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
         /*pFunc=*/      (void (*)(void)) NULL,
+#else
+        /*pFunc=*/      (void (*)(void)) vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging_IMPL,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+        /*flags=*/      0x160200u,
+        /*accessRight=*/0x0u,
+        /*methodId=*/   0xc7630101u,
+        /*paramSize=*/  sizeof(NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_ENABLE_LOGGING_PARAMS),
+        /*pClassInfo=*/ &(__nvoc_class_def_VidmemAccessBitBuffer.classInfo),
+#if NV_PRINTF_STRINGS_ALLOWED
+        /*func=*/       "vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging"
+#endif
+    },
+    {               /*  [1] */
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+        /*pFunc=*/      (void (*)(void)) NULL,
+#else
+        /*pFunc=*/      (void (*)(void)) vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging_IMPL,
+#endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+        /*flags=*/      0x160200u,
+        /*accessRight=*/0x0u,
+        /*methodId=*/   0xc7630102u,
+        /*paramSize=*/  0,
+        /*pClassInfo=*/ &(__nvoc_class_def_VidmemAccessBitBuffer.classInfo),
+#if NV_PRINTF_STRINGS_ALLOWED
+        /*func=*/       "vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging"
+#endif
+    },
+    {               /*  [2] */
+#if NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+        /*pFunc=*/      (void (*)(void)) NULL,
 #else
         /*pFunc=*/      (void (*)(void)) vidmemAccessBitBufCtrlCmdVidmemAccessBitDump_IMPL,
 #endif // NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
@@ -257,7 +287,7 @@ static const struct NVOC_EXPORTED_METHOD_DEF __nvoc_exported_method_def_VidmemAc
 
 const struct NVOC_EXPORT_INFO __nvoc_export_info_VidmemAccessBitBuffer = 
 {
-    /*numEntries=*/     1,
+    /*numEntries=*/     3,
     /*pExportEntries=*/ __nvoc_exported_method_def_VidmemAccessBitBuffer
 };
 
@@ -311,6 +341,14 @@ static void __nvoc_init_funcTable_VidmemAccessBitBuffer_1(VidmemAccessBitBuffer
     PORT_UNREFERENCED_VARIABLE(rmVariantHal);
     PORT_UNREFERENCED_VARIABLE(rmVariantHal_HalVarIdx);
 
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+    pThis->__vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging__ = &vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging_IMPL;
+#endif
+
+#if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
+    pThis->__vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging__ = &vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging_IMPL;
+#endif
+
 #if !NVOC_EXPORTED_METHOD_DISABLED_BY_FLAG(0x160200u)
     pThis->__vidmemAccessBitBufCtrlCmdVidmemAccessBitDump__ = &vidmemAccessBitBufCtrlCmdVidmemAccessBitDump_IMPL;
 #endif
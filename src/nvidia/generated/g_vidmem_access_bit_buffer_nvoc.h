@@ -93,6 +93,8 @@ struct VidmemAccessBitBuffer {
     struct INotifier *__nvoc_pbase_INotifier;
     struct Notifier *__nvoc_pbase_Notifier;
     struct VidmemAccessBitBuffer *__nvoc_pbase_VidmemAccessBitBuffer;
+    NV_STATUS (*__vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging__)(struct VidmemAccessBitBuffer *, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_ENABLE_LOGGING_PARAMS *);
+    NV_STATUS (*__vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging__)(struct VidmemAccessBitBuffer *);
     NV_STATUS (*__vidmemAccessBitBufCtrlCmdVidmemAccessBitDump__)(struct VidmemAccessBitBuffer *, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DUMP_PARAMS *);
     NvBool (*__vidmemAccessBitBufShareCallback__)(struct VidmemAccessBitBuffer *, struct RsClient *, struct RsResourceRef *, RS_SHARE_POLICY *);
     NV_STATUS (*__vidmemAccessBitBufCheckMemInterUnmap__)(struct VidmemAccessBitBuffer *, NvBool);
@@ -154,6 +156,8 @@ NV_STATUS __nvoc_objCreate_VidmemAccessBitBuffer(VidmemAccessBitBuffer**, Dynami
 #define __objCreate_VidmemAccessBitBuffer(ppNewObj, pParent, createFlags, arg_pCallContext, arg_pParams) \
     __nvoc_objCreate_VidmemAccessBitBuffer((ppNewObj), staticCast((pParent), Dynamic), (createFlags), arg_pCallContext, arg_pParams)
 
+#define vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging(pVidmemAccessBitBuffer, pParams) vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging_DISPATCH(pVidmemAccessBitBuffer, pParams)
+#define vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging(pVidmemAccessBitBuffer) vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging_DISPATCH(pVidmemAccessBitBuffer)
 #define vidmemAccessBitBufCtrlCmdVidmemAccessBitDump(pVidmemAccessBitBuffer, pParams) vidmemAccessBitBufCtrlCmdVidmemAccessBitDump_DISPATCH(pVidmemAccessBitBuffer, pParams)
 #define vidmemAccessBitBufShareCallback(pGpuResource, pInvokingClient, pParentRef, pSharePolicy) vidmemAccessBitBufShareCallback_DISPATCH(pGpuResource, pInvokingClient, pParentRef, pSharePolicy)
 #define vidmemAccessBitBufCheckMemInterUnmap(pRmResource, bSubdeviceHandleProvided) vidmemAccessBitBufCheckMemInterUnmap_DISPATCH(pRmResource, bSubdeviceHandleProvided)
@@ -205,6 +209,18 @@ static inline void vidmemAccessBitBufDestruct_b3696a(struct VidmemAccessBitBuffe
 
 
 #define __nvoc_vidmemAccessBitBufDestruct(pVidmemAccessBitBuffer) vidmemAccessBitBufDestruct_b3696a(pVidmemAccessBitBuffer)
+NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging_IMPL(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_ENABLE_LOGGING_PARAMS *pParams);
+
+static inline NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging_DISPATCH(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_ENABLE_LOGGING_PARAMS *pParams) {
+    return pVidmemAccessBitBuffer->__vidmemAccessBitBufCtrlCmdVidmemAccessBitEnableLogging__(pVidmemAccessBitBuffer, pParams);
+}
+
+NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging_IMPL(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer);
+
+static inline NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging_DISPATCH(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer) {
+    return pVidmemAccessBitBuffer->__vidmemAccessBitBufCtrlCmdVidmemAccessBitDisableLogging__(pVidmemAccessBitBuffer);
+}
+
 NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitDump_IMPL(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DUMP_PARAMS *pParams);
 
 static inline NV_STATUS vidmemAccessBitBufCtrlCmdVidmemAccessBitDump_DISPATCH(struct VidmemAccessBitBuffer *pVidmemAccessBitBuffer, NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DUMP_PARAMS *pParams) {
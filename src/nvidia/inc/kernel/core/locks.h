@@ -29,6 +29,21 @@
 // Forward declarations
 typedef struct OBJSYS OBJSYS;
 
+//
+// Lock order. A thread holding a lock may only acquire locks further down:
+//
+//   1. RM semaphore (only for entry points that request it)
+//   2. API lock (g_RmApiLock)
+//   3. Client locks, two clients in ascending handle order
+//   4. Session lock of the resource
+//   5. GPU locks, in ascending gpuInstance order. GPU group locks take the
+//      same per-GPU locks for a subset of the GPUs.
+//   6. Spinlocks protecting individual objects
+//
+// Controls declare the narrowest GPU lock they need with RMCTRL_FLAGS
+// (NO_GPUS_LOCK, GPU_LOCK_DEVICE_ONLY, GPU_LOCK_READONLY).
+//
+
 typedef enum
 {
     GPU_LOCK_GRP_SUBDEVICE,  // locks will be taken for subdevice only
@@ -184,8 +199,24 @@ void       rmIntrMaskLockRelease(OBJGPU *pGpu, NvU64 oldIrql);
 #define LOCK_METER_OP(f,l,t,d0,d1,d2)
 #define LOCK_METER_DATA(t,d0,d1,d2)
 
-#define rmInitLockMetering()
-#define rmDestroyLockMetering()
+//
+// Lock metering: acquire wait histograms and per call site hold times for
+// the API and GPU locks. Disabled unless NV_REG_STR_RM_LOCK_METERING is set,
+// in which case rmLockMeterTimestamp() returns 0 and nothing is recorded.
+//
+typedef enum
+{
+    RM_LOCK_METER_API_LOCK,
+    RM_LOCK_METER_GPU_LOCK,
+    RM_LOCK_METER_COUNT
+} RM_LOCK_METER_ID;
+
+void       rmInitLockMetering(void);
+void       rmDestroyLockMetering(void);
+NvU64      rmLockMeterTimestamp(void);
+void       rmLockMeterRecordWait(RM_LOCK_METER_ID, NvU64 startTs);
+void       rmLockMeterRecordHold(RM_LOCK_METER_ID, NvUPtr callerRA, NvU64 acquireTs);
+void       rmLockMeterDump(void);
 
 #include "rmapi/rmapi.h"
 
@@ -179,6 +179,7 @@ typedef struct THREAD_STATE_DB
 #define THREAD_STATE_FLAGS_PLACED_ON_PREEMPT_LIST       NVBIT(6)
 #define THREAD_STATE_FLAGS_DEVICE_INIT                  NVBIT(7)
 #define THREAD_STATE_FLAGS_STATE_FREE_CB_ENABLED        NVBIT(8)
+#define THREAD_STATE_FLAGS_TIMEOUT_DEFERRED             NVBIT(9)
 
 // These Threads run exclusively between a conditional acquire
 #define THREAD_STATE_FLAGS_EXCLUSIVE_RUNNING   (THREAD_STATE_FLAGS_IS_ISR                       | \
@@ -74,6 +74,32 @@ typedef struct
     RM_PROF_STATS *pLast;  //<! Stats for the previous module of the group.
 } RM_PROF_GROUP;
 
+/*!
+ * Timestamped trace of the steps of a one-time sequence, such as GPU init.
+ *
+ * Each entry records when a step ended, relative to the start of the trace,
+ * and how long it took. Entries are kept in the order they were recorded;
+ * once the trace is full, further entries are only counted.
+ */
+#define RM_PROF_TRACE_MAX_ENTRIES   48
+#define RM_PROF_TRACE_NAME_LENGTH   32
+
+typedef struct
+{
+    char    name[RM_PROF_TRACE_NAME_LENGTH];
+    NvU64   end_ns;     //<! End of the step, relative to the start of the trace
+    NvU64   elapsed_ns; //<! Duration of the step
+} RM_PROF_TRACE_ENTRY;
+
+typedef struct RM_PROF_TRACE
+{
+    NvU64               start_ns; //<! Start of the trace, 0 if never started
+    NvU64               last_ns;  //<! End of the last step
+    NvU32               count;    //<! Number of valid entries
+    NvU32               dropped;  //<! Steps not recorded because the trace was full
+    RM_PROF_TRACE_ENTRY entries[RM_PROF_TRACE_MAX_ENTRIES];
+} RM_PROF_TRACE;
+
 /*!
  * Start measuring time for the specified module stats (begin a new cycle).
  */
@@ -116,4 +142,15 @@ void rmProfGroupStart(RM_PROF_GROUP *pGroup, RM_PROF_STATS *pTotal, RM_PROF_STAT
 void rmProfGroupNext (RM_PROF_GROUP *pGroup, RM_PROF_STATS *pNext);
 void rmProfGroupStop (RM_PROF_GROUP *pGroup);
 
+/*!
+ * Trace API. rmProfTraceStep ends the step that started at the previous step
+ * (or at the start of the trace), while rmProfTraceRecord adds a step whose
+ * duration was measured by the caller, e.g. a sub-step of the next one. All
+ * of them accept a NULL trace, which records nothing.
+ */
+void rmProfTraceStart (RM_PROF_TRACE *pTrace, NvU64 start_ns);
+void rmProfTraceStep  (RM_PROF_TRACE *pTrace, const char *pName);
+void rmProfTraceRecord(RM_PROF_TRACE *pTrace, const char *pName, NvU64 elapsed_ns);
+void rmProfTracePrint (RM_PROF_TRACE *pTrace, const char *pTitle);
+
 #endif /* _PROFILER_H_ */
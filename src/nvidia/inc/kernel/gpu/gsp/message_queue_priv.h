@@ -69,6 +69,10 @@ typedef struct _message_queue_info
     NvU32                  txSeqNum;            // Next sequence number for tx.
     NvU32                  rxSeqNum;            // Next sequence number for rx.
     NvU32                  txBufferFull;
+    NvU32                  txLastFree;          // Free elements when the last command was queued.
+    NvU32                  txFreeMax;           // Most free elements seen, i.e. the idle capacity.
+    NvU32                  txUsedHighWater;     // Most elements seen in use.
+    NvU32                  txSpaceWaits;        // Commands that had to wait for queue space.
     NvU32                  queueIdx;            // QueueIndex used to identify which task the message is supposed to be sent to.
 } MESSAGE_QUEUE_INFO;
 
@@ -65,6 +65,7 @@ public:
     NV_STATUS ceutilsMemcopy(CeUtils *pCeUtils, CEUTILS_MEMCOPY_PARAMS *pParams);
 
     NvU64 ceutilsUpdateProgress(CeUtils *pCeUtils);
+    NV_STATUS ceutilsWaitForWorkId(CeUtils *pCeUtils, NvU64 workId);
     void ceutilsServiceInterrupts(CeUtils *pCeUtils);
 
     //
@@ -195,6 +195,7 @@ typedef NV_STATUS (*pmaMapScanContiguousNumaEviction_t)(void *pMap, NvU64 addrBa
                                                         NvU64 pageSize, NvU64 *evictStart, NvU64 *evictEnd);
 typedef NvU64 (*pmaMapGetEvictingFrames_t)(void *pMap);
 typedef void (*pmaMapSetEvictingFrames_t)(void *pMap, NvU64 frameEvictionsInProcess);
+typedef NvU64 (*pmaMapGetFreeAlignedCount_t)(void *pMap, NvU64 addrBase, NvU64 size);
 
 struct _PMA_MAP_INFO
 {
@@ -213,8 +214,29 @@ struct _PMA_MAP_INFO
     pmaMapScanContiguousNumaEviction_t pmaMapScanContiguousNumaEviction;
     pmaMapGetEvictingFrames_t  pmaMapGetEvictingFrames;
     pmaMapSetEvictingFrames_t  pmaMapSetEvictingFrames;
+    pmaMapGetFreeAlignedCount_t pmaMapGetFreeAlignedCount;    // Optional, NULL if not supported
 };
 
+//
+// Page sizes of pmaAllocatePages(), in the order of the allocation latency
+// histograms
+//
+#define PMA_ALLOC_STATS_PAGE_SIZES          4
+
+// Bucket i counts the pmaAllocatePages() calls that took [2^i, 2^(i+1)) ns
+#define PMA_ALLOC_STATS_LATENCY_BUCKETS     32
+
+/*!
+ * @brief Allocation telemetry, updated with atomics outside of the PMA lock
+ */
+typedef struct
+{
+    volatile NvU32  latency[PMA_ALLOC_STATS_PAGE_SIZES][PMA_ALLOC_STATS_LATENCY_BUCKETS];
+    volatile NvU32  numFailedAllocs;    // Allocations that returned an error
+    volatile NvU32  numEvictions;       // Eviction callbacks issued by allocations
+    volatile NvU32  numFailedEvictions; // Eviction callbacks that returned an error
+} PMA_ALLOC_STATS;
+
 struct _PMA
 {
     PORT_SPINLOCK           *pPmaLock;                          // PMA-wide lock
@@ -238,6 +260,7 @@ struct _PMA
     NvU64                   frameAllocDemand;                   // Frame count of allocations in-process
     NvBool                  bForcePersistence;                  // Force all allocations to persist across suspend/resume
     PMA_STATS               pmaStats;                           // PMA statistics used for client heuristics
+    PMA_ALLOC_STATS         allocStats;                         // Allocation latency and eviction telemetry
 
     // Scrubber related states
     NvSPtr                  initScrubbing;                      // If the init scrubber has finished in this PMA
@@ -669,6 +692,32 @@ void pmaGetFreeMemory(PMA *pPma, NvU64 *pBytesFree);
  */
 void pmaGetLargestFree(PMA *pPma, NvU64 *pLargestFree, NvU64 *pRegionBase, NvU64 *pLargestOffset);
 
+/*!
+ * @brief Returns the number of free, naturally aligned chunks of FB memory of
+ *        the given size across all regions.
+ *
+ * Regions whose map does not support the query are not counted.
+ *
+ * @param[in]  pPma           PMA pointer
+ * @param[in]  size           Chunk size, a multiple of the PMA frame size
+ * @param[out] pCount         Pointer that will return the number of free chunks.
+ *
+ * @return
+ *      void
+ */
+void pmaGetFreeAlignedCount(PMA *pPma, NvU64 size, NvU64 *pCount);
+
+/*!
+ * @brief Prints the allocation telemetry of PMA: latency histograms by page
+ *        size, eviction counts and the number of free 2MB and 512MB chunks.
+ *
+ * @param[in]  pPma           PMA pointer
+ *
+ * @return
+ *      void
+ */
+void pmaPrintAllocStats(PMA *pPma);
+
 /*!
  * @brief Returns a list of PMA allocated blocks which has ATTRIB_PERSISTENT
  *        attribute set. It will be used by FBSR module to save/restore
@@ -36,6 +36,12 @@ extern "C" {
 // TODO See if this can be added to NvPort
 #define pmaPortAtomicGet(ptr) portAtomicOrSize((ptr), 0)
 
+//
+// PMA_STATS counters are only written with the PMA lock held, through atomic
+// updates, so that capacity queries can read them without taking the lock.
+//
+#define pmaStatsGet(ptr) portAtomicExAddU64((volatile NvU64 *)(ptr), 0)
+
 NvU32 findRegionID(PMA *pPma, NvU64 address);
 void pmaPrintBlockStatus(PMA_PAGESTATUS blockStatus);
 void pmaRegionPrint(PMA *pPma, PMA_REGION_DESCRIPTOR *pRegion, void *pMap);
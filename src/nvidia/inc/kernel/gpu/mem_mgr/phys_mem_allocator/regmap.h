@@ -242,6 +242,19 @@ void pmaRegmapGetSize(void *pMap, NvU64 *pBytesTotal);
  */
 void pmaRegmapGetLargestFree(void *pMap, NvU64 *pLargestFree);
 
+/*!
+ * @brief Count the free, naturally aligned chunks of the given size in the
+ * specified PMA managed region of the FB. Frames that are being scrubbed or
+ * evicted count as free.
+ *
+ * @param[in]  pMap         Pointer to the regmap for the region
+ * @param[in]  addrBase     Base address of the region
+ * @param[in]  size         Chunk size, a multiple of the frame size
+ *
+ * @return The number of free chunks
+ */
+NvU64 pmaRegmapGetFreeAlignedCount(void *pMap, NvU64 addrBase, NvU64 size);
+
 
 /*!
  * @brief Returns the address range that is completely available for eviction.
@@ -92,6 +92,10 @@ typedef struct {
     NvU32 timeoutSecs;
     /*! Seconds between when the Watchdog is run */
     NvU32 intervalSecs;
+    /*! Upper bound of curIntervalSecs, equal to intervalSecs if not adaptive */
+    NvU32 maxIntervalSecs;
+    /*! Interval in use, grows while the watchdog keeps completing on time */
+    NvU32 curIntervalSecs;
     NvU64 notifyLimitTime;
     NvU64 nextRunTime;
     NvU64 resetLimitTime;
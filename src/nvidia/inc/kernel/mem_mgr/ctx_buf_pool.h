@@ -48,6 +48,9 @@ struct CTX_BUF_POOL_INFO
     // Pool corresponding to RM_ATTR_PAGE_SIZE_DEFAULT will be left unused
     //
     RM_POOL_ALLOC_MEM_RESERVE_INFO *pMemPool[RM_ATTR_PAGE_SIZE_INVALID];
+
+    // Heap whose PMA backs the pools
+    Heap *pHeap;
 };
 
 // List of all context buffers supported by memory pools
@@ -69,6 +72,30 @@ struct CTX_BUF_INFO
 };
 typedef struct CTX_BUF_INFO CTX_BUF_INFO;
 
+#define CTX_BUF_POOL_CACHE_MAX_POOLS    16
+#define CTX_BUF_POOL_CACHE_MAX_BUFS     16
+
+//
+// Idle context buffer pools of a heap that still hold their reservation.
+// Channel groups running on GR take a pool from here instead of creating and
+// reserving a new one, and give it back when they are freed. Accesses are
+// serialized by the API lock.
+//
+struct CTX_BUF_POOL_CACHE
+{
+    // Number of reserved pools to keep ready, from NV_REG_STR_RM_CTX_BUF_POOL_PREWARM
+    NvU32              prewarmCount;
+    NvU32              poolCount;
+    NvBool             bPrewarmQueued;
+
+    // Buffers last reserved for a GR context, used to size prewarmed pools
+    NvU32              bufCount;
+    CTX_BUF_INFO       bufInfoList[CTX_BUF_POOL_CACHE_MAX_BUFS];
+
+    CTX_BUF_POOL_INFO *pPools[CTX_BUF_POOL_CACHE_MAX_POOLS];
+};
+typedef struct CTX_BUF_POOL_CACHE CTX_BUF_POOL_CACHE;
+
 NV_STATUS ctxBufPoolInit(OBJGPU *pGpu, Heap *pHeap, CTX_BUF_POOL_INFO **ppCtxBufPool);
 NV_STATUS ctxBufPoolReserve(OBJGPU *pGpu, CTX_BUF_POOL_INFO *pCtxBufPool, CTX_BUF_INFO *pBufInfoList, NvU32 bufCount);
 NV_STATUS ctxBufPoolTrim(CTX_BUF_POOL_INFO *pCtxBufPool);
@@ -81,4 +108,9 @@ NV_STATUS ctxBufPoolGetSizeAndPageSize(CTX_BUF_POOL_INFO *pCtxBufPool, OBJGPU *p
 NV_STATUS ctxBufPoolGetGlobalPool(OBJGPU *pGpu, CTX_BUF_ID bufId, RM_ENGINE_TYPE rmEngineType, CTX_BUF_POOL_INFO **ppCtxBufPool);
 NvBool    ctxBufPoolIsScrubSkipped(CTX_BUF_POOL_INFO *pCtxBufPool);
 void      ctxBufPoolSetScrubSkip(CTX_BUF_POOL_INFO *pCtxBufPool, NvBool bSkipScrub);
+NvBool    ctxBufPoolIsIdle(CTX_BUF_POOL_INFO *pCtxBufPool);
+NV_STATUS ctxBufPoolCacheGet(OBJGPU *pGpu, Heap *pHeap, CTX_BUF_POOL_INFO **ppCtxBufPool);
+void      ctxBufPoolCachePut(OBJGPU *pGpu, CTX_BUF_POOL_INFO **ppCtxBufPool);
+void      ctxBufPoolCachePrewarm(OBJGPU *pGpu, CTX_BUF_POOL_INFO *pCtxBufPool, NvU32 swizzId, CTX_BUF_INFO *pBufInfoList, NvU32 bufCount);
+void      ctxBufPoolCacheDestroy(Heap *pHeap);
 #endif // _CTX_BUF_POOL_H_
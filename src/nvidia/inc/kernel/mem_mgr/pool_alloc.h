@@ -185,6 +185,17 @@ void      rmMemPoolSkipScrub(RM_POOL_ALLOC_MEM_RESERVE_INFO *pMemReserveInfo, Nv
  */
 NvBool    rmMemPoolIsScrubSkipped(RM_POOL_ALLOC_MEM_RESERVE_INFO *pMemReserveInfo);
 
+/*!
+ * @brief Check whether all allocations made from the pool have been freed.
+ *
+ * @param[in] pMemReserveInfo Pointer to the RM_POOL_ALLOC_MEM_RESERVE_INFO data
+ *
+ * @return
+ *      NV_TRUE  No allocations are outstanding
+ *      NV_FALSE Some allocations have not been freed yet
+ */
+NvBool    rmMemPoolIsIdle(RM_POOL_ALLOC_MEM_RESERVE_INFO *pMemReserveInfo);
+
 /*!
  * @brief Get page size and chunk size for a pool
  *
@@ -123,5 +123,7 @@ void        Nv04MapMemoryDmaWithSecInfo           (NVOS46_PARAMETERS*, API_SECUR
 void        Nv04UnmapMemoryDmaWithSecInfo         (NVOS47_PARAMETERS*, API_SECURITY_INFO);
 void        Nv04DupObjectWithSecInfo              (NVOS55_PARAMETERS*, API_SECURITY_INFO);
 void        Nv04ShareWithSecInfo                  (NVOS57_PARAMETERS*, API_SECURITY_INFO);
+void        Nv04AllocBatchWithSecInfo             (NVOS66_PARAMETERS*, API_SECURITY_INFO);
+void        Nv01FreeBatchWithSecInfo              (NVOS67_PARAMETERS*, API_SECURITY_INFO);
 
 #endif // _EXPORTS_H
@@ -218,6 +218,17 @@ NV_STATUS nvGpuOpsEnableAccessCntr(struct gpuDevice *device,
 
 NV_STATUS nvGpuOpsDisableAccessCntr(struct gpuDevice *device, gpuAccessCntrInfo *pAccessCntrInfo);
 
+NV_STATUS nvGpuOpsAccessBitsBufAlloc(struct gpuDevice *device,
+                                     NvU64 fbSize,
+                                     gpuAccessBitsBufferAlloc *pAccessBitsInfo);
+
+NV_STATUS nvGpuOpsAccessBitsBufFree(struct gpuDevice *device,
+                                    gpuAccessBitsBufferAlloc *pAccessBitsInfo);
+
+NV_STATUS nvGpuOpsAccessBitsDump(struct gpuDevice *device,
+                                 gpuAccessBitsBufferAlloc *pAccessBitsInfo,
+                                 NvU64 *pAccessBits);
+
 NV_STATUS nvGpuOpsP2pObjectCreate(struct gpuDevice *device1,
                                   struct gpuDevice *device2,
                                   NvHandle *hP2pObject);
@@ -250,6 +261,12 @@ NV_STATUS nvGpuOpsGetChannelResourcePtes(struct gpuAddressSpace *vaSpace,
                                          NvU64 size,
                                          gpuExternalMappingInfo *pGpuExternalMappingInfo);
 
+NV_STATUS nvGpuOpsGetChannelResourcesPtes(struct gpuAddressSpace *vaSpace,
+                                          NvU32 resourceCount,
+                                          const NvP64 *resourceDescriptors,
+                                          const NvU64 *sizes,
+                                          gpuExternalMappingInfo *pGpuExternalMappingInfos);
+
 NV_STATUS nvGpuOpsReportNonReplayableFault(struct gpuDevice *device,
                                            const void *pFaultPacket);
 
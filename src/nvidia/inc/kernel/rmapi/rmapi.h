@@ -238,6 +238,14 @@ struct _RM_API
 // Called before any RM resource is freed
 NV_STATUS rmapiFreeResourcePrologue(RS_RES_FREE_PARAMS_INTERNAL *pRmFreeParams);
 
+//
+// Allocate or free an array of objects of one client (NVOS66_ALLOC_ENTRY and
+// NVOS67_FREE_ENTRY respectively) under a single lock acquisition. Each entry
+// gets its own status; the first failing status is returned.
+//
+NV_STATUS rmapiAllocBatchWithSecInfo(NvHandle hClient, NvP64 pEntries, NvU32 numEntries, API_SECURITY_INFO *pSecInfo);
+NV_STATUS rmapiFreeBatchWithSecInfo(NvHandle hClient, NvP64 pEntries, NvU32 numEntries, API_SECURITY_INFO *pSecInfo);
+
 // Mark for deletion the client resources given a GPU mask
 void rmapiSetDelPendingClientResourcesFromGpuMask(NvU32 gpuMask);
 
@@ -279,12 +287,44 @@ NV_STATUS rmapiControlCacheSet(NvHandle hClient, NvHandle hObject, NvU32 cmd,
                                void* params, NvU32 paramsSize);
 NV_STATUS rmapiControlCacheSetGpuInstForObject(NvHandle hClient, NvHandle hObject, NvU32 gpuInst);
 void rmapiControlCacheFreeAllCacheForGpu(NvU32 gpuInst);
+void rmapiControlCacheInvalidate(NvU32 gpuInst, NvU32 eventMask);
+
+//
+// Events that change the output of some cacheable controls. Cached values of
+// the controls listed for an event in rmapi_cache.c are dropped when
+// rmapiControlCacheInvalidate() reports the event.
+//
+#define RMAPI_CONTROL_CACHE_INVALIDATE_MIG_CONFIG   NVBIT(0)
 void rmapiControlCacheSetMode(NvU32 mode);
 NvU32 rmapiControlCacheGetMode(void);
 void rmapiControlCacheFree(void);
 void rmapiControlCacheFreeClientEntry(NvHandle hClient);
 void rmapiControlCacheFreeObjectEntry(NvHandle hClient, NvHandle hObject);
 
+/**
+ * Control latency statistics API.
+ *
+ * Sampled controls are split into time spent blocked on locks, time spent
+ * waiting for GSP control RPCs, and the remainder spent executing locally.
+ */
+#define RMAPI_CONTROL_STATS_PHASE_LOCK      0
+#define RMAPI_CONTROL_STATS_PHASE_EXEC      1
+#define RMAPI_CONTROL_STATS_PHASE_RPC       2
+#define RMAPI_CONTROL_STATS_PHASE_COUNT     3
+
+typedef struct
+{
+    NvU64 startNs;
+    NvU64 phaseNs[RMAPI_CONTROL_STATS_PHASE_COUNT];
+} RMAPI_CONTROL_STATS_SAMPLE;
+
+NV_STATUS rmapiControlStatsInit(void);
+void rmapiControlStatsFree(void);
+NvBool rmapiControlStatsSampleBegin(RMAPI_CONTROL_STATS_SAMPLE *pSample);
+void rmapiControlStatsSampleEnd(RMAPI_CONTROL_STATS_SAMPLE *pSample, NvU32 cmd);
+NvU64 rmapiControlStatsWaitBegin(void);
+void rmapiControlStatsWaitEnd(NvU32 phase, NvU64 startNs);
+
 typedef struct _RM_API_CONTEXT {
     NvU32 gpuMask;
 } RM_API_CONTEXT;
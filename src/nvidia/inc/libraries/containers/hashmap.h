@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef _NV_CONTAINERS_HASHMAP_H_
+#define _NV_CONTAINERS_HASHMAP_H_
+
+// Contains mix of C/C++ declarations.
+#include "containers/type_safety.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "nvtypes.h"
+#include "nvstatus.h"
+#include "nvmisc.h"
+#include "nvport/nvport.h"
+#include "utils/nvassert.h"
+
+/**
+ * @defgroup NV_CONTAINERS_HASHMAP Hash Map
+ *
+ * @brief Unordered map from 64-bit integer keys to user-defined values.
+ *
+ * @details Open addressing table in the style of a Swiss table. Each slot has
+ * a one byte control tag holding 7 bits of the key hash, or an empty/deleted
+ * marker. Slots are probed in aligned groups of @ref HASHMAP_GROUP_SIZE, and
+ * the tags of a whole group are matched with a single 64-bit compare, so most
+ * lookups touch one control word and one value.
+ *
+ * Only the intrusive variant is provided: values embed a @ref HashMapNode and
+ * the table stores pointers to them.
+ *
+ * - Time Complexity:
+ *  * Find, insert and remove are \b O(1) expected.
+ *  * Insert is \b O(N) when the table has to grow.
+ *  * Iteration is \b O(capacity), in no particular order.
+ *
+ * - Memory Usage:
+ *  * \b 9 bytes of table per slot. The table is kept at most 7/8 full.
+ *
+ * - Allocation:
+ *  * Only insert and @ref hashmapReserve allocate, from the allocator
+ *    given to @ref hashmapInit.
+ *  * Find, remove and iteration never allocate, so they can be used from
+ *    non-paged context once the map is sized with @ref hashmapReserve.
+ *
+ * - Synchronization:
+ *  * \b None. The container is not thread-safe.
+ *  * Locking must be handled by the user if required.
+ *
+ */
+
+#define HASHMAP_GROUP_SIZE 8
+
+#define MAKE_INTRUSIVE_HASHMAP(hashmapTypeName, dataType, node)              \
+    typedef union hashmapTypeName##Iter                                      \
+    {                                                                        \
+        dataType *pValue;                                                    \
+        HashMapIterBase iter;                                                \
+    } hashmapTypeName##Iter;                                                 \
+    typedef union hashmapTypeName                                            \
+    {                                                                        \
+        IntrusiveHashMap real;                                               \
+        CONT_TAG_TYPE(HashMapBase, dataType, hashmapTypeName##Iter);         \
+        CONT_TAG_INTRUSIVE(dataType, node);                                  \
+    } hashmapTypeName
+
+#define DECLARE_INTRUSIVE_HASHMAP(hashmapTypeName)                           \
+    typedef union hashmapTypeName##Iter hashmapTypeName##Iter;               \
+    typedef union hashmapTypeName hashmapTypeName
+
+/**
+ * @brief Internal node structure to embed within intrusive hash map values.
+ */
+typedef struct HashMapNode HashMapNode;
+
+/**
+ * @brief Base type of the hash map.
+ */
+typedef struct HashMapBase HashMapBase;
+
+/**
+ * @brief Intrusive hash map (user-managed memory).
+ */
+typedef struct IntrusiveHashMap IntrusiveHashMap;
+
+/**
+ * @brief Iterator over all hash map values.
+ *
+ * See @ref iterators for usage details.
+ */
+typedef struct HashMapIterBase HashMapIterBase;
+
+struct HashMapNode
+{
+    /// @privatesection
+    NvU64           key;
+#if PORT_IS_CHECKED_BUILD
+    HashMapBase    *pMap;
+#endif
+};
+
+struct HashMapIterBase
+{
+    void           *pValue;
+    HashMapBase    *pMap;
+    NvU32           slot;
+#if PORT_IS_CHECKED_BUILD
+    NvU32           versionNumber;
+#endif
+};
+
+HashMapIterBase hashmapIterRange_IMPL(HashMapBase *pMap, void *pFirst, void *pLast);
+CONT_VTABLE_DECL(HashMapBase, HashMapIterBase);
+
+struct HashMapBase
+{
+    CONT_VTABLE_FIELD(HashMapBase);
+    PORT_MEM_ALLOCATOR *pAllocator;
+    HashMapNode       **ppSlots;
+    NvU8               *pCtrl;
+    NvU32               capacity;
+    NvU32               count;
+    NvU32               growthLeft;
+    NvS32               nodeOffset;
+#if PORT_IS_CHECKED_BUILD
+    NvU32               versionNumber;
+#endif
+};
+
+struct IntrusiveHashMap
+{
+    HashMapBase         base;
+};
+
+#define hashmapInit(pMap, pAllocator)                                        \
+    hashmapInit_IMPL(&((pMap)->real), pAllocator, sizeof(*(pMap)->nodeOffset))
+
+#define hashmapDestroy(pMap)                                                 \
+    hashmapDestroy_IMPL(&((pMap)->real).base)
+
+#define hashmapReserve(pMap, count)                                          \
+    hashmapReserve_IMPL(&((pMap)->real).base, count)
+
+#define hashmapCount(pMap)                                                   \
+    hashmapCount_IMPL(&((pMap)->real).base)
+
+#define hashmapKey(pMap, pValue)                                             \
+    hashmapKey_IMPL(&((pMap)->real).base, pValue)
+
+#define hashmapInsertExisting(pMap, key, pValue)                             \
+    hashmapInsertExisting_IMPL(&((pMap)->real).base, key,                    \
+        CONT_CHECK_ARG(pMap, pValue))
+
+#define hashmapRemove(pMap, pValue)                                          \
+    hashmapRemove_IMPL(&((pMap)->real).base, CONT_CHECK_ARG(pMap, pValue))
+
+#define hashmapRemoveByKey(pMap, key)                                        \
+    hashmapRemoveByKey_IMPL(&((pMap)->real).base, key)
+
+#define hashmapFind(pMap, key)                                               \
+    CONT_CAST_ELEM(pMap, hashmapFind_IMPL(&((pMap)->real).base, key),        \
+        hashmapIsValid_IMPL)
+
+#define hashmapIterAll(pMap)                                                 \
+    CONT_ITER_RANGE(pMap, &hashmapIterRange_IMPL, NULL, NULL,                \
+        hashmapIsValid_IMPL)
+
+#define hashmapIterNext(pIt)                                                 \
+    hashmapIterNext_IMPL(&((pIt)->iter))
+
+void hashmapInit_IMPL(IntrusiveHashMap *pMap,
+                      PORT_MEM_ALLOCATOR *pAllocator, NvS32 nodeOffset);
+void hashmapDestroy_IMPL(HashMapBase *pMap);
+NV_STATUS hashmapReserve_IMPL(HashMapBase *pMap, NvU32 count);
+
+NvU32 hashmapCount_IMPL(HashMapBase *pMap);
+NvU64 hashmapKey_IMPL(HashMapBase *pMap, void *pValue);
+
+NvBool hashmapInsertExisting_IMPL(HashMapBase *pMap, NvU64 key, void *pValue);
+void hashmapRemove_IMPL(HashMapBase *pMap, void *pValue);
+void hashmapRemoveByKey_IMPL(HashMapBase *pMap, NvU64 key);
+
+void *hashmapFind_IMPL(HashMapBase *pMap, NvU64 key);
+
+NvBool hashmapIterNext_IMPL(HashMapIterBase *pIt);
+
+static NV_FORCEINLINE HashMapNode *
+hashmapValueToNode(HashMapBase *pMap, void *pValue)
+{
+    if (NULL == pMap) return NULL;
+    if (NULL == pValue) return NULL;
+    return (HashMapNode*)((NvU8*)pValue + pMap->nodeOffset);
+}
+
+static NV_FORCEINLINE void *
+hashmapNodeToValue(HashMapBase *pMap, HashMapNode *pNode)
+{
+    if (NULL == pMap) return NULL;
+    if (NULL == pNode) return NULL;
+    return (NvU8*)pNode - pMap->nodeOffset;
+}
+
+NvBool hashmapIsValid_IMPL(void *pMap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _NV_CONTAINERS_HASHMAP_H_
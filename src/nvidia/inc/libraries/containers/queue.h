@@ -120,6 +120,10 @@ typedef enum
     circularQueuePopAndCopyNonManaged_IMPL(&((pQueue)->real), pCtx,          \
         CONT_CHECK_ARG(pQueue, pCopyTo))
 
+#define queuePopAndCopyBatchNonManaged(pQueue, pCtx, pCopyTo, maxElements)   \
+    circularQueuePopAndCopyBatchNonManaged_IMPL(&((pQueue)->real), pCtx,     \
+        CONT_CHECK_ARG(pQueue, pCopyTo), maxElements)
+
 NV_STATUS circularQueueInit_IMPL(Queue *pQueue, PORT_MEM_ALLOCATOR *pAllocator,
                                  NvLength capacity, NvLength msgSize);
 NV_STATUS circularQueueInitNonManaged_IMPL(Queue *pQueue, NvLength capacity,
@@ -136,6 +140,8 @@ void circularQueuePop_IMPL(Queue *pQueue);
 NvBool circularQueuePopAndCopy_IMPL(Queue *pQueue, void *pCopyTo);
 NvBool circularQueuePopAndCopyNonManaged_IMPL(Queue *pQueue, QueueContext *pCtx,
                                               void *pCopyTo);
+NvLength circularQueuePopAndCopyBatchNonManaged_IMPL(Queue *pQueue, QueueContext *pCtx,
+                                                     void *pCopyTo, NvLength maxElements);
 
 NvBool circularQueueIsValid_IMPL(void *pQueue);
 
@@ -240,6 +240,7 @@ struct PORT_MEM_ALLOCATOR_TRACKING
 #if PORT_MEM_TRACK_USE_ALLOCLIST
     PORT_MEM_LIST                      *pFirstAlloc;
     void                               *listLock;
+    NvU32                               listSampleCount;
 #endif
 #if PORT_MEM_TRACK_USE_CALLERINFO
     PORT_MEM_CALLERINFO                 callerInfo;
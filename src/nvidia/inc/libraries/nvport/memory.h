@@ -887,6 +887,19 @@ void portMemExUnmapIOSpace(void *addr, NvU64 byteSize);
  */
 #define PORT_MEM_TRACK_USE_ALLOCLIST 0
 #endif
+#if !defined(PORT_MEM_TRACK_ALLOCLIST_SAMPLE_RATE)
+/**
+ * @brief Only keep 1 in N allocations on the allocation list.
+ *
+ * Counters still account for every allocation, so leaks are always detected;
+ * the list (and the caller info of its entries) describes a sample of them.
+ * Keeps the list lock off most alloc/free calls when leak tracking has to
+ * stay enabled under load.
+ * Has no effect unless PORT_MEM_TRACK_USE_ALLOCLIST is also set.
+ * Default is 1 (track every allocation).
+ */
+#define PORT_MEM_TRACK_ALLOCLIST_SAMPLE_RATE 1
+#endif
 #if !defined(PORT_MEM_TRACK_USE_CALLERINFO)
 /**
  * @brief Track file:line information for all allocations
@@ -151,6 +151,9 @@ typedef void *PUID_TOKEN;
 //
 #define RS_CLIENT_RESOURCE_WARNING_THRESHOLD 100000
 
+/// Number of slots in the per-client cache of handle lookups. Must be power of two
+#define RS_CLIENT_LOOKUP_CACHE_SIZE     64
+
 #define RS_CLIENT_HANDLE_MAX            0x100000 // Must be power of two
 #define RS_CLIENT_HANDLE_BUCKET_COUNT   0x400  // 1024
 #define RS_CLIENT_HANDLE_BUCKET_MASK    0x3FF
@@ -180,6 +183,7 @@ typedef void *PUID_TOKEN;
 #define RS_LOCK_STATE_ALLOW_RECURSIVE_RES_LOCK NVBIT(6)
 #define RS_LOCK_STATE_CLIENT_LOCK_ACQUIRED     NVBIT(7)
 #define RS_LOCK_STATE_SESSION_LOCK_ACQUIRED    NVBIT(8)
+#define RS_LOCK_STATE_CLIENT_LOCK_READ         NVBIT(9)
 
 /// RS_LOCK_RELEASE
 #define RS_LOCK_RELEASE_TOP_LOCK               NVBIT(0)
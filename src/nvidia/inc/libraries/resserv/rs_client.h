@@ -99,6 +99,13 @@ public:
      */
     RsRefMap resourceMap;
 
+    /**
+     * Direct-mapped cache of resourceMap lookups, indexed by the low bits of
+     * the handle. Generated handles are sequential, so the resources a
+     * client uses together rarely collide.
+     */
+    RsResourceRef *pLookupCache[RS_CLIENT_LOOKUP_CACHE_SIZE];
+
     /**
      * Access right back reference list of <hClient, hResource> pairs
      *
@@ -456,6 +456,7 @@ struct RsCpuMapping
     RsResourceRef *pContextRef;      ///< Context resource that may be needed for the mapping
     void *pContext;                  ///< Additional context data for the mapping
     NvU32 processId;
+    NvU32 refCount;                  ///< Additional map requests sharing this mapping, see serverMap
 
     RS_CPU_MAPPING_PRIVATE *pPrivate; ///< Opaque struct allocated and freed by resserv on behalf of the user
 };
@@ -477,6 +478,8 @@ struct RS_CPU_MAP_PARAMS
     // Passed from RM into CpuMapping
     NvU32                   protect;        ///< [in] Protection flags
     NvBool                  bKernel;
+    NvU32                   processId;      ///< [in] Process the mapping is made for
+    NvBool                  bShareable;     ///< [in] An identical existing mapping may be reused
 
     /// [in] hContext Handle of resource that provides a context for the mapping (e.g., subdevice for channel map)
     NvHandle hContext;
@@ -743,6 +746,18 @@ NV_STATUS refFindCpuMapping(RsResourceRef *pResourceRef, NvP64 pAddress, RsCpuMa
  */
 NV_STATUS refFindCpuMappingWithFilter(RsResourceRef *pResourceRef, NvP64 pAddress, NvBool (*fnFilter)(RsCpuMapping*), RsCpuMapping **ppMapping);
 
+/**
+ * Find a CPU mapping owned by a resource reference that can satisfy a new
+ * map request, i.e. one made for the same process and context with the same
+ * offset, length and flags.
+ *
+ * @param[in]   pResourceRef
+ * @param[in]   pParams The map request
+ * @param[in]   pContextRef The context resource of the map request
+ * @param[out]  ppMapping The returned mapping
+ */
+NV_STATUS refFindShareableCpuMapping(RsResourceRef *pResourceRef, RS_CPU_MAP_PARAMS *pParams, RsResourceRef *pContextRef, RsCpuMapping **ppMapping);
+
 /**
  * Find the first child object of given type
  *
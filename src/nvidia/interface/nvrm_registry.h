@@ -613,6 +613,34 @@
 #define NV_REG_STR_RM_STREAM_MEMOPS_ENABLE_NO       0
 
 
+//
+// Type DWORD: Meter the API and GPU locks
+//
+// Records acquire wait time histograms and hold times by acquiring call site
+// for the API lock and the GPU locks, printed when the RM locks are freed.
+//
+#define NV_REG_STR_RM_LOCK_METERING                                "RmLockMetering"
+#define NV_REG_STR_RM_LOCK_METERING_DISABLE                        (0x00000000)
+#define NV_REG_STR_RM_LOCK_METERING_ENABLE                         (0x00000001)
+
+//
+// Type DWORD: Period in ms of the checks that decide a GPU with runtime D3
+// enabled is idle. The GPU is powered down after about two periods without
+// use, and a GC6 cycle holds off the next one for one period.
+//
+#define NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS           "RmDynamicPowerIdleCheckPeriodMs"
+#define NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS_DEFAULT   (5000)
+#define NV_REG_STR_RM_DYNAMIC_POWER_IDLE_CHECK_PERIOD_MS_MIN       (10)
+
+//
+// Type DWORD: Shortest predicted idle period in ms for which runtime D3 uses
+// GCOFF. The idle period is predicted from the previous GC6/GCOFF residencies.
+// When a shorter one is predicted, GC6 is used when available, since its exit
+// does not restore video memory. 0 always prefers GCOFF.
+//
+#define NV_REG_STR_RM_DYNAMIC_POWER_GCOFF_MIN_IDLE_MS              "RmDynamicPowerGcoffMinIdleMs"
+#define NV_REG_STR_RM_DYNAMIC_POWER_GCOFF_MIN_IDLE_MS_DEFAULT      (2000)
+
 //
 // Type DWORD: Enable read-only RMAPI locks for select interfaces
 //
@@ -658,6 +686,21 @@
 #define NV_REG_STR_RM_READONLY_API_LOCK_CTRL_DISABLE              (0x00000000)
 #define NV_REG_STR_RM_READONLY_API_LOCK_CTRL_ENABLE               (0x00000001)
 
+//
+// Type DWORD: Enable read-only client locks for select interfaces
+//
+// Setting an interface to 1 lets calls of that interface that only read the
+// state of their client take the client lock for read, so threads calling
+// into the same client do not serialize against each other. Only controls
+// flagged RMCTRL_FLAGS_API_LOCK_READONLY are affected. The bit positions
+// match NV_REG_STR_RM_READONLY_API_LOCK.
+//
+#define NV_REG_STR_RM_READONLY_CLIENT_LOCK                         "RmRoClientLock"
+#define NV_REG_STR_RM_READONLY_CLIENT_LOCK_CTRL                    9:9
+#define NV_REG_STR_RM_READONLY_CLIENT_LOCK_CTRL_DEFAULT           (0x00000000)
+#define NV_REG_STR_RM_READONLY_CLIENT_LOCK_CTRL_DISABLE           (0x00000000)
+#define NV_REG_STR_RM_READONLY_CLIENT_LOCK_CTRL_ENABLE            (0x00000001)
+
 
 //
 // Type DWORD: Enable read-only RMAPI locks for select modules
@@ -699,6 +742,15 @@
 // RMCTRL cache mode defined in ctrl0000system.h
 #define NV_REG_STR_RM_CACHEABLE_CONTROLS             "RmEnableCacheableControls"
 
+// Type DWORD
+// Sample one in every N external RM controls and accumulate per-command log2
+// histograms of lock wait, local execution and GSP RPC wait time. The
+// histograms are printed when RM API is shut down.
+// 0 - Disabled (default)
+// N - Sample one in N controls
+#define NV_REG_STR_RM_CONTROL_LATENCY_SAMPLE_RATE    "RmControlLatencySampleRate"
+#define NV_REG_STR_RM_CONTROL_LATENCY_SAMPLE_RATE_DISABLE       0x00000000
+
 // Type DWORD
 // This regkey forces for Maxwell+ that on FB Unload we wait for FB pull before issuing the
 // L2 clean. WAR for bug 1032432
@@ -1023,6 +1075,20 @@
 #define NV_REG_STR_RM_CLIENT_RM_ALLOCATED_CTX_BUFFER_DISABLED   0x00000000
 #define NV_REG_STR_RM_CLIENT_RM_ALLOCATED_CTX_BUFFER_ENABLED    0x00000001
 
+//
+// Type: Dword
+// Number of idle, already reserved context buffer pools kept per heap (the
+// GPU heap, or the memory partition heap of each GPU instance) for channel
+// groups running on GR. Pools of freed channel groups are kept up to this
+// count, and after a channel group is created the cache is refilled to it
+// from a work item.
+// Encoding:
+// 0       - Disabled, pools are created and reserved for each channel group
+// 1 .. 16 - Number of pools to keep ready (default 2)
+//
+#define NV_REG_STR_RM_CTX_BUF_POOL_PREWARM                      "RmCtxBufPoolPrewarm"
+#define NV_REG_STR_RM_CTX_BUF_POOL_PREWARM_DEFAULT              2
+
 //
 // Type: Dword
 // Encoding:
@@ -1185,6 +1251,18 @@
 // "stuck."
 // Default - See INTR_STUCK_THRESHOLD
 
+#define NV_REG_STR_RM_NONSTALL_INTR_HOLDOFF_US   "RmNonStallIntrHoldoffUs"
+// Type DWORD
+// Encoding NvU32, microseconds
+// Enables moderation of non-stall (semaphore release / notification)
+// interrupts serviced in the locked bottom half. When two non-stall services
+// come closer together than this interval, the non-stall tree is left masked
+// and a hold-off timer services everything that latched in the meantime in
+// one batch once the interval has elapsed. This caps the non-stall service
+// rate at one per interval and bounds the added notification latency by it.
+// 0 (default) disables moderation.
+#define NV_REG_STR_RM_NONSTALL_INTR_HOLDOFF_US_DEFAULT   0x00000000
+
 
 #define NV_REG_PROCESS_NONSTALL_INTR_IN_LOCKLESS_ISR  "RMProcessNonStallIntrInLocklessIsr"
 
@@ -1220,6 +1298,16 @@
 #define NV_REG_STR_RM_WATCHDOG_INTERVAL_HI                    0x0000000C
 #define NV_REG_STR_RM_WATCHDOG_INTERVAL_DEFAULT               NV_REG_STR_RM_WATCHDOG_INTERVAL_LOW
 
+// Type Dword
+// Upper bound, in seconds, of the adaptive watchdog interval. While every
+// watchdog notifier comes back on time the interval doubles, starting from
+// RmWatchDogInterval, up to this value; a late notifier, a watchdog channel
+// error or a recovery drops it back to RmWatchDogInterval. Hang detection
+// latency is bounded by this value plus RmWatchDogTimeOut.
+// 0 (default) or any value not above RmWatchDogInterval keeps the interval fixed.
+#define NV_REG_STR_RM_WATCHDOG_INTERVAL_MAX                  "RmWatchDogIntervalMax"
+#define NV_REG_STR_RM_WATCHDOG_INTERVAL_MAX_DEFAULT           0x00000000
+
 #define NV_REG_STR_RM_DO_LOG_RC_EVENTS                      "RmLogonRC"
 // Type Dword
 // Encoding : 0 --> Skip Logging
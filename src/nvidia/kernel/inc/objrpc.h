@@ -54,8 +54,36 @@ typedef struct RpcHistoryEntry
 {
     NvU32 function;
     NvU32 data[3];
+
+    // Command queue sequence number the RPC was sent with
+    NvU32 seqNum;
+
+    // Command queue elements that were free when the RPC was queued
+    NvU32 cmdQueueFree;
+
+    // When the RPC was sent and when its response arrived (0 if none yet), in ns
+    NvU64 ts_start;
+    NvU64 ts_end;
 } RpcHistoryEntry;
 
+#define RPC_STATS_LATENCY_BUCKETS 24
+
+// Send-to-response latency of one RPC function, in log2 microsecond buckets
+typedef struct RpcFunctionStats
+{
+    NvU32 count;
+    NvU32 latencyUs[RPC_STATS_LATENCY_BUCKETS];
+    NvU64 maxNs;
+} RpcFunctionStats;
+
+// Copy of an unsolicited GSP event whose processing has been deferred
+typedef struct RpcDeferredEvent
+{
+    struct RpcDeferredEvent *pNext;
+    NvU32 length;
+    NvU8 message[];
+} RpcDeferredEvent;
+
 struct OBJRPC{
     OBJECT_BASE_DEFINITION(RPC);
 
@@ -82,6 +110,17 @@ struct OBJRPC{
     NvU32 timeoutCount;
     NvBool bQuietPrints;
 
+    // Indexed by RPC function, NULL if it could not be allocated
+    RpcFunctionStats *pFunctionStats;
+
+    //
+    // Events received while polling for an RPC reply that are processed later
+    // by a work item, in order. Protected by the GPU lock.
+    //
+    RpcDeferredEvent *pDeferredEventsHead;
+    RpcDeferredEvent *pDeferredEventsTail;
+    NvBool bDeferredEventsScheduled;
+
 };
 
 //
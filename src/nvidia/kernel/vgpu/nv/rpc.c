@@ -950,6 +950,18 @@ NV_STATUS rpcGpuExecRegOps_v12_01(OBJGPU *pGpu, OBJRPC *pRpc, NvHandle hClient,
         }
         rpc_message->gpu_exec_reg_ops_v12_01.params.reg_op_params.regOpCount = i;
 
+        //
+        // The operations array is variable length and not covered by the size
+        // passed to rpcWriteCommonHeader. Size each batch so the transport
+        // carries the operations it holds, and re-arm the result fields that
+        // the previous batch's reply overwrote.
+        //
+        vgpu_rpc_message_header_v->length = sizeof(rpc_message_header_v) +
+                                            sizeof(rpc_gpu_exec_reg_ops_v12_01) +
+                                            i * sizeof(NV2080_CTRL_GPU_REG_OP_v03_00);
+        vgpu_rpc_message_header_v->rpc_result         = NV_VGPU_MSG_RESULT_RPC_PENDING;
+        vgpu_rpc_message_header_v->rpc_result_private = NV_VGPU_MSG_RESULT_RPC_PENDING;
+
         status = _issueRpcAndWait(pGpu, pRpc);
 
         if (status == NV_OK)
@@ -969,6 +981,11 @@ NV_STATUS rpcGpuExecRegOps_v12_01(OBJGPU *pGpu, OBJRPC *pRpc, NvHandle hClient,
                 NV_PRINTF(LEVEL_ERROR,"RegOps RPC failed: skipping 0x%x regOps\n", pParams->regOpCount - regOpsExecuted);
             }
         }
+
+        // Don't let a later batch mask the failure of this one
+        if (status != NV_OK)
+            break;
+
         regOpsExecuted = j;
     }
 
@@ -1576,6 +1593,7 @@ NV_STATUS rpcRmApiControl_GSP
     NvU32 resCtrlFlags = NVOS54_FLAGS_NONE;
     NvBool bPreSerialized = NV_FALSE;
     void *pOriginalParams = pParamStructPtr;
+    NvU64 statsWaitStart;
 
     if (!rmDeviceGpuLockIsOwner(pGpu->gpuInstance))
     {
@@ -1698,6 +1716,7 @@ NV_STATUS rpcRmApiControl_GSP
     }
 
     // Issue RPC
+    statsWaitStart = rmapiControlStatsWaitBegin();
     if (large_message_copy)
     {
         status = _issueRpcAndWaitLarge(pGpu, pRpc, total_size, large_message_copy, NV_TRUE);
@@ -1706,6 +1725,7 @@ NV_STATUS rpcRmApiControl_GSP
     {
         status = _issueRpcAndWait(pGpu, pRpc);
     }
+    rmapiControlStatsWaitEnd(RMAPI_CONTROL_STATS_PHASE_RPC, statsWaitStart);
 
     //
     // At this point we have:
@@ -1973,6 +1993,10 @@ NV_STATUS rpcRmApiFree_GSP
     NV_STATUS status = NV_OK;
     NvU32 gpuMaskRelease = 0;
 
+    // The whole client was already freed on GSP-RM by a bulk client free
+    if (rmclientIsBulkFreedOnGpu(serverutilGetClientUnderLock(hClient), pGpu->gpuInstance))
+        return NV_OK;
+
     if (!rmDeviceGpuLockIsOwner(pGpu->gpuInstance))
     {
         NV_PRINTF(LEVEL_WARNING, "Calling RPC RmFree without adequate locks!\n");
@@ -0,0 +1,242 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//
+// Lock metering for the API lock and the GPU locks, enabled with
+// NV_REG_STR_RM_LOCK_METERING.
+//
+// For each lock this keeps a log2 (ns) histogram of the time spent blocked
+// acquiring it, and the hold time of each call site that acquired it, keyed
+// by the return address recorded in the lock trace. The hold times of
+// shared (read) API lock acquires are not metered, only exclusive ones.
+//
+
+#include "core/core.h"
+#include "core/locks.h"
+#include "nvrm_registry.h"
+#include "os/os.h"
+
+// Must be a power of 2
+#define RM_LOCK_METER_NUM_SITES     128
+#define RM_LOCK_METER_NUM_BUCKETS   32
+#define RM_LOCK_METER_TOP_SITES     8
+
+typedef struct
+{
+    NvUPtr callerRA;
+    NvU32  count;
+    NvU64  totalNs;
+    NvU64  maxNs;
+} RM_LOCK_METER_SITE;
+
+typedef struct
+{
+    volatile NvU32      waitBuckets[RM_LOCK_METER_NUM_BUCKETS];
+    RM_LOCK_METER_SITE  sites[RM_LOCK_METER_NUM_SITES];
+    NvU32               sitesDropped;
+} RM_LOCK_METER;
+
+static struct
+{
+    NvBool          bEnabled;
+    PORT_SPINLOCK  *pLock;
+    RM_LOCK_METER  *pMeters;
+} rmLockMeterInfo;
+
+static const char *rmLockMeterName[RM_LOCK_METER_COUNT] =
+{
+    "API lock",
+    "GPU locks",
+};
+
+void
+rmInitLockMetering(void)
+{
+    NvU32 data;
+
+    portMemSet(&rmLockMeterInfo, 0, sizeof(rmLockMeterInfo));
+
+    if ((osReadRegistryDword(NULL, NV_REG_STR_RM_LOCK_METERING, &data) != NV_OK) ||
+        (data == NV_REG_STR_RM_LOCK_METERING_DISABLE))
+    {
+        return;
+    }
+
+    rmLockMeterInfo.pMeters = portMemAllocNonPaged(sizeof(RM_LOCK_METER) * RM_LOCK_METER_COUNT);
+    if (rmLockMeterInfo.pMeters == NULL)
+        return;
+    portMemSet(rmLockMeterInfo.pMeters, 0, sizeof(RM_LOCK_METER) * RM_LOCK_METER_COUNT);
+
+    rmLockMeterInfo.pLock = portSyncSpinlockCreate(portMemAllocatorGetGlobalNonPaged());
+    if (rmLockMeterInfo.pLock == NULL)
+    {
+        portMemFree(rmLockMeterInfo.pMeters);
+        rmLockMeterInfo.pMeters = NULL;
+        return;
+    }
+
+    rmLockMeterInfo.bEnabled = NV_TRUE;
+}
+
+void
+rmDestroyLockMetering(void)
+{
+    if (!rmLockMeterInfo.bEnabled)
+        return;
+
+    rmLockMeterDump();
+
+    rmLockMeterInfo.bEnabled = NV_FALSE;
+    portSyncSpinlockDestroy(rmLockMeterInfo.pLock);
+    portMemFree(rmLockMeterInfo.pMeters);
+    rmLockMeterInfo.pMeters = NULL;
+}
+
+NvU64
+rmLockMeterTimestamp(void)
+{
+    NvU64 ts;
+
+    if (!rmLockMeterInfo.bEnabled)
+        return 0;
+
+    osGetPerformanceCounter(&ts);
+    return ts;
+}
+
+void
+rmLockMeterRecordWait(RM_LOCK_METER_ID id, NvU64 startTs)
+{
+    NvU64 ns;
+    NvU32 bucket;
+
+    if (!rmLockMeterInfo.bEnabled || (startTs == 0))
+        return;
+
+    osGetPerformanceCounter(&ns);
+    ns -= startTs;
+
+    bucket = NV_MIN(64 - portUtilCountLeadingZeros64(ns), RM_LOCK_METER_NUM_BUCKETS - 1);
+    portAtomicIncrementU32(&rmLockMeterInfo.pMeters[id].waitBuckets[bucket]);
+}
+
+void
+rmLockMeterRecordHold(RM_LOCK_METER_ID id, NvUPtr callerRA, NvU64 acquireTs)
+{
+    RM_LOCK_METER *pMeter;
+    NvU64 ns;
+    NvU32 hash;
+    NvU32 i;
+
+    if (!rmLockMeterInfo.bEnabled || (acquireTs == 0))
+        return;
+
+    osGetPerformanceCounter(&ns);
+    ns -= acquireTs;
+
+    pMeter = &rmLockMeterInfo.pMeters[id];
+    hash = (NvU32)(callerRA ^ (callerRA >> 17)) * 0x9E3779B1;
+
+    portSyncSpinlockAcquire(rmLockMeterInfo.pLock);
+
+    for (i = 0; i < RM_LOCK_METER_NUM_SITES; i++)
+    {
+        RM_LOCK_METER_SITE *pSite =
+            &pMeter->sites[(hash + i) & (RM_LOCK_METER_NUM_SITES - 1)];
+
+        if (pSite->count == 0)
+            pSite->callerRA = callerRA;
+        else if (pSite->callerRA != callerRA)
+            continue;
+
+        pSite->count++;
+        pSite->totalNs += ns;
+        pSite->maxNs = NV_MAX(pSite->maxNs, ns);
+        break;
+    }
+
+    if (i == RM_LOCK_METER_NUM_SITES)
+        pMeter->sitesDropped++;
+
+    portSyncSpinlockRelease(rmLockMeterInfo.pLock);
+}
+
+void
+rmLockMeterDump(void)
+{
+    NvU32 id;
+
+    if (!rmLockMeterInfo.bEnabled)
+        return;
+
+    for (id = 0; id < RM_LOCK_METER_COUNT; id++)
+    {
+        RM_LOCK_METER *pMeter = &rmLockMeterInfo.pMeters[id];
+        RM_LOCK_METER_SITE top[RM_LOCK_METER_TOP_SITES];
+        NvU32 numTop = 0;
+        NvU32 bucket;
+        NvU32 i;
+        NvU32 j;
+
+        NV_PRINTF(LEVEL_NOTICE, "%s acquire wait:\n", rmLockMeterName[id]);
+        for (bucket = 0; bucket < RM_LOCK_METER_NUM_BUCKETS; bucket++)
+        {
+            if (pMeter->waitBuckets[bucket] == 0)
+                continue;
+
+            NV_PRINTF(LEVEL_NOTICE, "    < 2^%u ns: %u\n", bucket, pMeter->waitBuckets[bucket]);
+        }
+
+        // Keep the call sites with the largest total hold time, sorted
+        portSyncSpinlockAcquire(rmLockMeterInfo.pLock);
+        for (i = 0; i < RM_LOCK_METER_NUM_SITES; i++)
+        {
+            RM_LOCK_METER_SITE *pSite = &pMeter->sites[i];
+
+            if (pSite->count == 0)
+                continue;
+
+            for (j = numTop; j > 0 && top[j - 1].totalNs < pSite->totalNs; j--)
+            {
+                if (j < RM_LOCK_METER_TOP_SITES)
+                    top[j] = top[j - 1];
+            }
+
+            if (j < RM_LOCK_METER_TOP_SITES)
+            {
+                top[j] = *pSite;
+                numTop = NV_MIN(numTop + 1, RM_LOCK_METER_TOP_SITES);
+            }
+        }
+        portSyncSpinlockRelease(rmLockMeterInfo.pLock);
+
+        NV_PRINTF(LEVEL_NOTICE, "%s top holders (%u sites dropped):\n",
+                  rmLockMeterName[id], pMeter->sitesDropped);
+        for (i = 0; i < numTop; i++)
+        {
+            NV_PRINTF(LEVEL_NOTICE, "    %p: %u holds, total %llu ns, avg %llu ns, max %llu ns\n",
+                      (void *)top[i].callerRA, top[i].count, top[i].totalNs,
+                      top[i].totalNs / top[i].count, top[i].maxNs);
+        }
+    }
+}
@@ -40,6 +40,7 @@
 #include "kernel/gpu/intr/intr.h"
 #include <gpu/bif/kernel_bif.h>
 #include "gpu/disp/kern_disp.h"
+#include "rmapi/rmapi.h"
 
 //
 // GPU lock
@@ -58,6 +59,8 @@ typedef struct
     NvU16               priority;
     NvU16               priorityPrev;
     NvU64               timestamp;
+    NvUPtr              meterCallerRA;
+    NvU64               meterAcquireTs;
 } GPULOCK;
 
 //
@@ -483,6 +486,8 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
     NvU64     priority = 0;
     NvU64     priorityPrev = 0;
     NvU64     timestamp;
+    NvU64     statsWaitStart;
+    NvU64     meterWaitStart;
     NvBool    bLockAll = NV_FALSE;
 
     bHighIrql = (portSyncExSafeToSleep() == NV_FALSE);
@@ -688,7 +693,11 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
             do
             {
                 portSyncSpinlockRelease(rmGpuLockInfo.pLock);
+                statsWaitStart = rmapiControlStatsWaitBegin();
+                meterWaitStart = rmLockMeterTimestamp();
                 portSyncSemaphoreAcquire(pGpuLock->pWaitSema);
+                rmLockMeterRecordWait(RM_LOCK_METER_GPU_LOCK, meterWaitStart);
+                rmapiControlStatsWaitEnd(RMAPI_CONTROL_STATS_PHASE_LOCK, statsWaitStart);
                 portSyncSpinlockAcquire(rmGpuLockInfo.pLock);
 
                 if ((rmGpuLockInfo.gpusLockableMask & NVBIT(gpuInst)) == 0)
@@ -739,6 +748,8 @@ _rmGpuLocksAcquire(NvU32 gpuMask, NvU32 flags, NvU32 module, void *ra, NvU32 *pG
         pGpuLock->priority = priority;
         pGpuLock->priorityPrev = priorityPrev;
         pGpuLock->timestamp = timestamp;
+        pGpuLock->meterCallerRA = (NvUPtr)ra;
+        pGpuLock->meterAcquireTs = rmLockMeterTimestamp();
 
 next_gpu_instance:
         ;
@@ -1319,6 +1330,10 @@ _rmGpuLocksRelease(NvU32 gpuMask, NvU32 flags, OBJGPU *pDpcGpu, void *ra)
             // now enable interrupts
             _gpuLocksReleaseEnableInterrupts(gpuInst, flags);
 
+            rmLockMeterRecordHold(RM_LOCK_METER_GPU_LOCK, pGpuLock->meterCallerRA,
+                                  pGpuLock->meterAcquireTs);
+            pGpuLock->meterAcquireTs = 0;
+
             // indicate that the API is not running
             NV_ASSERT(pGpuLock->threadId == threadId);
             pGpuLock->bRunning = NV_FALSE;
@@ -35,6 +35,7 @@
 #include "os/os.h"
 #include "nvrm_registry.h"
 #include "core/thread_state.h"
+#include "gpu/mem_mgr/mem_desc.h"
 #include "diagnostics/tracer.h"
 #include "rmosxfac.h"
 #include "tls/tls.h"
@@ -146,6 +147,10 @@ sysConstruct_IMPL(OBJSYS *pSys)
     if (status != NV_OK)
         goto failed;
 
+    status = memdescCacheInit();
+    if (status != NV_OK)
+        goto failed;
+
     status = rmapiInitialize();
     if (status != NV_OK)
         goto failed;
@@ -157,6 +162,7 @@ failed:
 
     g_pSys = NULL;
 
+    memdescCacheDestroy();
     threadStateGlobalFree();
 
     rmapiShutdown();
@@ -178,6 +184,7 @@ sysDestruct_IMPL(OBJSYS *pSys)
 
     rmapiShutdown();
     osSyncWithRmDestroy();
+    memdescCacheDestroy();
     threadStateGlobalFree();
     rmLocksFree(pSys);
 
@@ -312,6 +319,15 @@ _sysRegistryOverrideResourceServer
         pSys->apiLockMask = NVBIT(RS_API_CTRL);
     }
 
+    // Set read-only client lock override
+    pSys->clientLockMask = 0;
+    if (osReadRegistryDword(pGpu, NV_REG_STR_RM_READONLY_CLIENT_LOCK,
+                            &data32) == NV_OK)
+    {
+        if (FLD_TEST_DRF(_REG_STR_RM, _READONLY_CLIENT_LOCK, _CTRL, _ENABLE, data32))
+            pSys->clientLockMask |= NVBIT(RS_API_CTRL);
+    }
+
     if (osReadRegistryDword(pGpu, NV_REG_STR_RM_READONLY_API_LOCK_MODULE,
                             &data32) == NV_OK)
     {
@@ -692,6 +708,7 @@ sysApplyLockingPolicy_IMPL(OBJSYS *pSys)
 {
     g_resServ.bRouteToPhysicalLockBypass = pSys->getProperty(pSys, PDB_PROP_SYS_ROUTE_TO_PHYSICAL_LOCK_BYPASS);
     g_resServ.roTopLockApiMask = pSys->apiLockMask;
+    g_resServ.roClientLockApiMask = pSys->clientLockMask;
 }
 
 NV_STATUS
@@ -47,6 +47,8 @@
 
 THREAD_STATE_DB threadStateDatabase;
 
+static void _threadNodeInitDeferredTime(THREAD_STATE_NODE *pThreadNode);
+
 static void _threadStatePrintInfo(THREAD_STATE_NODE *pThreadNode)
 {
     if ((threadStateDatabase.setupFlags & THREAD_STATE_SETUP_FLAGS_PRINT_INFO_ENABLED) == 0)
@@ -261,6 +263,8 @@ void threadStateYieldCpuIfNecessary(OBJGPU *pGpu, NvBool bQuiet)
     rmStatus = threadStateGetCurrent(&pThreadNode, pGpu);
     if ((rmStatus == NV_OK) && pThreadNode )
     {
+        _threadNodeInitDeferredTime(pThreadNode);
+
         osGetCurrentTick(&timeInNs);
         if (timeInNs >= pThreadNode->timeout.nextCpuYieldTime)
         {
@@ -274,7 +278,7 @@ void threadStateYieldCpuIfNecessary(OBJGPU *pGpu, NvBool bQuiet)
     }
 }
 
-static NV_STATUS _threadNodeInitTime(THREAD_STATE_NODE *pThreadNode)
+static NV_STATUS _threadNodeInitTime(THREAD_STATE_NODE *pThreadNode, NvBool bFromEnterTime)
 {
     NV_STATUS rmStatus = NV_OK;
     NvU64 timeInNs;
@@ -310,7 +314,14 @@ static NV_STATUS _threadNodeInitTime(THREAD_STATE_NODE *pThreadNode)
         nonComputeTimeoutMsecs = 500;
     }
 
-    osGetCurrentTick(&timeInNs);
+    //
+    // A deferred first init computes the limits from the time the thread
+    // entered the RM, so the time spent before the first wait still counts.
+    //
+    if (bFromEnterTime && !firstInit)
+        timeInNs = pThreadNode->timeout.enterTime;
+    else
+        osGetCurrentTick(&timeInNs);
 
     if (firstInit)
     {
@@ -371,6 +382,21 @@ static NV_STATUS _threadNodeInitTime(THREAD_STATE_NODE *pThreadNode)
     return rmStatus;
 }
 
+//
+// Regular threads only record their entry time in threadStateInit(). The
+// timeout limits are computed here the first time the thread waits on one.
+//
+static void _threadNodeInitDeferredTime(THREAD_STATE_NODE *pThreadNode)
+{
+    if (!(pThreadNode->flags & THREAD_STATE_FLAGS_TIMEOUT_DEFERRED))
+        return;
+
+    pThreadNode->flags &= ~THREAD_STATE_FLAGS_TIMEOUT_DEFERRED;
+
+    if (_threadNodeInitTime(pThreadNode, NV_TRUE) == NV_OK)
+        pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
+}
+
 static void _getTimeoutDataFromGpuMode(
     OBJGPU *pGpu,
     THREAD_STATE_NODE *pThreadNode,
@@ -541,9 +567,12 @@ void threadStateInit(THREAD_STATE_NODE *pThreadNode, NvU32 flags)
     listInit(&pThreadNode->cbList, portMemAllocatorGetGlobalNonPaged());
     pThreadNode->flags |= THREAD_STATE_FLAGS_STATE_FREE_CB_ENABLED;
 
-    rmStatus = _threadNodeInitTime(pThreadNode);
-    if (rmStatus == NV_OK)
-        pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
+    //
+    // Most control calls never wait on a timeout, so only record the entry
+    // time here and leave the rest to _threadNodeInitDeferredTime().
+    //
+    osGetCurrentTick(&pThreadNode->timeout.enterTime);
+    pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_DEFERRED;
 
     rmStatus = osGetCurrentThread(&pThreadNode->threadId);
     if (rmStatus != NV_OK)
@@ -628,7 +657,7 @@ void threadStateInitISRAndDeferredIntHandler
     pThreadNode->cpuNum = osGetCurrentProcessorNumber();
     pThreadNode->flags = flags;
 
-    rmStatus = _threadNodeInitTime(pThreadNode);
+    rmStatus = _threadNodeInitTime(pThreadNode, NV_FALSE);
 
     if (rmStatus == NV_OK)
         pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
@@ -678,7 +707,7 @@ void threadStateInitISRLockless(THREAD_STATE_NODE *pThreadNode, OBJGPU *pGpu, Nv
     pThreadNode->cpuNum = osGetCurrentProcessorNumber();
     pThreadNode->flags = flags;
 
-    rmStatus = _threadNodeInitTime(pThreadNode);
+    rmStatus = _threadNodeInitTime(pThreadNode, NV_FALSE);
     if (rmStatus == NV_OK)
         pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
 
@@ -809,6 +838,7 @@ void threadStateFree(THREAD_STATE_NODE *pThreadNode, NvU32 flags)
 
     if (threadStateDatabase.setupFlags & THREAD_STATE_SETUP_FLAGS_CHECK_TIMEOUT_AT_FREE_ENABLED)
     {
+        _threadNodeInitDeferredTime(pThreadNode);
         rmStatus = _threadNodeCheckTimeout(NULL /*pGpu*/, pThreadNode, NULL /*pElapsedTimeUs*/);
         NV_ASSERT(rmStatus == NV_OK);
     }
@@ -986,9 +1016,11 @@ static NV_STATUS _threadStateGet
         }
     }
 
-    // Try the Preempted list first before trying the API list
+    // Try the Preempted list first before trying the API list. It is almost always empty.
     portSyncSpinlockAcquire(threadStateDatabase.spinlock);
-    pNode = mapFind(&threadStateDatabase.dbRootPreempted, (NvU64) threadId);
+    pNode = NULL;
+    if (mapCount(&threadStateDatabase.dbRootPreempted) != 0)
+        pNode = mapFind(&threadStateDatabase.dbRootPreempted, (NvU64) threadId);
     if (pNode == NULL)
     {
         // Not found on the Preempted, try the API list
@@ -1119,7 +1151,8 @@ NV_STATUS threadStateResetTimeout(OBJGPU *pGpu)
     if ((rmStatus == NV_OK) && pThreadNode )
     {
         // Reset the timeout
-        rmStatus = _threadNodeInitTime(pThreadNode);
+        pThreadNode->flags &= ~THREAD_STATE_FLAGS_TIMEOUT_DEFERRED;
+        rmStatus = _threadNodeInitTime(pThreadNode, NV_FALSE);
         if (rmStatus == NV_OK)
         {
             pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
@@ -1180,6 +1213,8 @@ NV_STATUS threadStateCheckTimeout(OBJGPU *pGpu, NvU64 *pElapsedTimeUs)
     rmStatus = threadStateGetCurrent(&pThreadNode, pGpu);
     if ((rmStatus == NV_OK) && pThreadNode )
     {
+        _threadNodeInitDeferredTime(pThreadNode);
+
         if (pThreadNode->flags & THREAD_STATE_FLAGS_TIMEOUT_INITED)
         {
             rmStatus = _threadNodeCheckTimeout(pGpu, pThreadNode, pElapsedTimeUs);
@@ -1202,6 +1237,16 @@ void threadStateSetTimeoutOverride(THREAD_STATE_NODE *pThreadNode, NvU64 newTime
 
     pThreadNode->timeout.overrideTimeoutMsecs = newTimeoutMs;
 
+    //
+    // The override replaces the limits, so a pending deferred init only has
+    // to mark them valid.
+    //
+    if (pThreadNode->flags & THREAD_STATE_FLAGS_TIMEOUT_DEFERRED)
+    {
+        pThreadNode->flags &= ~THREAD_STATE_FLAGS_TIMEOUT_DEFERRED;
+        pThreadNode->flags |= THREAD_STATE_FLAGS_TIMEOUT_INITED;
+    }
+
     osGetCurrentTick(&timeInNs);
 
     _threadStateSetNextCpuYieldTime(pThreadNode);
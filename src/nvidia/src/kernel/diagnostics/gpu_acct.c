@@ -25,8 +25,6 @@
 #include "diagnostics/gpu_acct.h"
 #include "objtmr.h"
 #include "kernel/gpu/mig_mgr/kernel_mig_manager.h"
-#include "containers/map.h"
-#include "containers/list.h"
 #include "ctrl/ctrl0000/ctrl0000gpuacct.h"
 #include "ctrl/ctrl0000/ctrl0000gpu.h" // NV0000_CTRL_GPU_MAX_ATTACHED_GPUS
 #include "virtualization/hypervisor/hypervisor.h"
@@ -35,11 +33,10 @@
 
 static NV_STATUS gpuacctInitState(GpuAccounting *);
 static NvU64 gpuacctGetCurrTime(void);
-static NV_STATUS gpuacctAddProcEntry(GPU_ACCT_PROC_DATA_STORE *, GPUACCT_PROC_ENTRY *, NvBool);
+static NV_STATUS gpuacctAddProcEntry(GPU_ACCT_PROC_DATA_STORE *, const GPUACCT_PROC_ENTRY *, NvBool, GPUACCT_PROC_ENTRY **);
 static NV_STATUS gpuacctRemoveProcEntry(GPU_ACCT_PROC_DATA_STORE *, GPUACCT_PROC_ENTRY *);
 static NV_STATUS gpuacctLookupProcEntry(GPU_ACCT_PROC_DATA_STORE *, NvU32, GPUACCT_PROC_ENTRY **);
 static NV_STATUS gpuacctAllocProcEntry(GPU_ACCT_PROC_DATA_STORE *, NvU32, NvU32, GPUACCT_PROC_ENTRY **);
-static NV_STATUS gpuacctFreeProcEntry(GPU_ACCT_PROC_DATA_STORE *, GPUACCT_PROC_ENTRY *);
 static NV_STATUS gpuacctCleanupDataStore(GPU_ACCT_PROC_DATA_STORE *);
 static NV_STATUS gpuacctDestroyDataStore(GPU_ACCT_PROC_DATA_STORE *);
 static NV_STATUS gpuacctInitDataStore(GPU_ACCT_PROC_DATA_STORE *);
@@ -47,6 +44,9 @@ static NV_STATUS gpuacctStartTimerCallbacks(OBJGPU *, GPUACCT_GPU_INSTANCE_INFO
 static void gpuacctStopTimerCallbacks(OBJGPU *, GPUACCT_GPU_INSTANCE_INFO *);
 static NV_STATUS gpuacctSampleGpuUtil(OBJGPU *, OBJTMR *, TMR_EVENT *);
 
+// Initial number of slots of a data store table, must be a power of 2.
+#define GPUACCT_PROC_TABLE_MIN_SIZE     32
+
 /*!
  * Constrcutor for gpu accounting class.
  *
@@ -73,6 +73,9 @@ gpuacctConstruct_IMPL
 /*!
  * Initializes the data store.
  *
+ * @note The table of the data store is only allocated when the first entry
+ * is added to it.
+ *
  * @param[in]  pDS       Pointer to data store.
  *
  * @return  NV_OK
@@ -85,8 +88,7 @@ gpuacctInitDataStore
 {
     NV_STATUS status = NV_OK;
 
-    mapInitIntrusive(&pDS->procMap);
-    listInitIntrusive(&pDS->procList);
+    portMemSet(pDS, 0, sizeof(*pDS));
 
     return status;
 }
@@ -156,16 +158,10 @@ gpuacctCleanupDataStore
 {
     NV_ASSERT_OR_RETURN(pDS != NULL, NV_ERR_INVALID_ARGUMENT);
 
-    for (GPU_ACCT_PROC_LISTIter iter = listIterAll(&pDS->procList);
-         listIterNext(&iter);
-         iter = listIterAll(&pDS->procList))
-    {
-        GPUACCT_PROC_ENTRY *pEntry = iter.pValue;
-        if (pEntry)
-        {
-            gpuacctFreeProcEntry(pDS, pEntry);
-        }
-    }
+    portMemFree(pDS->pEntries);
+    pDS->pEntries  = NULL;
+    pDS->tableSize = 0;
+    pDS->count     = 0;
 
     return NV_OK;
 }
@@ -187,9 +183,6 @@ gpuacctDestroyDataStore
 
     NV_ASSERT_OR_RETURN(status == NV_OK, status);
 
-    mapDestroy(&pDS->procMap);
-    listDestroy(&pDS->procList);
-
     return NV_OK;
 }
 
@@ -213,83 +206,125 @@ void gpuacctDestruct_IMPL
 }
 
 /*!
- * Allocates an entry for a process and push it in the data store.
+ * Returns the home slot of a pid in a data store table.
  *
- * @param[in]  pDS       Pointer to data store where process entry is to be added.
+ * @param[in]  pDS       Pointer to data store, with a table allocated.
+ * @param[in]  pid       PID of the process.
+ */
+static NvU32
+gpuacctHashPid
+(
+    GPU_ACCT_PROC_DATA_STORE *pDS,
+    NvU32 pid
+)
+{
+    return ((pid ^ (pid >> 16)) * 0x45d9f3b) & (pDS->tableSize - 1);
+}
+
+/*!
+ * Finds the slot holding the entry of a pid, or the free slot where it
+ * would be added.
+ *
+ * @param[in]  pDS       Pointer to data store, with a table allocated.
  * @param[in]  pid       PID of the process.
- * @param[in]  procType  Type of the process.
- * @param[out] ppEntry   Pointer to process entry.
+ *
+ * @return  Index of the slot.
+ */
+static NvU32
+gpuacctFindSlot
+(
+    GPU_ACCT_PROC_DATA_STORE *pDS,
+    NvU32 pid
+)
+{
+    NvU32 mask = pDS->tableSize - 1;
+    NvU32 i = gpuacctHashPid(pDS, pid);
+
+    // The table is never full, so this always finds a free slot.
+    while ((pDS->pEntries[i].addSeq != 0) && (pDS->pEntries[i].procId != pid))
+    {
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+/*!
+ * Doubles the number of slots of a data store table.
+ *
+ * @param[in]  pDS       Pointer to data store.
  *
  * @return  NV_OK
- * @return  Other
- *     Bubbles up errors from:
- *         * portMemAllocNonPaged
- *         * gpuacctAddProcEntry
+ * @return  NV_ERR_NO_MEMORY
  */
 static NV_STATUS
-gpuacctAllocProcEntry
+gpuacctGrowDataStore
 (
-    GPU_ACCT_PROC_DATA_STORE *pDS,
-    NvU32 pid,
-    NvU32 procType,
-    GPUACCT_PROC_ENTRY **ppEntry
+    GPU_ACCT_PROC_DATA_STORE *pDS
 )
 {
-    GPUACCT_PROC_ENTRY *pEntry;
-    NV_STATUS status;
+    GPUACCT_PROC_ENTRY *pOldEntries = pDS->pEntries;
+    NvU32 oldTableSize = pDS->tableSize;
+    NvU32 tableSize;
+    NvU32 i;
 
-    NV_ASSERT_OR_RETURN(ppEntry != NULL, NV_ERR_INVALID_ARGUMENT);
-    *ppEntry = NULL;
+    tableSize = (oldTableSize != 0) ? (oldTableSize * 2) : GPUACCT_PROC_TABLE_MIN_SIZE;
 
-    pEntry = portMemAllocNonPaged(sizeof(GPUACCT_PROC_ENTRY));
-    if (pEntry == NULL)
+    pDS->pEntries = portMemAllocNonPaged(tableSize * sizeof(GPUACCT_PROC_ENTRY));
+    if (pDS->pEntries == NULL)
     {
+        pDS->pEntries = pOldEntries;
         return NV_ERR_NO_MEMORY;
     }
-    portMemSet(pEntry, 0, sizeof(GPUACCT_PROC_ENTRY));
+    portMemSet(pDS->pEntries, 0, tableSize * sizeof(GPUACCT_PROC_ENTRY));
+    pDS->tableSize = tableSize;
 
-    pEntry->procId = pid;
-    pEntry->procType = procType;
-
-    status = gpuacctAddProcEntry(pDS, pEntry, NV_TRUE);
-    if (status != NV_OK)
+    for (i = 0; i < oldTableSize; i++)
     {
-        goto out;
+        if (pOldEntries[i].addSeq != 0)
+        {
+            pDS->pEntries[gpuacctFindSlot(pDS, pOldEntries[i].procId)] = pOldEntries[i];
+        }
     }
 
-    *ppEntry = pEntry;
+    portMemFree(pOldEntries);
 
-out:
-    if (status != NV_OK)
-    {
-        portMemFree(pEntry);
-    }
-    return status;
+    return NV_OK;
 }
 
 /*!
- * Frees a process entry from the data store.
+ * Allocates an entry for a process and push it in the data store.
  *
- * @param[in]  pDS       Pointer to data store where process entry is stored.
- * @param[in]  pEntry    Pointer to process entry.
+ * @param[in]  pDS       Pointer to data store where process entry is to be added.
+ * @param[in]  pid       PID of the process.
+ * @param[in]  procType  Type of the process.
+ * @param[out] ppEntry   Pointer to process entry.
  *
  * @return  NV_OK
- * @return  NV_ERR_INVALID_ARGUMENT
+ * @return  Other
+ *     Bubbles up errors from:
+ *         * gpuacctAddProcEntry
  */
 static NV_STATUS
-gpuacctFreeProcEntry
+gpuacctAllocProcEntry
 (
     GPU_ACCT_PROC_DATA_STORE *pDS,
-    GPUACCT_PROC_ENTRY *pEntry
+    NvU32 pid,
+    NvU32 procType,
+    GPUACCT_PROC_ENTRY **ppEntry
 )
 {
-    NV_STATUS status = gpuacctRemoveProcEntry(pDS, pEntry);
+    GPUACCT_PROC_ENTRY entry;
 
-    NV_ASSERT_OR_RETURN(status == NV_OK, status);
+    NV_ASSERT_OR_RETURN(ppEntry != NULL, NV_ERR_INVALID_ARGUMENT);
+    *ppEntry = NULL;
 
-    portMemFree(pEntry);
+    portMemSet(&entry, 0, sizeof(entry));
 
-    return NV_OK;
+    entry.procId = pid;
+    entry.procType = procType;
+
+    return gpuacctAddProcEntry(pDS, &entry, NV_TRUE, ppEntry);
 }
 
 /*!
@@ -310,10 +345,21 @@ gpuacctLookupProcEntry
     GPUACCT_PROC_ENTRY **ppEntry
 )
 {
+    GPUACCT_PROC_ENTRY *pEntry;
+
     NV_ASSERT_OR_RETURN(ppEntry != NULL, NV_ERR_INVALID_ARGUMENT);
     *ppEntry = NULL;
 
-    *ppEntry = (GPUACCT_PROC_ENTRY *)mapFind(&pDS->procMap, pid);
+    if (pDS->pEntries == NULL)
+    {
+        return NV_OK;
+    }
+
+    pEntry = &pDS->pEntries[gpuacctFindSlot(pDS, pid)];
+    if (pEntry->addSeq != 0)
+    {
+        *ppEntry = pEntry;
+    }
 
     return NV_OK;
 }
@@ -321,6 +367,9 @@ gpuacctLookupProcEntry
 /*!
  * Removes a process entry from the data store.
  *
+ * @note The entries following the removed one in its probe sequence are
+ * shifted back, so that lookups never need to skip deleted slots.
+ *
  * @param[in]  pDS       Pointer to data store where process entry is stored.
  * @param[in]  pEntry    Pointer to process entry.
  *
@@ -334,62 +383,135 @@ gpuacctRemoveProcEntry
     GPUACCT_PROC_ENTRY *pEntry
 )
 {
+    NvU32 mask;
+    NvU32 hole;
+    NvU32 i;
+
     NV_ASSERT_OR_RETURN(pDS != NULL, NV_ERR_INVALID_ARGUMENT);
     NV_ASSERT_OR_RETURN(pEntry != NULL, NV_ERR_INVALID_ARGUMENT);
+    NV_ASSERT_OR_RETURN((pEntry >= pDS->pEntries) &&
+                        (pEntry < pDS->pEntries + pDS->tableSize),
+                        NV_ERR_INVALID_ARGUMENT);
 
-    mapRemove(&pDS->procMap, pEntry);
-    listRemove(&pDS->procList, pEntry);
+    mask = pDS->tableSize - 1;
+    hole = (NvU32)(pEntry - pDS->pEntries);
+
+    for (i = (hole + 1) & mask; pDS->pEntries[i].addSeq != 0; i = (i + 1) & mask)
+    {
+        NvU32 home = gpuacctHashPid(pDS, pDS->pEntries[i].procId);
+
+        // Move the entry into the hole unless the hole is before its home slot.
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            pDS->pEntries[hole] = pDS->pEntries[i];
+            hole = i;
+        }
+    }
+
+    portMemSet(&pDS->pEntries[hole], 0, sizeof(GPUACCT_PROC_ENTRY));
+    pDS->count--;
 
     return NV_OK;
 }
 
 /*!
- * Adds a process entry in the data store.
+ * Adds a copy of a process entry in the data store.
  *
- * @note If data store is full, the entry at the head will be removed and freed.
+ * @note If data store is full, the oldest entry will be removed.
  *
- * @param[in]  pDS       Pointer to data store where process entry will be added.
- * @param[in]  pEntry    Pointer to process entry.
+ * @param[in]  pDS              Pointer to data store where process entry will be added.
+ * @param[in]  pEntry           Pointer to process entry to copy.
+ * @param[in]  isLiveProcEntry  Whether pDS holds live processes.
+ * @param[out] ppEntry          Pointer to the added entry, optional.
  *
  * @return  NV_OK
+ * @return  NV_ERR_INSERT_DUPLICATE_NAME
+ * @return  Other
+ *     Bubbles up errors from:
+ *         * gpuacctGrowDataStore
  */
 static NV_STATUS
 gpuacctAddProcEntry
 (
     GPU_ACCT_PROC_DATA_STORE *pDS,
-    GPUACCT_PROC_ENTRY *pEntry,
-    NvBool isLiveProcEntry
+    const GPUACCT_PROC_ENTRY *pEntry,
+    NvBool isLiveProcEntry,
+    GPUACCT_PROC_ENTRY **ppEntry
 )
 {
     NvU32 maxProcLimit;
-    GPUACCT_PROC_ENTRY *pOldEntry;
+    GPUACCT_PROC_ENTRY *pNewEntry;
+    NV_STATUS status;
 
     NV_ASSERT_OR_RETURN(pDS != NULL, NV_ERR_INVALID_ARGUMENT);
     NV_ASSERT_OR_RETURN(pEntry != NULL, NV_ERR_INVALID_ARGUMENT);
 
     maxProcLimit = isLiveProcEntry ? NV_MAX_LIVE_ACCT_PROCESS : NV_MAX_DEAD_ACCT_PROCESS;
 
-    if (listCount(&pDS->procList) >= maxProcLimit)
+    if (pDS->count >= maxProcLimit)
     {
-        pOldEntry = NULL;
-        pOldEntry = listHead(&pDS->procList);
+        GPUACCT_PROC_ENTRY *pOldEntry = NULL;
+        NvU32 i;
+
+        for (i = 0; i < pDS->tableSize; i++)
+        {
+            if ((pDS->pEntries[i].addSeq != 0) &&
+                ((pOldEntry == NULL) || (pDS->pEntries[i].addSeq < pOldEntry->addSeq)))
+            {
+                pOldEntry = &pDS->pEntries[i];
+            }
+        }
         if (pOldEntry)
         {
-            gpuacctFreeProcEntry(pDS, pOldEntry);
+            gpuacctRemoveProcEntry(pDS, pOldEntry);
         }
     }
 
-    if (mapInsertExisting(&pDS->procMap, pEntry->procId, pEntry) == NV_TRUE)
+    // Keep the table at most 3/4 full.
+    if ((pDS->count + 1) * 4 > pDS->tableSize * 3)
     {
-        listAppendExisting(&pDS->procList, pEntry);
+        status = gpuacctGrowDataStore(pDS);
+        if (status != NV_OK)
+        {
+            return status;
+        }
     }
-    else
+
+    pNewEntry = &pDS->pEntries[gpuacctFindSlot(pDS, pEntry->procId)];
+    if (pNewEntry->addSeq != 0)
     {
         return NV_ERR_INSERT_DUPLICATE_NAME;
     }
+
+    *pNewEntry = *pEntry;
+    pNewEntry->addSeq = ++pDS->nextAddSeq;
+    pDS->count++;
+
+    if (ppEntry != NULL)
+    {
+        *ppEntry = pNewEntry;
+    }
+
     return NV_OK;
 }
 
+/*!
+ * Records that the accounting data of a process entry changed, for
+ * NV0000_CTRL_CMD_GPUACCT_GET_CHANGED_PROCS.
+ *
+ * @param[in]  pGpuInstanceInfo   Pointer to GPU node owning the entry.
+ * @param[in]  pEntry             Pointer to process entry.
+ */
+static void
+gpuacctMarkProcEntryChanged
+(
+    GPUACCT_GPU_INSTANCE_INFO *pGpuInstanceInfo,
+    GPUACCT_PROC_ENTRY *pEntry
+)
+{
+    pEntry->changeSeq = ++pGpuInstanceInfo->changeSeq;
+}
+
 /*!
  * Finds the process entry for input PMU sample's pid/subpid.
  *
@@ -582,6 +704,7 @@ gpuacctProcessGpuUtil
             if (status == NV_OK && pEntry != NULL)
             {
                 pEntry->sumUtil += pUtilSampleBuffer[index].gr.util;
+                gpuacctMarkProcEntryChanged(pGpuInstanceInfo, pEntry);
 
                 NV_PRINTF(LEVEL_INFO, "pid=%d subPid=%d util=%4d sumUtil=%lld sampleCount=%u (total=%u)\n",
                           pUtilSampleBuffer[index].gr.procId,
@@ -614,7 +737,7 @@ gpuacctProcessGpuUtil
             if (status == NV_OK && pEntry != NULL)
             {
                 pEntry->sumFbUtil += pUtilSampleBuffer[index].fb.util;
-
+                gpuacctMarkProcEntryChanged(pGpuInstanceInfo, pEntry);
             }
         }
     }
@@ -717,6 +840,8 @@ gpuacctStartGpuAccounting_IMPL
 
     pEntry->startSampleCount = gpuInstanceInfo->totalSampleCount;
 
+    gpuacctMarkProcEntryChanged(gpuInstanceInfo, pEntry);
+
     NV_PRINTF(LEVEL_INFO, "pid=%d startSampleCount=%u\n",
               searchPid, pEntry->startSampleCount);
 
@@ -763,6 +888,7 @@ gpuacctStopGpuAccounting_IMPL
     GPU_ACCT_PROC_DATA_STORE *pDeadDS;
     GPUACCT_PROC_ENTRY *pEntry;
     GPUACCT_PROC_ENTRY *pOldEntry;
+    GPUACCT_PROC_ENTRY deadEntry;
     NV_STATUS status;
     NvU32 searchPid;
     NvU32 vmIndex;
@@ -852,7 +978,7 @@ gpuacctStopGpuAccounting_IMPL
 
         if (pOldEntry != NULL)
         {
-            status = gpuacctFreeProcEntry(pDeadDS, pOldEntry);
+            status = gpuacctRemoveProcEntry(pDeadDS, pOldEntry);
             if (status != NV_OK)
             {
                 return status;
@@ -860,22 +986,25 @@ gpuacctStopGpuAccounting_IMPL
         }
 
         // Move the entry to dead procs data store
+        deadEntry = *pEntry;
+
         status = gpuacctRemoveProcEntry(pLiveDS, pEntry);
         if (status != NV_OK)
         {
             return status;
         }
 
-        status = gpuacctAddProcEntry(pDeadDS, pEntry, NV_FALSE);
+        status = gpuacctAddProcEntry(pDeadDS, &deadEntry, NV_FALSE, &pEntry);
         if (status != NV_OK)
         {
-            portMemFree(pEntry);
             return status;
         }
+
+        gpuacctMarkProcEntryChanged(pGpuInstanceInfo, pEntry);
     }
     else
     {
-        status = gpuacctFreeProcEntry(pLiveDS, pEntry);
+        status = gpuacctRemoveProcEntry(pLiveDS, pEntry);
         if (status != NV_OK)
         {
             return status;
@@ -954,6 +1083,12 @@ gpuacctUpdateProcPeakFbUsage_IMPL
         return NV_ERR_INVALID_STATE;
     }
 
+    if ((pEntry->procType != NV_GPUACCT_PROC_TYPE_GPU) ||
+        (fbUsage > pEntry->maxFbUsage))
+    {
+        gpuacctMarkProcEntryChanged(&pGpuAcct->gpuInstanceInfo[gpuInstance], pEntry);
+    }
+
     pEntry->procType = NV_GPUACCT_PROC_TYPE_GPU;
 
     if (fbUsage > pEntry->maxFbUsage)
@@ -1039,11 +1174,53 @@ gpuacctSetProcType_IMPL
         return NV_ERR_INVALID_STATE;
     }
 
+    if (pEntry->procType != procType)
+    {
+        gpuacctMarkProcEntryChanged(&pGpuAcct->gpuInstanceInfo[gpuInstance], pEntry);
+    }
+
     pEntry->procType = procType;
 
     return status;
 }
 
+/*!
+ * Computes the average utilizations of a process over its lifetime.
+ *
+ * @param[in]  pGpuInstanceInfo   Pointer to GPU node owning the entry.
+ * @param[in]  pEntry             Pointer to process entry.
+ * @param[in]  isLiveProcess      Whether the process is still running.
+ * @param[out] pGpuUtil           Average GR engine utilization.
+ * @param[out] pFbUtil            Average FB bandwidth utilization.
+ */
+static void
+gpuacctGetProcUtil
+(
+    GPUACCT_GPU_INSTANCE_INFO *pGpuInstanceInfo,
+    const GPUACCT_PROC_ENTRY *pEntry,
+    NvBool isLiveProcess,
+    NvU32 *pGpuUtil,
+    NvU32 *pFbUtil
+)
+{
+    NvU32 sampleCount;
+
+    *pGpuUtil = pEntry->gpuUtil;
+    *pFbUtil  = pEntry->fbUtil;
+
+    sampleCount = isLiveProcess == NV_TRUE ?
+                  pGpuInstanceInfo->totalSampleCount - pEntry->startSampleCount:
+                  pEntry->totalSampleCount;
+    if (sampleCount)
+    {
+        *pGpuUtil = (NvU32)(pEntry->sumUtil / sampleCount);
+        *pGpuUtil /= 100;
+
+        *pFbUtil = (NvU32)(pEntry->sumFbUtil / sampleCount);
+        *pFbUtil /= 100;
+    }
+}
+
 /*!
  * Gets GPU accounting info for the process.
  *
@@ -1071,7 +1248,6 @@ gpuacctGetProcAcctInfo_IMPL
     OBJGPU *pGpu;
     NvU32 vmIndex;
     GPUACCT_GPU_INSTANCE_INFO *pGpuInstanceInfo;
-    NvU32 sampleCount;
     NvBool isLiveProcess;
     NvBool bVgpuOnGspEnabled;
 
@@ -1178,17 +1354,8 @@ gpuacctGetProcAcctInfo_IMPL
     pParams->startTime  = pEntry->startTime;
     pParams->endTime    = pEntry->endTime;
 
-    sampleCount = isLiveProcess == NV_TRUE ?
-                  pGpuInstanceInfo->totalSampleCount - pEntry->startSampleCount:
-                  pEntry->totalSampleCount;
-    if (sampleCount)
-    {
-        pParams->gpuUtil = (NvU32)(pEntry->sumUtil / sampleCount);
-        pParams->gpuUtil /= 100;
-
-        pParams->fbUtil = (NvU32)(pEntry->sumFbUtil / sampleCount);
-        pParams->fbUtil /= 100;
-    }
+    gpuacctGetProcUtil(pGpuInstanceInfo, pEntry, isLiveProcess,
+                       &pParams->gpuUtil, &pParams->fbUtil);
 
     return NV_OK;
 }
@@ -1211,9 +1378,10 @@ gpuacctGetAcctPids_IMPL
 )
 {
     GPUACCT_PROC_ENTRY *pEntry;
-    GPU_ACCT_PROC_LIST *pList;
+    GPU_ACCT_PROC_DATA_STORE *pDS;
     OBJGPU *pGpu;
     NvU32 count;
+    NvU32 i;
     NvU32 vmPid;
     NvU32 vmIndex;
     GPUACCT_GPU_INSTANCE_INFO *pGpuInstanceInfo;
@@ -1264,19 +1432,18 @@ gpuacctGetAcctPids_IMPL
 
     if (vmIndex == NV_INVALID_VM_INDEX)
     {
-        pList = &pGpuInstanceInfo->deadProcAcctInfo.procList;
+        pDS = &pGpuInstanceInfo->deadProcAcctInfo;
     }
     else
     {
-        pList = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].deadVMProcAcctInfo.procList;
+        pDS = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].deadVMProcAcctInfo;
     }
-    NV_ASSERT_OR_RETURN(pList != NULL, NV_ERR_INVALID_STATE);
+    NV_ASSERT_OR_RETURN(pDS != NULL, NV_ERR_INVALID_STATE);
 
-    GPU_ACCT_PROC_LISTIter iter = listIterAll(pList);
-    while (listIterNext(&iter))
+    for (i = 0; i < pDS->tableSize; i++)
     {
-        pEntry = iter.pValue;
-        if (pEntry)
+        pEntry = &pDS->pEntries[i];
+        if (pEntry->addSeq != 0)
         {
             pParams->pidTbl[count++] = pEntry->procId;
         }
@@ -1284,19 +1451,18 @@ gpuacctGetAcctPids_IMPL
 
     if (vmIndex == NV_INVALID_VM_INDEX)
     {
-        pList = &pGpuInstanceInfo->liveProcAcctInfo.procList;
+        pDS = &pGpuInstanceInfo->liveProcAcctInfo;
     }
     else
     {
-        pList = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].liveVMProcAcctInfo.procList;
+        pDS = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].liveVMProcAcctInfo;
     }
-    NV_ASSERT_OR_RETURN(pList != NULL, NV_ERR_INVALID_STATE);
+    NV_ASSERT_OR_RETURN(pDS != NULL, NV_ERR_INVALID_STATE);
 
-    iter = listIterAll(pList);
-    while (listIterNext(&iter))
+    for (i = 0; i < pDS->tableSize; i++)
     {
-        pEntry = iter.pValue;
-        if (pEntry && pEntry->procType == NV_GPUACCT_PROC_TYPE_GPU)
+        pEntry = &pDS->pEntries[i];
+        if (pEntry->addSeq != 0 && pEntry->procType == NV_GPUACCT_PROC_TYPE_GPU)
         {
             pParams->pidTbl[count++] = pEntry->procId;
         }
@@ -1307,6 +1473,149 @@ gpuacctGetAcctPids_IMPL
     return NV_OK;
 }
 
+/*!
+ * Gets the accounting data of the processes that changed since a cursor.
+ *
+ * @note The processes are returned in increasing changeSeq order, so the
+ * changeSeq of the last process returned is a valid cursor when procTbl
+ * fills up.
+ *
+ * @param[in]     pGpuAcct    GPUACCT object pointer
+ * @param[in,out] pParams     NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS pointer.
+ *
+ * @return  NV_OK
+ * @return  NV_ERR_INVALID_ARGUMENT
+ * @return  NV_ERR_INVALID_STATE
+ */
+NV_STATUS
+gpuacctGetChangedProcs_IMPL
+(
+    GpuAccounting *pGpuAcct,
+    NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS *pParams
+)
+{
+    const GPUACCT_PROC_ENTRY *pChanged[NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT];
+    NvBool bChangedLive[NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT];
+    GPU_ACCT_PROC_DATA_STORE *pDS[2];
+    OBJGPU *pGpu;
+    NvU32 count;
+    NvU32 vmPid;
+    NvU32 vmIndex;
+    NvU32 d;
+    NvU32 i;
+    NvU32 j;
+    GPUACCT_GPU_INSTANCE_INFO *pGpuInstanceInfo;
+    NvBool bVgpuOnGspEnabled;
+    NvBool bMore;
+
+    if (pParams == NULL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    pGpu = gpumgrGetGpuFromId(pParams->gpuId);
+    if (pGpu == NULL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    pGpuInstanceInfo = &pGpuAcct->gpuInstanceInfo[pGpu->gpuInstance];
+    vmIndex = NV_INVALID_VM_INDEX;
+
+    bVgpuOnGspEnabled = IS_VGPU_GSP_PLUGIN_OFFLOAD_ENABLED(pGpu) && RMCFG_FEATURE_PLATFORM_GSP;
+
+    vmPid = ((hypervisorIsVgxHyper() || bVgpuOnGspEnabled) && (pParams->pid != 0)) ?
+            pParams->pid :
+            NV_INVALID_VM_PID;
+
+    // Find vmIndex if vmPid is provided.
+    if (vmPid != NV_INVALID_VM_PID)
+    {
+        for (i = 0; i < MAX_VGPU_DEVICES_PER_PGPU; i++)
+        {
+            if (pGpuInstanceInfo->vmInstanceInfo[i].vmPId == vmPid)
+            {
+                vmIndex = i;
+                break;
+            }
+        }
+        if (vmIndex == NV_INVALID_VM_INDEX)
+        {
+            return NV_ERR_INVALID_ARGUMENT;
+        }
+    }
+
+    if (vmIndex == NV_INVALID_VM_INDEX)
+    {
+        pDS[0] = &pGpuInstanceInfo->deadProcAcctInfo;
+        pDS[1] = &pGpuInstanceInfo->liveProcAcctInfo;
+    }
+    else
+    {
+        pDS[0] = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].deadVMProcAcctInfo;
+        pDS[1] = &pGpuInstanceInfo->vmInstanceInfo[vmIndex].liveVMProcAcctInfo;
+    }
+
+    //
+    // Keep the entries that changed after the cursor with the lowest
+    // changeSeq, sorted by changeSeq.
+    //
+    count = 0;
+    bMore = NV_FALSE;
+    for (d = 0; d < 2; d++)
+    {
+        NvBool isLiveProcess = (d == 1);
+
+        for (i = 0; i < pDS[d]->tableSize; i++)
+        {
+            const GPUACCT_PROC_ENTRY *pEntry = &pDS[d]->pEntries[i];
+
+            if ((pEntry->addSeq == 0) || (pEntry->changeSeq <= pParams->cursor))
+                continue;
+
+            if (isLiveProcess && (pEntry->procType != NV_GPUACCT_PROC_TYPE_GPU))
+                continue;
+
+            for (j = count; j > 0 && pChanged[j - 1]->changeSeq > pEntry->changeSeq; j--)
+            {
+                if (j < NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT)
+                {
+                    pChanged[j]     = pChanged[j - 1];
+                    bChangedLive[j] = bChangedLive[j - 1];
+                }
+            }
+
+            if (count == NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT)
+                bMore = NV_TRUE;
+            else
+                count++;
+
+            if (j < NV0000_GPUACCT_CHANGED_PROCS_MAX_COUNT)
+            {
+                pChanged[j]     = pEntry;
+                bChangedLive[j] = isLiveProcess;
+            }
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        NV0000_CTRL_GPUACCT_CHANGED_PROC *pProc = &pParams->procTbl[i];
+
+        pProc->pid        = pChanged[i]->procId;
+        pProc->bRunning   = bChangedLive[i];
+        pProc->maxFbUsage = pChanged[i]->maxFbUsage;
+        pProc->startTime  = pChanged[i]->startTime;
+        pProc->endTime    = pChanged[i]->endTime;
+
+        gpuacctGetProcUtil(pGpuInstanceInfo, pChanged[i], bChangedLive[i],
+                           &pProc->gpuUtil, &pProc->fbUtil);
+    }
+
+    pParams->procCount = count;
+    pParams->bMore     = bMore;
+    pParams->cursor    = bMore ? pChanged[count - 1]->changeSeq :
+                                 pGpuInstanceInfo->changeSeq;
+
+    return NV_OK;
+}
+
 /*!
  * Gets accounting mode.
  *
@@ -2097,18 +2097,35 @@ _rcdbAddRmGpuDumpCallback
     status = osAcquireRmSema(pSys->pSema);
     if (status == NV_OK)
     {
+        //
         // LOCK: acquire API lock
-        status = rmapiLockAcquire(API_LOCK_FLAGS_NONE, RM_LOCK_MODULES_DIAG);
+        //
+        // The dump only reads RM state, and the Journal error list is only
+        // torn down under the exclusive API lock, so a shared acquire is
+        // enough and doesn't hold off other clients.
+        //
+        status = rmapiLockAcquire(RMAPI_LOCK_FLAGS_READ, RM_LOCK_MODULES_DIAG);
         if (status == NV_OK)
         {
-            // LOCK: acquire GPUs lock
-            status = rmGpuLocksAcquire(GPUS_LOCK_FLAGS_NONE,
-                                       RM_LOCK_MODULES_DIAG);
-            if (status == NV_OK)
+            Journal *pRcDB = SYS_GET_RCDB(pSys);
+            OBJGPU  *pGpu = gpumgrGetGpu(gpuInstance);
+
+            //
+            // LOCK: acquire the device locks of the crashed GPU only, so the
+            // other GPUs keep running while the dump is encoded.
+            //
+            if (pGpu == NULL)
+            {
+                status = NV_ERR_INVALID_DEVICE;
+            }
+            else
             {
-                Journal *pRcDB = SYS_GET_RCDB(pSys);
-                OBJGPU  *pGpu = gpumgrGetGpu(gpuInstance);
+                status = rmDeviceGpuLocksAcquire(pGpu, GPUS_LOCK_FLAGS_NONE,
+                                                 RM_LOCK_MODULES_DIAG);
+            }
 
+            if (status == NV_OK)
+            {
                 //
                 // Mark the Journal object as in the deferred dump path so we won't
                 // re-attempt again.
@@ -2120,12 +2137,15 @@ _rcdbAddRmGpuDumpCallback
 
                 pRcDB->setProperty(pRcDB, PDB_PROP_RCDB_IN_DEFERRED_DUMP_CODEPATH, NV_FALSE);
 
-                // UNLOCK: release GPUs lock
-                rmGpuLocksRelease(GPUS_LOCK_FLAGS_NONE, NULL);
+                // UNLOCK: release the device locks
+                rmDeviceGpuLocksRelease(pGpu, GPUS_LOCK_FLAGS_NONE, NULL);
             }
             else
             {
                 NV_PRINTF(LEVEL_ERROR, "failed to acquire the GPU locks!\n");
+
+                // Let the next crash attempt a dump again
+                pRcDB->nvDumpState.bDumpInProcess = NV_FALSE;
             }
             // UNLOCK: release API lock
             rmapiLockRelease();
@@ -2142,6 +2162,47 @@ _rcdbAddRmGpuDumpCallback
     }
 }
 
+//
+// Queue the GPU dump to a system work item. The dump state stays marked as in
+// use until the work item runs, which keeps other interrupts and codepaths
+// from initiating the dump and/or queueing another work item.
+//
+static NV_STATUS
+_rcdbQueueDeferredGpuDump
+(
+    OBJGPU *pGpu
+)
+{
+    OBJSYS    *pSys = SYS_GET_INSTANCE();
+    OBJOS     *pOS  = SYS_GET_OS(pSys);
+    NvU32     *pGpuInstance;
+    NV_STATUS  status;
+
+    //
+    // This will be freed by the OS work item layer. We pass the GPU
+    // instance as the data separately because if the GPU has fallen off
+    // the bus, the OS layer may refuse to execute work items attached to
+    // it. Instead, use the system work item interface and handle the GPU
+    // ourselves.
+    //
+    pGpuInstance = portMemAllocNonPaged(sizeof(NvU32));
+    if (pGpuInstance == NULL)
+    {
+        return NV_ERR_NO_MEMORY;
+    }
+
+    *pGpuInstance = gpuGetInstance(pGpu);
+    status = pOS->osQueueSystemWorkItem(_rcdbAddRmGpuDumpCallback,
+                                        pGpuInstance);
+    if (status != NV_OK)
+    {
+        portMemFree(pGpuInstance);
+        return status;
+    }
+
+    return NV_WARN_MORE_PROCESSING_REQUIRED;
+}
+
 static NV_STATUS
 nvdDebuggerBufferCallback(void *pEncoder, NvBool bBufferFull)
 {
@@ -2810,6 +2871,26 @@ rcdbAddRmGpuDump
 
     rcdbDumpInitGpuAccessibleFlag(pGpu, pRcDB);
 
+    //
+    // Encoding a full dump takes a while. When the caller holds the locks of
+    // other GPUs too (e.g. the RC path, which runs under all GPU locks), hand
+    // the dump to a work item that only takes this GPU's locks, instead of
+    // stalling every GPU in the system until it is done.
+    //
+    if (!pRcDB->getProperty(pRcDB, PDB_PROP_RCDB_IN_DEFERRED_DUMP_CODEPATH) &&
+        ((rmGpuLocksGetOwnedMask() & ~gpumgrGetGpuMask(pGpu)) != 0))
+    {
+        NV_PRINTF(LEVEL_INFO, "deferring GPU dump out of the all-GPU lock\n");
+
+        status = _rcdbQueueDeferredGpuDump(pGpu);
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED)
+        {
+            return status;
+        }
+
+        // Couldn't queue it, dump synchronously then
+    }
+
     //
     // General process:
     //  1. Start the protobuf encoder in ALLOCATE mode, and dump the data
@@ -2827,8 +2908,6 @@ rcdbAddRmGpuDump
         // from the interrupt context anyway, so queue a work item to come back
         // later and try again.
         //
-        OBJOS *pOS = SYS_GET_OS(pSys);
-        NvU32 *pGpuInstance = NULL;
 
         //
         // If that's what we've already done and we're still failing, bail out
@@ -2844,35 +2923,13 @@ rcdbAddRmGpuDump
 
         NV_PRINTF(LEVEL_INFO, "deferring GPU dump for normal context\n");
 
-        //
-        // This will be freed by the OS work item layer. We pass the GPU
-        // instance as the data separately because if the GPU has fallen off
-        // the bus, the OS layer may refuse to execute work items attached to
-        // it. Instead, use the system work item interface and handle the GPU
-        // ourselves.
-        //
-        pGpuInstance = portMemAllocNonPaged(sizeof(NvU32));
-        if (pGpuInstance == NULL)
+        status = _rcdbQueueDeferredGpuDump(pGpu);
+        if (status == NV_WARN_MORE_PROCESSING_REQUIRED)
         {
-            status = NV_ERR_NO_MEMORY;
-            goto done;
+            return status;
         }
 
-        *pGpuInstance = gpuGetInstance(pGpu);
-        status = pOS->osQueueSystemWorkItem(_rcdbAddRmGpuDumpCallback,
-                                            pGpuInstance);
-        if (status != NV_OK)
-        {
-            portMemFree(pGpuInstance);
-            goto done;
-        }
-
-        //
-        // Since we've queued the work item, leave the dump state marked as in
-        // use to prevent other interrupts and codepaths from attempting to
-        // initiate the dump and/or queue a new work item.
-        //
-        return NV_WARN_MORE_PROCESSING_REQUIRED;
+        goto done;
     }
 
     status = nvdDumpAllEngines(pGpu, pNvd, &prbEnc, pNvDumpState);
@@ -2929,7 +2986,11 @@ rcdbAddRmGpuDump
     pNewErrorBlock->pNext = NULL;
     pErrorHeader->pErrorBlock = pNewErrorBlock;
 
-    // Add the error element to the Journal list
+    //
+    // Add the error element to the Journal list. The deferred dump only holds
+    // the API lock shared, so publish the element fully initialized.
+    //
+    portAtomicMemoryFenceStore();
     if (pSysErrorInfo->pErrorList != NULL)
     {
         pErrorList = (RMPRBERRORELEMENT_V2*)pSysErrorInfo->pErrorList;
@@ -547,16 +547,35 @@ nvlogRingBufferPush
     NvU32 oldPos;
     NvU32 lock = DRF_VAL(LOG, _BUFFER_FLAGS, _LOCKING, pBuffer->flags);
 
-    if (lock != NVLOG_BUFFER_FLAGS_LOCKING_NONE)
-        portSyncSpinlockAcquire(NvLogLogger.mainLock);
+    if (lock == NVLOG_BUFFER_FLAGS_LOCKING_STATE)
+    {
+        //
+        // State locking only needs the space reservation to be atomic, so
+        // claim it with a CAS on pos instead of serializing every writer of
+        // every buffer on the main lock. The data copy is unlocked as before.
+        //
+        NvU32 newPos;
+        NvU32 wraps;
+
+        do
+        {
+            oldPos = ((volatile NVLOG_BUFFER *)pBuffer)->pos;
+            wraps  = (oldPos + dataSize) / pBuffer->size;
+            newPos = (oldPos + dataSize) % pBuffer->size;
+        } while (!portAtomicCompareAndSwapU32(&pBuffer->pos, newPos, oldPos));
 
-    oldPos = pBuffer->pos;
-    pBuffer->extra.ring.overflow += (pBuffer->pos + dataSize) / pBuffer->size;
-    pBuffer->pos                  = (pBuffer->pos + dataSize) % pBuffer->size;
+        if (wraps != 0)
+            portAtomicAddU32(&pBuffer->extra.ring.overflow, wraps);
+    }
+    else
+    {
+        if (lock == NVLOG_BUFFER_FLAGS_LOCKING_FULL)
+            portSyncSpinlockAcquire(NvLogLogger.mainLock);
 
-    // State locking does portMemCopy unlocked.
-    if (lock == NVLOG_BUFFER_FLAGS_LOCKING_STATE)
-        portSyncSpinlockRelease(NvLogLogger.mainLock);
+        oldPos = pBuffer->pos;
+        pBuffer->extra.ring.overflow += (pBuffer->pos + dataSize) / pBuffer->size;
+        pBuffer->pos                  = (pBuffer->pos + dataSize) % pBuffer->size;
+    }
 
     while (dataSize > 0)
     {
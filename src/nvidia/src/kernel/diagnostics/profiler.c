@@ -225,3 +225,136 @@ rmProfGroupStop
     pGroup->pTotal = NULL;
     pGroup->pLast  = NULL;
 }
+
+/*!
+ * @brief Start a step trace.
+ *
+ * @param[out]  pTrace    Trace to start, may be NULL.
+ * @param[in]   start_ns  Start time from osGetPerformanceCounter, or 0 for now.
+ */
+void
+rmProfTraceStart
+(
+    RM_PROF_TRACE *pTrace,
+    NvU64          start_ns
+)
+{
+    if (pTrace == NULL)
+        return;
+
+    portMemSet(pTrace, 0, sizeof(*pTrace));
+
+    if (start_ns == 0)
+        osGetPerformanceCounter(&start_ns);
+
+    pTrace->start_ns = start_ns;
+    pTrace->last_ns  = start_ns;
+}
+
+static void
+_rmProfTraceAdd
+(
+    RM_PROF_TRACE *pTrace,
+    const char    *pName,
+    NvU64          end_ns,
+    NvU64          elapsed_ns
+)
+{
+    RM_PROF_TRACE_ENTRY *pEntry;
+
+    if (pTrace->count == RM_PROF_TRACE_MAX_ENTRIES)
+    {
+        pTrace->dropped++;
+        return;
+    }
+
+    pEntry = &pTrace->entries[pTrace->count++];
+    portStringCopy(pEntry->name, sizeof(pEntry->name), pName, portStringLength(pName) + 1);
+    pEntry->end_ns     = end_ns - pTrace->start_ns;
+    pEntry->elapsed_ns = elapsed_ns;
+}
+
+/*!
+ * @brief End the current step of a trace.
+ *
+ * @param[in,out]  pTrace  Trace, may be NULL.
+ * @param[in]      pName   Name of the step that just ended.
+ */
+void
+rmProfTraceStep
+(
+    RM_PROF_TRACE *pTrace,
+    const char    *pName
+)
+{
+    NvU64 now_ns;
+
+    if ((pTrace == NULL) || (pTrace->start_ns == 0))
+        return;
+
+    osGetPerformanceCounter(&now_ns);
+    _rmProfTraceAdd(pTrace, pName, now_ns, now_ns - pTrace->last_ns);
+    pTrace->last_ns = now_ns;
+}
+
+/*!
+ * @brief Record a step that ended now and was timed by the caller.
+ *
+ * Does not end the current step, so the time is also part of the next
+ * rmProfTraceStep.
+ *
+ * @param[in,out]  pTrace      Trace, may be NULL.
+ * @param[in]      pName       Name of the step.
+ * @param[in]      elapsed_ns  Duration of the step.
+ */
+void
+rmProfTraceRecord
+(
+    RM_PROF_TRACE *pTrace,
+    const char    *pName,
+    NvU64          elapsed_ns
+)
+{
+    NvU64 now_ns;
+
+    if ((pTrace == NULL) || (pTrace->start_ns == 0))
+        return;
+
+    osGetPerformanceCounter(&now_ns);
+    _rmProfTraceAdd(pTrace, pName, now_ns, elapsed_ns);
+}
+
+/*!
+ * @brief Print all steps of a trace.
+ *
+ * @param[in]  pTrace  Trace, may be NULL.
+ * @param[in]  pTitle  Printed before the steps.
+ */
+void
+rmProfTracePrint
+(
+    RM_PROF_TRACE *pTrace,
+    const char    *pTitle
+)
+{
+    NvU32 i;
+
+    if ((pTrace == NULL) || (pTrace->start_ns == 0))
+        return;
+
+    NV_PRINTF(LEVEL_NOTICE, "%s: %llu us\n", pTitle,
+              (pTrace->last_ns - pTrace->start_ns) / 1000);
+
+    for (i = 0; i < pTrace->count; i++)
+    {
+        NV_PRINTF(LEVEL_NOTICE, "    %10llu us  %-32s %10llu us\n",
+                  pTrace->entries[i].end_ns / 1000,
+                  pTrace->entries[i].name,
+                  pTrace->entries[i].elapsed_ns / 1000);
+    }
+
+    if (pTrace->dropped != 0)
+    {
+        NV_PRINTF(LEVEL_NOTICE, "    (%u steps not recorded)\n", pTrace->dropped);
+    }
+}
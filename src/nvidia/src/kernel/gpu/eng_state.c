@@ -26,6 +26,7 @@
 #include "core/hal.h"
 #include "core/info_block.h"
 #include "core/locks.h"
+#include "diagnostics/profiler.h"
 
 #include "gpu/bus/kern_bus.h"
 
@@ -117,6 +118,18 @@ engstateLogStateTransitionPost_IMPL
         engstateGetName(pEngstate),
         stateStrings[pEngstate->currentState], stateStrings[targetState],
         stats->transitionTimeUs);
+
+    // Engines that take 1ms or more to transition show up in the boot trace
+    if ((pEngstate->pGpu != NULL) && (pEngstate->pGpu->pBootTrace != NULL) &&
+        (stats->transitionTimeUs >= 1000))
+    {
+        char name[RM_PROF_TRACE_NAME_LENGTH];
+
+        nvDbgSnprintf(name, sizeof(name), "  %s %s",
+                      engstateGetName(pEngstate), stateStrings[targetState]);
+        rmProfTraceRecord(pEngstate->pGpu->pBootTrace, name,
+                          endTimeNs - pData->transitionStartTimeNs);
+    }
 #else
     NV_PRINTF(LEVEL_INFO,
         "Engine 0x%06x:%d state change: %d -> %d, took %uus\n",
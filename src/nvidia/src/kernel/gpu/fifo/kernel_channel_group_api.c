@@ -25,6 +25,8 @@
 
 #include "kernel/core/locks.h"
 #include "kernel/gpu/fifo/kernel_channel_group.h"
+#include "kernel/gpu/fifo/kernel_fifo.h"
+#include "kernel/gpu/fifo/kernel_sched_mgr.h"
 #include "kernel/gpu/mem_mgr/mem_mgr.h"
 #include "kernel/gpu/gr/kernel_graphics.h"
 #include "kernel/gpu/falcon/kernel_falcon.h"
@@ -41,6 +43,71 @@
 #include "vgpu/rpc.h"
 #include "rmapi/rs_utils.h"
 
+/*!
+ * @brief Move a channel group to a scheduling class
+ *
+ * The interleave level and timeslice of the class are set through the TSG
+ * controls, which only touch the TSG, so no channel is reconfigured. If the
+ * timeslice can't be set, the previous interleave level is restored and the
+ * TSG stays in its previous class.
+ */
+static NV_STATUS
+_kchangrpapiSetSchedClass
+(
+    KernelChannelGroupApi *pKernelChannelGroupApi,
+    NvU32                  schedClass
+)
+{
+    OBJGPU             *pGpu                = GPU_RES_GET_GPU(pKernelChannelGroupApi);
+    KernelFifo         *pKernelFifo         = GPU_GET_KERNEL_FIFO(pGpu);
+    KernelSchedMgr     *pKernelSchedMgr     = kfifoGetKernelSchedMgr(pKernelFifo);
+    KernelChannelGroup *pKernelChannelGroup = pKernelChannelGroupApi->pKernelChannelGroup;
+    RM_API             *pRmApi              = rmapiGetInterface(RMAPI_GPU_LOCK_INTERNAL);
+    NvHandle            hClient             = RES_GET_CLIENT_HANDLE(pKernelChannelGroupApi);
+    NvHandle            hObject             = RES_GET_HANDLE(pKernelChannelGroupApi);
+    NvU32               subdevInst          = gpumgrGetSubDeviceInstanceFromGpu(pGpu);
+    const KSCHEDMGR_SCHED_CLASS_CONFIG *pConfig;
+    NVA06C_CTRL_INTERLEAVE_LEVEL_PARAMS interleaveParams = { 0 };
+    NVA06C_CTRL_TIMESLICE_PARAMS        timesliceParams  = { 0 };
+    NvU32               prevInterleaveLevel;
+    NV_STATUS           status;
+
+    NV_CHECK_OR_RETURN(LEVEL_INFO, schedClass < NVA06C_CTRL_SCHED_CLASS_COUNT,
+                       NV_ERR_INVALID_ARGUMENT);
+    NV_ASSERT_OR_RETURN(pKernelSchedMgr != NULL, NV_ERR_NOT_SUPPORTED);
+
+    pConfig = kschedmgrGetSchedClassConfig(pKernelSchedMgr, schedClass);
+    prevInterleaveLevel = pKernelChannelGroup->pInterleaveLevel[subdevInst];
+
+    interleaveParams.tsgInterleaveLevel = pConfig->interleaveLevel;
+    NV_CHECK_OK_OR_RETURN(LEVEL_ERROR,
+        pRmApi->Control(pRmApi, hClient, hObject,
+                        NVA06C_CTRL_CMD_SET_INTERLEAVE_LEVEL,
+                        &interleaveParams, sizeof(interleaveParams)));
+
+    timesliceParams.timesliceUs = (pConfig->timesliceUs != 0) ?
+        pConfig->timesliceUs : kfifoChannelGroupGetDefaultTimeslice_HAL(pKernelFifo);
+    status = pRmApi->Control(pRmApi, hClient, hObject,
+                             NVA06C_CTRL_CMD_SET_TIMESLICE,
+                             &timesliceParams, sizeof(timesliceParams));
+    if (status != NV_OK)
+    {
+        NV_PRINTF(LEVEL_ERROR, "Failed to set the timeslice of sched class %d: 0x%x\n",
+                  schedClass, status);
+
+        interleaveParams.tsgInterleaveLevel = prevInterleaveLevel;
+        NV_ASSERT_OK(pRmApi->Control(pRmApi, hClient, hObject,
+                                     NVA06C_CTRL_CMD_SET_INTERLEAVE_LEVEL,
+                                     &interleaveParams, sizeof(interleaveParams)));
+        return status;
+    }
+
+    pKernelChannelGroup->schedClass       = schedClass;
+    pKernelChannelGroup->preemptTimeoutUs = pConfig->preemptTimeoutUs;
+
+    return NV_OK;
+}
+
 NV_STATUS
 kchangrpapiConstruct_IMPL
 (
@@ -117,6 +184,13 @@ kchangrpapiConstruct_IMPL
     pAllocParams = pParams->pAllocParams;
     hVASpace     = pAllocParams->hVASpace;
 
+    if (pAllocParams->schedClass >= NVA06C_CTRL_SCHED_CLASS_COUNT)
+    {
+        NV_PRINTF(LEVEL_ERROR, "Invalid sched class %d\n", pAllocParams->schedClass);
+        rmStatus = NV_ERR_INVALID_ARGUMENT;
+        goto failed;
+    }
+
     NV_ASSERT_OK_OR_GOTO(rmStatus,
         serverAllocShareWithHalspecParent(&g_resServ, classInfo(KernelChannelGroup),
                                           &pShared, staticCast(pGpu, Object)),
@@ -242,9 +316,22 @@ kchangrpapiConstruct_IMPL
 
     if (!RMCFG_FEATURE_PLATFORM_GSP)
     {
-        NV_ASSERT_OK_OR_GOTO(rmStatus,
-            ctxBufPoolInit(pGpu, pHeap, &pKernelChannelGroup->pCtxBufPool),
-            failed);
+        //
+        // GR contexts reuse the reserved pool of a freed channel group when
+        // the heap has one cached.
+        //
+        if (RM_ENGINE_TYPE_IS_GR(pKernelChannelGroup->engineType))
+        {
+            NV_ASSERT_OK_OR_GOTO(rmStatus,
+                ctxBufPoolCacheGet(pGpu, pHeap, &pKernelChannelGroup->pCtxBufPool),
+                failed);
+        }
+        else
+        {
+            NV_ASSERT_OK_OR_GOTO(rmStatus,
+                ctxBufPoolInit(pGpu, pHeap, &pKernelChannelGroup->pCtxBufPool),
+                failed);
+        }
 
         NV_ASSERT_OK_OR_GOTO(rmStatus,
             ctxBufPoolInit(pGpu, pHeap, &pKernelChannelGroup->pChannelBufPool),
@@ -485,6 +572,17 @@ kchangrpapiConstruct_IMPL
         }
     }
 
+    //
+    // Apply the scheduling class before the TSG gets any channel, so none of
+    // its work runs with the default settings.
+    //
+    if (pAllocParams->schedClass != NVA06C_CTRL_SCHED_CLASS_DEFAULT)
+    {
+        NV_ASSERT_OK_OR_GOTO(rmStatus,
+            _kchangrpapiSetSchedClass(pKernelChannelGroupApi, pAllocParams->schedClass),
+            failed);
+    }
+
     if (kfifoIsZombieSubctxWarEnabled(pKernelFifo))
     {
         kchangrpSetSubcontextZombieState_HAL(pGpu, pKernelChannelGroup, 0, NV_TRUE);
@@ -537,6 +635,14 @@ done:
         // GPU lock should not be held when reserving memory for ctxBufPool
         NV_ASSERT_OK_OR_CAPTURE_FIRST_ERROR(rmStatus,
             ctxBufPoolReserve(pGpu, pKernelChannelGroup->pCtxBufPool, bufInfoList, bufCount));
+
+        // Have pools ready for the next GR contexts created on this heap
+        if ((rmStatus == NV_OK) && RM_ENGINE_TYPE_IS_GR(pKernelChannelGroup->engineType))
+        {
+            ctxBufPoolCachePrewarm(pGpu, pKernelChannelGroup->pCtxBufPool,
+                                   bMIGInUse ? ref.pKernelMIGGpuInstance->swizzId : KMIGMGR_SWIZZID_INVALID,
+                                   bufInfoList, bufCount);
+        }
     }
 
     portMemFree(bufInfoList);
@@ -552,13 +658,32 @@ kchangrpapiControl_IMPL
     RS_RES_CONTROL_PARAMS_INTERNAL *pParams
 )
 {
-    RsResourceRef *pResourceRef = RES_GET_REF(pKernelChannelGroupApi);
+    RsResourceRef      *pResourceRef        = RES_GET_REF(pKernelChannelGroupApi);
+    KernelChannelGroup *pKernelChannelGroup = pKernelChannelGroupApi->pKernelChannelGroup;
 
     (void)pResourceRef;
     NV_PRINTF(LEVEL_INFO, "grpID 0x%x handle 0x%x cmd 0x%x\n",
-              pKernelChannelGroupApi->pKernelChannelGroup->grpID,
+              pKernelChannelGroup->grpID,
               pResourceRef->hResource, pParams->pLegacyParams->cmd);
 
+    //
+    // Preempts without a timeout from the client use the preemption timeout
+    // of the TSG's scheduling class. The preempt itself is routed to physical
+    // RM, so this is the place to fill it in.
+    //
+    if ((pParams->cmd == NVA06C_CTRL_CMD_PREEMPT) &&
+        (pParams->paramsSize == sizeof(NVA06C_CTRL_PREEMPT_PARAMS)) &&
+        (pKernelChannelGroup->preemptTimeoutUs != 0))
+    {
+        NVA06C_CTRL_PREEMPT_PARAMS *pPreemptParams = pParams->pParams;
+
+        if (!pPreemptParams->bManualTimeout)
+        {
+            pPreemptParams->bManualTimeout = NV_TRUE;
+            pPreemptParams->timeoutUs      = pKernelChannelGroup->preemptTimeoutUs;
+        }
+    }
+
     return gpuresControl_IMPL(staticCast(pKernelChannelGroupApi, GpuResource),
                               pCallContext, pParams);
 }
@@ -619,8 +744,15 @@ kchangrpapiDestruct_IMPL
 
         if (pKernelChannelGroup->pCtxBufPool != NULL)
         {
-            ctxBufPoolRelease(pKernelChannelGroup->pCtxBufPool);
-            ctxBufPoolDestroy(&pKernelChannelGroup->pCtxBufPool);
+            if (RM_ENGINE_TYPE_IS_GR(pKernelChannelGroup->engineType))
+            {
+                ctxBufPoolCachePut(pGpu, &pKernelChannelGroup->pCtxBufPool);
+            }
+            else
+            {
+                ctxBufPoolRelease(pKernelChannelGroup->pCtxBufPool);
+                ctxBufPoolDestroy(&pKernelChannelGroup->pCtxBufPool);
+            }
         }
 
         if (pKernelChannelGroup->pChannelBufPool != NULL)
@@ -1407,6 +1539,51 @@ kchangrpapiCtrlCmdGetInterleaveLevel_IMPL
     return NV_OK;
 }
 
+NV_STATUS
+kchangrpapiCtrlCmdSetSchedClass_IMPL
+(
+    KernelChannelGroupApi          *pKernelChannelGroupApi,
+    NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams
+)
+{
+    if (pKernelChannelGroupApi->pKernelChannelGroup == NULL)
+        return NV_ERR_INVALID_OBJECT;
+
+    NV_CHECK_OK_OR_RETURN(LEVEL_INFO,
+        _kchangrpapiSetSchedClass(pKernelChannelGroupApi, pParams->schedClass));
+
+    return kchangrpapiCtrlCmdGetSchedClass_IMPL(pKernelChannelGroupApi, pParams);
+}
+
+NV_STATUS
+kchangrpapiCtrlCmdGetSchedClass_IMPL
+(
+    KernelChannelGroupApi          *pKernelChannelGroupApi,
+    NVA06C_CTRL_SCHED_CLASS_PARAMS *pParams
+)
+{
+    OBJGPU             *pGpu            = GPU_RES_GET_GPU(pKernelChannelGroupApi);
+    KernelFifo         *pKernelFifo     = GPU_GET_KERNEL_FIFO(pGpu);
+    KernelSchedMgr     *pKernelSchedMgr = kfifoGetKernelSchedMgr(pKernelFifo);
+    KernelChannelGroup *pKernelChannelGroup;
+    const KSCHEDMGR_SCHED_CLASS_CONFIG *pConfig;
+
+    if (pKernelChannelGroupApi->pKernelChannelGroup == NULL)
+        return NV_ERR_INVALID_OBJECT;
+    pKernelChannelGroup = pKernelChannelGroupApi->pKernelChannelGroup;
+
+    NV_ASSERT_OR_RETURN(pKernelSchedMgr != NULL, NV_ERR_NOT_SUPPORTED);
+    pConfig = kschedmgrGetSchedClassConfig(pKernelSchedMgr, pKernelChannelGroup->schedClass);
+
+    pParams->schedClass       = pKernelChannelGroup->schedClass;
+    pParams->interleaveLevel  = pConfig->interleaveLevel;
+    pParams->preemptTimeoutUs = pConfig->preemptTimeoutUs;
+    pParams->timesliceUs      = (pConfig->timesliceUs != 0) ?
+        pConfig->timesliceUs : kfifoChannelGroupGetDefaultTimeslice_HAL(pKernelFifo);
+
+    return NV_OK;
+}
+
 /*!
  * @brief Handler for NVA06C_CTRL_CMD_INTERNAL_PROMOTE_FAULT_METHOD_BUFFERS
  *
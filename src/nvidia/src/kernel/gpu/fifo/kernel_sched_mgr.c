@@ -39,6 +39,24 @@
 
 #include "virtualization/hypervisor/hypervisor.h"
 
+/* ------------------------------- Datatypes -------------------------------- */
+
+//
+// Settings of each TSG scheduling class, indexed by NVA06C_CTRL_SCHED_CLASS_*.
+// DEFAULT matches what a TSG is created with.
+//
+static const KSCHEDMGR_SCHED_CLASS_CONFIG _kschedmgrSchedClassConfig[] =
+{
+    // timesliceUs, preemptTimeoutUs, interleaveLevel
+    { 0,    0,    NVA06C_CTRL_INTERLEAVE_LEVEL_MEDIUM }, // DEFAULT
+    { 0,    1000, NVA06C_CTRL_INTERLEAVE_LEVEL_HIGH   }, // LATENCY
+    { 2048, 0,    NVA06C_CTRL_INTERLEAVE_LEVEL_MEDIUM }, // THROUGHPUT
+    { 0,    0,    NVA06C_CTRL_INTERLEAVE_LEVEL_LOW    }, // BEST_EFFORT
+};
+
+ct_assert(NV_ARRAY_ELEMENTS(_kschedmgrSchedClassConfig) == NVA06C_CTRL_SCHED_CLASS_COUNT);
+ct_assert(sizeof(((KernelSchedMgr *)0)->schedClassConfig) == sizeof(_kschedmgrSchedClassConfig));
+
 /* -------------------------------- Functions ------------------------------- */
 
 /*!
@@ -95,6 +113,9 @@ kschedmgrConstructPolicy_IMPL
 
     schedPolicyName = _kschedmgrGetSchedulerPolicy(pKernelSchedMgr, pGpu, &pKernelSchedMgr->configSchedPolicy);
 
+    portMemCopy(pKernelSchedMgr->schedClassConfig, sizeof(pKernelSchedMgr->schedClassConfig),
+                _kschedmgrSchedClassConfig, sizeof(_kschedmgrSchedClassConfig));
+
     // PVMRL is disabled when GPU is older than Pascal
     if (((RMCFG_FEATURE_PLATFORM_GSP && IS_VGPU_GSP_PLUGIN_OFFLOAD_ENABLED(pGpu)) || hypervisorIsVgxHyper()) && IsPASCALorBetter(pGpu))
     {
@@ -47,6 +47,7 @@
 #include "kernel/gpu/fifo/kernel_channel.h"
 #include "kernel/virtualization/hypervisor/hypervisor.h"
 #include "rmapi/client.h"
+#include "objtmr.h"
 
 #include "class/cl90cdtypes.h"
 #include "ctrl/ctrl90cd.h"
@@ -54,6 +55,15 @@
 #define NV_FECS_TRACE_MAX_TIMESTAMPS 5
 #define NV_FECS_TRACE_MAGIC_INVALIDATED 0xdededede         // magic number for entries that have been read
 
+//
+// When the trace is polled rather than interrupt driven, the 1Hz callback is
+// supplemented by a one shot timer whose period follows the ring fill level
+// seen on each pass: halved when a pass drains at least half of the ring,
+// doubled when it drains less than an eighth of it.
+//
+#define NV_FECS_TRACE_POLL_INTERVAL_MIN_NS  (10 * 1000 * 1000)
+#define NV_FECS_TRACE_POLL_INTERVAL_MAX_NS  (1000 * 1000 * 1000)
+
 typedef struct
 {
     NvU32 magic_lo;
@@ -80,6 +90,10 @@ struct KGRAPHICS_FECS_TRACE_INFO
     NvU32  fecsCtxswLogIntrPending;
     NvU32  fecsLastSeqno;
 
+    // Adaptive polling, see NV_FECS_TRACE_POLL_INTERVAL_*
+    TMR_EVENT *pFecsPollEvent;
+    NvU64      fecsPollIntervalNs;
+
 #if PORT_IS_MODULE_SUPPORTED(crypto)
     PORT_CRYPTO_PRNG *pFecsLogPrng;
 #endif
@@ -142,26 +156,20 @@ _fecsLoadInternalRoutingInfo
     return NV_OK;
 }
 
-static NV_STATUS
+static void
 fecsExtractTagAndTimestamp
 (
-    OBJGPU *pGpu,
-    KernelGraphics *pKernelGraphics,
+    const NV2080_CTRL_INTERNAL_STATIC_GR_GET_FECS_TRACE_DEFINES *pFecsTraceDefines,
     NvU64 rawTimestamp,
     NvU64 *pTimestampVal,
     NvU8 *pTag
 )
 {
-    const KGRAPHICS_STATIC_INFO *pKernelGraphicsStaticInfo = kgraphicsGetStaticInfo(pGpu, pKernelGraphics);
-    NV_ASSERT_OR_RETURN(pKernelGraphicsStaticInfo != NULL, NV_ERR_INVALID_STATE);
-    NV_ASSERT_OR_RETURN(pKernelGraphicsStaticInfo->pFecsTraceDefines != NULL, NV_ERR_INVALID_STATE);
-
-    *pTag = ((NvU64_HI32(rawTimestamp)) >> pKernelGraphicsStaticInfo->pFecsTraceDefines->timestampHiTagShift) & pKernelGraphicsStaticInfo->pFecsTraceDefines->timestampHiTagMask;
-    *pTimestampVal = rawTimestamp & pKernelGraphicsStaticInfo->pFecsTraceDefines->timestampVMask;
+    *pTag = ((NvU64_HI32(rawTimestamp)) >> pFecsTraceDefines->timestampHiTagShift) & pFecsTraceDefines->timestampHiTagMask;
+    *pTimestampVal = rawTimestamp & pFecsTraceDefines->timestampVMask;
 
     // timestamp encoded as right shifted N bits, since they hold zeros. RM needs to reverse that here.
-    *pTimestampVal <<= pKernelGraphicsStaticInfo->pFecsTraceDefines->numLowerBitsZeroShift;
-    return NV_OK;
+    *pTimestampVal <<= pFecsTraceDefines->numLowerBitsZeroShift;
 }
 
 //
@@ -174,6 +182,9 @@ fecsExtractTagAndTimestamp
 //  whether any entry has been dropped.
 // pRecord is the current FECS entry.
 //
+// The tags and timestamps of the record are decoded once, up front, and the
+// same notification data is then handed to every bound event buffer.
+//
 static void
 formatAndNotifyFecsRecord
 (
@@ -182,7 +193,11 @@ formatAndNotifyFecsRecord
     FECS_EVENT_RECORD  *pRecord
 )
 {
+    const KGRAPHICS_STATIC_INFO *pStaticInfo   = kgraphicsGetStaticInfo(pGpu, pKernelGraphics);
+    KGRAPHICS_FECS_TRACE_INFO   *pFecsTraceInfo = kgraphicsGetFecsTraceInfo(pGpu, pKernelGraphics);
     FECS_EVENT_NOTIFICATION_DATA notifRecord;
+    NvU64                        timestamps[NV_FECS_TRACE_MAX_TIMESTAMPS];
+    NvU8                         tags[NV_FECS_TRACE_MAX_TIMESTAMPS];
     KernelFifo                  *pKernelFifo       = GPU_GET_KERNEL_FIFO(pGpu);
     KernelChannel               *pKernelChannel    = NULL;
     KernelChannel               *pKernelChannelNew = NULL;
@@ -194,7 +209,6 @@ formatAndNotifyFecsRecord
     NvU64                        noisyTimestampRange = 0;
     NvU32                        instSize;
     NvU32                        instShift;
-    NV_STATUS                    status;
 
     if (pRecord == NULL)
     {
@@ -203,6 +217,17 @@ formatAndNotifyFecsRecord
         return;
     }
 
+    NV_ASSERT_OR_RETURN_VOID(pFecsTraceInfo != NULL);
+    NV_ASSERT_OR_RETURN_VOID((pStaticInfo != NULL) && (pStaticInfo->pFecsTraceDefines != NULL));
+
+    for (timestampId = 0; timestampId < NV_FECS_TRACE_MAX_TIMESTAMPS; timestampId++)
+    {
+        fecsExtractTagAndTimestamp(pStaticInfo->pFecsTraceDefines,
+                                   pRecord->ts[timestampId],
+                                   &timestamps[timestampId],
+                                   &tags[timestampId]);
+    }
+
     kfifoGetInstBlkSizeAlign_HAL(pKernelFifo, &instSize, &instShift);
 
     portMemSet(&notifRecord, 0, sizeof(notifRecord));
@@ -232,8 +257,6 @@ formatAndNotifyFecsRecord
 
     if (kgraphicsIsFecsRecordUcodeSeqnoSupported(pGpu, pKernelGraphics))
     {
-        KGRAPHICS_FECS_TRACE_INFO *pFecsTraceInfo = kgraphicsGetFecsTraceInfo(pGpu, pKernelGraphics);
-
         // Dropped at least 1 event
         if ((pFecsTraceInfo->fecsLastSeqno + 1) != pRecord->seqno)
         {
@@ -245,12 +268,8 @@ formatAndNotifyFecsRecord
 
     for (timestampId = 0; timestampId < NV_FECS_TRACE_MAX_TIMESTAMPS; timestampId++)
     {
-        NV_ASSERT_OK_OR_ELSE(status,
-            fecsExtractTagAndTimestamp(pGpu, pKernelGraphics,
-                                       pRecord->ts[timestampId],
-                                       &notifRecord.timestamp,
-                                       &notifRecord.tag),
-            return);
+        notifRecord.timestamp = timestamps[timestampId];
+        notifRecord.tag = tags[timestampId];
 
         //
         // determine a few more fields of the current record by subevent type,
@@ -345,9 +364,6 @@ formatAndNotifyFecsRecord
         if ((pKernelChannel != NULL) || (pKernelChannelNew != NULL))
         {
             FecsEventBufferBindMultiMapSubmap *pSubmap;
-            KGRAPHICS_FECS_TRACE_INFO *pFecsTraceInfo = kgraphicsGetFecsTraceInfo(pGpu, pKernelGraphics);
-
-            NV_ASSERT_OR_RETURN_VOID(pFecsTraceInfo != NULL);
 
             notifRecord.noisyTimestamp = 0;
             if ((noisyTimestampRange > 0) && (pFecsTraceInfo->pFecsLogPrng != NULL))
@@ -712,6 +728,67 @@ fecsBufferChanged
     return NV_FALSE;
 }
 
+static NV_STATUS
+_fecsPollTimerCallback
+(
+    OBJGPU *pGpu,
+    OBJTMR *pTmr,
+    TMR_EVENT *pEvent
+)
+{
+    nvEventBufferFecsCallback(pGpu, pEvent->pUserData);
+    return NV_OK;
+}
+
+//
+// Adjust the polling period of a polled (not interrupt driven) trace after a
+// pass that consumed recordsRead of the ring's bufferSize records, and arm
+// the poll timer if the period dropped below that of the 1Hz callback.
+//
+static void
+_fecsAdaptPollInterval
+(
+    OBJGPU *pGpu,
+    KernelGraphics *pKernelGraphics,
+    KGRAPHICS_FECS_TRACE_INFO *pFecsTraceInfo,
+    NvU32 recordsRead,
+    NvU64 bufferSize
+)
+{
+    OBJTMR *pTmr = GPU_GET_TIMER(pGpu);
+    NvU64 interval = pFecsTraceInfo->fecsPollIntervalNs;
+
+    if (kgraphicsIsIntrDrivenCtxswLoggingEnabled(pGpu, pKernelGraphics))
+        return;
+
+    if (interval == 0)
+        interval = NV_FECS_TRACE_POLL_INTERVAL_MAX_NS;
+
+    if ((recordsRead * 2) >= bufferSize)
+        interval = NV_MAX(interval / 2, NV_FECS_TRACE_POLL_INTERVAL_MIN_NS);
+    else if ((recordsRead * 8) < bufferSize)
+        interval = NV_MIN(interval * 2, NV_FECS_TRACE_POLL_INTERVAL_MAX_NS);
+
+    pFecsTraceInfo->fecsPollIntervalNs = interval;
+
+    if (interval >= NV_FECS_TRACE_POLL_INTERVAL_MAX_NS)
+        return;
+
+    if (pFecsTraceInfo->pFecsPollEvent == NULL)
+    {
+        if (tmrEventCreate(pTmr, &pFecsTraceInfo->pFecsPollEvent,
+                           _fecsPollTimerCallback, pKernelGraphics,
+                           TMR_FLAGS_NONE) != NV_OK)
+        {
+            pFecsTraceInfo->pFecsPollEvent = NULL;
+            return;
+        }
+    }
+
+    if (!tmrEventOnList(pTmr, pFecsTraceInfo->pFecsPollEvent))
+        tmrEventScheduleRel(pTmr, pFecsTraceInfo->pFecsPollEvent, interval);
+}
+
 /**
  * @brief The callback function that transfers FECS Buffer entries to an EventBuffer
  */
@@ -780,7 +857,10 @@ nvEventBufferFecsCallback
                       (fecsReadOffset * fecsRecordSize));
 
         if (pPeekRecord->magic_lo == NV_FECS_TRACE_MAGIC_INVALIDATED)
+        {
+            _fecsAdaptPollInterval(pGpu, pKernelGraphics, pFecsTraceInfo, 0, fecsBufferSize);
             continue;
+        }
 
         // Get the read offset from hw if the buffer wrapped around
         fecsReadOffsetPrev = (fecsReadOffset - 1) % fecsBufferSize;
@@ -873,6 +953,8 @@ nvEventBufferFecsCallback
         }
         pFecsTraceInfo->fecsTraceRdOffset = fecsReadOffset;
 
+        _fecsAdaptPollInterval(pGpu, pKernelGraphics, pFecsTraceInfo, i, fecsBufferSize);
+
         // Re-arm interrupt if there may be more records
         if (i == maxFecsRecordsPerIntr)
             fecsSignalIntrPendingIfNotPending(pGpu, pKernelGraphics);
@@ -1425,6 +1507,17 @@ fecsBufferUnmap
     if (IS_VIRTUAL_WITHOUT_SRIOV(pGpu))
         return;
 
+    // Nothing left to poll once the buffer is unmapped
+    if (pFecsTraceInfo->pFecsPollEvent != NULL)
+    {
+        OBJTMR *pTmr = GPU_GET_TIMER(pGpu);
+
+        tmrEventCancel(pTmr, pFecsTraceInfo->pFecsPollEvent);
+        tmrEventDestroy(pTmr, pFecsTraceInfo->pFecsPollEvent);
+        pFecsTraceInfo->pFecsPollEvent = NULL;
+    }
+    pFecsTraceInfo->fecsPollIntervalNs = 0;
+
     status = _getFecsMemDesc(pGpu, pKernelGraphics, &pFecsMemDesc);
     if ((status == NV_OK) && (pFecsMemDesc != NULL) && (pFecsTraceInfo->pFecsBufferMapping != NULL))
         kbusUnmapRmAperture_HAL(pGpu, pFecsMemDesc,
@@ -28,6 +28,7 @@
 #include "kernel/core/thread_state.h"
 #include "kernel/core/locks.h"
 #include "kernel/diagnostics/gpu_acct.h"
+#include "kernel/diagnostics/profiler.h"
 #include "kernel/gpu/fifo/kernel_channel.h"
 #include "kernel/gpu/intr/engine_idx.h"
 #include "kernel/gpu/mem_mgr/heap.h"
@@ -80,6 +81,16 @@
 
 #define RPC_HDR  ((rpc_message_header_v*)(pRpc->message_buffer))
 
+//
+// _kgspRpcRecvPoll() spins for this long for the quick replies that most RPCs
+// get, and then backs off with increasing delays of up to
+// GSP_RPC_POLL_DELAY_MAX_US between polls of the status queue, which let
+// osDelayUs() give up the CPU while waiting on slow GSP operations.
+//
+#define GSP_RPC_POLL_SPIN_NS      (20 * 1000)
+#define GSP_RPC_POLL_DELAY_MIN_US 20
+#define GSP_RPC_POLL_DELAY_MAX_US 200
+
 struct MIG_CI_UPDATE_CALLBACK_PARAMS
 {
     NvU32 execPartCount;
@@ -112,6 +123,8 @@ static NV_STATUS _kgspRpcSendMessage(OBJGPU *, OBJRPC *);
 static NV_STATUS _kgspRpcRecvPoll(OBJGPU *, OBJRPC *, NvU32);
 static NV_STATUS _kgspRpcDrainEvents(OBJGPU *, KernelGsp *, NvU32);
 static void      _kgspRpcIncrementTimeoutCountAndRateLimitPrints(OBJGPU *, OBJRPC *);
+static void      _kgspRpcRecordResponse(OBJRPC *, NvU32);
+static void      _kgspRpcDumpStats(OBJGPU *, OBJRPC *);
 
 static NV_STATUS _kgspAllocSimAccessBuffer(OBJGPU *pGpu, KernelGsp *pKernelGsp);
 static void _kgspFreeSimAccessBuffer(OBJGPU *pGpu, KernelGsp *pKernelGsp);
@@ -235,11 +248,16 @@ _kgspRpcSendMessage
 {
     NV_STATUS nvStatus;
     KernelGsp *pKernelGsp = GPU_GET_KERNEL_GSP(pGpu);
+    NvU32 seqNum;
+    NvU64 sendNs;
 
     NV_ASSERT(rmDeviceGpuLockIsOwner(pGpu->gpuInstance));
 
     NV_CHECK_OK_OR_RETURN(LEVEL_SILENT, _kgspRpcSanityCheck(pGpu));
 
+    seqNum = pRpc->pMessageQueueInfo->txSeqNum;
+    osGetCurrentTick(&sendNs);
+
     nvStatus = GspMsgQueueSendCommand(pRpc->pMessageQueueInfo, pGpu);
     if (nvStatus != NV_OK)
     {
@@ -265,6 +283,9 @@ _kgspRpcSendMessage
 
         portMemSet(&pRpc->rpcHistory[entry], 0, sizeof(pRpc->rpcHistory[0]));
         pRpc->rpcHistory[entry].function = func;
+        pRpc->rpcHistory[entry].seqNum = seqNum;
+        pRpc->rpcHistory[entry].cmdQueueFree = pRpc->pMessageQueueInfo->txLastFree;
+        pRpc->rpcHistory[entry].ts_start = sendNs;
 
         _kgspGetActiveRpcDebugData(pRpc, func,
                                    &pRpc->rpcHistory[entry].data[0],
@@ -380,6 +401,92 @@ _kgspRpcPostEvent
     return nvStatus;
 }
 
+struct RC_TRIGGERED_CALLBACK_PARAMS
+{
+    RM_ENGINE_TYPE rmEngineType;
+    NvU32          chid;
+    NvHandle       hClient;
+    NvHandle       hChannel;
+    NvU32          exceptType;
+    NvU32          scope;
+    NvU16          partitionAttributionId;
+    NvU64          receivedNs;
+};
+
+/*!
+ * Look up the channel an RC was reported for, if it still exists.
+ */
+static KernelChannel *
+_kgspRpcRCGetKernelChannel
+(
+    OBJGPU        *pGpu,
+    RM_ENGINE_TYPE rmEngineType,
+    NvU32          chid
+)
+{
+    KernelFifo *pKernelFifo = GPU_GET_KERNEL_FIFO(pGpu);
+    CHID_MGR   *pChidMgr;
+
+    if (kfifoGetChidMgrFromType(pGpu, pKernelFifo,
+                                ENGINE_INFO_TYPE_RM_ENGINE_TYPE,
+                                (NvU32)rmEngineType,
+                                &pChidMgr) != NV_OK)
+    {
+        return NULL;
+    }
+
+    return kfifoChidMgrGetKernelChannel(pGpu, pKernelFifo, pChidMgr, chid);
+}
+
+/*!
+ * Send the client notifications of an RC from a work item, so that the GSP
+ * message queue and the RPC being waited for when the RC was received are
+ * not held up by them. Only the lock of the faulting GPU is taken.
+ */
+static void
+_kgspRpcRCTriggeredCallback
+(
+    NvU32 gpuInstance,
+    void *pArgs
+)
+{
+    OBJGPU *pGpu = gpumgrGetGpu(gpuInstance);
+    struct RC_TRIGGERED_CALLBACK_PARAMS *pParams = pArgs;
+    KernelChannel *pKernelChannel;
+    NV_STATUS status;
+    NvU64 now;
+
+    if (pGpu == NULL)
+        return;
+
+    //
+    // The channel may have been freed, and its ChID reused, since the RC was
+    // received. Only notify the channel the RC was reported for.
+    //
+    pKernelChannel = _kgspRpcRCGetKernelChannel(pGpu, pParams->rmEngineType, pParams->chid);
+    if ((pKernelChannel == NULL) ||
+        (RES_GET_CLIENT_HANDLE(pKernelChannel) != pParams->hClient) ||
+        (RES_GET_HANDLE(pKernelChannel) != pParams->hChannel))
+    {
+        NV_PRINTF(LEVEL_INFO,
+                  "RC on ChID %u: channel freed before its notifications were sent\n",
+                  pParams->chid);
+        return;
+    }
+
+    status = krcErrorSendEventNotifications_HAL(pGpu, GPU_GET_KERNEL_RC(pGpu),
+        pKernelChannel,
+        pParams->rmEngineType,  // unused on kernel side
+        pParams->exceptType,
+        pParams->scope,
+        pParams->partitionAttributionId);
+
+    osGetPerformanceCounter(&now);
+    NV_PRINTF(LEVEL_INFO,
+              "RC %u on ChID %u: clients notified %llu us after GSP-RM recovered the channel, status 0x%x\n",
+              pParams->exceptType, pParams->chid, (now - pParams->receivedNs) / 1000, status);
+}
+
 /*!
  * Receive RC notification from GSP-RM.
  *
@@ -397,10 +504,10 @@ _kgspRpcRCTriggered
 
     KernelRc      *pKernelRc = GPU_GET_KERNEL_RC(pGpu);
     KernelChannel *pKernelChannel;
-    KernelFifo    *pKernelFifo = GPU_GET_KERNEL_FIFO(pGpu);
-    CHID_MGR      *pChidMgr;
+    OBJOS         *pOS = GPU_GET_OS(pGpu);
     NvU32          status = NV_OK;
     RM_ENGINE_TYPE rmEngineType = gpuGetRmEngineType(rpc_params->nv2080EngineType);
+    struct RC_TRIGGERED_CALLBACK_PARAMS *pParams;
 
     // check if there's a PCI-E error pending either in device status or in AER
     krcCheckBusError_HAL(pGpu, pKernelRc);
@@ -417,21 +524,16 @@ _kgspRpcRCTriggered
         return status;
     }
 
-    status = kfifoGetChidMgrFromType(pGpu, pKernelFifo,
-                                     ENGINE_INFO_TYPE_RM_ENGINE_TYPE,
-                                     (NvU32)rmEngineType,
-                                     &pChidMgr);
-    if (status != NV_OK)
-        return status;
-
-    pKernelChannel = kfifoChidMgrGetKernelChannel(pGpu, pKernelFifo,
-                                                  pChidMgr,
-                                                  rpc_params->chid);
+    pKernelChannel = _kgspRpcRCGetKernelChannel(pGpu, rmEngineType, rpc_params->chid);
     NV_CHECK_OR_RETURN(LEVEL_ERROR,
                        pKernelChannel != NULL,
                        NV_ERR_INVALID_CHANNEL);
 
-    // With CC enabled, CPU-RM needs to write error notifiers
+    //
+    // With CC enabled, CPU-RM needs to write error notifiers. GSP-RM waits
+    // for them to be written (see ROBUST_CHANNEL_FAST_PATH_ERROR above), so
+    // this is not deferred.
+    //
     if (gpuIsCCFeatureEnabled(pGpu))
     {
         NV_ASSERT_OK_OR_RETURN(krcErrorSetNotifier(pGpu, pKernelRc,
@@ -441,6 +543,33 @@ _kgspRpcRCTriggered
                                                    rpc_params->scope));
     }
 
+    //
+    // GSP-RM has already torn down the channel. Waking up the clients is left
+    // to a work item, falling back to doing it here if it can't be queued.
+    //
+    pParams = portMemAllocNonPaged(sizeof(*pParams));
+    if (pParams != NULL)
+    {
+        pParams->rmEngineType           = rmEngineType;
+        pParams->chid                   = rpc_params->chid;
+        pParams->hClient                = RES_GET_CLIENT_HANDLE(pKernelChannel);
+        pParams->hChannel               = RES_GET_HANDLE(pKernelChannel);
+        pParams->exceptType             = rpc_params->exceptType;
+        pParams->scope                  = rpc_params->scope;
+        pParams->partitionAttributionId = rpc_params->partitionAttributionId;
+        osGetPerformanceCounter(&pParams->receivedNs);
+
+        if (pOS->osQueueWorkItemWithFlags(pGpu,
+                                          _kgspRpcRCTriggeredCallback,
+                                          pParams,
+                                          OS_QUEUE_WORKITEM_FLAGS_LOCK_GPU_GROUP_DEVICE_RW) == NV_OK)
+        {
+            return NV_OK;
+        }
+
+        portMemFree(pParams);
+    }
+
     return krcErrorSendEventNotifications_HAL(pGpu, pKernelRc,
         pKernelChannel,
         rmEngineType,           // unused on kernel side
@@ -489,6 +618,52 @@ _kgspRpcOsErrorLog
  * Receives RPC events containing periodic perfmon utilization samples, passing them
  * to GPUACCT for processing.
  */
+/*!
+ * Publish the newest perfmon util sample and the PMA free/total counts to the
+ * user shared data page, so monitoring clients can poll them without a
+ * control call.
+ */
+static void
+_kgspUpdateUserSharedTelemetry
+(
+    OBJGPU *pGpu,
+    NV2080_CTRL_PERF_GET_GPUMON_PERFMON_UTIL_SAMPLES_V2_PARAMS_v17_00 *pSamples
+)
+{
+    MemoryManager *pMemoryManager = GPU_GET_MEMORY_MANAGER(pGpu);
+    Heap *pHeap = GPU_GET_HEAP(pGpu);
+    NV00DE_SHARED_DATA *pSharedData;
+    NvU32 newest;
+
+    // Skip the copy entirely until some client has mapped the page
+    if (pGpu->userSharedData.pMemDesc == NULL)
+        return;
+
+    // tracker points at the oldest entry, the one before it is the newest
+    newest = (pSamples->tracker + NV2080_CTRL_PERF_GPUMON_SAMPLE_COUNT_PERFMON_UTIL - 1) %
+             NV2080_CTRL_PERF_GPUMON_SAMPLE_COUNT_PERFMON_UTIL;
+
+    pSharedData = gpushareddataWriteStart(pGpu);
+
+    if (pSamples->samples[newest].timeStamp != 0)
+    {
+        pSharedData->utilTimeStamp = pSamples->samples[newest].timeStamp;
+        pSharedData->grUtil        = pSamples->samples[newest].gr.util;
+        pSharedData->fbUtil        = pSamples->samples[newest].fb.util;
+        pSharedData->nvencUtil     = pSamples->samples[newest].nvenc.util;
+        pSharedData->nvdecUtil     = pSamples->samples[newest].nvdec.util;
+    }
+
+    if ((pHeap != NULL) && (pMemoryManager != NULL) &&
+        memmgrIsPmaInitialized(pMemoryManager))
+    {
+        pmaGetFreeMemory(&pHeap->pmaObject, &pSharedData->fbFreeBytes);
+        pmaGetTotalMemory(&pHeap->pmaObject, &pSharedData->fbTotalBytes);
+    }
+
+    gpushareddataWriteFinish(pGpu);
+}
+
 static void
 _kgspRpcGpuacctPerfmonUtilSamples
 (
@@ -505,6 +680,8 @@ _kgspRpcGpuacctPerfmonUtilSamples
     NV2080_CTRL_PERF_GET_GPUMON_PERFMON_UTIL_SAMPLES_V2_PARAMS        *dest;
     NvU32 i;
 
+    _kgspUpdateUserSharedTelemetry(pGpu, src);
+
     dest = pGpuInstanceInfo->pSamplesParams;
     if (dest == NULL)
     {
@@ -1218,10 +1395,144 @@ _kgspProcessRpcEvent
     return nvStatus;
 }
 
+/*!
+ * Whether an event only notifies CPU-RM of something and can be processed after
+ * the RPC being waited for completes. GSP-RM never waits on these.
+ */
+static NvBool
+_kgspRpcEventIsDeferrable
+(
+    NvU32 function
+)
+{
+    switch (function)
+    {
+        case NV_VGPU_MSG_EVENT_POST_EVENT:
+        case NV_VGPU_MSG_EVENT_OS_ERROR_LOG:
+        case NV_VGPU_MSG_EVENT_GPUACCT_PERFMON_UTIL_SAMPLES:
+        case NV_VGPU_MSG_EVENT_PERF_GPU_BOOST_SYNC_LIMITS_CALLBACK:
+        case NV_VGPU_MSG_EVENT_PERF_BRIDGELESS_INFO_UPDATE:
+        case NV_VGPU_MSG_EVENT_NVLINK_INBAND_RECEIVED_DATA_256:
+        case NV_VGPU_MSG_EVENT_NVLINK_INBAND_RECEIVED_DATA_512:
+        case NV_VGPU_MSG_EVENT_NVLINK_INBAND_RECEIVED_DATA_1024:
+        case NV_VGPU_MSG_EVENT_NVLINK_INBAND_RECEIVED_DATA_2048:
+        case NV_VGPU_MSG_EVENT_NVLINK_INBAND_RECEIVED_DATA_4096:
+        case NV_VGPU_MSG_EVENT_UCODE_LIBOS_PRINT:
+            return NV_TRUE;
+        default:
+            return NV_FALSE;
+    }
+}
+
+/*!
+ * Process the deferred events in the order they were received. Each event is
+ * copied back into the staging area, which must not hold an unprocessed
+ * message.
+ */
+static void
+_kgspRpcProcessDeferredEvents
+(
+    OBJGPU *pGpu,
+    OBJRPC *pRpc
+)
+{
+    NV_ASSERT(rmDeviceGpuLockIsOwner(pGpu->gpuInstance));
+
+    while (pRpc->pDeferredEventsHead != NULL)
+    {
+        RpcDeferredEvent *pEvent = pRpc->pDeferredEventsHead;
+        NV_STATUS nvStatus;
+
+        pRpc->pDeferredEventsHead = pEvent->pNext;
+        if (pRpc->pDeferredEventsHead == NULL)
+            pRpc->pDeferredEventsTail = NULL;
+
+        portMemCopy(pRpc->message_buffer, pRpc->maxRpcSize, pEvent->message, pEvent->length);
+        portMemFree(pEvent);
+
+        nvStatus = _kgspProcessRpcEvent(pGpu, pRpc);
+        if (nvStatus != NV_OK)
+        {
+            NV_PRINTF(LEVEL_ERROR,
+                      "Failed to process deferred event 0x%x (%s) from GPU%d: status=0x%x\n",
+                      RPC_HDR->function, _getRpcName(RPC_HDR->function), gpuGetInstance(pGpu), nvStatus);
+        }
+    }
+}
+
+static void
+_kgspRpcDeferredEventsCallback
+(
+    NvU32 gpuInstance,
+    void *pArgs
+)
+{
+    OBJGPU *pGpu = gpumgrGetGpu(gpuInstance);
+    KernelGsp *pKernelGsp;
+
+    if (pGpu == NULL)
+        return;
+
+    pKernelGsp = GPU_GET_KERNEL_GSP(pGpu);
+    if (pKernelGsp == NULL || pKernelGsp->pRpc == NULL)
+        return;
+
+    pKernelGsp->pRpc->bDeferredEventsScheduled = NV_FALSE;
+
+    _kgspRpcProcessDeferredEvents(pGpu, pKernelGsp->pRpc);
+}
+
+/*!
+ * Queue a copy of the event in the staging area for processing by a work item.
+ * If bSchedule is NV_FALSE, the caller processes the queue itself.
+ */
+static NV_STATUS
+_kgspRpcDeferEvent
+(
+    OBJGPU *pGpu,
+    OBJRPC *pRpc,
+    NvBool  bSchedule
+)
+{
+    NvU32 length = NV_MIN(RPC_HDR->length, pRpc->maxRpcSize);
+    RpcDeferredEvent *pEvent;
+
+    if (bSchedule && !pRpc->bDeferredEventsScheduled)
+    {
+        OBJOS *pOS = GPU_GET_OS(pGpu);
+
+        NV_CHECK_OK_OR_RETURN(LEVEL_INFO,
+            pOS->osQueueWorkItemWithFlags(pGpu,
+                                          _kgspRpcDeferredEventsCallback,
+                                          NULL,
+                                          OS_QUEUE_WORKITEM_FLAGS_LOCK_GPU_GROUP_DEVICE_RW));
+        pRpc->bDeferredEventsScheduled = NV_TRUE;
+    }
+
+    pEvent = portMemAllocNonPaged(sizeof(*pEvent) + length);
+    if (pEvent == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    pEvent->pNext = NULL;
+    pEvent->length = length;
+    portMemCopy(pEvent->message, length, pRpc->message_buffer, length);
+
+    if (pRpc->pDeferredEventsTail != NULL)
+        pRpc->pDeferredEventsTail->pNext = pEvent;
+    else
+        pRpc->pDeferredEventsHead = pEvent;
+    pRpc->pDeferredEventsTail = pEvent;
+
+    return NV_OK;
+}
+
 /*!
  * Handle a single RPC event from GSP unless the event is [an RPC return for] expectedFunc,
  * or there are no events available in the buffer.
  *
+ * While polling for an RPC reply, events that GSP-RM does not wait on are
+ * deferred to a work item to keep their processing out of the RPC latency.
+ *
  * @return
  *   NV_OK                              if the event is successfully handled.
  *   NV_WARN_NOTHING_TO_DO              if there are no events available.
@@ -1248,9 +1559,29 @@ _kgspRpcDrainOneEvent
     if (nvStatus == NV_OK)
     {
         rpc_message_header_v *pMsgHdr = RPC_HDR;
+        KernelGsp *pKernelGsp = GPU_GET_KERNEL_GSP(pGpu);
+
         if (pMsgHdr->function == expectedFunc)
             return NV_WARN_MORE_PROCESSING_REQUIRED;
 
+        if (pKernelGsp->bPollingForRpcResponse)
+        {
+            if (_kgspRpcEventIsDeferrable(pMsgHdr->function) &&
+                (_kgspRpcDeferEvent(pGpu, pRpc, NV_TRUE) == NV_OK))
+            {
+                return NV_OK;
+            }
+        }
+        else if (pRpc->pDeferredEventsHead != NULL)
+        {
+            // Keep the event ordered after the deferred ones
+            if (_kgspRpcDeferEvent(pGpu, pRpc, NV_FALSE) == NV_OK)
+            {
+                _kgspRpcProcessDeferredEvents(pGpu, pRpc);
+                return NV_OK;
+            }
+        }
+
         nvStatus = _kgspProcessRpcEvent(pGpu, pRpc);
         if (nvStatus != NV_OK)
         {
@@ -1367,19 +1698,28 @@ _kgspLogXid119
         }
 
         NV_PRINTF(LEVEL_ERROR, "RPC history (CPU -> GSP%d):\n", gpuGetInstance(pGpu));
-        NV_PRINTF(LEVEL_ERROR, "\tentry\tfunc\t\t\t\tdata\n");
+        NV_PRINTF(LEVEL_ERROR, "\tentry\tseq\tfunc\t\t\t\tdata\t\t\tqfree\tlatency (us)\n");
         for (historyIndex = 0; historyIndex < RPC_HISTORY_DEPTH; historyIndex++)
         {
+            RpcHistoryEntry *pEntry;
+
             historyEntry = (pRpc->rpcHistoryCurrent + RPC_HISTORY_DEPTH - historyIndex) % RPC_HISTORY_DEPTH;
-            NV_PRINTF(LEVEL_ERROR, "\t%c%-2d\t%2d %-22s\t0x%08x 0x%08x\n",
+            pEntry = &pRpc->rpcHistory[historyEntry];
+            NV_PRINTF(LEVEL_ERROR, "\t%c%-2d\t%u\t%2d %-22s\t0x%08x 0x%08x\t%u\t%llu%s\n",
                       ((historyIndex == 0) ? ' ' : '-'),
                       historyIndex,
-                      pRpc->rpcHistory[historyEntry].function,
-                      _getRpcName(pRpc->rpcHistory[historyEntry].function),
-                      pRpc->rpcHistory[historyEntry].data[0],
-                      pRpc->rpcHistory[historyEntry].data[1]);
+                      pEntry->seqNum,
+                      pEntry->function,
+                      _getRpcName(pEntry->function),
+                      pEntry->data[0],
+                      pEntry->data[1],
+                      pEntry->cmdQueueFree,
+                      (pEntry->ts_end != 0) ? (pEntry->ts_end - pEntry->ts_start) / 1000 : 0,
+                      (pEntry->ts_end != 0) ? "" : " (pending)");
         }
 
+        _kgspRpcDumpStats(pGpu, pRpc);
+
         osAssertFailed();
 
         NV_PRINTF(LEVEL_ERROR,
@@ -1427,6 +1767,85 @@ _kgspRpcIncrementTimeoutCountAndRateLimitPrints
                           ((pRpc->timeoutCount % (RPC_TIMEOUT_LIMIT_PRINT_RATE_SKIP + 1)) != 0));
 }
 
+/*!
+ * Record the response to the RPC most recently sent on @p pRpc.
+ */
+static void
+_kgspRpcRecordResponse
+(
+    OBJRPC *pRpc,
+    NvU32   expectedFunc
+)
+{
+    RpcHistoryEntry  *pEntry = &pRpc->rpcHistory[pRpc->rpcHistoryCurrent];
+    RpcFunctionStats *pStats;
+    NvU64             latencyNs;
+    NvU32             bucket;
+
+    // Events such as GSP_INIT_DONE are polled for without a matching send
+    if ((pEntry->function != expectedFunc) || (pEntry->ts_end != 0))
+        return;
+
+    osGetCurrentTick(&pEntry->ts_end);
+
+    if ((pRpc->pFunctionStats == NULL) ||
+        (expectedFunc >= NV_VGPU_MSG_FUNCTION_NUM_FUNCTIONS))
+    {
+        return;
+    }
+
+    latencyNs = pEntry->ts_end - pEntry->ts_start;
+    bucket = 64 - portUtilCountLeadingZeros64(latencyNs / 1000);
+
+    pStats = &pRpc->pFunctionStats[expectedFunc];
+    pStats->count++;
+    pStats->latencyUs[NV_MIN(bucket, RPC_STATS_LATENCY_BUCKETS - 1)]++;
+    pStats->maxNs = NV_MAX(pStats->maxNs, latencyNs);
+}
+
+/*!
+ * Print the per-function RPC latency histograms and command queue statistics.
+ */
+static void
+_kgspRpcDumpStats
+(
+    OBJGPU *pGpu,
+    OBJRPC *pRpc
+)
+{
+    MESSAGE_QUEUE_INFO *pMQI = pRpc->pMessageQueueInfo;
+    NvU32 func;
+    NvU32 bucket;
+
+    if (pRpc->pFunctionStats == NULL)
+        return;
+
+    NV_PRINTF(LEVEL_NOTICE,
+              "GSP%d RPC queue %u: %u elements high water, %u free at idle, %u sends waited for space\n",
+              gpuGetInstance(pGpu), pMQI->queueIdx, pMQI->txUsedHighWater,
+              pMQI->txFreeMax, pMQI->txSpaceWaits);
+
+    for (func = 0; func < NV_VGPU_MSG_FUNCTION_NUM_FUNCTIONS; func++)
+    {
+        RpcFunctionStats *pStats = &pRpc->pFunctionStats[func];
+
+        if (pStats->count == 0)
+            continue;
+
+        NV_PRINTF(LEVEL_NOTICE, "    %2d %-22s %u calls, max %llu us\n",
+                  func, _getRpcName(func), pStats->count, pStats->maxNs / 1000);
+
+        for (bucket = 0; bucket < RPC_STATS_LATENCY_BUCKETS; bucket++)
+        {
+            if (pStats->latencyUs[bucket] == 0)
+                continue;
+
+            NV_PRINTF(LEVEL_NOTICE, "        < 2^%u us: %u\n",
+                      bucket, pStats->latencyUs[bucket]);
+        }
+    }
+}
+
 /*!
  * GSP client RM RPC poll routine
  */
@@ -1445,6 +1864,9 @@ _kgspRpcRecvPoll
     NvU32      timeoutUs;
     NvU32      timeoutFlags;
     NvBool     bSlowGspRpc = IS_EMULATION(pGpu) || IS_SIMULATION(pGpu);
+    NvU64      pollStartNs;
+    NvU64      nowNs;
+    NvU32      pollDelayUs = 0;
 
     //
     // We do not allow recursive polling. This can happen if e.g.
@@ -1500,6 +1922,8 @@ _kgspRpcRecvPoll
 
     gpuSetTimeout(pGpu, timeoutUs, &timeout, timeoutFlags);
 
+    osGetCurrentTick(&pollStartNs);
+
     for (;;)
     {
         //
@@ -1545,6 +1969,18 @@ _kgspRpcRecvPoll
         }
 
         osSpinLoop();
+
+        if (pollDelayUs == 0)
+        {
+            osGetCurrentTick(&nowNs);
+            if (nowNs - pollStartNs < GSP_RPC_POLL_SPIN_NS)
+                continue;
+
+            pollDelayUs = GSP_RPC_POLL_DELAY_MIN_US;
+        }
+
+        osDelayUs(pollDelayUs);
+        pollDelayUs = NV_MIN(pollDelayUs * 2, GSP_RPC_POLL_DELAY_MAX_US);
     }
 
     pRpc->timeoutCount = 0;
@@ -1552,6 +1988,9 @@ _kgspRpcRecvPoll
 done:
     pKernelGsp->bPollingForRpcResponse = NV_FALSE;
 
+    if (rpcStatus == NV_OK)
+        _kgspRpcRecordResponse(pRpc, expectedFunc);
+
     if (bSlowGspRpc)
     {
         // Avoid cumulative timeout due to slow RPC
@@ -1643,6 +2082,15 @@ _kgspConstructRpcObject
 
     portMemSet(&pRpc->rpcHistory, 0, sizeof(pRpc->rpcHistory));
     pRpc->rpcHistoryCurrent   = RPC_HISTORY_DEPTH - 1;
+
+    // Latency statistics are best effort, RPCs work without them
+    pRpc->pFunctionStats = portMemAllocNonPaged(sizeof(RpcFunctionStats) *
+                                                NV_VGPU_MSG_FUNCTION_NUM_FUNCTIONS);
+    if (pRpc->pFunctionStats != NULL)
+    {
+        portMemSet(pRpc->pFunctionStats, 0,
+                   sizeof(RpcFunctionStats) * NV_VGPU_MSG_FUNCTION_NUM_FUNCTIONS);
+    }
     pRpc->message_buffer  = (NvU32 *)pRpc->pMessageQueueInfo->pRpcMsgBuf;
     pRpc->maxRpcSize      = GSP_MSG_QUEUE_RPC_SIZE_MAX;
 
@@ -1663,12 +2111,27 @@ _kgspFreeRpcInfrastructure
 {
     if (pKernelGsp->pRpc != NULL)
     {
+        while (pKernelGsp->pRpc->pDeferredEventsHead != NULL)
+        {
+            RpcDeferredEvent *pEvent = pKernelGsp->pRpc->pDeferredEventsHead;
+
+            pKernelGsp->pRpc->pDeferredEventsHead = pEvent->pNext;
+            portMemFree(pEvent);
+        }
+        pKernelGsp->pRpc->pDeferredEventsTail = NULL;
+
+        _kgspRpcDumpStats(pGpu, pKernelGsp->pRpc);
+        portMemFree(pKernelGsp->pRpc->pFunctionStats);
+
         rpcDestroy(pGpu, pKernelGsp->pRpc);
         portMemFree(pKernelGsp->pRpc);
         pKernelGsp->pRpc = NULL;
     }
     if (pKernelGsp->pLocklessRpc != NULL)
     {
+        _kgspRpcDumpStats(pGpu, pKernelGsp->pLocklessRpc);
+        portMemFree(pKernelGsp->pLocklessRpc->pFunctionStats);
+
         rpcDestroy(pGpu, pKernelGsp->pLocklessRpc);
         portMemFree(pKernelGsp->pLocklessRpc);
         pKernelGsp->pLocklessRpc = NULL;
@@ -2275,6 +2738,31 @@ _kgspVbiosVersionToStr(NvU64 vbiosVersionCombined, char *pVbiosVersionStr, NvU32
                   (vbiosVersionCombined) & 0xff);
 }
 
+/*!
+ * Add a step of GSP boot to the GPU boot trace, if one is being recorded.
+ *
+ * A step lasts from *pStepStartNs to now, and *pStepStartNs is moved to now
+ * for the next step. The steps are sub-steps of the caller's own step, so
+ * they do not end it.
+ */
+static void
+_kgspBootTraceStep
+(
+    OBJGPU     *pGpu,
+    NvU64      *pStepStartNs,
+    const char *pName
+)
+{
+    NvU64 now;
+
+    if (pGpu->pBootTrace == NULL)
+        return;
+
+    osGetPerformanceCounter(&now);
+    rmProfTraceRecord(pGpu->pBootTrace, pName, now - *pStepStartNs);
+    *pStepStartNs = now;
+}
+
 /*!
  * Initialize GSP-RM
  *
@@ -2296,10 +2784,13 @@ kgspInitRm_IMPL
     NV_STATUS  status = NV_OK;
     OBJTMR    *pTmr = GPU_GET_TIMER(pGpu);
     GPU_MASK   gpusLockedMask = 0;
+    NvU64      stepStartNs;
 
     if (!IS_GSP_CLIENT(pGpu))
         return NV_OK;
 
+    osGetPerformanceCounter(&stepStartNs);
+
     if ((pGspFw == NULL) || (pGspFw->pBuf == NULL) || (pGspFw->size == 0))
     {
         NV_PRINTF(LEVEL_ERROR, "need firmware to initialize GSP\n");
@@ -2373,6 +2864,7 @@ kgspInitRm_IMPL
             goto done;
         }
 
+        _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: VBIOS FWSEC parse");
     }
 
     /*
@@ -2414,6 +2906,7 @@ kgspInitRm_IMPL
                 goto done;
             }
         }
+        _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: booter ucode");
     }
 
     // Prepare boot binary image.
@@ -2438,9 +2931,12 @@ kgspInitRm_IMPL
     if (pKernelGsp->pLogElf == NULL)
         NV_CHECK_OK_OR_GOTO(status, LEVEL_ERROR, nvlogRegisterFlushCb(kgspNvlogFlushCb, pKernelGsp), done);
 
+    _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: firmware images");
+
     // Reset thread state timeout and wait for GFW_BOOT OK status
     threadStateResetTimeout(pGpu);
     NV_CHECK_OK_OR_GOTO(status, LEVEL_ERROR, kgspWaitForGfwBootOk_HAL(pGpu, pKernelGsp), done);
+    _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: GFW boot wait");
 
     // Fail early if WPR2 is up
     if (kgspIsWpr2Up_HAL(pGpu, pKernelGsp))
@@ -2486,6 +2982,7 @@ kgspInitRm_IMPL
                       prescrubbedSize, neededSize);
         }
     }
+    _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: FB layout, scrubber");
 
     // bring up ucode with RM offload task
     status = kgspBootstrapRiscvOSEarly_HAL(pGpu, pKernelGsp, pGspFw);
@@ -2501,6 +2998,7 @@ kgspInitRm_IMPL
         (void)kgspHealthCheck_HAL(pGpu, pKernelGsp);
         goto done;
     }
+    _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: bootstrap");
 
     // at this point we should be able to exchange RPCs with RM offload task
     NV_RM_RPC_SET_GUEST_SYSTEM_INFO(pGpu, status);
@@ -2516,6 +3014,7 @@ kgspInitRm_IMPL
         NV_PRINTF(LEVEL_ERROR, "GET_GSP_STATIC_INFO failed: 0x%x\n", status);
         goto done;
     }
+    _kgspBootTraceStep(pGpu, &stepStartNs, "GSP: init RPCs");
 
     NV_CHECK_OK_OR_GOTO(status, LEVEL_ERROR, kgspStartLogPolling(pGpu, pKernelGsp), done);
 
@@ -486,8 +486,27 @@ static NV_INLINE NvU32 _checkSum32(void *pData, NvU32 uLen)
 {
     NvU64 *p        = (NvU64 *)pData;
     NvU64 *pEnd     = (NvU64 *)((NvUPtr)pData + uLen);
-    NvU64  checkSum = 0;
+    NvU64  sum0     = 0;
+    NvU64  sum1     = 0;
+    NvU64  sum2     = 0;
+    NvU64  sum3     = 0;
+    NvU64  checkSum;
 
+    //
+    // Queue elements are multiples of GSP_MSG_QUEUE_ELEMENT_SIZE_MIN, so the
+    // bulk of the data goes through independent accumulators, 32 bytes
+    // at a time, instead of one serialized XOR chain.
+    //
+    while ((NvUPtr)(pEnd - p) >= 4)
+    {
+        sum0 ^= p[0];
+        sum1 ^= p[1];
+        sum2 ^= p[2];
+        sum3 ^= p[3];
+        p += 4;
+    }
+
+    checkSum = sum0 ^ sum1 ^ sum2 ^ sum3;
     while (p < pEnd)
         checkSum ^= *p++;
 
@@ -510,9 +529,14 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
     GSP_MSG_QUEUE_ELEMENT *pCQE = pMQI->pCmdQueueElement;
     NvU8      *pSrc             = (NvU8 *)pCQE;
     NvU8      *pNextElement     = NULL;
+    NvU8      *pRunDst          = NULL;
+    NvU8      *pRunSrc          = NULL;
+    NvU32      runSize          = 0;
     int        nRet;
     NvU32      i;
     NvU32      nRetries;
+    NvU32      txFree;
+    NvBool     bWaitedForSpace  = NV_FALSE;
     RMTIMEOUT  timeout;
     NV_STATUS  nvStatus         = NV_OK;
     NvU32      uElementSize     = GSP_MSG_QUEUE_ELEMENT_HDR_SIZE +
@@ -559,6 +583,15 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
 
     pCQE->checkSum  = _checkSum32(pSrc, pCQE->elemCount * GSP_MSG_QUEUE_ELEMENT_SIZE_MIN);
 
+    //
+    // Track command queue occupancy. The queue capacity is not exposed by
+    // msgq, so the most elements ever seen free stands in for it.
+    //
+    txFree = msgqTxGetFreeSpace(pMQI->hQueue);
+    pMQI->txLastFree      = txFree;
+    pMQI->txFreeMax       = NV_MAX(pMQI->txFreeMax, txFree);
+    pMQI->txUsedHighWater = NV_MAX(pMQI->txUsedHighWater, pMQI->txFreeMax - txFree);
+
     for (i = 0; i < pCQE->elemCount; i++)
     {
         NvU32 timeoutFlags = 0;
@@ -578,6 +611,8 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
             if (pNextElement != NULL)
                 break;
 
+            bWaitedForSpace = NV_TRUE;
+
             if (gpuCheckTimeout(pGpu, &timeout) != NV_OK)
                 break;
 
@@ -588,6 +623,7 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
 
         if (pNextElement == NULL)
         {
+            // Nothing is submitted, so the partial copy is simply discarded.
             pMQI->txBufferFull++;
             NV_PRINTF_COND(pMQI->txBufferFull == 1, LEVEL_ERROR, LEVEL_INFO, "buffer is full\n");
             nvStatus = NV_ERR_BUSY_RETRY;
@@ -598,11 +634,30 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
             pMQI->txBufferFull = 0;
         }
 
-        portMemCopy(pNextElement, GSP_MSG_QUEUE_ELEMENT_SIZE_MIN,
-                    pSrc,         GSP_MSG_QUEUE_ELEMENT_SIZE_MIN);
-        pSrc += GSP_MSG_QUEUE_ELEMENT_SIZE_MIN;
+        //
+        // Elements are only discontiguous where the ring wraps, so copy them
+        // in runs: at most two copies per record instead of one per element.
+        //
+        if ((pRunDst != NULL) && (pNextElement != pRunDst + runSize))
+        {
+            portMemCopy(pRunDst, runSize, pRunSrc, runSize);
+            pRunDst = NULL;
+        }
+
+        if (pRunDst == NULL)
+        {
+            pRunDst = pNextElement;
+            pRunSrc = pSrc;
+            runSize = 0;
+        }
+
+        runSize += GSP_MSG_QUEUE_ELEMENT_SIZE_MIN;
+        pSrc    += GSP_MSG_QUEUE_ELEMENT_SIZE_MIN;
     }
 
+    if (pRunDst != NULL)
+        portMemCopy(pRunDst, runSize, pRunSrc, runSize);
+
     //
     // If write after write (WAW) memory ordering is relaxed in a CPU, then
     // it's possible that below msgq update reaches memory first followed by
@@ -628,6 +683,9 @@ NV_STATUS GspMsgQueueSendCommand(MESSAGE_QUEUE_INFO *pMQI, OBJGPU *pGpu)
     nvStatus = NV_OK;
 
 done:
+    if (bWaitedForSpace)
+        pMQI->txSpaceWaits++;
+
     return nvStatus;
 }
 
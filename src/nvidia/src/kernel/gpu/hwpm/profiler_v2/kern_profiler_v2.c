@@ -82,6 +82,7 @@ profilerBaseDestruct_IMPL
     ProfilerBase *pProf
 )
 {
+    profilerBasePmaWatermarkDestroy(pProf);
     profilerBaseDestructState_HAL(pProf);
 }
 
@@ -30,6 +30,11 @@
 #include "ctrl/ctrlb0cc/ctrlb0ccprofiler.h"
 #include "mem_mgr/mem.h"
 #include "vgpu/rpc.h"
+#include "core/system.h"
+#include "gpu_mgr/gpu_mgr.h"
+#include "objtmr.h"
+#include "os/os.h"
+#include "class/cl2080_notification.h"
 
 static NV_STATUS _issueRpcToHost(OBJGPU *pGpu)
 {
@@ -102,6 +107,12 @@ profilerBaseCtrlCmdFreePmaStream_IMPL
     }
 err:
 
+    if (pProfiler->pPmaWatermarks != NULL &&
+        pProfiler->maxPmaChannels > pParams->pmaChannelIdx)
+    {
+        pProfiler->pPmaWatermarks[pParams->pmaChannelIdx].watermarkBytes = 0;
+    }
+
     return pRmApi->Control(pRmApi,
                            RES_GET_CLIENT_HANDLE(pProfiler),
                            RES_GET_HANDLE(pProfiler),
@@ -351,3 +362,227 @@ fail:
     return status;
 }
 
+
+typedef struct
+{
+    NvHandle hClient;
+    NvHandle hObject;
+} PROFILER_PMA_WATERMARK_WORKITEM_PARAMS;
+
+static NvBool
+_profilerPmaWatermarkArmed
+(
+    ProfilerBase *pProfiler
+)
+{
+    NvU32 i;
+
+    if (pProfiler->pPmaWatermarks == NULL)
+        return NV_FALSE;
+
+    for (i = 0; i < pProfiler->maxPmaChannels; i++)
+    {
+        if (pProfiler->pPmaWatermarks[i].watermarkBytes != 0)
+            return NV_TRUE;
+    }
+
+    return NV_FALSE;
+}
+
+static void
+_profilerPmaWatermarkSchedule
+(
+    ProfilerBase *pProfiler
+)
+{
+    OBJGPU *pGpu = GPU_RES_GET_GPU(pProfiler);
+    OBJTMR *pTmr = GPU_GET_TIMER(pGpu);
+
+    if (pProfiler->pPmaWatermarkEvent == NULL ||
+        !_profilerPmaWatermarkArmed(pProfiler) ||
+        tmrEventOnList(pTmr, pProfiler->pPmaWatermarkEvent))
+    {
+        return;
+    }
+
+    tmrEventScheduleRel(pTmr, pProfiler->pPmaWatermarkEvent,
+                        (NvU64)pProfiler->pmaWatermarkPollIntervalUs * 1000);
+}
+
+//
+// Samples the bytes available of every stream with an armed watermark and
+// notifies once per crossing. Runs with the API and GPU locks held, after
+// looking the profiler up again in case it was freed since the timer fired.
+//
+static void
+_profilerPmaWatermark_WORKITEM
+(
+    NvU32 gpuInstance,
+    void *pArgs
+)
+{
+    PROFILER_PMA_WATERMARK_WORKITEM_PARAMS *pWorkParams = pArgs;
+    OBJGPU        *pGpu = gpumgrGetGpu(gpuInstance);
+    RsResourceRef *pRef;
+    ProfilerBase  *pProfiler;
+    RM_API        *pRmApi;
+    NvU32          i;
+
+    if (pGpu == NULL ||
+        serverutilGetResourceRefWithType(pWorkParams->hClient, pWorkParams->hObject,
+                                         classId(ProfilerBase), &pRef) != NV_OK)
+    {
+        return;
+    }
+
+    pProfiler = dynamicCast(pRef->pResource, ProfilerBase);
+    if (pProfiler == NULL || pProfiler->pPmaWatermarks == NULL)
+        return;
+
+    pRmApi = GPU_GET_PHYSICAL_RMAPI(pGpu);
+
+    for (i = 0; i < pProfiler->maxPmaChannels; i++)
+    {
+        PROFILER_PMA_STREAM_WATERMARK *pWatermark = &pProfiler->pPmaWatermarks[i];
+        NVB0CC_CTRL_PMA_STREAM_UPDATE_GET_PUT_PARAMS getPutParams;
+
+        if (pWatermark->watermarkBytes == 0)
+            continue;
+
+        portMemSet(&getPutParams, 0, sizeof(getPutParams));
+        getPutParams.pmaChannelIdx = i;
+        getPutParams.bUpdateAvailableBytes = NV_TRUE;
+        getPutParams.bWait = NV_TRUE;
+
+        if (pRmApi->Control(pRmApi, pWorkParams->hClient, pWorkParams->hObject,
+                            NVB0CC_CTRL_CMD_PMA_STREAM_UPDATE_GET_PUT,
+                            &getPutParams, sizeof(getPutParams)) != NV_OK)
+        {
+            continue;
+        }
+
+        if (getPutParams.bytesAvailable >= pWatermark->watermarkBytes)
+        {
+            if (!pWatermark->bNotified)
+            {
+                pWatermark->bNotified = NV_TRUE;
+                gpuNotifySubDeviceEvent(pGpu, NV2080_NOTIFIERS_PMA_STREAM_WATERMARK,
+                                        NULL, 0, i, 0);
+            }
+        }
+        else
+        {
+            pWatermark->bNotified = NV_FALSE;
+        }
+    }
+
+    _profilerPmaWatermarkSchedule(pProfiler);
+}
+
+static NV_STATUS
+_profilerPmaWatermarkTimerCallback
+(
+    OBJGPU *pGpu,
+    OBJTMR *pTmr,
+    TMR_EVENT *pEvent
+)
+{
+    ProfilerBase *pProfiler = pEvent->pUserData;
+    OBJSYS *pSys = SYS_GET_INSTANCE();
+    OBJOS *pOS = SYS_GET_OS(pSys);
+    PROFILER_PMA_WATERMARK_WORKITEM_PARAMS *pWorkParams;
+
+    pWorkParams = portMemAllocNonPaged(sizeof(*pWorkParams));
+    if (pWorkParams == NULL)
+    {
+        _profilerPmaWatermarkSchedule(pProfiler);
+        return NV_OK;
+    }
+
+    pWorkParams->hClient = RES_GET_CLIENT_HANDLE(pProfiler);
+    pWorkParams->hObject = RES_GET_HANDLE(pProfiler);
+
+    // The control to sample the stream needs the API lock
+    if (pOS->osQueueWorkItemWithFlags(pGpu, _profilerPmaWatermark_WORKITEM, pWorkParams,
+                                      OS_QUEUE_WORKITEM_FLAGS_LOCK_API_RW |
+                                      OS_QUEUE_WORKITEM_FLAGS_LOCK_GPUS_RW) != NV_OK)
+    {
+        portMemFree(pWorkParams);
+        _profilerPmaWatermarkSchedule(pProfiler);
+    }
+
+    return NV_OK;
+}
+
+NV_STATUS
+profilerBaseCtrlCmdPmaStreamSetWatermark_IMPL
+(
+    ProfilerBase *pProfiler,
+    NVB0CC_CTRL_PMA_STREAM_SET_WATERMARK_PARAMS *pParams
+)
+{
+    OBJGPU *pGpu = GPU_RES_GET_GPU(pProfiler);
+    OBJTMR *pTmr = GPU_GET_TIMER(pGpu);
+    PROFILER_PMA_STREAM_WATERMARK *pWatermark;
+
+    // The stream must have been allocated through this profiler
+    NV_CHECK_OR_RETURN(LEVEL_INFO,
+        pProfiler->ppBytesAvailable != NULL &&
+        pParams->pmaChannelIdx < pProfiler->maxPmaChannels &&
+        pProfiler->ppBytesAvailable[pParams->pmaChannelIdx] != NULL,
+        NV_ERR_INVALID_ARGUMENT);
+
+    if (pProfiler->pPmaWatermarks == NULL)
+    {
+        if (pParams->watermarkBytes == 0)
+            return NV_OK;
+
+        pProfiler->pPmaWatermarks = portMemAllocNonPaged(pProfiler->maxPmaChannels *
+                                                         sizeof(PROFILER_PMA_STREAM_WATERMARK));
+        NV_ASSERT_OR_RETURN(pProfiler->pPmaWatermarks != NULL, NV_ERR_NO_MEMORY);
+        portMemSet(pProfiler->pPmaWatermarks, 0,
+                   pProfiler->maxPmaChannels * sizeof(PROFILER_PMA_STREAM_WATERMARK));
+    }
+
+    if (pProfiler->pPmaWatermarkEvent == NULL && pParams->watermarkBytes != 0)
+    {
+        NV_ASSERT_OK_OR_RETURN(tmrEventCreate(pTmr, &pProfiler->pPmaWatermarkEvent,
+                                              _profilerPmaWatermarkTimerCallback,
+                                              pProfiler, TMR_FLAGS_NONE));
+    }
+
+    pWatermark = &pProfiler->pPmaWatermarks[pParams->pmaChannelIdx];
+    pWatermark->watermarkBytes = pParams->watermarkBytes;
+    pWatermark->bNotified = NV_FALSE;
+
+    // The poll interval is shared by all the streams of the profiler
+    if (pParams->watermarkBytes != 0)
+    {
+        pProfiler->pmaWatermarkPollIntervalUs = (pParams->pollIntervalUs == 0) ?
+            NVB0CC_PMA_STREAM_WATERMARK_POLL_INTERVAL_US_DEFAULT :
+            NV_MAX(pParams->pollIntervalUs, NVB0CC_PMA_STREAM_WATERMARK_POLL_INTERVAL_US_MIN);
+    }
+
+    _profilerPmaWatermarkSchedule(pProfiler);
+
+    return NV_OK;
+}
+
+void
+profilerBasePmaWatermarkDestroy
+(
+    ProfilerBase *pProfiler
+)
+{
+    OBJTMR *pTmr = GPU_GET_TIMER(GPU_RES_GET_GPU(pProfiler));
+
+    if (pProfiler->pPmaWatermarkEvent != NULL)
+    {
+        tmrEventCancel(pTmr, pProfiler->pPmaWatermarkEvent);
+        tmrEventDestroy(pTmr, pProfiler->pPmaWatermarkEvent);
+        pProfiler->pPmaWatermarkEvent = NULL;
+    }
+
+    portMemFree(pProfiler->pPmaWatermarks);
+    pProfiler->pPmaWatermarks = NULL;
+}
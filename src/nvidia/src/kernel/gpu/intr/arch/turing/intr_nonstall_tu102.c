@@ -170,7 +170,8 @@ intrRestoreNonStall_TU102
     // non-stall interrupts in one go. We don't have a usecase to enable/disable
     // some of them selectively.
     //
-    if (intrEn1 == 0)
+    // A pending non-stall hold-off keeps the tree masked until it expires.
+    if ((intrEn1 == 0) || pIntr->bNonStallHeldOff)
     {
         intrDisableTopNonstall_HAL(pGpu, pIntr, pThreadState);
     }
@@ -34,6 +34,7 @@
 #include "gpu/mmu/kern_gmmu.h"
 #include "kernel/gpu/mig_mgr/kernel_mig_manager.h"
 #include "os/os.h"
+#include "objtmr.h"
 #include "resserv/rs_server.h"
 #include "vgpu/rpc.h"
 #include "virtualization/hypervisor/hypervisor.h"
@@ -718,6 +719,7 @@ intrGetHubLeafIntrPending_STUB
 }
 
 static void _intrInitRegistryOverrides(OBJGPU *, Intr *);
+static NV_STATUS _intrNonStallHoldoffCallback(OBJGPU *, OBJTMR *, TMR_EVENT *);
 
 NV_STATUS
 intrConstructEngine_IMPL
@@ -836,6 +838,22 @@ intrStateInitLocked_IMPL
         // Hypervisor will set the intr unblocked mask later at the time of SWRL init.
     }
 
+    if ((pIntr->nonStallHoldoffNs != 0) &&
+        pGpu->getProperty(pGpu, PDB_PROP_GPU_ALTERNATE_TREE_ENABLED) &&
+        !pGpu->getProperty(pGpu, PDB_PROP_GPU_ALTERNATE_TREE_HANDLE_LOCKLESS))
+    {
+        OBJTMR *pTmr = GPU_GET_TIMER(pGpu);
+
+        if (tmrEventCreate(pTmr, &pIntr->pNonStallHoldoffEvent,
+                           _intrNonStallHoldoffCallback, NULL,
+                           TMR_FLAGS_NONE) != NV_OK)
+        {
+            NV_PRINTF(LEVEL_ERROR,
+                      "Failed to create non-stall hold-off timer, moderation disabled\n");
+            pIntr->pNonStallHoldoffEvent = NULL;
+        }
+    }
+
 exit:
 
     return status;
@@ -850,6 +868,13 @@ intrStateDestroy_IMPL
 {
     intrStateDestroyPhysical_HAL(pGpu, pIntr);
 
+    if (pIntr->pNonStallHoldoffEvent != NULL)
+    {
+        tmrEventDestroy(GPU_GET_TIMER(pGpu), pIntr->pNonStallHoldoffEvent);
+        pIntr->pNonStallHoldoffEvent = NULL;
+        pIntr->bNonStallHeldOff = NV_FALSE;
+    }
+
     // Disable interrupts in the HAL
     pIntr->halIntrEnabled = NV_FALSE;
 
@@ -889,6 +914,78 @@ intrServiceNonStallBottomHalf_IMPL
     return status;
 }
 
+/*!
+ * Hold-off expiry for non-stall moderation: deliver everything that latched
+ * while the non-stall tree was masked in one pass. The tree is unmasked again
+ * when the GPU lock taken for this callback is released.
+ */
+static NV_STATUS
+_intrNonStallHoldoffCallback
+(
+    OBJGPU     *pGpu,
+    OBJTMR     *pTmr,
+    TMR_EVENT  *pEvent
+)
+{
+    Intr *pIntr = GPU_GET_INTR(pGpu);
+    THREAD_STATE_NODE *pThreadState = NULL;
+    MC_ENGINE_BITVECTOR intrPending;
+
+    pIntr->bNonStallHeldOff = NV_FALSE;
+
+    if (intrGetIntrEn(pIntr) == INTERRUPT_TYPE_DISABLED)
+    {
+        return NV_OK;
+    }
+
+    NV_ASSERT_OK(threadStateGetCurrent(&pThreadState, pGpu));
+
+    intrServiceNonStall_HAL(pGpu, pIntr, &intrPending, pThreadState);
+    osGetCurrentTick(&pIntr->nonStallLastServiceNs);
+
+    return NV_OK;
+}
+
+/*!
+ * Called from the locked bottom half after non-stall interrupts have been
+ * serviced. If this service followed the previous one by less than the
+ * configured hold-off, keep the non-stall tree masked and let
+ * _intrNonStallHoldoffCallback pick up the rest once the hold-off expires.
+ *
+ * @param[in] pGpu
+ * @param[in] pIntr
+ */
+void
+intrModerateNonStall_IMPL
+(
+    OBJGPU *pGpu,
+    Intr   *pIntr
+)
+{
+    NvU64 now;
+    NvU64 elapsed;
+
+    if ((pIntr->pNonStallHoldoffEvent == NULL) || pIntr->bNonStallHeldOff)
+    {
+        return;
+    }
+
+    osGetCurrentTick(&now);
+    elapsed = now - pIntr->nonStallLastServiceNs;
+    pIntr->nonStallLastServiceNs = now;
+
+    if (elapsed >= pIntr->nonStallHoldoffNs)
+    {
+        return;
+    }
+
+    if (tmrEventScheduleRel(GPU_GET_TIMER(pGpu), pIntr->pNonStallHoldoffEvent,
+                            pIntr->nonStallHoldoffNs - elapsed) == NV_OK)
+    {
+        pIntr->bNonStallHeldOff = NV_TRUE;
+    }
+}
+
 static void
 _intrInitRegistryOverrides
 (
@@ -962,6 +1059,12 @@ _intrInitRegistryOverrides
     {
         pIntr->intrStuckThreshold = data;
     }
+
+    pIntr->nonStallHoldoffNs = 0;
+    if (osReadRegistryDword(pGpu, NV_REG_STR_RM_NONSTALL_INTR_HOLDOFF_US, &data) == NV_OK)
+    {
+        pIntr->nonStallHoldoffNs = (NvU64)data * 1000;
+    }
 }
 
 void
@@ -1625,8 +1625,9 @@ _gmmuWalkCBMapNextEntries_RmAperture
                                      entryIndexLo, entryIndexHi, pProgress);
 
     memmgrMemEndTransfer(pMemoryManager, &surf, sizeOfEntries,
-                         TRANSFER_FLAGS_SHADOW_ALLOC |
-                         TRANSFER_FLAGS_SHADOW_INIT_MEM);
+                         gvaspaceWalkUserCtxTransferFlags(pUserCtx,
+                             TRANSFER_FLAGS_SHADOW_ALLOC |
+                             TRANSFER_FLAGS_SHADOW_INIT_MEM));
 }
 
 static NV_STATUS _dmaGetFabricAddress
@@ -2098,6 +2099,7 @@ dmaUpdateVASpace_GF100
                 NV_ASSERT_OR_RETURN(NULL != pMemBlock, NV_ERR_INVALID_ARGUMENT);
                 pVASBlock = pMemBlock->pData;
 
+                userCtx.bDeferFlush = NV_TRUE;
                 gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
                 status = mmuWalkMap(userCtx.pGpuState->pWalk, vaLo, vaHi, &mapTarget);
                 NV_ASSERT(NV_OK == status);
@@ -2525,7 +2527,6 @@ _dmaApplyWarForBug2720120
 )
 {
     KernelGmmu            *pKernelGmmu = GPU_GET_KERNEL_GMMU(pGpu);
-    KernelBus             *pKernelBus  = GPU_GET_KERNEL_BUS(pGpu);
     GVAS_GPU_STATE        *pGpuState   = gvaspaceGetGpuState(pGVAS, pGpu);
     const GMMU_FMT        *pFmt        = pGpuState->pFmt;
     const GMMU_FMT_FAMILY *pFmtFamily  = kgmmuFmtGetFamily(pKernelGmmu, pFmt->version);
@@ -2553,15 +2554,13 @@ _dmaApplyWarForBug2720120
     NV_ASSERT_OR_RETURN(pMemBlock != NULL, NV_ERR_INVALID_ARGUMENT);
     pVASBlock = pMemBlock->pData;
 
+    // Release flushes the batched PTE writes to vidmem before the invalidate
+    userCtx.bDeferFlush = NV_TRUE;
     gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
     NV_ASSERT_OK_OR_RETURN(mmuWalkMap(userCtx.pGpuState->pWalk,
                                       vaLo, vaHi, &mapTarget));
     gvaspaceWalkUserCtxRelease(pGVAS, &userCtx);
 
-    // Flush PTE writes to vidmem and issue TLB invalidate
-    kbusFlush_HAL(pGpu, pKernelBus, BUS_FLUSH_VIDEO_MEMORY |
-                                    BUS_FLUSH_SYSTEM_MEMORY |
-                                    BUS_FLUSH_USE_PCIE_READ);
     gvaspaceInvalidateTlb(pGVAS, pGpu, PTE_UPGRADE);
 
     return NV_OK;
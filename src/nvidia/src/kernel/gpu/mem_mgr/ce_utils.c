@@ -472,7 +472,7 @@ ceutilsMemset_IMPL
     else
     {
         // Check semaProgress and then timeout
-        status = channelWaitForFinishPayload(pChannel, channelPbInfo.payload);
+        status = ceutilsWaitForWorkId(pCeUtils, pCeUtils->lastSubmittedPayload);
         if (status == NV_OK)
         {
             NV_PRINTF(LEVEL_INFO, "Work was done from RM PoV lastSubmitted = 0x%x\n", channelPbInfo.payload);
@@ -599,7 +599,7 @@ ceutilsMemcopy_IMPL
     else
     {
         // Check semaProgress and then timeout
-        status = channelWaitForFinishPayload(pChannel, channelPbInfo.payload);
+        status = ceutilsWaitForWorkId(pCeUtils, pCeUtils->lastSubmittedPayload);
         if (status == NV_OK)
         {
             NV_PRINTF(LEVEL_INFO, "Work was done from RM PoV lastSubmitted = 0x%x\n", channelPbInfo.payload);
@@ -649,6 +649,43 @@ ceutilsUpdateProgress_IMPL
     return swLastCompletedPayload;
 }
 
+//
+// Wait for the work with the given submittedWorkId to complete. Callers can
+// submit a batch of _ASYNC memsets and memcopies and wait once for the last
+// one, since work on the channel completes in submission order.
+//
+NV_STATUS
+ceutilsWaitForWorkId_IMPL
+(
+    CeUtils *pCeUtils,
+    NvU64    workId
+)
+{
+    OBJGPU   *pGpu;
+    RMTIMEOUT timeout;
+    NV_STATUS status = NV_OK;
+
+    NV_ASSERT_OR_RETURN((pCeUtils != NULL) && (pCeUtils->pChannel != NULL), NV_ERR_INVALID_STATE);
+    NV_ASSERT_OR_RETURN(workId <= pCeUtils->lastSubmittedPayload, NV_ERR_INVALID_ARGUMENT);
+
+    pGpu = pCeUtils->pChannel->pGpu;
+
+    gpuSetTimeout(pGpu, GPU_TIMEOUT_DEFAULT, &timeout, GPU_TIMEOUT_FLAGS_BYPASS_THREAD_STATE);
+    while (ceutilsUpdateProgress(pCeUtils) < workId)
+    {
+        status = gpuCheckTimeout(pGpu, &timeout);
+        if (status == NV_ERR_TIMEOUT)
+        {
+            NV_PRINTF(LEVEL_ERROR, "Timed out waiting for CeUtils work 0x%llx\n", workId);
+            break;
+        }
+
+        ceutilsServiceInterrupts(pCeUtils);
+    }
+
+    return status;
+}
+
 #if defined(DEBUG) || defined (DEVELOP)
 NV_STATUS
 ceutilsapiCtrlCmdCheckProgress_IMPL
@@ -337,7 +337,9 @@ channelFillGpFifo
     OBJGPU *pGpu;
     KernelBus *pKernelBus;
     MemoryManager *pMemoryManager;
-    NvBool bReleaseMapping = NV_FALSE;
+    NvBool bReleasePbMapping = NV_FALSE;
+    NvBool bReleaseUserdMapping = NV_FALSE;
+    NvBool bReleaseNotifierMapping = NV_FALSE;
 
     //
     // Use BAR1 if CPU access is allowed, otherwise allocate and init shadow
@@ -360,7 +362,7 @@ channelFillGpFifo
     {
         pChannel->pbCpuVA = memmgrMemDescBeginTransfer(pMemoryManager, pChannel->pChannelBufferMemdesc,
                                                        transferFlags);
-        bReleaseMapping = NV_TRUE;
+        bReleasePbMapping = NV_TRUE;
     }
 
     NV_ASSERT_OR_RETURN(pChannel->pbCpuVA != NULL, NV_ERR_GENERIC);
@@ -380,7 +382,7 @@ channelFillGpFifo
     MEM_WR32(&pGpEntry[0], GpEntry0);
     MEM_WR32(&pGpEntry[1], GpEntry1);
 
-    if (bReleaseMapping)
+    if (bReleasePbMapping)
     {
         memmgrMemDescEndTransfer(pMemoryManager, pChannel->pChannelBufferMemdesc, 
                                  transferFlags);
@@ -397,12 +399,18 @@ channelFillGpFifo
             (void *)memmgrMemDescBeginTransfer(pMemoryManager, pChannel->pUserdMemdesc,
                                                transferFlags);
         NV_ASSERT_OR_RETURN(pChannel->pControlGPFifo != NULL, NV_ERR_INVALID_STATE);
-        bReleaseMapping = NV_TRUE;
+        bReleaseUserdMapping = NV_TRUE;
     }
 
     MEM_WR32(&pChannel->pControlGPFifo->GPPut, putIndex);
 
-    if (bReleaseMapping)
+    //
+    // Track each mapping separately: a channel whose USERD or notifier is
+    // mapped for its lifetime must not lose that mapping (and pay for a
+    // BAR1 remap on the next submit) just because the pushbuffer was
+    // mapped for this call only.
+    //
+    if (bReleaseUserdMapping)
     {
         memmgrMemDescEndTransfer(pMemoryManager, pChannel->pUserdMemdesc, transferFlags);
         pChannel->pControlGPFifo = NULL;
@@ -440,14 +448,14 @@ channelFillGpFifo
                 (NvNotification *)(pErrNotifierCpuVA +
                                (NV_CHANNELGPFIFO_NOTIFICATION_TYPE_WORK_SUBMIT_TOKEN *
                                 sizeof(NvNotification)));
-            bReleaseMapping = NV_TRUE;
+            bReleaseNotifierMapping = NV_TRUE;
         }
 
         // Use the token from notifier memory for VM migration support.
         MEM_WR32(pChannel->pDoorbellRegisterOffset, 
                  MEM_RD32(&(pChannel->pTokenFromNotifier->info32)));
 
-        if (bReleaseMapping)
+        if (bReleaseNotifierMapping)
         {
             memmgrMemDescEndTransfer(pMemoryManager, pChannel->pErrNotifierMemdesc, transferFlags);
             pChannel->pTokenFromNotifier = NULL;
@@ -34,6 +34,7 @@
 #include "mem_mgr/video_mem.h"
 #include "mem_mgr/vaspace.h"
 #include "mem_mgr/system_mem.h"
+#include "mem_mgr/ctx_buf_pool.h"
 #include "gpu/mem_mgr/mem_utils.h"
 #include "gpu/mem_mgr/virt_mem_allocator.h"
 #include "gpu/mem_mgr/mem_desc.h"
@@ -699,6 +700,9 @@ heapDestruct_IMPL
 
     NV_PRINTF(LEVEL_INFO, "Heap Manager: HEAP ABOUT TO BE DESTROYED.\n");
 
+    // Return the reservations of cached ctx buf pools while PMA is still up
+    ctxBufPoolCacheDestroy(pHeap);
+
 #ifdef DEBUG
     _heapDump(pHeap);
 #endif
@@ -1627,6 +1631,16 @@ NV_STATUS heapAlloc_IMPL
         goto non_contig_alloc;
     }
 
+    //
+    // pHeap->free is the sum of all free blocks, so a larger request cannot
+    // be placed contiguously. Don't walk the free list for it.
+    //
+    if (pAllocData->allocSize > pHeap->free)
+    {
+        NV_PRINTF(LEVEL_INFO, "contig request exceeds free heap memory\n");
+        goto non_contig_alloc;
+    }
+
     //
     // Loop through all available regions.
     // Note we don't check for bRsvdRegion here because when blacklisting
@@ -1697,6 +1711,13 @@ NV_STATUS heapAlloc_IMPL
             else
                 pBlockFree = pBlockFree->u1.nextFree;
 
+            //
+            // Skip blocks too small to hold the allocation before doing the
+            // range and alignment math. Fragmented heaps have many of them.
+            //
+            if ((pBlockFree->end - pBlockFree->begin + 1) < pAllocData->allocSize)
+                continue;
+
             //
             // Is this block completely in requested range?
             //
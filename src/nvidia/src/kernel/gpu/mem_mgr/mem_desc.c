@@ -79,6 +79,143 @@ const NV_ADDRESS_SPACE ADDRLIST_SYSMEM_PREFERRED[] = {ADDR_SYSMEM, ADDR_FBMEM, A
 const NV_ADDRESS_SPACE ADDRLIST_FBMEM_ONLY[] = {ADDR_FBMEM, ADDR_UNKNOWN};
 const NV_ADDRESS_SPACE ADDRLIST_SYSMEM_ONLY[] = {ADDR_SYSMEM, ADDR_UNKNOWN};
 
+//
+// Descriptors small enough to hold MEMDESC_CACHE_INLINE_PTES PTEs are
+// sub-allocated from a global pool of fixed size entries instead of the
+// kernel heap. This covers every contiguous descriptor and the small
+// discontiguous ones (semaphores, notifiers, USERD, instance blocks).
+//
+#define MEMDESC_CACHE_INLINE_PTES         4
+#define MEMDESC_CACHE_ENTRY_SIZE          NV_ALIGN_UP(sizeof(MEMORY_DESCRIPTOR) +                       \
+                                                      sizeof(RmPhysAddr) * MEMDESC_CACHE_INLINE_PTES,  \
+                                                      sizeof(NvU64))
+#define MEMDESC_CACHE_ENTRIES_PER_CHUNK   32
+#define MEMDESC_CACHE_FREE_CHUNKS         2
+
+static struct
+{
+    POOLALLOC     *pPool;
+    PORT_SPINLOCK *pLock;
+} memdescCache;
+
+static NV_STATUS
+_memdescCacheChunkAlloc(void *pCtx, NvU64 pageSize, POOLALLOC_HANDLE *pPage)
+{
+    void *pChunk = portMemAllocNonPaged((NvU32)pageSize);
+
+    if (pChunk == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    pPage->address   = (NvU64)(NvUPtr)pChunk;
+    pPage->pMetadata = NULL;
+
+    return NV_OK;
+}
+
+static void
+_memdescCacheChunkFree(void *pCtx, NvU64 pageSize, POOLALLOC_HANDLE *pPage)
+{
+    portMemFree((void *)(NvUPtr)pPage->address);
+}
+
+/*!
+ *  @brief Create the global memory descriptor cache
+ *
+ *  Descriptors created before this or after memdescCacheDestroy() are heap
+ *  allocated.
+ */
+NV_STATUS
+memdescCacheInit(void)
+{
+    PORT_MEM_ALLOCATOR *pAllocator = portMemAllocatorGetGlobalNonPaged();
+
+    memdescCache.pLock = portSyncSpinlockCreate(pAllocator);
+    NV_ASSERT_OR_RETURN(memdescCache.pLock != NULL, NV_ERR_NO_MEMORY);
+
+    memdescCache.pPool = poolInitialize(MEMDESC_CACHE_ENTRY_SIZE * MEMDESC_CACHE_ENTRIES_PER_CHUNK,
+                                        MEMDESC_CACHE_ENTRY_SIZE,
+                                        _memdescCacheChunkAlloc,
+                                        _memdescCacheChunkFree,
+                                        NULL,
+                                        pAllocator,
+                                        NV_RMPOOL_FLAGS_AUTO_POPULATE_ENABLE);
+    if (memdescCache.pPool == NULL)
+    {
+        portSyncSpinlockDestroy(memdescCache.pLock);
+        memdescCache.pLock = NULL;
+        return NV_ERR_NO_MEMORY;
+    }
+
+    return NV_OK;
+}
+
+/*!
+ *  @brief Destroy the global memory descriptor cache
+ */
+void
+memdescCacheDestroy(void)
+{
+    if (memdescCache.pPool != NULL)
+    {
+        poolDestroy(memdescCache.pPool);
+        memdescCache.pPool = NULL;
+    }
+
+    if (memdescCache.pLock != NULL)
+    {
+        portSyncSpinlockDestroy(memdescCache.pLock);
+        memdescCache.pLock = NULL;
+    }
+}
+
+//
+// Allocate storage for a descriptor of MdSize bytes, from the cache when it
+// fits. The cache chunk is returned in *ppCacheChunk, NULL for heap storage.
+//
+static MEMORY_DESCRIPTOR *
+_memdescStorageAlloc(NvU64 MdSize, void **ppCacheChunk)
+{
+    *ppCacheChunk = NULL;
+
+    if ((memdescCache.pPool != NULL) && (MdSize <= MEMDESC_CACHE_ENTRY_SIZE))
+    {
+        POOLALLOC_HANDLE handle;
+        NV_STATUS        status;
+
+        portSyncSpinlockAcquire(memdescCache.pLock);
+        status = poolAllocate(memdescCache.pPool, &handle);
+        portSyncSpinlockRelease(memdescCache.pLock);
+
+        if (status == NV_OK)
+        {
+            *ppCacheChunk = handle.pMetadata;
+            return (MEMORY_DESCRIPTOR *)(NvUPtr)handle.address;
+        }
+    }
+
+    return portMemAllocNonPaged((NvU32)MdSize);
+}
+
+static void
+_memdescStorageFree(MEMORY_DESCRIPTOR *pMemDesc)
+{
+    if (pMemDesc->_pCacheChunk != NULL)
+    {
+        POOLALLOC_HANDLE handle;
+
+        handle.address   = (NvU64)(NvUPtr)pMemDesc;
+        handle.pMetadata = pMemDesc->_pCacheChunk;
+
+        portSyncSpinlockAcquire(memdescCache.pLock);
+        poolFree(memdescCache.pPool, &handle);
+        poolTrim(memdescCache.pPool, MEMDESC_CACHE_FREE_CHUNKS);
+        portSyncSpinlockRelease(memdescCache.pLock);
+        return;
+    }
+
+    portMemFree(pMemDesc);
+}
+
 // XXX These could probably encode the whole list in the u32 bits.
 NvU32 memdescAddrSpaceListToU32(const NV_ADDRESS_SPACE *addrlist)
 {
@@ -224,6 +361,7 @@ memdescCreate
 )
 {
     MEMORY_DESCRIPTOR *pMemDesc;
+    void              *pCacheChunk = NULL;
     NvU64              allocSize, MdSize, PageCount;
     NvU32              gpuCacheAttrib = NV_MEMORY_UNCACHED;
     NV_STATUS          status         = NV_OK;
@@ -345,7 +483,7 @@ memdescCreate
     }
     else
     {
-        pMemDesc = portMemAllocNonPaged((NvU32)MdSize);
+        pMemDesc = _memdescStorageAlloc(MdSize, &pCacheChunk);
         if (pMemDesc == NULL)
         {
             return NV_ERR_NO_MEMORY;
@@ -354,6 +492,8 @@ memdescCreate
 
     portMemSet(pMemDesc, 0, (NvU32)MdSize);
 
+    pMemDesc->_pCacheChunk         = pCacheChunk;
+
     // Fill in initial non-zero parameters
     pMemDesc->pGpu                 = pGpu;
     pMemDesc->Size                 = Size;
@@ -408,7 +548,7 @@ failed:
     {
         if (!(Flags & MEMDESC_FLAGS_PRE_ALLOCATED))
         {
-            portMemFree(pMemDesc);
+            _memdescStorageFree(pMemDesc);
         }
     }
     else
@@ -631,7 +771,7 @@ memdescDestroy
 
         if ((pMemDesc->_flags & MEMDESC_FLAGS_PRE_ALLOCATED) == 0)
         {
-            portMemFree(pMemDesc);
+            _memdescStorageFree(pMemDesc);
         }
     }
 }
@@ -597,11 +597,20 @@ scrubCheckAndWaitForSize
     NvLength startIdx = pScrubber->lastSeenIdByClient;
     NvU64 totalScrubbedPages = 0;
     NvLength requiredItemsToSave = 0;
+    NvLength completedItems = 0;
 
-    for (; requiredItemsToSave < totalItems && totalScrubbedPages <= numPages; requiredItemsToSave++) {
+    //
+    // Only wait for as many items as it takes to cover numPages. Items the
+    // scrubber has already finished are handed back as well, since that
+    // costs no waiting and gives the caller more pages to retry with.
+    //
+    for (; requiredItemsToSave < totalItems && totalScrubbedPages < numPages; requiredItemsToSave++) {
         totalScrubbedPages += (pScrubber->pScrubList[(startIdx + requiredItemsToSave) % MAX_SCRUB_ITEMS].size / pageSize);
     }
 
+    completedItems = (NvLength)(_scrubCheckProgress(pScrubber) - pScrubber->lastSeenIdByClient);
+    requiredItemsToSave = NV_MAX(requiredItemsToSave, NV_MIN(completedItems, totalItems));
+
     if (requiredItemsToSave != 0) {
         pList = (PSCRUB_NODE) portMemAllocNonPaged(sizeof(SCRUB_NODE) * requiredItemsToSave);
         if (pList == NULL)
@@ -769,32 +778,34 @@ _searchScrubList
     RmPhysAddr    end
 )
 {
-    NvU64      tempLastSeenIdByClient    = pScrubber->lastSeenIdByClient;
-    NvU64      lastSubmittedWorkId       = pScrubber->lastSubmittedWorkId;
-    NvU64      id                        = 0;
-    NvU64      maxId                     = 0;
+    NvU64      lastSeenIdByClient        = pScrubber->lastSeenIdByClient;
+    NvU64      tempLastSubmittedWorkId   = pScrubber->lastSubmittedWorkId;
+    NvU64      lastCompletedId           = pScrubber->lastSWSemaphoreDone;
     RmPhysAddr blockStart                = 0;
     RmPhysAddr blockEnd                  = 0;
 
     //
-    // we need not check for lastSubmittedWorkId, since lastSubmittedWorkId is always one more than
-    // the lastSubmittedWorkIdx.
+    // Work IDs complete in submission order, so walk the list from the newest
+    // entry. The first overlapping entry has the highest ID, and anything at
+    // or below the last completed ID does not need to be waited on.
     //
-    while (tempLastSeenIdByClient != lastSubmittedWorkId)
+    while ((tempLastSubmittedWorkId != lastSeenIdByClient) &&
+           (tempLastSubmittedWorkId > lastCompletedId))
     {
-        blockStart = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].base;
-        blockEnd   = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].base +
-                   pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].size - 1;
+        NvU32 idx = (tempLastSubmittedWorkId - 1) % MAX_SCRUB_ITEMS;
+
+        blockStart = pScrubber->pScrubList[idx].base;
+        blockEnd   = pScrubber->pScrubList[idx].base +
+                     pScrubber->pScrubList[idx].size - 1;
 
         // Check whether the page ranges overlap
         if ( !(blockStart > end || blockEnd < base) )
         {
-           id    = pScrubber->pScrubList[tempLastSeenIdByClient%MAX_SCRUB_ITEMS].id;
-           maxId = (id > maxId) ? id : maxId;
+            return pScrubber->pScrubList[idx].id;
         }
-        tempLastSeenIdByClient++;
+        tempLastSubmittedWorkId--;
     }
-    return maxId;
+    return 0;
 }
 
 
@@ -220,6 +220,7 @@ pmaInitialize(PMA *pPma, NvU32 initFlags)
     pMapInfo->pmaMapScanContiguousNumaEviction = pmaRegMapScanContiguousNumaEviction;
     pMapInfo->pmaMapGetEvictingFrames = pmaRegmapGetEvictingFrames;
     pMapInfo->pmaMapSetEvictingFrames = pmaRegmapSetEvictingFrames;
+    pMapInfo->pmaMapGetFreeAlignedCount = pmaRegmapGetFreeAlignedCount;
 
     if (initFlags != PMA_INIT_NONE)
     {
@@ -258,6 +259,7 @@ pmaInitialize(PMA *pPma, NvU32 initFlags)
             pMapInfo->pmaMapScanContiguousNumaEviction = pmaAddrtreeScanContiguousNumaEviction;
             pMapInfo->pmaMapGetEvictingFrames = pmaAddrtreeGetEvictingFrames;
             pMapInfo->pmaMapSetEvictingFrames = pmaAddrtreeSetEvictingFrames;
+            pMapInfo->pmaMapGetFreeAlignedCount = NULL;
             NV_PRINTF(LEVEL_WARNING, "Going to use addrtree for PMA init!!\n");
         }
     }
@@ -269,6 +271,7 @@ pmaInitialize(PMA *pPma, NvU32 initFlags)
     pPma->pmaStats.numFreeFramesProtected = 0;
     pPma->pmaStats.num2mbPagesProtected = 0;
     pPma->pmaStats.numFree2mbPagesProtected = 0;
+    portMemSet(&pPma->allocStats, 0, sizeof(pPma->allocStats));
     pPma->regSize = 0;
     portAtomicSetSize(&pPma->initScrubbing, PMA_SCRUB_INITIALIZE);
 
@@ -388,6 +391,8 @@ pmaDestroy(PMA *pPma)
         pmaScrubComplete(pPma);
     }
 
+    pmaPrintAllocStats(pPma);
+
     if (pPma->bNuma)
     {
         if (pPma->nodeOnlined != NV_FALSE)
@@ -552,8 +557,8 @@ pmaRegisterRegion
     return status;
 }
 
-NV_STATUS
-pmaAllocatePages
+static NV_STATUS
+_pmaAllocatePages
 (
     PMA                    *pPma,
     NvLength                allocationCount,
@@ -744,6 +749,20 @@ pmaAllocatePages_retry:
     numPagesAllocatedSoFar = 0;
     curPages = pPages;
 
+    //
+    // Fail obvious OOM cases before contending on the PMA lock. The counters
+    // can go stale right after this, so the prediction is repeated with the
+    // lock held.
+    //
+    if (!tryEvict &&
+        (_pmaPredictOutOfMemory(pPma, allocationCount, pageSize,
+                                allocationOptions) == NV_ERR_NO_MEMORY))
+    {
+        NV_PRINTF(LEVEL_INFO, "Returning OOM from lockless prediction path.\n");
+        status = NV_ERR_NO_MEMORY;
+        goto unlocked_exit;
+    }
+
     portSyncSpinlockAcquire(pPma->pPmaLock);
 
     NV_ASSERT(pmaStateCheck(pPma));
@@ -904,6 +923,7 @@ pmaAllocatePages_retry:
                                       (evictEnd - addrBase) >> PMA_PAGE_SHIFT);
 
                 status = _pmaEvictContiguous(pPma, pMap, evictStart, evictEnd, prot);
+                portAtomicIncrementU32(&pPma->allocStats.numEvictions);
             }
             else
             {
@@ -936,6 +956,7 @@ pmaAllocatePages_retry:
                 status = _pmaEvictPages(pPma, pMap, curPages, numPagesLeftToAllocate,
                                         pPages, numPagesAllocatedSoFar, pageSize,
                                         evictPhysBegin, evictPhysEnd, prot);
+                portAtomicIncrementU32(&pPma->allocStats.numEvictions);
             }
 
             if (status == NV_OK)
@@ -944,6 +965,7 @@ pmaAllocatePages_retry:
             }
             else
             {
+                portAtomicIncrementU32(&pPma->allocStats.numFailedEvictions);
                 NV_PRINTF(LEVEL_INFO, "Eviction/scrubbing failed, region after:\n");
                 pmaRegionPrint(pPma, pPma->pRegDescriptors[regId], pMap);
             }
@@ -1156,6 +1178,8 @@ normal_exit:
     }
 
     portSyncSpinlockRelease(pPma->pPmaLock);
+
+unlocked_exit:
     if (bScrubOnFree)
     {
         portSyncRwLockReleaseRead(pPma->pScrubberValidLock);
@@ -1181,6 +1205,57 @@ scrub_fatal:
 
 }
 
+static NvU32
+_pmaAllocStatsPageSizeIndex(NvU64 pageSize)
+{
+    switch (pageSize)
+    {
+        case _PMA_64KB:  return 0;
+        case _PMA_128KB: return 1;
+        case _PMA_2MB:   return 2;
+        default:         return 3;
+    }
+}
+
+NV_STATUS
+pmaAllocatePages
+(
+    PMA                    *pPma,
+    NvLength                allocationCount,
+    NvU64                   pageSize,
+    PMA_ALLOCATION_OPTIONS *allocationOptions,
+    NvU64                  *pPages
+)
+{
+    NV_STATUS status;
+#if !defined(SRT_BUILD)
+    NvU64 startNs;
+    NvU64 endNs;
+    NvU32 bucket;
+
+    osGetPerformanceCounter(&startNs);
+#endif
+
+    status = _pmaAllocatePages(pPma, allocationCount, pageSize, allocationOptions, pPages);
+
+    if (status != NV_OK)
+    {
+        // Invalid arguments are not counted, they never reach the allocator
+        if (status != NV_ERR_INVALID_ARGUMENT)
+            portAtomicIncrementU32(&pPma->allocStats.numFailedAllocs);
+        return status;
+    }
+
+#if !defined(SRT_BUILD)
+    osGetPerformanceCounter(&endNs);
+    bucket = NV_MIN(64 - portUtilCountLeadingZeros64(endNs - startNs),
+                    PMA_ALLOC_STATS_LATENCY_BUCKETS - 1);
+    portAtomicIncrementU32(&pPma->allocStats.latency[_pmaAllocStatsPageSizeIndex(pageSize)][bucket]);
+#endif
+
+    return status;
+}
+
 NV_STATUS
 pmaAllocatePagesBroadcast
 (
@@ -1621,9 +1696,12 @@ pmaGetFreeMemory
 #if !defined(SRT_BUILD)
     NvU64 val;
 
-    portSyncSpinlockAcquire(pPma->pPmaLock);
+    //
+    // nodeOnlined only changes when the NUMA node is onlined or offlined, so
+    // a racy read is no worse than the value going stale after the lock is
+    // dropped.
+    //
     NvBool nodeOnlined = pPma->nodeOnlined;
-    portSyncSpinlockRelease(pPma->pPmaLock);
 
     if (nodeOnlined)
     {
@@ -1636,11 +1714,7 @@ pmaGetFreeMemory
     //
 #endif
 
-    portSyncSpinlockAcquire(pPma->pPmaLock);
-
-    *pBytesFree = pPma->pmaStats.numFreeFrames << PMA_PAGE_SHIFT;
-
-    portSyncSpinlockRelease(pPma->pPmaLock);
+    *pBytesFree = pmaStatsGet(&pPma->pmaStats.numFreeFrames) << PMA_PAGE_SHIFT;
 }
 
 void
@@ -1742,6 +1816,72 @@ pmaGetLargestFree
         *pLargestFree, *pRegionBase, *pLargestOffset);
 }
 
+void
+pmaGetFreeAlignedCount
+(
+    PMA             *pPma,
+    NvU64            size,
+    NvU64           *pCount
+)
+{
+    NvU32 i;
+
+    *pCount = 0;
+
+    if (pPma->pMapInfo->pmaMapGetFreeAlignedCount == NULL)
+        return;
+
+    portSyncSpinlockAcquire(pPma->pPmaLock);
+
+    for (i = 0; i < pPma->regSize; i++)
+    {
+        *pCount += pPma->pMapInfo->pmaMapGetFreeAlignedCount(pPma->pRegions[i],
+                                                             pPma->pRegDescriptors[i]->base,
+                                                             size);
+    }
+
+    portSyncSpinlockRelease(pPma->pPmaLock);
+}
+
+void
+pmaPrintAllocStats
+(
+    PMA *pPma
+)
+{
+    static const char *pageSizeNames[PMA_ALLOC_STATS_PAGE_SIZES] = { "64KB", "128KB", "2MB", "512MB" };
+    PMA_ALLOC_STATS *pStats = &pPma->allocStats;
+    NvU64 numFree512mb;
+    NvU64 numAllocs = 0;
+    NvU32 i;
+    NvU32 bucket;
+
+    pmaGetFreeAlignedCount(pPma, _PMA_512MB, &numFree512mb);
+
+    for (i = 0; i < PMA_ALLOC_STATS_PAGE_SIZES; i++)
+    {
+        for (bucket = 0; bucket < PMA_ALLOC_STATS_LATENCY_BUCKETS; bucket++)
+            numAllocs += pStats->latency[i][bucket];
+    }
+
+    NV_PRINTF(LEVEL_INFO, "PMA: %llu allocations, %u failed, %u evictions (%u failed)\n",
+              numAllocs, pStats->numFailedAllocs, pStats->numEvictions, pStats->numFailedEvictions);
+    NV_PRINTF(LEVEL_INFO, "PMA: free 2MB pages %llu, free 512MB chunks %llu\n",
+              pmaStatsGet(&pPma->pmaStats.numFree2mbPages), numFree512mb);
+
+    for (i = 0; i < PMA_ALLOC_STATS_PAGE_SIZES; i++)
+    {
+        for (bucket = 0; bucket < PMA_ALLOC_STATS_LATENCY_BUCKETS; bucket++)
+        {
+            if (pStats->latency[i][bucket] == 0)
+                continue;
+
+            NV_PRINTF(LEVEL_INFO, "PMA:     %s alloc < 2^%u ns: %u\n",
+                      pageSizeNames[i], bucket, pStats->latency[i][bucket]);
+        }
+    }
+}
+
 /*!
  * @brief Returns a list of PMA allocated blocks which has ATTRIB_PERSISTENT
  *        attribute set. It will be used by FBSR module to save/restore
@@ -2019,11 +2159,7 @@ pmaGetFreeProtectedMemory
     NvU64 *pBytesFree
 )
 {
-    portSyncSpinlockAcquire(pPma->pPmaLock);
-
-    *pBytesFree = (pPma->pmaStats.numFreeFramesProtected) << PMA_PAGE_SHIFT;
-
-    portSyncSpinlockRelease(pPma->pPmaLock);
+    *pBytesFree = pmaStatsGet(&pPma->pmaStats.numFreeFramesProtected) << PMA_PAGE_SHIFT;
 }
 
 void
@@ -2033,10 +2169,10 @@ pmaGetFreeUnprotectedMemory
     NvU64 *pBytesFree
 )
 {
-    portSyncSpinlockAcquire(pPma->pPmaLock);
+    NvU64 numFreeProtected = pmaStatsGet(&pPma->pmaStats.numFreeFramesProtected);
+    NvU64 numFree          = pmaStatsGet(&pPma->pmaStats.numFreeFrames);
 
-    *pBytesFree = (pPma->pmaStats.numFreeFrames -
-                   pPma->pmaStats.numFreeFramesProtected) << PMA_PAGE_SHIFT;
-
-    portSyncSpinlockRelease(pPma->pPmaLock);
+    // Read without the PMA lock, so the counters may be briefly out of step
+    *pBytesFree = ((numFree > numFreeProtected) ?
+                   (numFree - numFreeProtected) : 0) << PMA_PAGE_SHIFT;
 }
@@ -294,12 +294,12 @@ pmaStatsUpdateState
 
     if ((oldState == STATE_FREE) && (newState != STATE_FREE))
     {
-        (*pNumFree) -= numPages;
+        portAtomicExSubU64((volatile NvU64 *)pNumFree, numPages);
       //  NV_PRINTF(LEVEL_INFO, "Decrease to 0x%llx \n", *pNumFree);
     }
     else if ((oldState != STATE_FREE) && (newState == STATE_FREE))
     {
-        (*pNumFree) += numPages;
+        portAtomicExAddU64((volatile NvU64 *)pNumFree, numPages);
       //  NV_PRINTF(LEVEL_INFO, "Increase to 0x%llx \n", *pNumFree);
     }
 }
@@ -846,6 +846,8 @@ _pmaPredictOutOfMemory
     NvU64 alignment;
     NvU64 free2mbPages = 0;
     NvU64 bytesFree    = 0;
+    NvU64 numFree;
+    NvU64 numFreeProtected;
 
     alignFlag   = !!((allocationOptions->flags) & PMA_ALLOCATE_FORCE_ALIGNMENT);
     partialFlag = !!((allocationOptions->flags) & PMA_ALLOCATE_ALLOW_PARTIAL);
@@ -855,12 +857,18 @@ _pmaPredictOutOfMemory
     {
         if (allocationOptions->flags & PMA_ALLOCATE_PROTECTED_REGION)
         {
-            free2mbPages = pPma->pmaStats.numFree2mbPagesProtected;
+            free2mbPages = pmaStatsGet(&pPma->pmaStats.numFree2mbPagesProtected);
         }
         else
         {
-            free2mbPages = pPma->pmaStats.numFree2mbPages -
-                           pPma->pmaStats.numFree2mbPagesProtected;
+            //
+            // May be called without the PMA lock, so the two counters can be
+            // briefly out of step. Don't let the difference wrap.
+            //
+            numFreeProtected = pmaStatsGet(&pPma->pmaStats.numFree2mbPagesProtected);
+            numFree          = pmaStatsGet(&pPma->pmaStats.numFree2mbPages);
+            free2mbPages     = (numFree > numFreeProtected) ?
+                               (numFree - numFreeProtected) : 0;
         }
 
         // If we have at least one page free, don't fail a partial allocation
@@ -878,12 +886,14 @@ _pmaPredictOutOfMemory
     // Do a quick check and exit early if we are in OOM case
     if (allocationOptions->flags & PMA_ALLOCATE_PROTECTED_REGION)
     {
-        bytesFree = pPma->pmaStats.numFreeFramesProtected << PMA_PAGE_SHIFT;
+        bytesFree = pmaStatsGet(&pPma->pmaStats.numFreeFramesProtected) << PMA_PAGE_SHIFT;
     }
     else
     {
-        bytesFree = (pPma->pmaStats.numFreeFrames -
-                     pPma->pmaStats.numFreeFramesProtected) << PMA_PAGE_SHIFT;
+        numFreeProtected = pmaStatsGet(&pPma->pmaStats.numFreeFramesProtected);
+        numFree          = pmaStatsGet(&pPma->pmaStats.numFreeFrames);
+        bytesFree        = ((numFree > numFreeProtected) ?
+                            (numFree - numFreeProtected) : 0) << PMA_PAGE_SHIFT;
     }
 
     // If we have at least one page free, don't fail a partial allocation
@@ -392,64 +392,98 @@ pmaRegMapScanContiguousNumaEviction
 //  - NV_OK if the whole range is available and leaves frameIndex unset.
 //
 //  - NV_ERR_IN_USE if some frames would need to be evicted, and sets frameIndex
-//    to the first one.
+//    to the first one, or the last one if bLast is set.
 //
 //  - NV_ERR_NO_MEMORY if some frames are unavailable, and sets frameIndex to
-//    the first one.
+//    the first one, or the last one if bLast is set.
 //
-// TODO: Would it be better to return the last frame index instead, given how the
-// search skips over right past it?
+// Blacklisted frames are only reported when no frame needs eviction, as
+// unpinned allocations may cover them.
+//
+// All the state bitmaps are checked together one word at a time, so a range
+// is walked once instead of once per bitmap. Forward searches skip past the
+// returned frame and pass bLast, reverse searches end their next window
+// before it and want the first one.
 //
 static NV_STATUS
-_pmaRegmapStatus(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end, NvU64 *frameIndex)
+_pmaRegmapStatus(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end, NvBool bLast, NvU64 *frameIndex)
 {
-    NvS64 diff;
-
-    if ((diff = _checkOne(pRegmap->map[MAP_IDX_ALLOC_PIN], start, end)) != -1)
-    {
-        *frameIndex = diff;
-        return NV_ERR_NO_MEMORY;
-    }
-
-    if (pRegmap->frameEvictionsInProcess > 0)
+    NvU64 startMapIdx = PAGE_MAPIDX(start);
+    NvU64 endMapIdx   = PAGE_MAPIDX(end);
+    NvU64 startMask   = (NV_U64_MAX << PAGE_BITIDX(start));
+    NvU64 endMask     = (NV_U64_MAX >> (_UINT_SIZE - PAGE_BITIDX(end) - 1));
+    NvU64 *pUnpin     = pRegmap->map[MAP_IDX_ALLOC_UNPIN];
+    NvU64 *pPin       = pRegmap->map[MAP_IDX_ALLOC_PIN];
+    NvU64 *pEvicting  = pRegmap->map[MAP_IDX_EVICTING];
+    NvU64 *pScrubbing = pRegmap->map[MAP_IDX_SCRUBBING];
+    NvU64 *pNumaReuse = pRegmap->map[MAP_IDX_NUMA_REUSE];
+    NvU64 *pBlacklist = pRegmap->map[MAP_IDX_BLACKLIST];
+    //
+    // Pages that are being evicted may be in the free state so we need to
+    // check for eviction on all frames as long as any eviction is happening
+    // in the region.
+    //
+    NvBool bCheckEvicting = (pRegmap->frameEvictionsInProcess > 0);
+    NvBool bUnpinFound     = NV_FALSE;
+    NvBool bBlacklistFound = NV_FALSE;
+    NvU64 unpinFrame       = 0;
+    NvU64 blacklistFrame   = 0;
+    NvU64 i;
+
+    for (i = 0; i <= (endMapIdx - startMapIdx); i++)
     {
-        //
-        // Pages that are being evicted may be in the free state so we need to
-        // check for eviction on all frames as long as any eviction is happening
-        // in the region.
-        //
-        if ((diff = _checkOne(pRegmap->map[MAP_IDX_EVICTING], start, end)) != -1)
+        NvU64 mapIdx = bLast ? (endMapIdx - i) : (startMapIdx + i);
+        NvU64 mask   = NV_U64_MAX;
+        NvU64 unavailable;
+        NvU64 unpin;
+        NvU64 blacklist;
+
+        if (mapIdx == startMapIdx)
+            mask &= startMask;
+        if (mapIdx == endMapIdx)
+            mask &= endMask;
+
+        unavailable = pPin[mapIdx] | pScrubbing[mapIdx] | pNumaReuse[mapIdx];
+        if (bCheckEvicting)
+            unavailable |= pEvicting[mapIdx];
+
+        unavailable &= mask;
+        if (unavailable != 0)
         {
-            *frameIndex = diff;
+            *frameIndex = (mapIdx << _UINT_SHIFT) +
+                          (bLast ? (_UINT_SIZE - 1 - portUtilCountLeadingZeros64(unavailable)) :
+                                   portUtilCountTrailingZeros64(unavailable));
             return NV_ERR_NO_MEMORY;
         }
-    }
 
-    //
-    // Check SCRUBBING
-    // TODO: Skip this check if scrubbing has been completed for all frames.
-    //
-    if ((diff = _checkOne(pRegmap->map[MAP_IDX_SCRUBBING], start, end)) != -1)
-    {
-        *frameIndex = diff;
-        return NV_ERR_NO_MEMORY;
-    }
+        unpin = pUnpin[mapIdx] & mask;
+        if (!bUnpinFound && (unpin != 0))
+        {
+            bUnpinFound = NV_TRUE;
+            unpinFrame  = (mapIdx << _UINT_SHIFT) +
+                          (bLast ? (_UINT_SIZE - 1 - portUtilCountLeadingZeros64(unpin)) :
+                                   portUtilCountTrailingZeros64(unpin));
+        }
 
-    if ((diff = _checkOne(pRegmap->map[MAP_IDX_NUMA_REUSE], start, end)) != -1)
-    {
-        *frameIndex = diff;
-        return NV_ERR_NO_MEMORY;
+        blacklist = pBlacklist[mapIdx] & mask;
+        if (!bBlacklistFound && (blacklist != 0))
+        {
+            bBlacklistFound = NV_TRUE;
+            blacklistFrame  = (mapIdx << _UINT_SHIFT) +
+                              (bLast ? (_UINT_SIZE - 1 - portUtilCountLeadingZeros64(blacklist)) :
+                                       portUtilCountTrailingZeros64(blacklist));
+        }
     }
 
-    if ((diff = _checkOne(pRegmap->map[MAP_IDX_ALLOC_UNPIN], start, end)) != -1)
+    if (bUnpinFound)
     {
-        *frameIndex = diff;
+        *frameIndex = unpinFrame;
         return NV_ERR_IN_USE;
     }
 
-    if ((diff = _checkOne(pRegmap->map[MAP_IDX_BLACKLIST], start, end)) != -1)
+    if (bBlacklistFound)
     {
-        *frameIndex = diff;
+        *frameIndex = blacklistFrame;
         return NV_ERR_NO_MEMORY;
     }
 
@@ -458,13 +492,13 @@ _pmaRegmapStatus(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end, NvU64 *frameIndex)
 
 //
 // Return ALL_FREE if all frames in the [start, end] range are available for
-// allocation or the first frame index that isn't.
+// allocation or the first (last if bLast) frame index that isn't.
 //
 static NvS64
-_pmaRegmapAvailable(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end)
+_pmaRegmapAvailable(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end, NvBool bLast)
 {
     NvU64 unavailableFrameIndex;
-    NV_STATUS frameStatus = _pmaRegmapStatus(pRegmap, start, end, &unavailableFrameIndex);
+    NV_STATUS frameStatus = _pmaRegmapStatus(pRegmap, start, end, bLast, &unavailableFrameIndex);
 
     if (frameStatus == NV_OK)
         return ALL_FREE;
@@ -478,13 +512,13 @@ _pmaRegmapAvailable(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end)
 //
 // Return ALL_FREE if all frames in the [start, end] range are available for
 // allocation, EVICTABLE if some of them would need to be evicted, or the first
-// frame index that isn't free nor evictable.
+// (last if bLast) frame index that isn't free nor evictable.
 //
 static NvS64
-_pmaRegmapEvictable(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end)
+_pmaRegmapEvictable(PMA_REGMAP *pRegmap, NvU64 start, NvU64 end, NvBool bLast)
 {
     NvU64 unavailableFrameIndex;
-    NvS64 frameStatus = _pmaRegmapStatus(pRegmap, start, end, &unavailableFrameIndex);
+    NvS64 frameStatus = _pmaRegmapStatus(pRegmap, start, end, bLast, &unavailableFrameIndex);
 
     if (frameStatus == NV_OK)
         return ALL_FREE;
@@ -814,7 +848,7 @@ static NvS64 _scanContiguousSearchLoop
     NvU64 freeStart;
     PMA_PAGESTATUS startStatus, endStatus, state;
     NvS64 checkDiff;
-    NvS64 (*useFunc)(PMA_REGMAP *, NvU64, NvU64);
+    NvS64 (*useFunc)(PMA_REGMAP *, NvU64, NvU64, NvBool);
 
     if (!bSearchEvictable)
     {
@@ -841,7 +875,7 @@ static NvS64 _scanContiguousSearchLoop
         {
             if (startStatus == STATE_FREE || startStatus == state)
             {
-                NvS64 diff = (*useFunc)(pRegmap, freeStart, (freeStart + numFrames - 1));
+                NvS64 diff = (*useFunc)(pRegmap, freeStart, (freeStart + numFrames - 1), NV_TRUE);
                 if (diff == checkDiff)
                 {
                     return (NvS64)freeStart;
@@ -892,7 +926,7 @@ static NvS64 _scanContiguousSearchLoopReverse
     NvU64 freeStart;
     PMA_PAGESTATUS startStatus, endStatus, state;
     NvS64 checkDiff;
-    NvS64 (*useFunc)(PMA_REGMAP *, NvU64, NvU64);
+    NvS64 (*useFunc)(PMA_REGMAP *, NvU64, NvU64, NvBool);
 
     if (!bSearchEvictable)
     {
@@ -922,7 +956,7 @@ static NvS64 _scanContiguousSearchLoopReverse
         {
             if (endStatus == STATE_FREE || endStatus == state)
             {
-                NvS64 diff = (*useFunc)(pRegmap, freeStart, (freeStart + numFrames - 1));
+                NvS64 diff = (*useFunc)(pRegmap, freeStart, (freeStart + numFrames - 1), NV_FALSE);
                 if (diff == checkDiff)
                 {
                     return (NvS64)freeStart;
@@ -1140,7 +1174,7 @@ pmaRegmapScanDiscontiguous
         {
             if(endStatus == STATE_FREE)
             {
-                NvS64 diff = _pmaRegmapAvailable(pRegmap, freeStart, (freeStart + framesPerPage - 1));
+                NvS64 diff = _pmaRegmapAvailable(pRegmap, freeStart, (freeStart + framesPerPage - 1), NV_FALSE);
                 if (diff == ALL_FREE)
                 {
                     freeList[found++] = addrBase + (freeStart << PMA_PAGE_SHIFT);
@@ -1182,7 +1216,7 @@ pmaRegmapScanDiscontiguous
         {
             if(endStatus == STATE_FREE || endStatus == STATE_UNPIN)
             {
-                NvS64 diff = _pmaRegmapEvictable(pRegmap, freeStart, (freeStart + framesPerPage - 1));
+                NvS64 diff = _pmaRegmapEvictable(pRegmap, freeStart, (freeStart + framesPerPage - 1), NV_FALSE);
                 if (diff == EVICTABLE)
                 {
                     freeList[found++] = addrBase + (freeStart << PMA_PAGE_SHIFT);
@@ -1232,7 +1266,7 @@ pmaRegmapGetLargestFree
             bitmap |= (~0ULL) << PAGE_BITIDX(pRegmap->totalFrames);
         }
 
-        if (maxZerosGet(bitmap) == _UINT_SIZE)
+        if (bitmap == 0)
         {
             mapTrailZeros += _UINT_SIZE;
         }
@@ -1251,6 +1285,35 @@ pmaRegmapGetLargestFree
     *pLargestFree = ((NvU64) regionMaxZeros) << PMA_PAGE_SHIFT;
 }
 
+NvU64
+pmaRegmapGetFreeAlignedCount
+(
+    void  *pMap,
+    NvU64  addrBase,
+    NvU64  size
+)
+{
+    PMA_REGMAP *pRegmap = (PMA_REGMAP *)pMap;
+    NvU64 framesPerChunk = size >> PMA_PAGE_SHIFT;
+    NvU64 frame = (NV_ALIGN_UP(addrBase, size) - addrBase) >> PMA_PAGE_SHIFT;
+    NvU64 count = 0;
+
+    NV_ASSERT_OR_RETURN(framesPerChunk != 0, 0);
+
+    for (; (frame + framesPerChunk) <= pRegmap->totalFrames; frame += framesPerChunk)
+    {
+        NvU64 lastFrame = frame + framesPerChunk - 1;
+
+        if ((_checkOne(pRegmap->map[MAP_IDX_ALLOC_PIN], frame, lastFrame) == -1) &&
+            (_checkOne(pRegmap->map[MAP_IDX_ALLOC_UNPIN], frame, lastFrame) == -1))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
 NvU64 pmaRegmapGetEvictingFrames(void *pMap)
 {
     return ((PMA_REGMAP *)pMap)->frameEvictionsInProcess;
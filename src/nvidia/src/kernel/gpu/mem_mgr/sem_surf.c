@@ -190,11 +190,46 @@ _semsurfSetValue
     }
 }
 
+/*
+ * Indices whose value was advanced by waiters (newValue) while delivering
+ * notifications. Only these need to be checked again by the event callback,
+ * GPU-side releases raise an interrupt of their own.
+ */
+#define SEM_MAX_DIRTY_INDICES 32
+
+typedef struct {
+    NvU32  count;
+    NvBool bOverflow;
+    NvU64  indices[SEM_MAX_DIRTY_INDICES];
+} SEM_DIRTY_INDICES;
+
+static void
+_semsurfMarkIndexDirty
+(
+    SEM_DIRTY_INDICES *pDirty,
+    NvU64 index
+)
+{
+    NvU32 i;
+
+    for (i = 0; i < pDirty->count; i++)
+    {
+        if (pDirty->indices[i] == index)
+            return;
+    }
+
+    if (pDirty->count == SEM_MAX_DIRTY_INDICES)
+        pDirty->bOverflow = NV_TRUE;
+    else
+        pDirty->indices[pDirty->count++] = index;
+}
+
 static NvBool
 _semsurfNotifyCompleted
 (
     SEM_SHARED_DATA *pShared,
-    SEM_PENDING_NOTIFICATIONS *notifications
+    SEM_PENDING_NOTIFICATIONS *notifications,
+    SEM_DIRTY_INDICES *pDirty
 )
 {
     OBJGPU *pGpu = pShared->pSemaphoreMem->pGpu;
@@ -258,6 +293,9 @@ _semsurfNotifyCompleted
                       pShared->hClient, pShared->hSemaphoreMem, pVNode->newValue, pVNode->index);
 
             valuesChanged = NV_TRUE;
+
+            if (pDirty != NULL)
+                _semsurfMarkIndexDirty(pDirty, pVNode->index);
         }
 
         listRemove(notifications, pendIter.pValue);
@@ -301,6 +339,68 @@ _semsurfSetMonitoredValue
     *pMonitoredFence = value;
 }
 
+/*
+ * Moves the signaled value listeners at an index to the pending notification
+ * list. Must be called with the spinlock held.
+ *
+ * Returns NV_TRUE if the index has no listeners left and was freed.
+ */
+static NvBool
+_semsurfCollectSignaled
+(
+    SEM_SHARED_DATA *pShared,
+    SEM_INDEX_LISTENERS_NODE *pIndexListeners,
+    NvU64 index,
+    SEM_PENDING_NOTIFICATIONS *notifications
+)
+{
+    SEM_VALUE_LISTENERS_NODE *pValueListeners;
+    NvU64 semValue;
+    NvU64 minWaitValue = NV_U64_MAX;
+    NvBool bSignaled = NV_FALSE;
+
+    semValue = _semsurfGetValue(pShared, index);
+
+    /* The listeners are sorted by value, the head is the min wait value. */
+    while ((pValueListeners = listHead(&pIndexListeners->listeners)) != NULL)
+    {
+        NV_PRINTF(LEVEL_SILENT,
+                  "  Checking index %" NvU64_fmtu " value waiter %"
+                  NvU64_fmtu " against semaphore value %" NvU64_fmtu "\n",
+                  index, pValueListeners->value, semValue);
+
+        if (semValue < pValueListeners->value)
+        {
+            /* No other values at this index should be signaled yet. */
+            minWaitValue = pValueListeners->value;
+            break;
+        }
+
+        listRemove(&pIndexListeners->listeners, pValueListeners);
+        listInsertExisting(notifications, NULL, pValueListeners);
+        bSignaled = NV_TRUE;
+    }
+
+    /*
+     * The monitored fence already holds the min wait value unless some
+     * listeners were just signaled, so leave it alone otherwise.
+     */
+    if (!bSignaled)
+        return NV_FALSE;
+
+    _semsurfSetMonitoredValue(pShared, index, minWaitValue);
+
+    if (listCount(&pIndexListeners->listeners) == 0)
+    {
+        NV_ASSERT(minWaitValue == NV_U64_MAX);
+        mapRemove(&pShared->listenerMap, pIndexListeners);
+        portMemFree(pIndexListeners);
+        return NV_TRUE;
+    }
+
+    return NV_FALSE;
+}
+
 static void
 _semsurfEventCallback
 (
@@ -312,19 +412,21 @@ _semsurfEventCallback
 )
 {
     SEM_SHARED_DATA *pShared = pArg;
-    SEM_INDEX_LISTENERSIter ilIter;
-    SEM_VALUE_LISTENERSIter vlIter;
+    SEM_INDEX_LISTENERS_NODE *pIndexListeners;
+    SEM_INDEX_LISTENERS_NODE *pNextIndexListeners;
     SEM_PENDING_NOTIFICATIONS notifications;
+    SEM_DIRTY_INDICES dirty;
     NvU64 index;
-    NvU64 semValue;
-    NvU64 minWaitValue;
-    NvBool removedIndex = NV_FALSE;
+    NvU32 i;
+    NvBool bScanAll = NV_TRUE;
     NvBool valuesChanged = NV_TRUE;
 
     NV_PRINTF(LEVEL_INFO, "SemMem(0x%08x, 0x%08x): Got a callback\n", pShared->hClient, pShared->hSemaphoreMem);
     NV_PRINTF(LEVEL_INFO, "  hEvent: 0x%08x surf event: 0x%08x, data 0x%08x, status 0x%08x\n",
               hEvent, pShared->hEvent, data, status);
 
+    portMemSet(&dirty, 0, sizeof(dirty));
+
     while (valuesChanged)
     {
         listInitIntrusive(&notifications);
@@ -334,56 +436,35 @@ _semsurfEventCallback
                   pShared->hSemaphoreMem);
         portSyncSpinlockAcquire(pShared->pSpinlock);
 
-        for (ilIter = mapIterAll(&pShared->listenerMap);
-             mapIterNext(&ilIter);
-             removedIndex ? ilIter = mapIterAll(&pShared->listenerMap) :
-             ilIter)
+        if (bScanAll)
         {
-            removedIndex = NV_FALSE;
-            minWaitValue = NV_U64_MAX;
-
             /*
-             * TODO Only notify if vlIter.pValue->value <= the semaphore current
-             * value at mapKey(&pShared->listenerMap, ilIter->pValue)
+             * The interrupt doesn't say which index was released, so every
+             * index is read once. Freed nodes are stepped over rather than
+             * restarting the walk.
              */
-            index = mapKey(&pShared->listenerMap, ilIter.pValue);
-            semValue = _semsurfGetValue(pShared, index);
-
-            for (vlIter = listIterAll(&ilIter.pValue->listeners);
-                 listIterNext(&vlIter);
-                 vlIter = listIterAll(&ilIter.pValue->listeners))
+            for (pIndexListeners = mapFindGEQ(&pShared->listenerMap, 0);
+                 pIndexListeners;
+                 pIndexListeners = pNextIndexListeners)
             {
-                NV_PRINTF(LEVEL_SILENT,
-                          "  Checking index %" NvU64_fmtu " value waiter %"
-                          NvU64_fmtu " against semaphore value %" NvU64_fmtu "\n",
-                          index, vlIter.pValue->value, semValue);
-
-                if (semValue >= vlIter.pValue->value)
-                {
-                    listInsertExisting(&notifications, NULL, vlIter.pValue);
-                    listRemove(&ilIter.pValue->listeners, vlIter.pValue);
-                }
-                else
-                {
-                    /* No other values at this index should be signaled yet. */
-                    minWaitValue = vlIter.pValue->value;
-                    break;
-                }
-            }
+                pNextIndexListeners = mapNext(&pShared->listenerMap, pIndexListeners);
+                index = mapKey(&pShared->listenerMap, pIndexListeners);
 
-            if (listCount(&ilIter.pValue->listeners) == 0)
-            {
-                NV_ASSERT(minWaitValue == NV_U64_MAX);
-                mapRemove(&pShared->listenerMap, ilIter.pValue);
-                portMemFree(ilIter.pValue);
-                removedIndex = NV_TRUE;
+                _semsurfCollectSignaled(pShared, pIndexListeners, index,
+                                        &notifications);
             }
-            else
+        }
+        else
+        {
+            for (i = 0; i < dirty.count; i++)
             {
-                removedIndex = NV_FALSE;
+                pIndexListeners = mapFind(&pShared->listenerMap, dirty.indices[i]);
+                if (pIndexListeners)
+                {
+                    _semsurfCollectSignaled(pShared, pIndexListeners,
+                                            dirty.indices[i], &notifications);
+                }
             }
-
-            _semsurfSetMonitoredValue(pShared, index, minWaitValue);
         }
 
         portSyncSpinlockRelease(pShared->pSpinlock);
@@ -395,7 +476,9 @@ _semsurfEventCallback
         // from the object-wide lists, so their existance is private to this
         // instance of this function now. Hence, no locking is required for this
         // step.
-        valuesChanged = _semsurfNotifyCompleted(pShared, &notifications);
+        portMemSet(&dirty, 0, sizeof(dirty));
+        valuesChanged = _semsurfNotifyCompleted(pShared, &notifications, &dirty);
+        bScanAll = dirty.bOverflow;
     }
 }
 
@@ -1114,7 +1197,8 @@ _semsurfSetValueAndNotify
         // instance of this function now. Hence, no locking is required for this
         // step.
         valueChanged = _semsurfNotifyCompleted(pSemSurf->pShared,
-                                               &notifications);
+                                               &notifications,
+                                               NULL);
 
         NV_ASSERT(!valueChanged || (newValue > curValue));
     }
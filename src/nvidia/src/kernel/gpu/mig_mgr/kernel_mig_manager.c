@@ -2991,6 +2991,8 @@ kmigmgrSetPartitioningMode_IMPL
 
     pKernelMIGManager->bMIGEnabled = (params.smcMode == NV2080_CTRL_GPU_INFO_GPU_SMC_MODE_ENABLED);
 
+    rmapiControlCacheInvalidate(pGpu->gpuInstance, RMAPI_CONTROL_CACHE_INVALIDATE_MIG_CONFIG);
+
     // MIG Mode might not have been enabled yet, so load static info if enabled
     if (IS_MIG_ENABLED(pGpu))
     {
@@ -795,7 +795,8 @@ _gmmuWalkCBUpdatePde
         dest.offset = entryIndex * pLevelFmt->entrySize;
         NV_ASSERT_OK(memmgrMemWrite(GPU_GET_MEMORY_MANAGER(pGpu), &dest,
                                     entry.v8, pLevelFmt->entrySize,
-                                    TRANSFER_FLAGS_NONE));
+                                    gvaspaceWalkUserCtxTransferFlags(pUserCtx,
+                                        TRANSFER_FLAGS_NONE)));
     }
 
     return NV_TRUE;
@@ -956,7 +957,8 @@ _gmmuWalkCBFillEntries
         }
 
         memmgrMemEndTransfer(pMemoryManager, &dest, sizeOfEntries,
-                             TRANSFER_FLAGS_SHADOW_ALLOC);
+                             gvaspaceWalkUserCtxTransferFlags(pUserCtx,
+                                 TRANSFER_FLAGS_SHADOW_ALLOC));
     }
 
     *pProgress = entryIndexHi - entryIndexLo + 1;
@@ -999,7 +1001,9 @@ _gmmuWalkCBCopyEntries
                   entryIndexHi);
 
         NV_ASSERT_OK(memmgrMemCopy(GPU_GET_MEMORY_MANAGER(pGpu), &dest, &src,
-                                   sizeOfEntries, TRANSFER_FLAGS_NONE));
+                                   sizeOfEntries,
+                                   gvaspaceWalkUserCtxTransferFlags(pUserCtx,
+                                       TRANSFER_FLAGS_NONE)));
     }
 
     // Report full range complete.
@@ -171,6 +171,18 @@ _krcInitRegistryOverrides
             pKernelRc->watchdogPersistent.timeoutSecs;
     }
 
+    if ((osReadRegistryDword(pGpu,
+                             NV_REG_STR_RM_WATCHDOG_INTERVAL_MAX,
+                             &pKernelRc->watchdogPersistent.maxIntervalSecs) != NV_OK) ||
+        (pKernelRc->watchdogPersistent.maxIntervalSecs <
+         pKernelRc->watchdogPersistent.intervalSecs))
+    {
+        pKernelRc->watchdogPersistent.maxIntervalSecs =
+            pKernelRc->watchdogPersistent.intervalSecs;
+    }
+    pKernelRc->watchdogPersistent.curIntervalSecs =
+        pKernelRc->watchdogPersistent.intervalSecs;
+
 
     dword = 0;
     if (osReadRegistryDword(pGpu, NV_REG_STR_RM_RC_WATCHDOG, &dword) == NV_OK)
@@ -220,6 +220,8 @@ krcWatchdog_IMPL
 
             // Run Immediately
             pKernelRc->watchdogPersistent.nextRunTime = 0;
+            pKernelRc->watchdogPersistent.curIntervalSecs =
+                pKernelRc->watchdogPersistent.intervalSecs;
         }
 
         // Handle robust channel testing, if necessary.
@@ -285,6 +287,8 @@ krcWatchdog_IMPL
                 SLI_LOOP_END;
 
                 pKernelRc->watchdogPersistent.nextRunTime = 0;
+                pKernelRc->watchdogPersistent.curIntervalSecs =
+                    pKernelRc->watchdogPersistent.intervalSecs;
 
                 NV_PRINTF(LEVEL_WARNING, "RC watchdog: Trying to recover.\n");
 
@@ -316,9 +320,29 @@ krcWatchdog_IMPL
 
         if (currentTime >= pKernelRc->watchdogPersistent.nextRunTime)
         {
+            //
+            // Adaptive interval: each run whose notifier came back on time
+            // doubles the interval up to maxIntervalSecs, so a healthy GPU
+            // sees fewer watchdog pushes. Falling through from the reset
+            // limit above means the last run was late; go back to the base
+            // interval.
+            //
+            if (!allNotifiersWritten)
+            {
+                pKernelRc->watchdogPersistent.curIntervalSecs =
+                    pKernelRc->watchdogPersistent.intervalSecs;
+            }
+            else if (pKernelRc->watchdogPersistent.curIntervalSecs <
+                     pKernelRc->watchdogPersistent.maxIntervalSecs)
+            {
+                pKernelRc->watchdogPersistent.curIntervalSecs =
+                    NV_MIN(pKernelRc->watchdogPersistent.curIntervalSecs * 2,
+                           pKernelRc->watchdogPersistent.maxIntervalSecs);
+            }
+
             // Stored as microseconds (1000000 of a second)
             pKernelRc->watchdogPersistent.nextRunTime = currentTime +
-                (pKernelRc->watchdogPersistent.intervalSecs * 1000000);
+                ((NvU64)pKernelRc->watchdogPersistent.curIntervalSecs * 1000000);
             pKernelRc->watchdogPersistent.notifyLimitTime = currentTime +
                 (pKernelRc->watchdogPersistent.timeoutSecs * 1000000);
             pKernelRc->watchdogPersistent.resetLimitTime = currentTime +
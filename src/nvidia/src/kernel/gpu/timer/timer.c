@@ -213,6 +213,15 @@ static NV_INLINE NvBool tmrIsOSTimer(OBJTMR *pTmr, PTMR_EVENT pEventPublic)
            (pEventPublic->flags & TMR_FLAG_USE_OS_TIMER)));
 }
 
+/*!
+ * The OS timer list is doubly linked and unsorted, so membership can be
+ * checked without walking it: only the head has no previous element.
+ */
+static NV_INLINE NvBool _tmrOSTimerEventOnList(OBJTMR *pTmr, PTMR_EVENT_PVT pEvent)
+{
+    return (pEvent->pPrev != NULL) || (pTmr->pRmActiveOSTimerEventList == pEvent);
+}
+
 /*!
  * Allocates the necessary memory for storing a callback in the timer.
  *
@@ -239,6 +248,7 @@ NV_STATUS tmrEventCreate_IMPL
     (*ppEvent)->bLegacy         = NV_FALSE;
     (*ppEvent)->bInUse          = NV_FALSE;
     (*ppEvent)->pNext           = NULL;
+    (*ppEvent)->pPrev           = NULL;
     (*ppEventPublic)->pTimeProc = Proc;
     (*ppEventPublic)->pUserData = pUserData;
     (*ppEventPublic)->flags     = flags;
@@ -644,9 +654,17 @@ NvBool tmrEventOnList_IMPL
 )
 {
     PTMR_EVENT_PVT pEvent = (PTMR_EVENT_PVT)pEventPublic;
-    PTMR_EVENT_PVT pScan  = tmrIsOSTimer(pTmr, pEventPublic) ?
-                            pTmr->pRmActiveOSTimerEventList :
-                            pTmr->pRmActiveEventList;
+    PTMR_EVENT_PVT pScan  = pTmr->pRmActiveEventList;
+
+    if (tmrIsOSTimer(pTmr, pEventPublic))
+    {
+        if (_tmrOSTimerEventOnList(pTmr, pEvent))
+        {
+            NV_ASSERT(pEvent->bInUse);
+            return NV_TRUE;
+        }
+        return NV_FALSE;
+    }
 
     while (pScan != NULL)
     {
@@ -777,7 +795,12 @@ _tmrInsertCallbackInList
 
     if (tmrIsOSTimer(pTmr, (PTMR_EVENT)pEvent))
     {
+        pEvent->pPrev = NULL;
         pEvent->pNext = pTmr->pRmActiveOSTimerEventList;
+        if (pEvent->pNext != NULL)
+        {
+            pEvent->pNext->pPrev = pEvent;
+        }
         pTmr->pRmActiveOSTimerEventList = pEvent;
         return;
     }
@@ -1065,27 +1088,28 @@ _tmrScanCallbackOSTimer
     PTMR_EVENT_PVT  pEvent
 )
 {
-    PTMR_EVENT_PVT  pCurrent = pTmr->pRmActiveOSTimerEventList;
-
-    if (pCurrent == pEvent)
+    if (!_tmrOSTimerEventOnList(pTmr, pEvent))
     {
-        pTmr->pRmActiveOSTimerEventList = pCurrent->pNext;
-        pEvent->pNext = NULL;
-        pEvent->bInUse = NV_FALSE;
         return;
     }
 
-    while (pCurrent != NULL)
+    if (pEvent->pPrev != NULL)
     {
-        if (pCurrent->pNext == pEvent)
-        {
-            pCurrent->pNext = pEvent->pNext;
-            pEvent->pNext = NULL;
-            pEvent->bInUse = NV_FALSE;
-            break;
-        }
-        pCurrent = pCurrent->pNext;
+        pEvent->pPrev->pNext = pEvent->pNext;
+    }
+    else
+    {
+        pTmr->pRmActiveOSTimerEventList = pEvent->pNext;
     }
+
+    if (pEvent->pNext != NULL)
+    {
+        pEvent->pNext->pPrev = pEvent->pPrev;
+    }
+
+    pEvent->pNext = NULL;
+    pEvent->pPrev = NULL;
+    pEvent->bInUse = NV_FALSE;
 }
 
 // determine which (if any) callback should determine the next alarm time
@@ -41,6 +41,10 @@
 #include "kernel/gpu/fifo/kernel_fifo.h"
 #include "kernel/gpu/gr/kernel_graphics.h"
 #include "gpu/mem_mgr/heap.h"
+#include "kernel/gpu/mig_mgr/kernel_mig_manager.h"
+#include "gpu_mgr/gpu_mgr.h"
+#include "nvrm_registry.h"
+#include "os/os.h"
 
 /*
  * @brief Are memory pools supported for context buffers
@@ -131,6 +135,7 @@ ctxBufPoolInit
     pCtxBufPool = portMemAllocNonPaged(sizeof(CTX_BUF_POOL_INFO));
     NV_ASSERT_OR_RETURN((pCtxBufPool != NULL), NV_ERR_NO_MEMORY);
     portMemSet(pCtxBufPool, 0, sizeof(CTX_BUF_POOL_INFO));
+    pCtxBufPool->pHeap = pHeap;
 
     //
     // create a mem pool for each page size supported by RM
@@ -740,3 +745,272 @@ ctxBufPoolSetScrubSkip
         rmMemPoolSkipScrub(pCtxBufPool->pMemPool[i], bSkipScrub);
     }
 }
+
+/*
+ * @brief Checks that no buffer allocated from the ctx buf pool is still live
+ *
+ * @param[in] pCtxBufPool  Pointer to context buffer pool
+ *
+ * @return NvBool
+ */
+NvBool
+ctxBufPoolIsIdle
+(
+    CTX_BUF_POOL_INFO *pCtxBufPool
+)
+{
+    NvU32 i;
+    NV_ASSERT_OR_RETURN(pCtxBufPool != NULL, NV_FALSE);
+    for (i = 0; i < RM_ATTR_PAGE_SIZE_INVALID; i++)
+    {
+        if ((pCtxBufPool->pMemPool[i] != NULL) &&
+            !rmMemPoolIsIdle(pCtxBufPool->pMemPool[i]))
+        {
+            return NV_FALSE;
+        }
+    }
+
+    return NV_TRUE;
+}
+
+static CTX_BUF_POOL_CACHE *
+_ctxBufPoolCacheGetOrCreate
+(
+    OBJGPU *pGpu,
+    Heap   *pHeap
+)
+{
+    CTX_BUF_POOL_CACHE *pCache = pHeap->pCtxBufPoolCache;
+    NvU32 data;
+
+    if ((pCache != NULL) || !ctxBufPoolIsSupported(pGpu))
+        return pCache;
+
+    pCache = portMemAllocNonPaged(sizeof(*pCache));
+    if (pCache == NULL)
+        return NULL;
+    portMemSet(pCache, 0, sizeof(*pCache));
+
+    pCache->prewarmCount = NV_REG_STR_RM_CTX_BUF_POOL_PREWARM_DEFAULT;
+    if (osReadRegistryDword(pGpu, NV_REG_STR_RM_CTX_BUF_POOL_PREWARM, &data) == NV_OK)
+        pCache->prewarmCount = NV_MIN(data, CTX_BUF_POOL_CACHE_MAX_POOLS);
+
+    pHeap->pCtxBufPoolCache = pCache;
+    return pCache;
+}
+
+/*
+ * @brief Gets a ctx buf pool for a new context, reusing an idle reserved
+ *        pool of the heap if one is cached
+ *
+ * @param[in]  pGpu          OBJGPU pointer
+ * @param[in]  pHeap         Heap the pool reserves memory from
+ * @param[out] ppCtxBufPool  Pointer to the pool, NULL if pools are not supported
+ *
+ * @return NV_STATUS
+ */
+NV_STATUS
+ctxBufPoolCacheGet
+(
+    OBJGPU             *pGpu,
+    Heap               *pHeap,
+    CTX_BUF_POOL_INFO **ppCtxBufPool
+)
+{
+    CTX_BUF_POOL_CACHE *pCache;
+
+    NV_ASSERT_OR_RETURN(ppCtxBufPool != NULL, NV_ERR_INVALID_ARGUMENT);
+
+    pCache = _ctxBufPoolCacheGetOrCreate(pGpu, pHeap);
+    if ((pCache != NULL) && (pCache->poolCount > 0))
+    {
+        *ppCtxBufPool = pCache->pPools[--pCache->poolCount];
+        pCache->pPools[pCache->poolCount] = NULL;
+        return NV_OK;
+    }
+
+    return ctxBufPoolInit(pGpu, pHeap, ppCtxBufPool);
+}
+
+/*
+ * @brief Returns the ctx buf pool of a freed context to the cache of its heap
+ *        with its reservation intact, or releases and destroys it if the
+ *        cache is full
+ *
+ * @param[in]     pGpu          OBJGPU pointer
+ * @param[in,out] ppCtxBufPool  Pointer to the pool, set to NULL
+ */
+void
+ctxBufPoolCachePut
+(
+    OBJGPU             *pGpu,
+    CTX_BUF_POOL_INFO **ppCtxBufPool
+)
+{
+    CTX_BUF_POOL_INFO  *pCtxBufPool;
+    CTX_BUF_POOL_CACHE *pCache;
+
+    NV_ASSERT_OR_RETURN_VOID((ppCtxBufPool != NULL) && (*ppCtxBufPool != NULL));
+
+    pCtxBufPool = *ppCtxBufPool;
+    pCache = pCtxBufPool->pHeap->pCtxBufPoolCache;
+
+    if ((pCache != NULL) &&
+        (pCache->poolCount < pCache->prewarmCount) &&
+        ctxBufPoolIsIdle(pCtxBufPool))
+    {
+        ctxBufPoolSetScrubSkip(pCtxBufPool, NV_FALSE);
+        pCache->pPools[pCache->poolCount++] = pCtxBufPool;
+        *ppCtxBufPool = NULL;
+        return;
+    }
+
+    ctxBufPoolRelease(pCtxBufPool);
+    ctxBufPoolDestroy(ppCtxBufPool);
+}
+
+typedef struct
+{
+    NvU32 swizzId;
+} CTX_BUF_POOL_PREWARM_PARAMS;
+
+static void
+_ctxBufPoolCachePrewarm_WORKITEM
+(
+    NvU32 gpuInstance,
+    void *pArgs
+)
+{
+    CTX_BUF_POOL_PREWARM_PARAMS *pParams = pArgs;
+    OBJGPU *pGpu = gpumgrGetGpu(gpuInstance);
+    CTX_BUF_POOL_CACHE *pCache;
+    Heap *pHeap = NULL;
+
+    if ((pGpu == NULL) || !gpuIsStateLoaded(pGpu))
+        return;
+
+    if (pParams->swizzId == KMIGMGR_SWIZZID_INVALID)
+    {
+        pHeap = GPU_GET_HEAP(pGpu);
+    }
+    else
+    {
+        KernelMIGManager *pKernelMIGManager = GPU_GET_KERNEL_MIG_MANAGER(pGpu);
+        KERNEL_MIG_GPU_INSTANCE *pKernelMIGGpuInstance;
+
+        // The GPU instance may have been destroyed since the work was queued
+        if (kmigmgrGetGPUInstanceInfo(pGpu, pKernelMIGManager, pParams->swizzId,
+                                      &pKernelMIGGpuInstance) == NV_OK)
+        {
+            pHeap = pKernelMIGGpuInstance->pMemoryPartitionHeap;
+        }
+    }
+
+    if ((pHeap == NULL) || (pHeap->pCtxBufPoolCache == NULL))
+        return;
+
+    pCache = pHeap->pCtxBufPoolCache;
+    pCache->bPrewarmQueued = NV_FALSE;
+
+    // Called with only the API lock held, PMA reservations need the GPU lock dropped
+    while ((pCache->poolCount < pCache->prewarmCount) && (pCache->bufCount > 0))
+    {
+        CTX_BUF_POOL_INFO *pCtxBufPool = NULL;
+
+        if ((ctxBufPoolInit(pGpu, pHeap, &pCtxBufPool) != NV_OK) || (pCtxBufPool == NULL))
+            break;
+
+        if (ctxBufPoolReserve(pGpu, pCtxBufPool, pCache->bufInfoList, pCache->bufCount) != NV_OK)
+        {
+            ctxBufPoolDestroy(&pCtxBufPool);
+            break;
+        }
+
+        pCache->pPools[pCache->poolCount++] = pCtxBufPool;
+    }
+
+    NV_PRINTF(LEVEL_INFO, "%u reserved ctx buf pools ready\n", pCache->poolCount);
+}
+
+/*
+ * @brief Records the buffers reserved for a GR context and queues a work item
+ *        reserving pools for the next contexts if the cache is below its
+ *        prewarm count. Must be called without the GPU lock.
+ *
+ * @param[in] pGpu          OBJGPU pointer
+ * @param[in] pCtxBufPool   Pool that was just reserved
+ * @param[in] swizzId       GPU instance owning the pool's heap,
+ *                          KMIGMGR_SWIZZID_INVALID for the GPU heap
+ * @param[in] pBufInfoList  List of context buffers reserved in the pool
+ * @param[in] bufCount      Number of buffers in the list
+ */
+void
+ctxBufPoolCachePrewarm
+(
+    OBJGPU            *pGpu,
+    CTX_BUF_POOL_INFO *pCtxBufPool,
+    NvU32              swizzId,
+    CTX_BUF_INFO      *pBufInfoList,
+    NvU32              bufCount
+)
+{
+    OBJOS *pOS = GPU_GET_OS(pGpu);
+    CTX_BUF_POOL_CACHE *pCache;
+    CTX_BUF_POOL_PREWARM_PARAMS *pParams;
+
+    NV_ASSERT_OR_RETURN_VOID(pCtxBufPool != NULL);
+    NV_ASSERT_OR_RETURN_VOID(bufCount <= CTX_BUF_POOL_CACHE_MAX_BUFS);
+
+    pCache = pCtxBufPool->pHeap->pCtxBufPoolCache;
+    if ((pCache == NULL) || (bufCount == 0))
+        return;
+
+    portMemCopy(pCache->bufInfoList, sizeof(pCache->bufInfoList),
+                pBufInfoList, bufCount * sizeof(*pBufInfoList));
+    pCache->bufCount = bufCount;
+
+    if (pCache->bPrewarmQueued || (pCache->poolCount >= pCache->prewarmCount))
+        return;
+
+    pParams = portMemAllocNonPaged(sizeof(*pParams));
+    if (pParams == NULL)
+        return;
+    pParams->swizzId = swizzId;
+
+    if (pOS->osQueueWorkItemWithFlags(pGpu, _ctxBufPoolCachePrewarm_WORKITEM, pParams,
+                                      OS_QUEUE_WORKITEM_FLAGS_LOCK_API_RW) != NV_OK)
+    {
+        portMemFree(pParams);
+        return;
+    }
+
+    pCache->bPrewarmQueued = NV_TRUE;
+}
+
+/*
+ * @brief Releases the pools cached for a heap and frees the cache
+ *
+ * @param[in] pHeap  Heap pointer
+ */
+void
+ctxBufPoolCacheDestroy
+(
+    Heap *pHeap
+)
+{
+    CTX_BUF_POOL_CACHE *pCache = pHeap->pCtxBufPoolCache;
+
+    if (pCache == NULL)
+        return;
+
+    while (pCache->poolCount > 0)
+    {
+        CTX_BUF_POOL_INFO **ppCtxBufPool = &pCache->pPools[--pCache->poolCount];
+
+        ctxBufPoolRelease(*ppCtxBufPool);
+        ctxBufPoolDestroy(ppCtxBufPool);
+    }
+
+    portMemFree(pCache);
+    pHeap->pCtxBufPoolCache = NULL;
+}
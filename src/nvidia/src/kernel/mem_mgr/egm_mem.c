@@ -295,6 +295,22 @@ egmmemAllocResources
     NvBool                       bContig         = FLD_TEST_DRF(OS32, _ATTR, _PHYSICALITY,
                                                                 _CONTIGUOUS, pVidHeapAlloc->attr);
 
+    //
+    // EGM is backed by the same OS allocator as sysmem. When the client asks
+    // for big or huge GPU pages without specifying contiguity, allocate
+    // contiguously like sysmem does, so the GPU mapping can use the requested
+    // page size instead of falling back to 4K PTEs.
+    //
+    if (FLD_TEST_DRF(OS32, _ATTR, _PHYSICALITY, _DEFAULT, pVidHeapAlloc->attr))
+    {
+        if ((FLD_TEST_DRF(OS32, _ATTR, _PAGE_SIZE, _BIG, pVidHeapAlloc->attr) ||
+             FLD_TEST_DRF(OS32, _ATTR, _PAGE_SIZE, _HUGE, pVidHeapAlloc->attr)) &&
+            (pMemoryManager->sysmemPageSize == RM_PAGE_SIZE))
+        {
+            bContig = NV_TRUE;
+        }
+    }
+
     //
     // Check for virtual-only parameters used on physical allocs.
     //
@@ -337,6 +353,20 @@ egmmemAllocResources
     pVidHeapAlloc->attr = pFbAllocInfo->retAttr;
     pVidHeapAlloc->attr2 = pFbAllocInfo->retAttr2;
 
+    // update contiguity attribute to reflect memdesc
+    if (memdescGetContiguity(pAllocRequest->pMemDesc, AT_GPU))
+    {
+        pVidHeapAlloc->attr = FLD_SET_DRF(OS32, _ATTR, _PHYSICALITY,
+                                          _CONTIGUOUS,
+                                          pVidHeapAlloc->attr);
+    }
+    else
+    {
+        pVidHeapAlloc->attr = FLD_SET_DRF(OS32, _ATTR, _PHYSICALITY,
+                                          _NONCONTIGUOUS,
+                                          pVidHeapAlloc->attr);
+    }
+
     pVidHeapAlloc->offset = pFbAllocInfo->offset;
 
     if (pAllocRequest->pHwResource != NULL)
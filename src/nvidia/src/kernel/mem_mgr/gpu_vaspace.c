@@ -1588,10 +1588,10 @@ gvaspaceAlloc_IMPL
         // Loop over each GPU associated with VAS.
         FOR_EACH_GPU_IN_MASK_UC(32, pSys, pGpu, pVAS->gpuMask)
         {
-            KernelBus  *pKernelBus = GPU_GET_KERNEL_BUS(pGpu);
             MMU_WALK_USER_CTX userCtx = {0};
 
             // Sparsify the VA range.
+            userCtx.bDeferFlush = NV_TRUE;
             gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
 
             if (NULL == userCtx.pGpuState)
@@ -1611,10 +1611,7 @@ gvaspaceAlloc_IMPL
                 break;
             }
 
-            // Invalidate TLB to apply new sparse state.
-            kbusFlush_HAL(pGpu, pKernelBus, BUS_FLUSH_VIDEO_MEMORY  |
-                                            BUS_FLUSH_SYSTEM_MEMORY |
-                                            BUS_FLUSH_USE_PCIE_READ);
+            // Invalidate TLB to apply new sparse state (release flushed).
             gvaspaceInvalidateTlb(pGVAS, pGpu, PTE_UPGRADE);
         }
         FOR_EACH_GPU_IN_MASK_UC_END
@@ -1622,10 +1619,10 @@ gvaspaceAlloc_IMPL
         {
             FOR_EACH_GPU_IN_MASK_UC(32, pSys, pGpu, pVAS->gpuMask)
             {
-                KernelBus  *pKernelBus = GPU_GET_KERNEL_BUS(pGpu);
                 MMU_WALK_USER_CTX userCtx = {0};
 
                 // Unsparsify the VA range.
+                userCtx.bDeferFlush = NV_TRUE;
                 gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
                 if (NULL == userCtx.pGpuState)
                 {
@@ -1639,10 +1636,7 @@ gvaspaceAlloc_IMPL
                               pMemBlock->begin, pMemBlock->end);
                 }
                 gvaspaceWalkUserCtxRelease(pGVAS, &userCtx);
-                // Invalidate TLB to apply new sparse state.
-                kbusFlush_HAL(pGpu, pKernelBus, BUS_FLUSH_VIDEO_MEMORY  |
-                                         BUS_FLUSH_SYSTEM_MEMORY |
-                                         BUS_FLUSH_USE_PCIE_READ);
+                // Invalidate TLB to apply new sparse state (release flushed).
                 gvaspaceInvalidateTlb(pGVAS, pGpu, PTE_UPGRADE);
             }
             FOR_EACH_GPU_IN_MASK_UC_END
@@ -2260,6 +2254,7 @@ gvaspaceMap_IMPL
     }
 
     // Call MMU walker to map.
+    userCtx.bDeferFlush = NV_TRUE;
     gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
 
     if (NULL == userCtx.pGpuState)
@@ -2306,6 +2301,7 @@ gvaspaceUnmap_IMPL
     status = _gvaspaceMappingRemove(pGVAS, pGpu, pVASBlock, vaLo, vaHi);
     NV_ASSERT_OR_RETURN_VOID(NV_OK == status);
 
+    userCtx.bDeferFlush = NV_TRUE;
     gvaspaceWalkUserCtxAcquire(pGVAS, pGpu, pVASBlock, &userCtx);
 
     if (NULL == userCtx.pGpuState)
@@ -3791,6 +3787,7 @@ gvaspaceWalkUserCtxAcquire_IMPL
 
     // If current context is non-NULL, a previous release was missed.
     NV_ASSERT(NULL == mmuWalkGetUserCtx(pUserCtx->pGpuState->pWalk));
+    NV_ASSERT(!pUserCtx->bFlushPending);
     NV_ASSERT_OK(mmuWalkSetUserCtx(pUserCtx->pGpuState->pWalk, pUserCtx));
 }
 
@@ -3806,6 +3803,39 @@ gvaspaceWalkUserCtxRelease_IMPL
     NV_ASSERT_OR_RETURN_VOID(pUserCtx->pGpuState->pWalk);
     NV_ASSERT(pUserCtx == mmuWalkGetUserCtx(pUserCtx->pGpuState->pWalk));
     NV_ASSERT_OK(mmuWalkSetUserCtx(pUserCtx->pGpuState->pWalk, NULL));
+
+    // Make the batched page table writes visible before the caller invalidates.
+    if (pUserCtx->bFlushPending)
+    {
+        kbusFlush_HAL(pUserCtx->pGpu, GPU_GET_KERNEL_BUS(pUserCtx->pGpu),
+                      BUS_FLUSH_VIDEO_MEMORY  |
+                      BUS_FLUSH_SYSTEM_MEMORY |
+                      BUS_FLUSH_USE_PCIE_READ);
+        pUserCtx->bFlushPending = NV_FALSE;
+    }
+}
+
+/*!
+ * @brief Transfer flags for a page table write made by a walker callback.
+ *
+ * Adds TRANSFER_FLAGS_DEFER_FLUSH when the context batches flushes and
+ * records that a flush is owed on release.
+ */
+NvU32
+gvaspaceWalkUserCtxTransferFlags
+(
+    MMU_WALK_USER_CTX *pUserCtx,
+    NvU32              flags
+)
+{
+    if (!pUserCtx->bDeferFlush)
+        return flags;
+
+    NV_ASSERT(pUserCtx->pGpuState != NULL &&
+              pUserCtx == mmuWalkGetUserCtx(pUserCtx->pGpuState->pWalk));
+
+    pUserCtx->bFlushPending = NV_TRUE;
+    return flags | TRANSFER_FLAGS_DEFER_FLUSH;
 }
 
 NV_STATUS
@@ -33,12 +33,25 @@
 #include "core/locks.h"
 #include "gpu/device/device.h"
 #include "gpu/subdevice/subdevice.h"
+#include "gpu_mgr/gpu_mgr.h"
+#include "rmapi/client.h"
 #include "vgpu/rpc.h"
 
 #include "class/cl0041.h" // NV04_MEMORY
 #include "class/cl003e.h" // NV01_MEMORY_SYSTEM
 #include "class/cl0071.h" // NV01_MEMORY_SYSTEM_OS_DESCRIPTOR
 
+//
+// Memory descriptor whose free was deferred by the bulk teardown of its
+// client, see memFlushDeferredFrees().
+//
+typedef struct MEM_DEFERRED_FREE
+{
+    MEMORY_DESCRIPTOR        *pMemDesc;
+    NvU32                     gpuInstance;
+    struct MEM_DEFERRED_FREE *pNext;
+} MEM_DEFERRED_FREE;
+
 NV_STATUS
 memConstruct_IMPL
 (
@@ -142,6 +155,115 @@ memGetMapAddrSpace_IMPL
     return NV_OK;
 }
 
+/*!
+ * Queue the memory descriptor of a memory object for release once its client
+ * is gone, if the client is being torn down in bulk.
+ */
+static NvBool
+_memDeferFree
+(
+    Memory *pMemory
+)
+{
+    RmClient          *pClient = dynamicCast(RES_GET_CLIENT(pMemory), RmClient);
+    MEM_DEFERRED_FREE *pEntry;
+
+    if ((pClient == NULL) || !pClient->bBulkFree || (pMemory->pGpu == NULL))
+        return NV_FALSE;
+
+    pEntry = portMemAllocNonPaged(sizeof(*pEntry));
+    if (pEntry == NULL)
+        return NV_FALSE;
+
+    pEntry->pMemDesc    = pMemory->pMemDesc;
+    pEntry->gpuInstance = pMemory->pGpu->gpuInstance;
+    pEntry->pNext       = pClient->pDeferredFreeList;
+    pClient->pDeferredFreeList = pEntry;
+
+    return NV_TRUE;
+}
+
+static void
+_memFreeDeferredList
+(
+    MEM_DEFERRED_FREE *pList,
+    NvBool             bFreeHead
+)
+{
+    MEM_DEFERRED_FREE *pEntry = pList;
+
+    while (pEntry != NULL)
+    {
+        MEM_DEFERRED_FREE *pNext = pEntry->pNext;
+
+        memdescFree(pEntry->pMemDesc);
+        memdescDestroy(pEntry->pMemDesc);
+
+        if (bFreeHead || (pEntry != pList))
+            portMemFree(pEntry);
+
+        pEntry = pNext;
+    }
+}
+
+static void
+_memDeferredFreeCallback
+(
+    NvU32 gpuInstance,
+    void *pArgs
+)
+{
+    // The work item owns the head of the list and frees it on return
+    _memFreeDeferredList(pArgs, NV_FALSE);
+}
+
+/*!
+ * Release the memory descriptors whose free was deferred while the client was
+ * torn down in bulk. One work item is queued per GPU so the releases, and any
+ * scrubbing they trigger, run outside of the API lock.
+ *
+ * @param[in] pClient  Client being destroyed
+ */
+void
+memFlushDeferredFrees_IMPL
+(
+    RmClient *pClient
+)
+{
+    while (pClient->pDeferredFreeList != NULL)
+    {
+        NvU32               gpuInstance = pClient->pDeferredFreeList->gpuInstance;
+        OBJGPU             *pGpu = gpumgrGetGpu(gpuInstance);
+        MEM_DEFERRED_FREE **ppEntry = &pClient->pDeferredFreeList;
+        MEM_DEFERRED_FREE  *pBatch = NULL;
+
+        // Move the entries of this GPU over, back in destruction order
+        while (*ppEntry != NULL)
+        {
+            MEM_DEFERRED_FREE *pEntry = *ppEntry;
+
+            if (pEntry->gpuInstance != gpuInstance)
+            {
+                ppEntry = &pEntry->pNext;
+                continue;
+            }
+
+            *ppEntry = pEntry->pNext;
+            pEntry->pNext = pBatch;
+            pBatch = pEntry;
+        }
+
+        if ((pGpu != NULL) &&
+            (GPU_GET_OS(pGpu)->osQueueWorkItemWithFlags(pGpu, _memDeferredFreeCallback, pBatch,
+                 OS_QUEUE_WORKITEM_FLAGS_LOCK_GPU_GROUP_DEVICE_RW) == NV_OK))
+        {
+            continue;
+        }
+
+        _memFreeDeferredList(pBatch, NV_TRUE);
+    }
+}
+
 void
 memDestruct_IMPL
 (
@@ -162,8 +284,11 @@ memDestruct_IMPL
     {
         // Remove the system memory reference from the client
         memDestructCommon(pMemory);
-        memdescFree(pMemory->pMemDesc);
-        memdescDestroy(pMemory->pMemDesc);
+        if (!_memDeferFree(pMemory))
+        {
+            memdescFree(pMemory->pMemDesc);
+            memdescDestroy(pMemory->pMemDesc);
+        }
     }
 
     // if the allocation is RPC-ed, free using RPC
@@ -185,6 +185,11 @@ osdescConstruct_IMPL
         memdescFree(pMemDesc);
         memdescDestroy(pMemDesc);
     }
+    else
+    {
+        osCompleteMemFromOsDescriptor(pMemDesc, pUserParams->descriptor,
+                                      pUserParams->descriptorType);
+    }
 
     return status;
 }
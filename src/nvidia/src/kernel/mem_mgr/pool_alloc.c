@@ -588,14 +588,6 @@ rmMemPoolAllocate
     portMemSet(pPageHandleList, 0, sizeof(*pPageHandleList));
     listInit(pPageHandleList, portMemAllocatorGetGlobalNonPaged());
 
-    portSyncMutexAcquire(pMemReserveInfo->pPoolLock);
-
-    poolGetListLength(pMemReserveInfo->pPool[topPool],
-                      &freeListLength, NULL, NULL);
-    NV_PRINTF(LEVEL_INFO,
-        "Total size of memory reserved for allocation = 0x%llx Bytes\n",
-        freeListLength * pMemReserveInfo->pmaChunkSize);
-
     //
     // The onus is on the caller to pass the correct size info after factoring
     // in any alignment requirements. The size after factoring in all alignment
@@ -625,11 +617,36 @@ rmMemPoolAllocate
 
         if (poolIndex < 0)
         {
-            status = NV_ERR_NO_MEMORY;
-            goto done;
+            listClear(pPageHandleList);
+            portMemFree(pPageHandleList);
+            return NV_ERR_NO_MEMORY;
         }
     }
 
+    //
+    // Allocate the PTE staging array before taking the pool lock so that
+    // the critical section only covers the pool operations themselves.
+    //
+    if ((numPages > 1) && !memdescGetContiguity(pMemDesc, AT_GPU))
+    {
+        pPhysicalAddresses = (NvU64*)portMemAllocNonPaged(sizeof(*pPhysicalAddresses) * numPages);
+        if (pPhysicalAddresses == NULL)
+        {
+            listClear(pPageHandleList);
+            portMemFree(pPageHandleList);
+            return NV_ERR_NO_MEMORY;
+        }
+        portMemSet(pPhysicalAddresses, 0, sizeof(*pPhysicalAddresses) * numPages);
+    }
+
+    portSyncMutexAcquire(pMemReserveInfo->pPoolLock);
+
+    poolGetListLength(pMemReserveInfo->pPool[topPool],
+                      &freeListLength, NULL, NULL);
+    NV_PRINTF(LEVEL_INFO,
+        "Total size of memory reserved for allocation = 0x%llx Bytes\n",
+        freeListLength * pMemReserveInfo->pmaChunkSize);
+
     //
     // If allocation request is greater than page size of top level pool then
     // allocate multiple pages from top-level pool
@@ -654,14 +671,6 @@ rmMemPoolAllocate
         }
         else
         {
-            pPhysicalAddresses = (NvU64*)portMemAllocNonPaged(sizeof(*pPhysicalAddresses) * numPages);
-            if (pPhysicalAddresses == NULL)
-            {
-                status = NV_ERR_NO_MEMORY;
-                goto done;
-            }
-            portMemSet(pPhysicalAddresses, 0, sizeof(*pPhysicalAddresses) * numPages);
-
             for (index = 0; index < numPages; index++)
             {
                 pPageHandle = listAppendNew(pPageHandleList);
@@ -685,8 +694,6 @@ rmMemPoolAllocate
                 pPageHandle = NULL;
             }
             memdescFillPages(pMemDesc, 0, pPhysicalAddresses, numPages, poolAllocSizes[topPool]);
-            portMemFree(pPhysicalAddresses);
-            pPhysicalAddresses = NULL;
         }
     }
     else
@@ -714,23 +721,23 @@ rmMemPoolAllocate
     rmMemPoolAddRef(pMemReserveInfo);
 
 done:
-    portMemFree(pPhysicalAddresses);
-
     if ((status != NV_OK) && (pPageHandleList != NULL))
     {
-        if (poolIndex >= 0)
+        PoolPageHandleListIter it = listIterAll(pPageHandleList);
+        while (listIterNext(&it))
         {
-            PoolPageHandleListIter it = listIterAll(pPageHandleList);
-            while (listIterNext(&it))
-            {
-                poolFree(pMemReserveInfo->pPool[poolIndex], it.pValue);
-            }
+            poolFree(pMemReserveInfo->pPool[poolIndex], it.pValue);
         }
+    }
+    portSyncMutexRelease(pMemReserveInfo->pPoolLock);
+
+    portMemFree(pPhysicalAddresses);
 
+    if ((status != NV_OK) && (pPageHandleList != NULL))
+    {
         listClear(pPageHandleList);
         portMemFree(pPageHandleList);
     }
-    portSyncMutexRelease(pMemReserveInfo->pPoolLock);
     return status;
 }
 
@@ -981,6 +988,24 @@ rmMemPoolSkipScrub
 }
 
 
+NvBool
+rmMemPoolIsIdle
+(
+    RM_POOL_ALLOC_MEM_RESERVE_INFO *pMemReserveInfo
+)
+{
+    NvBool bIdle;
+
+    NV_ASSERT_OR_RETURN(pMemReserveInfo != NULL, NV_FALSE);
+
+    portSyncMutexAcquire(pMemReserveInfo->pPoolLock);
+    bIdle = (rmMemPoolGetRef(pMemReserveInfo) == 0);
+    portSyncMutexRelease(pMemReserveInfo->pPoolLock);
+
+    return bIdle;
+}
+
+
 NV_STATUS
 rmMemPoolGetChunkAndPageSize
 (
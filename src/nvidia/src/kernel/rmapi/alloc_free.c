@@ -976,7 +976,8 @@ serverFreeResourceRpcUnderLock
     if ((status != NV_OK) ||
         (!IS_VIRTUAL(pGpu) && !IS_GSP_CLIENT(pGpu)) ||
         (pRmResource == NULL) ||
-        (pRmResource->bRpcFree == NV_FALSE))
+        (pRmResource->bRpcFree == NV_FALSE) ||
+        rmclientIsBulkFreedOnGpu(dynamicCast(pResourceRef->pClient, RmClient), pGpu->gpuInstance))
     {
         status = NV_OK;
         goto rpc_done;
@@ -991,6 +992,75 @@ rpc_done:
     return status;
 }
 
+//
+// Clients owning at least this many resources are torn down in bulk when the
+// whole client is freed.
+//
+#define RM_BULK_FREE_CLIENT_MIN_RESOURCES 64
+
+NV_STATUS
+serverBulkFreeClientUnderLock
+(
+    RsServer *pServer,
+    RsClient *pClient
+)
+{
+    RmClient   *pRmClient = dynamicCast(pClient, RmClient);
+    RS_ITERATOR it;
+
+    if ((pRmClient == NULL) ||
+        (mapCount(&pClient->resourceMap) < RM_BULK_FREE_CLIENT_MIN_RESOURCES))
+    {
+        return NV_OK;
+    }
+
+    // Memory frees issued by the teardown are deferred until the client is gone
+    pRmClient->bBulkFree = NV_TRUE;
+
+    it = clientRefIter(pClient, NULL, classId(Device), RS_ITERATE_CHILDREN, NV_TRUE);
+    while (clientRefIterNext(it.pClient, &it))
+    {
+        Device   *pDevice = dynamicCast(it.pResourceRef->pResource, Device);
+        OBJGPU   *pGpu;
+        NvU32     gpuMaskRelease = 0;
+        NV_STATUS status = NV_OK;
+
+        if (pDevice == NULL)
+            continue;
+
+        pGpu = GPU_RES_GET_GPU(pDevice);
+        if (!IS_GSP_CLIENT(pGpu) ||
+            rmclientIsBulkFreedOnGpu(pRmClient, pGpu->gpuInstance))
+        {
+            continue;
+        }
+
+        if (!rmDeviceGpuLockIsOwner(pGpu->gpuInstance))
+        {
+            status = rmGpuGroupLockAcquire(pGpu->gpuInstance,
+                                           GPU_LOCK_GRP_DEVICE,
+                                           GPUS_LOCK_FLAGS_NONE,
+                                           RM_LOCK_MODULES_CLIENT,
+                                           &gpuMaskRelease);
+            if (status != NV_OK)
+                continue;
+        }
+
+        //
+        // Freeing the client on GSP-RM releases everything it owns there in
+        // one RPC, so the per-object free RPCs of the teardown can be skipped.
+        //
+        NV_RM_RPC_FREE(pGpu, pClient->hClient, NV01_NULL_OBJECT, pClient->hClient, status);
+        if (status == NV_OK)
+            pRmClient->bulkFreeGpuMask |= NVBIT(pGpu->gpuInstance);
+
+        if (gpuMaskRelease != 0)
+            rmGpuGroupLockRelease(gpuMaskRelease, GPUS_LOCK_FLAGS_NONE);
+    }
+
+    return NV_OK;
+}
+
 void
 serverResLock_Epilogue
 (
@@ -1043,7 +1113,9 @@ serverUpdateLockFlagsForFree
     if (gpuGetByRef(pLockInfo->pContextRef, NULL, &pGpu) == NV_OK)
     {
         RmResource *pRmResource = dynamicCast(pRmFreeParams->pResourceRef->pResource, RmResource);
-        if (pGpu != NULL && IS_GSP_CLIENT(pGpu) && pRmResource != NULL && pRmResource->bRpcFree)
+        RmClient *pRmClient = dynamicCast(pRmFreeParams->pResourceRef->pClient, RmClient);
+        if (pGpu != NULL && IS_GSP_CLIENT(pGpu) && pRmResource != NULL && pRmResource->bRpcFree &&
+            !rmclientIsBulkFreedOnGpu(pRmClient, pGpu->gpuInstance))
         {
             //
             // If the resource desc says no need for GPU locks, we still need to lock
@@ -1459,6 +1531,158 @@ rmapiFreeWithSecInfoTls
     return status;
 }
 
+//
+// Common part of the batched alloc and free: copies the entry array in, takes
+// TLS, the RM semaphore and the API lock once, and copies the statuses out.
+//
+typedef NV_STATUS RMAPI_BATCH_ENTRY_FN(RM_API *pRmApi, NvHandle hClient, void *pEntry, API_SECURITY_INFO *pSecInfo);
+
+static NV_STATUS
+_rmapiProcessBatch
+(
+    NvHandle              hClient,
+    NvP64                 pUserEntries,
+    NvU32                 numEntries,
+    NvU32                 entrySize,
+    RMAPI_BATCH_ENTRY_FN *pEntryFn,
+    API_SECURITY_INFO    *pSecInfo
+)
+{
+    OBJSYS          *pSys = SYS_GET_INSTANCE();
+    RM_API          *pRmApi = rmapiGetInterface(RMAPI_API_LOCK_INTERNAL);
+    RM_API_CONTEXT   rmApiContext = {0};
+    THREAD_STATE_NODE threadState;
+    RMAPI_PARAM_COPY paramCopy;
+    NvU8            *pEntries = NULL;
+    NV_STATUS        status;
+    NV_STATUS        tmpStatus;
+    NvU32            i;
+
+    if ((numEntries == 0) || (numEntries > NVOS_BATCH_MAX_ENTRIES))
+        return NV_ERR_INVALID_ARGUMENT;
+
+    threadStateInit(&threadState, THREAD_STATE_FLAGS_NONE);
+
+    RMAPI_PARAM_COPY_INIT(paramCopy, pEntries, pUserEntries, numEntries, entrySize);
+    status = rmapiParamsAcquire(&paramCopy, (pSecInfo->paramLocation == PARAM_LOCATION_USER));
+    if (status != NV_OK)
+        goto done;
+
+    status = rmapiPrologue(rmapiGetInterface(RMAPI_EXTERNAL), &rmApiContext);
+    if (status != NV_OK)
+        goto release_params;
+
+    status = osAcquireRmSema(pSys->pSema);
+    if (status != NV_OK)
+        goto epilogue;
+
+    // LOCK: acquire API lock
+    status = rmapiLockAcquire(RMAPI_LOCK_FLAGS_NONE, RM_LOCK_MODULES_CLIENT);
+    if (status == NV_OK)
+    {
+        for (i = 0; i < numEntries; i++)
+        {
+            tmpStatus = pEntryFn(pRmApi, hClient, pEntries + (NvU64)i * entrySize, pSecInfo);
+            if ((tmpStatus != NV_OK) && (status == NV_OK))
+                status = tmpStatus;
+        }
+
+        // UNLOCK: release API lock
+        rmapiLockRelease();
+    }
+
+    osReleaseRmSema(pSys->pSema, NULL);
+
+epilogue:
+    rmapiEpilogue(rmapiGetInterface(RMAPI_EXTERNAL), &rmApiContext);
+
+release_params:
+    tmpStatus = rmapiParamsRelease(&paramCopy);
+    if (status == NV_OK)
+        status = tmpStatus;
+
+done:
+    threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
+
+    return status;
+}
+
+static NvBool
+_rmapiIsClientClass(NvU32 hClass)
+{
+    return (hClass == NV01_ROOT) || (hClass == NV01_ROOT_NON_PRIV) || (hClass == NV01_ROOT_CLIENT);
+}
+
+static NV_STATUS
+_rmapiAllocBatchEntry
+(
+    RM_API            *pRmApi,
+    NvHandle           hClient,
+    void              *pEntry,
+    API_SECURITY_INFO *pSecInfo
+)
+{
+    NVOS66_ALLOC_ENTRY *pAlloc = pEntry;
+
+    if (_rmapiIsClientClass(pAlloc->hClass))
+    {
+        pAlloc->status = NV_ERR_INVALID_CLASS;
+        return pAlloc->status;
+    }
+
+    pAlloc->status = pRmApi->AllocWithSecInfo(pRmApi, hClient, pAlloc->hObjectParent, &pAlloc->hObjectNew,
+                                              pAlloc->hClass, pAlloc->pAllocParms, pAlloc->paramsSize,
+                                              RMAPI_ALLOC_FLAGS_NONE, NvP64_NULL, pSecInfo);
+    return pAlloc->status;
+}
+
+static NV_STATUS
+_rmapiFreeBatchEntry
+(
+    RM_API            *pRmApi,
+    NvHandle           hClient,
+    void              *pEntry,
+    API_SECURITY_INFO *pSecInfo
+)
+{
+    NVOS67_FREE_ENTRY *pFree = pEntry;
+
+    if (pFree->hObjectOld == hClient)
+    {
+        pFree->status = NV_ERR_INVALID_OBJECT_HANDLE;
+        return pFree->status;
+    }
+
+    pFree->status = pRmApi->FreeWithSecInfo(pRmApi, hClient, pFree->hObjectOld, RMAPI_FREE_FLAGS_NONE, pSecInfo);
+    return pFree->status;
+}
+
+NV_STATUS
+rmapiAllocBatchWithSecInfo
+(
+    NvHandle           hClient,
+    NvP64              pEntries,
+    NvU32              numEntries,
+    API_SECURITY_INFO *pSecInfo
+)
+{
+    return _rmapiProcessBatch(hClient, pEntries, numEntries, sizeof(NVOS66_ALLOC_ENTRY),
+                              _rmapiAllocBatchEntry, pSecInfo);
+}
+
+NV_STATUS
+rmapiFreeBatchWithSecInfo
+(
+    NvHandle           hClient,
+    NvP64              pEntries,
+    NvU32              numEntries,
+    API_SECURITY_INFO *pSecInfo
+)
+{
+    return _rmapiProcessBatch(hClient, pEntries, numEntries, sizeof(NVOS67_FREE_ENTRY),
+                              _rmapiFreeBatchEntry, pSecInfo);
+}
+
 NV_STATUS
 rmapiDisableClients
 (
@@ -31,6 +31,7 @@
 #include "core/locks.h"
 #include "core/system.h"
 #include "gpu/device/device.h"
+#include "mem_mgr/mem.h"
 #include "resource_desc.h"
 #include "gpu_mgr/gpu_mgr.h"
 #include "gpu/gpu.h"
@@ -261,6 +262,9 @@ rmclientDestruct_IMPL
         it = clientRefIter(pRsClient, NULL, classId(Device), RS_ITERATE_CHILDREN, NV_TRUE);
     }
 
+    // Release the memory whose free was deferred by a bulk teardown
+    memFlushDeferredFrees(pClient);
+
     // Updating the client list just before client handle unregister //
     // in case child free functions need to iterate over all clients //
     if (!rmGpuLockIsOwner())
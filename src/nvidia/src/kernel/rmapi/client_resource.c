@@ -1942,6 +1942,52 @@ cliresCtrlCmdGpuAcctGetAccountingPids_IMPL
     return gpuacctGetAcctPids(pGpuAcct, pAcctPidsParams);
 }
 
+NV_STATUS
+cliresCtrlCmdGpuAcctGetChangedProcs_IMPL
+(
+    RmClientResource *pRmCliRes,
+    NV0000_CTRL_GPUACCT_GET_CHANGED_PROCS_PARAMS *pParams
+)
+{
+    OBJSYS         *pSys = SYS_GET_INSTANCE();
+    GpuAccounting  *pGpuAcct = SYS_GET_GPUACCT(pSys);
+    OBJGPU         *pGpu;
+    CALL_CONTEXT   *pCallContext;
+    RmCtrlParams   *pRmCtrlParams;
+    NV_STATUS       status = NV_OK;
+
+    LOCK_ASSERT_AND_RETURN(rmapiLockIsOwner());
+
+    pGpu = gpumgrGetGpuFromId(pParams->gpuId);
+    if (pGpu == NULL)
+    {
+        return NV_ERR_INVALID_ARGUMENT;
+    }
+
+    // The host only forwards the legacy accounting controls to guests.
+    if (IS_VIRTUAL(pGpu))
+    {
+        return NV_ERR_NOT_SUPPORTED;
+    }
+    else if (IS_GSP_CLIENT(pGpu) && IS_VGPU_GSP_PLUGIN_OFFLOAD_ENABLED(pGpu) &&
+             (pParams->pid != 0))
+    {
+        pCallContext  = resservGetTlsCallContext();
+        pRmCtrlParams = pCallContext->pControlParams;
+
+        NV_RM_RPC_CONTROL(pGpu,
+                          pRmCtrlParams->hClient,
+                          pRmCtrlParams->hObject,
+                          pRmCtrlParams->cmd,
+                          pRmCtrlParams->pParams,
+                          pRmCtrlParams->paramsSize,
+                          status);
+        return status;
+    }
+
+    return gpuacctGetChangedProcs(pGpuAcct, pParams);
+}
+
 
 NV_STATUS
 cliresCtrlCmdSystemPfmreqhndlrControl_IMPL
@@ -400,6 +400,8 @@ _rmapiRmControl(NvHandle hClient, NvHandle hObject, NvU32 cmd, NvP64 pUserParams
     NvU32 ctrlFlags = 0;
     NvU32 ctrlAccessRight = 0;
     NV_STATUS getCtrlInfoStatus;
+    RMAPI_CONTROL_STATS_SAMPLE statsSample;
+    NvBool bStatsSampled = NV_FALSE;
 
     RMTRACE_RMAPI(_RMCTRL_ENTRY, cmd);
 
@@ -429,6 +431,10 @@ _rmapiRmControl(NvHandle hClient, NvHandle hObject, NvU32 cmd, NvP64 pUserParams
     // is this a lock bypass cmd?
     bIsLockBypassCmd = ((flags & NVOS54_FLAGS_LOCK_BYPASS) || pRmApi->bGpuLockInternal);
 
+    // Only top-level controls at normal IRQL are timed
+    if (!bInternalRequest && !bIsRaisedIrqlCmd)
+        bStatsSampled = rmapiControlStatsSampleBegin(&statsSample);
+
     // NVOS54_FLAGS_IRQL_RAISED cmds are only allowed to be called in raised irq level.
     if (bIsRaisedIrqlCmd)
     {
@@ -627,6 +633,8 @@ _rmapiRmControl(NvHandle hClient, NvHandle hObject, NvU32 cmd, NvP64 pUserParams
         rmapiEpilogue(pRmApi, &rmApiContext);
     }
 done:
+    if (bStatsSampled)
+        rmapiControlStatsSampleEnd(&statsSample, cmd);
 
     RMTRACE_RMAPI(_RMCTRL_EXIT, cmd);
     return rmStatus;
@@ -895,6 +903,22 @@ serverControlLookupLockFlags
         return NV_OK;
     }
 
+    //
+    // Read-only controls only look at the state of their client, so when
+    // enabled they share the client lock with each other. Everything else
+    // keeps exclusive access to the client.
+    //
+    if (lock == RS_LOCK_CLIENT)
+    {
+        if (serverSupportsReadOnlyLock(&g_resServ, RS_LOCK_CLIENT, RS_API_CTRL) &&
+            (controlFlags & RMCTRL_FLAGS_API_LOCK_READONLY))
+        {
+            *pAccess = LOCK_ACCESS_READ;
+        }
+
+        return NV_OK;
+    }
+
     if (lock == RS_LOCK_RESOURCE)
     {
         RS_LOCK_INFO *pLockInfo = pRmCtrlParams->pLockInfo;
@@ -68,6 +68,8 @@ static void _nv04MapMemoryDmaWithSecInfo(NVOS46_PARAMETERS*, API_SECURITY_INFO);
 static void _nv04UnmapMemoryDmaWithSecInfo(NVOS47_PARAMETERS*, API_SECURITY_INFO);
 static void _nv04DupObjectWithSecInfo(NVOS55_PARAMETERS*, API_SECURITY_INFO);
 static void _nv04ShareWithSecInfo(NVOS57_PARAMETERS*, API_SECURITY_INFO);
+static void _nv04AllocBatchWithSecInfo(NVOS66_PARAMETERS*, API_SECURITY_INFO);
+static void _nv01FreeBatchWithSecInfo(NVOS67_PARAMETERS*, API_SECURITY_INFO);
 
 
 //
@@ -170,6 +172,8 @@ void Nv04MapMemoryDmaWithSecInfo(NVOS46_PARAMETERS *pArgs, API_SECURITY_INFO sec
 void Nv04UnmapMemoryDmaWithSecInfo(NVOS47_PARAMETERS *pArgs, API_SECURITY_INFO secInfo)      { _nv04UnmapMemoryDmaWithSecInfo(pArgs, secInfo); }
 void Nv04DupObjectWithSecInfo(NVOS55_PARAMETERS *pArgs, API_SECURITY_INFO secInfo)           { _nv04DupObjectWithSecInfo(pArgs, secInfo); }
 void Nv04ShareWithSecInfo(NVOS57_PARAMETERS *pArgs, API_SECURITY_INFO secInfo)               { _nv04ShareWithSecInfo(pArgs, secInfo); }
+void Nv04AllocBatchWithSecInfo(NVOS66_PARAMETERS *pArgs, API_SECURITY_INFO secInfo)          { _nv04AllocBatchWithSecInfo(pArgs, secInfo); }
+void Nv01FreeBatchWithSecInfo(NVOS67_PARAMETERS *pArgs, API_SECURITY_INFO secInfo)           { _nv01FreeBatchWithSecInfo(pArgs, secInfo); }
 
 
 static void
@@ -337,6 +341,42 @@ static void _nv01FreeWithSecInfo
     pArgs->status = pRmApi->FreeWithSecInfo(pRmApi, pArgs->hRoot, pArgs->hObjectOld, RMAPI_FREE_FLAGS_NONE, &secInfo);
 } // end of Nv01FreeWithSecInfo()
 
+/*
+NV04_ALLOC_BATCH
+    NVOS66_PARAMETERS:
+        NvHandle hRoot;
+        NvU32    numEntries;
+        NvP64    pEntries;
+        NvV32    status;
+*/
+
+static void _nv04AllocBatchWithSecInfo
+(
+    NVOS66_PARAMETERS *pArgs,
+    API_SECURITY_INFO  secInfo
+)
+{
+    pArgs->status = rmapiAllocBatchWithSecInfo(pArgs->hRoot, pArgs->pEntries, pArgs->numEntries, &secInfo);
+} // end of _nv04AllocBatchWithSecInfo()
+
+/*
+NV01_FREE_BATCH
+    NVOS67_PARAMETERS:
+        NvHandle hRoot;
+        NvU32    numEntries;
+        NvP64    pEntries;
+        NvV32    status;
+*/
+
+static void _nv01FreeBatchWithSecInfo
+(
+    NVOS67_PARAMETERS *pArgs,
+    API_SECURITY_INFO  secInfo
+)
+{
+    pArgs->status = rmapiFreeBatchWithSecInfo(pArgs->hRoot, pArgs->pEntries, pArgs->numEntries, &secInfo);
+} // end of _nv01FreeBatchWithSecInfo()
+
 /*
 NV04_MAP_MEMORY
     NVOS33_PARAMETERS:
@@ -916,6 +916,13 @@ serverMap_Prologue
                       ? hSubDevice
                       : pMapParams->hDevice;
 
+    //
+    // Repeated requests to map the same range of a memory object with the same
+    // flags from the same process share one mapping, refcounted by resserv.
+    //
+    pMapParams->processId = osGetCurrentProcess();
+    pMapParams->bShareable = (dynamicCast(pMemoryRef->pResource, Memory) != NULL);
+
 
     // convert from OS33 flags to RM's memory protection flags
     switch (DRF_VAL(OS33, _FLAGS, _ACCESS, flags))
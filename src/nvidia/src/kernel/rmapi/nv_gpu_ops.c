@@ -72,6 +72,7 @@
 #include <class/clc6c0.h>
 #include <class/clc7b5.h>
 #include <class/clc7c0.h>
+#include <class/clc763.h> // MMU_VIDMEM_ACCESS_BIT_BUFFER
 #include <class/clcb33.h> // NV_CONFIDENTIAL_COMPUTE
 #include <class/clc661.h> // HOPPER_USERMODE_A
 #include <class/clc8b5.h> // HOPPER_DMA_COPY_A
@@ -94,6 +95,7 @@
 #include <ctrl/ctrlc365.h>
 #include <ctrl/ctrlc369.h>
 #include <ctrl/ctrlc36f.h>
+#include <ctrl/ctrlc763.h>
 #include <ctrl/ctrlcb33.h>
 
 #include <ampere/ga100/dev_runlist.h>
@@ -7679,6 +7681,135 @@ NV_STATUS nvGpuOpsDestroyAccessCntrInfo(struct gpuDevice *device,
     return NV_OK;
 }
 
+// Access bits reported by each range checker in a vidmem access bit dump
+#define GPU_OPS_ACCESS_BITS_PER_CHECKER \
+    (UVM_ACCESS_BITS_MAX_BITS / NV_VIDMEM_ACCESS_BIT_BUFFER_NUM_CHECKERS)
+
+ct_assert(sizeof(((NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DUMP_PARAMS *)0)->accessBits) * 8 ==
+          UVM_ACCESS_BITS_MAX_BITS);
+
+NV_STATUS nvGpuOpsAccessBitsBufAlloc(struct gpuDevice *device,
+                                     NvU64 fbSize,
+                                     gpuAccessBitsBufferAlloc *pAccessBitsInfo)
+{
+    struct gpuSession *session = device->session;
+    RM_API *pRmApi = rmapiGetInterface(RMAPI_EXTERNAL_KERNEL);
+    NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_ENABLE_LOGGING_PARAMS enableParams = {0};
+    NvU32 granularity;
+    NvU64 bytesPerBit;
+    NvU32 i;
+    NV_STATUS status;
+
+    if (fbSize == 0)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    // Pick the smallest granularity at which all the bits cover the FB
+    for (granularity = NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_GRANULARITY_64KB;
+         granularity < NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_GRANULARITY_2GB;
+         granularity++)
+    {
+        if ((NvU64)UVM_ACCESS_BITS_MAX_BITS * ((NvU64)RM_PAGE_SIZE_64K << granularity) >= fbSize)
+            break;
+    }
+    bytesPerBit = (NvU64)RM_PAGE_SIZE_64K << granularity;
+
+    // The range checkers are laid out back to back from the start of the FB
+    for (i = 0; i < NV_VIDMEM_ACCESS_BIT_BUFFER_NUM_CHECKERS; i++)
+    {
+        enableParams.granularity[i]  = granularity;
+        enableParams.startAddress[i] = i * GPU_OPS_ACCESS_BITS_PER_CHECKER * bytesPerBit;
+    }
+    enableParams.rangeCount  = NV_VIDMEM_ACCESS_BIT_BUFFER_NUM_CHECKERS;
+    enableParams.trackMode   = NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_TRACK_MODE_ACCESS;
+    enableParams.disableMode = NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DISABLE_MODE_SET;
+    enableParams.mmuType     = NV_VIDMEM_ACCESS_BIT_BUFFER_DEFAULT;
+
+    pAccessBitsInfo->accessBitsBufferHandle = NV01_NULL_OBJECT;
+    status = pRmApi->Alloc(pRmApi,
+                           session->handle,
+                           device->subhandle,
+                           &pAccessBitsInfo->accessBitsBufferHandle,
+                           MMU_VIDMEM_ACCESS_BIT_BUFFER,
+                           NULL,
+                           0);
+    if (status != NV_OK)
+        goto cleanup;
+
+    status = pRmApi->Control(pRmApi,
+                             session->handle,
+                             pAccessBitsInfo->accessBitsBufferHandle,
+                             NVC763_CTRL_CMD_VIDMEM_ACCESS_BIT_ENABLE_LOGGING,
+                             &enableParams,
+                             sizeof(enableParams));
+    if (status != NV_OK)
+        goto cleanup_buffer;
+
+    pAccessBitsInfo->granularity = bytesPerBit;
+    pAccessBitsInfo->numBits = (NvU32)NV_MIN((NvU64)UVM_ACCESS_BITS_MAX_BITS,
+                                             NV_DIV_AND_CEIL(fbSize, bytesPerBit));
+
+    return NV_OK;
+
+cleanup_buffer:
+    pRmApi->Free(pRmApi, session->handle, pAccessBitsInfo->accessBitsBufferHandle);
+cleanup:
+    portMemSet(pAccessBitsInfo, 0, sizeof(*pAccessBitsInfo));
+    return status;
+}
+
+NV_STATUS nvGpuOpsAccessBitsBufFree(struct gpuDevice *device,
+                                    gpuAccessBitsBufferAlloc *pAccessBitsInfo)
+{
+    struct gpuSession *session = device->session;
+    RM_API *pRmApi = rmapiGetInterface(RMAPI_EXTERNAL_KERNEL);
+
+    if (pAccessBitsInfo->accessBitsBufferHandle == NV01_NULL_OBJECT)
+        return NV_OK;
+
+    NV_ASSERT_OK(pRmApi->Control(pRmApi,
+                                 session->handle,
+                                 pAccessBitsInfo->accessBitsBufferHandle,
+                                 NVC763_CTRL_CMD_VIDMEM_ACCESS_BIT_DISABLE_LOGGING,
+                                 NULL,
+                                 0));
+
+    pRmApi->Free(pRmApi, session->handle, pAccessBitsInfo->accessBitsBufferHandle);
+    portMemSet(pAccessBitsInfo, 0, sizeof(*pAccessBitsInfo));
+    return NV_OK;
+}
+
+NV_STATUS nvGpuOpsAccessBitsDump(struct gpuDevice *device,
+                                 gpuAccessBitsBufferAlloc *pAccessBitsInfo,
+                                 NvU64 *pAccessBits)
+{
+    RM_API *pRmApi = rmapiGetInterface(RMAPI_EXTERNAL_KERNEL);
+    NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_DUMP_PARAMS *pParams;
+    NV_STATUS status;
+
+    if (pAccessBitsInfo->accessBitsBufferHandle == NV01_NULL_OBJECT || pAccessBits == NULL)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    pParams = portMemAllocNonPaged(sizeof(*pParams));
+    if (pParams == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    portMemSet(pParams, 0, sizeof(*pParams));
+    pParams->bMetadata = NV_FALSE;
+    pParams->op_enum   = NVC763_CTRL_VIDMEM_ACCESS_BIT_BUFFER_OP_CURRENT;
+
+    status = pRmApi->Control(pRmApi,
+                             device->session->handle,
+                             pAccessBitsInfo->accessBitsBufferHandle,
+                             NVC763_CTRL_CMD_VIDMEM_ACCESS_BIT_DUMP,
+                             pParams,
+                             sizeof(*pParams));
+    if (status == NV_OK)
+        portMemCopy(pAccessBits, sizeof(pParams->accessBits), pParams->accessBits, sizeof(pParams->accessBits));
+
+    portMemFree(pParams);
+    return status;
+}
+
 NV_STATUS nvGpuOpsDestroyFaultInfo(struct gpuDevice *device,
                                    gpuFaultInfo *pFaultInfo)
 {
@@ -7876,12 +8007,13 @@ NV_STATUS nvGpuOpsGetNonReplayableFaults(gpuFaultInfo *pFaultInfo,
         if (pQueue == NULL)
             return NV_ERR_INVALID_ARGUMENT;
 
-        // Copy all faults in the client shadow fault buffer to the given buffer
-        while (queuePopAndCopyNonManaged(pQueue, pQueueCtx, faultBuffer))
-        {
-            ++(*numFaults);
-            faultBuffer = (char *)faultBuffer + NVC369_BUF_SIZE;
-        }
+        //
+        // Copy all faults in the client shadow fault buffer to the given
+        // buffer, in at most two bulk copies and a single GET update.
+        //
+        *numFaults = (NvU32)queuePopAndCopyBatchNonManaged(pQueue, pQueueCtx, faultBuffer,
+                                                           pFaultInfo->nonReplayable.bufferSize /
+                                                           NVC369_BUF_SIZE);
     }
 
     return status;
@@ -8873,22 +9005,18 @@ static void _nvGpuOpsReleaseChannelResources(gpuRetainedChannel *retainedChannel
     }
 }
 
-NV_STATUS nvGpuOpsGetChannelResourcePtes(struct gpuAddressSpace *vaSpace,
-                                         NvP64 resourceDescriptor,
-                                         NvU64 offset,
-                                         NvU64 size,
-                                         gpuExternalMappingInfo *pGpuExternalMappingInfo)
+// Build the PTEs of one channel resource. The caller must hold the locks
+// acquired by _nvGpuOpsLocksAcquireAll.
+static NV_STATUS _nvGpuOpsBuildChannelResourcePtes(OBJVASPACE *pVAS,
+                                                   OBJGPU *pMappingGpu,
+                                                   NvP64 resourceDescriptor,
+                                                   NvU64 offset,
+                                                   NvU64 size,
+                                                   gpuExternalMappingInfo *pGpuExternalMappingInfo)
 {
-    NV_STATUS status = NV_OK;
-    nvGpuOpsLockSet acquiredLocks;
-    THREAD_STATE_NODE threadState;
-    PMEMORY_DESCRIPTOR pMemDesc = NULL;
-    OBJGPU *pMappingGpu = NULL;
-    OBJVASPACE *pVAS = NULL;
-    RsClient *pClient = NULL;
-    Subdevice *pSubDevice;
+    PMEMORY_DESCRIPTOR pMemDesc;
 
-    if (!vaSpace || !resourceDescriptor || !pGpuExternalMappingInfo)
+    if (!resourceDescriptor || !pGpuExternalMappingInfo)
         return NV_ERR_INVALID_ARGUMENT;
 
     if (pGpuExternalMappingInfo->mappingPageSize != 0)
@@ -8896,6 +9024,37 @@ NV_STATUS nvGpuOpsGetChannelResourcePtes(struct gpuAddressSpace *vaSpace,
         return NV_ERR_NOT_SUPPORTED;
     }
 
+    pMemDesc = (MEMORY_DESCRIPTOR *) NvP64_VALUE(resourceDescriptor);
+
+    if (pMemDesc->pGpu != pMappingGpu)
+        return NV_ERR_NOT_SUPPORTED;
+
+    // Do not support mapping on anything other than sysmem/vidmem!
+    if ((memdescGetAddressSpace(pMemDesc) != ADDR_SYSMEM) &&
+        (memdescGetAddressSpace(pMemDesc) != ADDR_FBMEM))
+        return NV_ERR_NOT_SUPPORTED;
+
+    return nvGpuOpsBuildExternalAllocPtes(pVAS, pMappingGpu, pMemDesc, NULL,
+                                          offset, size, NV_FALSE, NV_FALSE,
+                                          0, pGpuExternalMappingInfo);
+}
+
+static NV_STATUS _nvGpuOpsGetChannelResourcesPtes(struct gpuAddressSpace *vaSpace,
+                                                  NvU32 resourceCount,
+                                                  const NvP64 *resourceDescriptors,
+                                                  const NvU64 *offsets,
+                                                  const NvU64 *sizes,
+                                                  gpuExternalMappingInfo *pGpuExternalMappingInfos)
+{
+    NV_STATUS status = NV_OK;
+    nvGpuOpsLockSet acquiredLocks;
+    THREAD_STATE_NODE threadState;
+    OBJGPU *pMappingGpu = NULL;
+    OBJVASPACE *pVAS = NULL;
+    RsClient *pClient = NULL;
+    Subdevice *pSubDevice;
+    NvU32 i;
+
     threadStateInit(&threadState, THREAD_STATE_FLAGS_NONE);
     status = _nvGpuOpsLocksAcquireAll(RMAPI_LOCK_FLAGS_READ,
                                       vaSpace->device->session->handle,
@@ -8907,56 +9066,68 @@ NV_STATUS nvGpuOpsGetChannelResourcePtes(struct gpuAddressSpace *vaSpace,
         return status;
     }
 
-    pMemDesc = (MEMORY_DESCRIPTOR *) NvP64_VALUE(resourceDescriptor);
-
     status = subdeviceGetByHandle(pClient, vaSpace->device->subhandle, &pSubDevice);
     if (status != NV_OK)
-    {
-        _nvGpuOpsLocksRelease(&acquiredLocks);
-        threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
-        return status;
-    }
+        goto done;
 
     pMappingGpu = GPU_RES_GET_GPU(pSubDevice);
 
     GPU_RES_SET_THREAD_BC_STATE(pSubDevice);
 
-    if (pMemDesc->pGpu != pMappingGpu)
-    {
-        _nvGpuOpsLocksRelease(&acquiredLocks);
-        threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
-        return NV_ERR_NOT_SUPPORTED;
-    }
-
-    // Do not support mapping on anything other than sysmem/vidmem!
-    if ((memdescGetAddressSpace(pMemDesc) != ADDR_SYSMEM) &&
-        (memdescGetAddressSpace(pMemDesc) != ADDR_FBMEM))
-    {
-        _nvGpuOpsLocksRelease(&acquiredLocks);
-        threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
-        return NV_ERR_NOT_SUPPORTED;
-    }
-
     status = vaspaceGetByHandleOrDeviceDefault(pClient,
                                                vaSpace->device->handle,
                                                vaSpace->handle,
                                                &pVAS);
     if (status != NV_OK)
+        goto done;
+
+    for (i = 0; i < resourceCount; i++)
     {
-        _nvGpuOpsLocksRelease(&acquiredLocks);
-        threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
-        return status;
+        status = _nvGpuOpsBuildChannelResourcePtes(pVAS,
+                                                   pMappingGpu,
+                                                   resourceDescriptors[i],
+                                                   offsets ? offsets[i] : 0,
+                                                   sizes[i],
+                                                   &pGpuExternalMappingInfos[i]);
+        if (status != NV_OK)
+            break;
     }
 
-    status = nvGpuOpsBuildExternalAllocPtes(pVAS, pMappingGpu, pMemDesc, NULL,
-                                            offset, size, NV_FALSE, NV_FALSE,
-                                            0, pGpuExternalMappingInfo);
-
+done:
     _nvGpuOpsLocksRelease(&acquiredLocks);
     threadStateFree(&threadState, THREAD_STATE_FLAGS_NONE);
     return status;
 }
 
+NV_STATUS nvGpuOpsGetChannelResourcePtes(struct gpuAddressSpace *vaSpace,
+                                         NvP64 resourceDescriptor,
+                                         NvU64 offset,
+                                         NvU64 size,
+                                         gpuExternalMappingInfo *pGpuExternalMappingInfo)
+{
+    if (!vaSpace || !resourceDescriptor || !pGpuExternalMappingInfo)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    return _nvGpuOpsGetChannelResourcesPtes(vaSpace, 1, &resourceDescriptor, &offset, &size,
+                                            pGpuExternalMappingInfo);
+}
+
+NV_STATUS nvGpuOpsGetChannelResourcesPtes(struct gpuAddressSpace *vaSpace,
+                                          NvU32 resourceCount,
+                                          const NvP64 *resourceDescriptors,
+                                          const NvU64 *sizes,
+                                          gpuExternalMappingInfo *pGpuExternalMappingInfos)
+{
+    if (!vaSpace || !resourceDescriptors || !sizes || !pGpuExternalMappingInfos)
+        return NV_ERR_INVALID_ARGUMENT;
+
+    if (resourceCount == 0)
+        return NV_OK;
+
+    return _nvGpuOpsGetChannelResourcesPtes(vaSpace, resourceCount, resourceDescriptors, NULL, sizes,
+                                            pGpuExternalMappingInfos);
+}
+
 NV_STATUS nvGpuOpsBindChannelResources(gpuRetainedChannel *retainedChannel,
                                        gpuChannelResourceBindParams *channelResourceBindParams)
 {
@@ -46,6 +46,7 @@ typedef struct
     NvU64               tlsEntryId;
     volatile NvU32      contentionCount;
     NvU32               lowPriorityAging;
+    NvU64               meterAcquireTs;
 } RMAPI_LOCK;
 
 RsServer          g_resServ;
@@ -87,6 +88,8 @@ rmapiInitialize
         goto failed_free_lock;
     }
 
+    rmapiControlStatsInit();
+
     RsResInfoInitialize();
     status = serverConstruct(&g_resServ, RS_PRIV_LEVEL_HOST, 0);
 
@@ -118,6 +121,7 @@ rmapiInitialize
     return NV_OK;
 
 failed_free_cache:
+        rmapiControlStatsFree();
         rmapiControlCacheFree();
 failed_free_lock:
         _rmapiLockFree();
@@ -138,6 +142,7 @@ rmapiShutdown
     serverDestruct(&g_resServ);
     _rmapiLockFree();
 
+    rmapiControlStatsFree();
     rmapiControlCacheFree();
 
     g_bResServInit = NV_FALSE;
@@ -402,7 +407,8 @@ rmapiInitLockInfo
             }
             else
             {
-                pLockInfo->state &= ~RM_LOCK_STATES_CLIENT_LOCK_ACQUIRED;
+                pLockInfo->state &= ~(RM_LOCK_STATES_CLIENT_LOCK_ACQUIRED |
+                                      RS_LOCK_STATE_CLIENT_LOCK_READ);
             }
         }
     }
@@ -517,6 +523,9 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
     }
     else
     {
+        NvU64 statsWaitStart = rmapiControlStatsWaitBegin();
+        NvU64 meterWaitStart = rmLockMeterTimestamp();
+
         if ((flags & RMAPI_LOCK_FLAGS_READ))
         {
             portSyncRwLockAcquireRead(g_RmApiLock.pLock);
@@ -543,6 +552,9 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
             }
             g_RmApiLock.threadId = threadId;
         }
+
+        rmLockMeterRecordWait(RM_LOCK_METER_API_LOCK, meterWaitStart);
+        rmapiControlStatsWaitEnd(RMAPI_CONTROL_STATS_PHASE_LOCK, statsWaitStart);
     }
 
 
@@ -552,7 +564,10 @@ rmapiLockAcquire(NvU32 flags, NvU32 module)
         osGetCurrentTick(&timestamp);
 
         if (g_RmApiLock.threadId == threadId)
+        {
             g_RmApiLock.timestamp = timestamp;
+            g_RmApiLock.meterAcquireTs = rmLockMeterTimestamp();
+        }
 
         // save off owning thread
         RMTRACE_RMLOCK(_API_LOCK_ACQUIRE);
@@ -613,6 +628,14 @@ rmapiLockRelease(void)
         // If the threadId in the global is same as current thread id, then
         // we know that it was acquired in WRITE mode.
         //
+        if (g_RmApiLock.meterAcquireTs != 0)
+        {
+            rmLockMeterRecordHold(RM_LOCK_METER_API_LOCK,
+                                  (NvUPtr)NvP64_VALUE(tlsEntryGet(g_RmApiLock.tlsEntryId)),
+                                  g_RmApiLock.meterAcquireTs);
+            g_RmApiLock.meterAcquireTs = 0;
+        }
+
         g_RmApiLock.threadId  = ~0ull;
         g_RmApiLock.timestamp = timestamp;
         portSyncRwLockReleaseWrite(g_RmApiLock.pLock);
@@ -1048,6 +1048,51 @@ void rmapiControlCacheFreeAllCacheForGpu
     _cacheLockRelease(LOCK_EXCLUSIVE);
 }
 
+//
+// Cacheable controls whose output depends on state that can change at runtime,
+// with the events (RMAPI_CONTROL_CACHE_INVALIDATE_*) that change it.
+//
+static const struct
+{
+    NvU32 cmd;
+    NvU32 eventMask;
+} _invalidateOnEvent[] =
+{
+    { NV2080_CTRL_CMD_GPU_GET_INFO_V2,  RMAPI_CONTROL_CACHE_INVALIDATE_MIG_CONFIG },
+    { NV2080_CTRL_CMD_FIFO_GET_INFO,    RMAPI_CONTROL_CACHE_INVALIDATE_MIG_CONFIG },
+};
+
+void rmapiControlCacheInvalidate
+(
+    NvU32 gpuInst,
+    NvU32 eventMask
+)
+{
+    NvU32 i;
+
+    _cacheLockAcquire(LOCK_EXCLUSIVE);
+
+    for (i = 0; i < NV_ARRAY_ELEMENTS(_invalidateOnEvent); i++)
+    {
+        RmapiControlCacheEntry *entry;
+
+        if ((_invalidateOnEvent[i].eventMask & eventMask) == 0)
+            continue;
+
+        entry = multimapFindItem(&RmapiControlCache.gpusControlCache, gpuInst,
+                                 _invalidateOnEvent[i].cmd);
+        if (entry != NULL)
+        {
+            portMemFree(entry->params);
+            multimapRemoveItem(&RmapiControlCache.gpusControlCache, entry);
+            NV_PRINTF(LEVEL_INFO, "cached control 0x%x for gpu inst 0x%x invalidated\n",
+                      _invalidateOnEvent[i].cmd, gpuInst);
+        }
+    }
+
+    _cacheLockRelease(LOCK_EXCLUSIVE);
+}
+
 void rmapiControlCacheFreeClientEntry(NvHandle hClient)
 {
     _cacheLockAcquire(LOCK_EXCLUSIVE);
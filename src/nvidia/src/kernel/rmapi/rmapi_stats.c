@@ -0,0 +1,281 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+//
+// Sampled latency histograms for RM controls.
+//
+// With NV_REG_STR_RM_CONTROL_LATENCY_SAMPLE_RATE set to N, one in N external
+// controls is timed. The time of a sampled control is split into the time
+// spent blocked on the API and GPU locks, the time spent waiting for GSP to
+// answer control RPCs, and the remainder, which is counted as local
+// execution. Each part goes into a log2 (nanosecond) histogram kept per
+// control command. The histograms are printed when RM API is shut down.
+//
+// Lock and RPC waits are attributed to the sample through a TLS entry that
+// points at the sample on the control's stack, so nested internal controls
+// issued while handling a sampled control are charged to it.
+//
+
+#include "nvport/nvport.h"
+#include "nvrm_registry.h"
+#include "os/os.h"
+#include "rmapi/rmapi.h"
+#include "tls/tls.h"
+
+// Must be a power of 2
+#define RMAPI_CONTROL_STATS_NUM_SLOTS       256
+#define RMAPI_CONTROL_STATS_NUM_BUCKETS     32
+
+typedef struct
+{
+    // Control command owning the slot, 0 if the slot is free
+    volatile NvU32 cmd;
+    volatile NvU32 count;
+    volatile NvU64 totalNs;
+    volatile NvU32 buckets[RMAPI_CONTROL_STATS_PHASE_COUNT][RMAPI_CONTROL_STATS_NUM_BUCKETS];
+} RmapiControlStatsSlot;
+
+static struct {
+    NvU32 sampleRate;
+    volatile NvU32 sampleCounter;
+    volatile NvU32 droppedSamples;
+    volatile NvS32 activeSamples;
+    NvU64 tlsEntryId;
+    RmapiControlStatsSlot *pSlots;
+} RmapiControlStats;
+
+static const char *_phaseName[RMAPI_CONTROL_STATS_PHASE_COUNT] =
+{
+    "lock",
+    "exec",
+    "rpc",
+};
+
+static NvU32 _nsToBucket(NvU64 ns)
+{
+    NvU32 bucket = 64 - portUtilCountLeadingZeros64(ns);
+
+    return NV_MIN(bucket, RMAPI_CONTROL_STATS_NUM_BUCKETS - 1);
+}
+
+static RmapiControlStatsSlot *_getOrInitSlot(NvU32 cmd)
+{
+    NvU32 hash = (cmd ^ (cmd >> 16)) * 0x45d9f3b;
+    NvU32 i;
+
+    for (i = 0; i < RMAPI_CONTROL_STATS_NUM_SLOTS; i++)
+    {
+        RmapiControlStatsSlot *pSlot =
+            &RmapiControlStats.pSlots[(hash + i) & (RMAPI_CONTROL_STATS_NUM_SLOTS - 1)];
+        NvU32 slotCmd = pSlot->cmd;
+
+        if (slotCmd == 0)
+        {
+            if (portAtomicCompareAndSwapU32(&pSlot->cmd, cmd, 0))
+                return pSlot;
+
+            slotCmd = pSlot->cmd;
+        }
+
+        if (slotCmd == cmd)
+            return pSlot;
+    }
+
+    return NULL;
+}
+
+static void _recordPhase(RmapiControlStatsSlot *pSlot, NvU32 phase, NvU64 ns)
+{
+    portAtomicIncrementU32(&pSlot->buckets[phase][_nsToBucket(ns)]);
+}
+
+NV_STATUS rmapiControlStatsInit(void)
+{
+    NvU32 data;
+
+    portMemSet(&RmapiControlStats, 0, sizeof(RmapiControlStats));
+
+    if (osReadRegistryDword(NULL, NV_REG_STR_RM_CONTROL_LATENCY_SAMPLE_RATE, &data) != NV_OK ||
+        data == 0)
+    {
+        return NV_OK;
+    }
+
+    RmapiControlStats.pSlots = portMemAllocNonPaged(sizeof(RmapiControlStatsSlot) *
+                                                    RMAPI_CONTROL_STATS_NUM_SLOTS);
+    if (RmapiControlStats.pSlots == NULL)
+    {
+        NV_PRINTF(LEVEL_ERROR, "failed to allocate control latency histograms\n");
+        return NV_OK;
+    }
+    portMemSet(RmapiControlStats.pSlots, 0,
+               sizeof(RmapiControlStatsSlot) * RMAPI_CONTROL_STATS_NUM_SLOTS);
+
+    RmapiControlStats.tlsEntryId = tlsEntryAlloc();
+    RmapiControlStats.sampleRate = data;
+
+    NV_PRINTF(LEVEL_INFO, "sampling 1 in %u controls for latency\n", data);
+
+    return NV_OK;
+}
+
+void rmapiControlStatsFree(void)
+{
+    NvU32 i;
+    NvU32 phase;
+
+    if (RmapiControlStats.pSlots == NULL)
+        return;
+
+    RmapiControlStats.sampleRate = 0;
+
+    for (i = 0; i < RMAPI_CONTROL_STATS_NUM_SLOTS; i++)
+    {
+        RmapiControlStatsSlot *pSlot = &RmapiControlStats.pSlots[i];
+
+        if (pSlot->cmd == 0 || pSlot->count == 0)
+            continue;
+
+        NV_PRINTF(LEVEL_NOTICE, "control 0x%08x: %u samples, avg %llu ns\n",
+                  pSlot->cmd, pSlot->count, pSlot->totalNs / pSlot->count);
+
+        for (phase = 0; phase < RMAPI_CONTROL_STATS_PHASE_COUNT; phase++)
+        {
+            NvU32 bucket;
+
+            for (bucket = 0; bucket < RMAPI_CONTROL_STATS_NUM_BUCKETS; bucket++)
+            {
+                if (pSlot->buckets[phase][bucket] == 0)
+                    continue;
+
+                NV_PRINTF(LEVEL_NOTICE, "    %s < 2^%u ns: %u\n",
+                          _phaseName[phase], bucket, pSlot->buckets[phase][bucket]);
+            }
+        }
+    }
+
+    if (RmapiControlStats.droppedSamples != 0)
+    {
+        NV_PRINTF(LEVEL_NOTICE, "%u control samples dropped, histogram table full\n",
+                  RmapiControlStats.droppedSamples);
+    }
+
+    portMemFree(RmapiControlStats.pSlots);
+    RmapiControlStats.pSlots = NULL;
+}
+
+NvBool rmapiControlStatsSampleBegin(RMAPI_CONTROL_STATS_SAMPLE *pSample)
+{
+    NvU32 sampleRate = RmapiControlStats.sampleRate;
+    NvP64 *ppEntry;
+
+    if (sampleRate == 0)
+        return NV_FALSE;
+
+    if ((portAtomicIncrementU32(&RmapiControlStats.sampleCounter) % sampleRate) != 0)
+        return NV_FALSE;
+
+    // A control issued while handling a sampled one is charged to the outer one
+    if (tlsEntryGet(RmapiControlStats.tlsEntryId) != NvP64_NULL)
+        return NV_FALSE;
+
+    ppEntry = tlsEntryAcquire(RmapiControlStats.tlsEntryId);
+    if (ppEntry == NULL)
+        return NV_FALSE;
+
+    portMemSet(pSample, 0, sizeof(*pSample));
+    *ppEntry = NV_PTR_TO_NvP64(pSample);
+    portAtomicIncrementS32(&RmapiControlStats.activeSamples);
+    osGetPerformanceCounter(&pSample->startNs);
+
+    return NV_TRUE;
+}
+
+void rmapiControlStatsSampleEnd(RMAPI_CONTROL_STATS_SAMPLE *pSample, NvU32 cmd)
+{
+    RmapiControlStatsSlot *pSlot;
+    NvU64 now;
+    NvU64 totalNs;
+    NvU64 waitNs;
+
+    osGetPerformanceCounter(&now);
+    totalNs = now - pSample->startNs;
+
+    portAtomicDecrementS32(&RmapiControlStats.activeSamples);
+    tlsEntryRelease(RmapiControlStats.tlsEntryId);
+
+    if (RmapiControlStats.pSlots == NULL)
+        return;
+
+    pSlot = _getOrInitSlot(cmd);
+    if (pSlot == NULL)
+    {
+        portAtomicIncrementU32(&RmapiControlStats.droppedSamples);
+        return;
+    }
+
+    waitNs = pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_LOCK] +
+             pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_RPC];
+    pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_EXEC] =
+        (totalNs > waitNs) ? (totalNs - waitNs) : 0;
+
+    _recordPhase(pSlot, RMAPI_CONTROL_STATS_PHASE_LOCK,
+                 pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_LOCK]);
+    _recordPhase(pSlot, RMAPI_CONTROL_STATS_PHASE_EXEC,
+                 pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_EXEC]);
+    _recordPhase(pSlot, RMAPI_CONTROL_STATS_PHASE_RPC,
+                 pSample->phaseNs[RMAPI_CONTROL_STATS_PHASE_RPC]);
+
+    portAtomicExAddU64(&pSlot->totalNs, totalNs);
+    portAtomicIncrementU32(&pSlot->count);
+}
+
+NvU64 rmapiControlStatsWaitBegin(void)
+{
+    NvU64 now;
+
+    if (RmapiControlStats.activeSamples == 0)
+        return 0;
+
+    if (tlsEntryGet(RmapiControlStats.tlsEntryId) == NvP64_NULL)
+        return 0;
+
+    osGetPerformanceCounter(&now);
+    return now;
+}
+
+void rmapiControlStatsWaitEnd(NvU32 phase, NvU64 startNs)
+{
+    RMAPI_CONTROL_STATS_SAMPLE *pSample;
+    NvU64 now;
+
+    if (startNs == 0)
+        return;
+
+    pSample = NvP64_VALUE(tlsEntryGet(RmapiControlStats.tlsEntryId));
+    if (pSample == NULL)
+        return;
+
+    osGetPerformanceCounter(&now);
+    pSample->phaseNs[phase] += now - startNs;
+}
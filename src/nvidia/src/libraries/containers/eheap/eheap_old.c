@@ -427,46 +427,37 @@ eheapAlloc
         if (desiredOffset % offsetAlign)
             goto failed;
 
-        blockFree = pHeap->pFreeBlockList;
-
-        if (blockFree == NULL)
-        {
-            goto failed;
-        }
+        //
+        // Only the block containing desiredOffset can satisfy the request, so
+        // look it up in the block tree rather than walking the free list.
+        //
+        blockFree = eheapGetBlock(pHeap, desiredOffset, NV_TRUE);
 
-        do
+        // Does this free block contain our desired range?
+        if ((blockFree != NULL) &&
+            (blockFree->owner == NVOS32_BLOCK_TYPE_FREE) &&
+            ((desiredOffset + allocSize - 1) <= blockFree->end))
         {
             //
-            // Allocate from the bottom of the memory block.
+            // Make sure no allocated block between ALIGN_DOWN(allocLo, granularity)
+            // and ALIGN_UP(allocHi, granularity) have a different owner than the current allocation
             //
-            blockFree = blockFree->nextFree;
-
-            // Does this block contain our desired range?
-            if ( (desiredOffset >= blockFree->begin) &&
-                 (desiredOffset + allocSize - 1) <= blockFree->end )
+            if (pHeap->bOwnerIsolation)
             {
-                //
-                // Make sure no allocated block between ALIGN_DOWN(allocLo, granularity)
-                // and ALIGN_UP(allocHi, granularity) have a different owner than the current allocation
-                //
-                if (pHeap->bOwnerIsolation)
+                NV_ASSERT(NULL != checker);
+                if (!_eheapCheckOwnership(pHeap, pIsolationID, desiredOffset,
+                         desiredOffset + allocSize - 1, blockFree, checker))
                 {
-                    NV_ASSERT(NULL != checker);
-                    if (!_eheapCheckOwnership(pHeap, pIsolationID, desiredOffset,
-                             desiredOffset + allocSize - 1, blockFree, checker))
-                    {
-                        break;
-                    }
+                    goto failed;
                 }
-
-                // we have a match, now remove it from the pool
-                allocLo = desiredOffset;
-                allocHi = desiredOffset + allocSize - 1;
-                allocAl = allocLo;
-                goto got_one;
             }
 
-        } while (blockFree != pHeap->pFreeBlockList);
+            // we have a match, now remove it from the pool
+            allocLo = desiredOffset;
+            allocHi = desiredOffset + allocSize - 1;
+            allocAl = allocLo;
+            goto got_one;
+        }
 
         // return error if can't get that particular address
         goto failed;
@@ -506,6 +497,13 @@ eheapAlloc
         blockLo = (rangeLo > blockFree->begin) ? rangeLo : blockFree->begin;
         blockHi = (rangeHi < blockFree->end) ? rangeHi : blockFree->end;
 
+        //
+        // Skip blocks whose in-range part is too small for the request even
+        // before alignment.
+        //
+        if ((blockHi - blockLo) < (allocSize - 1))
+            goto next_free;
+
         if ( *flags & NVOS32_ALLOC_FLAGS_FORCE_MEM_GROWS_DOWN )
         {
             //
@@ -0,0 +1,566 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "containers/hashmap.h"
+
+CONT_VTABLE_DEFN(HashMapBase, hashmapIterRange_IMPL, NULL);
+
+//
+// Control byte encoding. A full slot holds the low 7 bits of the key hash
+// (MSB clear), empty and deleted slots have the MSB set. Deleted slots
+// (tombstones) keep probe chains intact until the next rehash.
+//
+#define HASHMAP_CTRL_EMPTY      ((NvU8)0x80)
+#define HASHMAP_CTRL_DELETED    ((NvU8)0xFE)
+
+#define HASHMAP_LSBS            0x0101010101010101ULL
+#define HASHMAP_MSBS            0x8080808080808080ULL
+
+#define HASHMAP_H1(hash)        ((hash) >> 7)
+#define HASHMAP_H2(hash)        ((NvU8)((hash) & 0x7F))
+
+// Keep at most 7/8 of the slots full or deleted, so every probe terminates
+#define HASHMAP_MAX_LOAD(cap)   ((cap) - ((cap) / 8))
+
+#define HASHMAP_SLOT_INVALID    NV_U32_MAX
+
+static NV_STATUS _hashmapResize(HashMapBase *pMap, NvU32 newCapacity);
+
+static NV_FORCEINLINE NvU64
+_hashmapHash(NvU64 key)
+{
+    // splitmix64 finalizer, spreads sequential handles and aligned addresses
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+//
+// Load the control bytes of a group so that byte i of the group ends up in
+// bits [8i+7:8i] of the result.
+//
+static NV_FORCEINLINE NvU64
+_hashmapLoadGroup(HashMapBase *pMap, NvU32 group)
+{
+#if NVCPU_IS_BIG_ENDIAN
+    NvU64 word = 0;
+    NvU32 i;
+
+    for (i = 0; i < HASHMAP_GROUP_SIZE; i++)
+        word |= (NvU64)pMap->pCtrl[group * HASHMAP_GROUP_SIZE + i] << (i * 8);
+
+    return word;
+#else
+    return ((const NvU64 *)pMap->pCtrl)[group];
+#endif
+}
+
+//
+// Returns a mask with the MSB of every byte set whose control byte equals h2.
+// The borrow can also flag the byte above a true match; such bytes are always
+// full slots, so callers still compare keys.
+//
+static NV_FORCEINLINE NvU64
+_hashmapMatch(NvU64 word, NvU8 h2)
+{
+    NvU64 x = word ^ (HASHMAP_LSBS * h2);
+    return (x - HASHMAP_LSBS) & ~x & HASHMAP_MSBS;
+}
+
+static NV_FORCEINLINE NvU64
+_hashmapMatchEmpty(NvU64 word)
+{
+    // Only EMPTY has the MSB set and bit 1 clear
+    return word & ~(word << 6) & HASHMAP_MSBS;
+}
+
+static NV_FORCEINLINE NvU64
+_hashmapMatchEmptyOrDeleted(NvU64 word)
+{
+    return word & HASHMAP_MSBS;
+}
+
+static NV_FORCEINLINE NvU32
+_hashmapMatchFirst(NvU64 match)
+{
+    return portUtilCountTrailingZeros64(match) >> 3;
+}
+
+static NV_FORCEINLINE void
+_hashmapSetCtrl(HashMapBase *pMap, NvU32 slot, NvU8 ctrl)
+{
+    pMap->pCtrl[slot] = ctrl;
+}
+
+/**
+ * @brief Find the slot holding key, or HASHMAP_SLOT_INVALID.
+ *
+ * Groups are visited in triangular order, which covers every group of a
+ * power of two sized table.
+ */
+static NvU32
+_hashmapFindSlot(HashMapBase *pMap, NvU64 key)
+{
+    NvU64 hash;
+    NvU32 groupMask;
+    NvU32 group;
+    NvU32 probe;
+
+    if (pMap->capacity == 0)
+        return HASHMAP_SLOT_INVALID;
+
+    hash = _hashmapHash(key);
+    groupMask = (pMap->capacity / HASHMAP_GROUP_SIZE) - 1;
+    group = (NvU32)HASHMAP_H1(hash) & groupMask;
+
+    for (probe = 0; probe <= groupMask; probe++)
+    {
+        NvU64 word = _hashmapLoadGroup(pMap, group);
+        NvU64 match = _hashmapMatch(word, HASHMAP_H2(hash));
+
+        while (match != 0)
+        {
+            NvU32 slot = group * HASHMAP_GROUP_SIZE + _hashmapMatchFirst(match);
+            HashMapNode *pNode = pMap->ppSlots[slot];
+
+            if ((pNode != NULL) && (pNode->key == key))
+                return slot;
+
+            match &= match - 1;
+        }
+
+        if (_hashmapMatchEmpty(word) != 0)
+            break;
+
+        group = (group + probe + 1) & groupMask;
+    }
+
+    return HASHMAP_SLOT_INVALID;
+}
+
+/**
+ * @brief Find the first empty or deleted slot on the probe chain of hash.
+ *
+ * The load limit guarantees that one exists.
+ */
+static NvU32
+_hashmapFindInsertSlot(HashMapBase *pMap, NvU64 hash)
+{
+    NvU32 groupMask = (pMap->capacity / HASHMAP_GROUP_SIZE) - 1;
+    NvU32 group = (NvU32)HASHMAP_H1(hash) & groupMask;
+    NvU32 probe;
+
+    for (probe = 0; probe <= groupMask; probe++)
+    {
+        NvU64 match = _hashmapMatchEmptyOrDeleted(_hashmapLoadGroup(pMap, group));
+
+        if (match != 0)
+            return group * HASHMAP_GROUP_SIZE + _hashmapMatchFirst(match);
+
+        group = (group + probe + 1) & groupMask;
+    }
+
+    NV_ASSERT_FAILED("hash map has no free slot");
+    return HASHMAP_SLOT_INVALID;
+}
+
+static void
+_hashmapPlace(HashMapBase *pMap, HashMapNode *pNode)
+{
+    NvU64 hash = _hashmapHash(pNode->key);
+    NvU32 slot = _hashmapFindInsertSlot(pMap, hash);
+
+    if (pMap->pCtrl[slot] == HASHMAP_CTRL_EMPTY)
+        pMap->growthLeft--;
+
+    _hashmapSetCtrl(pMap, slot, HASHMAP_H2(hash));
+    pMap->ppSlots[slot] = pNode;
+}
+
+/**
+ * @brief Move every value into a new table of newCapacity slots.
+ *
+ * Also drops all tombstones. The slot pointers and the control bytes share
+ * one allocation, the control bytes following the (8-byte aligned) pointers.
+ */
+static NV_STATUS
+_hashmapResize(HashMapBase *pMap, NvU32 newCapacity)
+{
+    HashMapNode **ppOldSlots = pMap->ppSlots;
+    NvU32 oldCapacity = pMap->capacity;
+    HashMapNode **ppNewSlots;
+    NvU32 i;
+
+    NV_ASSERT_OR_RETURN(newCapacity >= HASHMAP_GROUP_SIZE, NV_ERR_INVALID_ARGUMENT);
+    NV_ASSERT_OR_RETURN(ONEBITSET(newCapacity), NV_ERR_INVALID_ARGUMENT);
+    NV_ASSERT_OR_RETURN(HASHMAP_MAX_LOAD(newCapacity) >= pMap->count, NV_ERR_INVALID_ARGUMENT);
+
+    ppNewSlots = PORT_ALLOC(pMap->pAllocator,
+                            (NvLength)newCapacity * (sizeof(HashMapNode *) + 1));
+    if (ppNewSlots == NULL)
+        return NV_ERR_NO_MEMORY;
+
+    portMemSet(ppNewSlots, 0, (NvLength)newCapacity * sizeof(HashMapNode *));
+    portMemSet(ppNewSlots + newCapacity, HASHMAP_CTRL_EMPTY, newCapacity);
+
+    pMap->ppSlots = ppNewSlots;
+    pMap->pCtrl = (NvU8 *)(ppNewSlots + newCapacity);
+    pMap->capacity = newCapacity;
+    pMap->growthLeft = HASHMAP_MAX_LOAD(newCapacity);
+
+    for (i = 0; i < oldCapacity; i++)
+    {
+        if (ppOldSlots[i] != NULL)
+            _hashmapPlace(pMap, ppOldSlots[i]);
+    }
+
+    if (ppOldSlots != NULL)
+        PORT_FREE(pMap->pAllocator, ppOldSlots);
+
+#if PORT_IS_CHECKED_BUILD
+    pMap->versionNumber++;
+#endif
+    return NV_OK;
+}
+
+static void
+_hashmapEraseSlot(HashMapBase *pMap, NvU32 slot)
+{
+    NvU32 group = slot / HASHMAP_GROUP_SIZE;
+
+    //
+    // Lookups stop at the first group with an empty slot, so if this group
+    // already has one no probe chain passes through it and the slot can be
+    // freed outright instead of leaving a tombstone.
+    //
+    if (_hashmapMatchEmpty(_hashmapLoadGroup(pMap, group)) != 0)
+    {
+        _hashmapSetCtrl(pMap, slot, HASHMAP_CTRL_EMPTY);
+        pMap->growthLeft++;
+    }
+    else
+    {
+        _hashmapSetCtrl(pMap, slot, HASHMAP_CTRL_DELETED);
+    }
+
+#if PORT_IS_CHECKED_BUILD
+    pMap->ppSlots[slot]->pMap = NULL;
+    pMap->versionNumber++;
+#endif
+    pMap->ppSlots[slot] = NULL;
+    pMap->count--;
+}
+
+void
+hashmapInit_IMPL
+(
+    IntrusiveHashMap    *pMap,
+    PORT_MEM_ALLOCATOR  *pAllocator,
+    NvS32                nodeOffset
+)
+{
+    NV_ASSERT_OR_RETURN_VOID(NULL != pMap);
+    NV_ASSERT_OR_RETURN_VOID(NULL != pAllocator);
+    portMemSet(&(pMap->base), 0, sizeof(pMap->base));
+    CONT_VTABLE_INIT(HashMapBase, &pMap->base);
+    pMap->base.pAllocator = pAllocator;
+    pMap->base.nodeOffset = nodeOffset;
+}
+
+/**
+ * @brief Release the table. Values are left untouched, as for other
+ * intrusive containers.
+ */
+void
+hashmapDestroy_IMPL
+(
+    HashMapBase *pMap
+)
+{
+    NV_ASSERT_OR_RETURN_VOID(NULL != pMap);
+
+#if PORT_IS_CHECKED_BUILD
+    {
+        NvU32 i;
+        for (i = 0; i < pMap->capacity; i++)
+        {
+            if (pMap->ppSlots[i] != NULL)
+                pMap->ppSlots[i]->pMap = NULL;
+        }
+    }
+    pMap->versionNumber++;
+#endif
+
+    if (pMap->ppSlots != NULL)
+        PORT_FREE(pMap->pAllocator, pMap->ppSlots);
+
+    pMap->ppSlots = NULL;
+    pMap->pCtrl = NULL;
+    pMap->capacity = 0;
+    pMap->count = 0;
+    pMap->growthLeft = 0;
+}
+
+/**
+ * @brief Size the table for at least count values.
+ *
+ * Inserts up to that count do not allocate, unless removals in between left
+ * enough tombstones to force a rehash.
+ */
+NV_STATUS
+hashmapReserve_IMPL
+(
+    HashMapBase *pMap,
+    NvU32        count
+)
+{
+    NvU32 capacity = HASHMAP_GROUP_SIZE;
+
+    NV_ASSERT_OR_RETURN(NULL != pMap, NV_ERR_INVALID_ARGUMENT);
+
+    while (HASHMAP_MAX_LOAD(capacity) < count)
+    {
+        NV_ASSERT_OR_RETURN(capacity <= (NV_U32_MAX / 2), NV_ERR_INVALID_ARGUMENT);
+        capacity *= 2;
+    }
+
+    if (capacity <= pMap->capacity)
+        return NV_OK;
+
+    return _hashmapResize(pMap, capacity);
+}
+
+NvU32
+hashmapCount_IMPL
+(
+    HashMapBase *pMap
+)
+{
+    NV_ASSERT_OR_RETURN(NULL != pMap, 0);
+    return pMap->count;
+}
+
+NvU64
+hashmapKey_IMPL
+(
+    HashMapBase *pMap,
+    void        *pValue
+)
+{
+    HashMapNode *pNode = hashmapValueToNode(pMap, pValue);
+    NV_ASSERT_OR_RETURN(NULL != pNode, 0);
+    NV_ASSERT_CHECKED(pNode->pMap == pMap);
+    return pNode->key;
+}
+
+/**
+ * @brief Insert a user-allocated value under key.
+ *
+ * @returns NV_FALSE if the key is already present or the table could not grow.
+ */
+NvBool
+hashmapInsertExisting_IMPL
+(
+    HashMapBase *pMap,
+    NvU64        key,
+    void        *pValue
+)
+{
+    HashMapNode *pNode;
+
+    NV_ASSERT_OR_RETURN(NULL != pMap, NV_FALSE);
+    NV_ASSERT_OR_RETURN(NULL != pValue, NV_FALSE);
+
+    if (_hashmapFindSlot(pMap, key) != HASHMAP_SLOT_INVALID)
+        return NV_FALSE;
+
+    if (pMap->growthLeft == 0)
+    {
+        NvU32 newCapacity;
+
+        if (pMap->capacity == 0)
+        {
+            newCapacity = HASHMAP_GROUP_SIZE;
+        }
+        else if (pMap->count >= (pMap->capacity / 2))
+        {
+            NV_ASSERT_OR_RETURN(pMap->capacity <= (NV_U32_MAX / 2), NV_FALSE);
+            newCapacity = pMap->capacity * 2;
+        }
+        else
+        {
+            // Mostly tombstones, rehash in place
+            newCapacity = pMap->capacity;
+        }
+
+        if (_hashmapResize(pMap, newCapacity) != NV_OK)
+            return NV_FALSE;
+    }
+
+    pNode = hashmapValueToNode(pMap, pValue);
+    pNode->key = key;
+#if PORT_IS_CHECKED_BUILD
+    pNode->pMap = pMap;
+    pMap->versionNumber++;
+#endif
+
+    _hashmapPlace(pMap, pNode);
+    pMap->count++;
+
+    return NV_TRUE;
+}
+
+void
+hashmapRemove_IMPL
+(
+    HashMapBase *pMap,
+    void        *pValue
+)
+{
+    HashMapNode *pNode;
+    NvU32 slot;
+
+    if (pValue == NULL)
+        return;
+
+    pNode = hashmapValueToNode(pMap, pValue);
+    NV_ASSERT_OR_RETURN_VOID(NULL != pNode);
+    NV_ASSERT_CHECKED(pNode->pMap == pMap);
+
+    slot = _hashmapFindSlot(pMap, pNode->key);
+    NV_ASSERT_OR_RETURN_VOID(slot != HASHMAP_SLOT_INVALID);
+    NV_ASSERT_OR_RETURN_VOID(pMap->ppSlots[slot] == pNode);
+
+    _hashmapEraseSlot(pMap, slot);
+}
+
+void
+hashmapRemoveByKey_IMPL
+(
+    HashMapBase *pMap,
+    NvU64        key
+)
+{
+    NvU32 slot;
+
+    NV_ASSERT_OR_RETURN_VOID(NULL != pMap);
+
+    slot = _hashmapFindSlot(pMap, key);
+    if (slot != HASHMAP_SLOT_INVALID)
+        _hashmapEraseSlot(pMap, slot);
+}
+
+void *
+hashmapFind_IMPL
+(
+    HashMapBase *pMap,
+    NvU64        key
+)
+{
+    NvU32 slot;
+
+    NV_ASSERT_OR_RETURN(NULL != pMap, NULL);
+
+    slot = _hashmapFindSlot(pMap, key);
+    if (slot == HASHMAP_SLOT_INVALID)
+        return NULL;
+
+    return hashmapNodeToValue(pMap, pMap->ppSlots[slot]);
+}
+
+/**
+ * @brief Iterate over every value in table order.
+ *
+ * The map is unordered, so only the full range (NULL, NULL) is supported.
+ */
+HashMapIterBase
+hashmapIterRange_IMPL
+(
+    HashMapBase *pMap,
+    void        *pFirst,
+    void        *pLast
+)
+{
+    HashMapIterBase it;
+
+    portMemSet(&it, 0, sizeof(it));
+    it.pMap = pMap;
+
+    NV_ASSERT(NULL == pFirst);
+    NV_ASSERT(NULL == pLast);
+
+#if PORT_IS_CHECKED_BUILD
+    if (pMap != NULL)
+        it.versionNumber = pMap->versionNumber;
+#endif
+
+    return it;
+}
+
+NvBool
+hashmapIterNext_IMPL
+(
+    HashMapIterBase *pIt
+)
+{
+    HashMapBase *pMap;
+
+    NV_ASSERT_OR_RETURN(NULL != pIt, NV_FALSE);
+
+    pMap = pIt->pMap;
+    if (pMap == NULL)
+        return NV_FALSE;
+
+    NV_ASSERT_CHECKED(pIt->versionNumber == pMap->versionNumber);
+
+    while (pIt->slot < pMap->capacity)
+    {
+        HashMapNode *pNode = pMap->ppSlots[pIt->slot++];
+
+        if (pNode != NULL)
+        {
+            pIt->pValue = hashmapNodeToValue(pMap, pNode);
+            return NV_TRUE;
+        }
+    }
+
+    pIt->pValue = NULL;
+    return NV_FALSE;
+}
+
+NvBool
+hashmapIsValid_IMPL(void *pMap)
+{
+#if NV_TYPEOF_SUPPORTED
+    return NV_TRUE;
+#else
+    if (CONT_VTABLE_VALID((HashMapBase*)pMap))
+        return NV_TRUE;
+
+    NV_ASSERT_FAILED("vtable not valid!");
+    CONT_VTABLE_INIT(HashMapBase, (HashMapBase*)pMap);
+    return NV_FALSE;
+#endif
+}
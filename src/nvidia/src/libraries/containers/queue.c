@@ -285,6 +285,61 @@ NvBool circularQueuePopAndCopyNonManaged_IMPL(Queue *pQueue, QueueContext *pCtx,
     return NV_FALSE;
 }
 
+NvLength circularQueuePopAndCopyBatchNonManaged_IMPL
+(
+    Queue *pQueue,
+    QueueContext *pCtx,
+    void *pCopyTo,
+    NvLength maxElements
+)
+{
+    NvLength capacity;
+    NvLength msgSize;
+    NvLength getIdx;
+    NvLength numElements;
+    NvLength elemToCpy;
+    NvU8 *dst = pCopyTo;
+
+    NV_ASSERT_OR_RETURN(pQueue != NULL, 0);
+
+    capacity = MEM_RD64(&pQueue->capacity);
+    msgSize = MEM_RD64(&pQueue->msgSize);
+    getIdx = MEM_RD64(&pQueue->getIdx);
+
+    numElements = queueGetCount(pQueue);
+    if (numElements > maxElements)
+    {
+        numElements = maxElements;
+    }
+
+    if (numElements == 0)
+        return 0;
+
+    // Order the data reads after the PUT index read in queueGetCount.
+    portAtomicMemoryFenceLoad();
+
+    // A max of 2 copies to take care of the wrap around case
+    elemToCpy = numElements;
+    if ((getIdx + numElements) > capacity)
+    {
+        elemToCpy = capacity - getIdx;
+        pCtx->pCopyData(msgSize, getIdx, pCtx, dst, elemToCpy, NV_FALSE /*bCopyIn*/);
+
+        dst += msgSize * elemToCpy;
+        elemToCpy = numElements - elemToCpy;
+        getIdx = 0;
+    }
+
+    pCtx->pCopyData(msgSize, getIdx, pCtx, dst, elemToCpy, NV_FALSE /*bCopyIn*/);
+
+    // Update of index can't happen before we read all the data.
+    portAtomicMemoryFenceLoad();
+
+    MEM_WR64(&pQueue->getIdx, (getIdx + elemToCpy) % capacity);
+
+    return numElements;
+}
+
 NvBool circularQueuePopAndCopy_IMPL(Queue *pQueue, void *pCopyTo)
 {
     QueueContext ctx = {0};
@@ -44,7 +44,8 @@
 // |------------|--------|...|---------|
 //
 
-static NV_EVENT_BUFFER_RECORD* _eventBufferGetFreeRecord(EVENT_BUFFER_PRODUCER_INFO *);
+static NV_EVENT_BUFFER_RECORD* _eventBufferGetFreeRecord(EVENT_BUFFER_PRODUCER_INFO *, NvU32 *);
+static void _eventBufferCommitRecord(EVENT_BUFFER_PRODUCER_INFO *, NvU32);
 static void _eventBufferAddVardata(EVENT_BUFFER_PRODUCER_INFO*, NvP64, NvU32, NV_EVENT_BUFFER_RECORD_HEADER*);
 static void _eventBufferUpdateRecordBufferCount(EVENT_BUFFER_PRODUCER_INFO*);
 static void _eventBufferUpdateVarRemaingSize(EVENT_BUFFER_PRODUCER_INFO* info);
@@ -174,10 +175,11 @@ eventBufferProducerAddEvent
 )
 {
     NV_EVENT_BUFFER_RECORD *record;
+    NvU32 putNext;
 
     if (info->isEnabled)
     {
-        record = _eventBufferGetFreeRecord(info);
+        record = _eventBufferGetFreeRecord(info, &putNext);
         if (record)
         {
             record->recordHeader.type = eventType;
@@ -188,12 +190,20 @@ eventBufferProducerAddEvent
                              NvP64_VALUE(pData->pPayload), pData->payloadSize);
 
             _eventBufferAddVardata(info, pData->pVardata, pData->vardataSize, &record->recordHeader);
+
+            _eventBufferCommitRecord(info, putNext);
         }
     }
 }
 
+//
+// _eventBufferGetFreeRecord
+//
+// Reserves the record at recordPut. The record is not visible to the consumer
+// until _eventBufferCommitRecord publishes putNext in the shared header.
+//
 NV_EVENT_BUFFER_RECORD*
-_eventBufferGetFreeRecord(EVENT_BUFFER_PRODUCER_INFO *info)
+_eventBufferGetFreeRecord(EVENT_BUFFER_PRODUCER_INFO *info, NvU32 *pPutNext)
 {
     RECORD_BUFFER_INFO* pRecInfo = &info->recordBuffer;
     NV_EVENT_BUFFER_HEADER* pHeader = pRecInfo->pHeader;
@@ -213,13 +223,23 @@ _eventBufferGetFreeRecord(EVENT_BUFFER_PRODUCER_INFO *info)
     {
         recordOffset = pHeader->recordPut * pRecInfo->recordSize;
         pFreeRecord = (NV_EVENT_BUFFER_RECORD*)((NvUPtr)pRecInfo->recordBuffAddr + recordOffset);
-
-        pHeader->recordCount++;
-        pHeader->recordPut = putNext;
+        *pPutNext = putNext;
     }
     return pFreeRecord;
 }
 
+void
+_eventBufferCommitRecord(EVENT_BUFFER_PRODUCER_INFO *info, NvU32 putNext)
+{
+    NV_EVENT_BUFFER_HEADER* pHeader = info->recordBuffer.pHeader;
+
+    // The record and its vardata must be visible before the consumer sees PUT move
+    portAtomicMemoryFenceStore();
+
+    pHeader->recordCount++;
+    pHeader->recordPut = putNext;
+}
+
 void
 _eventBufferAddVardata
 (
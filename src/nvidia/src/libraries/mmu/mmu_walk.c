@@ -249,6 +249,36 @@ mmuWalkFindLevel
     return pLevel;
 }
 
+/*!
+ * Looks up the level instance covering va, checking the instance found by
+ * the previous lookup at this level before searching the instance tree.
+ */
+NV_STATUS
+mmuWalkLevelInstSearch
+(
+    MMU_WALK_LEVEL       *pLevel,
+    NvU64                 va,
+    MMU_WALK_LEVEL_INST **ppLevelInst
+)
+{
+    MMU_WALK_LEVEL_INST *pLevelInst = pLevel->pLastInst;
+    NV_STATUS            status;
+
+    if ((NULL != pLevelInst) &&
+        (va >= pLevelInst->node.keyStart) && (va <= pLevelInst->node.keyEnd))
+    {
+        *ppLevelInst = pLevelInst;
+        return NV_OK;
+    }
+
+    status = btreeSearch(va, (NODE**)ppLevelInst, (NODE*)pLevel->pInstances);
+    if (NV_OK == status)
+    {
+        pLevel->pLastInst = *ppLevelInst;
+    }
+    return status;
+}
+
 /*!
  * @brief This function traverses the topology described by @ref
  * MMU_FMT_LEVEL and @ref MMU_DESC_PDE. The @ref MmuOpFunc
@@ -1363,7 +1393,7 @@ _mmuWalkLevelInstAcquire
     NvBool               bNew       = NV_FALSE;
 
     // Lookup level instance.
-    if (NV_OK != btreeSearch(vaLo, (NODE**)&pLevelInst, (NODE*)pLevel->pInstances))
+    if (NV_OK != mmuWalkLevelInstSearch(pLevel, vaLo, &pLevelInst))
     {
         NvU32 numBytes;
 
@@ -1512,6 +1542,10 @@ _mmuWalkLevelInstRelease
     NV_ASSERT(0 == pLevelInst->numReserved);
     // Unlink.
     btreeUnlink(&pLevelInst->node, (NODE**)&pLevel->pInstances);
+    if (pLevel->pLastInst == pLevelInst)
+    {
+        pLevel->pLastInst = NULL;
+    }
     // Free.
     if (NULL != pLevelInst->pMemDesc)
     {
@@ -1561,8 +1595,8 @@ _mmuWalkPdeAcquire
         for (i = 0; i < numSubLevels; ++i)
         {
             // Lookup sub-level instance.
-            if (NV_OK == btreeSearch(vaLo, (NODE**)&pCurSubLevelInsts[i],
-                                     (NODE*)pLevel->subLevels[i].pInstances))
+            if (NV_OK == mmuWalkLevelInstSearch(pLevel->subLevels + i, vaLo,
+                                                &pCurSubLevelInsts[i]))
             {
                 const MMU_FMT_LEVEL *pSubLevelFmt = pLevel->pFmt->subLevels + i;
                 const NvU64          minVaLimit =
@@ -1687,8 +1721,8 @@ _mmuWalkPdeRelease
     for (i = pLevel->pFmt->numSubLevels; i > 0; --i)
     {
         subLevel = i - 1;
-        if (NV_OK == btreeSearch(entryVaLo, (NODE**)&pSubLevelInsts[subLevel],
-                                 (NODE*)pLevel->subLevels[subLevel].pInstances))
+        if (NV_OK == mmuWalkLevelInstSearch(pLevel->subLevels + subLevel, entryVaLo,
+                                            &pSubLevelInsts[subLevel]))
         {
             MMU_WALK_LEVEL_INST *pSubLevelInst = pSubLevelInsts[subLevel];
 
@@ -1817,6 +1851,7 @@ _mmuWalkLevelInstancesForceFree
         btreeEnumStart(0, (NODE **)&pLevelInst, (NODE*)pLevel->pInstances);
     }
     pLevel->pInstances = NULL;
+    pLevel->pLastInst  = NULL;
 
     if (NULL != pLevel->subLevels)
     {
@@ -122,6 +122,13 @@ struct MMU_WALK_LEVEL
      */
     MMU_WALK_LEVEL_INST  *pInstances;
 
+    /*!
+     * Instance returned by the last lookup at this level, checked before
+     * searching pInstances. Walks over a contiguous range hit the same
+     * instance for every entry of its parent. @see mmuWalkLevelInstSearch.
+     */
+    MMU_WALK_LEVEL_INST  *pLastInst;
+
     /*!
      * Tree tracking ranges of VA that are reserved (locked down)
      * for this level. @see mmuWalkReserveEntries.
@@ -318,6 +325,11 @@ const MMU_WALK_LEVEL *
 mmuWalkFindLevel(const MMU_WALK      *pWalk,
                  const MMU_FMT_LEVEL *pLevelFmt);
 
+NV_STATUS
+mmuWalkLevelInstSearch(MMU_WALK_LEVEL       *pLevel,
+                       NvU64                 va,
+                       MMU_WALK_LEVEL_INST **ppLevelInst);
+
 NV_STATUS
 mmuWalkProcessPdes(const MMU_WALK           *pWalk,
                    const MMU_WALK_OP_PARAMS *pOpParams,
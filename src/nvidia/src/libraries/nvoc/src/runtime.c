@@ -271,11 +271,14 @@ Dynamic *objDynamicCastById_IMPL(Dynamic *pFromObj, NVOC_CLASS_ID classId)
         return pDerivedObj;
     }
 
+    //
     // slowpath, search all the possibilities for a match
+    // relatives[0] is always the fully derived class itself, checked above.
+    //
     numBases = pDerivedRtti->pClassDef->pCastInfo->numRelatives;
     bases = pDerivedRtti->pClassDef->pCastInfo->relatives;
 
-    for (i = 0; i < numBases; i++)
+    for (i = 1; i < numBases; i++)
     {
         if (classId == bases[i]->pClassDef->classInfo.classId)
         {
@@ -289,7 +292,42 @@ Dynamic *objDynamicCastById_IMPL(Dynamic *pFromObj, NVOC_CLASS_ID classId)
 //! Internal backing method for dynamicCast.
 Dynamic *__nvoc_dynamicCast(Dynamic *pFromObj, const NVOC_CLASS_INFO *pClassInfo)
 {
-    return objDynamicCastById(pFromObj, pClassInfo->classId);
+    NvU32 i, numBases;
+    Dynamic *pDerivedObj;
+
+    const struct NVOC_RTTI *const   *bases;
+    const struct NVOC_RTTI          *pDerivedRtti;
+
+    if (pFromObj == NULL)
+    {
+        return NULL;
+    }
+
+    //
+    // There is exactly one class def per class and classInfo() points at it,
+    // so compare class def pointers instead of loading each classId.
+    //
+    if (&pFromObj->__nvoc_rtti->pClassDef->classInfo == pClassInfo)
+    {
+        return pFromObj;
+    }
+
+    pDerivedObj = __nvoc_fullyDerive(pFromObj);
+    pDerivedRtti = pDerivedObj->__nvoc_rtti;
+
+    numBases = pDerivedRtti->pClassDef->pCastInfo->numRelatives;
+    bases = pDerivedRtti->pClassDef->pCastInfo->relatives;
+
+    // relatives[0] is the fully derived class itself.
+    for (i = 0; i < numBases; i++)
+    {
+        if (&bases[i]->pClassDef->classInfo == pClassInfo)
+        {
+            return (Dynamic*)((NvU8*)pDerivedObj + bases[i]->offset);
+        }
+    }
+
+    return NULL;
 }
 
 /*!
@@ -377,6 +377,16 @@ _portMemListAdd
 {
     PORT_MEM_HEADER *pHead = (PORT_MEM_HEADER*)pMem - 1;
     PORT_MEM_LIST *pList = &pHead->list;
+#if PORT_MEM_TRACK_ALLOCLIST_SAMPLE_RATE > 1
+    if ((PORT_MEM_ATOMIC_INC_U32(&pTracking->listSampleCount) %
+         PORT_MEM_TRACK_ALLOCLIST_SAMPLE_RATE) != 0)
+    {
+        // Not sampled. A NULL pPrev tells _portMemListRemove to skip it.
+        pList->pNext = NULL;
+        pList->pPrev = NULL;
+        return;
+    }
+#endif
     pList->pNext = pList;
     pList->pPrev = pList;
     if (!PORT_MEM_ATOMIC_CAS_SIZE(&pTracking->pFirstAlloc, pList, NULL))
@@ -394,6 +404,11 @@ _portMemListRemove
     PORT_MEM_HEADER *pHead = (PORT_MEM_HEADER*)pMem - 1;
     PORT_MEM_LIST *pList = &pHead->list;
 
+#if PORT_MEM_TRACK_ALLOCLIST_SAMPLE_RATE > 1
+    if (pList->pPrev == NULL)
+        return;
+#endif
+
     if (!PORT_MEM_ATOMIC_CAS_SIZE(&pList->pNext, NULL, pList))
     {
         PORT_LOCKED_LIST_UNLINK(pTracking->pFirstAlloc, pList, pTracking->listLock);
@@ -412,6 +427,7 @@ _portMemListGetHeader
 #define PORT_MEM_LIST_INIT(pTracking)                                          \
     do {                                                                       \
         (pTracking)->pFirstAlloc = NULL;                                       \
+        (pTracking)->listSampleCount = 0;                                      \
         PORT_MEM_LOCK_INIT((pTracking)->listLock);                               \
     } while (0)
 #define PORT_MEM_LIST_DESTROY(pTracking)   PORT_MEM_LOCK_DESTROY((pTracking)->listLock)
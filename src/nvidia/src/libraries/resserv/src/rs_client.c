@@ -23,6 +23,7 @@
 
 
 #include "nvlog_inc.h"
+#include "nvctassert.h"
 #include "resserv/resserv.h"
 #include "resserv/rs_client.h"
 #include "resserv/rs_server.h"
@@ -74,6 +75,35 @@ static NV_STATUS _clientUnmapBackRefMappings(RsClient *pClient, CALL_CONTEXT *pC
 static void _clientUnmapInterMappings(RsClient *pClient, CALL_CONTEXT *pCallContext, RS_LOCK_INFO *pLockInfo);
 static void _clientUnmapInterBackRefMappings(RsClient *pClient, CALL_CONTEXT *pCallContext, RS_LOCK_INFO *pLockInfo);
 
+ct_assert((RS_CLIENT_LOOKUP_CACHE_SIZE & (RS_CLIENT_LOOKUP_CACHE_SIZE - 1)) == 0);
+
+/**
+ * Find a resource reference by handle, checking the lookup cache before the
+ * resource map
+ *
+ * @param[in] pClient Client that owns the resource
+ * @param[in] hResource Handle of the resource
+ */
+static RsResourceRef *
+_clientFindResourceRef
+(
+    RsClient *pClient,
+    NvHandle hResource
+)
+{
+    RsResourceRef **ppSlot = &pClient->pLookupCache[hResource & (RS_CLIENT_LOOKUP_CACHE_SIZE - 1)];
+    RsResourceRef *pResourceRef = *ppSlot;
+
+    if ((pResourceRef != NULL) && (pResourceRef->hResource == hResource))
+        return pResourceRef;
+
+    pResourceRef = mapFind(&pClient->resourceMap, hResource);
+    if (pResourceRef != NULL)
+        *ppSlot = pResourceRef;
+
+    return pResourceRef;
+}
+
 NV_STATUS
 clientConstruct_IMPL
 (
@@ -339,7 +369,7 @@ clientGetResource_IMPL
     RsResourceRef *pResourceRef;
     RsResource    *pResource;
 
-    pResourceRef = mapFind(&pClient->resourceMap, hResource);
+    pResourceRef = _clientFindResourceRef(pClient, hResource);
     if (pResourceRef == NULL)
     {
         status = NV_ERR_OBJECT_NOT_FOUND;
@@ -387,7 +417,7 @@ clientGetResourceRef_IMPL
 {
     RsResourceRef *pResourceRef;
 
-    pResourceRef = mapFind(&pClient->resourceMap, hResource);
+    pResourceRef = _clientFindResourceRef(pClient, hResource);
     if (pResourceRef == NULL)
         return NV_ERR_OBJECT_NOT_FOUND;
 
@@ -775,7 +805,7 @@ clientFreeResource_IMPL
     RsResourceRef  *pResourceRef;
     RsResource     *pResource;
 
-    pResourceRef = mapFind(&pClient->resourceMap, pParams->hResource);
+    pResourceRef = _clientFindResourceRef(pClient, pParams->hResource);
     if (pResourceRef == NULL)
         return NV_ERR_OBJECT_NOT_FOUND;
 
@@ -1065,6 +1095,9 @@ clientDestructResourceRef_IMPL
     _refCleanupDependants(pResourceRef);
     multimapDestroy(&pResourceRef->depRefMap);
 
+    if (pClient->pLookupCache[pResourceRef->hResource & (RS_CLIENT_LOOKUP_CACHE_SIZE - 1)] == pResourceRef)
+        pClient->pLookupCache[pResourceRef->hResource & (RS_CLIENT_LOOKUP_CACHE_SIZE - 1)] = NULL;
+
     mapRemove(&pClient->resourceMap, pResourceRef);
 
     portAtomicExDecrementU64(&pServer->activeResourceCount);
@@ -435,6 +435,40 @@ refFindCpuMappingWithFilter
     return status;
 }
 
+NV_STATUS
+refFindShareableCpuMapping
+(
+    RsResourceRef *pResourceRef,
+    RS_CPU_MAP_PARAMS *pParams,
+    RsResourceRef *pContextRef,
+    RsCpuMapping **ppMapping
+)
+{
+    RsCpuMappingListIter it;
+
+    NV_ASSERT_OR_RETURN(pResourceRef != NULL, NV_ERR_INVALID_ARGUMENT);
+
+    it = listIterAll(&pResourceRef->cpuMappings);
+    while (listIterNext(&it))
+    {
+        RsCpuMapping *pMapping = it.pValue;
+
+        if ((pMapping->offset == pParams->offset) &&
+            (pMapping->length == pParams->length) &&
+            (pMapping->flags == pParams->flags) &&
+            (pMapping->processId == pParams->processId) &&
+            (pMapping->pContextRef == pContextRef) &&
+            (pMapping->pLinearAddress != NvP64_NULL) &&
+            (pMapping->refCount != NV_U32_MAX))
+        {
+            *ppMapping = pMapping;
+            return NV_OK;
+        }
+    }
+
+    return NV_ERR_OBJECT_NOT_FOUND;
+}
+
 NV_STATUS
 refFindChildOfType
 (
@@ -192,6 +192,11 @@ NV_STATUS serverFreeResourceRpcUnderLock(RsServer *pServer, RS_RES_FREE_PARAMS *
 {
     return NV_OK;
 }
+
+NV_STATUS serverBulkFreeClientUnderLock(RsServer *pServer, RsClient *pClient)
+{
+    return NV_OK;
+}
 #endif
 
 
@@ -1120,6 +1125,12 @@ serverFreeResourceTree
 
     clientPostProcessPendingFreeList(pClient, &pFirstLowPriRef);
 
+    if ((pParams->hClient == pParams->hResource) && !bHiPriOnly && !pParams->bInvalidateOnly)
+    {
+        // Whole client is going away, let the user batch its teardown
+        NV_ASSERT_OK(serverBulkFreeClientUnderLock(pServer, pClient));
+    }
+
     if (pServer->bDebugFreeList)
     {
         NV_PRINTF(LEVEL_INFO, "PENDING FREE LIST START (0x%x)\n", pClient->hClient);
@@ -1263,6 +1274,7 @@ serverControl
     CALL_CONTEXT        callContext;
     CALL_CONTEXT       *pOldContext = NULL;
     LOCK_ACCESS_TYPE    access = LOCK_ACCESS_WRITE;
+    LOCK_ACCESS_TYPE    clientAccess = LOCK_ACCESS_WRITE;
 
     pLockInfo = pParams->pLockInfo;
     NV_ASSERT_OR_RETURN(pLockInfo != NULL, NV_ERR_INVALID_ARGUMENT);
@@ -1271,6 +1283,10 @@ serverControl
     if (status != NV_OK)
         goto done;
 
+    status = serverControlLookupLockFlags(pServer, RS_LOCK_CLIENT, pParams, pParams->pCookie, &clientAccess);
+    if (status != NV_OK)
+        goto done;
+
     if (pServer->bUnlockedParamCopy)
     {
         status = serverControlApiCopyIn(pServer, pParams, pParams->pCookie);
@@ -1282,7 +1298,7 @@ serverControl
     if (status != NV_OK)
         goto done;
 
-    status = _serverLockClientWithLockInfo(pServer, LOCK_ACCESS_WRITE, pParams->hClient, pLockInfo, &releaseFlags, &pClient);
+    status = _serverLockClientWithLockInfo(pServer, clientAccess, pParams->hClient, pLockInfo, &releaseFlags, &pClient);
     if (status != NV_OK)
         goto done;
 
@@ -1352,7 +1368,7 @@ done:
 
     serverSessionLock_Epilogue(pServer, LOCK_ACCESS_WRITE, pLockInfo, &releaseFlags);
 
-    _serverUnlockClientWithLockInfo(pServer, LOCK_ACCESS_WRITE, pParams->hClient, pLockInfo, &releaseFlags);
+    _serverUnlockClientWithLockInfo(pServer, clientAccess, pParams->hClient, pLockInfo, &releaseFlags);
     serverTopLock_Epilogue(pServer, access, pLockInfo, &releaseFlags);
 
     if (pServer->bUnlockedParamCopy)
@@ -1722,6 +1738,23 @@ serverMap
         }
     }
 
+    //
+    // Hand out an identical existing mapping again rather than building a new
+    // one. It is only torn down when the last of its users unmaps it, or when
+    // the resource or context is freed.
+    //
+    if (pParams->bShareable &&
+        (refFindShareableCpuMapping(pResourceRef, pParams, pContextRef, &pCpuMapping) == NV_OK))
+    {
+        pCpuMapping->refCount++;
+        if (pParams->ppCpuVirtAddr != NULL)
+            *pParams->ppCpuVirtAddr = pCpuMapping->pLinearAddress;
+
+        pCpuMapping = NULL;
+        status = NV_OK;
+        goto done;
+    }
+
     status = refAddMapping(pResourceRef, pParams, pContextRef, &pCpuMapping);
     if (status != NV_OK)
         goto done;
@@ -1821,6 +1854,13 @@ serverUnmap
     if (status != NV_OK)
         goto done;
 
+    // Other users of a shared mapping still hold it
+    if ((pCpuMapping->refCount != 0) && !pParams->bTeardown)
+    {
+        pCpuMapping->refCount--;
+        goto done;
+    }
+
     status = serverResLock_Prologue(pServer, LOCK_ACCESS_WRITE, pLockInfo, &releaseFlags);
     if (status != NV_OK)
         goto done;
@@ -2476,6 +2516,18 @@ _serverLockClientWithLockInfo
         NV_ASSERT_OK_OR_RETURN(_serverFindClientEntry(pServer, hClient, NV_FALSE, &pClientEntry));
         NV_ASSERT_OR_RETURN(pLockInfo->pClient != NULL, NV_ERR_INVALID_STATE);
         NV_ASSERT_OR_RETURN(pLockInfo->pClient == pClientEntry->pClient, NV_ERR_INVALID_STATE);
+
+        //
+        // A client lock held for read has no owner to check against, and
+        // cannot be upgraded for a nested call that modifies the client.
+        //
+        if (pLockInfo->state & RS_LOCK_STATE_CLIENT_LOCK_READ)
+        {
+            NV_ASSERT_OR_RETURN(access == LOCK_ACCESS_READ, NV_ERR_INVALID_LOCK_STATE);
+            *ppClient = pLockInfo->pClient;
+            return NV_OK;
+        }
+
         NV_ASSERT_OR_RETURN(pClientEntry->lockOwnerTid == portThreadGetCurrentThreadId(), NV_ERR_INVALID_STATE);
 
         *ppClient = pLockInfo->pClient;
@@ -2487,6 +2539,8 @@ _serverLockClientWithLockInfo
         return status;
 
     pLockInfo->state |= RS_LOCK_STATE_CLIENT_LOCK_ACQUIRED;
+    if (access == LOCK_ACCESS_READ)
+        pLockInfo->state |= RS_LOCK_STATE_CLIENT_LOCK_READ;
     pLockInfo->pClient = *ppClient;
     *pReleaseFlags |= RS_LOCK_RELEASE_CLIENT_LOCK;
 
@@ -2649,7 +2703,8 @@ _serverUnlockClientWithLockInfo
         if (status != NV_OK)
             return status;
 
-        pLockInfo->state &= ~RS_LOCK_STATE_CLIENT_LOCK_ACQUIRED;
+        pLockInfo->state &= ~(RS_LOCK_STATE_CLIENT_LOCK_ACQUIRED |
+                              RS_LOCK_STATE_CLIENT_LOCK_READ);
         pLockInfo->pClient = NULL;
         *pReleaseFlags &= ~RS_LOCK_RELEASE_CLIENT_LOCK;
     }
@@ -3910,5 +3965,10 @@ serverSupportsReadOnlyLock
         return (!!(pServer->roTopLockApiMask & NVBIT(api)));
     }
 
+    if (lock == RS_LOCK_CLIENT)
+    {
+        return (!!(pServer->roClientLockApiMask & NVBIT(api)));
+    }
+
     return NV_FALSE;
 }
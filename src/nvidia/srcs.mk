@@ -305,6 +305,7 @@ SRCS += src/kernel/core/hal/hals_all.c
 SRCS += src/kernel/core/hal/hals_stub.c
 SRCS += src/kernel/core/hal/info_block.c
 SRCS += src/kernel/core/hal_mgr.c
+SRCS += src/kernel/core/lock_meter.c
 SRCS += src/kernel/core/locks.c
 SRCS += src/kernel/core/locks_common.c
 SRCS += src/kernel/core/system.c
@@ -719,6 +720,7 @@ SRCS += src/kernel/rmapi/resource_desc.c
 SRCS += src/kernel/rmapi/rmapi.c
 SRCS += src/kernel/rmapi/rmapi_cache.c
 SRCS += src/kernel/rmapi/rmapi_finn.c
+SRCS += src/kernel/rmapi/rmapi_stats.c
 SRCS += src/kernel/rmapi/rmapi_stubs.c
 SRCS += src/kernel/rmapi/rmapi_utils.c
 SRCS += src/kernel/rmapi/rpc_common.c
@@ -741,6 +743,7 @@ SRCS += src/lib/ref_count.c
 SRCS += src/lib/zlib/inflate.c
 SRCS += src/libraries/containers/btree/btree.c
 SRCS += src/libraries/containers/eheap/eheap_old.c
+SRCS += src/libraries/containers/hashmap.c
 SRCS += src/libraries/containers/list.c
 SRCS += src/libraries/containers/map.c
 SRCS += src/libraries/containers/multimap.c